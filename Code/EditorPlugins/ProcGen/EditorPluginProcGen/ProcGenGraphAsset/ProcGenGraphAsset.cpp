@@ -90,7 +90,7 @@ struct ezProcGenGraphAssetDocument::GenerateContext
 
 ////////////////////////////////////////////////////////////////
 
-EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(ezProcGenGraphAssetDocument, 5, ezRTTINoAllocator)
+EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(ezProcGenGraphAssetDocument, 6, ezRTTINoAllocator)
 EZ_END_DYNAMIC_REFLECTED_TYPE;
 
 ezProcGenGraphAssetDocument::ezProcGenGraphAssetDocument(const char* szDocumentPath)
@@ -159,7 +159,7 @@ ezStatus ezProcGenGraphAssetDocument::WriteAsset(ezStreamWriter& stream, const e
   };
 
   {
-    chunk.BeginChunk("PlacementOutputs", 6);
+    chunk.BeginChunk("PlacementOutputs", 7);
 
     if (!bDebug)
     {
@@ -261,6 +261,16 @@ void ezProcGenGraphAssetDocument::UpdateAssetDocumentInfo(ezAssetDocumentInfo* p
         }
       }
 
+      ezUInt32 uiNumMeshes = typeAccessor.GetCount("Meshes");
+      for (ezUInt32 i = 0; i < uiNumMeshes; ++i)
+      {
+        ezVariant mesh = typeAccessor.GetValue("Meshes", i);
+        if (mesh.IsA<ezString>())
+        {
+          pInfo->m_RuntimeDependencies.Insert(mesh.Get<ezString>());
+        }
+      }
+
       ezVariant colorGradient = typeAccessor.GetValue("ColorGradient");
       if (colorGradient.IsA<ezString>())
       {
@@ -124,7 +124,9 @@ EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(ezProcGen_PlacementOutput, 1, ezRTTIDefaultAlloc
 {
   EZ_BEGIN_PROPERTIES
   {
+    EZ_ENUM_MEMBER_PROPERTY("OutputMode", ezProcPlacementOutputMode, m_OutputMode),
     EZ_ARRAY_MEMBER_PROPERTY("Objects", m_ObjectsToPlace)->AddAttributes(new ezAssetBrowserAttribute("Prefab")),
+    EZ_ARRAY_MEMBER_PROPERTY("Meshes", m_MeshesToPlace)->AddAttributes(new ezAssetBrowserAttribute("Mesh")),
     EZ_MEMBER_PROPERTY("Footprint", m_fFootprint)->AddAttributes(new ezDefaultValueAttribute(1.0f), new ezClampValueAttribute(0.0f, ezVariant())),
     EZ_MEMBER_PROPERTY("MinOffset", m_vMinOffset),
     EZ_MEMBER_PROPERTY("MaxOffset", m_vMaxOffset),
@@ -237,6 +239,10 @@ void ezProcGen_PlacementOutput::Save(ezStreamWriter& stream)
 
   // chunk version 5
   stream << m_PlacementMode;
+
+  // chunk version 7
+  stream << m_OutputMode;
+  stream.WriteArray(m_MeshesToPlace).IgnoreResult();
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -69,6 +69,9 @@ public:
 
   ezEnum<ezProcPlacementMode> m_PlacementMode;
 
+  ezEnum<ezProcPlacementOutputMode> m_OutputMode;
+  ezHybridArray<ezString, 4> m_MeshesToPlace;
+
   ezRenderPipelineNodeInputPin m_DensityPin;
   ezRenderPipelineNodeInputPin m_ScalePin;
   ezRenderPipelineNodeInputPin m_ColorIndexPin;
@@ -4,6 +4,7 @@
 
 #include <Core/Assets/AssetFileHeader.h>
 #include <EditorEngineProcessFramework/EngineProcess/EngineProcessDocumentContext.h>
+#include <Foundation/IO/FileSystem/FileReader.h>
 #include <Foundation/IO/FileSystem/FileWriter.h>
 #include <Foundation/Utilities/Progress.h>
 
@@ -36,10 +37,22 @@ ezResult ezLongOpWorker_BuildNavMesh::Execute(ezProgress& progress, ezStreamWrit
   ezRecastNavMeshBuilder NavMeshBuilder;
   ezRecastNavMeshResourceDescriptor desc;
 
+  // tiles of the previous result whose geometry did not change are reused
+  ezRecastNavMeshResourceDescriptor previousDesc;
+  bool bHasPreviousDesc = false;
+  {
+    ezFileReader file;
+    if (file.Open(m_sOutputPath).Succeeded())
+    {
+      ezAssetFileHeader header;
+      bHasPreviousDesc = header.Read(file).Succeeded() && previousDesc.Deserialize(file).Succeeded();
+    }
+  }
+
   if (!pgRange.BeginNextStep("Building NavMesh"))
     return EZ_FAILURE;
 
-  EZ_SUCCEED_OR_RETURN(NavMeshBuilder.Build(m_NavMeshConfig, m_ExtractedObjects, desc, progress));
+  EZ_SUCCEED_OR_RETURN(NavMeshBuilder.Build(m_NavMeshConfig, m_ExtractedObjects, desc, progress, bHasPreviousDesc ? &previousDesc : nullptr));
 
   if (!pgRange.BeginNextStep("Writing Result"))
     return EZ_FAILURE;
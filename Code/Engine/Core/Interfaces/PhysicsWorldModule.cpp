@@ -49,5 +49,45 @@ EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(ezMsgBuildStaticMesh, 1, ezRTTIDefaultAllocator<
 EZ_END_DYNAMIC_REFLECTED_TYPE;
 // clang-format on
 
+ezUInt32 ezPhysicsWorldModuleInterface::RaycastBatch(ezArrayPtr<const ezPhysicsCastRequest> rays, ezArrayPtr<ezPhysicsCastResult> out_Results, ezArrayPtr<bool> out_Hits, const ezPhysicsQueryParameters& params, ezPhysicsHitCollection collection, bool bAllowMultiThreading) const
+{
+  EZ_ASSERT_DEV(out_Results.GetCount() >= rays.GetCount() && out_Hits.GetCount() >= rays.GetCount(), "Result arrays are too small");
+
+  ezUInt32 uiNumHits = 0;
+
+  for (ezUInt32 i = 0; i < rays.GetCount(); ++i)
+  {
+    out_Hits[i] = false;
+
+    if (rays[i].m_fDistance <= 0.001f || rays[i].m_vDir.IsZero())
+      continue;
+
+    out_Hits[i] = Raycast(out_Results[i], rays[i].m_vStart, rays[i].m_vDir, rays[i].m_fDistance, params, collection);
+    uiNumHits += out_Hits[i] ? 1 : 0;
+  }
+
+  return uiNumHits;
+}
+
+ezUInt32 ezPhysicsWorldModuleInterface::SweepTestSphereBatch(float fSphereRadius, ezArrayPtr<const ezPhysicsCastRequest> sweeps, ezArrayPtr<ezPhysicsCastResult> out_Results, ezArrayPtr<bool> out_Hits, const ezPhysicsQueryParameters& params, ezPhysicsHitCollection collection, bool bAllowMultiThreading) const
+{
+  EZ_ASSERT_DEV(out_Results.GetCount() >= sweeps.GetCount() && out_Hits.GetCount() >= sweeps.GetCount(), "Result arrays are too small");
+
+  ezUInt32 uiNumHits = 0;
+
+  for (ezUInt32 i = 0; i < sweeps.GetCount(); ++i)
+  {
+    out_Hits[i] = false;
+
+    if (sweeps[i].m_fDistance <= 0.001f || sweeps[i].m_vDir.IsZero())
+      continue;
+
+    out_Hits[i] = SweepTestSphere(out_Results[i], fSphereRadius, sweeps[i].m_vStart, sweeps[i].m_vDir, sweeps[i].m_fDistance, params, collection);
+    uiNumHits += out_Hits[i] ? 1 : 0;
+  }
+
+  return uiNumHits;
+}
+
 
 EZ_STATICLINK_FILE(Core, Core_Interfaces_PhysicsWorldModule);
@@ -32,6 +32,16 @@ struct ezPhysicsCastResultArray
   ezHybridArray<ezPhysicsCastResult, 16> m_Results;
 };
 
+/// \brief One ray or sweep of a batched query, see ezPhysicsWorldModuleInterface::RaycastBatch()
+struct ezPhysicsCastRequest
+{
+  EZ_DECLARE_POD_TYPE();
+
+  ezVec3 m_vStart;
+  ezVec3 m_vDir; ///< Must be normalized
+  float m_fDistance;
+};
+
 /// \brief Used to report overlap query results
 struct ezPhysicsOverlapResult
 {
@@ -88,8 +98,19 @@ public:
 
   virtual bool RaycastAll(ezPhysicsCastResultArray& out_Results, const ezVec3& vStart, const ezVec3& vDir, float fDistance, const ezPhysicsQueryParameters& params) const = 0;
 
+  /// \brief Casts all rays with the same query parameters. Returns the number of rays that hit something.
+  ///
+  /// out_Hits[i] tells whether rays[i] hit something, out_Results[i] is only written in that case. Both arrays must be at least as large as rays.
+  /// Rays with a zero distance or a zero direction are reported as misses.
+  /// The default implementation calls Raycast() for every ray, physics engines override this to do the query setup only once.
+  /// If bAllowMultiThreading is set, the rays may be distributed across worker threads.
+  virtual ezUInt32 RaycastBatch(ezArrayPtr<const ezPhysicsCastRequest> rays, ezArrayPtr<ezPhysicsCastResult> out_Results, ezArrayPtr<bool> out_Hits, const ezPhysicsQueryParameters& params, ezPhysicsHitCollection collection = ezPhysicsHitCollection::Closest, bool bAllowMultiThreading = false) const;
+
   virtual bool SweepTestSphere(ezPhysicsCastResult& out_Result, float fSphereRadius, const ezVec3& vStart, const ezVec3& vDir, float fDistance, const ezPhysicsQueryParameters& params, ezPhysicsHitCollection collection = ezPhysicsHitCollection::Closest) const = 0;
 
+  /// \brief Sweeps a sphere along all the given rays. Works like RaycastBatch().
+  virtual ezUInt32 SweepTestSphereBatch(float fSphereRadius, ezArrayPtr<const ezPhysicsCastRequest> sweeps, ezArrayPtr<ezPhysicsCastResult> out_Results, ezArrayPtr<bool> out_Hits, const ezPhysicsQueryParameters& params, ezPhysicsHitCollection collection = ezPhysicsHitCollection::Closest, bool bAllowMultiThreading = false) const;
+
   virtual bool SweepTestBox(ezPhysicsCastResult& out_Result, ezVec3 vBoxExtends, const ezTransform& transform, const ezVec3& vDir, float fDistance, const ezPhysicsQueryParameters& params, ezPhysicsHitCollection collection = ezPhysicsHitCollection::Closest) const = 0;
 
   virtual bool SweepTestCapsule(ezPhysicsCastResult& out_Result, float fCapsuleRadius, float fCapsuleHeight, const ezTransform& transform, const ezVec3& vDir, float fDistance, const ezPhysicsQueryParameters& params, ezPhysicsHitCollection collection = ezPhysicsHitCollection::Closest) const = 0;
@@ -110,6 +110,18 @@ void ezResource::SetResourceDescription(const char* szDescription)
   m_sResourceDescription = szDescription;
 }
 
+void ezResource::RequestQualityLevelLoad()
+{
+  EZ_LOCK(ezResourceManager::GetMutex());
+
+  // the initial load will pick up whatever the resource wants at that time
+  if (m_LoadingState != ezResourceState::Loaded)
+    return;
+
+  m_uiQualityLevelsLoadable = ezMath::Max<ezUInt8>(m_uiQualityLevelsLoadable, 1);
+  ezResourceManager::PreloadResource(this);
+}
+
 void ezResource::SetUniqueID(const char* szUniqueID, bool bIsReloadable)
 {
   m_UniqueID = szUniqueID;
@@ -182,6 +182,13 @@ protected:
   /// \brief Used internally by the code injection macros
   void SetHasLoadingFallback(bool bHasLoadingFallback) { m_Flags.AddOrRemove(ezResourceFlags::ResourceHasFallback, bHasLoadingFallback); }
 
+  /// \brief Marks the resource as having more data to load and puts it into the preload queue again.
+  ///
+  /// This is meant for resources that decide on their own how much data they need, e.g. textures that stream their mipmaps
+  /// depending on their screen size. After UpdateContent() reported that there is nothing left to load, such a resource
+  /// can call this to get another UpdateContent() call once it wants more (or less) data. Does nothing while the resource is not loaded yet.
+  void RequestQualityLevelLoad();
+
 private:
   template <typename ResourceType>
   friend class ezTypedResourceHandle;
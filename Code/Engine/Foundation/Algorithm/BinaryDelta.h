@@ -0,0 +1,54 @@
+#pragma once
+
+#include <Foundation/Basics.h>
+#include <Foundation/Containers/DynamicArray.h>
+
+class ezStreamWriter;
+class ezStreamReader;
+
+/// \brief Computes and applies block based binary deltas, similar to rsync.
+///
+/// The side that has an old version of some data computes a Signature of it, which contains a weak rolling hash and a strong hash
+/// for every block. The side that has the new version uses that signature to find all blocks that the old data already contains,
+/// at arbitrary offsets, and only encodes the remaining bytes literally. The resulting delta is typically much smaller than the new data,
+/// if only parts of it changed. Applying the delta to the old data reproduces the new data.
+///
+/// The caller is responsible for verifying the result (e.g. by comparing a hash of the entire data), since the block hashes
+/// can have collisions.
+class EZ_FOUNDATION_DLL ezBinaryDelta
+{
+public:
+  struct BlockSignature
+  {
+    ezUInt32 m_uiWeakHash = 0;   ///< The rolling hash of the block.
+    ezUInt64 m_uiStrongHash = 0; ///< xxHash64 of the block.
+  };
+
+  struct Signature
+  {
+    ezUInt32 m_uiBlockSize = 0;              ///< Zero means the signature is empty and the delta will contain all data literally.
+    ezDynamicArray<BlockSignature> m_Blocks; ///< One entry per full block of the data, a partial last block is not included.
+  };
+
+  /// \brief Returns a block size that gives a reasonable trade-off between signature size and delta granularity for data of the given size.
+  static ezUInt32 ComputeBlockSize(ezUInt64 uiDataSize);
+
+  /// \brief Computes the signature of \a data. If \a uiBlockSize is zero, ComputeBlockSize() is used.
+  static void ComputeSignature(ezArrayPtr<const ezUInt8> data, Signature& out_Signature, ezUInt32 uiBlockSize = 0);
+
+  /// \brief Computes a delta that turns the data described by \a baseSignature into \a newData.
+  static void ComputeDelta(const Signature& baseSignature, ezArrayPtr<const ezUInt8> newData, ezDynamicArray<ezUInt8>& out_Delta);
+
+  /// \brief Reconstructs the new data from \a baseData and a delta that was computed with the signature of \a baseData.
+  ///
+  /// Fails if the delta is malformed or references blocks outside of \a baseData.
+  /// The delta may come from an untrusted source, the sizes stored in it are never used to allocate memory unchecked.
+  static ezResult ApplyDelta(ezArrayPtr<const ezUInt8> baseData, ezArrayPtr<const ezUInt8> delta, ezDynamicArray<ezUInt8>& out_Data);
+
+  static void WriteSignature(ezStreamWriter& stream, const Signature& signature);
+
+  /// \brief Reads a signature written by WriteSignature().
+  ///
+  /// Fails for a zero block size, an implausibly large block count or if the stream ends early. \a out_Signature is empty then.
+  static ezResult ReadSignature(ezStreamReader& stream, Signature& out_Signature);
+};
@@ -0,0 +1,355 @@
+#include <Foundation/FoundationPCH.h>
+
+#include <Foundation/Algorithm/BinaryDelta.h>
+#include <Foundation/Algorithm/HashingUtils.h>
+#include <Foundation/Containers/HashTable.h>
+#include <Foundation/IO/MemoryStream.h>
+
+namespace
+{
+  constexpr ezUInt8 s_uiDeltaVersion = 1;
+  constexpr ezUInt32 s_uiMinBlockSize = 512;
+  constexpr ezUInt32 s_uiMaxBlockSize = 64 * 1024;
+
+  /// ComputeBlockSize() keeps signatures at about 1024 blocks, this only guards against malformed signatures with huge counts.
+  constexpr ezUInt32 s_uiMaxSignatureBlocks = 1024 * 1024;
+
+  struct DeltaOp
+  {
+    enum Enum : ezUInt8
+    {
+      End = 0,
+      Copy = 1,    ///< Followed by the index of the first block and the number of consecutive blocks to copy from the base data.
+      Literal = 2, ///< Followed by the number of bytes and the bytes themselves.
+    };
+  };
+
+  /// The weak hash from rsync: two 16 bit sums that can be updated in O(1) when the window moves by one byte.
+  struct RollingHash
+  {
+    void Init(const ezUInt8* pData, ezUInt32 uiSize)
+    {
+      m_uiA = 0;
+      m_uiB = 0;
+      m_uiSize = uiSize;
+
+      for (ezUInt32 i = 0; i < uiSize; ++i)
+      {
+        m_uiA += pData[i];
+        m_uiB += (uiSize - i) * pData[i];
+      }
+    }
+
+    void Roll(ezUInt8 uiOut, ezUInt8 uiIn)
+    {
+      m_uiA = m_uiA - uiOut + uiIn;
+      m_uiB = m_uiB - m_uiSize * uiOut + m_uiA;
+    }
+
+    ezUInt32 GetHash() const { return (m_uiA & 0xFFFF) | (m_uiB << 16); }
+
+    ezUInt32 m_uiA = 0;
+    ezUInt32 m_uiB = 0;
+    ezUInt32 m_uiSize = 0;
+  };
+
+  ezUInt64 ComputeStrongHash(const ezUInt8* pData, ezUInt32 uiSize)
+  {
+    return ezHashingUtils::xxHash64(pData, uiSize);
+  }
+
+  void WriteLiteral(ezStreamWriter& stream, ezArrayPtr<const ezUInt8> data)
+  {
+    if (data.IsEmpty())
+      return;
+
+    stream << static_cast<ezUInt8>(DeltaOp::Literal);
+    stream << data.GetCount();
+    stream.WriteBytes(data.GetPtr(), data.GetCount()).IgnoreResult();
+  }
+} // namespace
+
+// static
+ezUInt32 ezBinaryDelta::ComputeBlockSize(ezUInt64 uiDataSize)
+{
+  // aim for roughly 1024 blocks, the signature then stays at about 12 KB
+  ezUInt32 uiBlockSize = s_uiMinBlockSize;
+  while (uiBlockSize < s_uiMaxBlockSize && uiDataSize / uiBlockSize > 1024)
+  {
+    uiBlockSize *= 2;
+  }
+
+  return uiBlockSize;
+}
+
+// static
+void ezBinaryDelta::ComputeSignature(ezArrayPtr<const ezUInt8> data, Signature& out_Signature, ezUInt32 uiBlockSize /*= 0*/)
+{
+  if (uiBlockSize == 0)
+    uiBlockSize = ComputeBlockSize(data.GetCount());
+
+  const ezUInt32 uiNumBlocks = data.GetCount() / uiBlockSize;
+
+  out_Signature.m_uiBlockSize = uiBlockSize;
+  out_Signature.m_Blocks.SetCount(uiNumBlocks);
+
+  RollingHash hash;
+
+  for (ezUInt32 i = 0; i < uiNumBlocks; ++i)
+  {
+    const ezUInt8* pBlock = data.GetPtr() + i * uiBlockSize;
+
+    hash.Init(pBlock, uiBlockSize);
+
+    out_Signature.m_Blocks[i].m_uiWeakHash = hash.GetHash();
+    out_Signature.m_Blocks[i].m_uiStrongHash = ComputeStrongHash(pBlock, uiBlockSize);
+  }
+}
+
+// static
+void ezBinaryDelta::ComputeDelta(const Signature& baseSignature, ezArrayPtr<const ezUInt8> newData, ezDynamicArray<ezUInt8>& out_Delta)
+{
+  out_Delta.Clear();
+
+  ezMemoryStreamContainerWrapperStorage<ezDynamicArray<ezUInt8>> storage(&out_Delta);
+  ezMemoryStreamWriter stream(&storage);
+
+  const ezUInt32 uiBlockSize = baseSignature.m_uiBlockSize;
+  const ezUInt32 uiDataSize = newData.GetCount();
+
+  stream << s_uiDeltaVersion;
+  stream << uiBlockSize;
+  stream << uiDataSize;
+
+  if (uiBlockSize == 0 || baseSignature.m_Blocks.IsEmpty() || uiDataSize < uiBlockSize)
+  {
+    WriteLiteral(stream, newData);
+    stream << static_cast<ezUInt8>(DeltaOp::End);
+    return;
+  }
+
+  // weak hash -> first block with that hash, further blocks with the same hash are chained through blockChain
+  ezHashTable<ezUInt32, ezUInt32> firstBlock;
+  ezDynamicArray<ezUInt32> blockChain;
+  firstBlock.Reserve(baseSignature.m_Blocks.GetCount());
+  blockChain.SetCountUninitialized(baseSignature.m_Blocks.GetCount());
+
+  for (ezUInt32 i = baseSignature.m_Blocks.GetCount(); i > 0; --i)
+  {
+    const ezUInt32 uiBlock = i - 1;
+    ezUInt32* pFirst = nullptr;
+
+    if (firstBlock.TryGetValue(baseSignature.m_Blocks[uiBlock].m_uiWeakHash, pFirst))
+    {
+      blockChain[uiBlock] = *pFirst;
+      *pFirst = uiBlock;
+    }
+    else
+    {
+      blockChain[uiBlock] = ezInvalidIndex;
+      firstBlock.Insert(baseSignature.m_Blocks[uiBlock].m_uiWeakHash, uiBlock);
+    }
+  }
+
+  const ezUInt8* pData = newData.GetPtr();
+
+  ezUInt32 uiLiteralStart = 0;
+  ezUInt32 uiCopyStart = ezInvalidIndex;
+  ezUInt32 uiCopyCount = 0;
+
+  auto FlushCopy = [&]() {
+    if (uiCopyCount > 0)
+    {
+      stream << static_cast<ezUInt8>(DeltaOp::Copy);
+      stream << uiCopyStart;
+      stream << uiCopyCount;
+      uiCopyCount = 0;
+    }
+  };
+
+  RollingHash hash;
+  hash.Init(pData, uiBlockSize);
+
+  ezUInt32 uiPos = 0;
+  while (uiPos + uiBlockSize <= uiDataSize)
+  {
+    ezUInt32 uiMatch = ezInvalidIndex;
+
+    ezUInt32 uiCandidate = ezInvalidIndex;
+    if (firstBlock.TryGetValue(hash.GetHash(), uiCandidate))
+    {
+      const ezUInt64 uiStrongHash = ComputeStrongHash(pData + uiPos, uiBlockSize);
+      const ezUInt32 uiPreferred = uiCopyCount > 0 ? uiCopyStart + uiCopyCount : ezInvalidIndex;
+
+      for (; uiCandidate != ezInvalidIndex; uiCandidate = blockChain[uiCandidate])
+      {
+        if (baseSignature.m_Blocks[uiCandidate].m_uiStrongHash != uiStrongHash)
+          continue;
+
+        uiMatch = uiCandidate;
+
+        // prefer the block that continues the current copy run, that keeps the delta small
+        if (uiMatch == uiPreferred || uiPreferred == ezInvalidIndex)
+          break;
+      }
+    }
+
+    if (uiMatch != ezInvalidIndex)
+    {
+      if (uiLiteralStart < uiPos)
+      {
+        FlushCopy();
+        WriteLiteral(stream, newData.GetSubArray(uiLiteralStart, uiPos - uiLiteralStart));
+      }
+
+      if (uiCopyCount > 0 && uiCopyStart + uiCopyCount != uiMatch)
+      {
+        FlushCopy();
+      }
+
+      if (uiCopyCount == 0)
+        uiCopyStart = uiMatch;
+
+      ++uiCopyCount;
+
+      uiPos += uiBlockSize;
+      uiLiteralStart = uiPos;
+
+      if (uiPos + uiBlockSize <= uiDataSize)
+        hash.Init(pData + uiPos, uiBlockSize);
+    }
+    else
+    {
+      if (uiPos + uiBlockSize < uiDataSize)
+        hash.Roll(pData[uiPos], pData[uiPos + uiBlockSize]);
+
+      ++uiPos;
+    }
+  }
+
+  if (uiLiteralStart < uiDataSize)
+  {
+    FlushCopy();
+    WriteLiteral(stream, newData.GetSubArray(uiLiteralStart));
+  }
+
+  FlushCopy();
+  stream << static_cast<ezUInt8>(DeltaOp::End);
+}
+
+// static
+ezResult ezBinaryDelta::ApplyDelta(ezArrayPtr<const ezUInt8> baseData, ezArrayPtr<const ezUInt8> delta, ezDynamicArray<ezUInt8>& out_Data)
+{
+  out_Data.Clear();
+
+  ezRawMemoryStreamReader stream(delta.GetPtr(), delta.GetCount());
+
+  ezUInt8 uiVersion = 0;
+  ezUInt32 uiBlockSize = 0;
+  ezUInt32 uiDataSize = 0;
+
+  stream >> uiVersion;
+  stream >> uiBlockSize;
+  stream >> uiDataSize;
+
+  if (uiVersion != s_uiDeltaVersion || uiBlockSize == 0)
+    return EZ_FAILURE;
+
+  // the size comes from the delta, so only reserve what the inputs can plausibly produce, the operations below check every step anyway
+  out_Data.Reserve(static_cast<ezUInt32>(ezMath::Min<ezUInt64>(uiDataSize, static_cast<ezUInt64>(baseData.GetCount()) + delta.GetCount())));
+
+  while (true)
+  {
+    ezUInt8 uiOp = DeltaOp::End;
+    if (stream.ReadBytes(&uiOp, sizeof(ezUInt8)) != sizeof(ezUInt8))
+      return EZ_FAILURE;
+
+    if (uiOp == DeltaOp::End)
+      break;
+
+    if (uiOp == DeltaOp::Copy)
+    {
+      ezUInt32 uiFirstBlock = 0, uiNumBlocks = 0;
+      stream >> uiFirstBlock;
+      stream >> uiNumBlocks;
+
+      const ezUInt64 uiOffset = static_cast<ezUInt64>(uiFirstBlock) * uiBlockSize;
+      const ezUInt64 uiSize = static_cast<ezUInt64>(uiNumBlocks) * uiBlockSize;
+
+      if (uiOffset + uiSize > baseData.GetCount() || out_Data.GetCount() + uiSize > uiDataSize)
+        return EZ_FAILURE;
+
+      out_Data.PushBackRange(baseData.GetSubArray(static_cast<ezUInt32>(uiOffset), static_cast<ezUInt32>(uiSize)));
+    }
+    else if (uiOp == DeltaOp::Literal)
+    {
+      ezUInt32 uiSize = 0;
+      stream >> uiSize;
+
+      if (uiSize > delta.GetCount() - stream.GetReadPosition() || out_Data.GetCount() + uiSize > uiDataSize)
+        return EZ_FAILURE;
+
+      const ezUInt32 uiStart = out_Data.GetCount();
+      out_Data.SetCountUninitialized(uiStart + uiSize);
+      stream.ReadBytes(out_Data.GetData() + uiStart, uiSize);
+    }
+    else
+    {
+      return EZ_FAILURE;
+    }
+  }
+
+  if (out_Data.GetCount() != uiDataSize)
+    return EZ_FAILURE;
+
+  return EZ_SUCCESS;
+}
+
+// static
+void ezBinaryDelta::WriteSignature(ezStreamWriter& stream, const Signature& signature)
+{
+  stream << signature.m_uiBlockSize;
+  stream << signature.m_Blocks.GetCount();
+
+  for (const BlockSignature& block : signature.m_Blocks)
+  {
+    stream << block.m_uiWeakHash;
+    stream << block.m_uiStrongHash;
+  }
+}
+
+// static
+ezResult ezBinaryDelta::ReadSignature(ezStreamReader& stream, Signature& out_Signature)
+{
+  out_Signature.m_uiBlockSize = 0;
+  out_Signature.m_Blocks.Clear();
+
+  ezUInt32 uiBlockSize = 0;
+  ezUInt32 uiNumBlocks = 0;
+
+  if (stream.ReadDWordValue(&uiBlockSize).Failed() || stream.ReadDWordValue(&uiNumBlocks).Failed())
+    return EZ_FAILURE;
+
+  if (uiBlockSize == 0 || uiNumBlocks > s_uiMaxSignatureBlocks)
+    return EZ_FAILURE;
+
+  // grow with the data that is actually there instead of trusting the count up front
+  out_Signature.m_Blocks.Reserve(ezMath::Min(uiNumBlocks, 1024u));
+
+  for (ezUInt32 i = 0; i < uiNumBlocks; ++i)
+  {
+    BlockSignature block;
+    if (stream.ReadDWordValue(&block.m_uiWeakHash).Failed() || stream.ReadQWordValue(&block.m_uiStrongHash).Failed())
+    {
+      out_Signature.m_Blocks.Clear();
+      return EZ_FAILURE;
+    }
+
+    out_Signature.m_Blocks.PushBack(block);
+  }
+
+  out_Signature.m_uiBlockSize = uiBlockSize;
+  return EZ_SUCCESS;
+}
+
+EZ_STATICLINK_FILE(Foundation, Foundation_Algorithm_Implementation_BinaryDelta);
@@ -67,7 +67,9 @@
 // Allocators
 #define EZ_USE_ALLOCATION_TRACKING EZ_OFF
 #define EZ_USE_ALLOCATION_STACK_TRACING EZ_OFF
+#define EZ_USE_ALLOCATION_SAMPLING EZ_OFF
 #define EZ_USE_GUARDED_ALLOCATIONS EZ_OFF
+#define EZ_USE_THREAD_CACHING_ALLOCATIONS EZ_OFF
 
 // Other Features
 #define EZ_USE_PROFILING EZ_OFF
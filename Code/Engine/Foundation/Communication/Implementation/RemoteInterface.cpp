@@ -1,8 +1,43 @@
 #include <Foundation/FoundationPCH.h>
 
 #include <Foundation/Communication/RemoteInterface.h>
+#include <Foundation/Logging/Log.h>
+#include <Foundation/Utilities/Compression.h>
 #include <Foundation/Utilities/ConversionUtils.h>
 
+namespace
+{
+  /// System ID of packets that wrap other messages. Every packet starts with the application ID, the system ID and the message ID.
+  constexpr ezUInt32 s_uiPacketSystemID = 'RIPK';
+  /// A batch packet contains any number of messages, each as system ID, message ID, data size and data.
+  constexpr ezUInt32 s_uiBatchMsgID = 'BTCH';
+  /// A compressed packet contains a zstd compressed packet without the application ID.
+  constexpr ezUInt32 s_uiCompressedMsgID = 'ZSTD';
+
+  /// Messages with more data than this are never batched.
+  constexpr ezUInt32 s_uiMaxBatchedMessageSize = 1024;
+  /// A batch is transmitted once it gets larger than this.
+  constexpr ezUInt32 s_uiMaxBatchSize = 32 * 1024;
+  /// Pooled messages that grew larger than this release their memory when they are recycled.
+  constexpr ezUInt64 s_uiMaxPooledMessageCapacity = 64 * 1024;
+  /// Once all messages are recycled, the pool is released if it grew larger than this, e.g. after a burst of messages.
+  constexpr ezUInt32 s_uiMaxPooledMessages = 256;
+
+  EZ_ALWAYS_INLINE void AppendUInt32(ezDynamicArray<ezUInt8>& inout_Data, ezUInt32 uiValue)
+  {
+    const ezUInt32 uiPos = inout_Data.GetCount();
+    inout_Data.SetCountUninitialized(uiPos + sizeof(ezUInt32));
+    ezMemoryUtils::Copy(&inout_Data[uiPos], reinterpret_cast<const ezUInt8*>(&uiValue), sizeof(ezUInt32));
+  }
+
+  EZ_ALWAYS_INLINE ezUInt32 ReadUInt32(const ezUInt8* pData)
+  {
+    ezUInt32 uiValue;
+    ezMemoryUtils::Copy(reinterpret_cast<ezUInt8*>(&uiValue), pData, sizeof(ezUInt32));
+    return uiValue;
+  }
+} // namespace
+
 ezRemoteInterface::~ezRemoteInterface()
 {
   // unfortunately we cannot do that ourselves here, because ShutdownConnection() calls virtual functions
@@ -87,11 +122,14 @@ void ezRemoteInterface::ShutdownConnection()
 
   if (m_RemoteMode != ezRemoteMode::None)
   {
+    FlushMessages();
+
     InternalShutdownConnection();
 
     m_RemoteMode = ezRemoteMode::None;
     m_uiApplicationID = 0;
     m_uiConnectionToken = 0;
+    m_PeersWithoutCompression.Clear();
   }
 }
 
@@ -108,6 +146,8 @@ void ezRemoteInterface::UpdateRemoteInterface()
 {
   EZ_LOCK(GetMutex());
 
+  FlushMessages();
+
   InternalUpdateRemoteInterface();
 }
 
@@ -118,13 +158,25 @@ ezResult ezRemoteInterface::Transmit(ezRemoteTransmitMode tm, const ezArrayPtr<c
 
   EZ_LOCK(GetMutex());
 
-  if (InternalTransmit(tm, data).Failed())
-    return EZ_FAILURE;
+#ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+  // the connection handshake has to stay readable for the implementation, never compress it
+  if (IsCompressionActive() && data.GetCount() >= 12 + m_uiCompressionThreshold && ReadUInt32(&data[4]) != m_uiConnectionToken)
+  {
+    if (ezCompressionUtils::Compress(data.GetSubArray(4), ezCompressionMethod::ZStd, m_CompressionBuffer).Succeeded() &&
+        m_CompressionBuffer.GetCount() + 12 < data.GetCount())
+    {
+      m_CompressedSendBuffer.Clear();
+      AppendUInt32(m_CompressedSendBuffer, m_uiApplicationID);
+      AppendUInt32(m_CompressedSendBuffer, s_uiPacketSystemID);
+      AppendUInt32(m_CompressedSendBuffer, s_uiCompressedMsgID);
+      m_CompressedSendBuffer.PushBackRange(m_CompressionBuffer);
 
-  // make sure the message is processed immediately
-  UpdateRemoteInterface();
+      return InternalTransmit(tm, m_CompressedSendBuffer);
+    }
+  }
+#endif
 
-  return EZ_SUCCESS;
+  return InternalTransmit(tm, data);
 }
 
 
@@ -141,6 +193,36 @@ void ezRemoteInterface::Send(ezRemoteTransmitMode tm, ezUInt32 uiSystemID, ezUIn
   // if (!IsConnectedToOther())
   //  return;
 
+  EZ_LOCK(m_Mutex);
+
+  // messages of the connection handshake are interpreted by the implementation directly, so they are never batched
+  if (m_bBatchMessages && data.GetCount() <= s_uiMaxBatchedMessageSize && uiSystemID != m_uiConnectionToken)
+  {
+    SendBatch& batch = m_SendBatches[(int)tm];
+
+    if (batch.m_Data.GetCount() + 12 + data.GetCount() > s_uiMaxBatchSize)
+    {
+      FlushBatch(tm);
+    }
+
+    if (batch.m_Data.IsEmpty())
+    {
+      AppendUInt32(batch.m_Data, m_uiApplicationID);
+      AppendUInt32(batch.m_Data, s_uiPacketSystemID);
+      AppendUInt32(batch.m_Data, s_uiBatchMsgID);
+    }
+
+    AppendUInt32(batch.m_Data, uiSystemID);
+    AppendUInt32(batch.m_Data, uiMsgID);
+    AppendUInt32(batch.m_Data, data.GetCount());
+    batch.m_Data.PushBackRange(data);
+    ++batch.m_uiNumMessages;
+    return;
+  }
+
+  // everything that was batched before has to arrive first
+  FlushMessages();
+
   m_TempSendBuffer.SetCountUninitialized(12 + data.GetCount());
   *((ezUInt32*)&m_TempSendBuffer[0]) = m_uiApplicationID;
   *((ezUInt32*)&m_TempSendBuffer[4]) = uiSystemID;
@@ -153,6 +235,9 @@ void ezRemoteInterface::Send(ezRemoteTransmitMode tm, ezUInt32 uiSystemID, ezUIn
   }
 
   Transmit(tm, m_TempSendBuffer).IgnoreResult();
+
+  // make sure the message is processed immediately
+  UpdateRemoteInterface();
 }
 
 void ezRemoteInterface::Send(ezRemoteTransmitMode tm, ezUInt32 uiSystemID, ezUInt32 uiMsgID, const void* pData /*= nullptr*/, ezUInt32 uiDataBytes /*= 0*/)
@@ -166,6 +251,60 @@ void ezRemoteInterface::Send(ezRemoteTransmitMode tm, ezRemoteMessage& msg)
 }
 
 
+void ezRemoteInterface::FlushMessages()
+{
+  EZ_LOCK(m_Mutex);
+
+  FlushBatch(ezRemoteTransmitMode::Reliable);
+  FlushBatch(ezRemoteTransmitMode::Unreliable);
+}
+
+void ezRemoteInterface::FlushBatch(ezRemoteTransmitMode tm)
+{
+  SendBatch& batch = m_SendBatches[(int)tm];
+
+  if (batch.m_uiNumMessages == 0)
+    return;
+
+  if (batch.m_uiNumMessages == 1)
+  {
+    // a single message does not need the batch overhead, turn it back into a regular packet
+    const ezUInt32 uiDataSize = ReadUInt32(&batch.m_Data[20]);
+
+    m_TempSendBuffer.Clear();
+    AppendUInt32(m_TempSendBuffer, m_uiApplicationID);
+    m_TempSendBuffer.PushBackRange(batch.m_Data.GetArrayPtr().GetSubArray(12, 8));
+    m_TempSendBuffer.PushBackRange(batch.m_Data.GetArrayPtr().GetSubArray(24, uiDataSize));
+
+    Transmit(tm, m_TempSendBuffer).IgnoreResult();
+  }
+  else
+  {
+    Transmit(tm, batch.m_Data).IgnoreResult();
+  }
+
+  batch.m_Data.Clear();
+  batch.m_uiNumMessages = 0;
+}
+
+void ezRemoteInterface::SetMessageBatching(bool bEnable)
+{
+  EZ_LOCK(m_Mutex);
+
+  if (!bEnable)
+  {
+    FlushMessages();
+  }
+
+  m_bBatchMessages = bEnable;
+}
+
+void ezRemoteInterface::SetCompressionThreshold(ezUInt32 uiMinBytes)
+{
+  EZ_LOCK(m_Mutex);
+  m_uiCompressionThreshold = uiMinBytes;
+}
+
 void ezRemoteInterface::SetMessageHandler(ezUInt32 uiSystemID, ezRemoteMessageHandler messageHandler)
 {
   m_MessageQueues[uiSystemID].m_MessageHandler = messageHandler;
@@ -193,23 +332,60 @@ ezUInt32 ezRemoteInterface::ExecuteAllMessageHandlers()
 
 ezUInt32 ezRemoteInterface::ExecuteMessageHandlersForQueue(ezRemoteMessageQueue& queue)
 {
-  queue.m_MessageQueueIn.Swap(queue.m_MessageQueueOut);
-  const ezUInt32 ret = queue.m_MessageQueueOut.GetCount();
-
-
-  if (queue.m_MessageHandler.IsValid())
+  // only handle the messages that are already there, handlers may update the network and thus receive more messages
+  // messages are taken from the front one by one, so that handlers may also execute the message handlers recursively
+  ezUInt32 ret = 0;
+  for (ezUInt32 uiNumMessages = queue.m_MessageQueueIn.GetCount(); uiNumMessages > 0 && !queue.m_MessageQueueIn.IsEmpty(); --uiNumMessages)
   {
-    for (auto& msg : queue.m_MessageQueueOut)
+    ezRemoteMessage* pMessage = queue.m_MessageQueueIn.PeekFront();
+    queue.m_MessageQueueIn.PopFront();
+
+    if (queue.m_MessageHandler.IsValid())
     {
-      queue.m_MessageHandler(msg);
+      queue.m_MessageHandler(*pMessage);
     }
-  }
 
-  queue.m_MessageQueueOut.Clear();
+    ReleaseMessage(pMessage);
+    ++ret;
+  }
 
   return ret;
 }
 
+ezRemoteMessage* ezRemoteInterface::AcquireMessage()
+{
+  if (m_FreeMessages.IsEmpty())
+    return &m_MessagePool.ExpandAndGetRef();
+
+  ezRemoteMessage* pMessage = m_FreeMessages.PeekBack();
+  m_FreeMessages.PopBack();
+  return pMessage;
+}
+
+void ezRemoteInterface::ReleaseMessage(ezRemoteMessage* pMessage)
+{
+  pMessage->m_Storage.Clear();
+
+  // don't keep the memory of the occasional huge message around
+  if (pMessage->m_Storage.GetHeapMemoryUsage() > s_uiMaxPooledMessageCapacity)
+  {
+    pMessage->m_Storage.Compact();
+  }
+
+  pMessage->m_Reader.SetStorage(&pMessage->m_Storage);
+  pMessage->m_Writer.SetStorage(&pMessage->m_Storage);
+
+  m_FreeMessages.PushBack(pMessage);
+
+  if (m_FreeMessages.GetCount() == m_MessagePool.GetCount() && m_MessagePool.GetCount() > s_uiMaxPooledMessages)
+  {
+    m_FreeMessages.Clear();
+    m_FreeMessages.Compact();
+    m_MessagePool.Clear();
+    m_MessagePool.Compact();
+  }
+}
+
 void ezRemoteInterface::StartUpdateThread()
 {
   StopUpdateThread();
@@ -237,13 +413,46 @@ void ezRemoteInterface::StopUpdateThread()
 }
 
 
-void ezRemoteInterface::ReportConnectionToServer(ezUInt32 uiServerID)
+bool ezRemoteInterface::IsCompressionActive() const
+{
+#ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+  EZ_LOCK(m_Mutex);
+
+  if (m_uiCompressionThreshold == 0 || !m_PeersWithoutCompression.IsEmpty())
+    return false;
+
+  // until the handshake is done, it is unknown whether the other side understands compressed packets
+  return m_RemoteMode == ezRemoteMode::Server ? m_iConnectionsToClients > 0 : m_uiConnectedToServerWithID != 0;
+#else
+  return false;
+#endif
+}
+
+// static
+ezUInt32 ezRemoteInterface::GetHandshakeFeatures()
+{
+  ezUInt32 uiFeatures = 0;
+
+#ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+  uiFeatures |= HandshakeFeatures::Compression;
+#endif
+
+  return uiFeatures;
+}
+
+void ezRemoteInterface::ReportConnectionToServer(ezUInt32 uiServerID, ezUInt32 uiServerFeatures)
 {
   if (m_uiConnectedToServerWithID == uiServerID)
     return;
 
   m_uiConnectedToServerWithID = uiServerID;
 
+  m_PeersWithoutCompression.Clear();
+  if ((uiServerFeatures & HandshakeFeatures::Compression) == 0)
+  {
+    m_PeersWithoutCompression.Insert(uiServerID);
+  }
+
   ezRemoteEvent e;
   e.m_Type = ezRemoteEvent::ConnectedToServer;
   e.m_uiOtherAppID = uiServerID;
@@ -251,10 +460,15 @@ void ezRemoteInterface::ReportConnectionToServer(ezUInt32 uiServerID)
 }
 
 
-void ezRemoteInterface::ReportConnectionToClient(ezUInt32 uiApplicationID)
+void ezRemoteInterface::ReportConnectionToClient(ezUInt32 uiApplicationID, ezUInt32 uiClientFeatures)
 {
   m_iConnectionsToClients++;
 
+  if ((uiClientFeatures & HandshakeFeatures::Compression) == 0)
+  {
+    m_PeersWithoutCompression.Insert(uiApplicationID);
+  }
+
   ezRemoteEvent e;
   e.m_Type = ezRemoteEvent::ConnectedToClient;
   e.m_uiOtherAppID = uiApplicationID;
@@ -264,6 +478,7 @@ void ezRemoteInterface::ReportConnectionToClient(ezUInt32 uiApplicationID)
 void ezRemoteInterface::ReportDisconnectedFromServer()
 {
   m_uiConnectedToServerWithID = 0;
+  m_PeersWithoutCompression.Clear();
 
   ezRemoteEvent e;
   e.m_Type = ezRemoteEvent::DisconnectedFromServer;
@@ -274,6 +489,7 @@ void ezRemoteInterface::ReportDisconnectedFromServer()
 void ezRemoteInterface::ReportDisconnectedFromClient(ezUInt32 uiApplicationID)
 {
   m_iConnectionsToClients--;
+  m_PeersWithoutCompression.Remove(uiApplicationID);
 
   ezRemoteEvent e;
   e.m_Type = ezRemoteEvent::DisconnectedFromClient;
@@ -286,6 +502,56 @@ void ezRemoteInterface::ReportMessage(ezUInt32 uiApplicationID, ezUInt32 uiSyste
 {
   EZ_LOCK(m_Mutex);
 
+  if (uiSystemID != s_uiPacketSystemID)
+  {
+    QueueMessage(uiApplicationID, uiSystemID, uiMsgID, data);
+    return;
+  }
+
+  if (uiMsgID == s_uiBatchMsgID)
+  {
+    ezUInt32 uiPos = 0;
+    while (uiPos + 12 <= data.GetCount())
+    {
+      const ezUInt32 uiSubSystemID = ReadUInt32(&data[uiPos + 0]);
+      const ezUInt32 uiSubMsgID = ReadUInt32(&data[uiPos + 4]);
+      const ezUInt32 uiSubSize = ReadUInt32(&data[uiPos + 8]);
+      uiPos += 12;
+
+      if (uiSubSize > data.GetCount() - uiPos)
+      {
+        ezLog::Error("Received a corrupted message batch");
+        return;
+      }
+
+      QueueMessage(uiApplicationID, uiSubSystemID, uiSubMsgID, data.GetSubArray(uiPos, uiSubSize));
+      uiPos += uiSubSize;
+    }
+  }
+  else if (uiMsgID == s_uiCompressedMsgID)
+  {
+    if (ezCompressionUtils::Decompress(data, ezCompressionMethod::ZStd, m_DecompressionBuffer).Failed() || m_DecompressionBuffer.GetCount() < 8)
+    {
+      ezLog::Error("Failed to decompress a received packet");
+      return;
+    }
+
+    const ezUInt32 uiInnerSystemID = ReadUInt32(&m_DecompressionBuffer[0]);
+    const ezUInt32 uiInnerMsgID = ReadUInt32(&m_DecompressionBuffer[4]);
+
+    // a nested compressed packet would be decompressed into the buffer that is still being read
+    if (uiInnerSystemID == s_uiPacketSystemID && uiInnerMsgID == s_uiCompressedMsgID)
+    {
+      ezLog::Error("Received a compressed packet inside of a compressed packet");
+      return;
+    }
+
+    ReportMessage(uiApplicationID, uiInnerSystemID, uiInnerMsgID, m_DecompressionBuffer.GetArrayPtr().GetSubArray(8));
+  }
+}
+
+void ezRemoteInterface::QueueMessage(ezUInt32 uiApplicationID, ezUInt32 uiSystemID, ezUInt32 uiMsgID, const ezArrayPtr<const ezUInt8>& data)
+{
   auto& queue = m_MessageQueues[uiSystemID];
 
   // discard messages for which we have no message handler
@@ -293,10 +559,12 @@ void ezRemoteInterface::ReportMessage(ezUInt32 uiApplicationID, ezUInt32 uiSyste
     return;
 
   // store the data for later
-  auto& msg = queue.m_MessageQueueIn.ExpandAndGetRef();
-  msg.m_uiApplicationID = uiApplicationID;
-  msg.SetMessageID(uiSystemID, uiMsgID);
-  msg.GetWriter().WriteBytes(data.GetPtr(), data.GetCount()).IgnoreResult();
+  ezRemoteMessage* pMsg = AcquireMessage();
+  pMsg->m_uiApplicationID = uiApplicationID;
+  pMsg->SetMessageID(uiSystemID, uiMsgID);
+  pMsg->GetWriter().WriteBytes(data.GetPtr(), data.GetCount()).IgnoreResult();
+
+  queue.m_MessageQueueIn.PushBack(pMsg);
 }
 
 ezResult ezRemoteInterface::DetermineTargetAddress(const char* szConnectTo, ezUInt32& out_IP, ezUInt16& out_Port)
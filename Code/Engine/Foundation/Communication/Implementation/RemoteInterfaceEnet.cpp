@@ -207,9 +207,10 @@ void ezRemoteInterfaceEnetImpl::InternalUpdateRemoteInterface()
         }
         else
         {
-          const ezUInt32 uiAppID = GetApplicationID();
+          // older clients only read the application ID
+          const ezUInt32 uiServerInfo[2] = {GetApplicationID(), GetHandshakeFeatures()};
           Send(ezRemoteTransmitMode::Reliable, GetConnectionToken(), 'EZID',
-            ezArrayPtr<const ezUInt8>(reinterpret_cast<const ezUInt8*>(&uiAppID), sizeof(ezUInt32)));
+            ezArrayPtr<const ezUInt8>(reinterpret_cast<const ezUInt8*>(uiServerInfo), sizeof(uiServerInfo)));
 
           // then wait for its acknowledgment message
         }
@@ -240,6 +241,7 @@ void ezRemoteInterfaceEnetImpl::InternalUpdateRemoteInterface()
         const ezUInt32 uiSystemID = *((ezUInt32*)&NetworkEvent.packet->data[4]);
         const ezUInt32 uiMsgID = *((ezUInt32*)&NetworkEvent.packet->data[8]);
         const ezUInt8* pData = &NetworkEvent.packet->data[12];
+        const ezUInt32 uiDataSize = (ezUInt32)NetworkEvent.packet->dataLength - 12;
 
         if (uiSystemID == GetConnectionToken())
         {
@@ -248,11 +250,14 @@ void ezRemoteInterfaceEnetImpl::InternalUpdateRemoteInterface()
             case 'EZID':
             {
               // acknowledge that the ID has been received
-              Send(GetConnectionToken(), 'AKID');
+              const ezUInt32 uiClientFeatures = GetHandshakeFeatures();
+              Send(ezRemoteTransmitMode::Reliable, GetConnectionToken(), 'AKID',
+                ezArrayPtr<const ezUInt8>(reinterpret_cast<const ezUInt8*>(&uiClientFeatures), sizeof(ezUInt32)));
 
-              // go tell the others about it
+              // go tell the others about it, older servers don't send their features
               ezUInt32 uiServerID = *((ezUInt32*)pData);
-              ReportConnectionToServer(uiServerID);
+              ezUInt32 uiServerFeatures = uiDataSize >= 2 * sizeof(ezUInt32) ? *((ezUInt32*)pData + 1) : 0;
+              ReportConnectionToServer(uiServerID, uiServerFeatures);
             }
             break;
 
@@ -263,7 +268,9 @@ void ezRemoteInterfaceEnetImpl::InternalUpdateRemoteInterface()
                 m_EnetPeerToClientID[NetworkEvent.peer] = uiApplicationID;
 
                 // the client received the server ID -> the connection has been established properly
-                ReportConnectionToClient(uiApplicationID);
+                // older clients don't send their features
+                ezUInt32 uiClientFeatures = uiDataSize >= sizeof(ezUInt32) ? *((ezUInt32*)pData) : 0;
+                ReportConnectionToClient(uiApplicationID, uiClientFeatures);
               }
             }
             break;
@@ -271,7 +278,7 @@ void ezRemoteInterfaceEnetImpl::InternalUpdateRemoteInterface()
         }
         else
         {
-          ReportMessage(uiApplicationID, uiSystemID, uiMsgID, ezArrayPtr<const ezUInt8>(pData, (ezUInt32)NetworkEvent.packet->dataLength - 12));
+          ReportMessage(uiApplicationID, uiSystemID, uiMsgID, ezArrayPtr<const ezUInt8>(pData, uiDataSize));
         }
 
         enet_packet_destroy(NetworkEvent.packet);
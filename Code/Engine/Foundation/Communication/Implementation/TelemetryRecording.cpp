@@ -0,0 +1,701 @@
+#include <Foundation/FoundationPCH.h>
+
+#include <Foundation/Communication/TelemetryRecording.h>
+#include <Foundation/IO/FileSystem/FileWriter.h>
+#include <Foundation/IO/MemoryStream.h>
+#include <Foundation/Utilities/Stats.h>
+
+namespace
+{
+  constexpr ezUInt32 s_uiRecordingMagic = 'EZTR';
+  constexpr ezUInt8 s_uiRecordingVersion = 1;
+
+  /// Stat names are short paths, anything longer can only come from a corrupted recording.
+  constexpr ezUInt64 s_uiMaxStatNameLength = 64 * 1024;
+
+  /// Every entry of a frame starts with (StatID << 2) | EntryType.
+  struct EntryType
+  {
+    enum Enum : ezUInt8
+    {
+      Delta = 0,  ///< Same numeric type as before, followed by the delta to the previous value.
+      Value = 1,  ///< Followed by the variant type and the value. Numeric values are delta encoded against zero.
+      Remove = 2, ///< The stat was removed.
+      Name = 3,   ///< Introduces a new stat ID, followed by the name. Always precedes the first change of that stat.
+    };
+  };
+
+  EZ_ALWAYS_INLINE void WriteVarUInt(ezDynamicArray<ezUInt8>& inout_Data, ezUInt64 uiValue)
+  {
+    while (uiValue >= 0x80)
+    {
+      inout_Data.PushBack(static_cast<ezUInt8>(uiValue | 0x80));
+      uiValue >>= 7;
+    }
+
+    inout_Data.PushBack(static_cast<ezUInt8>(uiValue));
+  }
+
+  ezResult ReadVarUInt(ezStreamReader& stream, ezUInt64& out_uiValue)
+  {
+    out_uiValue = 0;
+
+    for (ezUInt32 uiShift = 0; uiShift < 64; uiShift += 7)
+    {
+      ezUInt8 uiByte = 0;
+      if (stream.ReadBytes(&uiByte, sizeof(ezUInt8)) != sizeof(ezUInt8))
+        return EZ_FAILURE;
+
+      out_uiValue |= static_cast<ezUInt64>(uiByte & 0x7F) << uiShift;
+
+      if ((uiByte & 0x80) == 0)
+        return EZ_SUCCESS;
+    }
+
+    return EZ_FAILURE;
+  }
+
+  EZ_ALWAYS_INLINE ezUInt64 ZigZagEncode(ezInt64 iValue) { return (static_cast<ezUInt64>(iValue) << 1) ^ static_cast<ezUInt64>(iValue >> 63); }
+  EZ_ALWAYS_INLINE ezInt64 ZigZagDecode(ezUInt64 uiValue) { return static_cast<ezInt64>(uiValue >> 1) ^ -static_cast<ezInt64>(uiValue & 1); }
+
+  EZ_ALWAYS_INLINE bool IsFloatingPointType(ezUInt8 uiType) { return uiType == ezVariantType::Float || uiType == ezVariantType::Double; }
+
+  /// Returns the value as 64 bits that can be delta encoded. Returns false for non-numeric types.
+  bool GetNumericBits(const ezVariant& value, ezUInt64& out_uiBits)
+  {
+    switch (value.GetType())
+    {
+      case ezVariantType::Bool:
+        out_uiBits = value.Get<bool>() ? 1 : 0;
+        return true;
+      case ezVariantType::Int8:
+        out_uiBits = static_cast<ezUInt64>(static_cast<ezInt64>(value.Get<ezInt8>()));
+        return true;
+      case ezVariantType::UInt8:
+        out_uiBits = value.Get<ezUInt8>();
+        return true;
+      case ezVariantType::Int16:
+        out_uiBits = static_cast<ezUInt64>(static_cast<ezInt64>(value.Get<ezInt16>()));
+        return true;
+      case ezVariantType::UInt16:
+        out_uiBits = value.Get<ezUInt16>();
+        return true;
+      case ezVariantType::Int32:
+        out_uiBits = static_cast<ezUInt64>(static_cast<ezInt64>(value.Get<ezInt32>()));
+        return true;
+      case ezVariantType::UInt32:
+        out_uiBits = value.Get<ezUInt32>();
+        return true;
+      case ezVariantType::Int64:
+        out_uiBits = static_cast<ezUInt64>(value.Get<ezInt64>());
+        return true;
+      case ezVariantType::UInt64:
+        out_uiBits = value.Get<ezUInt64>();
+        return true;
+      case ezVariantType::Float:
+      {
+        ezUInt32 uiBits;
+        const float f = value.Get<float>();
+        ezMemoryUtils::Copy(reinterpret_cast<ezUInt8*>(&uiBits), reinterpret_cast<const ezUInt8*>(&f), sizeof(float));
+        out_uiBits = uiBits;
+        return true;
+      }
+      case ezVariantType::Double:
+      {
+        const double f = value.Get<double>();
+        ezMemoryUtils::Copy(reinterpret_cast<ezUInt8*>(&out_uiBits), reinterpret_cast<const ezUInt8*>(&f), sizeof(double));
+        return true;
+      }
+      default:
+        return false;
+    }
+  }
+
+  ezVariant FromNumericBits(ezUInt8 uiType, ezUInt64 uiBits)
+  {
+    switch (uiType)
+    {
+      case ezVariantType::Bool:
+        return ezVariant(uiBits != 0);
+      case ezVariantType::Int8:
+        return ezVariant(static_cast<ezInt8>(uiBits));
+      case ezVariantType::UInt8:
+        return ezVariant(static_cast<ezUInt8>(uiBits));
+      case ezVariantType::Int16:
+        return ezVariant(static_cast<ezInt16>(uiBits));
+      case ezVariantType::UInt16:
+        return ezVariant(static_cast<ezUInt16>(uiBits));
+      case ezVariantType::Int32:
+        return ezVariant(static_cast<ezInt32>(uiBits));
+      case ezVariantType::UInt32:
+        return ezVariant(static_cast<ezUInt32>(uiBits));
+      case ezVariantType::Int64:
+        return ezVariant(static_cast<ezInt64>(uiBits));
+      case ezVariantType::UInt64:
+        return ezVariant(uiBits);
+      case ezVariantType::Float:
+      {
+        const ezUInt32 uiBits32 = static_cast<ezUInt32>(uiBits);
+        float f;
+        ezMemoryUtils::Copy(reinterpret_cast<ezUInt8*>(&f), reinterpret_cast<const ezUInt8*>(&uiBits32), sizeof(float));
+        return ezVariant(f);
+      }
+      case ezVariantType::Double:
+      {
+        double f;
+        ezMemoryUtils::Copy(reinterpret_cast<ezUInt8*>(&f), reinterpret_cast<const ezUInt8*>(&uiBits), sizeof(double));
+        return ezVariant(f);
+      }
+      default:
+        return ezVariant();
+    }
+  }
+
+  /// Integers are stored as the difference to the previous value, floating point values as the XOR of the bit patterns,
+  /// because similar floats share their sign, exponent and upper mantissa bits.
+  EZ_ALWAYS_INLINE ezUInt64 EncodeNumeric(ezUInt8 uiType, ezUInt64 uiBits, ezUInt64 uiPreviousBits)
+  {
+    if (IsFloatingPointType(uiType))
+      return uiBits ^ uiPreviousBits;
+
+    return ZigZagEncode(static_cast<ezInt64>(uiBits - uiPreviousBits));
+  }
+
+  EZ_ALWAYS_INLINE ezUInt64 DecodeNumeric(ezUInt8 uiType, ezUInt64 uiEncoded, ezUInt64 uiPreviousBits)
+  {
+    if (IsFloatingPointType(uiType))
+      return uiEncoded ^ uiPreviousBits;
+
+    return uiPreviousBits + static_cast<ezUInt64>(ZigZagDecode(uiEncoded));
+  }
+} // namespace
+
+//////////////////////////////////////////////////////////////////////////
+
+// static
+void ezTelemetryRecordingEncoder::WriteHeader(ezStreamWriter& stream)
+{
+  stream << s_uiRecordingMagic;
+  stream << s_uiRecordingVersion;
+}
+
+ezTelemetryRecordingEncoder::StatState& ezTelemetryRecordingEncoder::GetStat(const char* szStatName)
+{
+  ezUInt32 uiStatID = 0;
+  if (!m_StatIDs.TryGetValue(szStatName, uiStatID))
+  {
+    uiStatID = m_Stats.GetCount();
+    m_StatIDs.Insert(szStatName, uiStatID);
+    m_Stats.ExpandAndGetRef().m_sName = szStatName;
+  }
+
+  StatState& stat = m_Stats[uiStatID];
+
+  if (!stat.m_bPending)
+  {
+    stat.m_bPending = true;
+    m_PendingChanges.PushBack(uiStatID);
+  }
+
+  return stat;
+}
+
+void ezTelemetryRecordingEncoder::SetStat(const char* szStatName, const ezVariant& value)
+{
+  StatState& stat = GetStat(szStatName);
+  stat.m_PendingValue = value;
+  stat.m_bPendingRemove = false;
+}
+
+void ezTelemetryRecordingEncoder::RemoveStat(const char* szStatName)
+{
+  StatState& stat = GetStat(szStatName);
+  stat.m_PendingValue = ezVariant();
+  stat.m_bPendingRemove = true;
+}
+
+bool ezTelemetryRecordingEncoder::EncodeFrame(ezTime frameTime, ezStreamWriter& stream)
+{
+  if (m_PendingChanges.IsEmpty())
+    return false;
+
+  m_FrameData.Clear();
+
+  ezUInt32 uiNumEntries = 0;
+
+  for (ezUInt32 uiStatID : m_PendingChanges)
+  {
+    StatState& stat = m_Stats[uiStatID];
+    stat.m_bPending = false;
+
+    if (!stat.m_bNameWritten)
+    {
+      stat.m_bNameWritten = true;
+
+      WriteVarUInt(m_FrameData, (static_cast<ezUInt64>(uiStatID) << 2) | EntryType::Name);
+      WriteVarUInt(m_FrameData, stat.m_sName.GetElementCount());
+      m_FrameData.PushBackRange(ezArrayPtr<const ezUInt8>(reinterpret_cast<const ezUInt8*>(stat.m_sName.GetData()), stat.m_sName.GetElementCount()));
+      ++uiNumEntries;
+    }
+
+    ++uiNumEntries;
+
+    if (stat.m_bPendingRemove)
+    {
+      WriteVarUInt(m_FrameData, (static_cast<ezUInt64>(uiStatID) << 2) | EntryType::Remove);
+
+      stat.m_uiPreviousType = ezVariantType::Invalid;
+      stat.m_uiPreviousBits = 0;
+      continue;
+    }
+
+    const ezUInt8 uiType = stat.m_PendingValue.GetType();
+    ezUInt64 uiBits = 0;
+
+    if (!GetNumericBits(stat.m_PendingValue, uiBits))
+    {
+      WriteVarUInt(m_FrameData, (static_cast<ezUInt64>(uiStatID) << 2) | EntryType::Value);
+      m_FrameData.PushBack(uiType);
+
+      ezMemoryStreamContainerWrapperStorage<ezDynamicArray<ezUInt8>> storage(&m_FrameData);
+      ezMemoryStreamWriter writer(&storage);
+      writer << stat.m_PendingValue;
+
+      stat.m_uiPreviousType = ezVariantType::Invalid;
+      stat.m_uiPreviousBits = 0;
+    }
+    else if (uiType == stat.m_uiPreviousType)
+    {
+      WriteVarUInt(m_FrameData, (static_cast<ezUInt64>(uiStatID) << 2) | EntryType::Delta);
+      WriteVarUInt(m_FrameData, EncodeNumeric(uiType, uiBits, stat.m_uiPreviousBits));
+
+      stat.m_uiPreviousBits = uiBits;
+    }
+    else
+    {
+      WriteVarUInt(m_FrameData, (static_cast<ezUInt64>(uiStatID) << 2) | EntryType::Value);
+      m_FrameData.PushBack(uiType);
+      WriteVarUInt(m_FrameData, EncodeNumeric(uiType, uiBits, 0));
+
+      stat.m_uiPreviousType = uiType;
+      stat.m_uiPreviousBits = uiBits;
+    }
+
+    stat.m_PendingValue = ezVariant();
+  }
+
+  m_PendingChanges.Clear();
+
+  // frame header: time since the previous frame in microseconds and the number of entries
+  // the rounded time is accumulated, exactly like the decoder does it, so that rounding errors don't add up
+  const ezInt64 iTimeDelta = static_cast<ezInt64>((frameTime - m_LastFrameTime).GetMicroseconds());
+  m_LastFrameTime += ezTime::Microseconds(static_cast<double>(iTimeDelta));
+
+  ezHybridArray<ezUInt8, 20> header;
+  WriteVarUInt(header, ZigZagEncode(iTimeDelta));
+  WriteVarUInt(header, uiNumEntries);
+
+  stream.WriteBytes(header.GetData(), header.GetCount()).IgnoreResult();
+  stream.WriteBytes(m_FrameData.GetData(), m_FrameData.GetCount()).IgnoreResult();
+  return true;
+}
+
+void ezTelemetryRecordingEncoder::Reset()
+{
+  m_StatIDs.Clear();
+  m_Stats.Clear();
+  m_PendingChanges.Clear();
+  m_LastFrameTime.SetZero();
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+ezResult ezTelemetryRecordingDecoder::ReadHeader(ezStreamReader& stream)
+{
+  Reset();
+
+  ezUInt32 uiMagic = 0;
+  ezUInt8 uiVersion = 0;
+  stream >> uiMagic;
+  stream >> uiVersion;
+
+  if (uiMagic != s_uiRecordingMagic)
+  {
+    ezLog::Error("Data is not a telemetry recording");
+    return EZ_FAILURE;
+  }
+
+  if (uiVersion != s_uiRecordingVersion)
+  {
+    ezLog::Error("Unsupported telemetry recording version {}", uiVersion);
+    return EZ_FAILURE;
+  }
+
+  return EZ_SUCCESS;
+}
+
+ezResult ezTelemetryRecordingDecoder::DecodeFrame(ezStreamReader& stream, ezTime& out_FrameTime, ezDynamicArray<StatChange>& out_Changes)
+{
+  out_Changes.Clear();
+
+  ezUInt64 uiTimeDelta = 0;
+  ezUInt64 uiNumEntries = 0;
+
+  if (ReadVarUInt(stream, uiTimeDelta).Failed() || ReadVarUInt(stream, uiNumEntries).Failed())
+    return EZ_FAILURE;
+
+  m_LastFrameTime += ezTime::Microseconds(static_cast<double>(ZigZagDecode(uiTimeDelta)));
+  out_FrameTime = m_LastFrameTime;
+
+  ezStringBuilder sName;
+
+  for (ezUInt64 uiEntry = 0; uiEntry < uiNumEntries; ++uiEntry)
+  {
+    ezUInt64 uiEntryHeader = 0;
+    EZ_SUCCEED_OR_RETURN(ReadVarUInt(stream, uiEntryHeader));
+
+    const ezUInt64 uiStatID = uiEntryHeader >> 2;
+    const ezUInt8 uiEntryType = static_cast<ezUInt8>(uiEntryHeader & 3);
+
+    if (uiEntryType == EntryType::Name)
+    {
+      // IDs are assigned in order, so a new name always gets the next ID
+      if (uiStatID != m_Stats.GetCount())
+        return EZ_FAILURE;
+
+      ezUInt64 uiLength = 0;
+      EZ_SUCCEED_OR_RETURN(ReadVarUInt(stream, uiLength));
+
+      if (uiLength > s_uiMaxStatNameLength)
+        return EZ_FAILURE;
+
+      ezHybridArray<char, 256> name;
+      name.SetCountUninitialized(static_cast<ezUInt32>(uiLength) + 1);
+      if (stream.ReadBytes(name.GetData(), uiLength) != uiLength)
+        return EZ_FAILURE;
+
+      name[static_cast<ezUInt32>(uiLength)] = '\0';
+      m_Stats.ExpandAndGetRef().m_sName = name.GetData();
+      continue;
+    }
+
+    if (uiStatID >= m_Stats.GetCount())
+      return EZ_FAILURE;
+
+    StatState& stat = m_Stats[static_cast<ezUInt32>(uiStatID)];
+
+    StatChange& change = out_Changes.ExpandAndGetRef();
+    change.m_szStatName = stat.m_sName.GetData();
+
+    if (uiEntryType == EntryType::Remove)
+    {
+      change.m_bRemoved = true;
+      stat.m_uiPreviousType = ezVariantType::Invalid;
+      stat.m_uiPreviousBits = 0;
+    }
+    else if (uiEntryType == EntryType::Delta)
+    {
+      if (stat.m_uiPreviousType == ezVariantType::Invalid)
+        return EZ_FAILURE;
+
+      ezUInt64 uiEncoded = 0;
+      EZ_SUCCEED_OR_RETURN(ReadVarUInt(stream, uiEncoded));
+
+      stat.m_uiPreviousBits = DecodeNumeric(stat.m_uiPreviousType, uiEncoded, stat.m_uiPreviousBits);
+      change.m_Value = FromNumericBits(stat.m_uiPreviousType, stat.m_uiPreviousBits);
+    }
+    else
+    {
+      ezUInt8 uiType = 0;
+      if (stream.ReadBytes(&uiType, sizeof(ezUInt8)) != sizeof(ezUInt8))
+        return EZ_FAILURE;
+
+      if (uiType >= ezVariantType::Bool && uiType <= ezVariantType::Double)
+      {
+        ezUInt64 uiEncoded = 0;
+        EZ_SUCCEED_OR_RETURN(ReadVarUInt(stream, uiEncoded));
+
+        stat.m_uiPreviousType = uiType;
+        stat.m_uiPreviousBits = DecodeNumeric(uiType, uiEncoded, 0);
+        change.m_Value = FromNumericBits(uiType, stat.m_uiPreviousBits);
+      }
+      else
+      {
+        stream >> change.m_Value;
+
+        if (change.m_Value.GetType() != uiType)
+          return EZ_FAILURE;
+
+        stat.m_uiPreviousType = ezVariantType::Invalid;
+        stat.m_uiPreviousBits = 0;
+      }
+    }
+  }
+
+  return EZ_SUCCESS;
+}
+
+void ezTelemetryRecordingDecoder::Reset()
+{
+  m_Stats.Clear();
+  m_LastFrameTime.SetZero();
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+  struct ezTelemetryRecorderState
+  {
+    ezFileWriter m_File;
+    ezTelemetryRecordingEncoder m_Encoder;
+    ezDynamicArray<ezUInt8> m_FrameBuffer;
+    ezUInt64 m_uiRecordedBytes = 0;
+  };
+
+  ezMutex s_RecorderMutex;
+  ezTelemetryRecorderState* s_pRecorder = nullptr;
+
+  void RecorderStatsEventHandler(const ezStats::StatsEventData& e)
+  {
+    EZ_LOCK(s_RecorderMutex);
+
+    if (s_pRecorder == nullptr)
+      return;
+
+    if (e.m_EventType == ezStats::StatsEventData::Remove)
+      s_pRecorder->m_Encoder.RemoveStat(e.m_szStatName);
+    else
+      s_pRecorder->m_Encoder.SetStat(e.m_szStatName, e.m_NewStatValue);
+  }
+
+  void RecorderTelemetryEventHandler(const ezTelemetry::TelemetryEventData& e)
+  {
+    if (e.m_EventType == ezTelemetry::TelemetryEventData::PerFrameUpdate)
+    {
+      ezTelemetryRecorder::EndFrame();
+    }
+  }
+} // namespace
+
+// static
+ezResult ezTelemetryRecorder::StartRecording(const char* szFile)
+{
+  StopRecording();
+
+  {
+    // no stat may change between taking the snapshot and registering the event handler, otherwise the change would be missing
+    // ezStats::SetStat() holds the same mutex while the handler locks the recorder, so both lock in the same order
+    EZ_LOCK(ezStats::GetMutex());
+
+    {
+      EZ_LOCK(s_RecorderMutex);
+
+      ezTelemetryRecorderState* pRecorder = EZ_DEFAULT_NEW(ezTelemetryRecorderState);
+
+      if (pRecorder->m_File.Open(szFile).Failed())
+      {
+        ezLog::Error("Failed to create telemetry recording '{}'", szFile);
+        EZ_DEFAULT_DELETE(pRecorder);
+        return EZ_FAILURE;
+      }
+
+      ezTelemetryRecordingEncoder::WriteHeader(pRecorder->m_File);
+      pRecorder->m_uiRecordedBytes = sizeof(ezUInt32) + sizeof(ezUInt8);
+
+      for (auto it = ezStats::GetAllStats().GetIterator(); it.IsValid(); ++it)
+      {
+        pRecorder->m_Encoder.SetStat(it.Key(), it.Value());
+      }
+
+      s_pRecorder = pRecorder;
+    }
+
+    // the event handlers are registered outside of the recorder lock, the events lock their own mutex while calling the handlers
+    ezStats::AddEventHandler(RecorderStatsEventHandler);
+  }
+
+  ezTelemetry::AddEventHandler(RecorderTelemetryEventHandler);
+
+  return EZ_SUCCESS;
+}
+
+// static
+void ezTelemetryRecorder::StopRecording()
+{
+  if (!IsRecording())
+    return;
+
+  ezTelemetry::RemoveEventHandler(RecorderTelemetryEventHandler);
+  ezStats::RemoveEventHandler(RecorderStatsEventHandler);
+
+  EndFrame();
+
+  EZ_LOCK(s_RecorderMutex);
+
+  s_pRecorder->m_File.Close();
+  EZ_DEFAULT_DELETE(s_pRecorder);
+}
+
+// static
+bool ezTelemetryRecorder::IsRecording()
+{
+  EZ_LOCK(s_RecorderMutex);
+  return s_pRecorder != nullptr;
+}
+
+// static
+void ezTelemetryRecorder::EndFrame()
+{
+  EZ_LOCK(s_RecorderMutex);
+
+  if (s_pRecorder == nullptr)
+    return;
+
+  s_pRecorder->m_FrameBuffer.Clear();
+  ezMemoryStreamContainerWrapperStorage<ezDynamicArray<ezUInt8>> storage(&s_pRecorder->m_FrameBuffer);
+  ezMemoryStreamWriter writer(&storage);
+
+  if (!s_pRecorder->m_Encoder.EncodeFrame(ezTime::Now(), writer))
+    return;
+
+  s_pRecorder->m_File.WriteBytes(s_pRecorder->m_FrameBuffer.GetData(), s_pRecorder->m_FrameBuffer.GetCount()).IgnoreResult();
+  s_pRecorder->m_uiRecordedBytes += s_pRecorder->m_FrameBuffer.GetCount();
+}
+
+// static
+ezUInt64 ezTelemetryRecorder::GetRecordedBytes()
+{
+  EZ_LOCK(s_RecorderMutex);
+  return s_pRecorder != nullptr ? s_pRecorder->m_uiRecordedBytes : 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+ezTelemetryRecordingPlayer::ezTelemetryRecordingPlayer() = default;
+
+ezTelemetryRecordingPlayer::~ezTelemetryRecordingPlayer()
+{
+  Close();
+}
+
+ezResult ezTelemetryRecordingPlayer::Open(const char* szFile)
+{
+  Close();
+
+  if (m_File.Open(szFile).Failed())
+  {
+    ezLog::Error("Failed to open telemetry recording '{}'", szFile);
+    return EZ_FAILURE;
+  }
+
+  if (m_Decoder.ReadHeader(m_File).Failed())
+  {
+    m_File.Close();
+    return EZ_FAILURE;
+  }
+
+  m_bFirstFrame = true;
+  m_FrameTime.SetZero();
+
+  ezTelemetry::AddEventHandler(ezMakeDelegate(&ezTelemetryRecordingPlayer::TelemetryEventHandler, this));
+  return EZ_SUCCESS;
+}
+
+void ezTelemetryRecordingPlayer::Close()
+{
+  if (!m_File.IsOpen())
+    return;
+
+  ezTelemetry::RemoveEventHandler(ezMakeDelegate(&ezTelemetryRecordingPlayer::TelemetryEventHandler, this));
+
+  m_File.Close();
+  m_Decoder.Reset();
+
+  EZ_LOCK(ezTelemetry::GetTelemetryMutex());
+  m_Stats.Clear();
+}
+
+ezResult ezTelemetryRecordingPlayer::PlayNextFrame()
+{
+  if (!m_File.IsOpen())
+    return EZ_FAILURE;
+
+  if (m_Decoder.DecodeFrame(m_File, m_FrameTime, m_Changes).Failed())
+    return EZ_FAILURE;
+
+  if (m_bFirstFrame)
+  {
+    m_bFirstFrame = false;
+    m_TimeOffset = ezTime::Now() - m_FrameTime;
+  }
+
+  const ezTime sendTime = m_FrameTime + m_TimeOffset;
+
+  // the stats are also accessed when a client connects
+  EZ_LOCK(ezTelemetry::GetTelemetryMutex());
+
+  for (const auto& change : m_Changes)
+  {
+    if (change.m_bRemoved)
+    {
+      m_Stats.Remove(change.m_szStatName);
+
+      if (ezTelemetry::IsConnectedToClient())
+      {
+        ezTelemetryMessage msg;
+        msg.SetMessageID('STAT', ' DEL');
+        msg.GetWriter() << change.m_szStatName;
+        msg.GetWriter() << sendTime;
+
+        ezTelemetry::Broadcast(ezTelemetry::Reliable, msg);
+      }
+    }
+    else
+    {
+      bool bExisted = false;
+      m_Stats.FindOrAdd(change.m_szStatName, &bExisted).Value() = change.m_Value;
+
+      if (ezTelemetry::IsConnectedToClient())
+      {
+        ezTelemetryMessage msg;
+        msg.SetMessageID('STAT', ' SET');
+        msg.GetWriter() << change.m_szStatName;
+        msg.GetWriter() << change.m_Value;
+        msg.GetWriter() << sendTime;
+
+        ezTelemetry::Broadcast(bExisted ? ezTelemetry::Unreliable : ezTelemetry::Reliable, msg);
+      }
+    }
+  }
+
+  return EZ_SUCCESS;
+}
+
+void ezTelemetryRecordingPlayer::TelemetryEventHandler(const ezTelemetry::TelemetryEventData& e)
+{
+  if (e.m_EventType == ezTelemetry::TelemetryEventData::ConnectedToClient)
+  {
+    SendAllStats();
+  }
+}
+
+void ezTelemetryRecordingPlayer::SendAllStats()
+{
+  EZ_LOCK(ezTelemetry::GetTelemetryMutex());
+
+  const ezTime sendTime = m_FrameTime + m_TimeOffset;
+
+  for (auto it = m_Stats.GetIterator(); it.IsValid(); ++it)
+  {
+    ezTelemetryMessage msg;
+    msg.SetMessageID('STAT', ' SET');
+    msg.GetWriter() << it.Key().GetData();
+    msg.GetWriter() << it.Value();
+    msg.GetWriter() << sendTime;
+
+    ezTelemetry::Broadcast(ezTelemetry::Reliable, msg);
+  }
+}
+
+EZ_STATICLINK_FILE(Foundation, Foundation_Communication_Implementation_TelemetryRecording);
@@ -4,6 +4,7 @@
 #include <Foundation/Communication/Event.h>
 #include <Foundation/Communication/RemoteMessage.h>
 #include <Foundation/Containers/Deque.h>
+#include <Foundation/Containers/HashSet.h>
 #include <Foundation/Containers/HashTable.h>
 #include <Foundation/Threading/Mutex.h>
 #include <Foundation/Threading/Thread.h>
@@ -49,11 +50,8 @@ struct EZ_FOUNDATION_DLL ezRemoteMessageQueue
 {
   ezRemoteMessageHandler m_MessageHandler;
   /// \brief Messages are pushed into this container on arrival.
-  ezDeque<ezRemoteMessage> m_MessageQueueIn;
-  /// \brief To flush the message queue, m_MessageQueueIn and m_MessageQueueOut are swapped.
-  /// Thus new messages can arrive while we execute the event handler for each element
-  /// in this container and then clear it.
-  ezDeque<ezRemoteMessage> m_MessageQueueOut;
+  /// The messages are owned by the ezRemoteInterface and are recycled once their handler was executed.
+  ezDeque<ezRemoteMessage*> m_MessageQueueIn;
 };
 
 class EZ_FOUNDATION_DLL ezRemoteInterface
@@ -170,6 +168,35 @@ public:
   /// If it is a client, the message is only sent to the server.
   void Send(ezRemoteTransmitMode tm, ezRemoteMessage& msg);
 
+  /// \brief Transmits all messages that were batched so far. Also done by every UpdateRemoteInterface().
+  void FlushMessages();
+
+  ///@}
+
+  /// \name Transmission Settings
+  ///@{
+
+  /// \brief Enables or disables coalescing of small messages into larger packets. Enabled by default.
+  ///
+  /// Batched messages are transmitted with the next UpdateRemoteInterface() or FlushMessages(), when the batch is full,
+  /// or right before a large message is sent, so the order of all messages is preserved.
+  void SetMessageBatching(bool bEnable);
+
+  /// \brief Whether small messages are coalesced into larger packets.
+  bool GetMessageBatching() const { return m_bBatchMessages; }
+
+  /// \brief Packets with at least this many bytes are compressed with zstd before they are transmitted. Zero disables compression (default).
+  ///
+  /// Only has an effect when zstd support is compiled in. Both sides report whether they support compression during the connection handshake,
+  /// and packets are only compressed while every connected peer does. See IsCompressionActive().
+  void SetCompressionThreshold(ezUInt32 uiMinBytes);
+
+  /// \brief Returns the size from which on packets are compressed, zero if compression is disabled.
+  ezUInt32 GetCompressionThreshold() const { return m_uiCompressionThreshold; }
+
+  /// \brief Whether large packets are currently compressed. Requires a compression threshold and that all connected peers support compression.
+  bool IsCompressionActive() const;
+
   ///@}
 
   /// \name Message Handling
@@ -221,10 +248,26 @@ protected:
   /// Derived classes should update this when the information is available
   ezString m_ServerInfoIP;
 
+  /// \brief Optional features that both sides exchange during the connection handshake.
+  struct HandshakeFeatures
+  {
+    enum Enum : ezUInt32
+    {
+      Compression = EZ_BIT(0), ///< The side can decompress packets, see SetCompressionThreshold()
+    };
+  };
+
+  /// \brief Returns the HandshakeFeatures of this side, the implementation has to send them to the other side during the handshake.
+  static ezUInt32 GetHandshakeFeatures();
+
   /// \brief Should be called by the implementation, when a server connection has been established
-  void ReportConnectionToServer(ezUInt32 uiServerID);
+  ///
+  /// \param uiServerFeatures The HandshakeFeatures that the server sent. Zero for servers that don't send any.
+  void ReportConnectionToServer(ezUInt32 uiServerID, ezUInt32 uiServerFeatures = 0);
   /// \brief Should be called by the implementation, when a client connection has been established
-  void ReportConnectionToClient(ezUInt32 uiApplicationID);
+  ///
+  /// \param uiClientFeatures The HandshakeFeatures that the client sent. Zero for clients that don't send any.
+  void ReportConnectionToClient(ezUInt32 uiApplicationID, ezUInt32 uiClientFeatures = 0);
   /// \brief Should be called by the implementation, when a server connection has been lost
   void ReportDisconnectedFromServer();
   /// \brief Should be called by the implementation, when a client connection has been lost
@@ -236,11 +279,21 @@ protected:
 
 
 private:
+  struct SendBatch
+  {
+    ezDynamicArray<ezUInt8> m_Data;
+    ezUInt32 m_uiNumMessages = 0;
+  };
+
   void StartUpdateThread();
   void StopUpdateThread();
   ezResult Transmit(ezRemoteTransmitMode tm, const ezArrayPtr<const ezUInt8>& data);
   ezResult CreateConnection(ezUInt32 uiConnectionToken, ezRemoteMode mode, const char* szServerAddress, bool bStartUpdateThread);
   ezUInt32 ExecuteMessageHandlersForQueue(ezRemoteMessageQueue& queue);
+  void FlushBatch(ezRemoteTransmitMode tm);
+  void QueueMessage(ezUInt32 uiApplicationID, ezUInt32 uiSystemID, ezUInt32 uiMsgID, const ezArrayPtr<const ezUInt8>& data);
+  ezRemoteMessage* AcquireMessage();
+  void ReleaseMessage(ezRemoteMessage* pMessage);
 
   mutable ezMutex m_Mutex;
   class ezRemoteThread* m_pUpdateThread = nullptr;
@@ -251,8 +304,17 @@ private:
   ezUInt32 m_uiConnectionToken = 0;
   ezUInt32 m_uiConnectedToServerWithID = 0;
   ezInt32 m_iConnectionsToClients = 0;
+  ezHashSet<ezUInt32> m_PeersWithoutCompression; // application IDs of connected peers that can't decompress packets
   ezDynamicArray<ezUInt8> m_TempSendBuffer;
+  ezDynamicArray<ezUInt8> m_CompressedSendBuffer;
+  ezDynamicArray<ezUInt8> m_CompressionBuffer;
+  ezDynamicArray<ezUInt8> m_DecompressionBuffer;
+  SendBatch m_SendBatches[2]; // indexed by ezRemoteTransmitMode
+  bool m_bBatchMessages = true;
+  ezUInt32 m_uiCompressionThreshold = 0;
   ezHashTable<ezUInt32, ezRemoteMessageQueue> m_MessageQueues;
+  ezDeque<ezRemoteMessage> m_MessagePool; // a deque, so that the messages never move in memory
+  ezDynamicArray<ezRemoteMessage*> m_FreeMessages;
 };
 
 /// \brief The remote interface thread updates in regular intervals to keep the connection alive.
@@ -0,0 +1,156 @@
+#pragma once
+
+#include <Foundation/Communication/Telemetry.h>
+#include <Foundation/Containers/Deque.h>
+#include <Foundation/Containers/DynamicArray.h>
+#include <Foundation/Containers/HashTable.h>
+#include <Foundation/Containers/Map.h>
+#include <Foundation/IO/FileSystem/FileReader.h>
+#include <Foundation/Strings/String.h>
+#include <Foundation/Time/Time.h>
+#include <Foundation/Types/Variant.h>
+
+class ezStreamWriter;
+class ezStreamReader;
+
+/// \brief Encodes changes of ezStats values into a compact binary stream, one frame at a time.
+///
+/// Stat names are interned, each name is only written once, the first time the stat is used. After that a stat is referenced by a small ID.
+/// Numeric values are delta encoded against the previous value of the same stat: integers store the difference, floating point values
+/// store the XOR of their bit patterns. Both are written as variable length integers, so slowly changing values only take a few bytes.
+/// Multiple changes of the same stat within one frame are coalesced.
+///
+/// Frames are self-contained with respect to the previously written frames, so a recording can be appended to frame by frame.
+/// \sa ezTelemetryRecordingDecoder, ezTelemetryRecorder
+class EZ_FOUNDATION_DLL ezTelemetryRecordingEncoder
+{
+public:
+  /// \brief Writes the header that has to precede the first frame of a recording.
+  static void WriteHeader(ezStreamWriter& stream);
+
+  /// \brief Records that the stat now has the given value. Written with the next EncodeFrame().
+  void SetStat(const char* szStatName, const ezVariant& value);
+
+  /// \brief Records that the stat has been removed. Written with the next EncodeFrame().
+  void RemoveStat(const char* szStatName);
+
+  /// \brief Returns the number of stats that changed since the last EncodeFrame().
+  ezUInt32 GetNumPendingChanges() const { return m_PendingChanges.GetCount(); }
+
+  /// \brief Writes all changes since the last frame. Does not write anything and returns false, if nothing changed.
+  bool EncodeFrame(ezTime frameTime, ezStreamWriter& stream);
+
+  /// \brief Forgets all interned names and previous values, the next frame can be written to a new stream.
+  void Reset();
+
+private:
+  struct StatState
+  {
+    ezString m_sName;
+    ezVariant m_PendingValue;
+    ezUInt64 m_uiPreviousBits = 0;
+    ezUInt8 m_uiPreviousType = 0;
+    bool m_bNameWritten = false;
+    bool m_bPending = false;
+    bool m_bPendingRemove = false;
+  };
+
+  StatState& GetStat(const char* szStatName);
+
+  ezHashTable<ezString, ezUInt32> m_StatIDs;
+  ezDeque<StatState> m_Stats;
+  ezDynamicArray<ezUInt32> m_PendingChanges;
+  ezDynamicArray<ezUInt8> m_FrameData;
+  ezTime m_LastFrameTime;
+};
+
+/// \brief Decodes a stream that was written with ezTelemetryRecordingEncoder.
+class EZ_FOUNDATION_DLL ezTelemetryRecordingDecoder
+{
+public:
+  struct StatChange
+  {
+    const char* m_szStatName = nullptr; ///< Stays valid until Reset() is called.
+    ezVariant m_Value;                   ///< Invalid, if the stat was removed.
+    bool m_bRemoved = false;
+  };
+
+  /// \brief Reads and validates the header of a recording.
+  ezResult ReadHeader(ezStreamReader& stream);
+
+  /// \brief Decodes the next frame. Fails at the end of the stream, or if the frame is incomplete or corrupted.
+  ezResult DecodeFrame(ezStreamReader& stream, ezTime& out_FrameTime, ezDynamicArray<StatChange>& out_Changes);
+
+  void Reset();
+
+private:
+  struct StatState
+  {
+    ezString m_sName;
+    ezUInt64 m_uiPreviousBits = 0;
+    ezUInt8 m_uiPreviousType = 0;
+  };
+
+  ezDeque<StatState> m_Stats;
+  ezTime m_LastFrameTime;
+};
+
+/// \brief Records all ezStats changes into a file, which can later be replayed with ezTelemetryRecordingPlayer.
+///
+/// While recording, every ezStats change is passed to an ezTelemetryRecordingEncoder and one frame is written per
+/// ezTelemetry::PerFrameUpdate(). EndFrame() can be called manually by applications that do not call ezTelemetry::PerFrameUpdate().
+class EZ_FOUNDATION_DLL ezTelemetryRecorder
+{
+public:
+  /// \brief Creates the file and starts recording. All stats that exist at this point are written into the first frame.
+  static ezResult StartRecording(const char* szFile);
+
+  /// \brief Writes the pending changes and closes the file.
+  static void StopRecording();
+
+  static bool IsRecording();
+
+  /// \brief Writes all stat changes since the previous frame to the file.
+  static void EndFrame();
+
+  /// \brief Returns the number of bytes that were written to the file so far.
+  static ezUInt64 GetRecordedBytes();
+};
+
+/// \brief Replays a recording that was written by ezTelemetryRecorder.
+///
+/// The stat changes are broadcast through ezTelemetry exactly like the InspectorPlugin broadcasts live stats,
+/// so ezInspector can connect to the application that plays the recording and display the stats and their history.
+/// The recorded time stamps are shifted, such that the first frame appears at the time at which Open() was called.
+class EZ_FOUNDATION_DLL ezTelemetryRecordingPlayer
+{
+public:
+  ezTelemetryRecordingPlayer();
+  ~ezTelemetryRecordingPlayer();
+
+  ezResult Open(const char* szFile);
+  void Close();
+
+  /// \brief Reads the next frame and broadcasts all of its changes. Returns EZ_FAILURE at the end of the recording.
+  ///
+  /// The caller decides about the playback speed, e.g. by comparing GetFrameTime() before and after the call.
+  ezResult PlayNextFrame();
+
+  /// \brief Returns the recorded time of the frame that was played last.
+  ezTime GetFrameTime() const { return m_FrameTime; }
+
+  /// \brief Returns the current value of all stats, as of the frame that was played last.
+  const ezMap<ezString, ezVariant>& GetStats() const { return m_Stats; }
+
+private:
+  void TelemetryEventHandler(const ezTelemetry::TelemetryEventData& e);
+  void SendAllStats();
+
+  ezFileReader m_File;
+  ezTelemetryRecordingDecoder m_Decoder;
+  ezDynamicArray<ezTelemetryRecordingDecoder::StatChange> m_Changes;
+  ezMap<ezString, ezVariant> m_Stats;
+  ezTime m_FrameTime;
+  ezTime m_TimeOffset;
+  bool m_bFirstFrame = true;
+};
@@ -6,6 +6,7 @@
 #include <Foundation/DataProcessing/Stream/ProcessingStreamProcessor.h>
 #include <Foundation/Logging/Log.h>
 #include <Foundation/Memory/MemoryUtils.h>
+#include <Foundation/Threading/TaskSystem.h>
 
 ezProcessingStreamGroup::ezProcessingStreamGroup()
 {
@@ -161,12 +162,22 @@ void ezProcessingStreamGroup::Process()
 {
   EnsureStreamAssignmentValid();
 
-  // TODO: Identify which processors work on which streams and find independent groups and use separate tasks for them?
   for (ezProcessingStreamProcessor* pStreamProcessor : m_Processors)
   {
+    if (pStreamProcessor->PrepareRangeProcessing(m_uiNumActiveElements))
+    {
+      m_RangeProcessors.PushBack(pStreamProcessor);
+      continue;
+    }
+
+    // everything batched so far has to be done before a regular processor may look at the data
+    ProcessRanges();
+
     pStreamProcessor->Process(m_uiNumActiveElements);
   }
 
+  ProcessRanges();
+
   // Run any pending deletions which happened due to stream processor execution
   RunPendingDeletions();
 
@@ -175,6 +186,44 @@ void ezProcessingStreamGroup::Process()
   RunPendingSpawns();
 }
 
+void ezProcessingStreamGroup::ProcessRanges()
+{
+  if (m_RangeProcessors.IsEmpty())
+    return;
+
+  const ezUInt64 uiNumElements = m_uiNumActiveElements;
+  const ezUInt64 uiChunkSize = m_uiParallelChunkSize;
+
+  if (uiChunkSize == 0 || uiNumElements < uiChunkSize * 2)
+  {
+    for (ezProcessingStreamProcessor* pStreamProcessor : m_RangeProcessors)
+    {
+      pStreamProcessor->ProcessRange(0, uiNumElements);
+    }
+  }
+  else
+  {
+    const ezUInt32 uiNumChunks = static_cast<ezUInt32>((uiNumElements + uiChunkSize - 1) / uiChunkSize);
+
+    ezTaskSystem::ParallelForIndexed(
+      0, uiNumChunks, [&](ezUInt32 uiStartChunk, ezUInt32 uiEndChunk) {
+        for (ezUInt32 uiChunk = uiStartChunk; uiChunk < uiEndChunk; ++uiChunk)
+        {
+          const ezUInt64 uiStartIndex = uiChunk * uiChunkSize;
+          const ezUInt64 uiCount = ezMath::Min(uiChunkSize, uiNumElements - uiStartIndex);
+
+          // run the chunk through all batched processors while it is still in the cache
+          for (ezProcessingStreamProcessor* pStreamProcessor : m_RangeProcessors)
+          {
+            pStreamProcessor->ProcessRange(uiStartIndex, uiCount);
+          }
+        }
+      },
+      "ezProcessingStreamGroup::ProcessRanges");
+  }
+
+  m_RangeProcessors.Clear();
+}
 
 void ezProcessingStreamGroup::RunPendingDeletions()
 {
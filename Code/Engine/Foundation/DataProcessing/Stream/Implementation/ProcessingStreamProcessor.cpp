@@ -19,6 +19,15 @@ ezProcessingStreamProcessor::~ezProcessingStreamProcessor()
   m_pStreamGroup = nullptr;
 }
 
+void ezProcessingStreamProcessor::Process(ezUInt64 uiNumElements)
+{
+  ProcessRange(0, uiNumElements);
+}
+
+void ezProcessingStreamProcessor::ProcessRange(ezUInt64 uiStartIndex, ezUInt64 uiNumElements)
+{
+  EZ_REPORT_FAILURE("Stream processor '{0}' implements neither Process() nor ProcessRange()", GetDynamicRTTI()->GetTypeName());
+}
 
 
 EZ_STATICLINK_FILE(Foundation, Foundation_DataProcessing_Stream_Implementation_ProcessingStreamProcessor);
@@ -67,6 +67,16 @@ public:
   /// \brief Runs the stream processors which have been added to the stream group.
   void Process();
 
+  /// \brief Sets the number of elements per chunk when processors that support range processing are executed on multiple threads.
+  ///
+  /// Consecutive processors that return true from ezProcessingStreamProcessor::PrepareRangeProcessing() are run chunk by chunk, so that the data of
+  /// one chunk stays in the cache for all of them. Once there are at least twice as many active elements as the chunk size, the chunks are
+  /// distributed across the task system. 0 (the default) processes everything on the calling thread. Should be a multiple of 4, so that SIMD
+  /// kernels don't have to deal with partial chunks.
+  void SetParallelChunkSize(ezUInt32 uiChunkSize) { m_uiParallelChunkSize = uiChunkSize; }
+
+  ezUInt32 GetParallelChunkSize() const { return m_uiParallelChunkSize; }
+
   /// \brief Returns the number of elements the streams store.
   inline ezUInt64 GetNumElements() const { return m_uiNumElements; }
 
@@ -89,8 +99,13 @@ private:
 
   void SortProcessorsByPriority();
 
+  void ProcessRanges();
+
   ezHybridArray<ezProcessingStreamProcessor*, 8> m_Processors;
 
+  /// Processors that are batched for the next ProcessRanges() call
+  ezHybridArray<ezProcessingStreamProcessor*, 8> m_RangeProcessors;
+
   ezHybridArray<ezProcessingStream*, 8> m_DataStreams;
 
   ezHybridArray<ezUInt64, 64> m_PendingRemoveIndices;
@@ -103,5 +118,7 @@ private:
 
   ezUInt64 m_uiHighestNumActiveElements;
 
+  ezUInt32 m_uiParallelChunkSize = 0;
+
   bool m_bStreamAssignmentDirty;
 };
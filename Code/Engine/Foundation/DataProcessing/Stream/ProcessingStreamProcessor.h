@@ -33,7 +33,21 @@ protected:
   virtual void InitializeElements(ezUInt64 uiStartIndex, ezUInt64 uiNumElements) = 0;
 
   /// \brief The actual method which processes the data, will be called with the number of elements to process.
-  virtual void Process(ezUInt64 uiNumElements) = 0;
+  /// The default implementation processes all elements with ProcessRange(), so processors that support range processing only need to
+  /// implement ProcessRange(). Every processor has to implement one of the two.
+  virtual void Process(ezUInt64 uiNumElements);
+
+  /// \brief Called right before the processor would be executed. Return true to have the elements processed through ProcessRange() instead of
+  /// Process().
+  ///
+  /// The stream group may then split the elements into chunks and call ProcessRange() for different chunks concurrently, so ProcessRange() must
+  /// only access the elements in its range and state that was set up here. This function must not access any element data itself, since
+  /// preceding processors may not have run yet.
+  virtual bool PrepareRangeProcessing(ezUInt64 uiNumElements) { return false; }
+
+  /// \brief Processes the elements in the range [uiStartIndex; uiStartIndex + uiNumElements). Called concurrently for different ranges if
+  /// PrepareRangeProcessing() returned true, otherwise only through the default implementation of Process().
+  virtual void ProcessRange(ezUInt64 uiStartIndex, ezUInt64 uiNumElements);
 
   /// \brief Back pointer to the stream group - will be set to the owner stream group when adding the stream processor to the group.
   /// Can be used to get stream pointers in UpdateStreamBindings();
@@ -405,6 +405,19 @@ done:
   return Res;
 }
 
+ezResult ezOSFile::MoveFileOrDirectory(const char* szSource, const char* szDestination)
+{
+  ezStringBuilder sSource(szSource);
+  sSource.MakeCleanPath();
+  sSource.MakePathSeparatorsNative();
+
+  ezStringBuilder sDestination(szDestination);
+  sDestination.MakeCleanPath();
+  sDestination.MakePathSeparatorsNative();
+
+  return InternalMoveFileOrDirectory(sSource, sDestination);
+}
+
 #if EZ_ENABLED(EZ_SUPPORTS_FILE_STATS)
 
 ezResult ezOSFile::GetFileStats(const char* szFileOrFolder, ezFileStats& out_Stats)
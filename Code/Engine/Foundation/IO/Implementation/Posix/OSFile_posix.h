@@ -226,6 +226,19 @@ ezResult ezOSFile::InternalDeleteFile(const char* szFile)
   return EZ_FAILURE;
 }
 
+ezResult ezOSFile::InternalMoveFileOrDirectory(const char* szSource, const char* szDestination)
+{
+#if EZ_ENABLED(EZ_PLATFORM_WINDOWS)
+  // rename() does not replace existing files here
+  _unlink(szDestination);
+#endif
+
+  if (rename(szSource, szDestination) != 0)
+    return EZ_FAILURE;
+
+  return EZ_SUCCESS;
+}
+
 ezResult ezOSFile::InternalDeleteDirectory(const char* szDirectory)
 {
 #if EZ_ENABLED(EZ_PLATFORM_WINDOWS)
@@ -247,6 +247,14 @@ ezResult ezOSFile::InternalDeleteFile(const char* szFile)
   return EZ_SUCCESS;
 }
 
+ezResult ezOSFile::InternalMoveFileOrDirectory(const char* szSource, const char* szDestination)
+{
+  if (MoveFileExW(ezDosDevicePath(szSource), ezDosDevicePath(szDestination), MOVEFILE_REPLACE_EXISTING) == FALSE)
+    return EZ_FAILURE;
+
+  return EZ_SUCCESS;
+}
+
 ezResult ezOSFile::InternalDeleteDirectory(const char* szDirectory)
 {
   if (RemoveDirectoryW(ezDosDevicePath(szDirectory)) == FALSE)
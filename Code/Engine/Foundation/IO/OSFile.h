@@ -222,6 +222,11 @@ public:
   /// \brief Copies the source file into the destination file.
   static ezResult CopyFile(const char* szSource, const char* szDestination); // [tested]
 
+  /// \brief Renames or moves the given file or directory. An existing destination file is replaced.
+  ///
+  /// Within the same volume this is atomic, so others either see the old or the new destination file, never a partially written one.
+  static ezResult MoveFileOrDirectory(const char* szSource, const char* szDestination); // [tested]
+
 #if EZ_ENABLED(EZ_SUPPORTS_FILE_STATS) || defined(EZ_DOCS)
   /// \brief Gets the stats about the given file or folder. Returns false, if the stats could not be determined.
   static ezResult GetFileStats(const char* szFileOrFolder, ezFileStats& out_Stats); // [tested]
@@ -357,6 +362,7 @@ private:
   static ezResult InternalDeleteFile(const char* szFile);
   static ezResult InternalDeleteDirectory(const char* szDirectory);
   static ezResult InternalCreateDirectory(const char* szFile);
+  static ezResult InternalMoveFileOrDirectory(const char* szSource, const char* szDestination);
 
 #if EZ_ENABLED(EZ_SUPPORTS_FILE_STATS)
   static ezResult InternalGetFileStats(const char* szFileOrFolder, ezFileStats& out_Stats);
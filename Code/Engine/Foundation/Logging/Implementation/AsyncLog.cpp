@@ -0,0 +1,517 @@
+#include <Foundation/FoundationPCH.h>
+
+#include <Foundation/Configuration/Startup.h>
+#include <Foundation/Containers/HybridArray.h>
+#include <Foundation/Logging/Log.h>
+#include <Foundation/Threading/AtomicUtils.h>
+#include <Foundation/Threading/Lock.h>
+#include <Foundation/Threading/Thread.h>
+#include <Foundation/Threading/ThreadSignal.h>
+#include <Foundation/Threading/ThreadUtils.h>
+
+namespace
+{
+  /// Header of every message in a thread's ring buffer, followed by the zero terminated tag and text.
+  struct AsyncLogRecord
+  {
+    ezUInt32 m_uiSize; ///< Size of the whole record, including the header. Records that only pad the end of the buffer have no text.
+    ezInt8 m_Type;
+    ezUInt8 m_uiIndentation;
+    ezUInt16 m_uiTagLength;
+    ezUInt32 m_uiTextLength;
+    ezUInt32 m_uiPadding;
+    ezInt64 m_iSequence; ///< Global message order, used to merge the messages of all threads.
+    double m_fSeconds;
+  };
+
+  // all records are a multiple of the header size, so that a header always fits in front of the end of the buffer
+  static_assert(sizeof(AsyncLogRecord) == 32, "Unexpected record header size");
+
+  constexpr ezInt8 s_PaddingRecordType = ezLogMsgType::ENUM_COUNT;
+
+  /// Space at the end of each buffer that only group end messages may use, so that groups stay balanced when messages are dropped.
+  constexpr ezUInt32 s_uiGroupEndReserve = 2 * 1024;
+  constexpr ezUInt32 s_uiMaxGroupEndTextLength = 128;
+
+  /// Single producer, single consumer ring buffer. Only the owning thread writes, only the async log thread reads.
+  struct AsyncLogBuffer
+  {
+    ezUInt8* m_pData = nullptr;
+    ezUInt32 m_uiCapacity = 0; ///< power of two
+    volatile ezInt64 m_iWritePos = 0;
+    volatile ezInt64 m_iReadPos = 0;
+    volatile ezInt64 m_iPendingSequence = ezMath::MaxValue<ezInt64>(); ///< Lower bound of the sequence of the message that is currently being written.
+    volatile ezInt32 m_iNumDropped = 0;
+    volatile ezInt32 m_iThreadExited = 0;
+    ezUInt32 m_uiDroppedGroups = 0; ///< One bit per group depth, for groups whose begin message was dropped. Only used by the owner.
+    AsyncLogBuffer* m_pNext = nullptr;
+  };
+
+  struct AsyncLogThreadState
+  {
+    AsyncLogBuffer* m_pBuffer;
+    ezUInt32 m_uiEpoch;
+    bool m_bExited;
+    bool m_bRegisteredExitCallback;
+  };
+
+  thread_local AsyncLogThreadState t_AsyncLogState;
+
+  EZ_ALWAYS_INLINE ezUInt32 GetRecordSize(ezUInt32 uiTagLength, ezUInt32 uiTextLength)
+  {
+    const ezUInt32 uiSize = sizeof(AsyncLogRecord) + uiTagLength + 1 + uiTextLength + 1;
+    return (uiSize + sizeof(AsyncLogRecord) - 1) & ~static_cast<ezUInt32>(sizeof(AsyncLogRecord) - 1);
+  }
+} // namespace
+
+/// \brief Owns the per-thread buffers and the thread that passes their messages on to the log writers.
+class ezAsyncLogPipeline : public ezThread
+{
+public:
+  ezAsyncLogPipeline()
+    : ezThread("Async Log")
+  {
+  }
+
+  static bool IsEnabled() { return ezAtomicUtils::Read(s_iEnabled) != 0; }
+
+  static void Enable(ezUInt32 uiBufferSizePerThread)
+  {
+    EZ_LOCK(s_StateMutex);
+
+    if (s_pPipeline != nullptr)
+      return;
+
+    s_uiBufferSize = ezMath::PowerOfTwo_Ceil(ezMath::Max(uiBufferSizePerThread, 4 * s_uiGroupEndReserve));
+
+    s_pPipeline = EZ_DEFAULT_NEW(ezAsyncLogPipeline);
+    s_pPipeline->Start();
+
+    ezAtomicUtils::Increment(s_iEpoch);
+    ezAtomicUtils::Set(s_iEnabled, 1);
+  }
+
+  static void Disable()
+  {
+    EZ_LOCK(s_StateMutex);
+
+    if (s_pPipeline == nullptr)
+      return;
+
+    // new messages are logged synchronously from now on, wait until all threads that are currently queuing a message are done
+    ezAtomicUtils::Set(s_iEnabled, 0);
+    ezAtomicUtils::Increment(s_iEpoch);
+
+    while (ezAtomicUtils::Read(s_iNumActiveProducers) != 0)
+    {
+      ezThreadUtils::YieldTimeSlice();
+    }
+
+    s_pPipeline->m_bStop = true;
+    s_pPipeline->m_WakeUp.RaiseSignal();
+    s_pPipeline->Join();
+    EZ_DEFAULT_DELETE(s_pPipeline);
+
+    EZ_LOCK(s_BuffersMutex);
+
+    while (s_pBuffers != nullptr)
+    {
+      AsyncLogBuffer* pBuffer = s_pBuffers;
+      s_pBuffers = pBuffer->m_pNext;
+      DeleteBuffer(pBuffer);
+    }
+  }
+
+  static bool QueueMessage(const ezLoggingEventData& le)
+  {
+    AsyncLogThreadState& state = t_AsyncLogState;
+
+    if (!IsEnabled() || state.m_bExited)
+      return false;
+
+    // messages that the log writers write themselves can't wait for the log thread
+    if (s_ThreadID == ezThreadUtils::GetCurrentThreadID())
+      return false;
+
+    ezAtomicUtils::Increment(s_iNumActiveProducers);
+
+    bool bQueued = false;
+    const ezUInt32 uiEpoch = static_cast<ezUInt32>(ezAtomicUtils::Read(s_iEpoch));
+
+    if (IsEnabled())
+    {
+      if (state.m_pBuffer == nullptr || state.m_uiEpoch != uiEpoch)
+      {
+        state.m_pBuffer = CreateBuffer();
+        state.m_uiEpoch = uiEpoch;
+      }
+
+      WriteMessage(*state.m_pBuffer, le);
+      bQueued = true;
+    }
+
+    ezAtomicUtils::Decrement(s_iNumActiveProducers);
+    return bQueued;
+  }
+
+  static void OnThreadExit()
+  {
+    AsyncLogThreadState& state = t_AsyncLogState;
+    state.m_bExited = true;
+
+    ezAtomicUtils::Increment(s_iNumActiveProducers);
+
+    // the buffer is deleted by the log thread, once it is empty
+    if (state.m_pBuffer != nullptr && IsEnabled() && state.m_uiEpoch == static_cast<ezUInt32>(ezAtomicUtils::Read(s_iEpoch)))
+    {
+      ezAtomicUtils::Set(state.m_pBuffer->m_iThreadExited, 1);
+    }
+
+    state.m_pBuffer = nullptr;
+
+    ezAtomicUtils::Decrement(s_iNumActiveProducers);
+  }
+
+  static void WaitForMessages()
+  {
+    if (!IsEnabled() || ezThreadUtils::GetCurrentThreadID() == s_ThreadID)
+      return;
+
+    EZ_LOCK(s_StateMutex);
+
+    const ezInt64 iNumQueued = ezAtomicUtils::Read(s_iNextSequence);
+
+    while (IsEnabled() && ezAtomicUtils::Read(s_iNumCompleted) < iNumQueued)
+    {
+      s_pPipeline->m_WakeUp.RaiseSignal();
+      ezThreadUtils::Sleep(ezTime::Milliseconds(1));
+    }
+  }
+
+  static ezUInt64 GetNumDropped() { return static_cast<ezUInt64>(ezAtomicUtils::Read(s_iNumDroppedTotal)); }
+
+private:
+  static AsyncLogBuffer* CreateBuffer()
+  {
+    // a thread that exits hands its buffer over to the log thread
+    if (!t_AsyncLogState.m_bRegisteredExitCallback)
+    {
+      t_AsyncLogState.m_bRegisteredExitCallback = true;
+      ezThreadUtils::AddThreadExitCallback(&ezAsyncLogPipeline::OnThreadExit);
+    }
+
+    // use new, not EZ_DEFAULT_NEW, to prevent tracking, same as the thread local log systems
+    AsyncLogBuffer* pBuffer = new AsyncLogBuffer;
+    pBuffer->m_uiCapacity = s_uiBufferSize;
+    pBuffer->m_pData = new ezUInt8[s_uiBufferSize];
+
+    EZ_LOCK(s_BuffersMutex);
+    pBuffer->m_pNext = s_pBuffers;
+    s_pBuffers = pBuffer;
+
+    return pBuffer;
+  }
+
+  static void DeleteBuffer(AsyncLogBuffer* pBuffer)
+  {
+    delete[] pBuffer->m_pData;
+    delete pBuffer;
+  }
+
+  static void WriteMessage(AsyncLogBuffer& buffer, const ezLoggingEventData& le)
+  {
+    // announced before the sequence is taken, so that the log thread doesn't pass on any later messages until this one is published
+    ezAtomicUtils::Set(buffer.m_iPendingSequence, ezAtomicUtils::Read(s_iNextSequence));
+
+    const ezInt64 iSequence = ezAtomicUtils::PostIncrement(s_iNextSequence);
+    WriteRecord(buffer, le, iSequence);
+
+    ezAtomicUtils::Set(buffer.m_iPendingSequence, ezMath::MaxValue<ezInt64>());
+  }
+
+  static void WriteRecord(AsyncLogBuffer& buffer, const ezLoggingEventData& le, ezInt64 iSequence)
+  {
+    // groups whose begin message was dropped also drop their end message, all other end messages use the reserve
+    const bool bGroupEnd = le.m_EventType == ezLogMsgType::EndGroup;
+    const ezUInt32 uiGroupBit = le.m_uiIndentation < 32 ? (1u << le.m_uiIndentation) : 0;
+
+    if (bGroupEnd && (buffer.m_uiDroppedGroups & uiGroupBit) != 0)
+    {
+      buffer.m_uiDroppedGroups &= ~uiGroupBit;
+      ezAtomicUtils::Increment(s_iNumCompleted);
+      return;
+    }
+
+    const char* szText = le.m_szText != nullptr ? le.m_szText : "";
+    const char* szTag = le.m_szTag != nullptr ? le.m_szTag : "";
+
+    const ezUInt32 uiMaxTextLength = bGroupEnd ? s_uiMaxGroupEndTextLength : buffer.m_uiCapacity / 8;
+    const ezUInt32 uiTagLength = ezMath::Min(ezStringUtils::GetStringElementCount(szTag), 255u);
+    const ezUInt32 uiTextLength = ezMath::Min(ezStringUtils::GetStringElementCount(szText), uiMaxTextLength);
+    const ezUInt32 uiRecordSize = GetRecordSize(uiTagLength, uiTextLength);
+
+    const ezInt64 iWritePos = buffer.m_iWritePos;
+    const ezUInt32 uiOffset = static_cast<ezUInt32>(iWritePos & (buffer.m_uiCapacity - 1));
+    const ezUInt32 uiContiguous = buffer.m_uiCapacity - uiOffset;
+    const ezUInt32 uiPaddingSize = uiContiguous < uiRecordSize ? uiContiguous : 0;
+
+    const ezUInt32 uiFree = buffer.m_uiCapacity - static_cast<ezUInt32>(iWritePos - ezAtomicUtils::Read(buffer.m_iReadPos));
+    const ezUInt32 uiReserve = bGroupEnd ? 0 : s_uiGroupEndReserve;
+
+    if (uiPaddingSize + uiRecordSize + uiReserve > uiFree)
+    {
+      if (le.m_EventType == ezLogMsgType::BeginGroup)
+        buffer.m_uiDroppedGroups |= uiGroupBit;
+
+      ezAtomicUtils::Increment(buffer.m_iNumDropped);
+      ezAtomicUtils::Increment(s_iNumDroppedTotal);
+      ezAtomicUtils::Increment(s_iNumCompleted);
+      return;
+    }
+
+    if (uiPaddingSize != 0)
+    {
+      AsyncLogRecord* pPadding = reinterpret_cast<AsyncLogRecord*>(buffer.m_pData + uiOffset);
+      pPadding->m_uiSize = uiPaddingSize;
+      pPadding->m_Type = s_PaddingRecordType;
+    }
+
+    AsyncLogRecord* pRecord = reinterpret_cast<AsyncLogRecord*>(buffer.m_pData + ((uiOffset + uiPaddingSize) & (buffer.m_uiCapacity - 1)));
+    pRecord->m_uiSize = uiRecordSize;
+    pRecord->m_Type = le.m_EventType;
+    pRecord->m_uiIndentation = le.m_uiIndentation;
+    pRecord->m_uiTagLength = static_cast<ezUInt16>(uiTagLength);
+    pRecord->m_uiTextLength = uiTextLength;
+    pRecord->m_iSequence = iSequence;
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+    pRecord->m_fSeconds = le.m_fSeconds;
+#else
+    pRecord->m_fSeconds = 0;
+#endif
+
+    char* pStrings = reinterpret_cast<char*>(pRecord + 1);
+    ezMemoryUtils::Copy(pStrings, szTag, uiTagLength);
+    pStrings[uiTagLength] = '\0';
+    ezMemoryUtils::Copy(pStrings + uiTagLength + 1, szText, uiTextLength);
+    pStrings[uiTagLength + 1 + uiTextLength] = '\0';
+
+    // publishes the record, the atomic add is a full barrier
+    ezAtomicUtils::Add(buffer.m_iWritePos, uiPaddingSize + uiRecordSize);
+
+    if (le.m_EventType == ezLogMsgType::ErrorMsg || le.m_EventType == ezLogMsgType::Flush)
+    {
+      s_pPipeline->m_WakeUp.RaiseSignal();
+    }
+  }
+
+  /// Returns the next record of the buffer, skipping padding, or nullptr if the buffer is empty.
+  static AsyncLogRecord* PeekRecord(AsyncLogBuffer& buffer)
+  {
+    while (true)
+    {
+      const ezInt64 iReadPos = buffer.m_iReadPos;
+      if (iReadPos == ezAtomicUtils::Read(buffer.m_iWritePos))
+        return nullptr;
+
+      AsyncLogRecord* pRecord = reinterpret_cast<AsyncLogRecord*>(buffer.m_pData + (iReadPos & (buffer.m_uiCapacity - 1)));
+      if (pRecord->m_Type != s_PaddingRecordType)
+        return pRecord;
+
+      ezAtomicUtils::Add(buffer.m_iReadPos, pRecord->m_uiSize);
+    }
+  }
+
+  static void ReportDroppedMessages(AsyncLogBuffer& buffer)
+  {
+    if (buffer.m_iNumDropped == 0)
+      return;
+
+    const ezInt32 iNumDropped = ezAtomicUtils::Set(buffer.m_iNumDropped, 0);
+
+    char szText[128];
+    ezStringUtils::snprintf(szText, EZ_ARRAY_SIZE(szText), "%i log messages of a thread were dropped, because its async log buffer was full.", iNumDropped);
+
+    ezLoggingEventData le;
+    le.m_EventType = ezLogMsgType::WarningMsg;
+    le.m_szText = szText;
+    le.m_szTag = "AsyncLog";
+    ezGlobalLog::s_LoggingEvent.Broadcast(le);
+  }
+
+  /// Passes all queued messages to the log writers, in the order in which they were logged.
+  void ProcessMessages()
+  {
+    m_Buffers.Clear();
+
+    // all messages with a lower sequence are either published or dropped, unless a buffer announced a pending one
+    // this has to be read before the buffers, so that new buffers of threads that already took a lower sequence are included
+    ezInt64 iSequenceLimit = ezAtomicUtils::Read(s_iNextSequence);
+
+    {
+      EZ_LOCK(s_BuffersMutex);
+
+      // buffers of threads that exited are deleted once they are empty, new messages can't be added to them anymore
+      for (AsyncLogBuffer** ppBuffer = &s_pBuffers; *ppBuffer != nullptr;)
+      {
+        AsyncLogBuffer* pBuffer = *ppBuffer;
+
+        if (ezAtomicUtils::Read(pBuffer->m_iThreadExited) != 0 && PeekRecord(*pBuffer) == nullptr)
+        {
+          ReportDroppedMessages(*pBuffer);
+
+          *ppBuffer = pBuffer->m_pNext;
+          DeleteBuffer(pBuffer);
+          continue;
+        }
+
+        m_Buffers.PushBack(pBuffer);
+        ppBuffer = &pBuffer->m_pNext;
+
+        iSequenceLimit = ezMath::Min(iSequenceLimit, ezAtomicUtils::Read(pBuffer->m_iPendingSequence));
+      }
+    }
+
+    // don't take forever, if the other threads log faster than the writers can keep up with
+    for (ezUInt32 uiNumProcessed = 0; uiNumProcessed < 16 * 1024; ++uiNumProcessed)
+    {
+      AsyncLogBuffer* pNextBuffer = nullptr;
+      AsyncLogRecord* pNextRecord = nullptr;
+
+      for (AsyncLogBuffer* pBuffer : m_Buffers)
+      {
+        AsyncLogRecord* pRecord = PeekRecord(*pBuffer);
+
+        if (pRecord != nullptr && (pNextRecord == nullptr || pRecord->m_iSequence < pNextRecord->m_iSequence))
+        {
+          pNextBuffer = pBuffer;
+          pNextRecord = pRecord;
+        }
+      }
+
+      // messages after one that is still being written are passed on in the next pass
+      if (pNextRecord == nullptr || pNextRecord->m_iSequence >= iSequenceLimit)
+        break;
+
+      const char* szTag = reinterpret_cast<const char*>(pNextRecord + 1);
+
+      ezLoggingEventData le;
+      le.m_EventType = static_cast<ezLogMsgType::Enum>(pNextRecord->m_Type);
+      le.m_uiIndentation = pNextRecord->m_uiIndentation;
+      le.m_szTag = szTag;
+      le.m_szText = szTag + pNextRecord->m_uiTagLength + 1;
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+      le.m_fSeconds = pNextRecord->m_fSeconds;
+#endif
+
+      ezGlobalLog::s_LoggingEvent.Broadcast(le);
+
+      ezAtomicUtils::Add(pNextBuffer->m_iReadPos, pNextRecord->m_uiSize);
+      ezAtomicUtils::Increment(s_iNumCompleted);
+    }
+
+    for (AsyncLogBuffer* pBuffer : m_Buffers)
+    {
+      ReportDroppedMessages(*pBuffer);
+    }
+  }
+
+  virtual ezUInt32 Run() override
+  {
+    s_ThreadID = ezThreadUtils::GetCurrentThreadID();
+
+    while (!m_bStop)
+    {
+      m_WakeUp.WaitForSignal(ezTime::Milliseconds(10));
+      ProcessMessages();
+    }
+
+    // no new messages can be queued anymore, write everything that is left
+    while (true)
+    {
+      const ezInt64 iNumCompleted = ezAtomicUtils::Read(s_iNumCompleted);
+      ProcessMessages();
+
+      if (iNumCompleted == ezAtomicUtils::Read(s_iNumCompleted))
+        break;
+    }
+
+    s_ThreadID = ezThreadID();
+    return 0;
+  }
+
+  volatile bool m_bStop = false;
+  ezThreadSignal m_WakeUp;
+  ezHybridArray<AsyncLogBuffer*, 32> m_Buffers;
+
+  static ezMutex s_StateMutex;
+  static ezMutex s_BuffersMutex;
+  static ezAsyncLogPipeline* s_pPipeline;
+  static AsyncLogBuffer* s_pBuffers;
+  static ezThreadID s_ThreadID;
+  static ezUInt32 s_uiBufferSize;
+  static volatile ezInt32 s_iEnabled;
+  static volatile ezInt32 s_iEpoch;
+  static volatile ezInt32 s_iNumActiveProducers;
+  static volatile ezInt64 s_iNextSequence;
+  static volatile ezInt64 s_iNumCompleted;
+  static volatile ezInt64 s_iNumDroppedTotal;
+};
+
+ezMutex ezAsyncLogPipeline::s_StateMutex;
+ezMutex ezAsyncLogPipeline::s_BuffersMutex;
+ezAsyncLogPipeline* ezAsyncLogPipeline::s_pPipeline = nullptr;
+AsyncLogBuffer* ezAsyncLogPipeline::s_pBuffers = nullptr;
+ezThreadID ezAsyncLogPipeline::s_ThreadID;
+ezUInt32 ezAsyncLogPipeline::s_uiBufferSize = 0;
+volatile ezInt32 ezAsyncLogPipeline::s_iEnabled = 0;
+volatile ezInt32 ezAsyncLogPipeline::s_iEpoch = 0;
+volatile ezInt32 ezAsyncLogPipeline::s_iNumActiveProducers = 0;
+volatile ezInt64 ezAsyncLogPipeline::s_iNextSequence = 0;
+volatile ezInt64 ezAsyncLogPipeline::s_iNumCompleted = 0;
+volatile ezInt64 ezAsyncLogPipeline::s_iNumDroppedTotal = 0;
+
+// clang-format off
+EZ_BEGIN_SUBSYSTEM_DECLARATION(Foundation, AsyncLog)
+
+  BEGIN_SUBSYSTEM_DEPENDENCIES
+    "ThreadUtils",
+    "Time"
+  END_SUBSYSTEM_DEPENDENCIES
+
+  ON_CORESYSTEMS_SHUTDOWN
+  {
+    ezGlobalLog::SetAsyncMode(false);
+  }
+
+EZ_END_SUBSYSTEM_DECLARATION;
+// clang-format on
+
+void ezGlobalLog::SetAsyncMode(bool bEnable, ezUInt32 uiBufferSizePerThread)
+{
+  if (bEnable)
+    ezAsyncLogPipeline::Enable(uiBufferSizePerThread);
+  else
+    ezAsyncLogPipeline::Disable();
+}
+
+bool ezGlobalLog::IsAsyncModeEnabled()
+{
+  return ezAsyncLogPipeline::IsEnabled();
+}
+
+void ezGlobalLog::WaitForAsyncMessages()
+{
+  ezAsyncLogPipeline::WaitForMessages();
+}
+
+ezUInt64 ezGlobalLog::GetNumDroppedMessages()
+{
+  return ezAsyncLogPipeline::GetNumDropped();
+}
+
+bool ezGlobalLog::QueueAsyncMessage(const ezLoggingEventData& le)
+{
+  return ezAsyncLogPipeline::QueueMessage(le);
+}
+
+EZ_STATICLINK_FILE(Foundation, Foundation_Logging_Implementation_AsyncLog);
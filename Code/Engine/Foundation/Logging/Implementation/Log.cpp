@@ -77,6 +77,9 @@ void ezGlobalLog::HandleLogMessage(const ezLoggingEventData& le)
     if ((ThisType > ezLogMsgType::None) && (ThisType < ezLogMsgType::All))
       s_uiMessageCount[ThisType].Increment();
 
+    if (QueueAsyncMessage(le))
+      return;
+
     s_LoggingEvent.Broadcast(le);
   }
 }
@@ -139,7 +139,36 @@ public:
   /// override is set at the moment.
   static void SetGlobalLogOverride(ezLogInterface* pInterface);
 
+  /// \brief Enables or disables asynchronous logging.
+  ///
+  /// In asynchronous mode, messages are copied into a lock-free ring buffer of the logging thread and a dedicated thread passes them on
+  /// to the log writers. Logging then does not block on the log writers anymore, e.g. on file I/O, which is important for verbose logging
+  /// from worker threads. The message text is still formatted on the logging thread, since the arguments may reference temporary data.
+  ///
+  /// The writers receive the messages of all threads in the order in which they were logged.
+  /// Each thread gets a buffer of \a uiBufferSizePerThread bytes. When a buffer is full, new messages of that thread are dropped and
+  /// the number of dropped messages is reported once there is space again.
+  /// Messages that are logged by the log writers themselves are handled synchronously.
+  ///
+  /// Disabling the async mode passes all pending messages to the writers before it returns.
+  /// The mode is disabled automatically during the core systems shutdown.
+  static void SetAsyncMode(bool bEnable, ezUInt32 uiBufferSizePerThread = 64 * 1024);
+
+  /// \brief Returns whether messages are passed to the log writers asynchronously.
+  static bool IsAsyncModeEnabled();
+
+  /// \brief Blocks until all messages that were logged before the call have been passed to the log writers. Does nothing in synchronous mode.
+  static void WaitForAsyncMessages();
+
+  /// \brief Returns how many messages were dropped in async mode, because the buffer of the logging thread was full.
+  static ezUInt64 GetNumDroppedMessages();
+
 private:
+  friend class ezAsyncLogPipeline;
+
+  /// \brief Queues the message for the async log thread. Returns false, if the message has to be passed to the log writers directly.
+  static bool QueueAsyncMessage(const ezLoggingEventData& le);
+
   /// \brief Counts the number of messages of each type.
   static ezAtomicInteger32 s_uiMessageCount[ezLogMsgType::ENUM_COUNT];
 
@@ -32,6 +32,9 @@ public:
 
     ezUInt64 m_uiPerFrameAllocationSize = 0; ///< allocation size in bytes in this frame
     ezTime m_PerFrameAllocationTime;         ///< time spend on allocations in this frame
+
+    ezUInt64 m_uiReservedSize = 0; ///< memory in bytes that the allocator holds on to for future allocations, including the used part (if supported)
+    ezUInt64 m_uiCachedSize = 0;   ///< part of the reserved memory in bytes that is currently unused (if supported)
   };
 
   ezAllocatorBase();
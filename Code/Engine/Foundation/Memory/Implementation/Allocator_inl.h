@@ -1,5 +1,18 @@
 namespace ezInternal
 {
+  /// \brief Lets allocation policies add their own information, e.g. about cached memory, to the allocator stats.
+  template <typename AllocationPolicy, bool HasGetStats>
+  struct ezAllocationPolicyStats
+  {
+    EZ_ALWAYS_INLINE static void GetStats(const AllocationPolicy& policy, ezAllocatorBase::Stats& inout_Stats) {}
+  };
+
+  template <typename AllocationPolicy>
+  struct ezAllocationPolicyStats<AllocationPolicy, true>
+  {
+    EZ_ALWAYS_INLINE static void GetStats(const AllocationPolicy& policy, ezAllocatorBase::Stats& inout_Stats) { policy.GetStats(inout_Stats); }
+  };
+
   template <typename AllocationPolicy, ezUInt32 TrackingFlags>
   class ezAllocatorImpl : public ezAllocatorBase
   {
@@ -44,6 +57,9 @@ EZ_FORCE_INLINE ezInternal::ezAllocatorImpl<A, TrackingFlags>::ezAllocatorImpl(c
   : m_allocator(pParent)
   , m_ThreadID(ezThreadUtils::GetCurrentThreadID())
 {
+  EZ_CHECK_AT_COMPILETIME_MSG((TrackingFlags & ezMemoryTrackingFlags::EnableSampling) == 0 || (TrackingFlags & ezMemoryTrackingFlags::RegisterAllocator) != 0,
+    "Sampling requires a registered allocator");
+
   if ((TrackingFlags & ezMemoryTrackingFlags::RegisterAllocator) != 0)
   {
     EZ_CHECK_AT_COMPILETIME_MSG((TrackingFlags & ~ezMemoryTrackingFlags::All) == 0, "Invalid tracking flags");
@@ -73,7 +89,11 @@ void* ezInternal::ezAllocatorImpl<A, TrackingFlags>::Allocate(size_t uiSize, siz
 
   EZ_ASSERT_DEBUG(ezMath::IsPowerOf2((ezUInt32)uiAlign), "Alignment must be power of two");
 
-  ezTime fAllocationTime = ezTime::Now();
+  ezTime fAllocationTime;
+  if ((TrackingFlags & ezMemoryTrackingFlags::EnableAllocationTracking) != 0)
+  {
+    fAllocationTime = ezTime::Now();
+  }
 
   void* ptr = m_allocator.Allocate(uiSize, uiAlign);
   EZ_ASSERT_DEV(ptr != nullptr, "Could not allocate {0} bytes. Out of memory?", uiSize);
@@ -85,6 +105,10 @@ void* ezInternal::ezAllocatorImpl<A, TrackingFlags>::Allocate(size_t uiSize, siz
 
     ezMemoryTracker::AddAllocation(this->m_Id, flags, ptr, uiSize, uiAlign, ezTime::Now() - fAllocationTime);
   }
+  else if ((TrackingFlags & ezMemoryTrackingFlags::EnableSampling) != 0)
+  {
+    ezMemoryTracker::SampleAllocation(this->m_Id, ptr, uiSize);
+  }
 
   return ptr;
 }
@@ -96,6 +120,10 @@ void ezInternal::ezAllocatorImpl<A, TrackingFlags>::Deallocate(void* ptr)
   {
     ezMemoryTracker::RemoveAllocation(this->m_Id, ptr);
   }
+  else if ((TrackingFlags & ezMemoryTrackingFlags::EnableSampling) != 0)
+  {
+    ezMemoryTracker::RemoveSampledAllocation(this->m_Id, ptr);
+  }
 
   m_allocator.Deallocate(ptr);
 }
@@ -120,12 +148,15 @@ ezAllocatorId ezInternal::ezAllocatorImpl<A, TrackingFlags>::GetId() const
 template <typename A, ezUInt32 TrackingFlags>
 ezAllocatorBase::Stats ezInternal::ezAllocatorImpl<A, TrackingFlags>::GetStats() const
 {
+  Stats stats;
+
   if ((TrackingFlags & ezMemoryTrackingFlags::RegisterAllocator) != 0)
   {
-    return ezMemoryTracker::GetAllocatorStats(this->m_Id);
+    stats = ezMemoryTracker::GetAllocatorStats(this->m_Id);
   }
 
-  return Stats();
+  ezAllocationPolicyStats<A, ezHasGetStats<A, void (A::*)(Stats&) const>::value>::GetStats(m_allocator, stats);
+  return stats;
 }
 
 template <typename A, ezUInt32 TrackingFlags>
@@ -153,8 +184,16 @@ void* ezInternal::ezAllocatorMixinReallocate<A, TrackingFlags, true>::Reallocate
   {
     ezMemoryTracker::RemoveAllocation(this->m_Id, ptr);
   }
+  else if ((TrackingFlags & ezMemoryTrackingFlags::EnableSampling) != 0)
+  {
+    ezMemoryTracker::RemoveSampledAllocation(this->m_Id, ptr);
+  }
 
-  ezTime fAllocationTime = ezTime::Now();
+  ezTime fAllocationTime;
+  if ((TrackingFlags & ezMemoryTrackingFlags::EnableAllocationTracking) != 0)
+  {
+    fAllocationTime = ezTime::Now();
+  }
 
   void* pNewMem = this->m_allocator.Reallocate(ptr, uiCurrentSize, uiNewSize, uiAlign);
 
@@ -165,5 +204,9 @@ void* ezInternal::ezAllocatorMixinReallocate<A, TrackingFlags, true>::Reallocate
 
     ezMemoryTracker::AddAllocation(this->m_Id, flags, pNewMem, uiNewSize, uiAlign, ezTime::Now() - fAllocationTime);
   }
+  else if ((TrackingFlags & ezMemoryTrackingFlags::EnableSampling) != 0)
+  {
+    ezMemoryTracker::SampleAllocation(this->m_Id, pNewMem, uiNewSize);
+  }
   return pNewMem;
 }
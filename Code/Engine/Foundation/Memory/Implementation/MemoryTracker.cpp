@@ -1,12 +1,16 @@
 #include <Foundation/FoundationPCH.h>
 
+#include <Foundation/Algorithm/HashingUtils.h>
+#include <Foundation/Containers/DynamicArray.h>
 #include <Foundation/Containers/HashTable.h>
 #include <Foundation/Containers/IdTable.h>
+#include <Foundation/IO/Stream.h>
 #include <Foundation/Logging/Log.h>
 #include <Foundation/Memory/Allocator.h>
 #include <Foundation/Memory/Policies/HeapAllocation.h>
 #include <Foundation/Strings/String.h>
 #include <Foundation/System/StackTracer.h>
+#include <Foundation/Threading/AtomicUtils.h>
 #include <Foundation/Threading/Lock.h>
 #include <Foundation/Threading/Mutex.h>
 
@@ -27,6 +31,16 @@ namespace
   };
 
 
+  struct SampledAllocation
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    void** m_pStackTrace = nullptr;
+    ezUInt64 m_uiSize = 0;
+    ezUInt64 m_uiEstimatedSize = 0; ///< The size divided by the probability that the allocation was sampled.
+    ezUInt16 m_uiStackTraceLength = 0;
+  };
+
   struct AllocatorData
   {
     EZ_ALWAYS_INLINE AllocatorData() {}
@@ -39,6 +53,9 @@ namespace
     ezAllocatorBase::Stats m_Stats;
 
     ezHashTable<const void*, ezMemoryTracker::AllocationInfo, ezHashHelper<const void*>, TrackerDataAllocatorWrapper> m_Allocations;
+
+    ezHashTable<const void*, SampledAllocation, ezHashHelper<const void*>, TrackerDataAllocatorWrapper> m_SampledAllocations;
+    ezUInt64 m_uiEstimatedSampledSize = 0;
   };
 
   struct TrackerData
@@ -58,6 +75,54 @@ namespace
   static bool s_bIsInitialized = false;
   static bool s_bIsInitializing = false;
 
+  static volatile ezInt32 s_iSamplingInterval = 512 * 1024;
+
+  // Counts the live samples per pointer hash, so that deallocations of allocations that were not sampled don't need to take the lock.
+  constexpr ezUInt32 s_uiSampleFilterBits = 12;
+  static volatile ezInt32 s_SampleFilter[1 << s_uiSampleFilterBits];
+
+  EZ_ALWAYS_INLINE volatile ezInt32& GetSampleFilterEntry(const void* ptr)
+  {
+    const ezUInt64 uiHash = (static_cast<ezUInt64>(reinterpret_cast<size_t>(ptr)) >> 4) * 0x9E3779B97F4A7C15ull;
+    return s_SampleFilter[uiHash >> (64 - s_uiSampleFilterBits)];
+  }
+
+  // trivially destructible, so that it can still be used while a thread shuts down
+  struct SamplingThreadState
+  {
+    ezInt64 m_iBytesUntilSample;
+    ezUInt64 m_uiRandomState;
+  };
+
+  static thread_local SamplingThreadState t_SamplingState;
+
+  /// Returns the number of bytes until the next sample, exponentially distributed with the sampling interval as mean.
+  static ezInt64 DrawSamplingDistance(SamplingThreadState& state)
+  {
+    if (state.m_uiRandomState == 0)
+    {
+      state.m_uiRandomState = (reinterpret_cast<size_t>(&state) ^ static_cast<ezUInt64>(ezTime::Now().GetNanoseconds())) | 1;
+    }
+
+    // xorshift64*
+    ezUInt64 x = state.m_uiRandomState;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    state.m_uiRandomState = x;
+
+    // uniform in (0, 1)
+    const float fRandom = (static_cast<float>((x * 0x2545F4914F6CDD1Dull) >> 40) + 0.5f) / static_cast<float>(1 << 24);
+
+    return static_cast<ezInt64>(-ezMath::Ln(fRandom) * s_iSamplingInterval) + 1;
+  }
+
+  static void FreeSampledAllocation(const void* ptr, const SampledAllocation& sample)
+  {
+    ezAtomicUtils::Decrement(GetSampleFilterEntry(ptr));
+    EZ_DELETE_ARRAY(s_pTrackerDataAllocator, ezArrayPtr<void*>(sample.m_pStackTrace, sample.m_uiStackTraceLength));
+  }
+
   static void Initialize()
   {
     if (s_bIsInitialized)
@@ -182,6 +247,11 @@ void ezMemoryTracker::DeregisterAllocator(ezAllocatorId allocatorId)
     EZ_REPORT_FAILURE("Allocator '{0}' leaked {1} allocation(s)", data.m_sName.GetData(), uiLiveAllocations);
   }
 
+  for (auto it = data.m_SampledAllocations.GetIterator(); it.IsValid(); ++it)
+  {
+    FreeSampledAllocation(it.Key(), it.Value());
+  }
+
   s_pTrackerData->m_AllocatorData.Remove(allocatorId);
 }
 
@@ -423,6 +493,207 @@ void ezMemoryTracker::DumpMemoryLeaks()
   }
 }
 
+// static
+void ezMemoryTracker::SetSamplingInterval(ezUInt32 uiAverageBytes)
+{
+  s_iSamplingInterval = static_cast<ezInt32>(ezMath::Clamp<ezUInt32>(uiAverageBytes, 1, 0x7FFFFFFF));
+}
+
+// static
+ezUInt32 ezMemoryTracker::GetSamplingInterval()
+{
+  return static_cast<ezUInt32>(s_iSamplingInterval);
+}
+
+// static
+void ezMemoryTracker::SampleAllocation(ezAllocatorId allocatorId, const void* ptr, size_t uiSize)
+{
+  SamplingThreadState& state = t_SamplingState;
+
+  state.m_iBytesUntilSample -= static_cast<ezInt64>(uiSize);
+  if (state.m_iBytesUntilSample > 0)
+    return;
+
+  if (state.m_uiRandomState == 0)
+  {
+    // first allocation on this thread
+    state.m_iBytesUntilSample = DrawSamplingDistance(state) - static_cast<ezInt64>(uiSize);
+    if (state.m_iBytesUntilSample > 0)
+      return;
+  }
+
+  state.m_iBytesUntilSample = DrawSamplingDistance(state);
+
+  // the probability that at least one sampling point fell into this allocation
+  const float fProbability = 1.0f - ezMath::Exp(-static_cast<float>(uiSize) / static_cast<float>(s_iSamplingInterval));
+
+  SampledAllocation sample;
+  sample.m_uiSize = uiSize;
+  sample.m_uiEstimatedSize = static_cast<ezUInt64>(uiSize / ezMath::Max(fProbability, 1e-9f));
+
+  {
+    void* pBuffer[64];
+    ezArrayPtr<void*> tempTrace(pBuffer);
+    const ezUInt32 uiNumTraces = ezStackTracer::GetStackTrace(tempTrace);
+
+    ezArrayPtr<void*> stackTrace = EZ_NEW_ARRAY(s_pTrackerDataAllocator, void*, uiNumTraces);
+    ezMemoryUtils::Copy(stackTrace.GetPtr(), pBuffer, uiNumTraces);
+
+    sample.m_pStackTrace = stackTrace.GetPtr();
+    sample.m_uiStackTraceLength = static_cast<ezUInt16>(uiNumTraces);
+  }
+
+  EZ_LOCK(*s_pTrackerData);
+
+  AllocatorData& data = s_pTrackerData->m_AllocatorData[allocatorId];
+
+  SampledAllocation previousSample;
+  if (data.m_SampledAllocations.Remove(ptr, &previousSample))
+  {
+    EZ_REPORT_FAILURE("Sampled allocation '{0}' was not removed. Memory corruption?", ezArgP(ptr));
+    data.m_uiEstimatedSampledSize -= previousSample.m_uiEstimatedSize;
+    FreeSampledAllocation(ptr, previousSample);
+  }
+
+  data.m_SampledAllocations.Insert(ptr, sample);
+  data.m_uiEstimatedSampledSize += sample.m_uiEstimatedSize;
+
+  ezAtomicUtils::Increment(GetSampleFilterEntry(ptr));
+}
+
+// static
+void ezMemoryTracker::RemoveSampledAllocation(ezAllocatorId allocatorId, const void* ptr)
+{
+  // the allocation can only be in the filter, if it was sampled before the pointer was handed out
+  if (GetSampleFilterEntry(ptr) == 0)
+    return;
+
+  SampledAllocation sample;
+
+  {
+    EZ_LOCK(*s_pTrackerData);
+
+    AllocatorData& data = s_pTrackerData->m_AllocatorData[allocatorId];
+    if (!data.m_SampledAllocations.Remove(ptr, &sample))
+      return;
+
+    data.m_uiEstimatedSampledSize -= sample.m_uiEstimatedSize;
+  }
+
+  FreeSampledAllocation(ptr, sample);
+}
+
+// static
+ezUInt64 ezMemoryTracker::GetEstimatedSampledSize(ezAllocatorId allocatorId)
+{
+  EZ_LOCK(*s_pTrackerData);
+
+  return s_pTrackerData->m_AllocatorData[allocatorId].m_uiEstimatedSampledSize;
+}
+
+namespace
+{
+  struct ProfileStack
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezUInt64 m_uiEstimatedSize = 0;
+    ezUInt32 m_uiNumSamples = 0;
+    ezUInt32 m_uiFirstFrame = 0;
+    ezUInt32 m_uiNumFrames = 0;
+  };
+
+  struct ProfileAllocator
+  {
+    ezHybridString<32, TrackerDataAllocatorWrapper> m_sName;
+    ezUInt64 m_uiEstimatedSize = 0;
+    ezUInt32 m_uiNumSamples = 0;
+    ezDynamicArray<ProfileStack, TrackerDataAllocatorWrapper> m_Stacks;
+  };
+
+  static void WriteProfileText(ezStreamWriter& stream, const char* szFormat, ...)
+  {
+    char szBuffer[1024];
+
+    va_list args;
+    va_start(args, szFormat);
+    const ezInt32 iLength = ezStringUtils::vsnprintf(szBuffer, EZ_ARRAY_SIZE(szBuffer), szFormat, args);
+    va_end(args);
+
+    stream.WriteBytes(szBuffer, ezMath::Clamp<ezInt32>(iLength, 0, EZ_ARRAY_SIZE(szBuffer) - 1)).IgnoreResult();
+  }
+} // namespace
+
+// static
+void ezMemoryTracker::WriteHeapProfile(ezStreamWriter& stream)
+{
+  ezDynamicArray<ProfileAllocator, TrackerDataAllocatorWrapper> allocators;
+  ezDynamicArray<void*, TrackerDataAllocatorWrapper> frames;
+
+  // only copy the samples while the lock is held, resolving the stack traces takes a while and may allocate
+  if (s_pTrackerData != nullptr)
+  {
+    EZ_LOCK(*s_pTrackerData);
+
+    ezHashTable<ezUInt64, ezUInt32, ezHashHelper<ezUInt64>, TrackerDataAllocatorWrapper> stackIndices;
+
+    for (auto it = s_pTrackerData->m_AllocatorData.GetIterator(); it.IsValid(); ++it)
+    {
+      const AllocatorData& data = it.Value();
+      if (data.m_SampledAllocations.IsEmpty())
+        continue;
+
+      ProfileAllocator& allocator = allocators.ExpandAndGetRef();
+      allocator.m_sName = data.m_sName;
+      allocator.m_uiEstimatedSize = data.m_uiEstimatedSampledSize;
+
+      stackIndices.Clear();
+
+      for (auto it2 = data.m_SampledAllocations.GetIterator(); it2.IsValid(); ++it2)
+      {
+        const SampledAllocation& sample = it2.Value();
+        const ezUInt64 uiStackHash = ezHashingUtils::xxHash64(sample.m_pStackTrace, sample.m_uiStackTraceLength * sizeof(void*));
+
+        ezUInt32 uiStackIndex;
+        if (!stackIndices.TryGetValue(uiStackHash, uiStackIndex))
+        {
+          uiStackIndex = allocator.m_Stacks.GetCount();
+          stackIndices.Insert(uiStackHash, uiStackIndex);
+
+          ProfileStack& stack = allocator.m_Stacks.ExpandAndGetRef();
+          stack.m_uiFirstFrame = frames.GetCount();
+          stack.m_uiNumFrames = sample.m_uiStackTraceLength;
+          frames.PushBackRange(ezArrayPtr<void*>(sample.m_pStackTrace, sample.m_uiStackTraceLength));
+        }
+
+        allocator.m_Stacks[uiStackIndex].m_uiEstimatedSize += sample.m_uiEstimatedSize;
+        allocator.m_Stacks[uiStackIndex].m_uiNumSamples++;
+        allocator.m_uiNumSamples++;
+      }
+    }
+  }
+
+  allocators.Sort([](const ProfileAllocator& a, const ProfileAllocator& b) { return a.m_sName < b.m_sName; });
+
+  WriteProfileText(stream, "ezHeapProfile 1\nSamplingInterval %u\n", GetSamplingInterval());
+
+  for (ProfileAllocator& allocator : allocators)
+  {
+    allocator.m_Stacks.Sort([](const ProfileStack& a, const ProfileStack& b) { return a.m_uiEstimatedSize > b.m_uiEstimatedSize; });
+
+    WriteProfileText(stream, "\nAllocator \"%s\" %llu bytes %u samples\n", allocator.m_sName.GetData(), allocator.m_uiEstimatedSize, allocator.m_uiNumSamples);
+
+    for (const ProfileStack& stack : allocator.m_Stacks)
+    {
+      WriteProfileText(stream, "\n  %llu bytes %u samples\n", stack.m_uiEstimatedSize, stack.m_uiNumSamples);
+
+      ezStackTracer::ResolveStackTrace(frames.GetArrayPtr().GetSubArray(stack.m_uiFirstFrame, stack.m_uiNumFrames), [&stream](const char* szText) {
+        WriteProfileText(stream, "    %s", szText);
+      });
+    }
+  }
+}
+
 // static
 ezMemoryTracker::Iterator ezMemoryTracker::GetIterator()
 {
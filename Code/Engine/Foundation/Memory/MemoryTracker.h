@@ -15,8 +15,10 @@ struct ezMemoryTrackingFlags
                                           ///< allocator implementation whether it collects usable stats or not.
     EnableAllocationTracking = EZ_BIT(1), ///< Enable tracking of individual allocations
     EnableStackTrace = EZ_BIT(2),         ///< Enable stack traces for each allocation
+    EnableSampling = EZ_BIT(3),           ///< Record only a random sample of the allocations, with stack traces. Requires RegisterAllocator and is ignored
+                                          ///< if EnableAllocationTracking is set. \see ezMemoryTracker::SetSamplingInterval()
 
-    All = RegisterAllocator | EnableAllocationTracking | EnableStackTrace,
+    All = RegisterAllocator | EnableAllocationTracking | EnableStackTrace | EnableSampling,
 
     Default = 0
 #if EZ_ENABLED(EZ_USE_ALLOCATION_TRACKING)
@@ -24,6 +26,9 @@ struct ezMemoryTrackingFlags
 #endif
 #if EZ_ENABLED(EZ_USE_ALLOCATION_STACK_TRACING)
               | EnableStackTrace
+#endif
+#if EZ_ENABLED(EZ_USE_ALLOCATION_SAMPLING)
+              | RegisterAllocator | EnableSampling
 #endif
   };
 
@@ -32,6 +37,7 @@ struct ezMemoryTrackingFlags
     StorageType RegisterAllocator : 1;
     StorageType EnableAllocationTracking : 1;
     StorageType EnableStackTrace : 1;
+    StorageType EnableSampling : 1;
   };
 };
 
@@ -39,6 +45,8 @@ struct ezMemoryTrackingFlags
 
 #define EZ_STATIC_ALLOCATOR_NAME "Statics"
 
+class ezStreamWriter;
+
 /// \brief Memory tracker which keeps track of all allocations and constructions
 class EZ_FOUNDATION_DLL ezMemoryTracker
 {
@@ -116,5 +124,33 @@ public:
 
   static void DumpMemoryLeaks();
 
+  /// \name Sampled allocation tracking
+  ///
+  /// Allocators with the EnableSampling flag only record about one allocation per sampling interval of allocated bytes.
+  /// The distance between two samples is drawn from an exponential distribution per thread, so every allocated byte has the same chance
+  /// to be sampled and large allocations are sampled more often than small ones. Each sample stores its call stack and the number of bytes
+  /// it represents, which gives an unbiased estimate of the live memory per call stack.
+  ///
+  /// Allocations that are not sampled only update a thread local counter, and deallocations only check a small global filter before
+  /// they look for a sample, so sampling is cheap enough to stay enabled in production builds.
+  ///@{
+
+  /// \brief Sets the average number of allocated bytes between two samples. Affects all threads, starting with their next sample.
+  static void SetSamplingInterval(ezUInt32 uiAverageBytes);
+  static ezUInt32 GetSamplingInterval();
+
+  static void SampleAllocation(ezAllocatorId allocatorId, const void* ptr, size_t uiSize);
+  static void RemoveSampledAllocation(ezAllocatorId allocatorId, const void* ptr);
+
+  /// \brief Returns the estimated number of bytes that are currently allocated, based on the live samples of the allocator.
+  static ezUInt64 GetEstimatedSampledSize(ezAllocatorId allocatorId);
+
+  /// \brief Writes the live samples of all allocators as a text heap profile, grouped by call stack and sorted by size.
+  ///
+  /// Call stacks are written resolved, so profiles that were taken with different builds can be compared with any diff tool.
+  static void WriteHeapProfile(ezStreamWriter& stream);
+
+  ///@}
+
   static Iterator GetIterator();
 };
@@ -0,0 +1,692 @@
+#include <Foundation/FoundationPCH.h>
+
+#include <Foundation/Memory/PageAllocator.h>
+#include <Foundation/Memory/Policies/AlignedHeapAllocation.h>
+#include <Foundation/Memory/Policies/ThreadCachingAllocation.h>
+#include <Foundation/Threading/AtomicUtils.h>
+#include <Foundation/Threading/Lock.h>
+#include <Foundation/Threading/ThreadUtils.h>
+
+namespace ezMemoryPolicies
+{
+  namespace
+  {
+    /// The page map works with 4 KB pages, independent of the actual page size. Spans are always aligned to at least that.
+    constexpr ezUInt32 s_uiPageMapPageShift = 12;
+    constexpr ezUInt32 s_uiPageMapLevelBits = 12;
+    constexpr ezUInt32 s_uiPageMapLevelSize = 1 << s_uiPageMapLevelBits;
+    constexpr ezUInt32 s_uiPageMapAddressBits = s_uiPageMapPageShift + 3 * s_uiPageMapLevelBits; // 48 bits
+
+    constexpr size_t s_uiSpanHeaderSize = 128;
+    constexpr ezUInt32 s_uiMaxEmptySpans = 16;
+    constexpr ezUInt32 s_uiMaxThreadCacheSlots = 4;
+
+    struct FreeObject
+    {
+      FreeObject* m_pNext;
+    };
+
+    /// Large allocations store their size and the offset to the start of the heap block in front of the returned memory.
+    struct LargeHeader
+    {
+      ezUInt64 m_uiSize;
+      ezUInt64 m_uiOffset;
+    };
+
+    /// The first 8 size classes are 16 bytes apart, after that every power of two range is split into 4 size classes.
+    EZ_ALWAYS_INLINE ezUInt32 GetSizeClass(size_t uiSize)
+    {
+      if (uiSize <= 128)
+        return static_cast<ezUInt32>((uiSize + 15) / 16) - 1;
+
+      const ezUInt32 uiBit = ezMath::FirstBitHigh(static_cast<ezUInt32>(uiSize - 1));
+      return 8 + (uiBit - 7) * 4 + static_cast<ezUInt32>((uiSize - 1 - (size_t(1) << uiBit)) >> (uiBit - 2));
+    }
+
+    EZ_ALWAYS_INLINE ezUInt32 GetSizeClassSize(ezUInt32 uiSizeClass)
+    {
+      if (uiSizeClass < 8)
+        return (uiSizeClass + 1) * 16;
+
+      const ezUInt32 uiBit = 7 + (uiSizeClass - 8) / 4;
+      return (1u << uiBit) + (((uiSizeClass - 8) % 4 + 1) << (uiBit - 2));
+    }
+
+    ezMutex& GetThreadCacheMutex()
+    {
+      // never destroyed, threads may still exit after static destruction
+      EZ_ALIGN_VARIABLE(static ezUInt8 s_MutexBuffer[sizeof(ezMutex)], EZ_ALIGNMENT_OF(ezMutex));
+      static ezMutex* s_pMutex = new (s_MutexBuffer) ezMutex();
+      return *s_pMutex;
+    }
+
+    volatile ezInt64 s_iNextAllocatorId = 0;
+    ezThreadCachingAllocation* s_pLiveAllocators = nullptr;
+  } // namespace
+
+  struct ezThreadCachingAllocation::Span
+  {
+    ThreadCache* m_pOwner;      ///< nullptr while the span is in the central empty list
+    FreeObject* m_pFreeList;    ///< Objects that were freed, only accessed by the owner.
+    ezUInt8* m_pUnused;         ///< Start of the objects that were never handed out.
+    ezUInt8* m_pEnd;            ///< End of the last object that fits into the span.
+    Span* m_pPrev;              ///< Partial span list of the owner, or the central empty list.
+    Span* m_pNext;              ///< Partial span list of the owner, or the central empty list.
+    Span* m_pPrevAllocated;     ///< List of all spans of the allocator.
+    Span* m_pNextAllocated;     ///< List of all spans of the allocator.
+    ezUInt32 m_uiSizeClass;
+    ezUInt32 m_uiObjectSize;
+    ezUInt32 m_uiNumUsed;
+    bool m_bInPartialList;
+
+    EZ_ALWAYS_INLINE bool HasFreeObject() const { return m_pFreeList != nullptr || m_pUnused + m_uiObjectSize <= m_pEnd; }
+  };
+
+  static_assert(sizeof(ezThreadCachingAllocation::Span) <= s_uiSpanHeaderSize, "Span header does not fit");
+
+  struct ezThreadCachingAllocation::ThreadCache
+  {
+    ezThreadCachingAllocation* m_pAllocator;
+    void* m_pRemoteFrees; ///< Lock-free stack of objects that other threads freed into spans of this cache.
+    Span* m_PartialSpans[NumSizeClasses];
+    ThreadCache* m_pNextInAllocator;
+    bool m_bAbandoned; ///< The thread exited, the cache will be reused by the next thread that needs one.
+
+    // only modified by the thread that uses the cache
+    ezUInt64 m_uiNumAllocations;
+    ezUInt64 m_uiNumDeallocations;
+    ezInt64 m_iAllocatedBytes;
+    ezInt64 m_iSmallObjectBytes;
+  };
+
+  /// Per thread list of the thread caches of all allocators. Trivially destructible, so that it can still be accessed
+  /// while other thread local objects are destroyed.
+  struct ezThreadCachingAllocationThreadData
+  {
+    struct Slot
+    {
+      ezUInt64 m_uiAllocatorId;
+      ezThreadCachingAllocation::ThreadCache* m_pCache;
+    };
+
+    Slot m_Slots[s_uiMaxThreadCacheSlots];
+    bool m_bShutDown;
+    bool m_bRegisteredExitHandler;
+
+    static bool IsAllocatorAlive(ezUInt64 uiAllocatorId)
+    {
+      for (ezThreadCachingAllocation* pAllocator = s_pLiveAllocators; pAllocator != nullptr; pAllocator = pAllocator->m_pNextLive)
+      {
+        if (pAllocator->m_uiId == uiAllocatorId)
+          return true;
+      }
+
+      return false;
+    }
+
+    void OnThreadExit()
+    {
+      EZ_LOCK(GetThreadCacheMutex());
+
+      for (Slot& slot : m_Slots)
+      {
+        if (slot.m_uiAllocatorId != 0 && IsAllocatorAlive(slot.m_uiAllocatorId))
+        {
+          slot.m_pCache->m_bAbandoned = true;
+        }
+
+        slot.m_uiAllocatorId = 0;
+        slot.m_pCache = nullptr;
+      }
+
+      // allocations from other thread local destructors go to the system heap from now on
+      m_bShutDown = true;
+    }
+  };
+
+  namespace
+  {
+    thread_local ezThreadCachingAllocationThreadData t_ThreadData;
+
+    void OnThreadExit()
+    {
+      t_ThreadData.OnThreadExit();
+    }
+  } // namespace
+
+  ezThreadCachingAllocation::ezThreadCachingAllocation(ezAllocatorBase* pParent)
+  {
+    m_uiId = static_cast<ezUInt64>(ezAtomicUtils::Increment(s_iNextAllocatorId));
+
+    EZ_LOCK(GetThreadCacheMutex());
+    m_pNextLive = s_pLiveAllocators;
+    s_pLiveAllocators = this;
+  }
+
+  ezThreadCachingAllocation::~ezThreadCachingAllocation()
+  {
+    {
+      EZ_LOCK(GetThreadCacheMutex());
+
+      for (ezThreadCachingAllocation** ppAllocator = &s_pLiveAllocators; *ppAllocator != nullptr; ppAllocator = &(*ppAllocator)->m_pNextLive)
+      {
+        if (*ppAllocator == this)
+        {
+          *ppAllocator = m_pNextLive;
+          break;
+        }
+      }
+
+      // thread local slots that still reference these caches are ignored, since the allocator ID is not alive anymore
+      while (m_pThreadCaches != nullptr)
+      {
+        ThreadCache* pCache = m_pThreadCaches;
+        m_pThreadCaches = pCache->m_pNextInAllocator;
+        free(pCache);
+      }
+    }
+
+    EZ_LOCK(m_CentralMutex);
+
+    while (m_pAllSpans != nullptr)
+    {
+      Span* pSpan = m_pAllSpans;
+      m_pAllSpans = pSpan->m_pNextAllocated;
+      ezPageAllocator::DeallocatePage(pSpan);
+    }
+
+    if (m_pPageMapRoot != nullptr)
+    {
+      for (ezUInt32 i = 0; i < s_uiPageMapLevelSize; ++i)
+      {
+        void** pNode = static_cast<void**>(m_pPageMapRoot[i]);
+        if (pNode == nullptr)
+          continue;
+
+        for (ezUInt32 j = 0; j < s_uiPageMapLevelSize; ++j)
+        {
+          if (pNode[j] != nullptr)
+            ezPageAllocator::DeallocatePage(pNode[j]);
+        }
+
+        ezPageAllocator::DeallocatePage(pNode);
+      }
+
+      ezPageAllocator::DeallocatePage(m_pPageMapRoot);
+      m_pPageMapRoot = nullptr;
+    }
+  }
+
+  void* ezThreadCachingAllocation::Allocate(size_t uiSize, size_t uiAlign)
+  {
+    ThreadCache* pCache = GetThreadCache();
+
+    if (pCache != nullptr && uiSize <= MaxSmallSize && uiAlign <= 16)
+    {
+      const ezUInt32 uiSizeClass = GetSizeClass(uiSize);
+
+      if (void* ptr = AllocateSmall(pCache, uiSizeClass))
+      {
+        const ezUInt32 uiObjectSize = GetSizeClassSize(uiSizeClass);
+
+        ++pCache->m_uiNumAllocations;
+        pCache->m_iAllocatedBytes += uiObjectSize;
+        pCache->m_iSmallObjectBytes += uiObjectSize;
+        return ptr;
+      }
+    }
+
+    return AllocateLarge(pCache, uiSize, uiAlign);
+  }
+
+  void ezThreadCachingAllocation::Deallocate(void* ptr)
+  {
+    if (ptr == nullptr)
+      return;
+
+    ThreadCache* pCache = GetThreadCache();
+    Span* pSpan = LookupSpan(ptr);
+
+    if (pSpan == nullptr)
+    {
+      DeallocateLarge(pCache, ptr);
+      return;
+    }
+
+    if (pCache != nullptr)
+    {
+      ++pCache->m_uiNumDeallocations;
+      pCache->m_iAllocatedBytes -= pSpan->m_uiObjectSize;
+      pCache->m_iSmallObjectBytes -= pSpan->m_uiObjectSize;
+    }
+    else
+    {
+      ezAtomicUtils::Increment(m_iUncachedDeallocations);
+      ezAtomicUtils::Add(m_iUncachedFreedBytes, pSpan->m_uiObjectSize);
+    }
+
+    if (pSpan->m_pOwner == pCache)
+    {
+      FreeLocal(pCache, pSpan, ptr);
+      return;
+    }
+
+    // the span belongs to another thread, hand the object over to its owner
+    ThreadCache* pOwner = pSpan->m_pOwner;
+    FreeObject* pObject = static_cast<FreeObject*>(ptr);
+    void* pHead;
+
+    do
+    {
+      pHead = pOwner->m_pRemoteFrees;
+      pObject->m_pNext = static_cast<FreeObject*>(pHead);
+    } while (!ezAtomicUtils::TestAndSet(&pOwner->m_pRemoteFrees, pHead, pObject));
+  }
+
+  void ezThreadCachingAllocation::GetStats(ezAllocatorBase::Stats& inout_Stats) const
+  {
+    ezUInt64 uiReservedSize = 0;
+    {
+      EZ_LOCK(m_CentralMutex);
+      uiReservedSize = m_uiNumReservedSpans * SpanSize;
+    }
+
+    ezUInt64 uiNumAllocations = static_cast<ezUInt64>(m_iUncachedAllocations);
+    ezUInt64 uiNumDeallocations = static_cast<ezUInt64>(m_iUncachedDeallocations);
+    ezInt64 iAllocatedBytes = m_iUncachedAllocatedBytes - m_iUncachedFreedBytes;
+    ezInt64 iSmallObjectBytes = 0;
+
+    {
+      EZ_LOCK(GetThreadCacheMutex());
+
+      // the counters of other threads are read without synchronization, the result is only exact while no other thread allocates
+      for (const ThreadCache* pCache = m_pThreadCaches; pCache != nullptr; pCache = pCache->m_pNextInAllocator)
+      {
+        uiNumAllocations += pCache->m_uiNumAllocations;
+        uiNumDeallocations += pCache->m_uiNumDeallocations;
+        iAllocatedBytes += pCache->m_iAllocatedBytes;
+        iSmallObjectBytes += pCache->m_iSmallObjectBytes;
+      }
+    }
+
+    // small objects that were freed while no thread cache was available are not subtracted, this only happens during thread shutdown
+    const ezUInt64 uiSmallObjectBytes = static_cast<ezUInt64>(ezMath::Max<ezInt64>(iSmallObjectBytes, 0));
+
+    inout_Stats.m_uiReservedSize = uiReservedSize;
+    inout_Stats.m_uiCachedSize = uiReservedSize > uiSmallObjectBytes ? uiReservedSize - uiSmallObjectBytes : 0;
+
+    if (inout_Stats.m_uiNumAllocations == 0 && inout_Stats.m_uiNumDeallocations == 0)
+    {
+      inout_Stats.m_uiNumAllocations = uiNumAllocations;
+      inout_Stats.m_uiNumDeallocations = uiNumDeallocations;
+      inout_Stats.m_uiAllocationSize = static_cast<ezUInt64>(ezMath::Max<ezInt64>(iAllocatedBytes, 0));
+    }
+  }
+
+  EZ_FORCE_INLINE ezThreadCachingAllocation::ThreadCache* ezThreadCachingAllocation::GetThreadCache()
+  {
+    for (const auto& slot : t_ThreadData.m_Slots)
+    {
+      if (slot.m_uiAllocatorId == m_uiId)
+        return slot.m_pCache;
+    }
+
+    if (t_ThreadData.m_bShutDown)
+      return nullptr;
+
+    return CreateThreadCache();
+  }
+
+  ezThreadCachingAllocation::ThreadCache* ezThreadCachingAllocation::CreateThreadCache()
+  {
+    EZ_LOCK(GetThreadCacheMutex());
+
+    ezThreadCachingAllocationThreadData& data = t_ThreadData;
+
+    if (!data.m_bRegisteredExitHandler)
+    {
+      data.m_bRegisteredExitHandler = true;
+      ezThreadUtils::AddThreadExitCallback(&OnThreadExit);
+    }
+
+    ezThreadCachingAllocationThreadData::Slot* pSlot = nullptr;
+    for (auto& slot : data.m_Slots)
+    {
+      if (slot.m_uiAllocatorId == 0 || !ezThreadCachingAllocationThreadData::IsAllocatorAlive(slot.m_uiAllocatorId))
+      {
+        pSlot = &slot;
+        break;
+      }
+    }
+
+    // too many allocators are used on this thread, the remaining ones use the system heap
+    if (pSlot == nullptr)
+      return nullptr;
+
+    // reuse the cache of a thread that exited, to get its spans back
+    ThreadCache* pCache = m_pThreadCaches;
+    while (pCache != nullptr && !pCache->m_bAbandoned)
+    {
+      pCache = pCache->m_pNextInAllocator;
+    }
+
+    if (pCache != nullptr)
+    {
+      pCache->m_bAbandoned = false;
+    }
+    else
+    {
+      pCache = static_cast<ThreadCache*>(malloc(sizeof(ThreadCache)));
+      if (pCache == nullptr)
+        return nullptr;
+
+      ezMemoryUtils::ZeroFill(pCache, 1);
+      pCache->m_pAllocator = this;
+      pCache->m_pNextInAllocator = m_pThreadCaches;
+      m_pThreadCaches = pCache;
+    }
+
+    pSlot->m_uiAllocatorId = m_uiId;
+    pSlot->m_pCache = pCache;
+    return pCache;
+  }
+
+  void* ezThreadCachingAllocation::AllocateSmall(ThreadCache* pCache, ezUInt32 uiSizeClass)
+  {
+    Span* pSpan = pCache->m_PartialSpans[uiSizeClass];
+
+    if (pSpan == nullptr)
+    {
+      CollectRemoteFrees(pCache);
+      pSpan = pCache->m_PartialSpans[uiSizeClass];
+
+      if (pSpan == nullptr)
+      {
+        pSpan = AcquireSpan(pCache, uiSizeClass);
+        if (pSpan == nullptr)
+          return nullptr;
+
+        pSpan->m_bInPartialList = true;
+        pCache->m_PartialSpans[uiSizeClass] = pSpan;
+      }
+    }
+
+    void* ptr;
+    if (pSpan->m_pFreeList != nullptr)
+    {
+      ptr = pSpan->m_pFreeList;
+      pSpan->m_pFreeList = pSpan->m_pFreeList->m_pNext;
+    }
+    else
+    {
+      ptr = pSpan->m_pUnused;
+      pSpan->m_pUnused += pSpan->m_uiObjectSize;
+    }
+
+    ++pSpan->m_uiNumUsed;
+
+    // full spans are not in any list, they are added again when an object is freed
+    if (!pSpan->HasFreeObject())
+    {
+      pCache->m_PartialSpans[uiSizeClass] = pSpan->m_pNext;
+      if (pSpan->m_pNext != nullptr)
+        pSpan->m_pNext->m_pPrev = nullptr;
+
+      pSpan->m_pNext = nullptr;
+      pSpan->m_bInPartialList = false;
+    }
+
+    return ptr;
+  }
+
+  void ezThreadCachingAllocation::FreeLocal(ThreadCache* pCache, Span* pSpan, void* ptr)
+  {
+    FreeObject* pObject = static_cast<FreeObject*>(ptr);
+    pObject->m_pNext = pSpan->m_pFreeList;
+    pSpan->m_pFreeList = pObject;
+    --pSpan->m_uiNumUsed;
+
+    Span*& pFirst = pCache->m_PartialSpans[pSpan->m_uiSizeClass];
+
+    if (!pSpan->m_bInPartialList)
+    {
+      pSpan->m_bInPartialList = true;
+      pSpan->m_pPrev = nullptr;
+      pSpan->m_pNext = pFirst;
+      if (pFirst != nullptr)
+        pFirst->m_pPrev = pSpan;
+      pFirst = pSpan;
+    }
+
+    // keep one empty span per size class, to not acquire and release a span all the time
+    if (pSpan->m_uiNumUsed == 0 && (pSpan->m_pPrev != nullptr || pSpan->m_pNext != nullptr))
+    {
+      if (pSpan->m_pPrev != nullptr)
+        pSpan->m_pPrev->m_pNext = pSpan->m_pNext;
+      else
+        pFirst = pSpan->m_pNext;
+
+      if (pSpan->m_pNext != nullptr)
+        pSpan->m_pNext->m_pPrev = pSpan->m_pPrev;
+
+      ReleaseSpan(pSpan);
+    }
+  }
+
+  void ezThreadCachingAllocation::CollectRemoteFrees(ThreadCache* pCache)
+  {
+    if (pCache->m_pRemoteFrees == nullptr)
+      return;
+
+    void* pList;
+    do
+    {
+      pList = pCache->m_pRemoteFrees;
+    } while (!ezAtomicUtils::TestAndSet(&pCache->m_pRemoteFrees, pList, nullptr));
+
+    FreeObject* pObject = static_cast<FreeObject*>(pList);
+    while (pObject != nullptr)
+    {
+      FreeObject* pNext = pObject->m_pNext;
+
+      // spans stay with their owner until all their objects were freed, so this is always one of ours
+      FreeLocal(pCache, LookupSpan(pObject), pObject);
+      pObject = pNext;
+    }
+  }
+
+  void* ezThreadCachingAllocation::AllocateLarge(ThreadCache* pCache, size_t uiSize, size_t uiAlign)
+  {
+    const size_t uiOffset = ezMath::Max<size_t>(uiAlign, sizeof(LargeHeader));
+
+    ezAlignedHeapAllocation heap(nullptr);
+    ezUInt8* pBlock = static_cast<ezUInt8*>(heap.Allocate(uiSize + uiOffset, ezMath::Max<size_t>(uiAlign, 16)));
+    if (pBlock == nullptr)
+      return nullptr;
+
+    LargeHeader* pHeader = reinterpret_cast<LargeHeader*>(pBlock + uiOffset) - 1;
+    pHeader->m_uiSize = uiSize;
+    pHeader->m_uiOffset = uiOffset;
+
+    if (pCache != nullptr)
+    {
+      ++pCache->m_uiNumAllocations;
+      pCache->m_iAllocatedBytes += uiSize;
+    }
+    else
+    {
+      // only happens while a thread shuts down, or with too many allocators on one thread
+      ezAtomicUtils::Increment(m_iUncachedAllocations);
+      ezAtomicUtils::Add(m_iUncachedAllocatedBytes, static_cast<ezInt64>(uiSize));
+    }
+
+    return pBlock + uiOffset;
+  }
+
+  void ezThreadCachingAllocation::DeallocateLarge(ThreadCache* pCache, void* ptr)
+  {
+    const LargeHeader* pHeader = static_cast<const LargeHeader*>(ptr) - 1;
+    const ezUInt64 uiSize = pHeader->m_uiSize;
+
+    if (pCache != nullptr)
+    {
+      ++pCache->m_uiNumDeallocations;
+      pCache->m_iAllocatedBytes -= uiSize;
+    }
+    else
+    {
+      ezAtomicUtils::Increment(m_iUncachedDeallocations);
+      ezAtomicUtils::Add(m_iUncachedFreedBytes, static_cast<ezInt64>(uiSize));
+    }
+
+    ezAlignedHeapAllocation heap(nullptr);
+    heap.Deallocate(static_cast<ezUInt8*>(ptr) - pHeader->m_uiOffset);
+  }
+
+  ezThreadCachingAllocation::Span* ezThreadCachingAllocation::AcquireSpan(ThreadCache* pCache, ezUInt32 uiSizeClass)
+  {
+    EZ_LOCK(m_CentralMutex);
+
+    Span* pSpan = m_pEmptySpans;
+
+    if (pSpan != nullptr)
+    {
+      m_pEmptySpans = pSpan->m_pNext;
+      --m_uiNumEmptySpans;
+    }
+    else
+    {
+      pSpan = static_cast<Span*>(ezPageAllocator::AllocatePage(SpanSize));
+      if (pSpan == nullptr)
+        return nullptr;
+
+      if (SetPageMapEntries(pSpan, pSpan).Failed())
+      {
+        SetPageMapEntries(pSpan, nullptr).IgnoreResult();
+        ezPageAllocator::DeallocatePage(pSpan);
+        return nullptr;
+      }
+
+      pSpan->m_pPrevAllocated = nullptr;
+      pSpan->m_pNextAllocated = m_pAllSpans;
+      if (m_pAllSpans != nullptr)
+        m_pAllSpans->m_pPrevAllocated = pSpan;
+      m_pAllSpans = pSpan;
+
+      ++m_uiNumReservedSpans;
+    }
+
+    const ezUInt32 uiObjectSize = GetSizeClassSize(uiSizeClass);
+    const size_t uiNumObjects = (SpanSize - s_uiSpanHeaderSize) / uiObjectSize;
+
+    pSpan->m_pOwner = pCache;
+    pSpan->m_pFreeList = nullptr;
+    pSpan->m_pUnused = reinterpret_cast<ezUInt8*>(pSpan) + s_uiSpanHeaderSize;
+    pSpan->m_pEnd = pSpan->m_pUnused + uiNumObjects * uiObjectSize;
+    pSpan->m_pPrev = nullptr;
+    pSpan->m_pNext = nullptr;
+    pSpan->m_uiSizeClass = uiSizeClass;
+    pSpan->m_uiObjectSize = uiObjectSize;
+    pSpan->m_uiNumUsed = 0;
+    pSpan->m_bInPartialList = false;
+
+    return pSpan;
+  }
+
+  void ezThreadCachingAllocation::ReleaseSpan(Span* pSpan)
+  {
+    EZ_LOCK(m_CentralMutex);
+
+    pSpan->m_pOwner = nullptr;
+    pSpan->m_bInPartialList = false;
+
+    if (m_uiNumEmptySpans < s_uiMaxEmptySpans)
+    {
+      pSpan->m_pPrev = nullptr;
+      pSpan->m_pNext = m_pEmptySpans;
+      m_pEmptySpans = pSpan;
+      ++m_uiNumEmptySpans;
+      return;
+    }
+
+    if (pSpan->m_pPrevAllocated != nullptr)
+      pSpan->m_pPrevAllocated->m_pNextAllocated = pSpan->m_pNextAllocated;
+    else
+      m_pAllSpans = pSpan->m_pNextAllocated;
+
+    if (pSpan->m_pNextAllocated != nullptr)
+      pSpan->m_pNextAllocated->m_pPrevAllocated = pSpan->m_pPrevAllocated;
+
+    --m_uiNumReservedSpans;
+
+    SetPageMapEntries(pSpan, nullptr).IgnoreResult();
+    ezPageAllocator::DeallocatePage(pSpan);
+  }
+
+  EZ_FORCE_INLINE ezThreadCachingAllocation::Span* ezThreadCachingAllocation::LookupSpan(const void* ptr) const
+  {
+    const ezUInt64 uiPage = static_cast<ezUInt64>(reinterpret_cast<size_t>(ptr)) >> s_uiPageMapPageShift;
+
+    // the page map is only extended while the central mutex is held, but a pointer can only be found, if its span was registered before it was handed out
+    void** pRoot = m_pPageMapRoot;
+    if (pRoot == nullptr || (uiPage >> (s_uiPageMapAddressBits - s_uiPageMapPageShift)) != 0)
+      return nullptr;
+
+    void** pNode = static_cast<void**>(pRoot[(uiPage >> (2 * s_uiPageMapLevelBits)) & (s_uiPageMapLevelSize - 1)]);
+    if (pNode == nullptr)
+      return nullptr;
+
+    void** pLeaf = static_cast<void**>(pNode[(uiPage >> s_uiPageMapLevelBits) & (s_uiPageMapLevelSize - 1)]);
+    if (pLeaf == nullptr)
+      return nullptr;
+
+    return static_cast<Span*>(pLeaf[uiPage & (s_uiPageMapLevelSize - 1)]);
+  }
+
+  ezResult ezThreadCachingAllocation::SetPageMapEntries(Span* pSpan, Span* pValue)
+  {
+    const size_t uiNodeSize = s_uiPageMapLevelSize * sizeof(void*);
+
+    // new nodes have to be completely initialized before another thread can see them
+    auto GetOrCreateNode = [&](void** ppNode) -> void** {
+      if (*ppNode == nullptr && pValue != nullptr)
+      {
+        void* pNewNode = ezPageAllocator::AllocatePage(uiNodeSize);
+        if (pNewNode == nullptr)
+          return nullptr;
+
+        ezMemoryUtils::ZeroFill(static_cast<ezUInt8*>(pNewNode), uiNodeSize);
+        ezAtomicUtils::TestAndSet(ppNode, nullptr, pNewNode);
+      }
+
+      return static_cast<void**>(*ppNode);
+    };
+
+    void** pRoot = GetOrCreateNode(reinterpret_cast<void**>(&m_pPageMapRoot));
+    if (pRoot == nullptr)
+      return pValue == nullptr ? EZ_SUCCESS : EZ_FAILURE;
+
+    const ezUInt64 uiFirstPage = static_cast<ezUInt64>(reinterpret_cast<size_t>(pSpan)) >> s_uiPageMapPageShift;
+    const ezUInt64 uiNumPages = SpanSize >> s_uiPageMapPageShift;
+
+    for (ezUInt64 uiPage = uiFirstPage; uiPage < uiFirstPage + uiNumPages; ++uiPage)
+    {
+      if ((uiPage >> (s_uiPageMapAddressBits - s_uiPageMapPageShift)) != 0)
+        return EZ_FAILURE;
+
+      void** pNode = GetOrCreateNode(&pRoot[(uiPage >> (2 * s_uiPageMapLevelBits)) & (s_uiPageMapLevelSize - 1)]);
+      if (pNode == nullptr)
+        return pValue == nullptr ? EZ_SUCCESS : EZ_FAILURE;
+
+      void** pLeaf = GetOrCreateNode(&pNode[(uiPage >> s_uiPageMapLevelBits) & (s_uiPageMapLevelSize - 1)]);
+      if (pLeaf == nullptr)
+        return pValue == nullptr ? EZ_SUCCESS : EZ_FAILURE;
+
+      pLeaf[uiPage & (s_uiPageMapLevelSize - 1)] = pValue;
+    }
+
+    return EZ_SUCCESS;
+  }
+} // namespace ezMemoryPolicies
+
+EZ_STATICLINK_FILE(Foundation, Foundation_Memory_Policies_ThreadCachingAllocation);
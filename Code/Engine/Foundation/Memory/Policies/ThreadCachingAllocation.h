@@ -0,0 +1,82 @@
+#pragma once
+
+#include <Foundation/Memory/AllocatorBase.h>
+#include <Foundation/Threading/Mutex.h>
+
+namespace ezMemoryPolicies
+{
+  /// \brief Allocation policy for many small allocations from many threads.
+  ///
+  /// Allocations of up to MaxSmallSize bytes are rounded up to one of NumSizeClasses size classes and served from 64 KB spans.
+  /// Every thread has its own cache per allocator, which owns a list of spans with free objects for each size class,
+  /// so allocations and deallocations on the same thread don't need any locks or atomic operations.
+  ///
+  /// Memory that is freed on another thread than the one that owns the span is pushed onto a lock-free remote free list of the owning
+  /// thread cache. The owner returns those objects to their spans when it runs out of free objects.
+  /// When a thread exits, its cache is kept and handed to the next thread that starts allocating, so its spans are not lost.
+  ///
+  /// Spans are allocated through ezPageAllocator by a central page heap, which is the only part that takes a lock.
+  /// It also keeps a few empty spans around, to avoid returning memory to the system that is needed again right away.
+  /// Larger allocations and allocations with an alignment larger than 16 bytes are forwarded to the system heap.
+  ///
+  /// The allocator must outlive all threads that still use it, the memory of all spans is released when it is destroyed.
+  ///
+  /// \see ezAllocator, ezThreadCachingHeapAllocator
+  class EZ_FOUNDATION_DLL ezThreadCachingAllocation
+  {
+  public:
+    static constexpr ezUInt32 NumSizeClasses = 32;
+    static constexpr size_t MaxSmallSize = 8 * 1024;
+    static constexpr size_t SpanSize = 64 * 1024;
+
+    ezThreadCachingAllocation(ezAllocatorBase* pParent);
+    ~ezThreadCachingAllocation();
+
+    void* Allocate(size_t uiSize, size_t uiAlign);
+    void Deallocate(void* ptr);
+
+    /// \brief Fills in the memory that is reserved for spans and the part of it that is currently unused.
+    ///
+    /// If the allocations are not tracked individually by ezMemoryTracker, the allocation counters are filled in as well.
+    void GetStats(ezAllocatorBase::Stats& inout_Stats) const;
+
+    EZ_ALWAYS_INLINE ezAllocatorBase* GetParent() const { return nullptr; }
+
+    struct Span;
+    struct ThreadCache;
+
+  private:
+    ThreadCache* GetThreadCache();
+    ThreadCache* CreateThreadCache();
+    void* AllocateSmall(ThreadCache* pCache, ezUInt32 uiSizeClass);
+    void* AllocateLarge(ThreadCache* pCache, size_t uiSize, size_t uiAlign);
+    void DeallocateLarge(ThreadCache* pCache, void* ptr);
+    void FreeLocal(ThreadCache* pCache, Span* pSpan, void* ptr);
+    void CollectRemoteFrees(ThreadCache* pCache);
+
+    Span* AcquireSpan(ThreadCache* pCache, ezUInt32 uiSizeClass);
+    void ReleaseSpan(Span* pSpan);
+    Span* LookupSpan(const void* ptr) const;
+    ezResult SetPageMapEntries(Span* pSpan, Span* pValue);
+
+    friend struct ezThreadCachingAllocationThreadData;
+
+    ezUInt64 m_uiId = 0;
+    ezThreadCachingAllocation* m_pNextLive = nullptr; ///< List of all existing allocators, protected by the global thread cache mutex.
+
+    mutable ezMutex m_CentralMutex;
+    Span* m_pEmptySpans = nullptr;     ///< Spans without any allocations, ready to be reused for any size class.
+    Span* m_pAllSpans = nullptr;       ///< All spans that were allocated from ezPageAllocator, to release them on destruction.
+    ezUInt32 m_uiNumEmptySpans = 0;
+    ezUInt64 m_uiNumReservedSpans = 0;
+    void** m_pPageMapRoot = nullptr;   ///< Three level radix tree that maps memory pages to the span that contains them.
+
+    ThreadCache* m_pThreadCaches = nullptr; ///< All thread caches, protected by the global thread cache mutex.
+
+    // counters of memory that was allocated or freed while no thread cache was available
+    volatile ezInt64 m_iUncachedAllocations = 0;
+    volatile ezInt64 m_iUncachedDeallocations = 0;
+    volatile ezInt64 m_iUncachedAllocatedBytes = 0;
+    volatile ezInt64 m_iUncachedFreedBytes = 0;
+  };
+} // namespace ezMemoryPolicies
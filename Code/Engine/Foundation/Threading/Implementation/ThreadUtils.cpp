@@ -17,6 +17,33 @@ EZ_BEGIN_SUBSYSTEM_DECLARATION(Foundation, ThreadUtils)
 EZ_END_SUBSYSTEM_DECLARATION;
 // clang-format on
 
+namespace
+{
+  struct ezThreadExitCallbacks
+  {
+    ~ezThreadExitCallbacks()
+    {
+      while (m_uiNumCallbacks > 0)
+      {
+        --m_uiNumCallbacks;
+        m_Callbacks[m_uiNumCallbacks]();
+      }
+    }
+
+    ezThreadUtils::ThreadExitCallback m_Callbacks[8];
+    ezUInt32 m_uiNumCallbacks = 0;
+  };
+} // namespace
+
+void ezThreadUtils::AddThreadExitCallback(ThreadExitCallback callback)
+{
+  // a function local thread_local is constructed the first time this runs on a thread, which registers its destructor for the thread's exit
+  static thread_local ezThreadExitCallbacks s_Callbacks;
+
+  EZ_ASSERT_DEV(s_Callbacks.m_uiNumCallbacks < EZ_ARRAY_SIZE(s_Callbacks.m_Callbacks), "Too many thread exit callbacks");
+  s_Callbacks.m_Callbacks[s_Callbacks.m_uiNumCallbacks++] = callback;
+}
+
 // Include inline file
 #if EZ_ENABLED(EZ_PLATFORM_WINDOWS)
 #  include <Foundation/Threading/Implementation/Win/ThreadUtils_win.h>
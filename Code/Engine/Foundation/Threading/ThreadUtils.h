@@ -25,6 +25,15 @@ public:
   /// \brief Returns an identifier for the currently running thread.
   static ezThreadID GetCurrentThreadID();
 
+  using ThreadExitCallback = void (*)();
+
+  /// \brief Registers a function that is called when the current thread exits. Works for all threads, not only for ezThread.
+  ///
+  /// The callbacks are called in reverse order of registration, from the destructor of a thread_local object.
+  /// Other thread_local objects of the thread may already be destroyed at that point.
+  /// A callback that is registered multiple times is also called multiple times. At most 8 callbacks can be registered per thread.
+  static void AddThreadExitCallback(ThreadExitCallback callback);
+
 private:
   EZ_MAKE_SUBSYSTEM_STARTUP_FRIEND(Foundation, ThreadUtils);
 
@@ -42,6 +42,14 @@
 #  define EZ_USE_ALLOCATION_STACK_TRACING EZ_OFF
 #endif
 
+#ifdef BUILDSYSTEM_USE_ALLOCATION_SAMPLING
+#  undef EZ_USE_ALLOCATION_SAMPLING
+#  define EZ_USE_ALLOCATION_SAMPLING EZ_ON
+#else
+#  undef EZ_USE_ALLOCATION_SAMPLING
+#  define EZ_USE_ALLOCATION_SAMPLING EZ_OFF
+#endif
+
 
 
 #if !defined(BUILDSYSTEM_IGNORE_USERCONFIG_HEADER)
@@ -79,4 +87,13 @@
 //#undef EZ_USE_GUARDED_ALLOCATIONS
 //#define EZ_USE_GUARDED_ALLOCATIONS EZ_ON
 
+// Uncomment to record a sample of all allocations with call stacks, see ezMemoryTracker::WriteHeapProfile().
+// Cheap enough for shipping builds, in which individual allocations are not tracked.
+//#undef EZ_USE_ALLOCATION_SAMPLING
+//#define EZ_USE_ALLOCATION_SAMPLING EZ_ON
+
+// Uncomment to use the thread-caching allocator as the default heap allocator. Faster for many small allocations from many threads.
+//#undef EZ_USE_THREAD_CACHING_ALLOCATIONS
+//#define EZ_USE_THREAD_CACHING_ALLOCATIONS EZ_ON
+
 #endif
@@ -33,8 +33,16 @@ public:
   static const ezVariant& GetStat(const char* szStatName) { return s_Stats[szStatName]; }
 
   /// \brief Returns the entire map of stats, can be used to display them.
+  ///
+  /// Stats may be changed from any thread, lock GetMutex() while iterating the map.
   static const MapType& GetAllStats() { return s_Stats; }
 
+  /// \brief Returns the (recursive) mutex that guards all changes to the stats.
+  ///
+  /// While it is held, no stat can be changed and no event is broadcast. This allows to take a snapshot of GetAllStats()
+  /// and to register an event handler, without missing any change in between.
+  static ezMutex& GetMutex() { return s_Mutex; }
+
   /// \brief The event data that is broadcast whenever a stat is changed.
   struct StatsEventData
   {
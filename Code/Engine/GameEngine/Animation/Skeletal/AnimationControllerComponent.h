@@ -10,7 +10,25 @@
 using ezSkeletonResourceHandle = ezTypedResourceHandle<class ezSkeletonResource>;
 using ezAnimGraphResourceHandle = ezTypedResourceHandle<class ezAnimGraphResource>;
 
-using ezAnimationControllerComponentManager = ezComponentManagerSimple<class ezAnimationControllerComponent, ezComponentUpdateType::WhenSimulating, ezBlockStorageType::FreeList>;
+/// \brief Updates all animation controllers of a world in three steps.
+///
+/// The animation graphs are stepped on the main thread, the expensive pose generation (sampling, blending, local to model space conversion)
+/// then runs for all controllers in parallel during the async phase and finally the resulting poses are sent to the animated meshes.
+///
+/// Controllers that are far away from the main camera are updated less often (see the Animation.Lod CVars).
+class EZ_GAMEENGINE_DLL ezAnimationControllerComponentManager : public ezComponentManager<class ezAnimationControllerComponent, ezBlockStorageType::FreeList>
+{
+public:
+  ezAnimationControllerComponentManager(ezWorld* pWorld);
+  ~ezAnimationControllerComponentManager();
+
+  virtual void Initialize() override;
+
+private:
+  void UpdateGraphs(const ezWorldModule::UpdateContext& context);
+  void GeneratePoses(const ezWorldModule::UpdateContext& context);
+  void SendPoses(const ezWorldModule::UpdateContext& context);
+};
 
 class EZ_GAMEENGINE_DLL ezAnimationControllerComponent : public ezComponent
 {
@@ -37,9 +55,11 @@ public:
   const char* GetAnimationControllerFile() const;      // [ property ]
 
 protected:
-  void Update();
+  void Update(ezTime tDiff, ezUInt32 uiUpdateInterval);
 
   ezEnum<ezRootMotionMode> m_RootMotionMode;
+  bool m_bPoseGenerationPending = false;
+  ezTime m_SkippedTime; ///< Time of the frames in which the update was skipped due to the animation LOD
 
   ezAnimGraphResourceHandle m_hAnimationController;
   ezAnimGraph m_AnimationGraph;
@@ -3,6 +3,7 @@
 #include <Core/Input/InputManager.h>
 #include <Core/WorldSerializer/WorldReader.h>
 #include <Core/WorldSerializer/WorldWriter.h>
+#include <Foundation/Configuration/CVar.h>
 #include <Foundation/Strings/HashedString.h>
 #include <GameEngine/Animation/Skeletal/AnimatedMeshComponent.h>
 #include <GameEngine/Animation/Skeletal/AnimationControllerComponent.h>
@@ -10,6 +11,13 @@
 #include <GameEngine/Physics/CharacterControllerComponent.h>
 #include <RendererCore/AnimationSystem/AnimGraph/AnimGraphResource.h>
 #include <RendererCore/AnimationSystem/SkeletonResource.h>
+#include <RendererCore/Pipeline/View.h>
+#include <RendererCore/RenderWorld/RenderWorld.h>
+
+ezCVarBool cvar_AnimationParallelPoseGeneration("Animation.ParallelPoseGeneration", true, ezCVarFlags::Default, "Generate the poses of all animation controllers in parallel");
+ezCVarBool cvar_AnimationLodEnable("Animation.Lod.Enable", true, ezCVarFlags::Default, "Update distant animation controllers less often");
+ezCVarFloat cvar_AnimationLodDistance("Animation.Lod.Distance", 15.0f, ezCVarFlags::Default, "Every multiple of this distance to the main camera skips one more animation update");
+ezCVarInt cvar_AnimationLodMaxInterval("Animation.Lod.MaxInterval", 4, ezCVarFlags::Default, "Animation controllers are updated at least every n-th frame");
 
 // clang-format off
 EZ_BEGIN_COMPONENT_TYPE(ezAnimationControllerComponent, 1, ezComponentMode::Static);
@@ -96,9 +104,20 @@ void ezAnimationControllerComponent::OnSimulationStarted()
   m_AnimationGraph.Configure(msg.m_hSkeleton, m_PoseGenerator, ezBlackboardComponent::FindBlackboard(GetOwner()));
 }
 
-void ezAnimationControllerComponent::Update()
+void ezAnimationControllerComponent::Update(ezTime tDiff, ezUInt32 uiUpdateInterval)
 {
-  m_AnimationGraph.Update(GetWorld()->GetClock().GetTimeDiff(), GetOwner());
+  m_bPoseGenerationPending = false;
+  m_SkippedTime += tDiff;
+
+  // distribute the skipped frames of all controllers with the same interval evenly
+  if (uiUpdateInterval > 1 && ((ezRenderWorld::GetFrameCounter() + GetHandle().GetInternalID().m_InstanceIndex) % uiUpdateInterval) != 0)
+    return;
+
+  const ezTime tUpdate = m_SkippedTime;
+  m_SkippedTime.SetZero();
+
+  if (!m_AnimationGraph.UpdateNodes(tUpdate, GetOwner()))
+    return;
 
   ezVec3 translation;
   ezAngle rotationX;
@@ -107,6 +126,117 @@ void ezAnimationControllerComponent::Update()
   m_AnimationGraph.GetRootMotion(translation, rotationX, rotationY, rotationZ);
 
   ezRootMotionMode::Apply(m_RootMotionMode, GetOwner(), translation, rotationX, rotationY, rotationZ);
+
+  if (cvar_AnimationParallelPoseGeneration && m_PoseGenerator.CanGeneratePoseAsync())
+  {
+    // the pose is generated in the async phase and sent in the post-async phase
+    m_bPoseGenerationPending = true;
+    return;
+  }
+
+  m_AnimationGraph.GeneratePose(GetOwner());
+  m_AnimationGraph.SendPoseUpdate(GetOwner());
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+ezAnimationControllerComponentManager::ezAnimationControllerComponentManager(ezWorld* pWorld)
+  : ezComponentManager(pWorld)
+{
+}
+
+ezAnimationControllerComponentManager::~ezAnimationControllerComponentManager() = default;
+
+void ezAnimationControllerComponentManager::Initialize()
+{
+  SUPER::Initialize();
+
+  {
+    auto desc = EZ_CREATE_MODULE_UPDATE_FUNCTION_DESC(ezAnimationControllerComponentManager::UpdateGraphs, this);
+    desc.m_Phase = ezWorldModule::UpdateFunctionDesc::Phase::PreAsync;
+    desc.m_bOnlyUpdateWhenSimulating = true;
+
+    this->RegisterUpdateFunction(desc);
+  }
+
+  {
+    auto desc = EZ_CREATE_MODULE_UPDATE_FUNCTION_DESC(ezAnimationControllerComponentManager::GeneratePoses, this);
+    desc.m_Phase = ezWorldModule::UpdateFunctionDesc::Phase::Async;
+    desc.m_bOnlyUpdateWhenSimulating = true;
+    desc.m_uiGranularity = 16;
+
+    this->RegisterUpdateFunction(desc);
+  }
+
+  {
+    auto desc = EZ_CREATE_MODULE_UPDATE_FUNCTION_DESC(ezAnimationControllerComponentManager::SendPoses, this);
+    desc.m_Phase = ezWorldModule::UpdateFunctionDesc::Phase::PostAsync;
+    desc.m_bOnlyUpdateWhenSimulating = true;
+
+    this->RegisterUpdateFunction(desc);
+  }
+}
+
+void ezAnimationControllerComponentManager::UpdateGraphs(const ezWorldModule::UpdateContext& context)
+{
+  bool bUseLod = false;
+  ezVec3 vCameraPos = ezVec3::ZeroVector();
+
+  if (cvar_AnimationLodEnable)
+  {
+    if (const ezView* pView = ezRenderWorld::GetViewByUsageHint(ezCameraUsageHint::MainView, ezCameraUsageHint::EditorView, GetWorld()))
+    {
+      vCameraPos = pView->GetCullingCamera()->GetCenterPosition();
+      bUseLod = true;
+    }
+  }
+
+  const float fLodDistance = ezMath::Max(cvar_AnimationLodDistance.GetValue(), 1.0f);
+  const ezUInt32 uiMaxInterval = static_cast<ezUInt32>(ezMath::Max(cvar_AnimationLodMaxInterval.GetValue(), 1));
+  const ezTime tDiff = GetWorld()->GetClock().GetTimeDiff();
+
+  for (auto it = this->m_ComponentStorage.GetIterator(context.m_uiFirstComponentIndex, context.m_uiComponentCount); it.IsValid(); ++it)
+  {
+    if (!it->IsActiveAndInitialized())
+      continue;
+
+    ezUInt32 uiUpdateInterval = 1;
+
+    if (bUseLod)
+    {
+      const float fDistance = (it->GetOwner()->GetGlobalPosition() - vCameraPos).GetLength();
+      uiUpdateInterval = ezMath::Min(1 + static_cast<ezUInt32>(fDistance / fLodDistance), uiMaxInterval);
+    }
+
+    it->Update(tDiff, uiUpdateInterval);
+  }
+}
+
+void ezAnimationControllerComponentManager::GeneratePoses(const ezWorldModule::UpdateContext& context)
+{
+  for (auto it = this->m_ComponentStorage.GetIterator(context.m_uiFirstComponentIndex, context.m_uiComponentCount); it.IsValid(); ++it)
+  {
+    if (it->m_bPoseGenerationPending)
+    {
+      it->m_AnimationGraph.GeneratePoseAsync();
+    }
+  }
+}
+
+void ezAnimationControllerComponentManager::SendPoses(const ezWorldModule::UpdateContext& context)
+{
+  for (auto it = this->m_ComponentStorage.GetIterator(context.m_uiFirstComponentIndex, context.m_uiComponentCount); it.IsValid(); ++it)
+  {
+    if (it->m_bPoseGenerationPending)
+    {
+      it->m_bPoseGenerationPending = false;
+
+      if (it->IsActiveAndInitialized())
+      {
+        it->m_AnimationGraph.SendPoseUpdate(it->GetOwner());
+      }
+    }
+  }
 }
 
 EZ_STATICLINK_FILE(GameEngine, GameEngine_Animation_Skeletal_Implementation_AnimationControllerComponent);
@@ -11,18 +11,14 @@
 ///
 /// Uses Verlet Integration to update the cloth positions from velocities, and the "Jakobsen method" to enforce distance constraints.
 ///
+/// The nodes are stored as separate x, y and z arrays, so that the constraints of four neighboring nodes are solved at once with SIMD.
+/// The rows are relaxed in red-black order (first all even rows, then all odd rows), since nodes in rows of the same color
+/// do not depend on each other.
+///
 /// Based on https://owlree.blog/posts/simulating-a-rope.html
 class EZ_GAMEENGINE_DLL ezClothSimulator
 {
 public:
-  struct Node
-  {
-    /// Whether this node can swing freely or will remain fixed in place.
-    bool m_bFixed = false;
-    ezSimdVec4f m_vPosition = ezSimdVec4f::ZeroVector();
-    ezSimdVec4f m_vPreviousPosition = ezSimdVec4f::ZeroVector();
-  };
-
   /// Resolution of the cloth along X
   ezUInt8 m_uiWidth = 32;
 
@@ -38,8 +34,24 @@ public:
   /// The distance along x and y between each neighboring node.
   ezVec2 m_vSegmentLength = ezVec2(0.1f);
 
-  /// All cloth nodes.
-  ezDynamicArray<Node, ezAlignedAllocatorWrapper> m_Nodes;
+  /// How often the distance constraints are enforced per step at most. Can be lowered for cloth that is not visible.
+  ezUInt32 m_uiMaxIterations = 32;
+
+  /// \brief Allocates m_uiWidth * m_uiHeight nodes. All nodes are at the origin and can swing freely.
+  void SetupNodes();
+
+  /// \brief Removes all nodes.
+  void ClearNodes();
+
+  bool HasNodes() const { return m_uiNumNodes > 0; }
+
+  /// \brief Places a node without giving it any velocity.
+  void SetNodePosition(ezUInt32 x, ezUInt32 y, const ezVec3& vPosition);
+  ezVec3 GetNodePosition(ezUInt32 x, ezUInt32 y) const;
+
+  /// \brief Whether the node can swing freely or will remain fixed in place.
+  void SetNodeFixed(ezUInt32 x, ezUInt32 y, bool bFixed);
+  bool IsNodeFixed(ezUInt32 x, ezUInt32 y) const;
 
   void SimulateCloth(const ezTime& tDiff);
   void SimulateStep(const ezSimdFloat tDiffSqr, ezUInt32 uiMaxIterations, ezSimdFloat fAllowedError);
@@ -47,8 +59,22 @@ public:
 
 private:
   ezSimdFloat EnforceDistanceConstraint();
+  ezSimdFloat EnforceDistanceConstraint(ezUInt32 y);
   void UpdateNodePositions(const ezSimdFloat tDiffSqr);
-  ezSimdVec4f MoveTowards(const ezSimdVec4f posThis, const ezSimdVec4f posNext, ezSimdFloat factor, const ezSimdVec4f fallbackDir, ezSimdFloat& inout_fError, ezSimdFloat fSegLen);
+
+  ezUInt32 GetNodeIndex(ezUInt32 x, ezUInt32 y) const { return m_uiPadding + y * m_uiStride + x; }
+
+  // every row is padded to a multiple of 4 nodes, the arrays have additional padding at the front and the back,
+  // so that the neighbors of the first and last node in a row can be loaded without bounds checks
+  static constexpr ezUInt32 m_uiPadding = 4;
+  ezUInt32 m_uiStride = 0;
+  ezUInt32 m_uiNumNodes = 0;
+
+  ezDynamicArray<float> m_Position[3];
+  ezDynamicArray<float> m_PreviousPosition[3];
+  ezDynamicArray<float> m_Mobility;    // 1 for free nodes, 0 for fixed nodes and padding
+  ezDynamicArray<float> m_LeftWeight;  // per column, 0 where there is no left neighbor
+  ezDynamicArray<float> m_RightWeight; // per column, 0 where there is no right neighbor
 
   ezTime m_leftOverTimeStep;
 };
@@ -152,8 +152,7 @@ void ezClothSheetComponent::SetupCloth()
     m_Simulator.m_vSegmentLength = m_vSize.CompMul(ezVec2(1.0f) + m_vSlack);
     m_Simulator.m_vSegmentLength.x /= (float)m_vSegments.x;
     m_Simulator.m_vSegmentLength.y /= (float)m_vSegments.y;
-    m_Simulator.m_Nodes.Clear();
-    m_Simulator.m_Nodes.SetCount(m_Simulator.m_uiWidth * m_Simulator.m_uiHeight);
+    m_Simulator.SetupNodes();
 
     const ezVec3 pos = ezVec3(0);
     const ezVec3 dirX = ezVec3(1, 0, 0);
@@ -167,32 +166,30 @@ void ezClothSheetComponent::SetupCloth()
     {
       for (ezUInt32 x = 0; x < m_Simulator.m_uiWidth; ++x)
       {
-        const ezUInt32 idx = (y * m_Simulator.m_uiWidth) + x;
-
-        m_Simulator.m_Nodes[idx].m_vPosition = ezSimdConversion::ToVec3(pos + x * dist.x * dirX + y * dist.y * dirY);
-        m_Simulator.m_Nodes[idx].m_vPreviousPosition = m_Simulator.m_Nodes[idx].m_vPosition;
+        m_Simulator.SetNodePosition(x, y, pos + x * dist.x * dirX + y * dist.y * dirY);
       }
     }
 
+    const ezUInt32 uiLastX = m_Simulator.m_uiWidth - 1;
+    const ezUInt32 uiLastY = m_Simulator.m_uiHeight - 1;
+
     if (m_Flags.IsSet(ezClothSheetFlags::FixedCornerTopLeft))
-      m_Simulator.m_Nodes[0].m_bFixed = true;
+      m_Simulator.SetNodeFixed(0, 0, true);
 
     if (m_Flags.IsSet(ezClothSheetFlags::FixedCornerTopRight))
-      m_Simulator.m_Nodes[m_Simulator.m_uiWidth - 1].m_bFixed = true;
+      m_Simulator.SetNodeFixed(uiLastX, 0, true);
 
     if (m_Flags.IsSet(ezClothSheetFlags::FixedCornerBottomRight))
-      m_Simulator.m_Nodes[m_Simulator.m_uiWidth * m_Simulator.m_uiHeight - 1].m_bFixed = true;
+      m_Simulator.SetNodeFixed(uiLastX, uiLastY, true);
 
     if (m_Flags.IsSet(ezClothSheetFlags::FixedCornerBottomLeft))
-      m_Simulator.m_Nodes[m_Simulator.m_uiWidth * (m_Simulator.m_uiHeight - 1)].m_bFixed = true;
+      m_Simulator.SetNodeFixed(0, uiLastY, true);
 
     if (m_Flags.IsSet(ezClothSheetFlags::FixedEdgeTop))
     {
       for (ezUInt32 x = 0; x < m_Simulator.m_uiWidth; ++x)
       {
-        const ezUInt32 idx = (0 * m_Simulator.m_uiWidth) + x;
-
-        m_Simulator.m_Nodes[idx].m_bFixed = true;
+        m_Simulator.SetNodeFixed(x, 0, true);
       }
     }
 
@@ -200,9 +197,7 @@ void ezClothSheetComponent::SetupCloth()
     {
       for (ezUInt32 y = 0; y < m_Simulator.m_uiHeight; ++y)
       {
-        const ezUInt32 idx = (y * m_Simulator.m_uiWidth) + (m_Simulator.m_uiWidth - 1);
-
-        m_Simulator.m_Nodes[idx].m_bFixed = true;
+        m_Simulator.SetNodeFixed(uiLastX, y, true);
       }
     }
 
@@ -210,9 +205,7 @@ void ezClothSheetComponent::SetupCloth()
     {
       for (ezUInt32 x = 0; x < m_Simulator.m_uiWidth; ++x)
       {
-        const ezUInt32 idx = ((m_Simulator.m_uiHeight - 1) * m_Simulator.m_uiWidth) + x;
-
-        m_Simulator.m_Nodes[idx].m_bFixed = true;
+        m_Simulator.SetNodeFixed(x, uiLastY, true);
       }
     }
 
@@ -220,9 +213,7 @@ void ezClothSheetComponent::SetupCloth()
     {
       for (ezUInt32 y = 0; y < m_Simulator.m_uiHeight; ++y)
       {
-        const ezUInt32 idx = (y * m_Simulator.m_uiWidth) + 0;
-
-        m_Simulator.m_Nodes[idx].m_bFixed = true;
+        m_Simulator.SetNodeFixed(0, y, true);
       }
     }
   }
@@ -232,7 +223,7 @@ void ezClothSheetComponent::SetupCloth()
 
 void ezClothSheetComponent::OnDeactivated()
 {
-  m_Simulator.m_Nodes.Clear();
+  m_Simulator.ClearNodes();
 
   SUPER::OnDeactivated();
 }
@@ -270,7 +261,7 @@ void ezClothSheetComponent::OnMsgExtractRenderData(ezMsgExtractRenderData& msg)
   pRenderData->m_hMaterial = m_hMaterial;
 
 
-  if (m_Simulator.m_Nodes.IsEmpty())
+  if (!m_Simulator.HasNodes())
   {
     pRenderData->m_uiVerticesX = 2;
     pRenderData->m_uiVerticesY = 2;
@@ -307,7 +298,7 @@ void ezClothSheetComponent::OnMsgExtractRenderData(ezMsgExtractRenderData& msg)
       {
         for (ezUInt32 x = 0; x < pRenderData->m_uiVerticesX; ++x, ++vidx)
         {
-          pRenderData->m_Positions[vidx] = ezSimdConversion::ToVec3(m_Simulator.m_Nodes[vidx].m_vPosition);
+          pRenderData->m_Positions[vidx] = m_Simulator.GetNodePosition(x, y);
         }
       }
     }
@@ -386,11 +377,14 @@ const char* ezClothSheetComponent::GetMaterialFile() const
 
 void ezClothSheetComponent::Update()
 {
-  if (m_Simulator.m_Nodes.IsEmpty() || m_uiVisibleCounter == 0)
+  if (!m_Simulator.HasNodes() || m_uiVisibleCounter == 0)
     return;
 
   --m_uiVisibleCounter;
 
+  // cloth that was not rendered recently keeps swinging until it falls asleep, but with less precision
+  m_Simulator.m_uiMaxIterations = GetOwner()->GetNumFramesSinceVisible() <= 1 ? 32 : 8;
+
   {
     ezVec3 acc = -GetOwner()->GetVelocity();
 
@@ -410,7 +404,7 @@ void ezClothSheetComponent::Update()
         ezVec3 ropeDir(0, 0, 1);
 
         // take the position of the center cloth node to sample the wind
-        const ezVec3 vSampleWindPos = GetOwner()->GetGlobalTransform().TransformPosition(ezSimdConversion::ToVec3(m_Simulator.m_Nodes[m_Simulator.m_uiWidth * (m_Simulator.m_uiHeight / 2) + m_Simulator.m_uiWidth / 2].m_vPosition));
+        const ezVec3 vSampleWindPos = GetOwner()->GetGlobalTransform().TransformPosition(m_Simulator.GetNodePosition(m_Simulator.m_uiWidth / 2, m_Simulator.m_uiHeight / 2));
 
         const ezVec3 vWind = pWind->GetWindAt(vSampleWindPos) * m_fWindInfluence;
 
@@ -436,10 +430,10 @@ void ezClothSheetComponent::Update()
     m_Simulator.SimulateCloth(GetWorld()->GetClock().GetTimeDiff());
 
     auto prevBbox = m_bbox;
-    m_bbox.ExpandToInclude(ezSimdConversion::ToVec3(m_Simulator.m_Nodes[0].m_vPosition));
-    m_bbox.ExpandToInclude(ezSimdConversion::ToVec3(m_Simulator.m_Nodes[m_Simulator.m_uiWidth - 1].m_vPosition));
-    m_bbox.ExpandToInclude(ezSimdConversion::ToVec3(m_Simulator.m_Nodes[((m_Simulator.m_uiHeight - 1) * m_Simulator.m_uiWidth)].m_vPosition));
-    m_bbox.ExpandToInclude(ezSimdConversion::ToVec3(m_Simulator.m_Nodes.PeekBack().m_vPosition));
+    m_bbox.ExpandToInclude(m_Simulator.GetNodePosition(0, 0));
+    m_bbox.ExpandToInclude(m_Simulator.GetNodePosition(m_Simulator.m_uiWidth - 1, 0));
+    m_bbox.ExpandToInclude(m_Simulator.GetNodePosition(0, m_Simulator.m_uiHeight - 1));
+    m_bbox.ExpandToInclude(m_Simulator.GetNodePosition(m_Simulator.m_uiWidth - 1, m_Simulator.m_uiHeight - 1));
 
     if (prevBbox != m_bbox)
     {
@@ -644,6 +638,7 @@ void ezClothSheetComponentManager::Initialize()
     auto desc = EZ_CREATE_MODULE_UPDATE_FUNCTION_DESC(ezClothSheetComponentManager::Update, this);
     desc.m_Phase = ezWorldModule::UpdateFunctionDesc::Phase::Async;
     desc.m_bOnlyUpdateWhenSimulating = true;
+    desc.m_uiGranularity = 8; // simulate batches of cloth sheets on all worker threads
 
     this->RegisterUpdateFunction(desc);
   }
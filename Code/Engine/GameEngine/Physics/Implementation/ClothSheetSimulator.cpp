@@ -1,8 +1,123 @@
 #include <GameEngine/GameEnginePCH.h>
 
-#include <Foundation/SimdMath/SimdConversion.h>
 #include <GameEngine/Physics/ClothSheetSimulator.h>
 
+namespace
+{
+  /// Computes how much four nodes have to move towards (or away from) one neighbor each, to restore the segment length.
+  EZ_ALWAYS_INLINE void MoveTowards(const ezSimdVec4f* pThis, const ezSimdVec4f* pNext, const ezSimdVec4f& vWeight, const ezSimdVec4f& vSegLen, ezUInt32 uiFallbackAxis, float fFallbackDir, ezSimdVec4f* pCorrection, ezSimdVec4f& inout_vError)
+  {
+    ezSimdVec4f vDir[3];
+    vDir[0] = pNext[0] - pThis[0];
+    vDir[1] = pNext[1] - pThis[1];
+    vDir[2] = pNext[2] - pThis[2];
+
+    const ezSimdVec4f vLenSqr = ezSimdVec4f::MulAdd(vDir[0], vDir[0], ezSimdVec4f::MulAdd(vDir[1], vDir[1], vDir[2].CompMul(vDir[2])));
+
+    // nodes at the same position are pushed apart along the fallback direction
+    const ezSimdVec4b bTooClose = vLenSqr < ezSimdVec4f(0.001f * 0.001f);
+    const ezSimdVec4f vLen = ezSimdVec4f::Select(bTooClose, ezSimdVec4f(1.0f), vLenSqr.GetSqrt());
+
+    for (ezUInt32 i = 0; i < 3; ++i)
+    {
+      const ezSimdVec4f vFallback((i == uiFallbackAxis) ? fFallbackDir : 0.0f);
+      vDir[i] = ezSimdVec4f::Select(bTooClose, vFallback, vDir[i]);
+    }
+
+    const ezSimdVec4f vLocalError = (vLen - vSegLen).CompMul(vWeight);
+    const ezSimdVec4f vScale = vLocalError.CompDiv(vLen);
+
+    pCorrection[0] = ezSimdVec4f::MulAdd(vDir[0], vScale, pCorrection[0]);
+    pCorrection[1] = ezSimdVec4f::MulAdd(vDir[1], vScale, pCorrection[1]);
+    pCorrection[2] = ezSimdVec4f::MulAdd(vDir[2], vScale, pCorrection[2]);
+
+    // keep track of how much the cloth had to be moved to fulfill the constraint
+    inout_vError += vLocalError.Abs();
+  }
+} // namespace
+
+void ezClothSimulator::SetupNodes()
+{
+  m_uiStride = ezMemoryUtils::AlignSize<ezUInt32>(m_uiWidth, 4);
+  m_uiNumNodes = m_uiWidth * m_uiHeight;
+
+  const ezUInt32 uiNumEntries = m_uiPadding * 2 + m_uiStride * m_uiHeight;
+
+  for (ezUInt32 i = 0; i < 3; ++i)
+  {
+    m_Position[i].Clear();
+    m_Position[i].SetCount(uiNumEntries, 0.0f);
+    m_PreviousPosition[i].Clear();
+    m_PreviousPosition[i].SetCount(uiNumEntries, 0.0f);
+  }
+
+  m_Mobility.Clear();
+  m_Mobility.SetCount(uiNumEntries, 0.0f);
+
+  for (ezUInt32 y = 0; y < m_uiHeight; ++y)
+  {
+    for (ezUInt32 x = 0; x < m_uiWidth; ++x)
+    {
+      m_Mobility[GetNodeIndex(x, y)] = 1.0f;
+    }
+  }
+
+  // each side of a constraint moves half the error
+  m_LeftWeight.Clear();
+  m_LeftWeight.SetCount(m_uiStride, 0.0f);
+  m_RightWeight.Clear();
+  m_RightWeight.SetCount(m_uiStride, 0.0f);
+
+  for (ezUInt32 x = 0; x < m_uiWidth; ++x)
+  {
+    m_LeftWeight[x] = (x > 0) ? 0.5f : 0.0f;
+    m_RightWeight[x] = (x + 1 < m_uiWidth) ? 0.5f : 0.0f;
+  }
+}
+
+void ezClothSimulator::ClearNodes()
+{
+  m_uiStride = 0;
+  m_uiNumNodes = 0;
+
+  for (ezUInt32 i = 0; i < 3; ++i)
+  {
+    m_Position[i].Clear();
+    m_PreviousPosition[i].Clear();
+  }
+
+  m_Mobility.Clear();
+  m_LeftWeight.Clear();
+  m_RightWeight.Clear();
+}
+
+void ezClothSimulator::SetNodePosition(ezUInt32 x, ezUInt32 y, const ezVec3& vPosition)
+{
+  const ezUInt32 idx = GetNodeIndex(x, y);
+
+  for (ezUInt32 i = 0; i < 3; ++i)
+  {
+    m_Position[i][idx] = vPosition.GetData()[i];
+    m_PreviousPosition[i][idx] = vPosition.GetData()[i];
+  }
+}
+
+ezVec3 ezClothSimulator::GetNodePosition(ezUInt32 x, ezUInt32 y) const
+{
+  const ezUInt32 idx = GetNodeIndex(x, y);
+  return ezVec3(m_Position[0][idx], m_Position[1][idx], m_Position[2][idx]);
+}
+
+void ezClothSimulator::SetNodeFixed(ezUInt32 x, ezUInt32 y, bool bFixed)
+{
+  m_Mobility[GetNodeIndex(x, y)] = bFixed ? 0.0f : 1.0f;
+}
+
+bool ezClothSimulator::IsNodeFixed(ezUInt32 x, ezUInt32 y) const
+{
+  return m_Mobility[GetNodeIndex(x, y)] == 0.0f;
+}
+
 void ezClothSimulator::SimulateCloth(const ezTime& tDiff)
 {
   m_leftOverTimeStep += tDiff;
@@ -12,7 +127,7 @@ void ezClothSimulator::SimulateCloth(const ezTime& tDiff)
 
   while (m_leftOverTimeStep >= tStep)
   {
-    SimulateStep(tStepSqr, 32, m_vSegmentLength.x);
+    SimulateStep(tStepSqr, m_uiMaxIterations, m_vSegmentLength.x);
 
     m_leftOverTimeStep -= tStep;
   }
@@ -20,7 +135,7 @@ void ezClothSimulator::SimulateCloth(const ezTime& tDiff)
 
 void ezClothSimulator::SimulateStep(const ezSimdFloat tDiffSqr, ezUInt32 uiMaxIterations, ezSimdFloat fAllowedError)
 {
-  if (m_Nodes.GetCount() < 4)
+  if (m_uiNumNodes < 4)
     return;
 
   UpdateNodePositions(tDiffSqr);
@@ -39,106 +154,158 @@ ezSimdFloat ezClothSimulator::EnforceDistanceConstraint()
 {
   ezSimdFloat fError = ezSimdFloat::Zero();
 
-  for (ezUInt32 y = 0; y < m_uiHeight; ++y)
+  // red-black order: rows of the same color only read from rows of the other color
+  for (ezUInt32 y = 0; y < m_uiHeight; y += 2)
   {
-    for (ezUInt32 x = 0; x < m_uiWidth; ++x)
-    {
-      const ezUInt32 idx = (y * m_uiWidth) + x;
+    fError += EnforceDistanceConstraint(y);
+  }
+
+  for (ezUInt32 y = 1; y < m_uiHeight; y += 2)
+  {
+    fError += EnforceDistanceConstraint(y);
+  }
+
+  return fError;
+}
 
-      auto& n = m_Nodes[idx];
+ezSimdFloat ezClothSimulator::EnforceDistanceConstraint(ezUInt32 y)
+{
+  const ezSimdVec4f vSegLenX(m_vSegmentLength.x);
+  const ezSimdVec4f vSegLenY(m_vSegmentLength.y);
+  const ezSimdVec4f vHalf(0.5f);
 
-      if (n.m_bFixed)
-        continue;
+  const bool bHasUp = y > 0;
+  const bool bHasDown = y + 1 < m_uiHeight;
 
-      const ezSimdVec4f posThis = n.m_vPosition;
+  ezSimdVec4f vError = ezSimdVec4f::ZeroVector();
 
-      if (x > 0)
-      {
-        const ezSimdVec4f pos = m_Nodes[idx - 1].m_vPosition;
-        n.m_vPosition += MoveTowards(posThis, pos, 0.5f, ezSimdVec4f(-1, 0, 0), fError, m_vSegmentLength.x);
-      }
+  for (ezUInt32 x = 0; x < m_uiWidth; x += 4)
+  {
+    const ezUInt32 idx = GetNodeIndex(x, y);
+
+    ezSimdVec4f vMobility;
+    vMobility.Load<4>(&m_Mobility[idx]);
 
-      if (x + 1 < m_uiWidth)
+    if ((vMobility == ezSimdVec4f::ZeroVector()).AllSet<4>())
+      continue;
+
+    ezSimdVec4f vThis[3];
+    ezSimdVec4f vNext[3];
+    ezSimdVec4f vCorrection[3] = {ezSimdVec4f::ZeroVector(), ezSimdVec4f::ZeroVector(), ezSimdVec4f::ZeroVector()};
+
+    for (ezUInt32 i = 0; i < 3; ++i)
+    {
+      vThis[i].Load<4>(&m_Position[i][idx]);
+    }
+
+    // left and right neighbors, the weights are zero at the edges and for the padding
+    {
+      ezSimdVec4f vWeight;
+      vWeight.Load<4>(&m_LeftWeight[x]);
+
+      for (ezUInt32 i = 0; i < 3; ++i)
       {
-        const ezSimdVec4f pos = m_Nodes[idx + 1].m_vPosition;
-        n.m_vPosition += MoveTowards(posThis, pos, 0.5f, ezSimdVec4f(1, 0, 0), fError, m_vSegmentLength.x);
+        vNext[i].Load<4>(&m_Position[i][idx - 1]);
       }
 
-      if (y > 0)
+      MoveTowards(vThis, vNext, vWeight.CompMul(vMobility), vSegLenX, 0, -1.0f, vCorrection, vError);
+    }
+
+    {
+      ezSimdVec4f vWeight;
+      vWeight.Load<4>(&m_RightWeight[x]);
+
+      for (ezUInt32 i = 0; i < 3; ++i)
       {
-        const ezSimdVec4f pos = m_Nodes[idx - m_uiWidth].m_vPosition;
-        n.m_vPosition += MoveTowards(posThis, pos, 0.5f, ezSimdVec4f(0, -1, 0), fError, m_vSegmentLength.y);
+        vNext[i].Load<4>(&m_Position[i][idx + 1]);
       }
 
-      if (y + 1 < m_uiHeight)
+      MoveTowards(vThis, vNext, vWeight.CompMul(vMobility), vSegLenX, 0, 1.0f, vCorrection, vError);
+    }
+
+    if (bHasUp)
+    {
+      for (ezUInt32 i = 0; i < 3; ++i)
       {
-        const ezSimdVec4f pos = m_Nodes[idx + m_uiWidth].m_vPosition;
-        n.m_vPosition += MoveTowards(posThis, pos, 0.5f, ezSimdVec4f(0, 1, 0), fError, m_vSegmentLength.y);
+        vNext[i].Load<4>(&m_Position[i][idx - m_uiStride]);
       }
+
+      MoveTowards(vThis, vNext, vHalf.CompMul(vMobility), vSegLenY, 1, -1.0f, vCorrection, vError);
     }
-  }
 
-  return fError;
-}
+    if (bHasDown)
+    {
+      for (ezUInt32 i = 0; i < 3; ++i)
+      {
+        vNext[i].Load<4>(&m_Position[i][idx + m_uiStride]);
+      }
 
-ezSimdVec4f ezClothSimulator::MoveTowards(const ezSimdVec4f posThis, const ezSimdVec4f posNext, ezSimdFloat factor, const ezSimdVec4f fallbackDir, ezSimdFloat& inout_fError, ezSimdFloat fSegLen)
-{
-  ezSimdVec4f vDir = (posNext - posThis);
-  ezSimdFloat fLen = vDir.GetLength<3>();
+      MoveTowards(vThis, vNext, vHalf.CompMul(vMobility), vSegLenY, 1, 1.0f, vCorrection, vError);
+    }
 
-  if (fLen.IsEqual(ezSimdFloat::Zero(), 0.001f))
-  {
-    vDir = fallbackDir;
-    fLen = 1;
+    for (ezUInt32 i = 0; i < 3; ++i)
+    {
+      (vThis[i] + vCorrection[i]).Store<4>(&m_Position[i][idx]);
+    }
   }
 
-  vDir /= fLen;
-  fLen -= fSegLen;
-
-  const ezSimdFloat fLocalError = fLen * factor;
-
-  vDir *= fLocalError;
-
-  // keep track of how much the rope had to be moved to fulfill the constraint
-  inout_fError += fLocalError.Abs();
-
-  return vDir;
+  return vError.HorizontalSum<4>();
 }
 
 void ezClothSimulator::UpdateNodePositions(const ezSimdFloat tDiffSqr)
 {
-  const ezSimdFloat damping = m_fDampingFactor;
-  const ezSimdVec4f acceleration = ezSimdConversion::ToVec3(m_vAcceleration) * tDiffSqr;
+  const ezSimdVec4f damping(m_fDampingFactor);
+  const ezSimdVec4f acceleration[3] = {
+    ezSimdVec4f(ezSimdFloat(m_vAcceleration.x) * tDiffSqr),
+    ezSimdVec4f(ezSimdFloat(m_vAcceleration.y) * tDiffSqr),
+    ezSimdVec4f(ezSimdFloat(m_vAcceleration.z) * tDiffSqr),
+  };
+
+  const ezUInt32 uiNumEntries = m_Mobility.GetCount();
 
-  for (auto& n : m_Nodes)
+  for (ezUInt32 n = 0; n < uiNumEntries; n += 4)
   {
-    if (n.m_bFixed)
-    {
-      n.m_vPreviousPosition = n.m_vPosition;
-    }
-    else
+    ezSimdVec4f vMobility;
+    vMobility.Load<4>(&m_Mobility[n]);
+
+    for (ezUInt32 i = 0; i < 3; ++i)
     {
       // this (simple) logic is the so called 'Verlet integration' (+ damping)
+      // fixed nodes have a mobility of zero, so they stay in place and their velocity stays zero
 
-      const ezSimdVec4f previousPos = n.m_vPosition;
+      ezSimdVec4f vPos, vPrevPos;
+      vPos.Load<4>(&m_Position[i][n]);
+      vPrevPos.Load<4>(&m_PreviousPosition[i][n]);
 
-      const ezSimdVec4f vel = (n.m_vPosition - n.m_vPreviousPosition) * damping;
+      const ezSimdVec4f vel = (vPos - vPrevPos).CompMul(damping);
 
-      // instead of using a single global acceleration, this could also use individual accelerations per node
-      // this would be needed to affect the rope more localized
-      n.m_vPosition += vel + acceleration;
-      n.m_vPreviousPosition = previousPos;
+      vPos.Store<4>(&m_PreviousPosition[i][n]);
+      ezSimdVec4f::MulAdd(vel + acceleration[i], vMobility, vPos).Store<4>(&m_Position[i][n]);
     }
   }
 }
 
 bool ezClothSimulator::HasEquilibrium(ezSimdFloat fAllowedMovement) const
 {
-  const ezSimdFloat fErrorSqr = fAllowedMovement * fAllowedMovement;
+  const ezSimdVec4f fErrorSqr(fAllowedMovement * fAllowedMovement);
 
-  for (const auto& n : m_Nodes)
+  const ezUInt32 uiNumEntries = m_Mobility.GetCount();
+
+  for (ezUInt32 n = 0; n < uiNumEntries; n += 4)
   {
-    if ((n.m_vPosition - n.m_vPreviousPosition).GetLengthSquared<3>() > fErrorSqr)
+    ezSimdVec4f vMovementSqr = ezSimdVec4f::ZeroVector();
+
+    for (ezUInt32 i = 0; i < 3; ++i)
+    {
+      ezSimdVec4f vPos, vPrevPos;
+      vPos.Load<4>(&m_Position[i][n]);
+      vPrevPos.Load<4>(&m_PreviousPosition[i][n]);
+
+      const ezSimdVec4f vMovement = vPos - vPrevPos;
+      vMovementSqr = ezSimdVec4f::MulAdd(vMovement, vMovement, vMovementSqr);
+    }
+
+    if ((vMovementSqr > fErrorSqr).AnySet<4>())
     {
       return false;
     }
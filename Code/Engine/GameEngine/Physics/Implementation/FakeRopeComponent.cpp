@@ -264,6 +264,8 @@ void ezFakeRopeComponent::RuntimeUpdate()
     return;
   }
 
+  // ropes that were not rendered recently keep swinging for a while, but with less precision
+  m_RopeSim.m_uiMaxIterations = uiFramesVisible <= 1 ? 32 : 8;
 
   m_RopeSim.SimulateRope(GetWorld()->GetClock().GetTimeDiff());
 
@@ -396,6 +398,7 @@ void ezFakeRopeComponentManager::Initialize()
     auto desc = EZ_CREATE_MODULE_UPDATE_FUNCTION_DESC(ezFakeRopeComponentManager::Update, this);
     desc.m_Phase = ezWorldModule::UpdateFunctionDesc::Phase::Async;
     desc.m_bOnlyUpdateWhenSimulating = false;
+    desc.m_uiGranularity = 16; // simulate batches of ropes on all worker threads
 
     this->RegisterUpdateFunction(desc);
   }
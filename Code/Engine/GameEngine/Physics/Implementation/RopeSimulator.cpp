@@ -16,7 +16,7 @@ void ezRopeSimulator::SimulateRope(const ezTime& tDiff)
 
   while (m_leftOverTimeStep >= tStep)
   {
-    SimulateStep(tStepSqr, 32, fAllowedError);
+    SimulateStep(tStepSqr, m_uiMaxIterations, fAllowedError);
 
     m_leftOverTimeStep -= tStep;
   }
@@ -46,6 +46,9 @@ public:
   bool m_bFirstNodeIsFixed = true;
   bool m_bLastNodeIsFixed = true;
 
+  /// \brief How often SimulateRope() enforces the distance constraints per step at most. Can be lowered for ropes that are not visible.
+  ezUInt32 m_uiMaxIterations = 32;
+
   void SimulateRope(const ezTime& tDiff);
   void SimulateStep(const ezSimdFloat tDiffSqr, ezUInt32 uiMaxIterations, ezSimdFloat fAllowedError);
   void SimulateTillEquilibrium(ezSimdFloat fAllowedMovement = 0.005f, ezUInt32 uiMaxIterations = 1000);
@@ -27,53 +27,36 @@ void ezVisualScriptInstance::Clear()
   }
 
   m_pWorld = nullptr;
+  m_pDescriptor = nullptr;
   m_Nodes.Clear();
-  m_ExecutionConnections.Clear();
-  m_DataConnections.Clear();
+  m_DataTargets.Clear();
   m_LocalVariables.Clear();
   m_hScriptResource.Invalidate();
 }
 
 
-void ezVisualScriptInstance::ComputeNodeDependencies()
+void ezVisualScriptInstance::ExecuteDependencies(ezUInt16 uiNode)
 {
-  m_NodeDependencies.SetCount(m_Nodes.GetCount());
+  const auto& compiledNode = m_pDescriptor->m_CompiledNodes[uiNode];
+  const ezUInt16* pDependencies = m_pDescriptor->m_CompiledDependencies.GetData() + compiledNode.m_uiFirstDependency;
 
-  for (auto it = m_DataConnections.GetIterator(); it.IsValid(); ++it)
+  // the list is already flattened and ordered such that the most dependent nodes come first
+  // only nodes that are not manually stepped are in the dependency list, so we do not need to filter those out here
+  for (ezUInt32 i = 0; i < compiledNode.m_uiNumDependencies; ++i)
   {
-    const ezVisualScriptPinConnectionID src = it.Key();
-
-    const ezUInt16 uiSourceNode = (src >> 16) & 0xFFFF;
-
-    if (m_Nodes[uiSourceNode]->IsManuallyStepped())
-      continue;
-
-    const ezHybridArray<DataPinConnection, 2>& dst = it.Value();
-
-    for (const DataPinConnection& target : dst)
-    {
-      m_NodeDependencies[target.m_uiTargetNode].PushBack(uiSourceNode);
-    }
+    auto* pNode = m_Nodes[pDependencies[i]];
+    pNode->Execute(this, 0);
+    pNode->m_bInputValuesChanged = false;
   }
 }
 
-
-void ezVisualScriptInstance::ExecuteDependentNodes(ezUInt16 uiNode)
+void ezVisualScriptInstance::ExecuteNode(ezUInt16 uiNode, ezUInt8 uiExecPin)
 {
-  const auto& dep = m_NodeDependencies[uiNode];
-  for (ezUInt32 i = 0; i < dep.GetCount(); ++i)
-  {
-    const ezUInt16 uiDependency = dep[i];
-    auto* pNode = m_Nodes[uiDependency];
-
-    // recurse to the most dependent nodes first
-    ExecuteDependentNodes(uiDependency);
+  ExecuteDependencies(uiNode);
 
-    // only nodes that are not manually stepped are in the dependency list
-    // so we do not need to filter those out here
-    pNode->Execute(this, 0);
-    pNode->m_bInputValuesChanged = false;
-  }
+  auto* pNode = m_Nodes[uiNode];
+  pNode->Execute(this, uiExecPin);
+  pNode->m_bInputValuesChanged = false;
 }
 
 void ezVisualScriptInstance::Configure(const ezVisualScriptResourceHandle& hScript, ezComponent* pOwnerComponent)
@@ -83,6 +66,7 @@ void ezVisualScriptInstance::Configure(const ezVisualScriptResourceHandle& hScri
   ezResourceLock<ezVisualScriptResource> pScript(hScript, ezResourceAcquireMode::BlockTillLoaded);
   const auto& resource = pScript->GetDescriptor();
   m_pMessageHandlers = &resource.m_MessageHandlers;
+  m_pDescriptor = &resource;
 
   m_hScriptResource = hScript;
 
@@ -126,21 +110,20 @@ void ezVisualScriptInstance::Configure(const ezVisualScriptResourceHandle& hScri
     }
   }
 
-  m_ExecutionConnections.Reserve(resource.m_ExecutionPaths.GetCount());
+  // the connections are resolved once per resource, only the pointers into this instance's nodes need to be set up here
+  m_DataTargets.SetCountUninitialized(resource.m_DataPaths.GetCount());
 
-  for (const auto& con : resource.m_ExecutionPaths)
+  for (ezUInt32 i = 0; i < resource.m_DataPaths.GetCount(); ++i)
   {
-    ConnectExecutionPins(con.m_uiSourceNode, con.m_uiOutputPin, con.m_uiTargetNode, con.m_uiInputPin);
-  }
+    const auto& con = resource.m_DataPaths[i];
 
-  for (const auto& con : resource.m_DataPaths)
-  {
-    ConnectDataPins(con.m_uiSourceNode, con.m_uiOutputPin, (ezVisualScriptDataPinType::Enum)con.m_uiOutputPinType, con.m_uiTargetNode,
-      con.m_uiInputPin, (ezVisualScriptDataPinType::Enum)con.m_uiInputPinType);
+    DataPinConnection& target = m_DataTargets[i];
+    target.m_uiTargetNode = con.m_uiTargetNode;
+    target.m_uiTargetPin = con.m_uiInputPin;
+    target.m_pTargetData = m_Nodes[con.m_uiTargetNode]->GetInputPinDataPointer(con.m_uiInputPin);
+    target.m_AssignFunc = FindDataPinAssignFunction((ezVisualScriptDataPinType::Enum)con.m_uiOutputPinType, (ezVisualScriptDataPinType::Enum)con.m_uiInputPinType);
   }
 
-  ComputeNodeDependencies();
-
   // initialize local variables
   {
     for (const auto& p : resource.m_BoolParameters)
@@ -346,7 +329,7 @@ void ezVisualScriptInstance::ExecuteScript(ezVisualScriptInstanceActivity* pActi
 
     if (pNode->m_bStepNode)
     {
-      ExecuteDependentNodes(i);
+      ExecuteDependencies(i);
 
       // node stepping is always executed, even if the node only 'wants' to be executed on input change
       pNode->m_bStepNode = false;
@@ -381,32 +364,17 @@ bool ezVisualScriptInstance::HandleMessage(ezMessage& msg)
   return bHandled;
 }
 
-void ezVisualScriptInstance::ConnectExecutionPins(ezUInt16 uiSourceNode, ezUInt8 uiOutputSlot, ezUInt16 uiTargetNode, ezUInt8 uiTargetPin)
-{
-  auto& con = m_ExecutionConnections[((ezUInt32)uiSourceNode << 16) | (ezUInt32)uiOutputSlot];
-  con.m_uiTargetNode = uiTargetNode;
-  con.m_uiTargetPin = uiTargetPin;
-}
-
-void ezVisualScriptInstance::ConnectDataPins(ezUInt16 uiSourceNode, ezUInt8 uiSourcePin, ezVisualScriptDataPinType::Enum sourcePinType,
-  ezUInt16 uiTargetNode, ezUInt8 uiTargetPin, ezVisualScriptDataPinType::Enum targetPinType)
-{
-  DataPinConnection& con = m_DataConnections[((ezUInt32)uiSourceNode << 16) | (ezUInt32)uiSourcePin].ExpandAndGetRef();
-  con.m_uiTargetNode = uiTargetNode;
-  con.m_uiTargetPin = uiTargetPin;
-  con.m_pTargetData = m_Nodes[uiTargetNode]->GetInputPinDataPointer(uiTargetPin);
-  con.m_AssignFunc = FindDataPinAssignFunction(sourcePinType, targetPinType);
-}
-
 void ezVisualScriptInstance::SetOutputPinValue(const ezVisualScriptNode* pNode, ezUInt8 uiPin, const void* pValue)
 {
-  const ezUInt32 uiConnectionID = ((ezUInt32)pNode->m_uiNodeID << 16) | (ezUInt32)uiPin;
+  const auto& compiledNode = m_pDescriptor->m_CompiledNodes[pNode->m_uiNodeID];
+  if (uiPin >= compiledNode.m_uiNumDataOutputs)
+    return;
 
-  ezHybridArray<DataPinConnection, 2>* TargetNodeAndPins;
-  if (!m_DataConnections.TryGetValue(uiConnectionID, TargetNodeAndPins))
+  const auto& output = m_pDescriptor->m_CompiledDataOutputs[compiledNode.m_uiFirstDataOutput + uiPin];
+  if (output.m_uiNumConnections == 0)
     return;
 
-  for (const DataPinConnection& TargetNodeAndPin : *TargetNodeAndPins)
+  for (const DataPinConnection& TargetNodeAndPin : m_DataTargets.GetArrayPtr().GetSubArray(output.m_uiFirstConnection, output.m_uiNumConnections))
   {
     if (TargetNodeAndPin.m_AssignFunc)
     {
@@ -419,7 +387,7 @@ void ezVisualScriptInstance::SetOutputPinValue(const ezVisualScriptNode* pNode,
 
   if (m_pActivity != nullptr)
   {
-    m_pActivity->m_ActiveDataConnections.PushBack(uiConnectionID);
+    m_pActivity->m_ActiveDataConnections.PushBack(((ezUInt32)pNode->m_uiNodeID << 16) | (ezUInt32)uiPin);
   }
 }
 
@@ -430,22 +398,19 @@ Otherwise visual script graph execution can end up in an endless recursion with
 Override ezVisualScriptNode::IsManuallyStepped() for type '{}' if necessary.",
     pNode->GetDynamicRTTI()->GetTypeName());
 
-  const ezUInt32 uiConnectionID = ((ezUInt32)pNode->m_uiNodeID << 16) | (ezUInt32)uiNthTarget;
-
-  ExecPinConnection TargetNode;
-  if (!m_ExecutionConnections.TryGetValue(uiConnectionID, TargetNode))
+  const auto& compiledNode = m_pDescriptor->m_CompiledNodes[pNode->m_uiNodeID];
+  if (uiNthTarget >= compiledNode.m_uiNumExecOutputs)
     return;
 
-  auto* pTargetNode = m_Nodes[TargetNode.m_uiTargetNode];
-
-  ExecuteDependentNodes(TargetNode.m_uiTargetNode);
+  const auto& output = m_pDescriptor->m_CompiledExecOutputs[compiledNode.m_uiFirstExecOutput + uiNthTarget];
+  if (output.m_uiTargetNode == 0xFFFF)
+    return;
 
-  pTargetNode->Execute(this, TargetNode.m_uiTargetPin);
-  pTargetNode->m_bInputValuesChanged = false;
+  ExecuteNode(output.m_uiTargetNode, output.m_uiTargetPin);
 
   if (m_pActivity != nullptr)
   {
-    m_pActivity->m_ActiveExecutionConnections.PushBack(uiConnectionID);
+    m_pActivity->m_ActiveExecutionConnections.PushBack(((ezUInt32)pNode->m_uiNodeID << 16) | (ezUInt32)uiNthTarget);
   }
 }
 
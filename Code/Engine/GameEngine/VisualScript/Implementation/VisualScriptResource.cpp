@@ -71,6 +71,7 @@ void ezVisualScriptResource::UpdateMemoryUsage(MemoryUsage& out_NewMemoryUsage)
 EZ_RESOURCE_IMPLEMENT_CREATEABLE(ezVisualScriptResource, ezVisualScriptResourceDescriptor)
 {
   m_Descriptor = descriptor;
+  m_Descriptor.Compile();
 
   ezResourceLoadDesc res;
   res.m_uiQualityLevelsDiscardable = 0;
@@ -221,6 +222,7 @@ void ezVisualScriptResourceDescriptor::Load(ezStreamReader& stream)
   }
 
   PrecomputeMessageHandlers();
+  Compile();
 }
 
 void ezVisualScriptResourceDescriptor::Save(ezStreamWriter& stream) const
@@ -356,6 +358,147 @@ void ezVisualScriptResourceDescriptor::PrecomputeMessageHandlers()
   }
 }
 
+namespace
+{
+  bool IsNodeManuallyStepped(const ezVisualScriptResourceDescriptor::Node& node)
+  {
+    // message senders, message handlers and function calls always have execution pins
+    if (node.m_isMsgSender || node.m_isMsgHandler || node.m_isFunctionCall)
+      return true;
+
+    if (node.m_pType == nullptr || !node.m_pType->IsDerivedFrom<ezVisualScriptNode>() || !node.m_pType->GetAllocator()->CanAllocate())
+      return false;
+
+    ezVisualScriptNode* pNode = node.m_pType->GetAllocator()->Allocate<ezVisualScriptNode>();
+    const bool bManuallyStepped = pNode->IsManuallyStepped();
+    node.m_pType->GetAllocator()->Deallocate(pNode);
+
+    return bManuallyStepped;
+  }
+
+  void CollectDependencies(ezUInt16 uiNode, ezUInt32 uiVisitedMarker, const ezDynamicArray<ezHybridArray<ezUInt16, 4>>& inputNodes, ezDynamicArray<ezUInt32>& visited, ezDynamicArray<ezUInt16>& out_Dependencies)
+  {
+    for (const ezUInt16 uiInputNode : inputNodes[uiNode])
+    {
+      // each node only needs to run once, this also stops at cycles
+      if (visited[uiInputNode] == uiVisitedMarker)
+        continue;
+
+      visited[uiInputNode] = uiVisitedMarker;
+
+      // the most dependent nodes need to run first
+      CollectDependencies(uiInputNode, uiVisitedMarker, inputNodes, visited, out_Dependencies);
+      out_Dependencies.PushBack(uiInputNode);
+    }
+  }
+} // namespace
+
+void ezVisualScriptResourceDescriptor::Compile()
+{
+  const ezUInt32 uiNumNodes = m_Nodes.GetCount();
+
+  m_CompiledNodes.Clear();
+  m_CompiledNodes.SetCount(uiNumNodes);
+  m_CompiledDependencies.Clear();
+  m_CompiledExecOutputs.Clear();
+  m_CompiledDataOutputs.Clear();
+
+  ezDynamicArray<bool> manuallyStepped;
+  manuallyStepped.SetCountUninitialized(uiNumNodes);
+
+  for (ezUInt32 uiNode = 0; uiNode < uiNumNodes; ++uiNode)
+  {
+    manuallyStepped[uiNode] = IsNodeManuallyStepped(m_Nodes[uiNode]);
+  }
+
+  // sort the data connections, so that all connections of an output pin are next to each other
+  m_DataPaths.Sort([](const DataConnection& a, const DataConnection& b) {
+    if (a.m_uiSourceNode != b.m_uiSourceNode)
+      return a.m_uiSourceNode < b.m_uiSourceNode;
+    if (a.m_uiOutputPin != b.m_uiOutputPin)
+      return a.m_uiOutputPin < b.m_uiOutputPin;
+    if (a.m_uiTargetNode != b.m_uiTargetNode)
+      return a.m_uiTargetNode < b.m_uiTargetNode;
+    return a.m_uiInputPin < b.m_uiInputPin;
+  });
+
+  // nodes without execution pins are executed on demand, right before a node that reads their output
+  {
+    ezDynamicArray<ezHybridArray<ezUInt16, 4>> inputNodes;
+    inputNodes.SetCount(uiNumNodes);
+
+    for (const DataConnection& con : m_DataPaths)
+    {
+      if (!manuallyStepped[con.m_uiSourceNode])
+      {
+        inputNodes[con.m_uiTargetNode].PushBack(con.m_uiSourceNode);
+      }
+    }
+
+    ezDynamicArray<ezUInt32> visited;
+    visited.SetCount(uiNumNodes, 0);
+
+    for (ezUInt32 uiNode = 0; uiNode < uiNumNodes; ++uiNode)
+    {
+      CompiledNode& compiledNode = m_CompiledNodes[uiNode];
+      compiledNode.m_uiFirstDependency = m_CompiledDependencies.GetCount();
+
+      CollectDependencies(static_cast<ezUInt16>(uiNode), uiNode + 1, inputNodes, visited, m_CompiledDependencies);
+
+      compiledNode.m_uiNumDependencies = static_cast<ezUInt16>(m_CompiledDependencies.GetCount() - compiledNode.m_uiFirstDependency);
+    }
+  }
+
+  // one slot per output pin, up to the highest connected pin
+  {
+    for (const ExecutionConnection& con : m_ExecutionPaths)
+    {
+      CompiledNode& compiledNode = m_CompiledNodes[con.m_uiSourceNode];
+      compiledNode.m_uiNumExecOutputs = ezMath::Max<ezUInt8>(compiledNode.m_uiNumExecOutputs, con.m_uiOutputPin + 1);
+    }
+
+    for (const DataConnection& con : m_DataPaths)
+    {
+      CompiledNode& compiledNode = m_CompiledNodes[con.m_uiSourceNode];
+      compiledNode.m_uiNumDataOutputs = ezMath::Max<ezUInt8>(compiledNode.m_uiNumDataOutputs, con.m_uiOutputPin + 1);
+    }
+
+    ezUInt32 uiNumExecOutputs = 0;
+    ezUInt32 uiNumDataOutputs = 0;
+
+    for (CompiledNode& compiledNode : m_CompiledNodes)
+    {
+      compiledNode.m_uiFirstExecOutput = uiNumExecOutputs;
+      compiledNode.m_uiFirstDataOutput = uiNumDataOutputs;
+      uiNumExecOutputs += compiledNode.m_uiNumExecOutputs;
+      uiNumDataOutputs += compiledNode.m_uiNumDataOutputs;
+    }
+
+    m_CompiledExecOutputs.SetCount(uiNumExecOutputs);
+    m_CompiledDataOutputs.SetCount(uiNumDataOutputs);
+  }
+
+  for (const ExecutionConnection& con : m_ExecutionPaths)
+  {
+    CompiledExecOutput& output = m_CompiledExecOutputs[m_CompiledNodes[con.m_uiSourceNode].m_uiFirstExecOutput + con.m_uiOutputPin];
+    output.m_uiTargetNode = con.m_uiTargetNode;
+    output.m_uiTargetPin = con.m_uiInputPin;
+  }
+
+  for (ezUInt32 uiCon = 0; uiCon < m_DataPaths.GetCount(); ++uiCon)
+  {
+    const DataConnection& con = m_DataPaths[uiCon];
+    CompiledDataOutput& output = m_CompiledDataOutputs[m_CompiledNodes[con.m_uiSourceNode].m_uiFirstDataOutput + con.m_uiOutputPin];
+
+    if (output.m_uiNumConnections == 0)
+    {
+      output.m_uiFirstConnection = uiCon;
+    }
+
+    ++output.m_uiNumConnections;
+  }
+}
+
 void ezVisualScriptResourceDescriptor::AssignNodeProperties(ezVisualScriptNode& vsNode, const Node& properties) const
 {
   for (ezUInt32 i = 0; i < properties.m_uiNumProperties; ++i)
@@ -76,12 +76,12 @@ private:
   friend class ezVisualScriptNode;
 
   void Clear();
-  void ComputeNodeDependencies();
-  void ExecuteDependentNodes(ezUInt16 uiNode);
 
-  void ConnectExecutionPins(ezUInt16 uiSourceNode, ezUInt8 uiOutputSlot, ezUInt16 uiTargetNode, ezUInt8 uiTargetPin);
-  void ConnectDataPins(ezUInt16 uiSourceNode, ezUInt8 uiSourcePin, ezVisualScriptDataPinType::Enum sourcePinType, ezUInt16 uiTargetNode,
-    ezUInt8 uiTargetPin, ezVisualScriptDataPinType::Enum targetPinType);
+  /// \brief Runs all nodes that the given node depends on, in the order that was precomputed by ezVisualScriptResourceDescriptor::Compile().
+  void ExecuteDependencies(ezUInt16 uiNode);
+
+  /// \brief Runs the dependencies of the node and then the node itself.
+  void ExecuteNode(ezUInt16 uiNode, ezUInt8 uiExecPin);
 
   void CreateVisualScriptNode(ezUInt32 uiNodeIdx, const ezVisualScriptResourceDescriptor& resource);
   void CreateMessageSenderNode(ezUInt32 uiNodeIdx, const ezVisualScriptResourceDescriptor& resource);
@@ -99,22 +99,13 @@ private:
     void* m_pTargetData = nullptr;
   };
 
-  struct ExecPinConnection
-  {
-    EZ_DECLARE_POD_TYPE();
-
-    ezUInt16 m_uiTargetNode;
-    ezUInt8 m_uiTargetPin;
-  };
-
   ezVisualScriptResourceHandle m_hScriptResource;
   ezGameObjectHandle m_hOwnerObject;
   ezComponentHandle m_hOwnerComponent;
   ezWorld* m_pWorld = nullptr;
   ezDynamicArray<ezVisualScriptNode*> m_Nodes;
-  ezDynamicArray<ezHybridArray<ezUInt16, 2>> m_NodeDependencies;
-  ezHashTable<ezVisualScriptNodeConnectionID, ExecPinConnection> m_ExecutionConnections;
-  ezHashTable<ezVisualScriptPinConnectionID, ezHybridArray<DataPinConnection, 2>> m_DataConnections;
+  ezDynamicArray<DataPinConnection> m_DataTargets; ///< One entry per data connection in the resource, in the same order
+  const ezVisualScriptResourceDescriptor* m_pDescriptor = nullptr;
   ezStateMap m_LocalVariables;
   ezVisualScriptInstanceActivity* m_pActivity = nullptr;
   const ezArrayMap<ezMessageId, ezUInt16>* m_pMessageHandlers = nullptr;
@@ -16,6 +16,12 @@ struct EZ_GAMEENGINE_DLL ezVisualScriptResourceDescriptor
   void Save(ezStreamWriter& stream) const;
   void PrecomputeMessageHandlers();
 
+  /// \brief Flattens the graph into the m_Compiled tables, which are what ezVisualScriptInstance executes. Called by Load().
+  ///
+  /// For every node this resolves the nodes without execution pins that have to run before it (in order and without duplicates),
+  /// and turns the connections into arrays that are indexed by node and pin. Sorts m_DataPaths by source node and pin.
+  void Compile();
+
   struct Node
   {
     Node()
@@ -84,6 +90,34 @@ struct EZ_GAMEENGINE_DLL ezVisualScriptResourceDescriptor
     ezString m_sValue;
   };
 
+  struct CompiledNode
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezUInt32 m_uiFirstDependency = 0; ///< Index into m_CompiledDependencies
+    ezUInt32 m_uiFirstExecOutput = 0; ///< Index into m_CompiledExecOutputs, one entry per output execution pin
+    ezUInt32 m_uiFirstDataOutput = 0; ///< Index into m_CompiledDataOutputs, one entry per output data pin
+    ezUInt16 m_uiNumDependencies = 0;
+    ezUInt8 m_uiNumExecOutputs = 0;
+    ezUInt8 m_uiNumDataOutputs = 0;
+  };
+
+  struct CompiledExecOutput
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezUInt16 m_uiTargetNode = 0xFFFF; ///< 0xFFFF if the pin is not connected
+    ezUInt8 m_uiTargetPin = 0;
+  };
+
+  struct CompiledDataOutput
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezUInt32 m_uiFirstConnection = 0; ///< Index into m_DataPaths
+    ezUInt32 m_uiNumConnections = 0;
+  };
+
   void AssignNodeProperties(ezVisualScriptNode& vsNode, const Node& properties) const;
 
   ezDynamicArray<Node> m_Nodes;
@@ -94,6 +128,11 @@ struct EZ_GAMEENGINE_DLL ezVisualScriptResourceDescriptor
   ezDynamicArray<LocalParameterBool> m_BoolParameters;
   ezDynamicArray<LocalParameterNumber> m_NumberParameters;
   ezDynamicArray<LocalParameterString> m_StringParameters;
+
+  ezDynamicArray<CompiledNode> m_CompiledNodes;
+  ezDynamicArray<ezUInt16> m_CompiledDependencies;
+  ezDynamicArray<CompiledExecOutput> m_CompiledExecOutputs;
+  ezDynamicArray<CompiledDataOutput> m_CompiledDataOutputs;
 };
 
 class EZ_GAMEENGINE_DLL ezVisualScriptResource : public ezResource
@@ -57,6 +57,18 @@ public:
   void Configure(const ezSkeletonResourceHandle& hSkeleton, ezAnimPoseGenerator& poseGenerator, ezBlackboard* pBlackboard = nullptr);
 
   void Update(ezTime tDiff, ezGameObject* pTarget);
+
+  /// \brief Steps all nodes, which records the commands for the pose generator. Returns false if no pose can be generated this frame.
+  ///
+  /// UpdateNodes(), GeneratePose() and SendPoseUpdate() together do the same as Update(). GeneratePoseAsync() can be used instead of
+  /// GeneratePose() to run the expensive pose generation of many graphs in parallel. It is the only one of these functions that may be
+  /// called from another thread, and only if the pose generator reports CanGeneratePoseAsync().
+  /// The skeleton stays acquired from a successful UpdateNodes() until SendPoseUpdate().
+  bool UpdateNodes(ezTime tDiff, ezGameObject* pTarget);
+  void GeneratePose(const ezGameObject* pTarget);
+  void GeneratePoseAsync();
+  void SendPoseUpdate(ezGameObject* pTarget);
+
   void GetRootMotion(ezVec3& translation, ezAngle& rotationX, ezAngle& rotationY, ezAngle& rotationZ) const;
 
   ezBlackboard* GetBlackboard() { return m_pBlackboard; }
@@ -76,8 +88,11 @@ public:
   void SetRootMotion(const ezVec3& translation, ezAngle rotationX, ezAngle rotationY, ezAngle rotationZ);
 
 private:
+  void ReleaseSkeleton();
+
   ezDynamicArray<ezUniquePtr<ezAnimGraphNode>> m_Nodes;
   ezSkeletonResourceHandle m_hSkeleton;
+  ezSkeletonResource* m_pAcquiredSkeleton = nullptr;
 
   ezDynamicArray<ezDynamicArray<ezUInt16>> m_OutputPinToInputPinMapping[ezAnimGraphPin::ENUM_COUNT];
 
@@ -85,10 +100,16 @@ private:
   ezDynamicArray<ezInt8> m_TriggerInputPinStates;
   ezDynamicArray<double> m_NumberInputPinStates;
   ezDynamicArray<ezUInt16> m_BoneWeightInputPinStates;
-  ezDynamicArray<ezHybridArray<ezUInt16, 1>> m_LocalPoseInputPinStates;
+  ezDynamicArray<ezUInt8> m_LocalPoseInputPinStates; // number of poses connected to each input pin this frame, the poses are stored in m_LocalPoseInputPinSlots
   ezDynamicArray<ezUInt16> m_ModelPoseInputPinStates;
 
+  // all local pose input pins can receive multiple poses, the slots for them are allocated once in PrepareInputPinSlots()
+  // the slots of input pin i are m_LocalPoseInputPinSlots[m_LocalPoseInputPinSlotOffsets[i] .. m_LocalPoseInputPinSlotOffsets[i + 1]]
+  ezDynamicArray<ezUInt16> m_LocalPoseInputPinSlotOffsets;
+  ezDynamicArray<ezUInt16> m_LocalPoseInputPinSlots;
+
   ezAnimGraphPinDataModelTransforms* m_pCurrentModelTransforms = nullptr;
+  ezArrayPtr<ezMat4> m_GeneratedPose;
 
   ezVec3 m_vRootMotion = ezVec3::ZeroVector();
   ezAngle m_RootRotationX;
@@ -109,6 +130,8 @@ private:
   friend class ezAnimGraphNumberInputPin;
   friend class ezAnimGraphNumberOutputPin;
 
+  void PrepareInputPinSlots();
+
   bool m_bInitialized = false;
 
   ezAnimPoseGenerator* m_pPoseGenerator = nullptr;
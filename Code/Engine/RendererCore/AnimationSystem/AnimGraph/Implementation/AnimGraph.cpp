@@ -10,7 +10,10 @@ ezMutex ezAnimGraph::s_SharedDataMutex;
 ezHashTable<ezString, ezSharedPtr<ezAnimGraphSharedBoneWeights>> ezAnimGraph::s_SharedBoneWeights;
 
 ezAnimGraph::ezAnimGraph() = default;
-ezAnimGraph::~ezAnimGraph() = default;
+ezAnimGraph::~ezAnimGraph()
+{
+  ReleaseSkeleton();
+}
 
 void ezAnimGraph::Configure(const ezSkeletonResourceHandle& hSkeleton, ezAnimPoseGenerator& poseGenerator, ezBlackboard* pBlackboard /*= nullptr*/)
 {
@@ -21,12 +24,33 @@ void ezAnimGraph::Configure(const ezSkeletonResourceHandle& hSkeleton, ezAnimPos
 
 void ezAnimGraph::Update(ezTime tDiff, ezGameObject* pTarget)
 {
-  if (!m_hSkeleton.IsValid())
+  if (!UpdateNodes(tDiff, pTarget))
     return;
 
-  ezResourceLock<ezSkeletonResource> pSkeleton(m_hSkeleton, ezResourceAcquireMode::BlockTillLoaded_NeverFail);
-  if (pSkeleton.GetAcquireResult() != ezResourceAcquireResult::Final)
-    return;
+  GeneratePose(pTarget);
+  SendPoseUpdate(pTarget);
+}
+
+bool ezAnimGraph::UpdateNodes(ezTime tDiff, ezGameObject* pTarget)
+{
+  ReleaseSkeleton();
+
+  if (!m_hSkeleton.IsValid())
+    return false;
+
+  // the pose generator keeps using the skeleton until SendPoseUpdate(), possibly from another thread in between,
+  // so it stays acquired until then instead of only for the scope of this function
+  ezResourceAcquireResult acquireResult = ezResourceAcquireResult::None;
+  ezSkeletonResource* pSkeleton = ezResourceManager::BeginAcquireResource(m_hSkeleton, ezResourceAcquireMode::BlockTillLoaded_NeverFail, ezSkeletonResourceHandle(), &acquireResult);
+  if (acquireResult != ezResourceAcquireResult::Final)
+  {
+    if (pSkeleton != nullptr)
+      ezResourceManager::EndAcquireResource(pSkeleton);
+
+    return false;
+  }
+
+  m_pAcquiredSkeleton = pSkeleton;
 
   if (!m_bInitialized)
   {
@@ -36,13 +60,14 @@ void ezAnimGraph::Update(ezTime tDiff, ezGameObject* pTarget)
 
     for (const auto& pNode : m_Nodes)
     {
-      pNode->Initialize(*this, pSkeleton.GetPointer());
+      pNode->Initialize(*this, pSkeleton);
     }
   }
 
   m_pCurrentModelTransforms = nullptr;
+  m_GeneratedPose.Clear();
 
-  m_pPoseGenerator->Reset(pSkeleton.GetPointer());
+  m_pPoseGenerator->Reset(pSkeleton);
 
   // reset all pin states
   {
@@ -62,10 +87,7 @@ void ezAnimGraph::Update(ezTime tDiff, ezGameObject* pTarget)
     {
       pin = 0xFFFF;
     }
-    for (auto& pins : m_LocalPoseInputPinStates)
-    {
-      pins.Clear();
-    }
+    ezMemoryUtils::ZeroFill(m_LocalPoseInputPinStates.GetData(), m_LocalPoseInputPinStates.GetCount());
     for (auto& pin : m_ModelPoseInputPinStates)
     {
       pin = 0xFFFF;
@@ -74,17 +96,49 @@ void ezAnimGraph::Update(ezTime tDiff, ezGameObject* pTarget)
 
   for (const auto& pNode : m_Nodes)
   {
-    pNode->Step(*this, tDiff, pSkeleton.GetPointer(), pTarget);
+    pNode->Step(*this, tDiff, pSkeleton, pTarget);
   }
 
-  if (auto newPose = GetPoseGenerator().GeneratePose(pTarget); !newPose.IsEmpty())
-  {
-    ezMsgAnimationPoseUpdated msg;
-    msg.m_pRootTransform = &pSkeleton->GetDescriptor().m_RootTransform;
-    msg.m_pSkeleton = &pSkeleton->GetDescriptor().m_Skeleton;
-    msg.m_ModelTransforms = newPose;
+  return true;
+}
 
-    pTarget->SendMessageRecursive(msg);
+void ezAnimGraph::GeneratePose(const ezGameObject* pTarget)
+{
+  m_GeneratedPose = GetPoseGenerator().GeneratePose(pTarget);
+}
+
+void ezAnimGraph::GeneratePoseAsync()
+{
+  EZ_ASSERT_DEBUG(m_pAcquiredSkeleton != nullptr, "UpdateNodes() must succeed before the pose can be generated.");
+
+  m_GeneratedPose = GetPoseGenerator().GeneratePoseAsync();
+}
+
+void ezAnimGraph::SendPoseUpdate(ezGameObject* pTarget)
+{
+  EZ_SCOPE_EXIT(ReleaseSkeleton());
+
+  GetPoseGenerator().SendQueuedEvents(pTarget);
+
+  if (m_GeneratedPose.IsEmpty())
+    return;
+
+  const ezSkeletonResource* pSkeleton = GetPoseGenerator().GetSkeleton();
+
+  ezMsgAnimationPoseUpdated msg;
+  msg.m_pRootTransform = &pSkeleton->GetDescriptor().m_RootTransform;
+  msg.m_pSkeleton = &pSkeleton->GetDescriptor().m_Skeleton;
+  msg.m_ModelTransforms = m_GeneratedPose;
+
+  pTarget->SendMessageRecursive(msg);
+}
+
+void ezAnimGraph::ReleaseSkeleton()
+{
+  if (m_pAcquiredSkeleton != nullptr)
+  {
+    ezResourceManager::EndAcquireResource(m_pAcquiredSkeleton);
+    m_pAcquiredSkeleton = nullptr;
   }
 }
 
@@ -250,9 +304,40 @@ ezResult ezAnimGraph::Deserialize(ezStreamReader& stream)
   }
   // EXTEND THIS if a new type is introduced
 
+  PrepareInputPinSlots();
+
   return EZ_SUCCESS;
 }
 
+void ezAnimGraph::PrepareInputPinSlots()
+{
+  const ezUInt32 uiNumInputPins = m_LocalPoseInputPinStates.GetCount();
+
+  // every output pin that is connected to an input pin can pass at most one pose to it per frame
+  ezHybridArray<ezUInt16, 16> numConnections;
+  numConnections.SetCount(uiNumInputPins);
+
+  for (const auto& inputPins : m_OutputPinToInputPinMapping[ezAnimGraphPin::LocalPose])
+  {
+    for (ezUInt16 idx : inputPins)
+    {
+      ++numConnections[idx];
+    }
+  }
+
+  m_LocalPoseInputPinSlotOffsets.SetCountUninitialized(uiNumInputPins + 1);
+
+  ezUInt16 uiNumSlots = 0;
+  for (ezUInt32 i = 0; i < uiNumInputPins; ++i)
+  {
+    m_LocalPoseInputPinSlotOffsets[i] = uiNumSlots;
+    uiNumSlots += numConnections[i];
+  }
+
+  m_LocalPoseInputPinSlotOffsets[uiNumInputPins] = uiNumSlots;
+  m_LocalPoseInputPinSlots.SetCount(uiNumSlots);
+}
+
 ezAnimGraphPinDataBoneWeights* ezAnimGraph::AddPinDataBoneWeights()
 {
   ezAnimGraphPinDataBoneWeights* pData = &m_PinDataBoneWeights.ExpandAndGetRef();
@@ -161,10 +161,10 @@ ezAnimGraphPinDataLocalTransforms* ezAnimGraphLocalPoseInputPin::GetPose(ezAnimG
   if (m_iPinIndex < 0)
     return nullptr;
 
-  if (graph.m_LocalPoseInputPinStates[m_iPinIndex].IsEmpty())
+  if (graph.m_LocalPoseInputPinStates[m_iPinIndex] == 0)
     return nullptr;
 
-  return &graph.m_PinDataLocalTransforms[graph.m_LocalPoseInputPinStates[m_iPinIndex][0]];
+  return &graph.m_PinDataLocalTransforms[graph.m_LocalPoseInputPinSlots[graph.m_LocalPoseInputPinSlotOffsets[m_iPinIndex]]];
 }
 
 void ezAnimGraphLocalPoseMultiInputPin::GetPoses(ezAnimGraph& graph, ezDynamicArray<ezAnimGraphPinDataLocalTransforms*>& out_Poses) const
@@ -174,10 +174,12 @@ void ezAnimGraphLocalPoseMultiInputPin::GetPoses(ezAnimGraph& graph, ezDynamicAr
   if (m_iPinIndex < 0)
     return;
 
-  out_Poses.SetCountUninitialized(graph.m_LocalPoseInputPinStates[m_iPinIndex].GetCount());
-  for (ezUInt32 i = 0; i < graph.m_LocalPoseInputPinStates[m_iPinIndex].GetCount(); ++i)
+  const ezUInt32 uiFirstSlot = graph.m_LocalPoseInputPinSlotOffsets[m_iPinIndex];
+
+  out_Poses.SetCountUninitialized(graph.m_LocalPoseInputPinStates[m_iPinIndex]);
+  for (ezUInt32 i = 0; i < out_Poses.GetCount(); ++i)
   {
-    out_Poses[i] = &graph.m_PinDataLocalTransforms[graph.m_LocalPoseInputPinStates[m_iPinIndex][i]];
+    out_Poses[i] = &graph.m_PinDataLocalTransforms[graph.m_LocalPoseInputPinSlots[uiFirstSlot + i]];
   }
 }
 
@@ -191,7 +193,16 @@ void ezAnimGraphLocalPoseOutputPin::SetPose(ezAnimGraph& graph, ezAnimGraphPinDa
   // set all input pins that are connected to this output pin
   for (ezUInt16 idx : map)
   {
-    graph.m_LocalPoseInputPinStates[idx].PushBack(pPose->m_uiOwnIndex);
+    const ezUInt32 uiSlot = graph.m_LocalPoseInputPinSlotOffsets[idx] + graph.m_LocalPoseInputPinStates[idx];
+
+    if (uiSlot >= graph.m_LocalPoseInputPinSlotOffsets[idx + 1])
+    {
+      EZ_REPORT_FAILURE("More poses were passed to an input pin than it has connections. SetPose() must only be called once per frame.");
+      continue;
+    }
+
+    graph.m_LocalPoseInputPinSlots[uiSlot] = pPose->m_uiOwnIndex;
+    ++graph.m_LocalPoseInputPinStates[idx];
   }
 }
 
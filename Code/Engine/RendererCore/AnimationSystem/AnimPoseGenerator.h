@@ -2,6 +2,7 @@
 
 #include <Core/ResourceManager/ResourceHandle.h>
 #include <Foundation/Containers/ArrayMap.h>
+#include <Foundation/Strings/HashedString.h>
 #include <Foundation/Types/UniquePtr.h>
 #include <RendererCore/RendererCoreDLL.h>
 
@@ -174,18 +175,33 @@ public:
   const ezAnimPoseGeneratorCommand& GetCommand(ezAnimPoseGeneratorCommandID id) const;
   ezAnimPoseGeneratorCommand& GetCommand(ezAnimPoseGeneratorCommandID id);
 
+  /// \brief Executes all commands and sends the sampled animation events to \a pSendAnimationEventsTo right away.
   ezArrayPtr<ezMat4> GeneratePose(const ezGameObject* pSendAnimationEventsTo);
 
+  /// \brief Whether GeneratePoseAsync() may be used, i.e. no command needs to send a message to a game object while it is executed.
+  bool CanGeneratePoseAsync() const;
+
+  /// \brief Executes all commands without touching any game object, so that multiple pose generators can be run in parallel.
+  ///
+  /// Sampled animation events are queued and have to be sent afterwards on the main thread through SendQueuedEvents().
+  ezArrayPtr<ezMat4> GeneratePoseAsync();
+
+  /// \brief Sends the animation events that were sampled by the last call to GeneratePoseAsync().
+  void SendQueuedEvents(const ezGameObject* pSendAnimationEventsTo);
+
+  const ezSkeletonResource* GetSkeleton() const { return m_pSkeleton; }
+
 private:
   void Validate() const;
+  void PrepareLocalPoseArena();
 
-  void Execute(ezAnimPoseGeneratorCommand& cmd, const ezGameObject* pSendAnimationEventsTo);
-  void ExecuteCmd(ezAnimPoseGeneratorCommandSampleTrack& cmd, const ezGameObject* pSendAnimationEventsTo);
+  void Execute(ezAnimPoseGeneratorCommand& cmd);
+  void ExecuteCmd(ezAnimPoseGeneratorCommandSampleTrack& cmd);
   void ExecuteCmd(ezAnimPoseGeneratorCommandCombinePoses& cmd);
   void ExecuteCmd(ezAnimPoseGeneratorCommandLocalToModelPose& cmd);
   void ExecuteCmd(ezAnimPoseGeneratorCommandModelPoseToOutput& cmd);
-  void ExecuteCmd(ezAnimPoseGeneratorCommandSampleEventTrack& cmd, const ezGameObject* pSendAnimationEventsTo);
-  void SampleEventTrack(const ezAnimationClipResource* pResource, ezAnimPoseEventTrackSampleMode mode, const ezGameObject* pSendAnimationEventsTo, float fPrevPos, float fCurPos);
+  void ExecuteCmd(ezAnimPoseGeneratorCommandSampleEventTrack& cmd);
+  void SampleEventTrack(const ezAnimationClipResource* pResource, ezAnimPoseEventTrackSampleMode mode, float fPrevPos, float fCurPos);
 
   ezArrayPtr<ozz::math::SoaTransform> AcquireLocalPoseTransforms(ezAnimPoseGeneratorLocalPoseID id);
   ezArrayPtr<ezMat4> AcquireModelPoseTransforms(ezAnimPoseGeneratorModelPoseID id);
@@ -196,8 +212,11 @@ private:
   ezAnimPoseGeneratorModelPoseID m_ModelPoseCounter = 0;
 
   ezArrayPtr<ezMat4> m_OutputPose;
+  ezHybridArray<ezHashedString, 4> m_QueuedEvents;
 
-  ezHybridArray<ezArrayPtr<ozz::math::SoaTransform>, 8> m_UsedLocalTransforms;
+  // all local poses of one update, the memory is reused across frames, so generating a pose doesn't allocate
+  ezDynamicArray<ozz::math::SoaTransform, ezAlignedAllocatorWrapper> m_LocalPoseArena;
+  ezUInt32 m_uiNumSoaJoints = 0;
   ezHybridArray<ezDynamicArray<ezMat4, ezAlignedAllocatorWrapper>, 2> m_UsedModelTransforms;
 
   ezHybridArray<ezAnimPoseGeneratorCommandSampleTrack, 4> m_CommandsSampleTrack;
@@ -27,5 +27,18 @@ public:
 
   void MapModelSpacePoseToSkinningSpace(const ezHashTable<ezHashedString, ezMeshResourceDescriptor::BoneData>& bones, const ezSkeleton& skeleton, ezArrayPtr<const ezMat4> modelSpaceTransforms, ezBoundingBox* bounds);
 
+  /// \brief Forces all poses to rebuild their cached bone to joint mapping the next time they are mapped.
+  ///
+  /// Called by the mesh and skeleton resources whenever their content gets updated or unloaded,
+  /// since the bone table and the skeleton may then change without changing their address.
+  static void InvalidateBoneMappings();
+
   ezDynamicArray<ezShaderTransform, ezAlignedAllocatorWrapper> m_Transforms;
+
+private:
+  // joint index for every bone, in the iteration order of the bone table, so that joints don't have to be looked up by name every frame
+  const void* m_pMappedBones = nullptr;
+  const ezSkeleton* m_pMappedSkeleton = nullptr;
+  ezUInt32 m_uiMappedGeneration = 0;
+  ezDynamicArray<ezUInt16> m_BoneToJointIndex;
 };
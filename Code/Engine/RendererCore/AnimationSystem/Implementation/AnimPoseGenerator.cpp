@@ -24,11 +24,11 @@ void ezAnimPoseGenerator::Reset(const ezSkeletonResource* pSkeleton)
   m_CommandsLocalToModelPose.Clear();
   m_CommandsModelPoseToOutput.Clear();
 
-  m_UsedLocalTransforms.Clear();
-
   m_OutputPose.Clear();
+  m_QueuedEvents.Clear();
 
   // don't clear these arrays, they are reused
+  //m_LocalPoseArena.Clear();
   //m_UsedModelTransforms.Clear();
   //m_SamplingCaches.Clear();
 }
@@ -197,12 +197,15 @@ ezAnimPoseGeneratorCommand& ezAnimPoseGenerator::GetCommand(ezAnimPoseGeneratorC
 ezArrayPtr<ezMat4> ezAnimPoseGenerator::GeneratePose(const ezGameObject* pSendAnimationEventsTo /*= nullptr*/)
 {
   Validate();
+  PrepareLocalPoseArena();
 
   for (auto& cmd : m_CommandsModelPoseToOutput)
   {
-    Execute(cmd, pSendAnimationEventsTo);
+    Execute(cmd);
   }
 
+  SendQueuedEvents(pSendAnimationEventsTo);
+
   auto pPose = m_OutputPose;
 
   // TODO: clear temp data
@@ -210,7 +213,50 @@ ezArrayPtr<ezMat4> ezAnimPoseGenerator::GeneratePose(const ezGameObject* pSendAn
   return pPose;
 }
 
-void ezAnimPoseGenerator::Execute(ezAnimPoseGeneratorCommand& cmd, const ezGameObject* pSendAnimationEventsTo)
+bool ezAnimPoseGenerator::CanGeneratePoseAsync() const
+{
+  for (const auto& cmd : m_CommandsLocalToModelPose)
+  {
+    if (cmd.m_pSendLocalPoseMsgTo != nullptr)
+      return false;
+  }
+
+  return true;
+}
+
+ezArrayPtr<ezMat4> ezAnimPoseGenerator::GeneratePoseAsync()
+{
+  EZ_ASSERT_DEBUG(CanGeneratePoseAsync(), "Pose generation needs to send messages and can't run asynchronously.");
+
+  Validate();
+  PrepareLocalPoseArena();
+
+  for (auto& cmd : m_CommandsModelPoseToOutput)
+  {
+    Execute(cmd);
+  }
+
+  return m_OutputPose;
+}
+
+void ezAnimPoseGenerator::SendQueuedEvents(const ezGameObject* pSendAnimationEventsTo)
+{
+  if (pSendAnimationEventsTo != nullptr)
+  {
+    ezMsgGenericEvent msg;
+
+    for (const auto& hs : m_QueuedEvents)
+    {
+      msg.m_sMessage = hs;
+
+      pSendAnimationEventsTo->SendEventMessage(msg, nullptr);
+    }
+  }
+
+  m_QueuedEvents.Clear();
+}
+
+void ezAnimPoseGenerator::Execute(ezAnimPoseGeneratorCommand& cmd)
 {
   if (cmd.m_bExecuted)
     return;
@@ -220,7 +266,7 @@ void ezAnimPoseGenerator::Execute(ezAnimPoseGeneratorCommand& cmd, const ezGameO
 
   for (auto id : cmd.m_Inputs)
   {
-    Execute(GetCommand(id), pSendAnimationEventsTo);
+    Execute(GetCommand(id));
   }
 
   // TODO: build a task graph and execute multi-threaded
@@ -228,7 +274,7 @@ void ezAnimPoseGenerator::Execute(ezAnimPoseGeneratorCommand& cmd, const ezGameO
   switch (cmd.GetType())
   {
     case ezAnimPoseGeneratorCommandType::SampleTrack:
-      ExecuteCmd(static_cast<ezAnimPoseGeneratorCommandSampleTrack&>(cmd), pSendAnimationEventsTo);
+      ExecuteCmd(static_cast<ezAnimPoseGeneratorCommandSampleTrack&>(cmd));
       break;
 
     case ezAnimPoseGeneratorCommandType::CombinePoses:
@@ -244,14 +290,14 @@ void ezAnimPoseGenerator::Execute(ezAnimPoseGeneratorCommand& cmd, const ezGameO
       break;
 
     case ezAnimPoseGeneratorCommandType::SampleEventTrack:
-      ExecuteCmd(static_cast<ezAnimPoseGeneratorCommandSampleEventTrack&>(cmd), pSendAnimationEventsTo);
+      ExecuteCmd(static_cast<ezAnimPoseGeneratorCommandSampleEventTrack&>(cmd));
       break;
 
       EZ_DEFAULT_CASE_NOT_IMPLEMENTED;
   }
 }
 
-void ezAnimPoseGenerator::ExecuteCmd(ezAnimPoseGeneratorCommandSampleTrack& cmd, const ezGameObject* pSendAnimationEventsTo)
+void ezAnimPoseGenerator::ExecuteCmd(ezAnimPoseGeneratorCommandSampleTrack& cmd)
 {
   ezResourceLock<ezAnimationClipResource> pResource(cmd.m_hAnimationClip, ezResourceAcquireMode::BlockTillLoaded);
 
@@ -285,7 +331,7 @@ void ezAnimPoseGenerator::ExecuteCmd(ezAnimPoseGeneratorCommandSampleTrack& cmd,
   EZ_ASSERT_DEBUG(job.Validate(), "");
   job.Run();
 
-  SampleEventTrack(pResource.GetPointer(), cmd.m_EventSampling, pSendAnimationEventsTo, cmd.m_fPreviousNormalizedSamplePos, cmd.m_fNormalizedSamplePos);
+  SampleEventTrack(pResource.GetPointer(), cmd.m_EventSampling, cmd.m_fPreviousNormalizedSamplePos, cmd.m_fNormalizedSamplePos);
 }
 
 void ezAnimPoseGenerator::ExecuteCmd(ezAnimPoseGeneratorCommandCombinePoses& cmd)
@@ -408,14 +454,14 @@ void ezAnimPoseGenerator::ExecuteCmd(ezAnimPoseGeneratorCommandModelPoseToOutput
   }
 }
 
-void ezAnimPoseGenerator::ExecuteCmd(ezAnimPoseGeneratorCommandSampleEventTrack& cmd, const ezGameObject* pSendAnimationEventsTo)
+void ezAnimPoseGenerator::ExecuteCmd(ezAnimPoseGeneratorCommandSampleEventTrack& cmd)
 {
   ezResourceLock<ezAnimationClipResource> pResource(cmd.m_hAnimationClip, ezResourceAcquireMode::BlockTillLoaded);
 
-  SampleEventTrack(pResource.GetPointer(), cmd.m_EventSampling, pSendAnimationEventsTo, cmd.m_fPreviousNormalizedSamplePos, cmd.m_fNormalizedSamplePos);
+  SampleEventTrack(pResource.GetPointer(), cmd.m_EventSampling, cmd.m_fPreviousNormalizedSamplePos, cmd.m_fNormalizedSamplePos);
 }
 
-void ezAnimPoseGenerator::SampleEventTrack(const ezAnimationClipResource* pResource, ezAnimPoseEventTrackSampleMode mode, const ezGameObject* pSendAnimationEventsTo, float fPrevPos, float fCurPos)
+void ezAnimPoseGenerator::SampleEventTrack(const ezAnimationClipResource* pResource, ezAnimPoseEventTrackSampleMode mode, float fPrevPos, float fCurPos)
 {
   const auto& et = pResource->GetDescriptor().m_EventTrack;
 
@@ -429,7 +475,7 @@ void ezAnimPoseGenerator::SampleEventTrack(const ezAnimationClipResource* pResou
   const ezTime tStart = ezTime::Zero();
   const ezTime tEnd = duration + ezTime::Seconds(1.0); // sampling position is EXCLUSIVE
 
-  ezHybridArray<ezHashedString, 16> events;
+  auto& events = m_QueuedEvents;
 
   switch (mode)
   {
@@ -459,29 +505,20 @@ void ezAnimPoseGenerator::SampleEventTrack(const ezAnimationClipResource* pResou
 
       EZ_DEFAULT_CASE_NOT_IMPLEMENTED;
   }
+}
 
-  ezMsgGenericEvent msg;
-
-  for (const auto& hs : events)
-  {
-    msg.m_sMessage = hs;
-
-    pSendAnimationEventsTo->SendEventMessage(msg, nullptr);
-  }
+void ezAnimPoseGenerator::PrepareLocalPoseArena()
+{
+  // the number of local poses is known once all commands are allocated, so the arena never needs to grow during execution
+  m_uiNumSoaJoints = m_pSkeleton->GetDescriptor().m_Skeleton.GetOzzSkeleton().num_soa_joints();
+  m_LocalPoseArena.SetCountUninitialized(m_LocalPoseCounter * m_uiNumSoaJoints);
 }
 
 ezArrayPtr<ozz::math::SoaTransform> ezAnimPoseGenerator::AcquireLocalPoseTransforms(ezAnimPoseGeneratorLocalPoseID id)
 {
-  m_UsedLocalTransforms.EnsureCount(id + 1);
-
-  if (m_UsedLocalTransforms[id].IsEmpty())
-  {
-    using T = ozz::math::SoaTransform;
-    const ezUInt32 num = m_pSkeleton->GetDescriptor().m_Skeleton.GetOzzSkeleton().num_soa_joints();
-    m_UsedLocalTransforms[id] = EZ_NEW_ARRAY(ezFrameAllocator::GetCurrentAllocator(), T, num);
-  }
+  EZ_ASSERT_DEBUG(id < m_LocalPoseCounter, "Invalid local pose ID");
 
-  return m_UsedLocalTransforms[id];
+  return m_LocalPoseArena.GetArrayPtr().GetSubArray(id * m_uiNumSoaJoints, m_uiNumSoaJoints);
 }
 
 ezArrayPtr<ezMat4> ezAnimPoseGenerator::AcquireModelPoseTransforms(ezAnimPoseGeneratorModelPoseID id)
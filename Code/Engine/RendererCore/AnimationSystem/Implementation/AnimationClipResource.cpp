@@ -103,6 +103,7 @@ struct ezAnimationClipResourceDescriptor::OzzImpl
     ozz::unique_ptr<ozz::animation::Animation> m_pAnim;
   };
 
+  ezMutex m_MappedOzzAnimationsMutex; // poses of different instances may be generated in parallel
   ezMap<const ezSkeletonResource*, CachedAnim> m_MappedOzzAnimations;
 };
 
@@ -258,6 +259,8 @@ EZ_FORCE_INLINE void ez2ozz(const ezQuat& in, ozz::math::Quaternion& out)
 
 const ozz::animation::Animation& ezAnimationClipResourceDescriptor::GetMappedOzzAnimation(const ezSkeletonResource& skeleton) const
 {
+  EZ_LOCK(m_OzzImpl->m_MappedOzzAnimationsMutex);
+
   auto it = m_OzzImpl->m_MappedOzzAnimations.Find(&skeleton);
   if (it.IsValid())
   {
@@ -1,5 +1,7 @@
 #include <RendererCore/RendererCorePCH.h>
 
+#include <Foundation/SimdMath/SimdConversion.h>
+#include <Foundation/Threading/AtomicInteger.h>
 #include <RendererCore/AnimationSystem/AnimationPose.h>
 #include <RendererCore/AnimationSystem/Skeleton.h>
 #include <RendererCore/Shader/Types.h>
@@ -70,6 +72,8 @@ void ezMsgAnimationPoseUpdated::ComputeFullBoneTransform(ezUInt32 uiJointIndex,
   ComputeFullBoneTransform(m_pRootTransform->GetAsMat4(), m_ModelTransforms[uiJointIndex], fullTransform, rotationOnly);
 }
 
+static ezAtomicInteger32 s_iBoneMappingGeneration = 1;
+
 ezSkinningSpaceAnimationPose::ezSkinningSpaceAnimationPose() = default;
 ezSkinningSpaceAnimationPose::~ezSkinningSpaceAnimationPose() = default;
 
@@ -84,34 +88,50 @@ void ezSkinningSpaceAnimationPose::Configure(ezUInt32 uiNumTransforms)
   m_Transforms.SetCountUninitialized(uiNumTransforms);
 }
 
+void ezSkinningSpaceAnimationPose::InvalidateBoneMappings()
+{
+  s_iBoneMappingGeneration.Increment();
+}
+
 void ezSkinningSpaceAnimationPose::MapModelSpacePoseToSkinningSpace(const ezHashTable<ezHashedString, ezMeshResourceDescriptor::BoneData>& bones, const ezSkeleton& skeleton, ezArrayPtr<const ezMat4> modelSpaceTransforms, ezBoundingBox* bounds)
 {
   Configure(bones.GetCount());
 
-  if (bounds)
+  const ezUInt32 uiGeneration = static_cast<ezUInt32>(static_cast<ezInt32>(s_iBoneMappingGeneration));
+
+  if (m_pMappedBones != &bones || m_pMappedSkeleton != &skeleton || m_uiMappedGeneration != uiGeneration || m_BoneToJointIndex.GetCount() != bones.GetCount())
   {
-    for (auto itBone : bones)
-    {
-      const ezUInt16 uiJointIdx = skeleton.FindJointByName(itBone.Key());
+    m_pMappedBones = &bones;
+    m_pMappedSkeleton = &skeleton;
+    m_uiMappedGeneration = uiGeneration;
 
-      if (uiJointIdx == ezInvalidJointIndex)
-        continue;
+    m_BoneToJointIndex.Clear();
+    m_BoneToJointIndex.Reserve(bones.GetCount());
 
-      bounds->ExpandToInclude(modelSpaceTransforms[uiJointIdx].GetTranslationVector());
-      m_Transforms[itBone.Value().m_uiBoneIndex] = modelSpaceTransforms[uiJointIdx] * itBone.Value().m_GlobalInverseBindPoseMatrix;
+    for (auto itBone : bones)
+    {
+      m_BoneToJointIndex.PushBack(skeleton.FindJointByName(itBone.Key()));
     }
   }
-  else
+
+  const ezUInt32 uiNumJoints = modelSpaceTransforms.GetCount();
+  ezUInt32 uiBone = 0;
+
+  for (auto itBone : bones)
   {
-    for (auto itBone : bones)
-    {
-      const ezUInt16 uiJointIdx = skeleton.FindJointByName(itBone.Key());
+    const ezUInt16 uiJointIdx = m_BoneToJointIndex[uiBone++];
+
+    if (uiJointIdx == ezInvalidJointIndex || uiJointIdx >= uiNumJoints)
+      continue;
 
-      if (uiJointIdx == ezInvalidJointIndex)
-        continue;
+    const ezMat4& modelTransform = modelSpaceTransforms[uiJointIdx];
 
-      m_Transforms[itBone.Value().m_uiBoneIndex] = modelSpaceTransforms[uiJointIdx] * itBone.Value().m_GlobalInverseBindPoseMatrix;
+    if (bounds)
+    {
+      bounds->ExpandToInclude(modelTransform.GetTranslationVector());
     }
+
+    m_Transforms[itBone.Value().m_uiBoneIndex] = ezSimdConversion::ToMat4(modelTransform) * ezSimdConversion::ToMat4(itBone.Value().m_GlobalInverseBindPoseMatrix);
   }
 }
 
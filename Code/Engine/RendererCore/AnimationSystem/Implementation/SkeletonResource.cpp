@@ -1,6 +1,7 @@
 #include <RendererCore/RendererCorePCH.h>
 
 #include <Core/Assets/AssetFileHeader.h>
+#include <RendererCore/AnimationSystem/AnimationPose.h>
 #include <RendererCore/AnimationSystem/Implementation/OzzUtils.h>
 #include <RendererCore/AnimationSystem/SkeletonResource.h>
 #include <ozz/animation/runtime/skeleton.h>
@@ -24,6 +25,7 @@ EZ_RESOURCE_IMPLEMENT_CREATEABLE(ezSkeletonResource, ezSkeletonResourceDescripto
 {
   m_pDescriptor = EZ_DEFAULT_NEW(ezSkeletonResourceDescriptor);
   *m_pDescriptor = std::move(descriptor);
+  ezSkinningSpaceAnimationPose::InvalidateBoneMappings();
 
   ezResourceLoadDesc res;
   res.m_uiQualityLevelsDiscardable = 0;
@@ -36,6 +38,7 @@ EZ_RESOURCE_IMPLEMENT_CREATEABLE(ezSkeletonResource, ezSkeletonResourceDescripto
 ezResourceLoadDesc ezSkeletonResource::UnloadData(Unload WhatToUnload)
 {
   m_pDescriptor.Clear();
+  ezSkinningSpaceAnimationPose::InvalidateBoneMappings();
 
   ezResourceLoadDesc res;
   res.m_uiQualityLevelsDiscardable = 0;
@@ -71,6 +74,7 @@ ezResourceLoadDesc ezSkeletonResource::UpdateContent(ezStreamReader* Stream)
 
   m_pDescriptor = EZ_DEFAULT_NEW(ezSkeletonResourceDescriptor);
   m_pDescriptor->Deserialize(*Stream).IgnoreResult();
+  ezSkinningSpaceAnimationPose::InvalidateBoneMappings();
 
   res.m_State = ezResourceState::Loaded;
   return res;
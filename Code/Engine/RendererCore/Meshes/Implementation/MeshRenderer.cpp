@@ -1,5 +1,6 @@
 #include <RendererCore/RendererCorePCH.h>
 
+#include <Core/Graphics/Camera.h>
 #include <RendererCore/Debug/DebugRenderer.h>
 #include <RendererCore/Meshes/Implementation/MeshRendererUtils.h>
 #include <RendererCore/Meshes/InstancedMeshComponent.h>
@@ -7,13 +8,58 @@
 #include <RendererCore/Pipeline/InstanceDataProvider.h>
 #include <RendererCore/Pipeline/RenderPipeline.h>
 #include <RendererCore/Pipeline/RenderPipelinePass.h>
+#include <RendererCore/Pipeline/ViewData.h>
 #include <RendererCore/RenderContext/RenderContext.h>
+#include <RendererCore/Textures/TextureStreaming.h>
 
 // clang-format off
 EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(ezMeshRenderer, 1, ezRTTIDefaultAllocator<ezMeshRenderer>)
 EZ_END_DYNAMIC_REFLECTED_TYPE;
 // clang-format on
 
+namespace
+{
+  /// Returns roughly how many pixels the largest object of the batch covers on screen, which is the resolution its textures should have.
+  float ComputeTextureStreamingScreenSize(const ezRenderViewContext& renderViewContext, const ezRenderDataBatch& batch)
+  {
+    const ezCamera& camera = *renderViewContext.m_pCamera;
+    const ezRectFloat& viewport = renderViewContext.m_pViewData->m_ViewPortRect;
+
+    if (viewport.height <= 0.0f)
+      return 0.0f;
+
+    // objects that intersect the camera or have no bounds get the full resolution
+    const float fFullResolution = 65536.0f;
+
+    const float fAspectRatio = viewport.width / viewport.height;
+    const float fTanHalfFovY = ezMath::Tan(camera.GetFovY(fAspectRatio) * 0.5f);
+    const float fOrthoHalfHeight = camera.GetDimensionY(fAspectRatio) * 0.5f;
+
+    float fMaxScreenSize = 0.0f;
+
+    for (auto it = batch.GetIterator<ezRenderData>(); it.IsValid(); ++it)
+    {
+      const ezBoundingBoxSphere& bounds = it->m_GlobalBounds;
+      if (!bounds.IsValid())
+        return fFullResolution;
+
+      float fHalfHeight = fOrthoHalfHeight;
+      if (camera.IsPerspective())
+      {
+        const float fDistance = (bounds.m_vCenter - camera.GetPosition()).GetLength() - bounds.m_fSphereRadius;
+        if (fDistance <= 0.0f)
+          return fFullResolution;
+
+        fHalfHeight = fTanHalfFovY * fDistance;
+      }
+
+      fMaxScreenSize = ezMath::Max(fMaxScreenSize, bounds.m_fSphereRadius / fHalfHeight * viewport.height);
+    }
+
+    return ezMath::Min(fMaxScreenSize, fFullResolution);
+  }
+} // namespace
+
 ezMeshRenderer::ezMeshRenderer() = default;
 ezMeshRenderer::~ezMeshRenderer() = default;
 
@@ -59,8 +105,16 @@ void ezMeshRenderer::RenderBatch(const ezRenderViewContext& renderViewContext, c
   }
 
   ezInstanceData* pInstanceData = bHasExplicitInstanceData ? static_cast<const ezInstancedMeshRenderData*>(pRenderData)->m_pExplicitInstanceData : pPass->GetPipeline()->GetFrameDataProvider<ezInstanceDataProvider>()->GetData(renderViewContext);
+  const bool bUsePersistentInstanceData = !bHasExplicitInstanceData && CanUsePersistentInstanceData(batch);
 
-  pInstanceData->BindResources(pContext);
+  if (bUsePersistentInstanceData)
+  {
+    pInstanceData->BindPersistentResources(pContext);
+  }
+  else
+  {
+    pInstanceData->BindResources(pContext);
+  }
 
   if (pRenderData->m_uiFlipWinding)
   {
@@ -74,9 +128,62 @@ void ezMeshRenderer::RenderBatch(const ezRenderViewContext& renderViewContext, c
   pContext->BindMaterial(hMaterial);
   pContext->BindMeshBuffer(pMesh->GetMeshBuffer());
 
+  if (ezTextureStreaming::IsEnabled())
+  {
+    pContext->SetTextureStreamingScreenSize(ComputeTextureStreamingScreenSize(renderViewContext, batch));
+  }
+
   SetAdditionalData(renderViewContext, pRenderData);
 
-  if (!bHasExplicitInstanceData)
+  if (bUsePersistentInstanceData)
+  {
+    ezUInt32 uiStartIndex = 0;
+    while (uiStartIndex < batch.GetCount())
+    {
+      const ezUInt32 uiRemainingInstances = batch.GetCount() - uiStartIndex;
+
+      ezUInt32 uiInstanceIndexOffset = 0;
+      ezArrayPtr<ezUInt32> instanceIndices = pInstanceData->GetInstanceIndices(uiRemainingInstances, uiInstanceIndexOffset);
+
+      ezUInt32 uiFilteredCount = 0;
+      for (auto it = batch.GetIterator<ezMeshRenderData>(uiStartIndex, instanceIndices.GetCount()); it.IsValid(); ++it)
+      {
+        const ezMeshRenderData* pCachedRenderData = it;
+        instanceIndices[uiFilteredCount] = ezPersistentInstanceData::GetOrAllocateSlot(pCachedRenderData, [&](ezPerInstanceData& instanceData) { FillPersistentInstanceData(instanceData, pCachedRenderData); });
+
+        ++uiFilteredCount;
+      }
+
+      if (uiFilteredCount > 0) // Instance data might be empty if all render data was filtered.
+      {
+        ezPersistentInstanceData::UploadDirtySlots(pContext);
+        pInstanceData->UpdateInstanceIndices(pContext, uiFilteredCount);
+
+        const ezMeshResourceDescriptor::SubMesh& meshPart = subMeshes[uiPartIndex];
+
+        unsigned int uiRenderedInstances = uiFilteredCount;
+        if (renderViewContext.m_pCamera->IsStereoscopic())
+          uiRenderedInstances *= 2;
+
+        if (pContext->DrawMeshBuffer(meshPart.m_uiPrimitiveCount, meshPart.m_uiFirstPrimitive, uiRenderedInstances).Failed())
+        {
+          for (auto it = batch.GetIterator<ezMeshRenderData>(uiStartIndex, instanceIndices.GetCount()); it.IsValid(); ++it)
+          {
+            pRenderData = it;
+
+            // draw bounding box instead
+            if (pRenderData->m_GlobalBounds.IsValid())
+            {
+              ezDebugRenderer::DrawLineBox(*renderViewContext.m_pViewDebugContext, pRenderData->m_GlobalBounds.GetBox(), ezColor::Magenta);
+            }
+          }
+        }
+      }
+
+      uiStartIndex += instanceIndices.GetCount();
+    }
+  }
+  else if (!bHasExplicitInstanceData)
   {
     ezUInt32 uiStartIndex = 0;
     while (uiStartIndex < batch.GetCount())
@@ -128,6 +235,8 @@ void ezMeshRenderer::RenderBatch(const ezRenderViewContext& renderViewContext, c
 
     pContext->DrawMeshBuffer(meshPart.m_uiPrimitiveCount, meshPart.m_uiFirstPrimitive, uiInstanceCount).IgnoreResult();
   }
+
+  pContext->SetTextureStreamingScreenSize(0.0f);
 }
 
 void ezMeshRenderer::SetAdditionalData(const ezRenderViewContext& renderViewContext, const ezMeshRenderData* pRenderData) const
@@ -135,6 +244,27 @@ void ezMeshRenderer::SetAdditionalData(const ezRenderViewContext& renderViewCont
   renderViewContext.m_pRenderContext->SetShaderPermutationVariable("VERTEX_SKINNING", "FALSE");
 }
 
+void ezMeshRenderer::FillPersistentInstanceData(ezPerInstanceData& instanceData, const ezMeshRenderData* pRenderData) const
+{
+  ezInternal::FillPerInstanceData(instanceData, pRenderData);
+}
+
+bool ezMeshRenderer::CanUsePersistentInstanceData(const ezRenderDataBatch& batch) const
+{
+  if (!ezPersistentInstanceData::IsEnabled())
+    return false;
+
+  // Render data that is not cached yet (e.g. while the material is still loading) only lives for this frame,
+  // so the whole batch falls back to the per-frame path in that case.
+  for (auto it = batch.GetIterator<ezMeshRenderData>(); it.IsValid(); ++it)
+  {
+    if (!it->IsCached())
+      return false;
+  }
+
+  return true;
+}
+
 void ezMeshRenderer::FillPerInstanceData(ezArrayPtr<ezPerInstanceData> instanceData, const ezRenderDataBatch& batch, ezUInt32 uiStartIndex, ezUInt32& out_uiFilteredCount) const
 {
   ezUInt32 uiCount = ezMath::Min<ezUInt32>(instanceData.GetCount(), batch.GetCount() - uiStartIndex);
@@ -1,6 +1,7 @@
 #include <RendererCore/RendererCorePCH.h>
 
 #include <Core/Assets/AssetFileHeader.h>
+#include <RendererCore/AnimationSystem/AnimationPose.h>
 #include <RendererCore/Material/MaterialResource.h>
 #include <RendererCore/Meshes/MeshResource.h>
 
@@ -35,6 +36,7 @@ ezResourceLoadDesc ezMeshResource::UnloadData(Unload WhatToUnload)
     m_Materials.Compact();
     m_Bones.Clear();
     m_Bones.Compact();
+    ezSkinningSpaceAnimationPose::InvalidateBoneMappings();
 
     m_hMeshBuffer.Invalidate();
     m_hDefaultSkeleton.Invalidate();
@@ -91,6 +93,7 @@ EZ_RESOURCE_IMPLEMENT_CREATEABLE(ezMeshResource, ezMeshResourceDescriptor)
 
   m_hDefaultSkeleton = descriptor.m_hDefaultSkeleton;
   m_Bones = descriptor.m_Bones;
+  ezSkinningSpaceAnimationPose::InvalidateBoneMappings();
   m_fMaxBoneVertexOffset = descriptor.m_fMaxBoneVertexOffset;
 
   // otherwise create a new mesh buffer from the descriptor
@@ -25,4 +25,12 @@ protected:
   virtual void SetAdditionalData(const ezRenderViewContext& renderViewContext, const ezMeshRenderData* pRenderData) const;
   virtual void FillPerInstanceData(
     ezArrayPtr<ezPerInstanceData> instanceData, const ezRenderDataBatch& batch, ezUInt32 uiStartIndex, ezUInt32& out_uiFilteredCount) const;
+
+  /// \brief Fills the instance data of a single cached render data for the persistent instance data buffer.
+  ///
+  /// This is only called once when the render data gets its slot, so it must not depend on any per-frame state.
+  virtual void FillPersistentInstanceData(ezPerInstanceData& instanceData, const ezMeshRenderData* pRenderData) const;
+
+private:
+  bool CanUsePersistentInstanceData(const ezRenderDataBatch& batch) const;
 };
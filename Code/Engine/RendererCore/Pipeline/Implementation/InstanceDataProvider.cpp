@@ -1,15 +1,52 @@
 #include <RendererCore/RendererCorePCH.h>
 
+#include <Foundation/Configuration/CVar.h>
+#include <Foundation/Configuration/Startup.h>
+#include <Foundation/Utilities/Stats.h>
 #include <RendererCore/Pipeline/ExtractedRenderData.h>
 #include <RendererCore/Pipeline/InstanceDataProvider.h>
 #include <RendererCore/RenderContext/RenderContext.h>
+#include <RendererCore/RenderWorld/RenderWorld.h>
 #include <RendererFoundation/Profiling/Profiling.h>
 
 #include <RendererCore/../../../Data/Base/Shaders/Common/ObjectConstants.h>
 
+ezCVarBool cvar_RenderingPersistentInstanceData("Rendering.PersistentInstanceData", true, ezCVarFlags::Default, "Keeps the instance data of cached render data in a persistent GPU buffer instead of uploading it every frame");
+
+namespace
+{
+  enum
+  {
+    InitialPersistentSlotCount = 16 * 1024,
+    InvalidInstanceIndexOffset = 0xFFFFFFFF
+  };
+}
+
+// clang-format off
+EZ_BEGIN_SUBSYSTEM_DECLARATION(RendererCore, PersistentInstanceData)
+
+  BEGIN_SUBSYSTEM_DEPENDENCIES
+    "Foundation",
+    "Core"
+  END_SUBSYSTEM_DEPENDENCIES
+
+  ON_HIGHLEVELSYSTEMS_STARTUP
+  {
+    ezPersistentInstanceData::OnEngineStartup();
+  }
+
+  ON_HIGHLEVELSYSTEMS_SHUTDOWN
+  {
+    ezPersistentInstanceData::OnEngineShutdown();
+  }
+
+EZ_END_SUBSYSTEM_DECLARATION;
+// clang-format on
+
 ezInstanceData::ezInstanceData(ezUInt32 uiMaxInstanceCount /*= 1024*/)
   : m_uiBufferSize(0)
   , m_uiBufferOffset(0)
+  , m_uiIndexBufferOffset(0)
 {
   CreateBuffer(uiMaxInstanceCount);
 
@@ -21,6 +58,7 @@ ezInstanceData::~ezInstanceData()
   ezGALDevice* pDevice = ezGALDevice::GetDefaultDevice();
 
   pDevice->DestroyBuffer(m_hInstanceDataBuffer);
+  pDevice->DestroyBuffer(m_hInstanceIndexBuffer);
 
   ezRenderContext::DeleteConstantBufferStorage(m_hConstantBuffer);
 }
@@ -30,6 +68,7 @@ void ezInstanceData::BindResources(ezRenderContext* pRenderContext)
   ezGALDevice* pDevice = ezGALDevice::GetDefaultDevice();
 
   pRenderContext->BindBuffer("perInstanceData", pDevice->GetDefaultResourceView(m_hInstanceDataBuffer));
+  pRenderContext->BindBuffer("perInstanceIndices", pDevice->GetDefaultResourceView(m_hInstanceIndexBuffer));
   pRenderContext->BindConstantBuffer("ezObjectConstants", m_hConstantBuffer);
 }
 
@@ -57,17 +96,62 @@ void ezInstanceData::UpdateInstanceData(ezRenderContext* pRenderContext, ezUInt3
 
   pGALCommandEncoder->UpdateBuffer(m_hInstanceDataBuffer, uiDestOffset, pSourceData.ToByteArray(), updateMode);
 
+  ezPersistentInstanceData::s_iFrameTransientBytes.Add(pSourceData.ToByteArray().GetCount());
 
   ezObjectConstants* pConstants = pRenderContext->GetConstantBufferData<ezObjectConstants>(m_hConstantBuffer);
   pConstants->InstanceDataOffset = m_uiBufferOffset;
+  pConstants->InstanceIndexOffset = InvalidInstanceIndexOffset;
 
   m_uiBufferOffset += uiCount;
 }
 
+void ezInstanceData::BindPersistentResources(ezRenderContext* pRenderContext)
+{
+  ezGALDevice* pDevice = ezGALDevice::GetDefaultDevice();
+
+  pRenderContext->BindBuffer("perInstanceData", pDevice->GetDefaultResourceView(ezPersistentInstanceData::GetBuffer()));
+  pRenderContext->BindBuffer("perInstanceIndices", pDevice->GetDefaultResourceView(m_hInstanceIndexBuffer));
+  pRenderContext->BindConstantBuffer("ezObjectConstants", m_hConstantBuffer);
+}
+
+ezArrayPtr<ezUInt32> ezInstanceData::GetInstanceIndices(ezUInt32 uiCount, ezUInt32& out_uiOffset)
+{
+  uiCount = ezMath::Min(uiCount, m_uiBufferSize);
+  if (m_uiIndexBufferOffset + uiCount > m_uiBufferSize)
+  {
+    m_uiIndexBufferOffset = 0;
+  }
+
+  out_uiOffset = m_uiIndexBufferOffset;
+  return m_InstanceIndices.GetArrayPtr().GetSubArray(m_uiIndexBufferOffset, uiCount);
+}
+
+void ezInstanceData::UpdateInstanceIndices(ezRenderContext* pRenderContext, ezUInt32 uiCount)
+{
+  EZ_ASSERT_DEV(m_uiIndexBufferOffset + uiCount <= m_uiBufferSize, "Implementation error");
+
+  ezGALCommandEncoder* pGALCommandEncoder = pRenderContext->GetCommandEncoder();
+
+  ezUInt32 uiDestOffset = m_uiIndexBufferOffset * sizeof(ezUInt32);
+  auto pSourceData = m_InstanceIndices.GetArrayPtr().GetSubArray(m_uiIndexBufferOffset, uiCount);
+  ezGALUpdateMode::Enum updateMode = (m_uiIndexBufferOffset == 0) ? ezGALUpdateMode::Discard : ezGALUpdateMode::NoOverwrite;
+
+  pGALCommandEncoder->UpdateBuffer(m_hInstanceIndexBuffer, uiDestOffset, pSourceData.ToByteArray(), updateMode);
+
+  ezPersistentInstanceData::s_iFrameIndexBytes.Add(pSourceData.ToByteArray().GetCount());
+
+  ezObjectConstants* pConstants = pRenderContext->GetConstantBufferData<ezObjectConstants>(m_hConstantBuffer);
+  pConstants->InstanceDataOffset = 0;
+  pConstants->InstanceIndexOffset = m_uiIndexBufferOffset;
+
+  m_uiIndexBufferOffset += uiCount;
+}
+
 void ezInstanceData::CreateBuffer(ezUInt32 uiSize)
 {
   m_uiBufferSize = uiSize;
   m_perInstanceData.SetCountUninitialized(m_uiBufferSize);
+  m_InstanceIndices.SetCountUninitialized(m_uiBufferSize);
 
   ezGALDevice* pDevice = ezGALDevice::GetDefaultDevice();
 
@@ -80,11 +164,198 @@ void ezInstanceData::CreateBuffer(ezUInt32 uiSize)
   desc.m_ResourceAccess.m_bImmutable = false;
 
   m_hInstanceDataBuffer = pDevice->CreateBuffer(desc);
+
+  desc.m_uiStructSize = sizeof(ezUInt32);
+  desc.m_uiTotalSize = desc.m_uiStructSize * uiSize;
+
+  m_hInstanceIndexBuffer = pDevice->CreateBuffer(desc);
 }
 
 void ezInstanceData::Reset()
 {
   m_uiBufferOffset = 0;
+  m_uiIndexBufferOffset = 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+ezMutex ezPersistentInstanceData::s_Mutex;
+ezGALBufferHandle ezPersistentInstanceData::s_hBuffer;
+ezUInt32 ezPersistentInstanceData::s_uiBufferSlotCount = 0;
+ezDynamicArray<ezPerInstanceData, ezAlignedAllocatorWrapper> ezPersistentInstanceData::s_SlotData;
+ezDynamicArray<ezUInt32> ezPersistentInstanceData::s_FreeSlots;
+ezDynamicArray<ezUInt32> ezPersistentInstanceData::s_DirtySlots;
+ezPersistentInstanceData::Statistics ezPersistentInstanceData::s_LastFrameStatistics;
+ezAtomicInteger32 ezPersistentInstanceData::s_iFrameTransientBytes;
+ezAtomicInteger32 ezPersistentInstanceData::s_iFramePersistentBytes;
+ezAtomicInteger32 ezPersistentInstanceData::s_iFrameIndexBytes;
+
+// static
+bool ezPersistentInstanceData::IsEnabled()
+{
+  return cvar_RenderingPersistentInstanceData;
+}
+
+// static
+void ezPersistentInstanceData::FreeSlot(const ezRenderData* pRenderData)
+{
+  const ezUInt32 uiSlot = pRenderData->m_uiPersistentInstanceSlot;
+  if (uiSlot == ezInvalidIndex)
+    return;
+
+  EZ_LOCK(s_Mutex);
+
+  s_FreeSlots.PushBack(uiSlot);
+  pRenderData->m_uiPersistentInstanceSlot = ezInvalidIndex;
+}
+
+// static
+void ezPersistentInstanceData::UploadDirtySlots(ezRenderContext* pRenderContext)
+{
+  EZ_LOCK(s_Mutex);
+
+  if (s_DirtySlots.IsEmpty())
+    return;
+
+  EZ_PROFILE_SCOPE("UploadDirtyInstanceData");
+
+  EnsureBufferSize(s_SlotData.GetCount());
+
+  // Merge the dirty slots into contiguous ranges, newly allocated slots are mostly consecutive.
+  s_DirtySlots.Sort();
+
+  ezGALCommandEncoder* pGALCommandEncoder = pRenderContext->GetCommandEncoder();
+
+  ezUInt32 uiRangeStart = s_DirtySlots[0];
+  ezUInt32 uiRangeEnd = uiRangeStart + 1;
+
+  auto uploadRange = [&]() {
+    auto sourceData = s_SlotData.GetArrayPtr().GetSubArray(uiRangeStart, uiRangeEnd - uiRangeStart).ToByteArray();
+    pGALCommandEncoder->UpdateBuffer(s_hBuffer, uiRangeStart * sizeof(ezPerInstanceData), sourceData, ezGALUpdateMode::CopyToTempStorage);
+
+    s_iFramePersistentBytes.Add(sourceData.GetCount());
+  };
+
+  for (ezUInt32 i = 1; i < s_DirtySlots.GetCount(); ++i)
+  {
+    const ezUInt32 uiSlot = s_DirtySlots[i];
+    if (uiSlot < uiRangeEnd)
+      continue;
+
+    if (uiSlot > uiRangeEnd)
+    {
+      uploadRange();
+      uiRangeStart = uiSlot;
+    }
+
+    uiRangeEnd = uiSlot + 1;
+  }
+
+  uploadRange();
+
+  s_DirtySlots.Clear();
+}
+
+// static
+void ezPersistentInstanceData::OnEngineStartup()
+{
+  ezRenderWorld::GetRenderEvent().AddEventHandler(&ezPersistentInstanceData::OnRenderEvent);
+}
+
+// static
+void ezPersistentInstanceData::OnEngineShutdown()
+{
+  ezRenderWorld::GetRenderEvent().RemoveEventHandler(&ezPersistentInstanceData::OnRenderEvent);
+
+  if (!s_hBuffer.IsInvalidated())
+  {
+    ezGALDevice::GetDefaultDevice()->DestroyBuffer(s_hBuffer);
+    s_hBuffer.Invalidate();
+  }
+
+  s_uiBufferSlotCount = 0;
+  s_SlotData.Clear();
+  s_SlotData.Compact();
+  s_FreeSlots.Clear();
+  s_FreeSlots.Compact();
+  s_DirtySlots.Clear();
+  s_DirtySlots.Compact();
+}
+
+// static
+void ezPersistentInstanceData::OnRenderEvent(const ezRenderWorldRenderEvent& e)
+{
+  if (e.m_Type != ezRenderWorldRenderEvent::Type::EndRender)
+    return;
+
+  s_LastFrameStatistics.m_uiTransientBytes = s_iFrameTransientBytes.Set(0);
+  s_LastFrameStatistics.m_uiPersistentBytes = s_iFramePersistentBytes.Set(0);
+  s_LastFrameStatistics.m_uiIndexBytes = s_iFrameIndexBytes.Set(0);
+
+  {
+    EZ_LOCK(s_Mutex);
+    s_LastFrameStatistics.m_uiNumSlots = s_SlotData.GetCount() - s_FreeSlots.GetCount();
+  }
+
+  ezStats::SetStat("Rendering/InstanceData/TransientBytes", s_LastFrameStatistics.m_uiTransientBytes);
+  ezStats::SetStat("Rendering/InstanceData/PersistentBytes", s_LastFrameStatistics.m_uiPersistentBytes);
+  ezStats::SetStat("Rendering/InstanceData/IndexBytes", s_LastFrameStatistics.m_uiIndexBytes);
+  ezStats::SetStat("Rendering/InstanceData/PersistentSlots", s_LastFrameStatistics.m_uiNumSlots);
+}
+
+// static
+ezPerInstanceData& ezPersistentInstanceData::AllocateSlot(const ezRenderData* pRenderData, ezUInt32& out_uiSlot)
+{
+  EZ_LOCK(s_Mutex);
+
+  if (!s_FreeSlots.IsEmpty())
+  {
+    out_uiSlot = s_FreeSlots.PeekBack();
+    s_FreeSlots.PopBack();
+  }
+  else
+  {
+    out_uiSlot = s_SlotData.GetCount();
+    s_SlotData.ExpandAndGetRef();
+  }
+
+  pRenderData->m_uiPersistentInstanceSlot = out_uiSlot;
+  s_DirtySlots.PushBack(out_uiSlot);
+
+  return s_SlotData[out_uiSlot];
+}
+
+// static
+void ezPersistentInstanceData::EnsureBufferSize(ezUInt32 uiSlotCount)
+{
+  if (uiSlotCount <= s_uiBufferSlotCount)
+    return;
+
+  ezGALDevice* pDevice = ezGALDevice::GetDefaultDevice();
+
+  if (!s_hBuffer.IsInvalidated())
+  {
+    pDevice->DestroyBuffer(s_hBuffer);
+  }
+
+  s_uiBufferSlotCount = ezMath::Max<ezUInt32>(InitialPersistentSlotCount, ezMath::PowerOfTwo_Ceil(uiSlotCount));
+
+  ezGALBufferCreationDescription desc;
+  desc.m_uiStructSize = sizeof(ezPerInstanceData);
+  desc.m_uiTotalSize = desc.m_uiStructSize * s_uiBufferSlotCount;
+  desc.m_BufferType = ezGALBufferType::Generic;
+  desc.m_bUseAsStructuredBuffer = true;
+  desc.m_bAllowShaderResourceView = true;
+  desc.m_ResourceAccess.m_bImmutable = false;
+
+  s_hBuffer = pDevice->CreateBuffer(desc);
+
+  // The new buffer is empty, so every slot needs to be uploaded again. Free slots are uploaded as well, which keeps this a single range.
+  s_DirtySlots.Clear();
+  for (ezUInt32 i = 0; i < s_SlotData.GetCount(); ++i)
+  {
+    s_DirtySlots.PushBack(i);
+  }
 }
 
 //////////////////////////////////////////////////////////////////////////
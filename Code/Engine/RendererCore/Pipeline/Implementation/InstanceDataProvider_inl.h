@@ -0,0 +1,14 @@
+
+template <typename Callback>
+EZ_FORCE_INLINE ezUInt32 ezPersistentInstanceData::GetOrAllocateSlot(const ezRenderData* pRenderData, Callback fillCallback)
+{
+  EZ_ASSERT_DEBUG(pRenderData->IsCached(), "Only cached render data can have a persistent instance data slot");
+
+  ezUInt32 uiSlot = pRenderData->m_uiPersistentInstanceSlot;
+  if (uiSlot == ezInvalidIndex)
+  {
+    fillCallback(AllocateSlot(pRenderData, uiSlot));
+  }
+
+  return uiSlot;
+}
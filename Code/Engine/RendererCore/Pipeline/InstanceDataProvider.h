@@ -1,10 +1,14 @@
 #pragma once
 
+#include <Foundation/Threading/AtomicInteger.h>
+#include <Foundation/Threading/Mutex.h>
 #include <RendererCore/Declarations.h>
 #include <RendererCore/Pipeline/FrameDataProvider.h>
+#include <RendererCore/Pipeline/RenderData.h>
 #include <RendererCore/Shader/ConstantBufferStorage.h>
 
 struct ezPerInstanceData;
+struct ezRenderWorldRenderEvent;
 class ezInstanceDataProvider;
 class ezInstancedMeshComponent;
 
@@ -17,6 +21,7 @@ public:
   ~ezInstanceData();
 
   ezGALBufferHandle m_hInstanceDataBuffer;
+  ezGALBufferHandle m_hInstanceIndexBuffer;
 
   ezConstantBufferStorageHandle m_hConstantBuffer;
 
@@ -25,6 +30,14 @@ public:
   ezArrayPtr<ezPerInstanceData> GetInstanceData(ezUInt32 uiCount, ezUInt32& out_uiOffset);
   void UpdateInstanceData(ezRenderContext* pRenderContext, ezUInt32 uiCount);
 
+  /// \brief Binds the persistent instance data buffer instead of this object's instance data buffer.
+  ///
+  /// Draw calls then reference slots in the persistent buffer through the indices written with GetInstanceIndices / UpdateInstanceIndices.
+  void BindPersistentResources(ezRenderContext* pRenderContext);
+
+  ezArrayPtr<ezUInt32> GetInstanceIndices(ezUInt32 uiCount, ezUInt32& out_uiOffset);
+  void UpdateInstanceIndices(ezRenderContext* pRenderContext, ezUInt32 uiCount);
+
 private:
   friend ezInstanceDataProvider;
   friend ezInstancedMeshComponent;
@@ -35,6 +48,68 @@ private:
   ezUInt32 m_uiBufferSize;
   ezUInt32 m_uiBufferOffset;
   ezDynamicArray<ezPerInstanceData, ezAlignedAllocatorWrapper> m_perInstanceData;
+
+  ezUInt32 m_uiIndexBufferOffset;
+  ezDynamicArray<ezUInt32, ezAlignedAllocatorWrapper> m_InstanceIndices;
+};
+
+/// \brief Stores ezPerInstanceData for cached (static) render data in one large GPU buffer that outlives a frame.
+///
+/// Every cached render data that is drawn through the persistent path gets a stable slot in this buffer. The slot is filled once when it is
+/// allocated and uploaded as part of a dirty range. Afterwards draw calls only upload a small list of slot indices instead of the full
+/// per instance data. Slots are released when the cached render data is deleted by ezRenderWorld.
+class EZ_RENDERERCORE_DLL ezPersistentInstanceData
+{
+public:
+  struct Statistics
+  {
+    ezUInt32 m_uiTransientBytes = 0;  ///< Bytes of ezPerInstanceData uploaded through the regular per-frame path.
+    ezUInt32 m_uiPersistentBytes = 0; ///< Bytes of ezPerInstanceData uploaded for dirty slots of the persistent buffer.
+    ezUInt32 m_uiIndexBytes = 0;      ///< Bytes of slot indices uploaded for draw calls that use the persistent buffer.
+    ezUInt32 m_uiNumSlots = 0;        ///< Number of currently allocated slots.
+  };
+
+  /// \brief Returns whether the persistent path should be used. Controlled by the cvar 'Rendering.PersistentInstanceData'.
+  static bool IsEnabled();
+
+  /// \brief Returns the slot of the given cached render data. Allocates a new slot and fills it through the given callback if necessary.
+  template <typename Callback>
+  static ezUInt32 GetOrAllocateSlot(const ezRenderData* pRenderData, Callback fillCallback);
+
+  /// \brief Releases the slot of the given render data, if it has one. Called by ezRenderWorld before cached render data is deleted.
+  static void FreeSlot(const ezRenderData* pRenderData);
+
+  /// \brief Uploads all slots that have been written since the last upload. Must be called before any draw call that references them.
+  static void UploadDirtySlots(ezRenderContext* pRenderContext);
+
+  static ezGALBufferHandle GetBuffer() { return s_hBuffer; }
+
+  /// \brief Returns the statistics of the last rendered frame. The values are also published as ezStats under 'Rendering/InstanceData'.
+  static const Statistics& GetStatistics() { return s_LastFrameStatistics; }
+
+private:
+  friend struct ezInstanceData;
+  EZ_MAKE_SUBSYSTEM_STARTUP_FRIEND(RendererCore, PersistentInstanceData);
+
+  static void OnEngineStartup();
+  static void OnEngineShutdown();
+  static void OnRenderEvent(const ezRenderWorldRenderEvent& e);
+
+  static ezPerInstanceData& AllocateSlot(const ezRenderData* pRenderData, ezUInt32& out_uiSlot);
+  static void EnsureBufferSize(ezUInt32 uiSlotCount);
+
+  static ezMutex s_Mutex;
+  static ezGALBufferHandle s_hBuffer;
+  static ezUInt32 s_uiBufferSlotCount;
+  static ezDynamicArray<ezPerInstanceData, ezAlignedAllocatorWrapper> s_SlotData;
+  static ezDynamicArray<ezUInt32> s_FreeSlots;
+  static ezDynamicArray<ezUInt32> s_DirtySlots;
+  static Statistics s_LastFrameStatistics;
+
+  // The uploads of a frame happen on several threads, the counters are collected into s_LastFrameStatistics at the end of the frame.
+  static ezAtomicInteger32 s_iFrameTransientBytes;
+  static ezAtomicInteger32 s_iFramePersistentBytes;
+  static ezAtomicInteger32 s_iFrameIndexBytes;
 };
 
 class EZ_RENDERERCORE_DLL ezInstanceDataProvider : public ezFrameDataProvider<ezInstanceData>
@@ -50,3 +125,5 @@ private:
 
   ezInstanceData m_Data;
 };
+
+#include <RendererCore/Pipeline/Implementation/InstanceDataProvider_inl.h>
@@ -45,6 +45,9 @@ public:
 
   ezUInt64 GetCategorySortingKey(Category category, const ezCamera& camera) const;
 
+  /// \brief Returns true if this render data is owned by the render data cache of ezRenderWorld and thus lives longer than one frame.
+  bool IsCached() const { return m_bIsCached; }
+
   ezUInt32 m_uiBatchId = 0; ///< BatchId is used to group render data in batches.
   ezUInt32 m_uiSortingKey = 0;
 
@@ -58,6 +61,12 @@ public:
 #endif
 
 private:
+  friend class ezRenderWorld;
+  friend class ezPersistentInstanceData;
+
+  bool m_bIsCached = false;
+  mutable ezUInt32 m_uiPersistentInstanceSlot = ezInvalidIndex; ///< Slot in ezPersistentInstanceData, only assigned for cached render data.
+
   EZ_MAKE_SUBSYSTEM_STARTUP_FRIEND(RendererCore, RenderData);
 
   static void PluginEventHandler(const ezPluginEvent& e);
@@ -12,6 +12,7 @@
 #include <RendererCore/Textures/Texture2DResource.h>
 #include <RendererCore/Textures/Texture3DResource.h>
 #include <RendererCore/Textures/TextureCubeResource.h>
+#include <RendererCore/Textures/TextureStreaming.h>
 #include <RendererFoundation/CommandEncoder/CommandEncoder.h>
 #include <RendererFoundation/Resources/RenderTargetView.h>
 #include <RendererFoundation/Resources/Texture.h>
@@ -235,6 +236,11 @@ void ezRenderContext::BindTexture2D(const ezTempHashedString& sSlotName, const e
     ezResourceLock<ezTexture2DResource> pTexture(hTexture, acquireMode);
     BindTexture2D(sSlotName, ezGALDevice::GetDefaultDevice()->GetDefaultResourceView(pTexture->GetGALTexture()));
     BindSamplerState(sSlotName, pTexture->GetGALSamplerState());
+
+    if (m_fTextureStreamingScreenSize > 0.0f)
+    {
+      ezTextureStreaming::RequestResolution(pTexture.GetPointer(), m_fTextureStreamingScreenSize);
+    }
   }
   else
   {
@@ -716,6 +722,7 @@ void ezRenderContext::ResetContextState()
   m_PermutationVariables.Clear();
   m_hNewMaterial.Invalidate();
   m_hMaterial.Invalidate();
+  m_fTextureStreamingScreenSize = 0.0f;
 
   m_hActiveShaderPermutation.Invalidate();
 
@@ -1082,6 +1089,14 @@ ezMaterialResource* ezRenderContext::ApplyMaterialState()
 
     m_hMaterial = m_hNewMaterial;
   }
+  else if (m_fTextureStreamingScreenSize > 0.0f)
+  {
+    // the textures are still bound from a previous draw call, but this geometry may need a higher resolution
+    for (auto it = pMaterial->GetOrUpdateCachedValues()->m_Texture2DBindings.GetIterator(); it.IsValid(); ++it)
+    {
+      ezTextureStreaming::RequestResolution(it.Value(), m_fTextureStreamingScreenSize);
+    }
+  }
 
   // The material needs its constant buffer updated.
   // Thus we keep it acquired until we have the correct shader permutation for the constant buffer layout.
@@ -145,6 +145,12 @@ public:
 
   void BindMaterial(const ezMaterialResourceHandle& hMaterial);
 
+  /// \brief Sets how many pixels the geometry that is rendered next covers on screen. Zero by default.
+  ///
+  /// As long as this is non-zero, all 2D textures bound through a material or a texture resource handle request a matching
+  /// resolution from ezTextureStreaming. Renderers should reset it to zero once they are done.
+  void SetTextureStreamingScreenSize(float fScreenSize) { m_fTextureStreamingScreenSize = fScreenSize; }
+
   void BindTexture2D(const ezTempHashedString& sSlotName, const ezTexture2DResourceHandle& hTexture, ezResourceAcquireMode acquireMode = ezResourceAcquireMode::AllowLoadingFallback);
   void BindTexture3D(const ezTempHashedString& sSlotName, const ezTexture3DResourceHandle& hTexture, ezResourceAcquireMode acquireMode = ezResourceAcquireMode::AllowLoadingFallback);
   void BindTextureCube(const ezTempHashedString& sSlotName, const ezTextureCubeResourceHandle& hTexture, ezResourceAcquireMode acquireMode = ezResourceAcquireMode::AllowLoadingFallback);
@@ -277,6 +283,7 @@ private:
   ezHashTable<ezHashedString, ezHashedString> m_PermutationVariables;
   ezMaterialResourceHandle m_hNewMaterial;
   ezMaterialResourceHandle m_hMaterial;
+  float m_fTextureStreamingScreenSize = 0.0f;
 
   ezShaderPermutationResourceHandle m_hActiveShaderPermutation;
 
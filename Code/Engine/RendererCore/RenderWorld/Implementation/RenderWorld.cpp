@@ -4,6 +4,7 @@
 #include <Foundation/Configuration/CVar.h>
 #include <Foundation/Configuration/Startup.h>
 #include <Foundation/Memory/CommonAllocators.h>
+#include <RendererCore/Pipeline/InstanceDataProvider.h>
 #include <RendererCore/Pipeline/RenderPipeline.h>
 #include <RendererCore/Pipeline/View.h>
 #include <RendererCore/RenderWorld/RenderWorld.h>
@@ -640,6 +641,8 @@ void ezRenderWorld::ClearRenderDataCache()
 
   for (auto pRenderData : s_DeletedRenderData)
   {
+    ezPersistentInstanceData::FreeSlot(pRenderData);
+
     ezRenderData* ptr = const_cast<ezRenderData*>(pRenderData);
     EZ_DELETE(s_pCacheAllocator, ptr);
   }
@@ -681,7 +684,11 @@ void ezRenderWorld::UpdateRenderDataCache()
           if (uiCachedRenderDataIndex >= cachedRenderDataPerComponent.GetCount())
           {
             const ezRTTI* pRtti = newEntry.m_pRenderData->GetDynamicRTTI();
-            newEntry.m_pRenderData = pRtti->GetAllocator()->Clone<ezRenderData>(newEntry.m_pRenderData, s_pCacheAllocator);
+            ezRenderData* pCachedRenderData = pRtti->GetAllocator()->Clone<ezRenderData>(newEntry.m_pRenderData, s_pCacheAllocator);
+            pCachedRenderData->m_bIsCached = true;
+            pCachedRenderData->m_uiPersistentInstanceSlot = ezInvalidIndex;
+
+            newEntry.m_pRenderData = pCachedRenderData;
 
             cachedRenderDataPerComponent.PushBack(newEntry.m_pRenderData);
           }
@@ -2,7 +2,9 @@
 
 #include <Foundation/IO/FileSystem/FileReader.h>
 #include <Foundation/IO/FileSystem/FileWriter.h>
+#include <Foundation/IO/MemoryStream.h>
 #include <RendererCore/Shader/ShaderStageBinary.h>
+#include <RendererCore/Shader/ShaderStagePack.h>
 #include <RendererCore/Shader/Types.h>
 #include <RendererCore/ShaderCompiler/ShaderManager.h>
 
@@ -153,7 +155,10 @@ ezShaderResourceBinding::~ezShaderResourceBinding() {}
 
 //////////////////////////////////////////////////////////////////////////
 
+ezMutex ezShaderStageBinary::s_Mutex;
+bool ezShaderStageBinary::s_bPackInitialized = false;
 ezMap<ezUInt32, ezShaderStageBinary> ezShaderStageBinary::s_ShaderStageBinaries[ezGALShaderStage::ENUM_COUNT];
+ezHashTable<ezUInt64, ezScopedRefPointer<ezGALShaderByteCode>> ezShaderStageBinary::s_SharedByteCode;
 
 ezShaderStageBinary::ezShaderStageBinary() = default;
 
@@ -327,6 +332,14 @@ ezShaderConstantBufferLayout* ezShaderStageBinary::CreateConstantBufferLayout()
 
 ezResult ezShaderStageBinary::WriteStageBinary(ezLogInterface* pLog) const
 {
+  // Permutations are compiled in parallel and different permutations often produce the same stage source.
+  // The first one writes the file, all others pick up the in-memory binary.
+  EZ_LOCK(s_Mutex);
+
+  auto itStage = s_ShaderStageBinaries[m_Stage].Find(m_uiSourceHash);
+  if (itStage.IsValid() && !itStage.Value().m_ByteCode.IsEmpty())
+    return EZ_SUCCESS;
+
   ezStringBuilder sShaderStageFile = ezShaderManager::GetCacheDirectory();
 
   sShaderStageFile.AppendPath(ezShaderManager::GetActivePlatform().GetData());
@@ -345,33 +358,82 @@ ezResult ezShaderStageBinary::WriteStageBinary(ezLogInterface* pLog) const
     return EZ_FAILURE;
   }
 
+  if (itStage.IsValid())
+  {
+    itStage.Value().m_ByteCode = m_ByteCode;
+  }
+  else
+  {
+    ezShaderStageBinary& binary = s_ShaderStageBinaries[m_Stage][m_uiSourceHash];
+    binary.m_uiSourceHash = m_uiSourceHash;
+    binary.m_Stage = m_Stage;
+    binary.m_ByteCode = m_ByteCode;
+    binary.m_ShaderResourceBindings = m_ShaderResourceBindings;
+    binary.m_bWasCompiledWithDebug = m_bWasCompiledWithDebug;
+  }
+
+  return EZ_SUCCESS;
+}
+
+// static
+ezResult ezShaderStageBinary::LoadStageBinaryFromPack(ezGALShaderStage::Enum Stage, ezUInt32 uiHash, ezShaderStageBinary& out_Binary)
+{
+  if (!s_bPackInitialized)
+  {
+    s_bPackInitialized = true;
+    ezShaderStagePack::Open(ezShaderManager::GetActivePlatform()).IgnoreResult();
+  }
+
+  if (!ezShaderStagePack::IsOpen())
+    return EZ_FAILURE;
+
+  const ezShaderStagePack::Entry* pEntry = ezShaderStagePack::FindEntry(Stage, uiHash);
+  if (pEntry == nullptr)
+    return EZ_FAILURE;
+
+  const ezArrayPtr<const ezUInt8> metaData = ezShaderStagePack::GetMetaData(*pEntry);
+  ezRawMemoryStreamReader metaDataReader(metaData.GetPtr(), metaData.GetCount());
+  if (out_Binary.Read(metaDataReader).Failed())
+  {
+    ezLog::Error("Could not read shader stage {0} {1} from the shader stage pack", ezGALShaderStage::Names[Stage], ezArgU(uiHash, 8, true, 16, true));
+    return EZ_FAILURE;
+  }
+
+  out_Binary.m_ByteCode = ezShaderStagePack::GetByteCode(*pEntry);
   return EZ_SUCCESS;
 }
 
 // static
 ezShaderStageBinary* ezShaderStageBinary::LoadStageBinary(ezGALShaderStage::Enum Stage, ezUInt32 uiHash)
 {
+  // called from the resource loading thread as well as from the main thread and the shader compiler tasks
+  EZ_LOCK(s_Mutex);
+
   auto itStage = s_ShaderStageBinaries[Stage].Find(uiHash);
 
   if (!itStage.IsValid())
   {
-    ezStringBuilder sShaderStageFile = ezShaderManager::GetCacheDirectory();
-
-    sShaderStageFile.AppendPath(ezShaderManager::GetActivePlatform().GetData());
-    sShaderStageFile.AppendFormat("/{0}_{1}.ezShaderStage", ezGALShaderStage::Names[Stage], ezArgU(uiHash, 8, true, 16, true));
+    ezShaderStageBinary shaderStageBinary;
 
-    ezFileReader StageFileIn;
-    if (StageFileIn.Open(sShaderStageFile.GetData()).Failed())
+    if (LoadStageBinaryFromPack(Stage, uiHash, shaderStageBinary).Failed())
     {
-      ezLog::Debug("Could not open shader stage file '{0}' for reading", sShaderStageFile);
-      return nullptr;
-    }
+      ezStringBuilder sShaderStageFile = ezShaderManager::GetCacheDirectory();
 
-    ezShaderStageBinary shaderStageBinary;
-    if (shaderStageBinary.Read(StageFileIn).Failed())
-    {
-      ezLog::Error("Could not read shader stage file '{0}'", sShaderStageFile);
-      return nullptr;
+      sShaderStageFile.AppendPath(ezShaderManager::GetActivePlatform().GetData());
+      sShaderStageFile.AppendFormat("/{0}_{1}.ezShaderStage", ezGALShaderStage::Names[Stage], ezArgU(uiHash, 8, true, 16, true));
+
+      ezFileReader StageFileIn;
+      if (StageFileIn.Open(sShaderStageFile.GetData()).Failed())
+      {
+        ezLog::Debug("Could not open shader stage file '{0}' for reading", sShaderStageFile);
+        return nullptr;
+      }
+
+      if (shaderStageBinary.Read(StageFileIn).Failed())
+      {
+        ezLog::Error("Could not read shader stage file '{0}'", sShaderStageFile);
+        return nullptr;
+      }
     }
 
     itStage = ezShaderStageBinary::s_ShaderStageBinaries[Stage].Insert(uiHash, shaderStageBinary);
@@ -386,7 +448,20 @@ ezShaderStageBinary* ezShaderStageBinary::LoadStageBinary(ezGALShaderStage::Enum
 
   if (pShaderStageBinary->m_pGALByteCode == nullptr && !pShaderStageBinary->m_ByteCode.IsEmpty())
   {
-    pShaderStageBinary->m_pGALByteCode = EZ_DEFAULT_NEW(ezGALShaderByteCode, pShaderStageBinary->m_ByteCode);
+    const ezArrayPtr<const ezUInt8> byteCode = pShaderStageBinary->m_ByteCode;
+    const ezUInt64 uiContentHash = ezHashingUtils::xxHash64(byteCode.GetPtr(), byteCode.GetCount());
+
+    ezScopedRefPointer<ezGALShaderByteCode>* pSharedByteCode = nullptr;
+    if (s_SharedByteCode.TryGetValue(uiContentHash, pSharedByteCode) &&
+        ezArrayPtr<const ezUInt8>(static_cast<const ezUInt8*>((*pSharedByteCode)->GetByteCode()), (*pSharedByteCode)->GetSize()) == byteCode)
+    {
+      pShaderStageBinary->m_pGALByteCode = *pSharedByteCode;
+    }
+    else
+    {
+      pShaderStageBinary->m_pGALByteCode = EZ_DEFAULT_NEW(ezGALShaderByteCode, byteCode);
+      s_SharedByteCode.Insert(uiContentHash, pShaderStageBinary->m_pGALByteCode);
+    }
   }
 
   return pShaderStageBinary;
@@ -395,10 +470,27 @@ ezShaderStageBinary* ezShaderStageBinary::LoadStageBinary(ezGALShaderStage::Enum
 // static
 void ezShaderStageBinary::OnEngineShutdown()
 {
+  EZ_LOCK(s_Mutex);
+
   for (ezUInt32 stage = 0; stage < ezGALShaderStage::ENUM_COUNT; ++stage)
   {
     s_ShaderStageBinaries[stage].Clear();
   }
+
+  // the binaries only delete their byte code once nobody references it anymore, so the last reference is the one of the table
+  for (auto it = s_SharedByteCode.GetIterator(); it.IsValid(); ++it)
+  {
+    ezGALShaderByteCode* pByteCode = it.Value();
+    it.Value() = nullptr;
+
+    if (pByteCode->GetRefCount() == 0)
+      EZ_DEFAULT_DELETE(pByteCode);
+  }
+
+  s_SharedByteCode.Clear();
+
+  ezShaderStagePack::Close();
+  s_bPackInitialized = false;
 }
 
 
@@ -0,0 +1,277 @@
+#include <RendererCore/RendererCorePCH.h>
+
+#include <Foundation/IO/FileSystem/DeferredFileWriter.h>
+#include <Foundation/IO/FileSystem/FileReader.h>
+#include <Foundation/IO/FileSystem/FileSystem.h>
+#include <Foundation/IO/MemoryMappedFile.h>
+#include <Foundation/IO/MemoryStream.h>
+#include <Foundation/IO/OSFile.h>
+#include <RendererCore/Shader/ShaderStageBinary.h>
+#include <RendererCore/Shader/ShaderStagePack.h>
+#include <RendererCore/ShaderCompiler/ShaderManager.h>
+
+namespace
+{
+  constexpr ezUInt32 s_uiPackMagic = 0x50535A45; // 'EZSP'
+  constexpr ezUInt32 s_uiPackVersion = 1;
+
+  struct PackHeader
+  {
+    ezUInt32 m_uiMagic;
+    ezUInt32 m_uiVersion;
+    ezUInt32 m_uiNumEntries;
+    ezUInt32 m_uiReserved;
+  };
+
+  EZ_ALWAYS_INLINE bool IsLess(ezUInt32 uiStageA, ezUInt32 uiHashA, ezUInt32 uiStageB, ezUInt32 uiHashB)
+  {
+    return uiStageA < uiStageB || (uiStageA == uiStageB && uiHashA < uiHashB);
+  }
+} // namespace
+
+ezUniquePtr<ezMemoryMappedFile> ezShaderStagePack::s_pFile;
+const ezShaderStagePack::Entry* ezShaderStagePack::s_pEntries = nullptr;
+ezUInt32 ezShaderStagePack::s_uiNumEntries = 0;
+
+void ezShaderStagePack::GetPackFilePath(const char* szPlatform, ezStringBuilder& out_sPath)
+{
+  out_sPath = ezShaderManager::GetCacheDirectory();
+  out_sPath.AppendPath(szPlatform, "ShaderStages.ezShaderStagePack");
+}
+
+ezResult ezShaderStagePack::WritePack(const char* szPlatform, ezLogInterface* pLog)
+{
+#if EZ_ENABLED(EZ_SUPPORTS_FILE_ITERATORS)
+  EZ_LOG_BLOCK(pLog, "Writing Shader Stage Pack", szPlatform);
+
+  ezStringBuilder sPlatformDir = ezShaderManager::GetCacheDirectory();
+  sPlatformDir.AppendPath(szPlatform);
+
+  ezStringBuilder sAbsPlatformDir;
+  if (ezFileSystem::ResolvePath(sPlatformDir, &sAbsPlatformDir, nullptr).Failed())
+  {
+    ezLog::Error(pLog, "Could not resolve shader cache directory '{0}'", sPlatformDir);
+    return EZ_FAILURE;
+  }
+
+  ezDeque<ezShaderStageBinary> binaries;
+
+  ezStringBuilder sStageFile;
+  ezFileSystemIterator fsIt;
+  for (fsIt.StartSearch(sAbsPlatformDir, ezFileSystemIteratorFlags::ReportFiles); fsIt.IsValid(); fsIt.Next())
+  {
+    if (!ezPathUtils::HasExtension(fsIt.GetStats().m_sName, "ezShaderStage"))
+      continue;
+
+    sStageFile = sPlatformDir;
+    sStageFile.AppendPath(fsIt.GetStats().m_sName);
+
+    ezFileReader stageFileIn;
+    if (stageFileIn.Open(sStageFile).Failed())
+    {
+      ezLog::Error(pLog, "Could not open shader stage file '{0}' for reading", sStageFile);
+      return EZ_FAILURE;
+    }
+
+    ezShaderStageBinary& binary = binaries.ExpandAndGetRef();
+    if (binary.Read(stageFileIn).Failed())
+    {
+      ezLog::Error(pLog, "Could not read shader stage file '{0}'", sStageFile);
+      return EZ_FAILURE;
+    }
+  }
+
+  binaries.Sort([](const ezShaderStageBinary& a, const ezShaderStageBinary& b) { return IsLess(a.m_Stage, a.m_uiSourceHash, b.m_Stage, b.m_uiSourceHash); });
+
+  ezDynamicArray<Entry> entries;
+  entries.Reserve(binaries.GetCount());
+
+  ezDynamicArray<ezUInt8> metaData;
+  ezDynamicArray<ezUInt8> byteCode;
+  ezHashTable<ezUInt64, ezUInt32> byteCodeOffsets;
+  ezUInt32 uiDuplicateByteCodes = 0;
+
+  for (ezShaderStageBinary& binary : binaries)
+  {
+    Entry& entry = entries.ExpandAndGetRef();
+    entry.m_uiSourceHash = binary.m_uiSourceHash;
+    entry.m_uiStage = binary.m_Stage;
+
+    // byte code is content addressed, identical byte code is only stored once
+    const ezArrayPtr<const ezUInt8> binaryByteCode = binary.m_ByteCode;
+    const ezUInt64 uiContentHash = ezHashingUtils::xxHash64(binaryByteCode.GetPtr(), binaryByteCode.GetCount());
+
+    ezUInt32 uiByteCodeOffset = 0;
+    if (byteCodeOffsets.TryGetValue(uiContentHash, uiByteCodeOffset) && byteCode.GetArrayPtr().GetSubArray(uiByteCodeOffset, binaryByteCode.GetCount()) == binaryByteCode)
+    {
+      ++uiDuplicateByteCodes;
+    }
+    else
+    {
+      uiByteCodeOffset = ezMemoryUtils::AlignSize(byteCode.GetCount(), 16u);
+      byteCode.SetCount(uiByteCodeOffset);
+      byteCode.PushBackRange(binaryByteCode);
+
+      byteCodeOffsets.Insert(uiContentHash, uiByteCodeOffset);
+    }
+
+    entry.m_uiByteCodeOffset = uiByteCodeOffset;
+    entry.m_uiByteCodeSize = binaryByteCode.GetCount();
+
+    // everything else is stored as a regular stage binary without byte code
+    binary.m_ByteCode.Clear();
+
+    entry.m_uiMetaDataOffset = metaData.GetCount();
+
+    ezMemoryStreamStorage storage;
+    ezMemoryStreamWriter metaDataWriter(&storage);
+    EZ_SUCCEED_OR_RETURN(binary.Write(metaDataWriter));
+
+    entry.m_uiMetaDataSize = storage.GetStorageSize();
+    metaData.PushBackRange(ezArrayPtr<const ezUInt8>(storage.GetData(), storage.GetStorageSize()));
+  }
+
+  // fix up offsets, meta data follows the entry table and byte code follows the meta data
+  const ezUInt32 uiMetaDataStart = sizeof(PackHeader) + entries.GetCount() * sizeof(Entry);
+  const ezUInt32 uiByteCodeStart = ezMemoryUtils::AlignSize(uiMetaDataStart + metaData.GetCount(), 16u);
+
+  for (Entry& entry : entries)
+  {
+    entry.m_uiMetaDataOffset += uiMetaDataStart;
+    entry.m_uiByteCodeOffset += uiByteCodeStart;
+  }
+
+  PackHeader header;
+  header.m_uiMagic = s_uiPackMagic;
+  header.m_uiVersion = s_uiPackVersion;
+  header.m_uiNumEntries = entries.GetCount();
+  header.m_uiReserved = 0;
+
+  ezStringBuilder sPackFile;
+  GetPackFilePath(szPlatform, sPackFile);
+
+  ezDeferredFileWriter packFileOut;
+  packFileOut.SetOutput(sPackFile);
+
+  EZ_SUCCEED_OR_RETURN(packFileOut.WriteBytes(&header, sizeof(PackHeader)));
+  EZ_SUCCEED_OR_RETURN(packFileOut.WriteBytes(entries.GetData(), entries.GetCount() * sizeof(Entry)));
+  EZ_SUCCEED_OR_RETURN(packFileOut.WriteBytes(metaData.GetData(), metaData.GetCount()));
+
+  const ezUInt8 padding[16] = {};
+  EZ_SUCCEED_OR_RETURN(packFileOut.WriteBytes(padding, uiByteCodeStart - uiMetaDataStart - metaData.GetCount()));
+  EZ_SUCCEED_OR_RETURN(packFileOut.WriteBytes(byteCode.GetData(), byteCode.GetCount()));
+
+  if (packFileOut.Close().Failed())
+  {
+    ezLog::Error(pLog, "Could not write shader stage pack '{0}'", sPackFile);
+    return EZ_FAILURE;
+  }
+
+  ezLog::Info(pLog, "Packed {0} shader stages into '{1}', {2} of them share byte code with another stage", entries.GetCount(), sPackFile, uiDuplicateByteCodes);
+  return EZ_SUCCESS;
+#else
+  ezLog::Error(pLog, "Writing a shader stage pack is not supported on this platform");
+  return EZ_FAILURE;
+#endif
+}
+
+ezResult ezShaderStagePack::Open(const char* szPlatform)
+{
+  Close();
+
+#if EZ_ENABLED(EZ_SUPPORTS_MEMORY_MAPPED_FILE)
+  ezStringBuilder sPackFile;
+  GetPackFilePath(szPlatform, sPackFile);
+
+  ezStringBuilder sAbsPackFile;
+  if (ezFileSystem::ResolvePath(sPackFile, &sAbsPackFile, nullptr).Failed() || !ezOSFile::ExistsFile(sAbsPackFile))
+    return EZ_FAILURE;
+
+  s_pFile = EZ_DEFAULT_NEW(ezMemoryMappedFile);
+  if (s_pFile->Open(sAbsPackFile, ezMemoryMappedFile::Mode::ReadOnly).Failed())
+  {
+    ezLog::Warning("Shader stage pack '{0}' could not be memory mapped", sAbsPackFile);
+    Close();
+    return EZ_FAILURE;
+  }
+
+  const ezUInt64 uiFileSize = s_pFile->GetFileSize();
+  const PackHeader* pHeader = static_cast<const PackHeader*>(s_pFile->GetReadPointer());
+
+  if (uiFileSize < sizeof(PackHeader) || pHeader->m_uiMagic != s_uiPackMagic || pHeader->m_uiVersion != s_uiPackVersion ||
+      uiFileSize < sizeof(PackHeader) + (ezUInt64)pHeader->m_uiNumEntries * sizeof(Entry))
+  {
+    ezLog::Warning("Shader stage pack '{0}' is invalid or outdated and is ignored", sAbsPackFile);
+    Close();
+    return EZ_FAILURE;
+  }
+
+  const Entry* pEntries = reinterpret_cast<const Entry*>(pHeader + 1);
+  for (ezUInt32 i = 0; i < pHeader->m_uiNumEntries; ++i)
+  {
+    const Entry& entry = pEntries[i];
+    if ((ezUInt64)entry.m_uiMetaDataOffset + entry.m_uiMetaDataSize > uiFileSize || (ezUInt64)entry.m_uiByteCodeOffset + entry.m_uiByteCodeSize > uiFileSize)
+    {
+      ezLog::Warning("Shader stage pack '{0}' is corrupted and is ignored", sAbsPackFile);
+      Close();
+      return EZ_FAILURE;
+    }
+  }
+
+  s_pEntries = pEntries;
+  s_uiNumEntries = pHeader->m_uiNumEntries;
+
+  ezLog::Dev("Memory mapped shader stage pack '{0}' with {1} stages", sAbsPackFile, s_uiNumEntries);
+  return EZ_SUCCESS;
+#else
+  return EZ_FAILURE;
+#endif
+}
+
+void ezShaderStagePack::Close()
+{
+  s_pEntries = nullptr;
+  s_uiNumEntries = 0;
+  s_pFile.Clear();
+}
+
+const ezShaderStagePack::Entry* ezShaderStagePack::FindEntry(ezGALShaderStage::Enum stage, ezUInt32 uiSourceHash)
+{
+  // entries are sorted by stage and source hash
+  ezUInt32 uiLow = 0;
+  ezUInt32 uiHigh = s_uiNumEntries;
+
+  while (uiLow < uiHigh)
+  {
+    const ezUInt32 uiMid = uiLow + (uiHigh - uiLow) / 2;
+    const Entry& entry = s_pEntries[uiMid];
+
+    if (IsLess(entry.m_uiStage, entry.m_uiSourceHash, stage, uiSourceHash))
+    {
+      uiLow = uiMid + 1;
+    }
+    else
+    {
+      uiHigh = uiMid;
+    }
+  }
+
+  if (uiLow < s_uiNumEntries && s_pEntries[uiLow].m_uiStage == (ezUInt32)stage && s_pEntries[uiLow].m_uiSourceHash == uiSourceHash)
+  {
+    return &s_pEntries[uiLow];
+  }
+
+  return nullptr;
+}
+
+ezArrayPtr<const ezUInt8> ezShaderStagePack::GetMetaData(const Entry& entry)
+{
+  return ezArrayPtr<const ezUInt8>(static_cast<const ezUInt8*>(s_pFile->GetReadPointer(entry.m_uiMetaDataOffset)), entry.m_uiMetaDataSize);
+}
+
+ezArrayPtr<const ezUInt8> ezShaderStagePack::GetByteCode(const Entry& entry)
+{
+  return ezArrayPtr<const ezUInt8>(static_cast<const ezUInt8*>(s_pFile->GetReadPointer(entry.m_uiByteCodeOffset)), entry.m_uiByteCodeSize);
+}
+
+EZ_STATICLINK_FILE(RendererCore, RendererCore_Shader_Implementation_ShaderStagePack);
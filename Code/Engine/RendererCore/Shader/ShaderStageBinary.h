@@ -4,6 +4,7 @@
 #include <Foundation/Containers/Map.h>
 #include <Foundation/IO/Stream.h>
 #include <Foundation/Strings/HashedString.h>
+#include <Foundation/Threading/Mutex.h>
 #include <Foundation/Types/Enum.h>
 #include <RendererCore/RendererCoreDLL.h>
 #include <RendererFoundation/Descriptors/Descriptors.h>
@@ -142,6 +143,7 @@ private:
   friend class ezShaderCompiler;
   friend class ezShaderPermutationResource;
   friend class ezShaderPermutationResourceLoader;
+  friend class ezShaderStagePack;
 
   ezUInt32 m_uiSourceHash = 0;
   ezGALShaderStage::Enum m_Stage = ezGALShaderStage::ENUM_COUNT;
@@ -150,10 +152,22 @@ private:
   ezHybridArray<ezShaderResourceBinding, 8> m_ShaderResourceBindings;
   bool m_bWasCompiledWithDebug = false;
 
+  /// \brief Writes the stage binary to the shader cache and makes it available to all other permutations with the same source hash.
+  /// Does nothing if a binary for the same source hash was already written or loaded.
   ezResult WriteStageBinary(ezLogInterface* pLog) const;
+
+  /// \brief Looks up the stage binary in memory, then in the shader stage pack and finally in the individual .ezShaderStage files.
+  /// Thread safe, the returned pointer stays valid until engine shutdown.
   static ezShaderStageBinary* LoadStageBinary(ezGALShaderStage::Enum Stage, ezUInt32 uiHash);
+  static ezResult LoadStageBinaryFromPack(ezGALShaderStage::Enum Stage, ezUInt32 uiHash, ezShaderStageBinary& out_Binary);
 
   static void OnEngineShutdown();
 
+  static ezMutex s_Mutex;
+  static bool s_bPackInitialized;
   static ezMap<ezUInt32, ezShaderStageBinary> s_ShaderStageBinaries[ezGALShaderStage::ENUM_COUNT];
+
+  // GAL byte code objects by content hash, stages with identical byte code share one object.
+  // The table holds a reference itself, so entries stay valid even if all binaries that use them are destroyed.
+  static ezHashTable<ezUInt64, ezScopedRefPointer<ezGALShaderByteCode>> s_SharedByteCode;
 };
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <Foundation/Types/UniquePtr.h>
+#include <RendererCore/RendererCoreDLL.h>
+#include <RendererFoundation/Descriptors/Descriptors.h>
+
+class ezMemoryMappedFile;
+
+/// \brief A single file that contains all shader stage binaries of one platform.
+///
+/// Instead of opening one .ezShaderStage file per stage and permutation, the pack is memory mapped once and stage binaries are looked up by
+/// their source hash. Byte code is stored content addressed, i.e. stages with identical byte code share the same data in the pack, even if
+/// they were compiled from different permutation variable combinations.
+///
+/// The pack is written by the ShaderCompiler tool (option -pack) and picked up automatically by ezShaderStageBinary::LoadStageBinary if it
+/// exists in the shader cache directory. Individual .ezShaderStage files are still used for stages that are not in the pack.
+class EZ_RENDERERCORE_DLL ezShaderStagePack
+{
+public:
+  struct Entry
+  {
+    ezUInt32 m_uiSourceHash;
+    ezUInt32 m_uiStage;
+    ezUInt32 m_uiMetaDataOffset; ///< Serialized ezShaderStageBinary without byte code
+    ezUInt32 m_uiMetaDataSize;
+    ezUInt32 m_uiByteCodeOffset;
+    ezUInt32 m_uiByteCodeSize;
+  };
+
+  /// \brief Collects all .ezShaderStage files of the given platform from the shader cache directory and writes them into one pack file.
+  static ezResult WritePack(const char* szPlatform, ezLogInterface* pLog = nullptr);
+
+  /// \brief Returns the path of the pack file for the given platform, relative to the shader cache directory.
+  static void GetPackFilePath(const char* szPlatform, ezStringBuilder& out_sPath);
+
+  /// \brief Memory maps the pack file of the given platform. Returns failure if there is no pack or it can't be mapped.
+  static ezResult Open(const char* szPlatform);
+  static void Close();
+  static bool IsOpen() { return s_pEntries != nullptr; }
+
+  /// \brief Returns the entry for the given stage and source hash or nullptr if the pack does not contain it.
+  static const Entry* FindEntry(ezGALShaderStage::Enum stage, ezUInt32 uiSourceHash);
+
+  static ezArrayPtr<const ezUInt8> GetMetaData(const Entry& entry);
+  static ezArrayPtr<const ezUInt8> GetByteCode(const Entry& entry);
+
+private:
+  static ezUniquePtr<ezMemoryMappedFile> s_pFile;
+  static const Entry* s_pEntries;
+  static ezUInt32 s_uiNumEntries;
+};
@@ -4,6 +4,7 @@
 
 #include <Foundation/Math/Mat3.h>
 #include <Foundation/Math/Transform.h>
+#include <Foundation/SimdMath/SimdMat4f.h>
 
 /// \brief A wrapper class that converts a ezMat3 into the correct data layout for shaders.
 class ezShaderMat3
@@ -51,6 +52,15 @@ public:
     }
   }
 
+  inline void operator=(const ezSimdMat4f& t)
+  {
+    const ezSimdMat4f rows = t.GetTranspose();
+
+    rows.m_col0.Store<4>(&m_Data[0]);
+    rows.m_col1.Store<4>(&m_Data[4]);
+    rows.m_col2.Store<4>(&m_Data[8]);
+  }
+
   inline void operator=(const ezMat3& t)
   {
     float data[9];
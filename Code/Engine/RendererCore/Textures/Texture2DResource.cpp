@@ -5,6 +5,7 @@
 #include <Foundation/Configuration/Startup.h>
 #include <RendererCore/RenderContext/RenderContext.h>
 #include <RendererCore/Textures/Texture2DResource.h>
+#include <RendererCore/Textures/TextureStreaming.h>
 #include <RendererCore/Textures/TextureUtils.h>
 #include <RendererFoundation/Resources/Texture.h>
 #include <Texture/Image/Formats/DdsFileFormat.h>
@@ -52,6 +53,15 @@ ezResourceLoadDesc ezTexture2DResource::UnloadData(Unload WhatToUnload)
     }
   }
 
+  if (m_uiLoadedTextures == 0 && m_uiStreamableMipLevels > 0)
+  {
+    ezTextureStreaming::UnregisterTexture(this);
+
+    m_uiStreamableMipLevels = 0;
+    m_uiResidentMipLevels = 0;
+    m_iStreamingTargetMipLevels = 0;
+  }
+
   if (WhatToUnload == Unload::AllQualityLevels)
   {
     if (!m_hSamplerState.IsInvalidated())
@@ -151,6 +161,9 @@ ezResourceLoadDesc ezTexture2DResource::UpdateContent(ezStreamReader* Stream)
   ezImage* pImage = nullptr;
   bool bIsFallback = false;
   ezTexFormat texFormat;
+  ezUInt8 uiStreamableMipLevels = 0;
+  ezUInt32 uiStreamableWidth = 0;
+  ezUInt32 uiStreamableHeight = 0;
 
   // load image data
   {
@@ -158,6 +171,13 @@ ezResourceLoadDesc ezTexture2DResource::UpdateContent(ezStreamReader* Stream)
     *Stream >> bIsFallback;
     texFormat.ReadHeader(*Stream);
 
+    *Stream >> uiStreamableMipLevels;
+    if (uiStreamableMipLevels > 0)
+    {
+      *Stream >> uiStreamableWidth;
+      *Stream >> uiStreamableHeight;
+    }
+
     td.m_SamplerDesc.m_AddressU = texFormat.m_AddressModeU;
     td.m_SamplerDesc.m_AddressV = texFormat.m_AddressModeV;
     td.m_SamplerDesc.m_AddressW = texFormat.m_AddressModeW;
@@ -166,6 +186,17 @@ ezResourceLoadDesc ezTexture2DResource::UpdateContent(ezStreamReader* Stream)
   const bool bIsRenderTarget = texFormat.m_iRenderTargetResolutionX != 0;
   EZ_ASSERT_DEV(!bIsRenderTarget, "Render targets are not supported by regular 2D texture resources");
 
+  if (uiStreamableMipLevels > 0 && !bIsFallback)
+  {
+    ezImageHeader header;
+    header.SetImageFormat(pImage->GetImageFormat());
+    header.SetWidth(uiStreamableWidth);
+    header.SetHeight(uiStreamableHeight);
+    header.SetNumMipLevels(uiStreamableMipLevels);
+
+    return UpdateStreamedContent(pImage, texFormat, header, td);
+  }
+
   {
 
     const ezUInt32 uiNumMipmapsLowRes = ezTextureUtils::s_bForceFullQualityAlways ? pImage->GetNumMipLevels() : ezMath::Min(pImage->GetNumMipLevels(), 6U);
@@ -234,6 +265,65 @@ ezResourceLoadDesc ezTexture2DResource::UpdateContent(ezStreamReader* Stream)
   }
 }
 
+ezResourceLoadDesc ezTexture2DResource::UpdateStreamedContent(const ezImage* pImage, const ezTexFormat& texFormat, const ezImageHeader& header, ezTexture2DResourceDescriptor& td)
+{
+  ezGALDevice* pDevice = ezGALDevice::GetDefaultDevice();
+
+  ezHybridArray<ezGALSystemMemoryDescription, 32> initData;
+  ezUInt32 uiMemoryGPU = 0;
+  FillOutDescriptor(td, pImage, texFormat.m_bSRGB, pImage->GetNumMipLevels(), uiMemoryGPU, initData);
+
+  ezTextureUtils::ConfigureSampler(static_cast<ezTextureFilterSetting::Enum>(texFormat.m_TextureFilter.GetValue()), td.m_SamplerDesc);
+
+  ezGALTextureHandle hTexture = pDevice->CreateTexture(td.m_DescGAL, td.m_InitialContent);
+  EZ_ASSERT_DEV(!hTexture.IsInvalidated(), "Texture Data could not be uploaded to the GPU");
+
+  pDevice->GetTexture(hTexture)->SetDebugName(GetResourceDescription());
+
+  if (m_hSamplerState.IsInvalidated())
+  {
+    m_hSamplerState = pDevice->CreateSamplerState(td.m_SamplerDesc);
+    EZ_ASSERT_DEV(!m_hSamplerState.IsInvalidated(), "Sampler state error");
+  }
+
+  // the new set of mips replaces everything that was resident before, including fallback data,
+  // the old textures are only destroyed after the new one is in place, so there is always a valid texture to render with
+  const ezGALTextureHandle hOldTextures[2] = {m_hGALTexture[0], m_hGALTexture[1]};
+
+  m_Type = td.m_DescGAL.m_Type;
+  m_Format = td.m_DescGAL.m_Format;
+  m_uiWidth = header.GetWidth();
+  m_uiHeight = header.GetHeight();
+
+  m_hGALTexture[0] = hTexture;
+  m_hGALTexture[1].Invalidate();
+  m_uiMemoryGPU[0] = uiMemoryGPU;
+  m_uiMemoryGPU[1] = 0;
+  m_uiLoadedTextures = 1;
+
+  for (const ezGALTextureHandle& hOldTexture : hOldTextures)
+  {
+    if (!hOldTexture.IsInvalidated())
+    {
+      pDevice->DestroyTexture(hOldTexture);
+    }
+  }
+
+  m_uiStreamableMipLevels = static_cast<ezUInt8>(header.GetNumMipLevels());
+  m_uiResidentMipLevels = static_cast<ezUInt8>(pImage->GetNumMipLevels());
+
+  ezTextureStreaming::RegisterTexture(this, header, m_uiResidentMipLevels);
+
+  // a target of zero means that ezTextureStreaming has not decided yet, it requests another update once it has
+  const ezInt32 iTargetMipLevels = m_iStreamingTargetMipLevels;
+
+  ezResourceLoadDesc res;
+  res.m_uiQualityLevelsDiscardable = m_uiLoadedTextures;
+  res.m_uiQualityLevelsLoadable = (iTargetMipLevels > 0 && iTargetMipLevels != m_uiResidentMipLevels) ? 1 : 0;
+  res.m_State = ezResourceState::Loaded;
+  return res;
+}
+
 void ezTexture2DResource::UpdateMemoryUsage(MemoryUsage& out_NewMemoryUsage)
 {
   out_NewMemoryUsage.m_uiMemoryCPU = sizeof(ezTexture2DResource);
@@ -5,12 +5,15 @@
 #include <Core/ResourceManager/Resource.h>
 #include <Core/ResourceManager/ResourceTypeLoader.h>
 #include <Foundation/IO/MemoryStream.h>
+#include <Foundation/Threading/AtomicInteger.h>
 #include <RendererCore/Pipeline/Declarations.h>
 #include <RendererCore/RenderContext/Implementation/RenderContextStructs.h>
 #include <RendererFoundation/Descriptors/Descriptors.h>
 #include <RendererFoundation/RendererFoundationDLL.h>
 
 class ezImage;
+class ezImageHeader;
+struct ezTexFormat;
 
 using ezTexture2DResourceHandle = ezTypedResourceHandle<class ezTexture2DResource>;
 
@@ -70,6 +73,18 @@ protected:
   ezUInt32 m_uiHeight = 0;
 
   ezGALSamplerStateHandle m_hSamplerState;
+
+  // texture streaming, see ezTextureStreaming
+  ezUInt8 m_uiStreamableMipLevels = 0;
+  ezUInt8 m_uiResidentMipLevels = 0;
+  ezUInt32 m_uiStreamingIndex = ezInvalidIndex;
+  ezAtomicInteger32 m_iStreamingTargetMipLevels;
+  ezAtomicInteger32 m_iStreamingRequestedSize;
+
+private:
+  friend class ezTextureStreaming;
+
+  ezResourceLoadDesc UpdateStreamedContent(const ezImage* pImage, const ezTexFormat& texFormat, const ezImageHeader& header, ezTexture2DResourceDescriptor& td);
 };
 
 //////////////////////////////////////////////////////////////////////////
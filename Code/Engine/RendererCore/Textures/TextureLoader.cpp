@@ -9,10 +9,12 @@
 #include <RendererCore/Textures/Texture3DResource.h>
 #include <RendererCore/Textures/TextureCubeResource.h>
 #include <RendererCore/Textures/TextureLoader.h>
+#include <RendererCore/Textures/TextureStreaming.h>
 #include <RendererCore/Textures/TextureUtils.h>
 #include <Texture/Image/Formats/DdsFileFormat.h>
 #include <Texture/Image/ImageConversion.h>
 #include <Texture/ezTexFormat/ezTexFormat.h>
+#include <Texture/ezTexFormat/ezTexMipChain.h>
 
 static ezTextureResourceLoader s_TextureResourceLoader;
 
@@ -118,7 +120,14 @@ ezResourceLoadData ezTextureResourceLoader::OpenDataStream(const ezResource* pRe
 
     if (sAbsolutePath.HasExtension("ezTexture2D") || sAbsolutePath.HasExtension("ezTexture3D") || sAbsolutePath.HasExtension("ezTextureCube") || sAbsolutePath.HasExtension("ezRenderTarget") || sAbsolutePath.HasExtension("ezLUT"))
     {
-      if (LoadTexFile(File, *pData).Failed())
+      // only regular 2D textures stream their mips, all other texture types always load everything
+      const ezTexture2DResource* pStreamingTexture = nullptr;
+      if (pResource->GetDynamicRTTI() == ezGetStaticRTTI<ezTexture2DResource>())
+      {
+        pStreamingTexture = static_cast<const ezTexture2DResource*>(pResource);
+      }
+
+      if (LoadTexFile(File, *pData, pStreamingTexture).Failed())
         return res;
     }
     else
@@ -189,7 +198,7 @@ bool ezTextureResourceLoader::IsResourceOutdated(const ezResource* pResource) co
   return true;
 }
 
-ezResult ezTextureResourceLoader::LoadTexFile(ezStreamReader& stream, LoadedData& data)
+ezResult ezTextureResourceLoader::LoadTexFile(ezStreamReader& stream, LoadedData& data, const ezTexture2DResource* pStreamingTexture /*= nullptr*/)
 {
   // read the hash, ignore it
   ezAssetFileHeader AssetHash;
@@ -197,15 +206,32 @@ ezResult ezTextureResourceLoader::LoadTexFile(ezStreamReader& stream, LoadedData
 
   data.m_TexFormat.ReadHeader(stream);
 
-  if (data.m_TexFormat.m_iRenderTargetResolutionX == 0)
+  if (data.m_TexFormat.m_iRenderTargetResolutionX != 0)
   {
-    ezDdsFileFormat fmt;
-    return fmt.ReadImage(stream, data.m_Image, ezLog::GetThreadLocalLogSystem(), "dds");
+    return EZ_SUCCESS;
   }
-  else
+
+  if (data.m_TexFormat.m_bStreamableMips)
   {
-    return EZ_SUCCESS;
+    ezTexMipChain mipChain;
+    EZ_SUCCEED_OR_RETURN(mipChain.ReadHeader(stream));
+
+    ezUInt32 uiNumMipLevels = mipChain.GetNumMipLevels();
+
+    if (pStreamingTexture != nullptr)
+    {
+      uiNumMipLevels = ezTextureStreaming::GetNumMipLevelsToLoad(pStreamingTexture, mipChain.m_Header);
+
+      data.m_uiStreamableMipLevels = static_cast<ezUInt8>(mipChain.GetNumMipLevels());
+      data.m_uiStreamableWidth = mipChain.m_Header.GetWidth();
+      data.m_uiStreamableHeight = mipChain.m_Header.GetHeight();
+    }
+
+    return mipChain.ReadMipLevels(stream, uiNumMipLevels, data.m_Image);
   }
+
+  ezDdsFileFormat fmt;
+  return fmt.ReadImage(stream, data.m_Image, ezLog::GetThreadLocalLogSystem(), "dds");
 }
 
 void ezTextureResourceLoader::WriteTextureLoadStream(ezStreamWriter& w, const LoadedData& data)
@@ -215,6 +241,13 @@ void ezTextureResourceLoader::WriteTextureLoadStream(ezStreamWriter& w, const Lo
 
   w << data.m_bIsFallback;
   data.m_TexFormat.WriteRenderTargetHeader(w);
+
+  w << data.m_uiStreamableMipLevels;
+  if (data.m_uiStreamableMipLevels > 0)
+  {
+    w << data.m_uiStreamableWidth;
+    w << data.m_uiStreamableHeight;
+  }
 }
 
 EZ_STATICLINK_FILE(RendererCore, RendererCore_Textures_TextureLoader);
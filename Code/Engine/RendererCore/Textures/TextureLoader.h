@@ -8,6 +8,8 @@
 #include <Texture/Image/Image.h>
 #include <Texture/ezTexFormat/ezTexFormat.h>
 
+class ezTexture2DResource;
+
 class EZ_RENDERERCORE_DLL ezTextureResourceLoader : public ezResourceTypeLoader
 {
 public:
@@ -24,12 +26,21 @@ public:
 
     bool m_bIsFallback = false;
     ezTexFormat m_TexFormat;
+
+    /// Number of mip levels and resolution of the full texture, if only some of its mips were read for streaming. Zero otherwise.
+    ezUInt8 m_uiStreamableMipLevels = 0;
+    ezUInt32 m_uiStreamableWidth = 0;
+    ezUInt32 m_uiStreamableHeight = 0;
   };
 
   virtual ezResourceLoadData OpenDataStream(const ezResource* pResource) override;
   virtual void CloseDataStream(const ezResource* pResource, const ezResourceLoadData& LoaderData) override;
   virtual bool IsResourceOutdated(const ezResource* pResource) const override;
 
-  static ezResult LoadTexFile(ezStreamReader& stream, LoadedData& data);
+  /// \brief Reads an ezTexture file into \a data.
+  ///
+  /// If \a pStreamingTexture is given and the file stores its mips with an ezTexMipChain, only as many mips are read as
+  /// ezTextureStreaming wants to have resident for that texture. Otherwise the whole texture is read.
+  static ezResult LoadTexFile(ezStreamReader& stream, LoadedData& data, const ezTexture2DResource* pStreamingTexture = nullptr);
   static void WriteTextureLoadStream(ezStreamWriter& stream, const LoadedData& data);
 };
@@ -0,0 +1,297 @@
+#include <RendererCore/RendererCorePCH.h>
+
+#include <Core/ResourceManager/ResourceManager.h>
+#include <Foundation/Configuration/CVar.h>
+#include <Foundation/Profiling/Profiling.h>
+#include <Foundation/Utilities/Stats.h>
+#include <RendererCore/RenderWorld/RenderWorld.h>
+#include <RendererCore/Textures/TextureStreaming.h>
+#include <RendererCore/Textures/TextureUtils.h>
+#include <Texture/Image/ImageHeader.h>
+
+ezCVarBool cvar_StreamingTextureStreaming("Streaming.TextureStreaming", true, ezCVarFlags::Save, "Whether textures stream in their mipmaps depending on their screen size");
+ezCVarInt cvar_StreamingTextureBudget("Streaming.TextureBudget", 1024, ezCVarFlags::Save, "GPU memory budget in MB for streamed texture mipmaps");
+ezCVarInt cvar_StreamingTextureMipTailSize("Streaming.TextureMipTailSize", 64, ezCVarFlags::Save, "Texture mipmaps up to this resolution are always resident");
+ezCVarFloat cvar_StreamingTextureKeepTime("Streaming.TextureKeepTime", 2.0f, ezCVarFlags::Save, "Seconds that texture mipmaps stay resident after they are not needed anymore");
+
+// clang-format off
+EZ_BEGIN_SUBSYSTEM_DECLARATION(RendererCore, TextureStreaming)
+
+  BEGIN_SUBSYSTEM_DEPENDENCIES
+    "Foundation",
+    "Core"
+  END_SUBSYSTEM_DEPENDENCIES
+
+  ON_HIGHLEVELSYSTEMS_STARTUP
+  {
+    ezTextureStreaming::OnEngineStartup();
+  }
+
+  ON_HIGHLEVELSYSTEMS_SHUTDOWN
+  {
+    ezTextureStreaming::OnEngineShutdown();
+  }
+
+EZ_END_SUBSYSTEM_DECLARATION;
+// clang-format on
+
+ezMutex ezTextureStreaming::s_Mutex;
+ezDynamicArray<ezTextureStreaming::TextureEntry> ezTextureStreaming::s_Textures;
+ezTextureStreaming::Statistics ezTextureStreaming::s_LastFrameStatistics;
+
+// static
+bool ezTextureStreaming::IsEnabled()
+{
+  return cvar_StreamingTextureStreaming && !ezTextureUtils::s_bForceFullQualityAlways;
+}
+
+// static
+void ezTextureStreaming::RequestResolution(ezTexture2DResource* pTexture, float fScreenSize)
+{
+  // zero means 'not requested', so every request asks for at least one pixel
+  pTexture->m_iStreamingRequestedSize.Max(ezMath::Max(static_cast<ezInt32>(ezMath::Min(fScreenSize, 65536.0f)), 1));
+}
+
+// static
+void ezTextureStreaming::RequestResolution(const ezTexture2DResourceHandle& hTexture, float fScreenSize)
+{
+  if (!hTexture.IsValid())
+    return;
+
+  ezResourceLock<ezTexture2DResource> pTexture(hTexture, ezResourceAcquireMode::PointerOnly);
+  RequestResolution(pTexture.GetPointer(), fScreenSize);
+}
+
+// static
+ezUInt32 ezTextureStreaming::GetNumMipLevelsToLoad(const ezTexture2DResource* pTexture, const ezImageHeader& header)
+{
+  const ezUInt32 uiNumMipLevels = header.GetNumMipLevels();
+
+  if (!IsEnabled())
+    return uiNumMipLevels;
+
+  // as long as Update() has not decided on a target, only the mip tail is loaded
+  const ezInt32 iTargetMipLevels = pTexture->m_iStreamingTargetMipLevels;
+  if (iTargetMipLevels <= 0)
+    return ComputeNumMipTailLevels(header);
+
+  return ezMath::Min(static_cast<ezUInt32>(iTargetMipLevels), uiNumMipLevels);
+}
+
+// static
+ezUInt32 ezTextureStreaming::ComputeNumMipTailLevels(const ezImageHeader& header)
+{
+  const ezUInt32 uiMipTailSize = static_cast<ezUInt32>(ezMath::Max<int>(cvar_StreamingTextureMipTailSize, 1));
+
+  ezUInt32 uiNumMipLevels = 0;
+  for (ezUInt32 mip = header.GetNumMipLevels(); mip > 0; --mip)
+  {
+    if (ezMath::Max(header.GetWidth(mip - 1), header.GetHeight(mip - 1)) > uiMipTailSize)
+      break;
+
+    ++uiNumMipLevels;
+  }
+
+  return ezMath::Max(uiNumMipLevels, 1u);
+}
+
+// static
+void ezTextureStreaming::OnEngineStartup()
+{
+  ezRenderWorld::GetRenderEvent().AddEventHandler(&ezTextureStreaming::OnRenderEvent);
+}
+
+// static
+void ezTextureStreaming::OnEngineShutdown()
+{
+  ezRenderWorld::GetRenderEvent().RemoveEventHandler(&ezTextureStreaming::OnRenderEvent);
+
+  EZ_LOCK(s_Mutex);
+  s_Textures.Clear();
+  s_Textures.Compact();
+}
+
+// static
+void ezTextureStreaming::OnRenderEvent(const ezRenderWorldRenderEvent& e)
+{
+  if (e.m_Type != ezRenderWorldRenderEvent::Type::EndRender)
+    return;
+
+  Update();
+
+  ezStats::SetStat("Streaming/Textures/ResidentMemory", s_LastFrameStatistics.m_uiResidentMemory);
+  ezStats::SetStat("Streaming/Textures/RequestedMemory", s_LastFrameStatistics.m_uiRequestedMemory);
+  ezStats::SetStat("Streaming/Textures/TargetMemory", s_LastFrameStatistics.m_uiTargetMemory);
+  ezStats::SetStat("Streaming/Textures/Budget", s_LastFrameStatistics.m_uiBudget);
+  ezStats::SetStat("Streaming/Textures/NumTextures", s_LastFrameStatistics.m_uiNumTextures);
+  ezStats::SetStat("Streaming/Textures/NumPending", s_LastFrameStatistics.m_uiNumPending);
+  ezStats::SetStat("Streaming/Textures/MipBias", s_LastFrameStatistics.m_uiMipBias);
+}
+
+// static
+void ezTextureStreaming::RegisterTexture(ezTexture2DResource* pTexture, const ezImageHeader& header, ezUInt32 uiResidentMipLevels)
+{
+  EZ_LOCK(s_Mutex);
+
+  if (pTexture->m_uiStreamingIndex != ezInvalidIndex)
+  {
+    s_Textures[pTexture->m_uiStreamingIndex].m_uiResidentMipLevels = static_cast<ezUInt8>(uiResidentMipLevels);
+    return;
+  }
+
+  pTexture->m_uiStreamingIndex = s_Textures.GetCount();
+
+  TextureEntry& entry = s_Textures.ExpandAndGetRef();
+  entry.m_pTexture = pTexture;
+  entry.m_uiNumMipLevels = static_cast<ezUInt8>(header.GetNumMipLevels());
+  entry.m_uiNumMipTailLevels = static_cast<ezUInt8>(ComputeNumMipTailLevels(header));
+  entry.m_uiRequestedMipLevels = entry.m_uiNumMipTailLevels;
+  entry.m_uiResidentMipLevels = static_cast<ezUInt8>(uiResidentMipLevels);
+  entry.m_uiMaxSize = ezMath::Max(header.GetWidth(), header.GetHeight());
+  entry.m_RegisterTime = ezTime::Now();
+
+  ezUInt64 uiMemory = 0;
+  for (ezUInt32 mip = header.GetNumMipLevels(); mip > 0; --mip)
+  {
+    uiMemory += header.GetDepthPitch(mip - 1);
+    entry.m_MemoryForMipLevels.PushBack(uiMemory);
+  }
+}
+
+// static
+void ezTextureStreaming::UnregisterTexture(ezTexture2DResource* pTexture)
+{
+  EZ_LOCK(s_Mutex);
+
+  const ezUInt32 uiIndex = pTexture->m_uiStreamingIndex;
+  if (uiIndex == ezInvalidIndex)
+    return;
+
+  s_Textures.RemoveAtAndSwap(uiIndex);
+
+  if (uiIndex < s_Textures.GetCount())
+  {
+    s_Textures[uiIndex].m_pTexture->m_uiStreamingIndex = uiIndex;
+  }
+
+  pTexture->m_uiStreamingIndex = ezInvalidIndex;
+}
+
+// static
+ezUInt8 ezTextureStreaming::ComputeNumMipLevelsForSize(const TextureEntry& entry, ezUInt32 uiScreenSize)
+{
+  // drop every mip that is still at least as large as the geometry on screen
+  ezUInt32 uiDroppedMipLevels = 0;
+  while (uiDroppedMipLevels + 1 < entry.m_uiNumMipLevels && (entry.m_uiMaxSize >> (uiDroppedMipLevels + 1)) >= uiScreenSize)
+  {
+    ++uiDroppedMipLevels;
+  }
+
+  return static_cast<ezUInt8>(ezMath::Max<ezUInt32>(entry.m_uiNumMipLevels - uiDroppedMipLevels, entry.m_uiNumMipTailLevels));
+}
+
+// static
+ezUInt8 ezTextureStreaming::ComputeTargetMipLevels(const TextureEntry& entry, ezUInt32 uiMipBias)
+{
+  if (entry.m_uiRequestedMipLevels <= entry.m_uiNumMipTailLevels + uiMipBias)
+    return entry.m_uiNumMipTailLevels;
+
+  return static_cast<ezUInt8>(entry.m_uiRequestedMipLevels - uiMipBias);
+}
+
+// static
+void ezTextureStreaming::Update()
+{
+  EZ_PROFILE_SCOPE("TextureStreaming");
+
+  // same lock order as ezTexture2DResource::UnloadData(), which is called with the resource manager mutex held
+  EZ_LOCK(ezResourceManager::GetMutex());
+  EZ_LOCK(s_Mutex);
+
+  const ezTime tNow = ezTime::Now();
+  const ezTime tKeep = ezTime::Seconds(ezMath::Max(cvar_StreamingTextureKeepTime.GetValue(), 0.0f));
+  const bool bEnabled = IsEnabled();
+
+  Statistics stats;
+  stats.m_uiBudget = static_cast<ezUInt64>(ezMath::Max<int>(cvar_StreamingTextureBudget, 0)) * 1024 * 1024;
+  stats.m_uiNumTextures = s_Textures.GetCount();
+
+  for (TextureEntry& entry : s_Textures)
+  {
+    const ezUInt32 uiRequestedSize = static_cast<ezUInt32>(entry.m_pTexture->m_iStreamingRequestedSize.Set(0));
+
+    ezUInt8 uiWantedMipLevels = entry.m_uiRequestedMipLevels;
+
+    if (!bEnabled)
+    {
+      uiWantedMipLevels = entry.m_uiNumMipLevels;
+    }
+    else if (uiRequestedSize > 0)
+    {
+      entry.m_LastRequestTime = tNow;
+      uiWantedMipLevels = ComputeNumMipLevelsForSize(entry, uiRequestedSize);
+    }
+    else if (entry.m_LastRequestTime.IsZero())
+    {
+      // nothing that reports its screen size uses this texture, so there is no way to tell which resolution it needs
+      if (tNow - entry.m_RegisterTime > ezTime::Seconds(0.5))
+      {
+        uiWantedMipLevels = entry.m_uiNumMipLevels;
+      }
+    }
+    else if (tNow - entry.m_LastRequestTime > tKeep)
+    {
+      uiWantedMipLevels = entry.m_uiNumMipTailLevels;
+    }
+
+    // mips are added right away, but only removed once they have not been needed for a while
+    if (uiWantedMipLevels >= entry.m_uiRequestedMipLevels)
+    {
+      entry.m_uiRequestedMipLevels = uiWantedMipLevels;
+      entry.m_LastIncreaseTime = tNow;
+    }
+    else if (tNow - entry.m_LastIncreaseTime > tKeep)
+    {
+      entry.m_uiRequestedMipLevels = uiWantedMipLevels;
+    }
+
+    stats.m_uiRequestedMemory += entry.m_MemoryForMipLevels[entry.m_uiRequestedMipLevels - 1];
+    stats.m_uiResidentMemory += entry.m_uiResidentMipLevels > 0 ? entry.m_MemoryForMipLevels[entry.m_uiResidentMipLevels - 1] : 0;
+  }
+
+  // drop the same number of top mips from all textures until everything fits into the budget
+  stats.m_uiTargetMemory = stats.m_uiRequestedMemory;
+
+  while (stats.m_uiTargetMemory > stats.m_uiBudget && stats.m_uiMipBias < 16)
+  {
+    ++stats.m_uiMipBias;
+
+    stats.m_uiTargetMemory = 0;
+    for (const TextureEntry& entry : s_Textures)
+    {
+      stats.m_uiTargetMemory += entry.m_MemoryForMipLevels[ComputeTargetMipLevels(entry, stats.m_uiMipBias) - 1];
+    }
+  }
+
+  for (const TextureEntry& entry : s_Textures)
+  {
+    const ezUInt8 uiTargetMipLevels = ComputeTargetMipLevels(entry, stats.m_uiMipBias);
+
+    entry.m_pTexture->m_iStreamingTargetMipLevels = uiTargetMipLevels;
+
+    if (uiTargetMipLevels != entry.m_uiResidentMipLevels)
+    {
+      ++stats.m_uiNumPending;
+
+      // while the resource still reports loadable data, it is already queued or being updated and will pick up the new target
+      if (entry.m_pTexture->GetNumQualityLevelsLoadable() == 0)
+      {
+        entry.m_pTexture->RequestQualityLevelLoad();
+      }
+    }
+  }
+
+  s_LastFrameStatistics = stats;
+}
+
+EZ_STATICLINK_FILE(RendererCore, RendererCore_Textures_TextureStreaming);
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <Foundation/Configuration/Startup.h>
+#include <Foundation/Containers/DynamicArray.h>
+#include <Foundation/Containers/HybridArray.h>
+#include <Foundation/Threading/Mutex.h>
+#include <Foundation/Time/Time.h>
+#include <RendererCore/Textures/Texture2DResource.h>
+
+class ezImageHeader;
+struct ezRenderWorldRenderEvent;
+
+/// \brief Decides how many mipmaps of every streamable 2D texture should be resident on the GPU.
+///
+/// Textures that are stored with an ezTexMipChain only load their mip tail at first (all mips up to 'Streaming.TextureMipTailSize').
+/// While rendering, every draw call reports the screen size of its geometry for the bound textures via RequestResolution().
+/// Once per frame, the requests are turned into a target number of mips per texture, which the texture resources then
+/// stream in or evict through the resource manager.
+///
+/// If the targets of all textures together need more memory than 'Streaming.TextureBudget' allows, the top mips of all textures
+/// are dropped equally (the mip bias), until everything fits. The mip tails always stay resident, even if they alone exceed the budget.
+///
+/// Textures that are never requested by a draw call (e.g. used by UI or with custom renderers) are streamed in fully.
+class EZ_RENDERERCORE_DLL ezTextureStreaming
+{
+public:
+  struct Statistics
+  {
+    ezUInt64 m_uiResidentMemory = 0;  ///< GPU memory of all mips that are currently resident.
+    ezUInt64 m_uiRequestedMemory = 0; ///< GPU memory that all textures would need to have their requested mips resident.
+    ezUInt64 m_uiTargetMemory = 0;    ///< GPU memory of the mips that are targeted after applying the budget.
+    ezUInt64 m_uiBudget = 0;          ///< The memory budget in bytes.
+    ezUInt32 m_uiNumTextures = 0;     ///< Number of textures that are streamed.
+    ezUInt32 m_uiNumPending = 0;      ///< Number of textures whose resident mips differ from their target.
+    ezUInt32 m_uiMipBias = 0;         ///< How many top mips are currently dropped from all textures to stay within the budget.
+  };
+
+  /// \brief Returns whether texture streaming is enabled. Controlled by the cvar 'Streaming.TextureStreaming'.
+  static bool IsEnabled();
+
+  /// \brief Reports that the texture is used for geometry that covers about \a fScreenSize pixels on screen.
+  ///
+  /// Can be called from any thread. The largest request per frame determines the resolution of the texture.
+  static void RequestResolution(ezTexture2DResource* pTexture, float fScreenSize);
+  static void RequestResolution(const ezTexture2DResourceHandle& hTexture, float fScreenSize);
+
+  /// \brief Returns how many mips should be loaded for a texture with the given full resolution header.
+  static ezUInt32 GetNumMipLevelsToLoad(const ezTexture2DResource* pTexture, const ezImageHeader& header);
+
+  /// \brief Returns the number of mips that always stay resident for a texture with the given full resolution header.
+  static ezUInt32 ComputeNumMipTailLevels(const ezImageHeader& header);
+
+  /// \brief Returns the statistics of the last frame. The values are also published as ezStats under 'Streaming/Textures'.
+  static const Statistics& GetStatistics() { return s_LastFrameStatistics; }
+
+private:
+  friend class ezTexture2DResource;
+  EZ_MAKE_SUBSYSTEM_STARTUP_FRIEND(RendererCore, TextureStreaming);
+
+  struct TextureEntry
+  {
+    ezTexture2DResource* m_pTexture = nullptr;
+    ezUInt8 m_uiNumMipLevels = 0;
+    ezUInt8 m_uiNumMipTailLevels = 0;
+    ezUInt8 m_uiRequestedMipLevels = 0;
+    ezUInt8 m_uiResidentMipLevels = 0;
+    ezUInt32 m_uiMaxSize = 0;
+    ezTime m_RegisterTime;
+    ezTime m_LastRequestTime;
+    ezTime m_LastIncreaseTime;
+    ezHybridArray<ezUInt64, 16> m_MemoryForMipLevels; ///< Index i holds the memory of the (i + 1) smallest mips.
+  };
+
+  static void OnEngineStartup();
+  static void OnEngineShutdown();
+  static void OnRenderEvent(const ezRenderWorldRenderEvent& e);
+
+  static void RegisterTexture(ezTexture2DResource* pTexture, const ezImageHeader& header, ezUInt32 uiResidentMipLevels);
+  static void UnregisterTexture(ezTexture2DResource* pTexture);
+  static void Update();
+
+  static ezUInt8 ComputeNumMipLevelsForSize(const TextureEntry& entry, ezUInt32 uiScreenSize);
+  static ezUInt8 ComputeTargetMipLevels(const TextureEntry& entry, ezUInt32 uiMipBias);
+
+  static ezMutex s_Mutex;
+  static ezDynamicArray<TextureEntry> s_Textures;
+  static Statistics s_LastFrameStatistics;
+};
@@ -80,6 +80,7 @@ public:
 
 protected:
   friend class ezGALDevice;
+  friend class ezGALCommandRecorder;
 
   ezGALCommandEncoder(ezGALDevice& device, ezGALCommandEncoderState& state, ezGALCommandEncoderCommonPlatformInterface& commonImpl);
   virtual ~ezGALCommandEncoder();
@@ -89,7 +90,7 @@ protected:
 
   void AssertRenderingThread()
   {
-    EZ_ASSERT_DEV(ezThreadUtils::IsMainThread(), "This function can only be executed on the main thread.");
+    EZ_ASSERT_DEV(m_bIsRecording || ezThreadUtils::IsMainThread(), "This function can only be executed on the main thread.");
   }
 
   void CountStateChange() { m_uiStateChanges++; }
@@ -108,4 +109,7 @@ private:
   ezGALCommandEncoderState& m_State;
 
   ezGALCommandEncoderCommonPlatformInterface& m_CommonImpl;
+
+  // Encoders owned by an ezGALCommandRecorder only record commands and can therefore be used on any thread.
+  bool m_bIsRecording = false;
 };
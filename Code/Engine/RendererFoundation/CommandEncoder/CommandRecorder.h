@@ -0,0 +1,218 @@
+
+#pragma once
+
+#include <Foundation/Containers/DynamicArray.h>
+#include <RendererFoundation/CommandEncoder/CommandEncoderPlatformInterface.h>
+#include <RendererFoundation/CommandEncoder/CommandEncoderState.h>
+#include <RendererFoundation/CommandEncoder/ComputeCommandEncoder.h>
+#include <RendererFoundation/CommandEncoder/RenderCommandEncoder.h>
+
+/// \brief Records GAL commands into a linear command stream instead of executing them, so that they can be replayed later.
+///
+/// Command recorders allow GAL commands to be recorded in parallel on different threads.
+/// Each thread uses its own recorder through GetRenderCommandEncoder() or GetComputeCommandEncoder(). Afterwards the recorders are replayed
+/// on the rendering thread into the real command encoder in a fixed order, which makes the submitted command stream independent of
+/// the order in which the recording tasks finished.
+///
+/// The recorder implements the platform interfaces, so all redundant state filtering of ezGALCommandEncoder also happens during recording.
+/// Functions that need an immediate result from the GPU (fence and query results, readback results) and texture updates
+/// are not supported while recording.
+///
+/// Recording only reads GAL objects, so no GAL objects may be destroyed while recording tasks are running.
+class EZ_RENDERERFOUNDATION_DLL ezGALCommandRecorder : public ezGALCommandEncoderCommonPlatformInterface, public ezGALCommandEncoderRenderPlatformInterface, public ezGALCommandEncoderComputePlatformInterface
+{
+  EZ_DISALLOW_COPY_AND_ASSIGN(ezGALCommandRecorder);
+
+public:
+  ezGALCommandRecorder(ezGALDevice& device);
+  ~ezGALCommandRecorder();
+
+  /// \brief Returns a render command encoder that records into this recorder. The encoder may be used on any thread.
+  ezGALRenderCommandEncoder* GetRenderCommandEncoder() { return &m_RenderCommandEncoder; }
+
+  /// \brief Returns a compute command encoder that records into this recorder. The encoder may be used on any thread.
+  ezGALComputeCommandEncoder* GetComputeCommandEncoder() { return &m_ComputeCommandEncoder; }
+
+  /// \brief Removes all recorded commands and resets the state of the recording encoders. Keeps the allocated memory.
+  void Reset();
+
+  /// \brief Returns the number of recorded commands.
+  ezUInt32 GetCommandCount() const { return m_uiCommandCount; }
+
+  /// \brief Returns the raw recorded command stream. Two recorders that recorded the same sequence of commands have identical streams.
+  ezArrayPtr<const ezUInt8> GetCommandStream() const { return m_CommandStream.GetArrayPtr().ToByteArray().GetSubArray(0, m_uiStreamSize); }
+
+  /// \brief Replays all recorded commands into the given render command encoder.
+  ///
+  /// The state cache of the target encoder is invalidated afterwards since the replayed commands bypass it.
+  void Replay(ezGALRenderCommandEncoder* pTarget) const;
+
+  /// \brief Replays all recorded commands into the given compute command encoder. The recording must not contain draw commands.
+  void Replay(ezGALComputeCommandEncoder* pTarget) const;
+
+  /// \brief Replays all recorded commands directly into the given platform implementations. Mostly useful for tests and for chaining recorders.
+  void Replay(ezGALCommandEncoderCommonPlatformInterface& commonImpl, ezGALCommandEncoderRenderPlatformInterface* pRenderImpl, ezGALCommandEncoderComputePlatformInterface* pComputeImpl) const;
+
+  // ezGALCommandEncoderCommonPlatformInterface
+
+  virtual void SetShaderPlatform(const ezGALShader* pShader) override;
+
+  virtual void SetConstantBufferPlatform(ezUInt32 uiSlot, const ezGALBuffer* pBuffer) override;
+  virtual void SetSamplerStatePlatform(ezGALShaderStage::Enum Stage, ezUInt32 uiSlot, const ezGALSamplerState* pSamplerState) override;
+  virtual void SetResourceViewPlatform(ezGALShaderStage::Enum Stage, ezUInt32 uiSlot, const ezGALResourceView* pResourceView) override;
+  virtual void SetUnorderedAccessViewPlatform(ezUInt32 uiSlot, const ezGALUnorderedAccessView* pUnorderedAccessView) override;
+
+  virtual void InsertFencePlatform(const ezGALFence* pFence) override;
+  virtual bool IsFenceReachedPlatform(const ezGALFence* pFence) override;
+  virtual void WaitForFencePlatform(const ezGALFence* pFence) override;
+
+  virtual void BeginQueryPlatform(const ezGALQuery* pQuery) override;
+  virtual void EndQueryPlatform(const ezGALQuery* pQuery) override;
+  virtual ezResult GetQueryResultPlatform(const ezGALQuery* pQuery, ezUInt64& uiQueryResult) override;
+
+  virtual void InsertTimestampPlatform(ezGALTimestampHandle hTimestamp) override;
+
+  virtual void ClearUnorderedAccessViewPlatform(const ezGALUnorderedAccessView* pUnorderedAccessView, ezVec4 clearValues) override;
+  virtual void ClearUnorderedAccessViewPlatform(const ezGALUnorderedAccessView* pUnorderedAccessView, ezVec4U32 clearValues) override;
+
+  virtual void CopyBufferPlatform(const ezGALBuffer* pDestination, const ezGALBuffer* pSource) override;
+  virtual void CopyBufferRegionPlatform(const ezGALBuffer* pDestination, ezUInt32 uiDestOffset, const ezGALBuffer* pSource, ezUInt32 uiSourceOffset, ezUInt32 uiByteCount) override;
+
+  virtual void UpdateBufferPlatform(const ezGALBuffer* pDestination, ezUInt32 uiDestOffset, ezArrayPtr<const ezUInt8> pSourceData, ezGALUpdateMode::Enum updateMode) override;
+
+  virtual void CopyTexturePlatform(const ezGALTexture* pDestination, const ezGALTexture* pSource) override;
+  virtual void CopyTextureRegionPlatform(const ezGALTexture* pDestination, const ezGALTextureSubresource& DestinationSubResource, const ezVec3U32& DestinationPoint, const ezGALTexture* pSource, const ezGALTextureSubresource& SourceSubResource, const ezBoundingBoxu32& Box) override;
+
+  virtual void UpdateTexturePlatform(const ezGALTexture* pDestination, const ezGALTextureSubresource& DestinationSubResource, const ezBoundingBoxu32& DestinationBox, const ezGALSystemMemoryDescription& pSourceData) override;
+
+  virtual void ResolveTexturePlatform(const ezGALTexture* pDestination, const ezGALTextureSubresource& DestinationSubResource, const ezGALTexture* pSource, const ezGALTextureSubresource& SourceSubResource) override;
+
+  virtual void ReadbackTexturePlatform(const ezGALTexture* pTexture) override;
+
+  virtual void CopyTextureReadbackResultPlatform(const ezGALTexture* pTexture, ezArrayPtr<ezGALTextureSubresource> SourceSubResource, ezArrayPtr<ezGALSystemMemoryDescription> TargetData) override;
+
+  virtual void GenerateMipMapsPlatform(const ezGALResourceView* pResourceView) override;
+
+  virtual void FlushPlatform() override;
+
+  virtual void PushMarkerPlatform(const char* Marker) override;
+  virtual void PopMarkerPlatform() override;
+  virtual void InsertEventMarkerPlatform(const char* Marker) override;
+
+  // ezGALCommandEncoderRenderPlatformInterface
+
+  virtual void ClearPlatform(const ezColor& ClearColor, ezUInt32 uiRenderTargetClearMask, bool bClearDepth, bool bClearStencil, float fDepthClear, ezUInt8 uiStencilClear) override;
+
+  virtual void DrawPlatform(ezUInt32 uiVertexCount, ezUInt32 uiStartVertex) override;
+  virtual void DrawIndexedPlatform(ezUInt32 uiIndexCount, ezUInt32 uiStartIndex) override;
+  virtual void DrawIndexedInstancedPlatform(ezUInt32 uiIndexCountPerInstance, ezUInt32 uiInstanceCount, ezUInt32 uiStartIndex) override;
+  virtual void DrawIndexedInstancedIndirectPlatform(const ezGALBuffer* pIndirectArgumentBuffer, ezUInt32 uiArgumentOffsetInBytes) override;
+  virtual void DrawInstancedPlatform(ezUInt32 uiVertexCountPerInstance, ezUInt32 uiInstanceCount, ezUInt32 uiStartVertex) override;
+  virtual void DrawInstancedIndirectPlatform(const ezGALBuffer* pIndirectArgumentBuffer, ezUInt32 uiArgumentOffsetInBytes) override;
+  virtual void DrawAutoPlatform() override;
+
+  virtual void BeginStreamOutPlatform() override;
+  virtual void EndStreamOutPlatform() override;
+
+  virtual void SetIndexBufferPlatform(const ezGALBuffer* pIndexBuffer) override;
+  virtual void SetVertexBufferPlatform(ezUInt32 uiSlot, const ezGALBuffer* pVertexBuffer) override;
+  virtual void SetVertexDeclarationPlatform(const ezGALVertexDeclaration* pVertexDeclaration) override;
+  virtual void SetPrimitiveTopologyPlatform(ezGALPrimitiveTopology::Enum Topology) override;
+
+  virtual void SetBlendStatePlatform(const ezGALBlendState* pBlendState, const ezColor& BlendFactor, ezUInt32 uiSampleMask) override;
+  virtual void SetDepthStencilStatePlatform(const ezGALDepthStencilState* pDepthStencilState, ezUInt8 uiStencilRefValue) override;
+  virtual void SetRasterizerStatePlatform(const ezGALRasterizerState* pRasterizerState) override;
+
+  virtual void SetViewportPlatform(const ezRectFloat& rect, float fMinDepth, float fMaxDepth) override;
+  virtual void SetScissorRectPlatform(const ezRectU32& rect) override;
+
+  virtual void SetStreamOutBufferPlatform(ezUInt32 uiSlot, const ezGALBuffer* pBuffer, ezUInt32 uiOffset) override;
+
+  // ezGALCommandEncoderComputePlatformInterface
+
+  virtual void DispatchPlatform(ezUInt32 uiThreadGroupCountX, ezUInt32 uiThreadGroupCountY, ezUInt32 uiThreadGroupCountZ) override;
+  virtual void DispatchIndirectPlatform(const ezGALBuffer* pIndirectArgumentBuffer, ezUInt32 uiArgumentOffsetInBytes) override;
+
+private:
+  struct CommandType
+  {
+    enum Enum : ezUInt8
+    {
+      SetShader,
+      SetConstantBuffer,
+      SetSamplerState,
+      SetResourceView,
+      SetUnorderedAccessView,
+      InsertFence,
+      BeginQuery,
+      EndQuery,
+      InsertTimestamp,
+      ClearUnorderedAccessViewFloat,
+      ClearUnorderedAccessViewUInt,
+      CopyBuffer,
+      CopyBufferRegion,
+      UpdateBuffer,
+      CopyTexture,
+      CopyTextureRegion,
+      ResolveTexture,
+      ReadbackTexture,
+      GenerateMipMaps,
+      Flush,
+      PushMarker,
+      PopMarker,
+      InsertEventMarker,
+      Clear,
+      Draw,
+      DrawIndexed,
+      DrawIndexedInstanced,
+      DrawIndexedInstancedIndirect,
+      DrawInstanced,
+      DrawInstancedIndirect,
+      DrawAuto,
+      BeginStreamOut,
+      EndStreamOut,
+      SetIndexBuffer,
+      SetVertexBuffer,
+      SetVertexDeclaration,
+      SetPrimitiveTopology,
+      SetBlendState,
+      SetDepthStencilState,
+      SetRasterizerState,
+      SetViewport,
+      SetScissorRect,
+      SetStreamOutBuffer,
+      Dispatch,
+      DispatchIndirect,
+    };
+  };
+
+  // The stream is stored in 16 byte blocks so that buffer update data inside the stream can be kept 16 byte aligned.
+  struct EZ_ALIGN_16(StreamBlock)
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezUInt8 m_Data[16];
+  };
+
+  class Reader;
+
+  void BeginCommand(CommandType::Enum type);
+  void WriteBytes(const void* pData, ezUInt32 uiSize);
+  ezUInt32 WriteAlignedBytes(const void* pData, ezUInt32 uiSize);
+  void WriteString(const char* szString);
+
+  template <typename T>
+  EZ_ALWAYS_INLINE void Write(const T& value)
+  {
+    WriteBytes(&value, sizeof(T));
+  }
+
+  ezDynamicArray<StreamBlock, ezAlignedAllocatorWrapper> m_CommandStream;
+  ezUInt32 m_uiStreamSize = 0;
+  ezUInt32 m_uiCommandCount = 0;
+
+  ezGALCommandEncoderRenderState m_RenderState;
+  ezGALCommandEncoderState m_ComputeState;
+  ezGALRenderCommandEncoder m_RenderCommandEncoder;
+  ezGALComputeCommandEncoder m_ComputeCommandEncoder;
+};
@@ -17,6 +17,8 @@ public:
   virtual void ClearStatisticsCounters() override;
 
 private:
+  friend class ezGALCommandRecorder;
+
   void CountDispatchCall() { m_uiDispatchCalls++; }
 
   // Statistic variables
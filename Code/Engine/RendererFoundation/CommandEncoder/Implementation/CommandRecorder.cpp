@@ -0,0 +1,776 @@
+#include <RendererFoundation/RendererFoundationPCH.h>
+
+#include <RendererFoundation/CommandEncoder/CommandRecorder.h>
+#include <RendererFoundation/Device/Device.h>
+
+class ezGALCommandRecorder::Reader
+{
+public:
+  Reader(ezArrayPtr<const ezUInt8> stream)
+    : m_Stream(stream)
+  {
+  }
+
+  bool IsAtEnd() const { return m_uiOffset >= m_Stream.GetCount(); }
+
+  template <typename T>
+  T Read()
+  {
+    T value;
+    ezMemoryUtils::RawByteCopy(&value, m_Stream.GetPtr() + m_uiOffset, sizeof(T));
+    m_uiOffset += sizeof(T);
+    return value;
+  }
+
+  template <typename T>
+  const T* ReadPtr()
+  {
+    return reinterpret_cast<const T*>(Read<const void*>());
+  }
+
+  ezArrayPtr<const ezUInt8> ReadAlignedBytes()
+  {
+    const ezUInt32 uiSize = Read<ezUInt32>();
+    m_uiOffset = ezMemoryUtils::AlignSize(m_uiOffset, 16u);
+
+    ezArrayPtr<const ezUInt8> data = m_Stream.GetSubArray(m_uiOffset, uiSize);
+    m_uiOffset = ezMemoryUtils::AlignSize(m_uiOffset + uiSize, 16u);
+    return data;
+  }
+
+  const char* ReadString()
+  {
+    const ezUInt32 uiLength = Read<ezUInt32>();
+    const char* szString = reinterpret_cast<const char*>(m_Stream.GetPtr() + m_uiOffset);
+    m_uiOffset += uiLength + 1;
+    return szString;
+  }
+
+private:
+  ezArrayPtr<const ezUInt8> m_Stream;
+  ezUInt32 m_uiOffset = 0;
+};
+
+ezGALCommandRecorder::ezGALCommandRecorder(ezGALDevice& device)
+  : m_RenderCommandEncoder(device, m_RenderState, *this, *this)
+  , m_ComputeCommandEncoder(device, m_ComputeState, *this, *this)
+{
+  m_RenderCommandEncoder.m_bIsRecording = true;
+  m_ComputeCommandEncoder.m_bIsRecording = true;
+}
+
+ezGALCommandRecorder::~ezGALCommandRecorder() = default;
+
+void ezGALCommandRecorder::Reset()
+{
+  m_uiStreamSize = 0;
+  m_uiCommandCount = 0;
+
+  m_RenderCommandEncoder.InvalidateState();
+  m_ComputeCommandEncoder.InvalidateState();
+}
+
+void ezGALCommandRecorder::Replay(ezGALRenderCommandEncoder* pTarget) const
+{
+  Replay(pTarget->m_CommonImpl, &pTarget->m_RenderImpl, nullptr);
+
+  pTarget->InvalidateState();
+}
+
+void ezGALCommandRecorder::Replay(ezGALComputeCommandEncoder* pTarget) const
+{
+  Replay(pTarget->m_CommonImpl, nullptr, &pTarget->m_ComputeImpl);
+
+  pTarget->InvalidateState();
+}
+
+void ezGALCommandRecorder::Replay(ezGALCommandEncoderCommonPlatformInterface& commonImpl, ezGALCommandEncoderRenderPlatformInterface* pRenderImpl, ezGALCommandEncoderComputePlatformInterface* pComputeImpl) const
+{
+  Reader reader(GetCommandStream());
+
+  while (!reader.IsAtEnd())
+  {
+    const CommandType::Enum type = static_cast<CommandType::Enum>(reader.Read<ezUInt8>());
+
+    EZ_ASSERT_DEBUG(type < CommandType::Clear || type > CommandType::SetStreamOutBuffer || pRenderImpl != nullptr, "Recorded render commands can only be replayed into a render command encoder");
+    EZ_ASSERT_DEBUG(type < CommandType::Dispatch || pComputeImpl != nullptr, "Recorded compute commands can only be replayed into a compute command encoder");
+
+    switch (type)
+    {
+      case CommandType::SetShader:
+        commonImpl.SetShaderPlatform(reader.ReadPtr<ezGALShader>());
+        break;
+
+      case CommandType::SetConstantBuffer:
+      {
+        const ezUInt32 uiSlot = reader.Read<ezUInt32>();
+        commonImpl.SetConstantBufferPlatform(uiSlot, reader.ReadPtr<ezGALBuffer>());
+      }
+      break;
+
+      case CommandType::SetSamplerState:
+      {
+        const auto stage = static_cast<ezGALShaderStage::Enum>(reader.Read<ezUInt32>());
+        const ezUInt32 uiSlot = reader.Read<ezUInt32>();
+        commonImpl.SetSamplerStatePlatform(stage, uiSlot, reader.ReadPtr<ezGALSamplerState>());
+      }
+      break;
+
+      case CommandType::SetResourceView:
+      {
+        const auto stage = static_cast<ezGALShaderStage::Enum>(reader.Read<ezUInt32>());
+        const ezUInt32 uiSlot = reader.Read<ezUInt32>();
+        commonImpl.SetResourceViewPlatform(stage, uiSlot, reader.ReadPtr<ezGALResourceView>());
+      }
+      break;
+
+      case CommandType::SetUnorderedAccessView:
+      {
+        const ezUInt32 uiSlot = reader.Read<ezUInt32>();
+        commonImpl.SetUnorderedAccessViewPlatform(uiSlot, reader.ReadPtr<ezGALUnorderedAccessView>());
+      }
+      break;
+
+      case CommandType::InsertFence:
+        commonImpl.InsertFencePlatform(reader.ReadPtr<ezGALFence>());
+        break;
+
+      case CommandType::BeginQuery:
+        commonImpl.BeginQueryPlatform(reader.ReadPtr<ezGALQuery>());
+        break;
+
+      case CommandType::EndQuery:
+        commonImpl.EndQueryPlatform(reader.ReadPtr<ezGALQuery>());
+        break;
+
+      case CommandType::InsertTimestamp:
+        commonImpl.InsertTimestampPlatform(reader.Read<ezGALTimestampHandle>());
+        break;
+
+      case CommandType::ClearUnorderedAccessViewFloat:
+      {
+        const ezGALUnorderedAccessView* pView = reader.ReadPtr<ezGALUnorderedAccessView>();
+        commonImpl.ClearUnorderedAccessViewPlatform(pView, reader.Read<ezVec4>());
+      }
+      break;
+
+      case CommandType::ClearUnorderedAccessViewUInt:
+      {
+        const ezGALUnorderedAccessView* pView = reader.ReadPtr<ezGALUnorderedAccessView>();
+        commonImpl.ClearUnorderedAccessViewPlatform(pView, reader.Read<ezVec4U32>());
+      }
+      break;
+
+      case CommandType::CopyBuffer:
+      {
+        const ezGALBuffer* pDestination = reader.ReadPtr<ezGALBuffer>();
+        commonImpl.CopyBufferPlatform(pDestination, reader.ReadPtr<ezGALBuffer>());
+      }
+      break;
+
+      case CommandType::CopyBufferRegion:
+      {
+        const ezGALBuffer* pDestination = reader.ReadPtr<ezGALBuffer>();
+        const ezUInt32 uiDestOffset = reader.Read<ezUInt32>();
+        const ezGALBuffer* pSource = reader.ReadPtr<ezGALBuffer>();
+        const ezUInt32 uiSourceOffset = reader.Read<ezUInt32>();
+        commonImpl.CopyBufferRegionPlatform(pDestination, uiDestOffset, pSource, uiSourceOffset, reader.Read<ezUInt32>());
+      }
+      break;
+
+      case CommandType::UpdateBuffer:
+      {
+        const ezGALBuffer* pDestination = reader.ReadPtr<ezGALBuffer>();
+        const ezUInt32 uiDestOffset = reader.Read<ezUInt32>();
+        const auto updateMode = static_cast<ezGALUpdateMode::Enum>(reader.Read<ezUInt32>());
+        commonImpl.UpdateBufferPlatform(pDestination, uiDestOffset, reader.ReadAlignedBytes(), updateMode);
+      }
+      break;
+
+      case CommandType::CopyTexture:
+      {
+        const ezGALTexture* pDestination = reader.ReadPtr<ezGALTexture>();
+        commonImpl.CopyTexturePlatform(pDestination, reader.ReadPtr<ezGALTexture>());
+      }
+      break;
+
+      case CommandType::CopyTextureRegion:
+      {
+        const ezGALTexture* pDestination = reader.ReadPtr<ezGALTexture>();
+        const auto destSubResource = reader.Read<ezGALTextureSubresource>();
+        const auto destPoint = reader.Read<ezVec3U32>();
+        const ezGALTexture* pSource = reader.ReadPtr<ezGALTexture>();
+        const auto sourceSubResource = reader.Read<ezGALTextureSubresource>();
+        commonImpl.CopyTextureRegionPlatform(pDestination, destSubResource, destPoint, pSource, sourceSubResource, reader.Read<ezBoundingBoxu32>());
+      }
+      break;
+
+      case CommandType::ResolveTexture:
+      {
+        const ezGALTexture* pDestination = reader.ReadPtr<ezGALTexture>();
+        const auto destSubResource = reader.Read<ezGALTextureSubresource>();
+        const ezGALTexture* pSource = reader.ReadPtr<ezGALTexture>();
+        commonImpl.ResolveTexturePlatform(pDestination, destSubResource, pSource, reader.Read<ezGALTextureSubresource>());
+      }
+      break;
+
+      case CommandType::ReadbackTexture:
+        commonImpl.ReadbackTexturePlatform(reader.ReadPtr<ezGALTexture>());
+        break;
+
+      case CommandType::GenerateMipMaps:
+        commonImpl.GenerateMipMapsPlatform(reader.ReadPtr<ezGALResourceView>());
+        break;
+
+      case CommandType::Flush:
+        commonImpl.FlushPlatform();
+        break;
+
+      case CommandType::PushMarker:
+        commonImpl.PushMarkerPlatform(reader.ReadString());
+        break;
+
+      case CommandType::PopMarker:
+        commonImpl.PopMarkerPlatform();
+        break;
+
+      case CommandType::InsertEventMarker:
+        commonImpl.InsertEventMarkerPlatform(reader.ReadString());
+        break;
+
+      case CommandType::Clear:
+      {
+        const ezColor clearColor = reader.Read<ezColor>();
+        const ezUInt32 uiRenderTargetClearMask = reader.Read<ezUInt32>();
+        const ezUInt8 uiFlags = reader.Read<ezUInt8>();
+        const float fDepthClear = reader.Read<float>();
+        const ezUInt8 uiStencilClear = reader.Read<ezUInt8>();
+        pRenderImpl->ClearPlatform(clearColor, uiRenderTargetClearMask, (uiFlags & 1) != 0, (uiFlags & 2) != 0, fDepthClear, uiStencilClear);
+      }
+      break;
+
+      case CommandType::Draw:
+      {
+        const ezUInt32 uiVertexCount = reader.Read<ezUInt32>();
+        pRenderImpl->DrawPlatform(uiVertexCount, reader.Read<ezUInt32>());
+      }
+      break;
+
+      case CommandType::DrawIndexed:
+      {
+        const ezUInt32 uiIndexCount = reader.Read<ezUInt32>();
+        pRenderImpl->DrawIndexedPlatform(uiIndexCount, reader.Read<ezUInt32>());
+      }
+      break;
+
+      case CommandType::DrawIndexedInstanced:
+      {
+        const ezUInt32 uiIndexCountPerInstance = reader.Read<ezUInt32>();
+        const ezUInt32 uiInstanceCount = reader.Read<ezUInt32>();
+        pRenderImpl->DrawIndexedInstancedPlatform(uiIndexCountPerInstance, uiInstanceCount, reader.Read<ezUInt32>());
+      }
+      break;
+
+      case CommandType::DrawIndexedInstancedIndirect:
+      {
+        const ezGALBuffer* pBuffer = reader.ReadPtr<ezGALBuffer>();
+        pRenderImpl->DrawIndexedInstancedIndirectPlatform(pBuffer, reader.Read<ezUInt32>());
+      }
+      break;
+
+      case CommandType::DrawInstanced:
+      {
+        const ezUInt32 uiVertexCountPerInstance = reader.Read<ezUInt32>();
+        const ezUInt32 uiInstanceCount = reader.Read<ezUInt32>();
+        pRenderImpl->DrawInstancedPlatform(uiVertexCountPerInstance, uiInstanceCount, reader.Read<ezUInt32>());
+      }
+      break;
+
+      case CommandType::DrawInstancedIndirect:
+      {
+        const ezGALBuffer* pBuffer = reader.ReadPtr<ezGALBuffer>();
+        pRenderImpl->DrawInstancedIndirectPlatform(pBuffer, reader.Read<ezUInt32>());
+      }
+      break;
+
+      case CommandType::DrawAuto:
+        pRenderImpl->DrawAutoPlatform();
+        break;
+
+      case CommandType::BeginStreamOut:
+        pRenderImpl->BeginStreamOutPlatform();
+        break;
+
+      case CommandType::EndStreamOut:
+        pRenderImpl->EndStreamOutPlatform();
+        break;
+
+      case CommandType::SetIndexBuffer:
+        pRenderImpl->SetIndexBufferPlatform(reader.ReadPtr<ezGALBuffer>());
+        break;
+
+      case CommandType::SetVertexBuffer:
+      {
+        const ezUInt32 uiSlot = reader.Read<ezUInt32>();
+        pRenderImpl->SetVertexBufferPlatform(uiSlot, reader.ReadPtr<ezGALBuffer>());
+      }
+      break;
+
+      case CommandType::SetVertexDeclaration:
+        pRenderImpl->SetVertexDeclarationPlatform(reader.ReadPtr<ezGALVertexDeclaration>());
+        break;
+
+      case CommandType::SetPrimitiveTopology:
+        pRenderImpl->SetPrimitiveTopologyPlatform(static_cast<ezGALPrimitiveTopology::Enum>(reader.Read<ezUInt32>()));
+        break;
+
+      case CommandType::SetBlendState:
+      {
+        const ezGALBlendState* pBlendState = reader.ReadPtr<ezGALBlendState>();
+        const ezColor blendFactor = reader.Read<ezColor>();
+        pRenderImpl->SetBlendStatePlatform(pBlendState, blendFactor, reader.Read<ezUInt32>());
+      }
+      break;
+
+      case CommandType::SetDepthStencilState:
+      {
+        const ezGALDepthStencilState* pDepthStencilState = reader.ReadPtr<ezGALDepthStencilState>();
+        pRenderImpl->SetDepthStencilStatePlatform(pDepthStencilState, reader.Read<ezUInt8>());
+      }
+      break;
+
+      case CommandType::SetRasterizerState:
+        pRenderImpl->SetRasterizerStatePlatform(reader.ReadPtr<ezGALRasterizerState>());
+        break;
+
+      case CommandType::SetViewport:
+      {
+        const ezRectFloat rect = reader.Read<ezRectFloat>();
+        const float fMinDepth = reader.Read<float>();
+        pRenderImpl->SetViewportPlatform(rect, fMinDepth, reader.Read<float>());
+      }
+      break;
+
+      case CommandType::SetScissorRect:
+        pRenderImpl->SetScissorRectPlatform(reader.Read<ezRectU32>());
+        break;
+
+      case CommandType::SetStreamOutBuffer:
+      {
+        const ezUInt32 uiSlot = reader.Read<ezUInt32>();
+        const ezGALBuffer* pBuffer = reader.ReadPtr<ezGALBuffer>();
+        pRenderImpl->SetStreamOutBufferPlatform(uiSlot, pBuffer, reader.Read<ezUInt32>());
+      }
+      break;
+
+      case CommandType::Dispatch:
+      {
+        const ezUInt32 uiThreadGroupCountX = reader.Read<ezUInt32>();
+        const ezUInt32 uiThreadGroupCountY = reader.Read<ezUInt32>();
+        pComputeImpl->DispatchPlatform(uiThreadGroupCountX, uiThreadGroupCountY, reader.Read<ezUInt32>());
+      }
+      break;
+
+      case CommandType::DispatchIndirect:
+      {
+        const ezGALBuffer* pBuffer = reader.ReadPtr<ezGALBuffer>();
+        pComputeImpl->DispatchIndirectPlatform(pBuffer, reader.Read<ezUInt32>());
+      }
+      break;
+
+      default:
+        EZ_REPORT_FAILURE("Invalid command type in recorded command stream");
+        return;
+    }
+  }
+}
+
+void ezGALCommandRecorder::BeginCommand(CommandType::Enum type)
+{
+  ++m_uiCommandCount;
+  Write<ezUInt8>(type);
+}
+
+void ezGALCommandRecorder::WriteBytes(const void* pData, ezUInt32 uiSize)
+{
+  const ezUInt32 uiNewSize = m_uiStreamSize + uiSize;
+  const ezUInt32 uiRequiredBlocks = (uiNewSize + sizeof(StreamBlock) - 1) / sizeof(StreamBlock);
+  if (uiRequiredBlocks > m_CommandStream.GetCount())
+  {
+    m_CommandStream.SetCount(ezMath::Max(uiRequiredBlocks, m_CommandStream.GetCount() * 2));
+  }
+
+  ezMemoryUtils::RawByteCopy(m_CommandStream.GetArrayPtr().ToByteArray().GetPtr() + m_uiStreamSize, pData, uiSize);
+  m_uiStreamSize = uiNewSize;
+}
+
+ezUInt32 ezGALCommandRecorder::WriteAlignedBytes(const void* pData, ezUInt32 uiSize)
+{
+  Write(uiSize);
+
+  // padding is always zeroed so that identical command sequences produce identical streams
+  static const ezUInt8 s_Padding[16] = {};
+  WriteBytes(s_Padding, ezMemoryUtils::AlignSize(m_uiStreamSize, 16u) - m_uiStreamSize);
+
+  const ezUInt32 uiOffset = m_uiStreamSize;
+  WriteBytes(pData, uiSize);
+  WriteBytes(s_Padding, ezMemoryUtils::AlignSize(m_uiStreamSize, 16u) - m_uiStreamSize);
+
+  return uiOffset;
+}
+
+void ezGALCommandRecorder::WriteString(const char* szString)
+{
+  const ezUInt32 uiLength = ezStringUtils::GetStringElementCount(szString);
+  Write(uiLength);
+  WriteBytes(szString, uiLength + 1);
+}
+
+// ezGALCommandEncoderCommonPlatformInterface
+
+void ezGALCommandRecorder::SetShaderPlatform(const ezGALShader* pShader)
+{
+  BeginCommand(CommandType::SetShader);
+  Write(pShader);
+}
+
+void ezGALCommandRecorder::SetConstantBufferPlatform(ezUInt32 uiSlot, const ezGALBuffer* pBuffer)
+{
+  BeginCommand(CommandType::SetConstantBuffer);
+  Write(uiSlot);
+  Write(pBuffer);
+}
+
+void ezGALCommandRecorder::SetSamplerStatePlatform(ezGALShaderStage::Enum Stage, ezUInt32 uiSlot, const ezGALSamplerState* pSamplerState)
+{
+  BeginCommand(CommandType::SetSamplerState);
+  Write<ezUInt32>(Stage);
+  Write(uiSlot);
+  Write(pSamplerState);
+}
+
+void ezGALCommandRecorder::SetResourceViewPlatform(ezGALShaderStage::Enum Stage, ezUInt32 uiSlot, const ezGALResourceView* pResourceView)
+{
+  BeginCommand(CommandType::SetResourceView);
+  Write<ezUInt32>(Stage);
+  Write(uiSlot);
+  Write(pResourceView);
+}
+
+void ezGALCommandRecorder::SetUnorderedAccessViewPlatform(ezUInt32 uiSlot, const ezGALUnorderedAccessView* pUnorderedAccessView)
+{
+  BeginCommand(CommandType::SetUnorderedAccessView);
+  Write(uiSlot);
+  Write(pUnorderedAccessView);
+}
+
+void ezGALCommandRecorder::InsertFencePlatform(const ezGALFence* pFence)
+{
+  BeginCommand(CommandType::InsertFence);
+  Write(pFence);
+}
+
+bool ezGALCommandRecorder::IsFenceReachedPlatform(const ezGALFence* pFence)
+{
+  EZ_REPORT_FAILURE("Fences can't be queried while recording commands");
+  return false;
+}
+
+void ezGALCommandRecorder::WaitForFencePlatform(const ezGALFence* pFence)
+{
+  EZ_REPORT_FAILURE("Fences can't be waited on while recording commands");
+}
+
+void ezGALCommandRecorder::BeginQueryPlatform(const ezGALQuery* pQuery)
+{
+  BeginCommand(CommandType::BeginQuery);
+  Write(pQuery);
+}
+
+void ezGALCommandRecorder::EndQueryPlatform(const ezGALQuery* pQuery)
+{
+  BeginCommand(CommandType::EndQuery);
+  Write(pQuery);
+}
+
+ezResult ezGALCommandRecorder::GetQueryResultPlatform(const ezGALQuery* pQuery, ezUInt64& uiQueryResult)
+{
+  EZ_REPORT_FAILURE("Query results can't be retrieved while recording commands");
+  return EZ_FAILURE;
+}
+
+void ezGALCommandRecorder::InsertTimestampPlatform(ezGALTimestampHandle hTimestamp)
+{
+  BeginCommand(CommandType::InsertTimestamp);
+  Write(hTimestamp);
+}
+
+void ezGALCommandRecorder::ClearUnorderedAccessViewPlatform(const ezGALUnorderedAccessView* pUnorderedAccessView, ezVec4 clearValues)
+{
+  BeginCommand(CommandType::ClearUnorderedAccessViewFloat);
+  Write(pUnorderedAccessView);
+  Write(clearValues);
+}
+
+void ezGALCommandRecorder::ClearUnorderedAccessViewPlatform(const ezGALUnorderedAccessView* pUnorderedAccessView, ezVec4U32 clearValues)
+{
+  BeginCommand(CommandType::ClearUnorderedAccessViewUInt);
+  Write(pUnorderedAccessView);
+  Write(clearValues);
+}
+
+void ezGALCommandRecorder::CopyBufferPlatform(const ezGALBuffer* pDestination, const ezGALBuffer* pSource)
+{
+  BeginCommand(CommandType::CopyBuffer);
+  Write(pDestination);
+  Write(pSource);
+}
+
+void ezGALCommandRecorder::CopyBufferRegionPlatform(const ezGALBuffer* pDestination, ezUInt32 uiDestOffset, const ezGALBuffer* pSource, ezUInt32 uiSourceOffset, ezUInt32 uiByteCount)
+{
+  BeginCommand(CommandType::CopyBufferRegion);
+  Write(pDestination);
+  Write(uiDestOffset);
+  Write(pSource);
+  Write(uiSourceOffset);
+  Write(uiByteCount);
+}
+
+void ezGALCommandRecorder::UpdateBufferPlatform(const ezGALBuffer* pDestination, ezUInt32 uiDestOffset, ezArrayPtr<const ezUInt8> pSourceData, ezGALUpdateMode::Enum updateMode)
+{
+  BeginCommand(CommandType::UpdateBuffer);
+  Write(pDestination);
+  Write(uiDestOffset);
+  Write<ezUInt32>(updateMode);
+  WriteAlignedBytes(pSourceData.GetPtr(), pSourceData.GetCount());
+}
+
+void ezGALCommandRecorder::CopyTexturePlatform(const ezGALTexture* pDestination, const ezGALTexture* pSource)
+{
+  BeginCommand(CommandType::CopyTexture);
+  Write(pDestination);
+  Write(pSource);
+}
+
+void ezGALCommandRecorder::CopyTextureRegionPlatform(const ezGALTexture* pDestination, const ezGALTextureSubresource& DestinationSubResource, const ezVec3U32& DestinationPoint, const ezGALTexture* pSource, const ezGALTextureSubresource& SourceSubResource, const ezBoundingBoxu32& Box)
+{
+  BeginCommand(CommandType::CopyTextureRegion);
+  Write(pDestination);
+  Write(DestinationSubResource);
+  Write(DestinationPoint);
+  Write(pSource);
+  Write(SourceSubResource);
+  Write(Box);
+}
+
+void ezGALCommandRecorder::UpdateTexturePlatform(const ezGALTexture* pDestination, const ezGALTextureSubresource& DestinationSubResource, const ezBoundingBoxu32& DestinationBox, const ezGALSystemMemoryDescription& pSourceData)
+{
+  // The size of the source data depends on the texture format and can't be determined reliably here.
+  EZ_REPORT_FAILURE("Textures can't be updated while recording commands");
+}
+
+void ezGALCommandRecorder::ResolveTexturePlatform(const ezGALTexture* pDestination, const ezGALTextureSubresource& DestinationSubResource, const ezGALTexture* pSource, const ezGALTextureSubresource& SourceSubResource)
+{
+  BeginCommand(CommandType::ResolveTexture);
+  Write(pDestination);
+  Write(DestinationSubResource);
+  Write(pSource);
+  Write(SourceSubResource);
+}
+
+void ezGALCommandRecorder::ReadbackTexturePlatform(const ezGALTexture* pTexture)
+{
+  BeginCommand(CommandType::ReadbackTexture);
+  Write(pTexture);
+}
+
+void ezGALCommandRecorder::CopyTextureReadbackResultPlatform(const ezGALTexture* pTexture, ezArrayPtr<ezGALTextureSubresource> SourceSubResource, ezArrayPtr<ezGALSystemMemoryDescription> TargetData)
+{
+  EZ_REPORT_FAILURE("Readback results can't be retrieved while recording commands");
+}
+
+void ezGALCommandRecorder::GenerateMipMapsPlatform(const ezGALResourceView* pResourceView)
+{
+  BeginCommand(CommandType::GenerateMipMaps);
+  Write(pResourceView);
+}
+
+void ezGALCommandRecorder::FlushPlatform()
+{
+  BeginCommand(CommandType::Flush);
+}
+
+void ezGALCommandRecorder::PushMarkerPlatform(const char* Marker)
+{
+  BeginCommand(CommandType::PushMarker);
+  WriteString(Marker);
+}
+
+void ezGALCommandRecorder::PopMarkerPlatform()
+{
+  BeginCommand(CommandType::PopMarker);
+}
+
+void ezGALCommandRecorder::InsertEventMarkerPlatform(const char* Marker)
+{
+  BeginCommand(CommandType::InsertEventMarker);
+  WriteString(Marker);
+}
+
+// ezGALCommandEncoderRenderPlatformInterface
+
+void ezGALCommandRecorder::ClearPlatform(const ezColor& ClearColor, ezUInt32 uiRenderTargetClearMask, bool bClearDepth, bool bClearStencil, float fDepthClear, ezUInt8 uiStencilClear)
+{
+  BeginCommand(CommandType::Clear);
+  Write(ClearColor);
+  Write(uiRenderTargetClearMask);
+  Write<ezUInt8>((bClearDepth ? 1 : 0) | (bClearStencil ? 2 : 0));
+  Write(fDepthClear);
+  Write(uiStencilClear);
+}
+
+void ezGALCommandRecorder::DrawPlatform(ezUInt32 uiVertexCount, ezUInt32 uiStartVertex)
+{
+  BeginCommand(CommandType::Draw);
+  Write(uiVertexCount);
+  Write(uiStartVertex);
+}
+
+void ezGALCommandRecorder::DrawIndexedPlatform(ezUInt32 uiIndexCount, ezUInt32 uiStartIndex)
+{
+  BeginCommand(CommandType::DrawIndexed);
+  Write(uiIndexCount);
+  Write(uiStartIndex);
+}
+
+void ezGALCommandRecorder::DrawIndexedInstancedPlatform(ezUInt32 uiIndexCountPerInstance, ezUInt32 uiInstanceCount, ezUInt32 uiStartIndex)
+{
+  BeginCommand(CommandType::DrawIndexedInstanced);
+  Write(uiIndexCountPerInstance);
+  Write(uiInstanceCount);
+  Write(uiStartIndex);
+}
+
+void ezGALCommandRecorder::DrawIndexedInstancedIndirectPlatform(const ezGALBuffer* pIndirectArgumentBuffer, ezUInt32 uiArgumentOffsetInBytes)
+{
+  BeginCommand(CommandType::DrawIndexedInstancedIndirect);
+  Write(pIndirectArgumentBuffer);
+  Write(uiArgumentOffsetInBytes);
+}
+
+void ezGALCommandRecorder::DrawInstancedPlatform(ezUInt32 uiVertexCountPerInstance, ezUInt32 uiInstanceCount, ezUInt32 uiStartVertex)
+{
+  BeginCommand(CommandType::DrawInstanced);
+  Write(uiVertexCountPerInstance);
+  Write(uiInstanceCount);
+  Write(uiStartVertex);
+}
+
+void ezGALCommandRecorder::DrawInstancedIndirectPlatform(const ezGALBuffer* pIndirectArgumentBuffer, ezUInt32 uiArgumentOffsetInBytes)
+{
+  BeginCommand(CommandType::DrawInstancedIndirect);
+  Write(pIndirectArgumentBuffer);
+  Write(uiArgumentOffsetInBytes);
+}
+
+void ezGALCommandRecorder::DrawAutoPlatform()
+{
+  BeginCommand(CommandType::DrawAuto);
+}
+
+void ezGALCommandRecorder::BeginStreamOutPlatform()
+{
+  BeginCommand(CommandType::BeginStreamOut);
+}
+
+void ezGALCommandRecorder::EndStreamOutPlatform()
+{
+  BeginCommand(CommandType::EndStreamOut);
+}
+
+void ezGALCommandRecorder::SetIndexBufferPlatform(const ezGALBuffer* pIndexBuffer)
+{
+  BeginCommand(CommandType::SetIndexBuffer);
+  Write(pIndexBuffer);
+}
+
+void ezGALCommandRecorder::SetVertexBufferPlatform(ezUInt32 uiSlot, const ezGALBuffer* pVertexBuffer)
+{
+  BeginCommand(CommandType::SetVertexBuffer);
+  Write(uiSlot);
+  Write(pVertexBuffer);
+}
+
+void ezGALCommandRecorder::SetVertexDeclarationPlatform(const ezGALVertexDeclaration* pVertexDeclaration)
+{
+  BeginCommand(CommandType::SetVertexDeclaration);
+  Write(pVertexDeclaration);
+}
+
+void ezGALCommandRecorder::SetPrimitiveTopologyPlatform(ezGALPrimitiveTopology::Enum Topology)
+{
+  BeginCommand(CommandType::SetPrimitiveTopology);
+  Write<ezUInt32>(Topology);
+}
+
+void ezGALCommandRecorder::SetBlendStatePlatform(const ezGALBlendState* pBlendState, const ezColor& BlendFactor, ezUInt32 uiSampleMask)
+{
+  BeginCommand(CommandType::SetBlendState);
+  Write(pBlendState);
+  Write(BlendFactor);
+  Write(uiSampleMask);
+}
+
+void ezGALCommandRecorder::SetDepthStencilStatePlatform(const ezGALDepthStencilState* pDepthStencilState, ezUInt8 uiStencilRefValue)
+{
+  BeginCommand(CommandType::SetDepthStencilState);
+  Write(pDepthStencilState);
+  Write(uiStencilRefValue);
+}
+
+void ezGALCommandRecorder::SetRasterizerStatePlatform(const ezGALRasterizerState* pRasterizerState)
+{
+  BeginCommand(CommandType::SetRasterizerState);
+  Write(pRasterizerState);
+}
+
+void ezGALCommandRecorder::SetViewportPlatform(const ezRectFloat& rect, float fMinDepth, float fMaxDepth)
+{
+  BeginCommand(CommandType::SetViewport);
+  Write(rect);
+  Write(fMinDepth);
+  Write(fMaxDepth);
+}
+
+void ezGALCommandRecorder::SetScissorRectPlatform(const ezRectU32& rect)
+{
+  BeginCommand(CommandType::SetScissorRect);
+  Write(rect);
+}
+
+void ezGALCommandRecorder::SetStreamOutBufferPlatform(ezUInt32 uiSlot, const ezGALBuffer* pBuffer, ezUInt32 uiOffset)
+{
+  BeginCommand(CommandType::SetStreamOutBuffer);
+  Write(uiSlot);
+  Write(pBuffer);
+  Write(uiOffset);
+}
+
+// ezGALCommandEncoderComputePlatformInterface
+
+void ezGALCommandRecorder::DispatchPlatform(ezUInt32 uiThreadGroupCountX, ezUInt32 uiThreadGroupCountY, ezUInt32 uiThreadGroupCountZ)
+{
+  BeginCommand(CommandType::Dispatch);
+  Write(uiThreadGroupCountX);
+  Write(uiThreadGroupCountY);
+  Write(uiThreadGroupCountZ);
+}
+
+void ezGALCommandRecorder::DispatchIndirectPlatform(const ezGALBuffer* pIndirectArgumentBuffer, ezUInt32 uiArgumentOffsetInBytes)
+{
+  BeginCommand(CommandType::DispatchIndirect);
+  Write(pIndirectArgumentBuffer);
+  Write(uiArgumentOffsetInBytes);
+}
+
+EZ_STATICLINK_FILE(RendererFoundation, RendererFoundation_CommandEncoder_Implementation_CommandRecorder);
@@ -50,6 +50,8 @@ public:
   virtual void ClearStatisticsCounters() override;
 
 private:
+  friend class ezGALCommandRecorder;
+
   void CountDrawCall() { m_uiDrawCalls++; }
 
   // Statistic variables
@@ -0,0 +1,871 @@
+#include <Texture/TexturePCH.h>
+
+#include <Foundation/Configuration/CVar.h>
+#include <Foundation/Math/Float16.h>
+#include <Foundation/SimdMath/SimdVec4f.h>
+#include <Foundation/Threading/TaskSystem.h>
+#include <Texture/Image/Conversions/BlockCompression.h>
+#include <Texture/Image/Conversions/DXTConversions.h>
+#include <Texture/Image/Conversions/PixelConversions.h>
+#include <Texture/Image/ImageConversion.h>
+
+ezCVarInt cvar_TextureCompressionQuality("Texture.CompressionQuality", ezBlockCompressionQuality::Default, ezCVarFlags::Default, "Quality of the built-in block compressors: 0 = fast, 1 = normal, 2 = high");
+
+ezBlockCompressionQuality::Enum ezBlockCompressionQuality::GetConfigured()
+{
+  return static_cast<Enum>(ezMath::Clamp<int>(cvar_TextureCompressionQuality, Fast, High));
+}
+
+namespace
+{
+  constexpr ezUInt32 s_uiNumBlockPixels = 16;
+
+  // BC6H and BC7 interpolate between the endpoints with these weights (out of 64) when using 4 bit indices
+  constexpr ezUInt32 s_InterpolationWeights4[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+  ezUInt32 GetNumIterations(ezBlockCompressionQuality::Enum quality)
+  {
+    switch (quality)
+    {
+      case ezBlockCompressionQuality::Fast:
+        return 1;
+      case ezBlockCompressionQuality::Normal:
+        return 2;
+      default:
+        return 4;
+    }
+  }
+
+  /// Computes the line segment that fits the points best, from the principal axis of their covariance matrix.
+  /// Components that are zero in vMask are ignored.
+  void ComputeEndpoints(const ezSimdVec4f* pPoints, ezUInt32 uiNumPoints, const ezSimdVec4f& vMask, ezSimdVec4f& out_vEndpoint0, ezSimdVec4f& out_vEndpoint1)
+  {
+    ezSimdVec4f vMean = ezSimdVec4f::ZeroVector();
+    ezSimdVec4f vMin(ezMath::MaxValue<float>());
+    ezSimdVec4f vMax(-ezMath::MaxValue<float>());
+
+    for (ezUInt32 i = 0; i < uiNumPoints; ++i)
+    {
+      vMean += pPoints[i];
+      vMin = vMin.CompMin(pPoints[i]);
+      vMax = vMax.CompMax(pPoints[i]);
+    }
+
+    vMean *= ezSimdFloat(1.0f / uiNumPoints);
+
+    ezSimdVec4f vCovariance[4] = {ezSimdVec4f::ZeroVector(), ezSimdVec4f::ZeroVector(), ezSimdVec4f::ZeroVector(), ezSimdVec4f::ZeroVector()};
+
+    for (ezUInt32 i = 0; i < uiNumPoints; ++i)
+    {
+      const ezSimdVec4f vDiff = (pPoints[i] - vMean).CompMul(vMask);
+      vCovariance[0] = ezSimdVec4f::MulAdd(vDiff, vDiff.x(), vCovariance[0]);
+      vCovariance[1] = ezSimdVec4f::MulAdd(vDiff, vDiff.y(), vCovariance[1]);
+      vCovariance[2] = ezSimdVec4f::MulAdd(vDiff, vDiff.z(), vCovariance[2]);
+      vCovariance[3] = ezSimdVec4f::MulAdd(vDiff, vDiff.w(), vCovariance[3]);
+    }
+
+    // the diagonal of the bounding box is usually close to the principal axis already, a few power iterations refine it
+    ezSimdVec4f vAxis = (vMax - vMin).CompMul(vMask);
+
+    if (vAxis.GetLengthSquared<4>() < ezSimdFloat(ezMath::SmallEpsilon<float>()))
+    {
+      out_vEndpoint0 = vMean;
+      out_vEndpoint1 = vMean;
+      return;
+    }
+
+    vAxis.Normalize<4>();
+
+    for (ezUInt32 uiIteration = 0; uiIteration < 8; ++uiIteration)
+    {
+      ezSimdVec4f vNewAxis = vCovariance[0] * vAxis.x();
+      vNewAxis = ezSimdVec4f::MulAdd(vCovariance[1], vAxis.y(), vNewAxis);
+      vNewAxis = ezSimdVec4f::MulAdd(vCovariance[2], vAxis.z(), vNewAxis);
+      vNewAxis = ezSimdVec4f::MulAdd(vCovariance[3], vAxis.w(), vNewAxis);
+
+      if (vNewAxis.GetLengthSquared<4>() < ezSimdFloat(ezMath::SmallEpsilon<float>()))
+        break;
+
+      vAxis = vNewAxis.GetNormalized<4>();
+    }
+
+    ezSimdFloat fMinT = ezMath::MaxValue<float>();
+    ezSimdFloat fMaxT = -ezMath::MaxValue<float>();
+
+    for (ezUInt32 i = 0; i < uiNumPoints; ++i)
+    {
+      const ezSimdFloat t = (pPoints[i] - vMean).Dot<4>(vAxis);
+      fMinT = fMinT.Min(t);
+      fMaxT = fMaxT.Max(t);
+    }
+
+    out_vEndpoint0 = ezSimdVec4f::MulAdd(vAxis, fMinT, vMean).CompMax(vMin).CompMin(vMax);
+    out_vEndpoint1 = ezSimdVec4f::MulAdd(vAxis, fMaxT, vMean).CompMax(vMin).CompMin(vMax);
+  }
+
+  /// Assigns each point the closest palette entry and returns the sum of the squared errors.
+  float FindIndices(const ezSimdVec4f* pPoints, ezUInt32 uiNumPoints, const ezSimdVec4f* pPalette, ezUInt32 uiPaletteSize, const ezSimdVec4f& vMask, ezUInt8* out_pIndices)
+  {
+    ezSimdFloat fTotalError = 0.0f;
+
+    for (ezUInt32 i = 0; i < uiNumPoints; ++i)
+    {
+      ezSimdFloat fBestError = ezMath::MaxValue<float>();
+      ezUInt8 uiBestIndex = 0;
+
+      for (ezUInt32 c = 0; c < uiPaletteSize; ++c)
+      {
+        const ezSimdFloat fError = (pPoints[i] - pPalette[c]).CompMul(vMask).GetLengthSquared<4>();
+
+        if (fError < fBestError)
+        {
+          fBestError = fError;
+          uiBestIndex = static_cast<ezUInt8>(c);
+        }
+      }
+
+      out_pIndices[i] = uiBestIndex;
+      fTotalError += fBestError;
+    }
+
+    return fTotalError;
+  }
+
+  /// Computes the endpoints that minimize the squared error, if every point keeps its index.
+  /// pWeights holds for each index how much of the second endpoint goes into the interpolated value.
+  bool RefineEndpoints(const ezSimdVec4f* pPoints, ezUInt32 uiNumPoints, const ezUInt8* pIndices, const float* pWeights, ezSimdVec4f& out_vEndpoint0, ezSimdVec4f& out_vEndpoint1)
+  {
+    float fAlpha2 = 0.0f;
+    float fBeta2 = 0.0f;
+    float fAlphaBeta = 0.0f;
+    ezSimdVec4f vAlphaX = ezSimdVec4f::ZeroVector();
+    ezSimdVec4f vBetaX = ezSimdVec4f::ZeroVector();
+
+    for (ezUInt32 i = 0; i < uiNumPoints; ++i)
+    {
+      const float fBeta = pWeights[pIndices[i]];
+      const float fAlpha = 1.0f - fBeta;
+
+      fAlpha2 += fAlpha * fAlpha;
+      fBeta2 += fBeta * fBeta;
+      fAlphaBeta += fAlpha * fBeta;
+      vAlphaX = ezSimdVec4f::MulAdd(pPoints[i], ezSimdFloat(fAlpha), vAlphaX);
+      vBetaX = ezSimdVec4f::MulAdd(pPoints[i], ezSimdFloat(fBeta), vBetaX);
+    }
+
+    const float fDeterminant = fAlpha2 * fBeta2 - fAlphaBeta * fAlphaBeta;
+
+    // all points use the same index
+    if (ezMath::Abs(fDeterminant) < ezMath::SmallEpsilon<float>())
+      return false;
+
+    const ezSimdFloat fInvDeterminant = 1.0f / fDeterminant;
+    out_vEndpoint0 = (vAlphaX * ezSimdFloat(fBeta2) - vBetaX * ezSimdFloat(fAlphaBeta)) * fInvDeterminant;
+    out_vEndpoint1 = (vBetaX * ezSimdFloat(fAlpha2) - vAlphaX * ezSimdFloat(fAlphaBeta)) * fInvDeterminant;
+    return true;
+  }
+
+  /// Writes the bits of a block in order, starting at the least significant bit of the first byte.
+  class BlockBitWriter
+  {
+  public:
+    BlockBitWriter(ezUInt8* pTarget)
+      : m_pTarget(pTarget)
+    {
+      ezMemoryUtils::ZeroFill(m_pTarget, 16);
+    }
+
+    void Write(ezUInt32 uiValue, ezUInt32 uiNumBits)
+    {
+      for (ezUInt32 i = 0; i < uiNumBits; ++i, ++m_uiBit)
+      {
+        if ((uiValue >> i) & 1)
+        {
+          m_pTarget[m_uiBit >> 3] |= static_cast<ezUInt8>(1 << (m_uiBit & 7));
+        }
+      }
+    }
+
+  private:
+    ezUInt8* m_pTarget;
+    ezUInt32 m_uiBit = 0;
+  };
+
+  ezColorBaseUB ToColorBaseUB(const ezSimdVec4f& v)
+  {
+    float f[4];
+    v.Store<4>(f);
+
+    return ezColorBaseUB(static_cast<ezUInt8>(ezMath::Clamp(f[0] + 0.5f, 0.0f, 255.0f)), static_cast<ezUInt8>(ezMath::Clamp(f[1] + 0.5f, 0.0f, 255.0f)),
+      static_cast<ezUInt8>(ezMath::Clamp(f[2] + 0.5f, 0.0f, 255.0f)), static_cast<ezUInt8>(ezMath::Clamp(f[3] + 0.5f, 0.0f, 255.0f)));
+  }
+
+  ezSimdVec4f ToSimdVec4f(const ezColorBaseUB& c) { return ezSimdVec4f(c.r, c.g, c.b, c.a); }
+
+  //////////////////////////////////////////////////////////////////////////
+  // BC1
+
+  void CompressColorBlock(const ezColorBaseUB* pSource, ezUInt8* pTarget, ezBlockCompressionQuality::Enum quality, bool bAllowPunchThroughAlpha)
+  {
+    ezSimdVec4f points[s_uiNumBlockPixels];
+    bool isTransparent[s_uiNumBlockPixels];
+    ezUInt32 uiNumPoints = 0;
+
+    for (ezUInt32 i = 0; i < s_uiNumBlockPixels; ++i)
+    {
+      isTransparent[i] = bAllowPunchThroughAlpha && pSource[i].a < 128;
+
+      if (!isTransparent[i])
+      {
+        points[uiNumPoints] = ezSimdVec4f(pSource[i].r, pSource[i].g, pSource[i].b, 0.0f);
+        ++uiNumPoints;
+      }
+    }
+
+    if (uiNumPoints == 0)
+    {
+      // color0 <= color1 selects the three color mode, where index 3 is transparent black
+      ezMemoryUtils::ZeroFill(pTarget, 4);
+      ezMemoryUtils::PatternFill(pTarget + 4, 0xFF, 4);
+      return;
+    }
+
+    const bool bPunchThrough = uiNumPoints < s_uiNumBlockPixels;
+    const ezSimdVec4f vMask(1.0f, 1.0f, 1.0f, 0.0f);
+
+    ezSimdVec4f vEndpoint0, vEndpoint1;
+    ComputeEndpoints(points, uiNumPoints, vMask, vEndpoint0, vEndpoint1);
+
+    ezUInt16 uiBestColor0 = 0;
+    ezUInt16 uiBestColor1 = 0;
+    ezUInt8 bestIndices[s_uiNumBlockPixels] = {};
+    float fBestError = ezMath::MaxValue<float>();
+
+    const ezUInt32 uiNumIterations = GetNumIterations(quality);
+    for (ezUInt32 uiIteration = 0; uiIteration < uiNumIterations; ++uiIteration)
+    {
+      ezUInt16 uiColor0 = ezCompressB5G6R5(ToColorBaseUB(vEndpoint0));
+      ezUInt16 uiColor1 = ezCompressB5G6R5(ToColorBaseUB(vEndpoint1));
+
+      // the order of the endpoints selects the mode, the four color mode needs color0 > color1
+      const bool bThreeColorMode = bPunchThrough || uiColor0 == uiColor1;
+      if (bThreeColorMode == (uiColor0 > uiColor1))
+      {
+        ezMath::Swap(uiColor0, uiColor1);
+      }
+
+      const ezColorBaseUB c0 = ezDecompressB5G6R5(uiColor0);
+      const ezColorBaseUB c1 = ezDecompressB5G6R5(uiColor1);
+
+      ezSimdVec4f palette[4];
+      palette[0] = ToSimdVec4f(c0);
+      palette[1] = ToSimdVec4f(c1);
+
+      // same rounding as the decoder
+      if (bThreeColorMode)
+      {
+        palette[2] = ezSimdVec4f(static_cast<float>((c0.r + c1.r) / 2), static_cast<float>((c0.g + c1.g) / 2), static_cast<float>((c0.b + c1.b) / 2), 0.0f);
+      }
+      else
+      {
+        palette[2] = ezSimdVec4f(static_cast<float>((2 * c0.r + c1.r + 1) / 3), static_cast<float>((2 * c0.g + c1.g + 1) / 3), static_cast<float>((2 * c0.b + c1.b + 1) / 3), 0.0f);
+        palette[3] = ezSimdVec4f(static_cast<float>((c0.r + 2 * c1.r + 1) / 3), static_cast<float>((c0.g + 2 * c1.g + 1) / 3), static_cast<float>((c0.b + 2 * c1.b + 1) / 3), 0.0f);
+      }
+
+      ezUInt8 indices[s_uiNumBlockPixels];
+      const float fError = FindIndices(points, uiNumPoints, palette, bThreeColorMode ? 3 : 4, vMask, indices);
+
+      if (fError < fBestError)
+      {
+        fBestError = fError;
+        uiBestColor0 = uiColor0;
+        uiBestColor1 = uiColor1;
+        ezMemoryUtils::Copy(bestIndices, indices, s_uiNumBlockPixels);
+      }
+
+      if (fError == 0.0f || uiIteration + 1 == uiNumIterations)
+        break;
+
+      static constexpr float s_ThreeColorWeights[] = {0.0f, 1.0f, 0.5f};
+      static constexpr float s_FourColorWeights[] = {0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f};
+
+      if (!RefineEndpoints(points, uiNumPoints, indices, bThreeColorMode ? s_ThreeColorWeights : s_FourColorWeights, vEndpoint0, vEndpoint1))
+        break;
+    }
+
+    pTarget[0] = static_cast<ezUInt8>(uiBestColor0 & 0xFF);
+    pTarget[1] = static_cast<ezUInt8>(uiBestColor0 >> 8);
+    pTarget[2] = static_cast<ezUInt8>(uiBestColor1 & 0xFF);
+    pTarget[3] = static_cast<ezUInt8>(uiBestColor1 >> 8);
+
+    ezUInt32 uiIndexBits = 0;
+    for (ezUInt32 i = 0, uiPoint = 0; i < s_uiNumBlockPixels; ++i)
+    {
+      const ezUInt32 uiIndex = isTransparent[i] ? 3 : bestIndices[uiPoint++];
+      uiIndexBits |= uiIndex << (2 * i);
+    }
+
+    pTarget[4] = static_cast<ezUInt8>(uiIndexBits);
+    pTarget[5] = static_cast<ezUInt8>(uiIndexBits >> 8);
+    pTarget[6] = static_cast<ezUInt8>(uiIndexBits >> 16);
+    pTarget[7] = static_cast<ezUInt8>(uiIndexBits >> 24);
+  }
+
+  //////////////////////////////////////////////////////////////////////////
+  // BC4
+
+  ezUInt32 FindIndicesBC4(const ezUInt8* pSource, ezUInt32 a0, ezUInt32 a1, ezUInt8* out_pIndices)
+  {
+    ezUInt32 palette[8];
+    ezUnpackPaletteBC4(a0, a1, palette);
+
+    ezUInt32 uiTotalError = 0;
+
+    for (ezUInt32 i = 0; i < s_uiNumBlockPixels; ++i)
+    {
+      ezUInt32 uiBestError = 0xFFFFFFFF;
+
+      for (ezUInt32 c = 0; c < 8; ++c)
+      {
+        const ezInt32 iDiff = static_cast<ezInt32>(pSource[i]) - static_cast<ezInt32>(palette[c]);
+        const ezUInt32 uiError = static_cast<ezUInt32>(iDiff * iDiff);
+
+        if (uiError < uiBestError)
+        {
+          uiBestError = uiError;
+          out_pIndices[i] = static_cast<ezUInt8>(c);
+        }
+      }
+
+      uiTotalError += uiBestError;
+    }
+
+    return uiTotalError;
+  }
+
+  //////////////////////////////////////////////////////////////////////////
+  // BC6H and BC7
+
+  /// Rearranges the endpoints such that the first index fits into one bit less, as the formats require.
+  void FixAnchorIndex(ezUInt8* pIndices, ezUInt32 uiIndexBits, ezUInt32* pEndpoint0, ezUInt32* pEndpoint1, ezUInt32 uiNumEndpointValues)
+  {
+    const ezUInt32 uiMaxIndex = (1u << uiIndexBits) - 1;
+
+    if (pIndices[0] <= uiMaxIndex / 2)
+      return;
+
+    for (ezUInt32 i = 0; i < uiNumEndpointValues; ++i)
+    {
+      ezMath::Swap(pEndpoint0[i], pEndpoint1[i]);
+    }
+
+    for (ezUInt32 i = 0; i < s_uiNumBlockPixels; ++i)
+    {
+      pIndices[i] = static_cast<ezUInt8>(uiMaxIndex - pIndices[i]);
+    }
+  }
+
+  void WriteIndices(BlockBitWriter& writer, const ezUInt8* pIndices, ezUInt32 uiIndexBits)
+  {
+    writer.Write(pIndices[0], uiIndexBits - 1);
+
+    for (ezUInt32 i = 1; i < s_uiNumBlockPixels; ++i)
+    {
+      writer.Write(pIndices[i], uiIndexBits);
+    }
+  }
+
+  float GetInterpolationWeights4(ezUInt32 uiIndex) { return s_InterpolationWeights4[uiIndex] / 64.0f; }
+
+  // BC6H works on 16 bit values that become half floats after scaling by 31/64, unsigned mode 11 stores them with 10 bits
+  ezUInt32 QuantizeBC6(float fValue) { return static_cast<ezUInt32>(ezMath::Clamp((fValue - 32.0f) / 64.0f + 0.5f, 0.0f, 1023.0f)); }
+
+  ezUInt32 UnquantizeBC6(ezUInt32 uiValue)
+  {
+    if (uiValue == 0)
+      return 0;
+    if (uiValue == 1023)
+      return 0xFFFF;
+    return ((uiValue << 16) + 0x8000) >> 10;
+  }
+
+  float ToUnquantizedBC6(float fValue)
+  {
+    // also catches NaN
+    if (!(fValue > 0.0f))
+      return 0.0f;
+
+    const ezFloat16 half = ezMath::Min(fValue, 65504.0f);
+    return half.GetRawData() * (64.0f / 31.0f);
+  }
+
+  // BC7 mode 6 stores 7 bits per channel and one p-bit per endpoint, which becomes the lowest bit of all channels
+  ezUInt32 QuantizeBC7(float fValue, ezUInt32 uiPBit) { return static_cast<ezUInt32>(ezMath::Clamp((fValue - uiPBit) / 2.0f + 0.5f, 0.0f, 127.0f)); }
+
+  ezUInt32 ChooseBC7PBit(const ezSimdVec4f& vEndpoint)
+  {
+    float f[4];
+    vEndpoint.Store<4>(f);
+
+    float fError[2] = {0.0f, 0.0f};
+    for (ezUInt32 uiPBit = 0; uiPBit < 2; ++uiPBit)
+    {
+      for (ezUInt32 c = 0; c < 4; ++c)
+      {
+        const float fDiff = f[c] - static_cast<float>((QuantizeBC7(f[c], uiPBit) << 1) | uiPBit);
+        fError[uiPBit] += fDiff * fDiff;
+      }
+    }
+
+    return fError[1] < fError[0] ? 1 : 0;
+  }
+
+  /// Converts the pixels of a block row by row, distributing the rows over all worker threads.
+  template <typename Func>
+  void ForEachBlock(ezUInt32 numBlocksX, ezUInt32 numBlocksY, const char* szTaskName, Func func)
+  {
+    ezParallelForParams params;
+    params.uiBinSize = 4;
+
+    ezTaskSystem::ParallelForIndexed(
+      0, numBlocksY,
+      [&](ezUInt32 uiStartRow, ezUInt32 uiEndRow) {
+        for (ezUInt32 blockY = uiStartRow; blockY < uiEndRow; ++blockY)
+        {
+          for (ezUInt32 blockX = 0; blockX < numBlocksX; ++blockX)
+          {
+            func(blockX, blockY);
+          }
+        }
+      },
+      szTaskName, params);
+  }
+
+  template <typename T>
+  void GatherBlock(ezConstByteBlobPtr source, ezUInt64 uiRowPitch, ezUInt32 blockX, ezUInt32 blockY, T* out_pPixels)
+  {
+    for (ezUInt32 y = 0; y < 4; ++y)
+    {
+      const T* pRow = reinterpret_cast<const T*>(source.GetPtr() + (4 * blockY + y) * uiRowPitch) + 4 * blockX;
+
+      for (ezUInt32 x = 0; x < 4; ++x)
+      {
+        out_pPixels[4 * y + x] = pRow[x];
+      }
+    }
+  }
+
+  ezImageConversionEntry MakeEntry(ezImageFormat::Enum sourceFormat, ezImageFormat::Enum targetFormat)
+  {
+    ezImageConversionEntry entry(sourceFormat, targetFormat, ezImageConversionFlags::Default);
+
+#if EZ_ENABLED(EZ_PLATFORM_WINDOWS_DESKTOP)
+    // prefer DirectXTex when it has a hardware device, it is faster and supports all BC6H and BC7 modes
+    entry.m_additionalPenalty = 1.0f;
+#endif
+
+    return entry;
+  }
+} // namespace
+
+void ezCompressBlockBC1(const ezColorBaseUB* pSource, ezUInt8* pTarget, ezBlockCompressionQuality::Enum quality)
+{
+  CompressColorBlock(pSource, pTarget, quality, true);
+}
+
+void ezCompressBlockBC4(const ezUInt8* pSource, ezUInt8* pTarget, ezBlockCompressionQuality::Enum quality)
+{
+  ezUInt32 uiMin = 255, uiMax = 0;
+  ezUInt32 uiInnerMin = 255, uiInnerMax = 0;
+
+  for (ezUInt32 i = 0; i < s_uiNumBlockPixels; ++i)
+  {
+    uiMin = ezMath::Min<ezUInt32>(uiMin, pSource[i]);
+    uiMax = ezMath::Max<ezUInt32>(uiMax, pSource[i]);
+
+    if (pSource[i] != 0 && pSource[i] != 255)
+    {
+      uiInnerMin = ezMath::Min<ezUInt32>(uiInnerMin, pSource[i]);
+      uiInnerMax = ezMath::Max<ezUInt32>(uiInnerMax, pSource[i]);
+    }
+  }
+
+  // a0 > a1 selects eight interpolated values, a0 <= a1 six values plus exact 0 and 255
+  ezUInt32 uiBestA0 = uiMax;
+  ezUInt32 uiBestA1 = uiMin;
+  ezUInt8 bestIndices[s_uiNumBlockPixels];
+  ezUInt32 uiBestError = FindIndicesBC4(pSource, uiBestA0, uiBestA1, bestIndices);
+
+  auto TryEndpoints = [&](ezUInt32 a0, ezUInt32 a1) {
+    ezUInt8 indices[s_uiNumBlockPixels];
+    const ezUInt32 uiError = FindIndicesBC4(pSource, a0, a1, indices);
+
+    if (uiError < uiBestError)
+    {
+      uiBestError = uiError;
+      uiBestA0 = a0;
+      uiBestA1 = a1;
+      ezMemoryUtils::Copy(bestIndices, indices, s_uiNumBlockPixels);
+    }
+  };
+
+  if (uiBestError > 0 && quality >= ezBlockCompressionQuality::Normal && uiInnerMin <= uiInnerMax && (uiMin == 0 || uiMax == 255))
+  {
+    TryEndpoints(uiInnerMin, uiInnerMax);
+  }
+
+  if (uiBestError > 0 && quality >= ezBlockCompressionQuality::High)
+  {
+    // the extremes usually fall between two palette values anyway, so a slightly smaller range often fits the rest better
+    for (ezUInt32 uiShrinkMax = 0; uiShrinkMax < 4; ++uiShrinkMax)
+    {
+      for (ezUInt32 uiShrinkMin = 0; uiShrinkMin < 4; ++uiShrinkMin)
+      {
+        if (uiMin + uiShrinkMin + uiShrinkMax < uiMax)
+        {
+          TryEndpoints(uiMax - uiShrinkMax, uiMin + uiShrinkMin);
+        }
+      }
+    }
+  }
+
+  pTarget[0] = static_cast<ezUInt8>(uiBestA0);
+  pTarget[1] = static_cast<ezUInt8>(uiBestA1);
+
+  ezUInt64 uiIndexBits = 0;
+  for (ezUInt32 i = 0; i < s_uiNumBlockPixels; ++i)
+  {
+    uiIndexBits |= static_cast<ezUInt64>(bestIndices[i]) << (3 * i);
+  }
+
+  for (ezUInt32 i = 0; i < 6; ++i)
+  {
+    pTarget[2 + i] = static_cast<ezUInt8>(uiIndexBits >> (8 * i));
+  }
+}
+
+void ezCompressBlockBC6(const ezColor* pSource, ezUInt8* pTarget, ezBlockCompressionQuality::Enum quality)
+{
+  // only mode 11 is used: one region with 10 bit endpoints and 16 interpolation steps
+  ezSimdVec4f points[s_uiNumBlockPixels];
+  for (ezUInt32 i = 0; i < s_uiNumBlockPixels; ++i)
+  {
+    points[i] = ezSimdVec4f(ToUnquantizedBC6(pSource[i].r), ToUnquantizedBC6(pSource[i].g), ToUnquantizedBC6(pSource[i].b), 0.0f);
+  }
+
+  const ezSimdVec4f vMask(1.0f, 1.0f, 1.0f, 0.0f);
+
+  ezSimdVec4f vEndpoint0, vEndpoint1;
+  ComputeEndpoints(points, s_uiNumBlockPixels, vMask, vEndpoint0, vEndpoint1);
+
+  ezUInt32 bestEndpoint0[3] = {};
+  ezUInt32 bestEndpoint1[3] = {};
+  ezUInt8 bestIndices[s_uiNumBlockPixels] = {};
+  float fBestError = ezMath::MaxValue<float>();
+
+  float weights[16];
+  for (ezUInt32 i = 0; i < 16; ++i)
+  {
+    weights[i] = GetInterpolationWeights4(i);
+  }
+
+  const ezUInt32 uiNumIterations = GetNumIterations(quality);
+  for (ezUInt32 uiIteration = 0; uiIteration < uiNumIterations; ++uiIteration)
+  {
+    float e0[4], e1[4];
+    vEndpoint0.Store<4>(e0);
+    vEndpoint1.Store<4>(e1);
+
+    ezUInt32 endpoint0[3], endpoint1[3], unquantized0[3], unquantized1[3];
+    for (ezUInt32 c = 0; c < 3; ++c)
+    {
+      endpoint0[c] = QuantizeBC6(e0[c]);
+      endpoint1[c] = QuantizeBC6(e1[c]);
+      unquantized0[c] = UnquantizeBC6(endpoint0[c]);
+      unquantized1[c] = UnquantizeBC6(endpoint1[c]);
+    }
+
+    ezSimdVec4f palette[16];
+    for (ezUInt32 i = 0; i < 16; ++i)
+    {
+      const ezUInt32 w = s_InterpolationWeights4[i];
+      palette[i] = ezSimdVec4f(static_cast<float>((unquantized0[0] * (64 - w) + unquantized1[0] * w + 32) >> 6),
+        static_cast<float>((unquantized0[1] * (64 - w) + unquantized1[1] * w + 32) >> 6), static_cast<float>((unquantized0[2] * (64 - w) + unquantized1[2] * w + 32) >> 6), 0.0f);
+    }
+
+    ezUInt8 indices[s_uiNumBlockPixels];
+    const float fError = FindIndices(points, s_uiNumBlockPixels, palette, 16, vMask, indices);
+
+    if (fError < fBestError)
+    {
+      fBestError = fError;
+      ezMemoryUtils::Copy(bestEndpoint0, endpoint0, 3);
+      ezMemoryUtils::Copy(bestEndpoint1, endpoint1, 3);
+      ezMemoryUtils::Copy(bestIndices, indices, s_uiNumBlockPixels);
+    }
+
+    if (fError == 0.0f || uiIteration + 1 == uiNumIterations)
+      break;
+
+    if (!RefineEndpoints(points, s_uiNumBlockPixels, indices, weights, vEndpoint0, vEndpoint1))
+      break;
+  }
+
+  FixAnchorIndex(bestIndices, 4, bestEndpoint0, bestEndpoint1, 3);
+
+  BlockBitWriter writer(pTarget);
+  writer.Write(0x03, 5);
+
+  for (ezUInt32 c = 0; c < 3; ++c)
+  {
+    writer.Write(bestEndpoint0[c], 10);
+  }
+
+  for (ezUInt32 c = 0; c < 3; ++c)
+  {
+    writer.Write(bestEndpoint1[c], 10);
+  }
+
+  WriteIndices(writer, bestIndices, 4);
+}
+
+void ezCompressBlockBC7(const ezColorBaseUB* pSource, ezUInt8* pTarget, ezBlockCompressionQuality::Enum quality)
+{
+  // only mode 6 is used: one subset, RGBA with 7 bits per channel plus a p-bit per endpoint, and 16 interpolation steps
+  ezSimdVec4f points[s_uiNumBlockPixels];
+  for (ezUInt32 i = 0; i < s_uiNumBlockPixels; ++i)
+  {
+    points[i] = ToSimdVec4f(pSource[i]);
+  }
+
+  const ezSimdVec4f vMask(1.0f);
+
+  ezSimdVec4f vEndpoint0, vEndpoint1;
+  ComputeEndpoints(points, s_uiNumBlockPixels, vMask, vEndpoint0, vEndpoint1);
+
+  // the p-bits are stored as the fifth value of each endpoint
+  ezUInt32 bestEndpoint0[5] = {};
+  ezUInt32 bestEndpoint1[5] = {};
+  ezUInt8 bestIndices[s_uiNumBlockPixels] = {};
+  float fBestError = ezMath::MaxValue<float>();
+
+  float weights[16];
+  for (ezUInt32 i = 0; i < 16; ++i)
+  {
+    weights[i] = GetInterpolationWeights4(i);
+  }
+
+  const ezUInt32 uiNumIterations = GetNumIterations(quality);
+  for (ezUInt32 uiIteration = 0; uiIteration < uiNumIterations; ++uiIteration)
+  {
+    float e0[4], e1[4];
+    vEndpoint0.Store<4>(e0);
+    vEndpoint1.Store<4>(e1);
+
+    // the fast mode picks the p-bits that round each endpoint best, the others try all combinations
+    const ezUInt32 uiFirstCombination = quality == ezBlockCompressionQuality::Fast ? (ChooseBC7PBit(vEndpoint0) | (ChooseBC7PBit(vEndpoint1) << 1)) : 0;
+    const ezUInt32 uiLastCombination = quality == ezBlockCompressionQuality::Fast ? uiFirstCombination : 3;
+
+    ezUInt8 indices[s_uiNumBlockPixels];
+    float fIterationError = ezMath::MaxValue<float>();
+    ezUInt8 iterationIndices[s_uiNumBlockPixels];
+
+    for (ezUInt32 uiCombination = uiFirstCombination; uiCombination <= uiLastCombination; ++uiCombination)
+    {
+      const ezUInt32 uiPBit0 = uiCombination & 1;
+      const ezUInt32 uiPBit1 = uiCombination >> 1;
+
+      ezUInt32 endpoint0[5], endpoint1[5], unquantized0[4], unquantized1[4];
+      for (ezUInt32 c = 0; c < 4; ++c)
+      {
+        endpoint0[c] = QuantizeBC7(e0[c], uiPBit0);
+        endpoint1[c] = QuantizeBC7(e1[c], uiPBit1);
+        unquantized0[c] = (endpoint0[c] << 1) | uiPBit0;
+        unquantized1[c] = (endpoint1[c] << 1) | uiPBit1;
+      }
+
+      endpoint0[4] = uiPBit0;
+      endpoint1[4] = uiPBit1;
+
+      ezSimdVec4f palette[16];
+      for (ezUInt32 i = 0; i < 16; ++i)
+      {
+        const ezUInt32 w = s_InterpolationWeights4[i];
+        palette[i] = ezSimdVec4f(static_cast<float>((unquantized0[0] * (64 - w) + unquantized1[0] * w + 32) >> 6),
+          static_cast<float>((unquantized0[1] * (64 - w) + unquantized1[1] * w + 32) >> 6), static_cast<float>((unquantized0[2] * (64 - w) + unquantized1[2] * w + 32) >> 6),
+          static_cast<float>((unquantized0[3] * (64 - w) + unquantized1[3] * w + 32) >> 6));
+      }
+
+      const float fError = FindIndices(points, s_uiNumBlockPixels, palette, 16, vMask, indices);
+
+      if (fError < fIterationError)
+      {
+        fIterationError = fError;
+        ezMemoryUtils::Copy(iterationIndices, indices, s_uiNumBlockPixels);
+      }
+
+      if (fError < fBestError)
+      {
+        fBestError = fError;
+        ezMemoryUtils::Copy(bestEndpoint0, endpoint0, 5);
+        ezMemoryUtils::Copy(bestEndpoint1, endpoint1, 5);
+        ezMemoryUtils::Copy(bestIndices, indices, s_uiNumBlockPixels);
+      }
+    }
+
+    if (fBestError == 0.0f || uiIteration + 1 == uiNumIterations)
+      break;
+
+    if (!RefineEndpoints(points, s_uiNumBlockPixels, iterationIndices, weights, vEndpoint0, vEndpoint1))
+      break;
+
+    vEndpoint0 = vEndpoint0.CompMax(ezSimdVec4f::ZeroVector()).CompMin(ezSimdVec4f(255.0f));
+    vEndpoint1 = vEndpoint1.CompMax(ezSimdVec4f::ZeroVector()).CompMin(ezSimdVec4f(255.0f));
+  }
+
+  FixAnchorIndex(bestIndices, 4, bestEndpoint0, bestEndpoint1, 5);
+
+  BlockBitWriter writer(pTarget);
+  writer.Write(1 << 6, 7);
+
+  for (ezUInt32 c = 0; c < 4; ++c)
+  {
+    writer.Write(bestEndpoint0[c], 7);
+    writer.Write(bestEndpoint1[c], 7);
+  }
+
+  writer.Write(bestEndpoint0[4], 1);
+  writer.Write(bestEndpoint1[4], 1);
+
+  WriteIndices(writer, bestIndices, 4);
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+class ezImageConversion_CompressBC1 : public ezImageConversionStepCompressBlocks
+{
+  virtual ezArrayPtr<const ezImageConversionEntry> GetSupportedConversions() const override
+  {
+    static ezImageConversionEntry supportedConversions[] = {
+      MakeEntry(ezImageFormat::R8G8B8A8_UNORM, ezImageFormat::BC1_UNORM),
+      MakeEntry(ezImageFormat::R8G8B8A8_UNORM_SRGB, ezImageFormat::BC1_UNORM_SRGB),
+    };
+    return supportedConversions;
+  }
+
+  virtual ezResult CompressBlocks(ezConstByteBlobPtr source, ezByteBlobPtr target, ezUInt32 numBlocksX, ezUInt32 numBlocksY,
+    ezImageFormat::Enum sourceFormat, ezImageFormat::Enum targetFormat) const override
+  {
+    const ezUInt64 uiRowPitch = ezImageFormat::GetRowPitch(sourceFormat, 4 * numBlocksX);
+    const ezBlockCompressionQuality::Enum quality = ezBlockCompressionQuality::GetConfigured();
+
+    ForEachBlock(numBlocksX, numBlocksY, "CompressBC1", [&](ezUInt32 blockX, ezUInt32 blockY) {
+      ezColorBaseUB pixels[s_uiNumBlockPixels];
+      GatherBlock(source, uiRowPitch, blockX, blockY, pixels);
+
+      ezCompressBlockBC1(pixels, target.GetPtr() + (blockY * numBlocksX + blockX) * 8, quality);
+    });
+
+    return EZ_SUCCESS;
+  }
+};
+
+class ezImageConversion_CompressBC3 : public ezImageConversionStepCompressBlocks
+{
+  virtual ezArrayPtr<const ezImageConversionEntry> GetSupportedConversions() const override
+  {
+    static ezImageConversionEntry supportedConversions[] = {
+      MakeEntry(ezImageFormat::R8G8B8A8_UNORM, ezImageFormat::BC3_UNORM),
+      MakeEntry(ezImageFormat::R8G8B8A8_UNORM_SRGB, ezImageFormat::BC3_UNORM_SRGB),
+    };
+    return supportedConversions;
+  }
+
+  virtual ezResult CompressBlocks(ezConstByteBlobPtr source, ezByteBlobPtr target, ezUInt32 numBlocksX, ezUInt32 numBlocksY,
+    ezImageFormat::Enum sourceFormat, ezImageFormat::Enum targetFormat) const override
+  {
+    const ezUInt64 uiRowPitch = ezImageFormat::GetRowPitch(sourceFormat, 4 * numBlocksX);
+    const ezBlockCompressionQuality::Enum quality = ezBlockCompressionQuality::GetConfigured();
+
+    ForEachBlock(numBlocksX, numBlocksY, "CompressBC3", [&](ezUInt32 blockX, ezUInt32 blockY) {
+      ezColorBaseUB pixels[s_uiNumBlockPixels];
+      GatherBlock(source, uiRowPitch, blockX, blockY, pixels);
+
+      ezUInt8 alpha[s_uiNumBlockPixels];
+      for (ezUInt32 i = 0; i < s_uiNumBlockPixels; ++i)
+      {
+        alpha[i] = pixels[i].a;
+      }
+
+      ezUInt8* pTarget = target.GetPtr() + (blockY * numBlocksX + blockX) * 16;
+      ezCompressBlockBC4(alpha, pTarget, quality);
+
+      // the color part of BC3 is always decoded in four color mode
+      CompressColorBlock(pixels, pTarget + 8, quality, false);
+    });
+
+    return EZ_SUCCESS;
+  }
+};
+
+class ezImageConversion_CompressBC6 : public ezImageConversionStepCompressBlocks
+{
+  virtual ezArrayPtr<const ezImageConversionEntry> GetSupportedConversions() const override
+  {
+    static ezImageConversionEntry supportedConversions[] = {
+      MakeEntry(ezImageFormat::R32G32B32A32_FLOAT, ezImageFormat::BC6H_UF16),
+    };
+    return supportedConversions;
+  }
+
+  virtual ezResult CompressBlocks(ezConstByteBlobPtr source, ezByteBlobPtr target, ezUInt32 numBlocksX, ezUInt32 numBlocksY,
+    ezImageFormat::Enum sourceFormat, ezImageFormat::Enum targetFormat) const override
+  {
+    const ezUInt64 uiRowPitch = ezImageFormat::GetRowPitch(sourceFormat, 4 * numBlocksX);
+    const ezBlockCompressionQuality::Enum quality = ezBlockCompressionQuality::GetConfigured();
+
+    ForEachBlock(numBlocksX, numBlocksY, "CompressBC6", [&](ezUInt32 blockX, ezUInt32 blockY) {
+      ezColor pixels[s_uiNumBlockPixels];
+      GatherBlock(source, uiRowPitch, blockX, blockY, pixels);
+
+      ezCompressBlockBC6(pixels, target.GetPtr() + (blockY * numBlocksX + blockX) * 16, quality);
+    });
+
+    return EZ_SUCCESS;
+  }
+};
+
+class ezImageConversion_CompressBC7 : public ezImageConversionStepCompressBlocks
+{
+  virtual ezArrayPtr<const ezImageConversionEntry> GetSupportedConversions() const override
+  {
+    static ezImageConversionEntry supportedConversions[] = {
+      MakeEntry(ezImageFormat::R8G8B8A8_UNORM, ezImageFormat::BC7_UNORM),
+      MakeEntry(ezImageFormat::R8G8B8A8_UNORM_SRGB, ezImageFormat::BC7_UNORM_SRGB),
+    };
+    return supportedConversions;
+  }
+
+  virtual ezResult CompressBlocks(ezConstByteBlobPtr source, ezByteBlobPtr target, ezUInt32 numBlocksX, ezUInt32 numBlocksY,
+    ezImageFormat::Enum sourceFormat, ezImageFormat::Enum targetFormat) const override
+  {
+    const ezUInt64 uiRowPitch = ezImageFormat::GetRowPitch(sourceFormat, 4 * numBlocksX);
+    const ezBlockCompressionQuality::Enum quality = ezBlockCompressionQuality::GetConfigured();
+
+    ForEachBlock(numBlocksX, numBlocksY, "CompressBC7", [&](ezUInt32 blockX, ezUInt32 blockY) {
+      ezColorBaseUB pixels[s_uiNumBlockPixels];
+      GatherBlock(source, uiRowPitch, blockX, blockY, pixels);
+
+      ezCompressBlockBC7(pixels, target.GetPtr() + (blockY * numBlocksX + blockX) * 16, quality);
+    });
+
+    return EZ_SUCCESS;
+  }
+};
+
+static ezImageConversion_CompressBC1 s_conversion_compressBC1;
+static ezImageConversion_CompressBC3 s_conversion_compressBC3;
+static ezImageConversion_CompressBC6 s_conversion_compressBC6;
+static ezImageConversion_CompressBC7 s_conversion_compressBC7;
+
+EZ_STATICLINK_FILE(Texture, Texture_Image_Conversions_BlockCompression);
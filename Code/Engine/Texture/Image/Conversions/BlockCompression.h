@@ -0,0 +1,33 @@
+#pragma once
+
+#include <Texture/Image/Image.h>
+
+/// \brief How much time the block compressors may spend on finding good endpoints.
+struct ezBlockCompressionQuality
+{
+  typedef ezUInt8 StorageType;
+
+  enum Enum
+  {
+    Fast,   ///< Endpoints from the principal axis of the block, no refinement.
+    Normal, ///< Refines the endpoints with a few least-squares iterations.
+    High,   ///< More iterations and a search over alternative encodings of each block.
+
+    Default = Normal
+  };
+
+  /// \brief Returns the quality selected by the cvar 'Texture.CompressionQuality'.
+  EZ_TEXTURE_DLL static Enum GetConfigured();
+};
+
+/// \brief Encodes a block of 4x4 pixels as BC1. Pixels with an alpha below 128 make the block use the punch-through alpha mode.
+EZ_TEXTURE_DLL void ezCompressBlockBC1(const ezColorBaseUB* pSource, ezUInt8* pTarget, ezBlockCompressionQuality::Enum quality);
+
+/// \brief Encodes 16 single channel values as a BC4 block (8 bytes). BC3 uses the same encoding for its alpha channel.
+EZ_TEXTURE_DLL void ezCompressBlockBC4(const ezUInt8* pSource, ezUInt8* pTarget, ezBlockCompressionQuality::Enum quality);
+
+/// \brief Encodes a block of 4x4 pixels as unsigned BC6H. Negative values and NaNs are stored as zero.
+EZ_TEXTURE_DLL void ezCompressBlockBC6(const ezColor* pSource, ezUInt8* pTarget, ezBlockCompressionQuality::Enum quality);
+
+/// \brief Encodes a block of 4x4 pixels as BC7.
+EZ_TEXTURE_DLL void ezCompressBlockBC7(const ezColorBaseUB* pSource, ezUInt8* pTarget, ezBlockCompressionQuality::Enum quality);
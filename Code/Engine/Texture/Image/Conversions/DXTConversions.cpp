@@ -2,6 +2,8 @@
 
 #include <Foundation/Math/Color16f.h>
 #include <Foundation/Strings/StringBuilder.h>
+#include <Foundation/Threading/TaskSystem.h>
+#include <Texture/Image/Conversions/BlockCompression.h>
 #include <Texture/Image/Conversions/DXTConversions.h>
 #include <Texture/Image/Conversions/PixelConversions.h>
 #include <Texture/Image/ImageConversion.h>
@@ -2920,7 +2922,26 @@ public:
   }
 };
 
+namespace
+{
+  void CompressBlockBC4(const ezUInt8* sourceBlock, ezUInt8 bias, ezBlockCompressionQuality::Enum quality, ezUInt8* targetPointer)
+  {
 #if defined(EZ_SUPPORTS_BC4_COMPRESSOR)
+    EZ_IGNORE_UNUSED(quality);
+
+    ezUInt32 a0, a1;
+    findBestPaletteBC4(sourceBlock, a0, a1);
+    packBlockBC4(sourceBlock, a0, a1, targetPointer);
+#else
+    ezCompressBlockBC4(sourceBlock, targetPointer, quality);
+#endif
+
+    // Undo biasing for signed formats by shifting palette upper and lower bound back into signed range
+    targetPointer[0] -= bias;
+    targetPointer[1] -= bias;
+  }
+} // namespace
+
 class ezImageConversion_CompressBC4 : public ezImageConversionStepCompressBlocks
 {
   virtual ezArrayPtr<const ezImageConversionEntry> GetSupportedConversions() const override
@@ -2941,6 +2962,7 @@ class ezImageConversion_CompressBC4 : public ezImageConversionStepCompressBlocks
   {
     ezUInt32 stride = ezImageFormat::GetBitsPerPixel(sourceFormat) / 8;
     ezUInt64 rowPitch = ezImageFormat::GetRowPitch(sourceFormat, 4 * numBlocksX);
+    const ezBlockCompressionQuality::Enum quality = ezBlockCompressionQuality::GetConfigured();
 
     // Bias to shift signed data into unsigned range so we can treat it the same as unsigned
     ezUInt8 bias = 0;
@@ -2949,32 +2971,34 @@ class ezImageConversion_CompressBC4 : public ezImageConversionStepCompressBlocks
       bias = 128;
     }
 
-    for (ezUInt32 blockY = 0; blockY < numBlocksY; ++blockY)
-    {
-      for (ezUInt32 blockX = 0; blockX < numBlocksX; ++blockX)
-      {
-        ezUInt8 sourceBlock[16];
+    ezParallelForParams params;
+    params.uiBinSize = 4;
 
-        for (ezUInt32 y = 0; y < 4; ++y)
+    ezTaskSystem::ParallelForIndexed(
+      0, numBlocksY,
+      [&](ezUInt32 uiStartRow, ezUInt32 uiEndRow) {
+        for (ezUInt32 blockY = uiStartRow; blockY < uiEndRow; ++blockY)
         {
-          const ezUInt8* sourcePointer = static_cast<const ezUInt8*>(source.GetPtr()) + (4 * blockY + y) * rowPitch;
-
-          for (ezUInt32 x = 0; x < 4; ++x)
+          for (ezUInt32 blockX = 0; blockX < numBlocksX; ++blockX)
           {
-            sourceBlock[4 * y + x] = sourcePointer[(x + 4 * blockX) * stride] + bias;
-          }
-        }
+            ezUInt8 sourceBlock[16];
 
-        ezUInt32 a0, a1;
-        findBestPaletteBC4(sourceBlock, a0, a1);
+            for (ezUInt32 y = 0; y < 4; ++y)
+            {
+              const ezUInt8* sourcePointer = static_cast<const ezUInt8*>(source.GetPtr()) + (4 * blockY + y) * rowPitch;
 
-        ezUInt8* targetPointer = static_cast<ezUInt8*>(target.GetPtr()) + (blockY * numBlocksX + blockX) * 8;
-        packBlockBC4(sourceBlock, a0, a1, targetPointer);
+              for (ezUInt32 x = 0; x < 4; ++x)
+              {
+                sourceBlock[4 * y + x] = sourcePointer[(x + 4 * blockX) * stride] + bias;
+              }
+            }
 
-        targetPointer[0] -= bias;
-        targetPointer[1] -= bias;
-      }
-    }
+            ezUInt8* targetPointer = static_cast<ezUInt8*>(target.GetPtr()) + (blockY * numBlocksX + blockX) * 8;
+            CompressBlockBC4(sourceBlock, bias, quality, targetPointer);
+          }
+        }
+      },
+      "CompressBC4", params);
 
     return EZ_SUCCESS;
   }
@@ -2998,6 +3022,7 @@ class ezImageConversion_CompressBC5 : public ezImageConversionStepCompressBlocks
   {
     ezUInt32 stride = ezImageFormat::GetBitsPerPixel(sourceFormat) / 8;
     ezUInt64 rowPitch = ezImageFormat::GetRowPitch(sourceFormat, 4 * numBlocksX);
+    const ezBlockCompressionQuality::Enum quality = ezBlockCompressionQuality::GetConfigured();
 
     // Bias to shift signed data into unsigned range so we can treat it the same as unsigned
     ezUInt8 bias = 0;
@@ -3006,47 +3031,37 @@ class ezImageConversion_CompressBC5 : public ezImageConversionStepCompressBlocks
       bias = 128;
     }
 
-    for (ezUInt32 blockY = 0; blockY < numBlocksY; ++blockY)
-    {
-      for (ezUInt32 blockX = 0; blockX < numBlocksX; ++blockX)
-      {
-        ezUInt8 sourceBlockR[16];
-        ezUInt8 sourceBlockG[16];
+    ezParallelForParams params;
+    params.uiBinSize = 4;
 
-        for (ezUInt32 y = 0; y < 4; ++y)
+    ezTaskSystem::ParallelForIndexed(
+      0, numBlocksY,
+      [&](ezUInt32 uiStartRow, ezUInt32 uiEndRow) {
+        for (ezUInt32 blockY = uiStartRow; blockY < uiEndRow; ++blockY)
         {
-          const ezUInt8* sourcePointer = static_cast<const ezUInt8*>(source.GetPtr()) + (4 * blockY + y) * rowPitch;
-
-          for (ezUInt32 x = 0; x < 4; ++x)
+          for (ezUInt32 blockX = 0; blockX < numBlocksX; ++blockX)
           {
-            sourceBlockR[4 * y + x] = sourcePointer[(x + 4 * blockX) * stride + 0] + bias;
-            sourceBlockG[4 * y + x] = sourcePointer[(x + 4 * blockX) * stride + 1] + bias;
-          }
-        }
-
-        ezUInt8* targetPointer = static_cast<ezUInt8*>(target.GetPtr()) + (blockY * numBlocksX + blockX) * 16;
-
-        {
-          ezUInt32 a0, a1;
-          findBestPaletteBC4(sourceBlockR, a0, a1);
-          packBlockBC4(sourceBlockR, a0, a1, targetPointer);
+            ezUInt8 sourceBlockR[16];
+            ezUInt8 sourceBlockG[16];
 
-          // Undo biasing for signed formats by shifting palette upper and lower bound back into signed range
-          targetPointer[0] -= bias;
-          targetPointer[1] -= bias;
-        }
+            for (ezUInt32 y = 0; y < 4; ++y)
+            {
+              const ezUInt8* sourcePointer = static_cast<const ezUInt8*>(source.GetPtr()) + (4 * blockY + y) * rowPitch;
 
-        {
-          ezUInt32 a0, a1;
-          findBestPaletteBC4(sourceBlockG, a0, a1);
-          packBlockBC4(sourceBlockG, a0, a1, targetPointer + 8);
+              for (ezUInt32 x = 0; x < 4; ++x)
+              {
+                sourceBlockR[4 * y + x] = sourcePointer[(x + 4 * blockX) * stride + 0] + bias;
+                sourceBlockG[4 * y + x] = sourcePointer[(x + 4 * blockX) * stride + 1] + bias;
+              }
+            }
 
-          // Undo biasing for signed formats by shifting palette upper and lower bound back into signed range
-          targetPointer[8] -= bias;
-          targetPointer[9] -= bias;
+            ezUInt8* targetPointer = static_cast<ezUInt8*>(target.GetPtr()) + (blockY * numBlocksX + blockX) * 16;
+            CompressBlockBC4(sourceBlockR, bias, quality, targetPointer);
+            CompressBlockBC4(sourceBlockG, bias, quality, targetPointer + 8);
+          }
         }
-      }
-    }
+      },
+      "CompressBC5", params);
 
     return EZ_SUCCESS;
   }
@@ -3055,8 +3070,6 @@ class ezImageConversion_CompressBC5 : public ezImageConversionStepCompressBlocks
 static ezImageConversion_CompressBC4 s_conversion_compressBC4;
 static ezImageConversion_CompressBC5 s_conversion_compressBC5;
 
-#endif
-
 static ezImageConversion_BC1_RGBA s_conversion_BC1_RGBA;
 static ezImageConversion_BC2_RGBA s_conversion_BC2_RGBA;
 static ezImageConversion_BC3_RGBA s_conversion_BC3_RGBA;
@@ -76,6 +76,9 @@ public:
   };
 
   /// Scales the image.
+  ///
+  /// The image is filtered in separate passes along each axis. The rows of each pass are distributed over the task system,
+  /// filtering along Y and Z adds up whole source rows to keep the memory accesses linear.
   static ezResult Scale(const ezImageView& source, ezImage& target, ezUInt32 width, ezUInt32 height, const ezImageFilter* filter = nullptr,
     ezImageAddressMode::Enum addressModeU = ezImageAddressMode::Clamp, ezImageAddressMode::Enum addressModeV = ezImageAddressMode::Clamp,
     const ezColor& borderColor = ezColor::Black);
@@ -87,6 +90,8 @@ public:
     const ezColor& borderColor = ezColor::Black);
 
   /// Genererates the mip maps for the image. The input texture must be in ezImageFormat::R32_G32_B32_A32_FLOAT
+  ///
+  /// Each mip level is computed from the previous one with Scale3D(), so the work of a level is spread over all worker threads.
   static void GenerateMipMaps(const ezImageView& source, ezImage& target, const MipMapOptions& options);
 
   /// Assumes that the Red and Green components of an image contain XY of an unit length normal and reconstructs the Z component into B
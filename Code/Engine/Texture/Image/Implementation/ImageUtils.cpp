@@ -3,6 +3,7 @@
 #include <Texture/Image/ImageUtils.h>
 
 #include <Foundation/SimdMath/SimdVec4f.h>
+#include <Foundation/Threading/TaskSystem.h>
 #include <Texture/Image/ImageConversion.h>
 #include <Texture/Image/ImageEnums.h>
 #include <Texture/Image/ImageFilter.h>
@@ -635,6 +636,84 @@ inline static void FilterLine(
   }
 }
 
+/// \brief Computes one target row as the weighted sum of whole source rows.
+///
+/// This is used for filtering along Y and Z, where filtering single columns would jump through memory for every pixel.
+/// The row is processed in tiles that fit into the L1 cache, each tile accumulates all weighted source rows before moving on.
+template <typename GetSourceRow>
+static void FilterRows(ezUInt32 numSourceRows, GetSourceRow getSourceRow, ezSimdVec4f* __restrict targetRow, ezUInt32 numPixels, const ezImageFilterWeights& weights, ezUInt32 targetIndex,
+  ezInt32 firstSourceIdx, ezImageAddressMode::Enum addressMode, const ezSimdVec4f& borderColor)
+{
+  const ezUInt32 numWeights = weights.GetNumWeights();
+
+  ezHybridArray<const ezSimdVec4f*, 32> sourceRows;
+  ezHybridArray<float, 32> rowWeights;
+
+  // rows outside of the image that use the border color add the same value to every pixel
+  ezSimdVec4f borderContribution = ezSimdVec4f::ZeroVector();
+
+  for (ezUInt32 weightIdx = 0; weightIdx < numWeights; ++weightIdx)
+  {
+    const ezSimdFloat weight = weights.GetWeight(targetIndex, weightIdx);
+
+    bool useBorderColor = false;
+    const ezUInt32 sourceIdx = ezImageUtils::GetSampleIndex(numSourceRows, firstSourceIdx + static_cast<ezInt32>(weightIdx), addressMode, useBorderColor);
+
+    if (useBorderColor)
+    {
+      borderContribution = ezSimdVec4f::MulAdd(borderColor, weight, borderContribution);
+    }
+    else
+    {
+      sourceRows.PushBack(getSourceRow(sourceIdx));
+      rowWeights.PushBack(weight);
+    }
+  }
+
+  constexpr ezUInt32 tileSize = 256;
+
+  for (ezUInt32 tileStart = 0; tileStart < numPixels; tileStart += tileSize)
+  {
+    const ezUInt32 tileEnd = ezMath::Min(tileStart + tileSize, numPixels);
+
+    for (ezUInt32 x = tileStart; x < tileEnd; ++x)
+    {
+      targetRow[x] = borderContribution;
+    }
+
+    for (ezUInt32 rowIdx = 0; rowIdx < sourceRows.GetCount(); ++rowIdx)
+    {
+      const ezSimdVec4f* __restrict sourceRow = sourceRows[rowIdx];
+      const ezSimdVec4f weight(rowWeights[rowIdx]);
+
+      for (ezUInt32 x = tileStart; x < tileEnd; ++x)
+      {
+        targetRow[x] = ezSimdVec4f::MulAdd(sourceRow[x], weight, targetRow[x]);
+      }
+    }
+  }
+}
+
+/// \brief Calls func for every line index, distributing the lines over all worker threads.
+///
+/// Small images are processed on the calling thread, the bin size makes sure that each task has enough pixels to work on.
+template <typename Func>
+static void ForEachLine(ezUInt32 numLines, ezUInt32 workPerLine, const char* szTaskName, Func func)
+{
+  ezParallelForParams params;
+  params.uiBinSize = ezMath::Max(1u, 16 * 1024 / ezMath::Max(1u, workPerLine));
+
+  ezTaskSystem::ParallelForIndexed(
+    0, numLines,
+    [&](ezUInt32 startLine, ezUInt32 endLine) {
+      for (ezUInt32 line = startLine; line < endLine; ++line)
+      {
+        func(line);
+      }
+    },
+    szTaskName, params);
+}
+
 static void DownScaleFastLine(ezUInt32 pixelStride, const ezUInt8* src, ezUInt8* dest, ezUInt32 lengthIn, ezUInt32 strideIn, ezUInt32 lengthOut, ezUInt32 strideOut)
 {
   const ezUInt32 downScaleFactor = lengthIn / lengthOut;
@@ -893,6 +972,8 @@ ezResult ezImageUtils::Scale3D(const ezImageView& source, ezImage& target, ezUIn
   ezHybridArray<ezInt32, 256> firstSampleIndices;
   firstSampleIndices.Reserve(ezMath::Max(width, height, depth));
 
+  const ezSimdVec4f vBorderColor(borderColor.r, borderColor.g, borderColor.b, borderColor.a);
+
   if (width != originalWidth)
   {
     ezImageFilterWeights weights(*filter, originalWidth, width);
@@ -916,21 +997,16 @@ ezResult ezImageUtils::Scale3D(const ezImageView& source, ezImage& target, ezUIn
     stepHeader.SetWidth(width);
     stepTarget->ResetAndAlloc(stepHeader);
 
-    for (ezUInt32 arrayIndex = 0; arrayIndex < numArrayElements; ++arrayIndex)
-    {
-      for (ezUInt32 face = 0; face < numFaces; ++face)
-      {
-        for (ezUInt32 z = 0; z < originalDepth; ++z)
-        {
-          for (ezUInt32 y = 0; y < originalHeight; ++y)
-          {
-            const ezSimdVec4f* filterSource = stepSource->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, 0, y, z);
-            ezSimdVec4f* filterTarget = stepTarget->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, 0, y, z);
-            FilterLine(originalWidth, filterSource, filterTarget, 1, weights, firstSampleIndices, addressModeU, ezSimdVec4f(borderColor.r, borderColor.g, borderColor.b, borderColor.a));
-          }
-        }
-      }
-    }
+    ForEachLine(numArrayElements * numFaces * originalDepth * originalHeight, width, "ScaleImageX", [&](ezUInt32 line) {
+      const ezUInt32 y = line % originalHeight;
+      const ezUInt32 z = (line / originalHeight) % originalDepth;
+      const ezUInt32 face = (line / (originalHeight * originalDepth)) % numFaces;
+      const ezUInt32 arrayIndex = line / (originalHeight * originalDepth * numFaces);
+
+      const ezSimdVec4f* filterSource = stepSource->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, 0, y, z);
+      ezSimdVec4f* filterTarget = stepTarget->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, 0, y, z);
+      FilterLine(originalWidth, filterSource, filterTarget, 1, weights, firstSampleIndices, addressModeU, vBorderColor);
+    });
 
     releaseScratch(*stepSource);
     stepSource = stepTarget;
@@ -959,21 +1035,17 @@ ezResult ezImageUtils::Scale3D(const ezImageView& source, ezImage& target, ezUIn
     stepHeader.SetHeight(height);
     stepTarget->ResetAndAlloc(stepHeader);
 
-    for (ezUInt32 arrayIndex = 0; arrayIndex < numArrayElements; ++arrayIndex)
-    {
-      for (ezUInt32 face = 0; face < numFaces; ++face)
-      {
-        for (ezUInt32 z = 0; z < originalDepth; ++z)
-        {
-          for (ezUInt32 x = 0; x < width; ++x)
-          {
-            const ezSimdVec4f* filterSource = stepSource->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, x, 0, z);
-            ezSimdVec4f* filterTarget = stepTarget->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, x, 0, z);
-            FilterLine(originalHeight, filterSource, filterTarget, width, weights, firstSampleIndices, addressModeV, ezSimdVec4f(borderColor.r, borderColor.g, borderColor.b, borderColor.a));
-          }
-        }
-      }
-    }
+    // filter whole rows instead of single columns, which keeps the memory accesses linear
+    ForEachLine(numArrayElements * numFaces * originalDepth * height, width * weights.GetNumWeights(), "ScaleImageY", [&](ezUInt32 line) {
+      const ezUInt32 y = line % height;
+      const ezUInt32 z = (line / height) % originalDepth;
+      const ezUInt32 face = (line / (height * originalDepth)) % numFaces;
+      const ezUInt32 arrayIndex = line / (height * originalDepth * numFaces);
+
+      auto getSourceRow = [&](ezUInt32 sourceY) { return stepSource->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, 0, sourceY, z); };
+      ezSimdVec4f* filterTarget = stepTarget->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, 0, y, z);
+      FilterRows(originalHeight, getSourceRow, filterTarget, width, weights, y, firstSampleIndices[y], addressModeV, vBorderColor);
+    });
 
     releaseScratch(*stepSource);
     stepSource = stepTarget;
@@ -1002,21 +1074,16 @@ ezResult ezImageUtils::Scale3D(const ezImageView& source, ezImage& target, ezUIn
     stepHeader.SetDepth(depth);
     stepTarget->ResetAndAlloc(stepHeader);
 
-    for (ezUInt32 arrayIndex = 0; arrayIndex < numArrayElements; ++arrayIndex)
-    {
-      for (ezUInt32 face = 0; face < numFaces; ++face)
-      {
-        for (ezUInt32 y = 0; y < height; ++y)
-        {
-          for (ezUInt32 x = 0; x < width; ++x)
-          {
-            const ezSimdVec4f* filterSource = stepSource->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, x, y, 0);
-            ezSimdVec4f* filterTarget = stepTarget->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, x, y, 0);
-            FilterLine(originalHeight, filterSource, filterTarget, width * height, weights, firstSampleIndices, addressModeW, ezSimdVec4f(borderColor.r, borderColor.g, borderColor.b, borderColor.a));
-          }
-        }
-      }
-    }
+    ForEachLine(numArrayElements * numFaces * depth * height, width * weights.GetNumWeights(), "ScaleImageZ", [&](ezUInt32 line) {
+      const ezUInt32 y = line % height;
+      const ezUInt32 z = (line / height) % depth;
+      const ezUInt32 face = (line / (height * depth)) % numFaces;
+      const ezUInt32 arrayIndex = line / (height * depth * numFaces);
+
+      auto getSourceRow = [&](ezUInt32 sourceZ) { return stepSource->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, 0, y, sourceZ); };
+      ezSimdVec4f* filterTarget = stepTarget->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, 0, y, z);
+      FilterRows(originalDepth, getSourceRow, filterTarget, width, weights, z, firstSampleIndices[z], addressModeW, vBorderColor);
+    });
 
     releaseScratch(*stepSource);
     stepSource = stepTarget;
@@ -1,5 +1,9 @@
 #include <Texture/TexturePCH.h>
 
+#include <Foundation/Algorithm/HashingUtils.h>
+#include <Foundation/IO/FileSystem/FileReader.h>
+#include <Foundation/IO/MemoryStream.h>
+#include <Texture/Image/Formats/ImageFileFormat.h>
 #include <Texture/Image/ImageUtils.h>
 #include <Texture/TexConv/TexConvProcessor.h>
 
@@ -17,6 +21,8 @@ ezResult ezTexConvProcessor::LoadInputImages()
     return EZ_FAILURE;
   }
 
+  m_InputHashes.Clear();
+
   if (!m_Descriptor.m_InputImages.IsEmpty())
   {
     // make sure the two arrays have the same size
@@ -27,6 +33,8 @@ ezResult ezTexConvProcessor::LoadInputImages()
     {
       tmp.Format("InputImage{}", ezArgI(i, 2, true));
       m_Descriptor.m_InputFiles[i] = tmp;
+
+      m_InputHashes.PushBack(m_Cache.IsEnabled() ? ComputeImageHash(m_Descriptor.m_InputImages[i]) : 0);
     }
   }
   else
@@ -36,11 +44,14 @@ ezResult ezTexConvProcessor::LoadInputImages()
     for (const auto& file : m_Descriptor.m_InputFiles)
     {
       auto& img = m_Descriptor.m_InputImages.ExpandAndGetRef();
-      if (img.LoadFrom(file).Failed())
+      ezUInt64 uiContentHash = 0;
+      if (LoadInputImage(file, img, uiContentHash).Failed())
       {
         ezLog::Error("Could not load input file '{0}'.", ezArgSensitive(file, "File"));
         return EZ_FAILURE;
       }
+
+      m_InputHashes.PushBack(uiContentHash);
     }
   }
 
@@ -58,6 +69,50 @@ ezResult ezTexConvProcessor::LoadInputImages()
   return EZ_SUCCESS;
 }
 
+ezResult ezTexConvProcessor::LoadInputImage(const char* szFile, ezImage& out_Image, ezUInt64& out_uiContentHash)
+{
+  if (!m_Cache.IsEnabled())
+  {
+    out_uiContentHash = 0;
+    return out_Image.LoadFrom(szFile);
+  }
+
+  ezFileReader reader;
+  if (reader.Open(szFile).Failed())
+    return EZ_FAILURE;
+
+  // the decoded image is cached under the hash of the file content, so we have to read the file in any case
+  ezMemoryStreamStorage content;
+  content.ReadAll(reader);
+  reader.Close();
+
+  const ezStringView sExtension = ezPathUtils::GetFileExtension(szFile);
+  const ezString sExt = sExtension;
+
+  out_uiContentHash = ezHashingUtils::xxHash64(content.GetData(), content.GetStorageSize(), ezHashingUtils::xxHash64String(sExtension));
+
+  if (m_Cache.Load(ezTexConvCacheStage::DecodedInput, out_uiContentHash, out_Image))
+    return EZ_SUCCESS;
+
+  ezImageFileFormat* pFormat = ezImageFileFormat::GetReaderFormat(sExt);
+  if (pFormat == nullptr)
+  {
+    ezLog::Warning("No known image file format for extension '{0}'", sExt);
+    return EZ_FAILURE;
+  }
+
+  ezMemoryStreamReader stream(&content);
+  EZ_SUCCEED_OR_RETURN(pFormat->ReadImage(stream, out_Image, ezLog::GetThreadLocalLogSystem(), sExt));
+
+  // DDS files already store the raw image data, caching them would only duplicate the file
+  if (!sExtension.IsEqual_NoCase("dds"))
+  {
+    m_Cache.Store(ezTexConvCacheStage::DecodedInput, out_uiContentHash, out_Image);
+  }
+
+  return EZ_SUCCESS;
+}
+
 ezResult ezTexConvProcessor::ConvertAndScaleImage(const char* szImageName, ezImage& inout_Image, ezUInt32 uiResolutionX, ezUInt32 uiResolutionY, ezEnum<ezTexConvUsage> usage)
 {
   const bool bSingleChannel = ezImageFormat::GetNumChannels(inout_Image.GetImageFormat()) == 1;
@@ -1,6 +1,9 @@
 #include <Texture/TexturePCH.h>
 
+#include <Foundation/Algorithm/HashStream.h>
+#include <Foundation/Algorithm/HashingUtils.h>
 #include <Foundation/Reflection/ReflectionUtils.h>
+#include <Texture/Image/Conversions/BlockCompression.h>
 #include <Texture/Image/ImageUtils.h>
 #include <Texture/TexConv/TexConvProcessor.h>
 
@@ -20,10 +23,17 @@ EZ_BEGIN_STATIC_REFLECTED_ENUM(ezTexConvUsage, 1)
 EZ_END_STATIC_REFLECTED_ENUM;
 // clang=format on
 
+// Increase this whenever the processing of one of the cached stages changes, to invalidate all existing cache entries.
+static constexpr ezUInt64 s_uiCachedPipelineVersion = 1;
+
 ezTexConvProcessor::ezTexConvProcessor() = default;
 
 ezResult ezTexConvProcessor::Process()
 {
+  m_Cache.SetCacheDirectory(m_Descriptor.m_sCacheDirectory);
+  m_Cache.SetSizeLimit(m_Descriptor.m_uiCacheSizeLimit);
+  m_Cache.ResetStatistics();
+
   if (m_Descriptor.m_OutputType == ezTexConvOutputType::Atlas)
   {
     ezMemoryStreamWriter stream(&m_TextureAtlas);
@@ -58,49 +68,160 @@ ezResult ezTexConvProcessor::Process()
 
     ezLog::Info("Target resolution is '{} x {}'", uiTargetResolutionX, uiTargetResolutionY);
 
-    EZ_SUCCEED_OR_RETURN(ConvertAndScaleInputImages(uiTargetResolutionX, uiTargetResolutionY, m_Descriptor.m_Usage));
-
-    EZ_SUCCEED_OR_RETURN(ClampInputValues(m_Descriptor.m_InputImages, m_Descriptor.m_fMaxValue));
+    // every stage key includes the key of the previous stage, so the latest stage that is cached can be used directly
+    const ezUInt64 uiAssembledKey = ComputeAssembledCacheKey(uiTargetResolutionX, uiTargetResolutionY, m_Descriptor.m_Usage);
+    const ezUInt64 uiMipmapsKey = ComputeMipmapsCacheKey(uiAssembledKey, uiNumChannelsUsed);
+    const ezUInt64 uiOutputKey = ComputeOutputCacheKey(uiMipmapsKey, OutputImageFormat);
 
-    if (m_Descriptor.m_Usage == ezTexConvUsage::BumpMap)
+    const bool bConvertBumpMap = m_Descriptor.m_Usage == ezTexConvUsage::BumpMap;
+    if (bConvertBumpMap)
     {
-      EZ_SUCCEED_OR_RETURN(ConvertToNormalMap(m_Descriptor.m_InputImages));
       m_Descriptor.m_Usage = ezTexConvUsage::NormalMap;
     }
 
-    ezImage assembledImg;
-    if (m_Descriptor.m_OutputType == ezTexConvOutputType::Texture2D || m_Descriptor.m_OutputType == ezTexConvOutputType::None)
+    if (!m_Cache.Load(ezTexConvCacheStage::Output, uiOutputKey, m_OutputImage))
     {
-      EZ_SUCCEED_OR_RETURN(Assemble2DTexture(m_Descriptor.m_InputImages[0].GetHeader(), assembledImg));
+      ezImage assembledImg;
 
-      EZ_SUCCEED_OR_RETURN(DilateColor2D(assembledImg));
-    }
-    else if (m_Descriptor.m_OutputType == ezTexConvOutputType::Cubemap)
-    {
-      EZ_SUCCEED_OR_RETURN(AssembleCubemap(assembledImg));
-    }
-    else if (m_Descriptor.m_OutputType == ezTexConvOutputType::Volume)
-    {
-      EZ_SUCCEED_OR_RETURN(Assemble3DTexture(assembledImg));
-    }
+      if (!m_Cache.Load(ezTexConvCacheStage::Mipmaps, uiMipmapsKey, assembledImg))
+      {
+        if (!m_Cache.Load(ezTexConvCacheStage::Assembled, uiAssembledKey, assembledImg))
+        {
+          EZ_SUCCEED_OR_RETURN(AssembleTexture(uiTargetResolutionX, uiTargetResolutionY, bConvertBumpMap, assembledImg));
+
+          m_Cache.Store(ezTexConvCacheStage::Assembled, uiAssembledKey, assembledImg);
+        }
+
+        EZ_SUCCEED_OR_RETURN(
+          GenerateMipmaps(assembledImg, 0, uiNumChannelsUsed == 1 ? MipmapChannelMode::SingleChannel : MipmapChannelMode::AllChannels));
 
-    EZ_SUCCEED_OR_RETURN(AdjustHdrExposure(assembledImg));
+        EZ_SUCCEED_OR_RETURN(PremultiplyAlpha(assembledImg));
 
-    EZ_SUCCEED_OR_RETURN(
-      GenerateMipmaps(assembledImg, 0, uiNumChannelsUsed == 1 ? MipmapChannelMode::SingleChannel : MipmapChannelMode::AllChannels));
+        m_Cache.Store(ezTexConvCacheStage::Mipmaps, uiMipmapsKey, assembledImg);
+      }
 
-    EZ_SUCCEED_OR_RETURN(PremultiplyAlpha(assembledImg));
+      EZ_SUCCEED_OR_RETURN(GenerateOutput(std::move(assembledImg), m_OutputImage, OutputImageFormat));
 
-    EZ_SUCCEED_OR_RETURN(GenerateOutput(std::move(assembledImg), m_OutputImage, OutputImageFormat));
+      m_Cache.Store(ezTexConvCacheStage::Output, uiOutputKey, m_OutputImage);
+    }
 
     EZ_SUCCEED_OR_RETURN(GenerateThumbnailOutput(m_OutputImage, m_ThumbnailOutputImage, m_Descriptor.m_uiThumbnailOutputResolution));
 
     EZ_SUCCEED_OR_RETURN(GenerateLowResOutput(m_OutputImage, m_LowResOutputImage, m_Descriptor.m_uiLowResMipmaps));
+
+    m_Cache.EnforceSizeLimit();
+    m_Cache.LogStatistics();
+  }
+
+  return EZ_SUCCESS;
+}
+
+ezResult ezTexConvProcessor::AssembleTexture(ezUInt32 uiResolutionX, ezUInt32 uiResolutionY, bool bConvertBumpMap, ezImage& dst)
+{
+  EZ_SUCCEED_OR_RETURN(ConvertAndScaleInputImages(uiResolutionX, uiResolutionY, m_Descriptor.m_Usage));
+
+  EZ_SUCCEED_OR_RETURN(ClampInputValues(m_Descriptor.m_InputImages, m_Descriptor.m_fMaxValue));
+
+  if (bConvertBumpMap)
+  {
+    EZ_SUCCEED_OR_RETURN(ConvertToNormalMap(m_Descriptor.m_InputImages));
+  }
+
+  if (m_Descriptor.m_OutputType == ezTexConvOutputType::Texture2D || m_Descriptor.m_OutputType == ezTexConvOutputType::None)
+  {
+    EZ_SUCCEED_OR_RETURN(Assemble2DTexture(m_Descriptor.m_InputImages[0].GetHeader(), dst));
+
+    EZ_SUCCEED_OR_RETURN(DilateColor2D(dst));
+  }
+  else if (m_Descriptor.m_OutputType == ezTexConvOutputType::Cubemap)
+  {
+    EZ_SUCCEED_OR_RETURN(AssembleCubemap(dst));
+  }
+  else if (m_Descriptor.m_OutputType == ezTexConvOutputType::Volume)
+  {
+    EZ_SUCCEED_OR_RETURN(Assemble3DTexture(dst));
   }
 
+  EZ_SUCCEED_OR_RETURN(AdjustHdrExposure(dst));
+
   return EZ_SUCCESS;
 }
 
+ezUInt64 ezTexConvProcessor::ComputeAssembledCacheKey(ezUInt32 uiResolutionX, ezUInt32 uiResolutionY, ezEnum<ezTexConvUsage> usage) const
+{
+  if (!m_Cache.IsEnabled())
+    return 0;
+
+  ezHashStreamWriter64 hash(s_uiCachedPipelineVersion);
+
+  for (ezUInt64 uiInputHash : m_InputHashes)
+  {
+    hash << uiInputHash;
+  }
+
+  for (const auto& mapping : m_Descriptor.m_ChannelMappings)
+  {
+    for (ezUInt32 i = 0; i < 4; ++i)
+    {
+      hash << mapping.m_Channel[i].m_iInputImageIndex;
+      hash << static_cast<ezUInt8>(mapping.m_Channel[i].m_ChannelValue);
+    }
+  }
+
+  hash << uiResolutionX << uiResolutionY;
+  hash << usage.GetValue();
+  hash << m_Descriptor.m_OutputType.GetValue();
+  hash << m_Descriptor.m_BumpMapFilter.GetValue();
+  hash << m_Descriptor.m_fMaxValue;
+  hash << m_Descriptor.m_bFlipHorizontal;
+  hash << m_Descriptor.m_uiDilateColor;
+  hash << m_Descriptor.m_fHdrExposureBias;
+
+  return hash.GetHashValue();
+}
+
+ezUInt64 ezTexConvProcessor::ComputeMipmapsCacheKey(ezUInt64 uiAssembledKey, ezUInt32 uiNumChannels) const
+{
+  if (!m_Cache.IsEnabled())
+    return 0;
+
+  ezHashStreamWriter64 hash(uiAssembledKey);
+
+  hash << m_Descriptor.m_MipmapMode.GetValue();
+  hash << m_Descriptor.m_AddressModeU.GetValue();
+  hash << m_Descriptor.m_AddressModeV.GetValue();
+  hash << m_Descriptor.m_AddressModeW.GetValue();
+  hash << m_Descriptor.m_bPreserveMipmapCoverage;
+  hash << m_Descriptor.m_fMipmapAlphaThreshold;
+  hash << m_Descriptor.m_bPremultiplyAlpha;
+  hash << uiNumChannels;
+
+  return hash.GetHashValue();
+}
+
+ezUInt64 ezTexConvProcessor::ComputeOutputCacheKey(ezUInt64 uiMipmapsKey, ezEnum<ezImageFormat> format)
+{
+  ezHashStreamWriter64 hash(uiMipmapsKey);
+
+  hash << format.GetValue();
+  hash << static_cast<ezUInt8>(ezBlockCompressionQuality::GetConfigured());
+
+  return hash.GetHashValue();
+}
+
+ezUInt64 ezTexConvProcessor::ComputeImageHash(const ezImageView& image)
+{
+  const ezImageHeader& header = image.GetHeader();
+
+  ezUInt32 headerData[] = {static_cast<ezUInt32>(header.GetImageFormat()), header.GetWidth(), header.GetHeight(), header.GetDepth(),
+    header.GetNumMipLevels(), header.GetNumFaces(), header.GetNumArrayIndices()};
+
+  const ezUInt64 uiHeaderHash = ezHashingUtils::xxHash64(headerData, sizeof(headerData));
+
+  ezConstByteBlobPtr data = image.GetByteBlobPtr();
+  return ezHashingUtils::xxHash64(data.GetPtr(), static_cast<size_t>(data.GetCount()), uiHeaderHash);
+}
+
 ezResult ezTexConvProcessor::DetectNumChannels(ezArrayPtr<const ezTexConvSliceChannelMapping> channelMapping, ezUInt32& uiNumChannels)
 {
   uiNumChannels = 0;
@@ -0,0 +1,360 @@
+#include <Texture/TexturePCH.h>
+
+#include <Foundation/IO/MemoryStream.h>
+#include <Foundation/IO/OSFile.h>
+#include <Texture/TexConv/TexConvCache.h>
+
+namespace
+{
+  constexpr ezUInt32 s_uiEntryMagic = 0x43545A45; // 'EZTC'
+  constexpr ezUInt32 s_uiEntryVersion = 1;
+
+  constexpr const char* s_szStageNames[ezTexConvCacheStage::ENUM_COUNT] = {"Input", "Assembled", "Mipmaps", "Output"};
+
+  constexpr ezUInt32 s_uiIndexMagic = 0x49545A45; // 'EZTI'
+  constexpr ezUInt32 s_uiIndexVersion = 1;
+  constexpr const char* s_szIndexFileName = "AccessOrder.ezTexConvCacheIndex";
+
+  /// Entries are written under this extension first and renamed once they are complete.
+  constexpr const char* s_szTempExtension = "ezTexConvCacheTmp";
+
+  struct EntryHeader
+  {
+    ezUInt32 m_uiMagic = s_uiEntryMagic;
+    ezUInt32 m_uiVersion = s_uiEntryVersion;
+    ezUInt64 m_uiKey = 0;
+    ezUInt32 m_uiStage = 0;
+    ezUInt32 m_uiFormat = 0;
+    ezUInt32 m_uiWidth = 0;
+    ezUInt32 m_uiHeight = 0;
+    ezUInt32 m_uiDepth = 0;
+    ezUInt32 m_uiNumMipLevels = 0;
+    ezUInt32 m_uiNumFaces = 0;
+    ezUInt32 m_uiNumArrayIndices = 0;
+    ezUInt64 m_uiDataSize = 0;
+  };
+
+  struct EntryFile
+  {
+    ezString m_sName;
+    ezTimestamp m_LastModification;
+    ezUInt64 m_uiLastAccess = 0; ///< Zero for entries that were never used since the index exists.
+    ezUInt64 m_uiSize = 0;
+  };
+
+  void FormatEntryName(ezTexConvCacheStage::Enum stage, ezUInt64 uiKey, ezStringBuilder& out_sName)
+  {
+    out_sName.Format("{}-{}.ezTexConvCache", s_szStageNames[stage], ezArgU(uiKey, 16, true, 16));
+  }
+
+  /// Returns the number of the most recent access in the index.
+  ezUInt64 ReadAccessIndex(const char* szPath, ezHashTable<ezString, ezUInt64>& out_AccessOrder)
+  {
+    out_AccessOrder.Clear();
+
+    ezOSFile file;
+    if (!ezOSFile::ExistsFile(szPath) || file.Open(szPath, ezFileOpenMode::Read).Failed())
+      return 0;
+
+    ezDynamicArray<ezUInt8> data;
+    file.ReadAll(data);
+
+    ezRawMemoryStreamReader reader(data);
+
+    ezUInt32 uiMagic = 0;
+    ezUInt32 uiVersion = 0;
+    reader >> uiMagic;
+    reader >> uiVersion;
+
+    if (uiMagic != s_uiIndexMagic || uiVersion != s_uiIndexVersion || reader.ReadHashTable(out_AccessOrder).Failed())
+    {
+      ezLog::Warning("Ignoring invalid texture cache index '{}'", szPath);
+      out_AccessOrder.Clear();
+      return 0;
+    }
+
+    ezUInt64 uiMostRecent = 0;
+    for (auto it = out_AccessOrder.GetIterator(); it.IsValid(); ++it)
+    {
+      uiMostRecent = ezMath::Max(uiMostRecent, it.Value());
+    }
+
+    return uiMostRecent;
+  }
+
+  void WriteAccessIndex(const char* szPath, const ezHashTable<ezString, ezUInt64>& accessOrder)
+  {
+    ezDynamicArray<ezUInt8> data;
+    ezMemoryStreamContainerWrapperStorage<ezDynamicArray<ezUInt8>> storage(&data);
+    ezMemoryStreamWriter writer(&storage);
+
+    writer << s_uiIndexMagic;
+    writer << s_uiIndexVersion;
+    writer.WriteHashTable(accessOrder).IgnoreResult();
+
+    ezOSFile file;
+    if (file.Open(szPath, ezFileOpenMode::Write).Failed() || file.Write(data.GetData(), data.GetCount()).Failed())
+    {
+      ezLog::Warning("Failed to write texture cache index '{}'", szPath);
+    }
+  }
+} // namespace
+
+ezTexConvCache::ezTexConvCache() = default;
+
+void ezTexConvCache::SetCacheDirectory(ezStringView sDirectory)
+{
+  ezStringBuilder sPath = sDirectory;
+  sPath.MakeCleanPath();
+  sPath.Trim("", "/");
+
+  m_sDirectory = sPath;
+}
+
+void ezTexConvCache::GetEntryPath(ezTexConvCacheStage::Enum stage, ezUInt64 uiKey, ezStringBuilder& out_sPath) const
+{
+  ezStringBuilder sName;
+  FormatEntryName(stage, uiKey, sName);
+
+  out_sPath = m_sDirectory;
+  out_sPath.AppendPath(sName);
+}
+
+void ezTexConvCache::RecordAccess(ezTexConvCacheStage::Enum stage, ezUInt64 uiKey)
+{
+  ezStringBuilder sName;
+  FormatEntryName(stage, uiKey, sName);
+
+  m_AccessOrder[sName] = ++m_uiNumAccesses;
+}
+
+bool ezTexConvCache::Load(ezTexConvCacheStage::Enum stage, ezUInt64 uiKey, ezImage& out_Image)
+{
+  if (!IsEnabled())
+    return false;
+
+  ezStringBuilder sPath;
+  GetEntryPath(stage, uiKey, sPath);
+
+  ezOSFile file;
+  if (!ezOSFile::ExistsFile(sPath) || file.Open(sPath, ezFileOpenMode::Read).Failed())
+  {
+    m_Statistics.m_uiMisses[stage]++;
+    return false;
+  }
+
+  EntryHeader entry;
+  const bool bValidHeader = file.Read(&entry, sizeof(entry)) == sizeof(entry) && entry.m_uiMagic == s_uiEntryMagic &&
+                            entry.m_uiVersion == s_uiEntryVersion && entry.m_uiKey == uiKey && entry.m_uiStage == static_cast<ezUInt32>(stage) &&
+                            entry.m_uiFormat < ezImageFormat::NUM_FORMATS && file.GetFileSize() == sizeof(entry) + entry.m_uiDataSize;
+
+  if (!bValidHeader)
+  {
+    ezLog::Warning("Ignoring invalid texture cache entry '{}'", sPath);
+    m_Statistics.m_uiMisses[stage]++;
+    return false;
+  }
+
+  ezImageHeader header;
+  header.SetImageFormat(static_cast<ezImageFormat::Enum>(entry.m_uiFormat));
+  header.SetWidth(entry.m_uiWidth);
+  header.SetHeight(entry.m_uiHeight);
+  header.SetDepth(entry.m_uiDepth);
+  header.SetNumMipLevels(entry.m_uiNumMipLevels);
+  header.SetNumFaces(entry.m_uiNumFaces);
+  header.SetNumArrayIndices(entry.m_uiNumArrayIndices);
+
+  if (header.ComputeDataSize() != entry.m_uiDataSize)
+  {
+    ezLog::Warning("Ignoring invalid texture cache entry '{}'", sPath);
+    m_Statistics.m_uiMisses[stage]++;
+    return false;
+  }
+
+  ezImage image;
+  image.ResetAndAlloc(header);
+
+  ezByteBlobPtr data = image.GetByteBlobPtr();
+  if (data.GetCount() < entry.m_uiDataSize || file.Read(data.GetPtr(), entry.m_uiDataSize) != entry.m_uiDataSize)
+  {
+    ezLog::Warning("Failed to read texture cache entry '{}'", sPath);
+    m_Statistics.m_uiMisses[stage]++;
+    return false;
+  }
+
+  out_Image.ResetAndMove(std::move(image));
+
+  RecordAccess(stage, uiKey);
+
+  m_Statistics.m_uiHits[stage]++;
+  m_Statistics.m_uiBytesRead += sizeof(entry) + entry.m_uiDataSize;
+  return true;
+}
+
+void ezTexConvCache::Store(ezTexConvCacheStage::Enum stage, ezUInt64 uiKey, const ezImageView& image)
+{
+  if (!IsEnabled() || !image.IsValid())
+    return;
+
+  EntryHeader entry;
+  entry.m_uiKey = uiKey;
+  entry.m_uiStage = stage;
+  entry.m_uiFormat = image.GetImageFormat();
+  entry.m_uiWidth = image.GetWidth();
+  entry.m_uiHeight = image.GetHeight();
+  entry.m_uiDepth = image.GetDepth();
+  entry.m_uiNumMipLevels = image.GetNumMipLevels();
+  entry.m_uiNumFaces = image.GetNumFaces();
+  entry.m_uiNumArrayIndices = image.GetNumArrayIndices();
+  entry.m_uiDataSize = image.GetHeader().ComputeDataSize();
+
+  ezConstByteBlobPtr data = image.GetByteBlobPtr();
+  EZ_ASSERT_DEV(data.GetCount() >= entry.m_uiDataSize, "Image data is smaller than its header suggests");
+
+  ezStringBuilder sPath;
+  GetEntryPath(stage, uiKey, sPath);
+
+  // the entry only appears under its final name once it is complete, so an interrupted run can't leave a truncated entry behind
+  ezStringBuilder sTempPath = sPath;
+  sTempPath.ChangeFileExtension(s_szTempExtension);
+
+  ezOSFile file;
+  if (file.Open(sTempPath, ezFileOpenMode::Write).Failed() || file.Write(&entry, sizeof(entry)).Failed() ||
+      file.Write(data.GetPtr(), entry.m_uiDataSize).Failed())
+  {
+    file.Close();
+    ezOSFile::DeleteFile(sTempPath).IgnoreResult();
+
+    ezLog::Warning("Failed to write texture cache entry '{}'", sPath);
+    return;
+  }
+
+  file.Close();
+
+  if (ezOSFile::MoveFileOrDirectory(sTempPath, sPath).Failed())
+  {
+    ezOSFile::DeleteFile(sTempPath).IgnoreResult();
+
+    ezLog::Warning("Failed to write texture cache entry '{}'", sPath);
+    return;
+  }
+
+  RecordAccess(stage, uiKey);
+
+  m_Statistics.m_uiBytesWritten += sizeof(entry) + entry.m_uiDataSize;
+}
+
+void ezTexConvCache::EnforceSizeLimit()
+{
+  if (!IsEnabled() || (m_uiSizeLimit == 0 && m_AccessOrder.IsEmpty()))
+    return;
+
+#if EZ_ENABLED(EZ_SUPPORTS_FILE_ITERATORS)
+  ezStringBuilder sIndexPath = m_sDirectory;
+  sIndexPath.AppendPath(s_szIndexFileName);
+
+  // all accesses of this session are more recent than the ones in the index
+  ezHashTable<ezString, ezUInt64> accessOrder;
+  const ezUInt64 uiPrevNumAccesses = ReadAccessIndex(sIndexPath, accessOrder);
+
+  for (auto it = m_AccessOrder.GetIterator(); it.IsValid(); ++it)
+  {
+    accessOrder[it.Key()] = uiPrevNumAccesses + it.Value();
+  }
+
+  m_AccessOrder.Clear();
+  m_uiNumAccesses = 0;
+
+  if (m_uiSizeLimit == 0)
+  {
+    WriteAccessIndex(sIndexPath, accessOrder);
+    return;
+  }
+
+  ezDynamicArray<EntryFile> entries;
+  ezUInt64 uiTotalSize = 0;
+
+  ezStringBuilder sFullPath;
+
+  ezFileSystemIterator it;
+  it.StartSearch(m_sDirectory, ezFileSystemIteratorFlags::ReportFiles);
+
+  while (it.IsValid())
+  {
+    const ezFileStats& stats = it.GetStats();
+
+    // left over temp files of interrupted runs are never in the index, so they are evicted first
+    if (ezPathUtils::HasExtension(stats.m_sName, "ezTexConvCache") || ezPathUtils::HasExtension(stats.m_sName, s_szTempExtension))
+    {
+      auto& entry = entries.ExpandAndGetRef();
+      entry.m_sName = stats.m_sName;
+      entry.m_LastModification = stats.m_LastModificationTime;
+      entry.m_uiSize = stats.m_uiFileSize;
+      accessOrder.TryGetValue(stats.m_sName, entry.m_uiLastAccess);
+
+      uiTotalSize += stats.m_uiFileSize;
+    }
+
+    it.Next();
+  }
+
+  // least recently used first, entries that are not in the index are older than all others
+  entries.Sort([](const EntryFile& a, const EntryFile& b) -> bool {
+    if (a.m_uiLastAccess != b.m_uiLastAccess)
+      return a.m_uiLastAccess < b.m_uiLastAccess;
+
+    return a.m_LastModification.GetInt64(ezSIUnitOfTime::Microsecond) < b.m_LastModification.GetInt64(ezSIUnitOfTime::Microsecond);
+  });
+
+  // the index only keeps the entries that still exist
+  accessOrder.Clear();
+
+  for (const EntryFile& entry : entries)
+  {
+    if (uiTotalSize > m_uiSizeLimit)
+    {
+      sFullPath = m_sDirectory;
+      sFullPath.AppendPath(entry.m_sName);
+
+      if (ezOSFile::DeleteFile(sFullPath).Succeeded())
+      {
+        uiTotalSize -= entry.m_uiSize;
+
+        m_Statistics.m_uiEvictedEntries++;
+        m_Statistics.m_uiBytesEvicted += entry.m_uiSize;
+        continue;
+      }
+    }
+
+    if (entry.m_uiLastAccess != 0)
+    {
+      accessOrder.Insert(entry.m_sName, entry.m_uiLastAccess);
+    }
+  }
+
+  WriteAccessIndex(sIndexPath, accessOrder);
+#endif
+}
+
+void ezTexConvCache::LogStatistics() const
+{
+  if (!IsEnabled())
+    return;
+
+  ezStringBuilder sLine, sTmp;
+
+  for (ezUInt32 stage = 0; stage < ezTexConvCacheStage::ENUM_COUNT; ++stage)
+  {
+    if (m_Statistics.m_uiHits[stage] + m_Statistics.m_uiMisses[stage] == 0)
+      continue;
+
+    sTmp.Format("{}{}: {} hits / {} misses", sLine.IsEmpty() ? "" : ", ", s_szStageNames[stage], m_Statistics.m_uiHits[stage], m_Statistics.m_uiMisses[stage]);
+    sLine.Append(sTmp.GetView());
+  }
+
+  ezLog::Info("Texture cache: {}", sLine);
+  ezLog::Info("Texture cache: {} read, {} written, {} entries evicted ({})", ezArgFileSize(m_Statistics.m_uiBytesRead),
+    ezArgFileSize(m_Statistics.m_uiBytesWritten), m_Statistics.m_uiEvictedEntries, ezArgFileSize(m_Statistics.m_uiBytesEvicted));
+}
+
+EZ_STATICLINK_FILE(Texture, Texture_TexConv_Implementation_TexConvCache);
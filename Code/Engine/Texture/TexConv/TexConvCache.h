@@ -0,0 +1,88 @@
+#pragma once
+
+#include <Foundation/Containers/HashTable.h>
+#include <Foundation/Strings/String.h>
+#include <Texture/Image/Image.h>
+
+/// \brief The intermediate results of ezTexConvProcessor that can be stored in an ezTexConvCache.
+struct ezTexConvCacheStage
+{
+  enum Enum
+  {
+    DecodedInput, ///< An input file after decoding, in its original format.
+    Assembled,    ///< The RGBA image after channel mapping, scaling, dilation and exposure adjustment.
+    Mipmaps,      ///< The assembled image with its full mip chain (and premultiplied alpha).
+    Output,       ///< The final image in the output format.
+
+    ENUM_COUNT
+  };
+
+  using StorageType = ezUInt8;
+};
+
+/// \brief Counters for how effective an ezTexConvCache was.
+struct EZ_TEXTURE_DLL ezTexConvCacheStatistics
+{
+  ezUInt32 m_uiHits[ezTexConvCacheStage::ENUM_COUNT] = {};
+  ezUInt32 m_uiMisses[ezTexConvCacheStage::ENUM_COUNT] = {};
+
+  ezUInt64 m_uiBytesRead = 0;
+  ezUInt64 m_uiBytesWritten = 0;
+
+  ezUInt32 m_uiEvictedEntries = 0;
+  ezUInt64 m_uiBytesEvicted = 0;
+};
+
+/// \brief A content-addressed disk cache for the intermediate images of a texture conversion.
+///
+/// Every entry is stored as one file in the cache directory, named after its stage and its key.
+/// The keys are hashes over everything that influences the result of a stage (input file content and the relevant settings),
+/// so entries never have to be invalidated, they just stop being used. EnforceSizeLimit() deletes the least recently used
+/// entries once the cache grows too large. The order in which the entries were used is kept in an index file in the cache directory,
+/// which is updated by EnforceSizeLimit(). Processes that share a cache directory may lose some of each other's updates of the index.
+///
+/// As long as no directory is set, the cache is disabled and all lookups miss.
+class EZ_TEXTURE_DLL ezTexConvCache
+{
+  EZ_DISALLOW_COPY_AND_ASSIGN(ezTexConvCache);
+
+public:
+  ezTexConvCache();
+
+  /// \brief Sets the directory in which the cache entries are stored. An empty string disables the cache.
+  void SetCacheDirectory(ezStringView sDirectory);
+  const ezString& GetCacheDirectory() const { return m_sDirectory; }
+
+  bool IsEnabled() const { return !m_sDirectory.IsEmpty(); }
+
+  /// \brief The maximum number of bytes that all entries together may take up. Zero means unlimited.
+  void SetSizeLimit(ezUInt64 uiBytes) { m_uiSizeLimit = uiBytes; }
+  ezUInt64 GetSizeLimit() const { return m_uiSizeLimit; }
+
+  /// \brief Reads the entry for the given stage and key into \a out_Image. Returns false if there is no valid entry.
+  bool Load(ezTexConvCacheStage::Enum stage, ezUInt64 uiKey, ezImage& out_Image);
+
+  /// \brief Writes \a image as the entry for the given stage and key. Failing to write an entry is not an error, it is only logged.
+  void Store(ezTexConvCacheStage::Enum stage, ezUInt64 uiKey, const ezImageView& image);
+
+  /// \brief Stores the order in which the entries were used and deletes the least recently used ones until the cache fits into the size
+  /// limit again.
+  void EnforceSizeLimit();
+
+  const ezTexConvCacheStatistics& GetStatistics() const { return m_Statistics; }
+  void ResetStatistics() { m_Statistics = ezTexConvCacheStatistics(); }
+
+  /// \brief Writes the statistics to the log.
+  void LogStatistics() const;
+
+private:
+  void GetEntryPath(ezTexConvCacheStage::Enum stage, ezUInt64 uiKey, ezStringBuilder& out_sPath) const;
+  void RecordAccess(ezTexConvCacheStage::Enum stage, ezUInt64 uiKey);
+
+  ezString m_sDirectory;
+  ezUInt64 m_uiSizeLimit = 0;
+  ezTexConvCacheStatistics m_Statistics;
+
+  ezUInt64 m_uiNumAccesses = 0;
+  ezHashTable<ezString, ezUInt64> m_AccessOrder; ///< Entry file name to the number of the last access, since the index was last written.
+};
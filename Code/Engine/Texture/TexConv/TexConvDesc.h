@@ -83,4 +83,8 @@ public:
 
   // Bump map filter
   ezEnum<ezTexConvBumpMapFilter> m_BumpMapFilter;
+
+  // Intermediate results cache, disabled when no directory is set
+  ezString m_sCacheDirectory;
+  ezUInt64 m_uiCacheSizeLimit = 0; // in bytes, zero means unlimited
 };
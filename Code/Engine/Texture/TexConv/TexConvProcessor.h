@@ -2,6 +2,7 @@
 
 #include <Foundation/IO/MemoryStream.h>
 #include <Foundation/Math/Rect.h>
+#include <Texture/TexConv/TexConvCache.h>
 #include <Texture/TexConv/TexConvDesc.h>
 
 struct ezTextureAtlasCreationDesc;
@@ -22,11 +23,15 @@ public:
   ezImage m_ThumbnailOutputImage;
   ezMemoryStreamStorage m_TextureAtlas;
 
+  /// \brief How often the intermediate results cache was used during Process(). See ezTexConvDesc::m_sCacheDirectory.
+  const ezTexConvCacheStatistics& GetCacheStatistics() const { return m_Cache.GetStatistics(); }
+
 private:
   //////////////////////////////////////////////////////////////////////////
   // Modifying the Descriptor
 
   ezResult LoadInputImages();
+  ezResult LoadInputImage(const char* szFile, ezImage& out_Image, ezUInt64& out_uiContentHash);
   ezResult ForceSRGBFormats();
   ezResult ConvertAndScaleInputImages(ezUInt32 uiResolutionX, ezUInt32 uiResolutionY, ezEnum<ezTexConvUsage> usage);
   ezResult ConvertToNormalMap(ezImage& bumpMap) const;
@@ -55,6 +60,18 @@ private:
   ezResult DilateColor2D(ezImage& img) const;
   ezResult Assemble2DSlice(const ezTexConvSliceChannelMapping& mapping, ezUInt32 uiResolutionX, ezUInt32 uiResolutionY, ezColor* pPixelOut) const;
   ezResult GenerateMipmaps(ezImage& img, ezUInt32 uiNumMips /* =0 */, MipmapChannelMode channelMode = MipmapChannelMode::AllChannels) const;
+  ezResult AssembleTexture(ezUInt32 uiResolutionX, ezUInt32 uiResolutionY, bool bConvertBumpMap, ezImage& dst);
+
+  //////////////////////////////////////////////////////////////////////////
+  // Intermediate results cache
+
+  ezUInt64 ComputeAssembledCacheKey(ezUInt32 uiResolutionX, ezUInt32 uiResolutionY, ezEnum<ezTexConvUsage> usage) const;
+  ezUInt64 ComputeMipmapsCacheKey(ezUInt64 uiAssembledKey, ezUInt32 uiNumChannels) const;
+  static ezUInt64 ComputeOutputCacheKey(ezUInt64 uiMipmapsKey, ezEnum<ezImageFormat> format);
+  static ezUInt64 ComputeImageHash(const ezImageView& image);
+
+  ezTexConvCache m_Cache;
+  ezHybridArray<ezUInt64, 4> m_InputHashes;
 
   //////////////////////////////////////////////////////////////////////////
   // Purely functional
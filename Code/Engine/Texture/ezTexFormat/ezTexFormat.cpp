@@ -5,19 +5,27 @@
 
 void ezTexFormat::WriteTextureHeader(ezStreamWriter& stream) const
 {
-  ezUInt8 uiFileFormatVersion = 2;
-  stream << uiFileFormatVersion;
-
-  stream << m_bSRGB;
-  stream << m_AddressModeU;
-  stream << m_AddressModeV;
-  stream << m_AddressModeW;
-  stream << m_TextureFilter;
+  if (!m_bStreamableMips)
+  {
+    ezUInt8 uiFileFormatVersion = 2;
+    stream << uiFileFormatVersion;
+
+    stream << m_bSRGB;
+    stream << m_AddressModeU;
+    stream << m_AddressModeV;
+    stream << m_AddressModeW;
+    stream << m_TextureFilter;
+  }
+  else
+  {
+    // only files with the new mip layout need the new version, all others stay readable by older loaders
+    WriteRenderTargetHeader(stream);
+  }
 }
 
 void ezTexFormat::WriteRenderTargetHeader(ezStreamWriter& stream) const
 {
-  ezUInt8 uiFileFormatVersion = 5;
+  ezUInt8 uiFileFormatVersion = 6;
   stream << uiFileFormatVersion;
 
   // version 2
@@ -36,6 +44,9 @@ void ezTexFormat::WriteRenderTargetHeader(ezStreamWriter& stream) const
 
   // version 5
   stream << m_GalRenderTargetFormat;
+
+  // version 6
+  stream << m_bStreamableMips;
 }
 
 void ezTexFormat::ReadHeader(ezStreamReader& stream)
@@ -71,6 +82,12 @@ void ezTexFormat::ReadHeader(ezStreamReader& stream)
   {
     stream >> m_GalRenderTargetFormat;
   }
+
+  // version 6
+  if (uiFileFormatVersion >= 6)
+  {
+    stream >> m_bStreamableMips;
+  }
 }
 
 
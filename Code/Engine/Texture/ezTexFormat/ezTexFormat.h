@@ -28,6 +28,10 @@ struct EZ_TEXTURE_DLL ezTexFormat
   // version 5
   int m_GalRenderTargetFormat = 0;
 
+  // version 6
+  /// If set, the image data following the header is an ezTexMipChain instead of a DDS file.
+  bool m_bStreamableMips = false;
+
   void WriteTextureHeader(ezStreamWriter& stream) const;
   void WriteRenderTargetHeader(ezStreamWriter& stream) const;
   void ReadHeader(ezStreamReader& stream);
@@ -0,0 +1,181 @@
+#include <Texture/TexturePCH.h>
+
+#include <Foundation/IO/Stream.h>
+#include <Texture/ezTexFormat/ezTexMipChain.h>
+
+namespace
+{
+  constexpr ezUInt8 s_uiMipChainVersion = 1;
+
+  ezUInt64 ComputeMipLevelSize(const ezImageHeader& header, ezUInt32 uiMipLevel)
+  {
+    return header.GetDepthPitch(uiMipLevel) * header.GetDepth(uiMipLevel) * header.GetNumFaces() * header.GetNumArrayIndices();
+  }
+} // namespace
+
+// static
+ezResult ezTexMipChain::WriteImage(ezStreamWriter& stream, const ezImageView& image)
+{
+  if (!image.IsValid())
+    return EZ_FAILURE;
+
+  const ezImageHeader& header = image.GetHeader();
+  const ezUInt32 uiNumMipLevels = header.GetNumMipLevels();
+
+  stream << s_uiMipChainVersion;
+  stream << static_cast<ezUInt32>(header.GetImageFormat());
+  stream << header.GetWidth();
+  stream << header.GetHeight();
+  stream << header.GetDepth();
+  stream << uiNumMipLevels;
+  stream << header.GetNumFaces();
+  stream << header.GetNumArrayIndices();
+
+  // the table is written in storage order, i.e. smallest mip first
+  ezUInt64 uiOffset = 0;
+  for (ezUInt32 mip = uiNumMipLevels; mip > 0; --mip)
+  {
+    const ezUInt64 uiSize = ComputeMipLevelSize(header, mip - 1);
+
+    stream << uiOffset;
+    stream << uiSize;
+
+    uiOffset += uiSize;
+  }
+
+  for (ezUInt32 mip = uiNumMipLevels; mip > 0; --mip)
+  {
+    for (ezUInt32 arrayIndex = 0; arrayIndex < header.GetNumArrayIndices(); ++arrayIndex)
+    {
+      for (ezUInt32 face = 0; face < header.GetNumFaces(); ++face)
+      {
+        const ezConstByteBlobPtr data = image.GetSubImageView(mip - 1, face, arrayIndex).GetByteBlobPtr();
+        EZ_SUCCEED_OR_RETURN(stream.WriteBytes(data.GetPtr(), data.GetCount()));
+      }
+    }
+  }
+
+  return EZ_SUCCESS;
+}
+
+ezResult ezTexMipChain::ReadHeader(ezStreamReader& stream)
+{
+  ezUInt8 uiVersion = 0;
+  stream >> uiVersion;
+
+  if (uiVersion != s_uiMipChainVersion)
+  {
+    ezLog::Error("Unsupported texture mip chain version {}", uiVersion);
+    return EZ_FAILURE;
+  }
+
+  ezUInt32 uiFormat = 0, uiWidth = 0, uiHeight = 0, uiDepth = 0, uiNumMipLevels = 0, uiNumFaces = 0, uiNumArrayIndices = 0;
+  stream >> uiFormat;
+  stream >> uiWidth;
+  stream >> uiHeight;
+  stream >> uiDepth;
+  stream >> uiNumMipLevels;
+  stream >> uiNumFaces;
+  stream >> uiNumArrayIndices;
+
+  if (uiFormat >= ezImageFormat::NUM_FORMATS || uiNumMipLevels == 0 || uiNumMipLevels > 32 || uiNumFaces == 0 || uiNumArrayIndices == 0)
+  {
+    ezLog::Error("Invalid texture mip chain header");
+    return EZ_FAILURE;
+  }
+
+  m_Header.SetImageFormat(static_cast<ezImageFormat::Enum>(uiFormat));
+  m_Header.SetWidth(uiWidth);
+  m_Header.SetHeight(uiHeight);
+  m_Header.SetDepth(uiDepth);
+  m_Header.SetNumMipLevels(uiNumMipLevels);
+  m_Header.SetNumFaces(uiNumFaces);
+  m_Header.SetNumArrayIndices(uiNumArrayIndices);
+
+  m_MipLevels.SetCount(uiNumMipLevels);
+
+  for (ezUInt32 mip = uiNumMipLevels; mip > 0; --mip)
+  {
+    MipLevel& level = m_MipLevels[mip - 1];
+    stream >> level.m_uiOffset;
+    stream >> level.m_uiSize;
+
+    if (level.m_uiSize != ComputeMipLevelSize(m_Header, mip - 1))
+    {
+      ezLog::Error("Texture mip chain size of mip level {} does not match its header", mip - 1);
+      return EZ_FAILURE;
+    }
+  }
+
+  return EZ_SUCCESS;
+}
+
+ezResult ezTexMipChain::ReadMipLevels(ezStreamReader& stream, ezUInt32 uiNumMipLevels, ezImage& out_Image) const
+{
+  uiNumMipLevels = ezMath::Clamp(uiNumMipLevels, 1u, GetNumMipLevels());
+
+  const ezUInt32 uiFirstMipLevel = GetNumMipLevels() - uiNumMipLevels;
+
+  ezImageHeader header = m_Header;
+  header.SetWidth(m_Header.GetWidth(uiFirstMipLevel));
+  header.SetHeight(m_Header.GetHeight(uiFirstMipLevel));
+  header.SetDepth(m_Header.GetDepth(uiFirstMipLevel));
+  header.SetNumMipLevels(uiNumMipLevels);
+
+  out_Image.ResetAndAlloc(header);
+
+  ezUInt64 uiPosition = 0;
+
+  for (ezUInt32 mip = GetNumMipLevels(); mip > uiFirstMipLevel; --mip)
+  {
+    const MipLevel& level = m_MipLevels[mip - 1];
+
+    if (level.m_uiOffset < uiPosition)
+    {
+      ezLog::Error("Invalid offset for texture mip level {}", mip - 1);
+      return EZ_FAILURE;
+    }
+
+    if (level.m_uiOffset > uiPosition)
+    {
+      const ezUInt64 uiSkip = level.m_uiOffset - uiPosition;
+      if (stream.SkipBytes(uiSkip) != uiSkip)
+        return EZ_FAILURE;
+
+      uiPosition = level.m_uiOffset;
+    }
+
+    for (ezUInt32 arrayIndex = 0; arrayIndex < header.GetNumArrayIndices(); ++arrayIndex)
+    {
+      for (ezUInt32 face = 0; face < header.GetNumFaces(); ++face)
+      {
+        ezByteBlobPtr data = out_Image.GetSubImageView(mip - 1 - uiFirstMipLevel, face, arrayIndex).GetByteBlobPtr();
+
+        if (stream.ReadBytes(data.GetPtr(), data.GetCount()) != data.GetCount())
+        {
+          ezLog::Error("Failed to read texture mip level {}", mip - 1);
+          return EZ_FAILURE;
+        }
+
+        uiPosition += data.GetCount();
+      }
+    }
+  }
+
+  return EZ_SUCCESS;
+}
+
+ezUInt64 ezTexMipChain::GetDataSize(ezUInt32 uiNumMipLevels) const
+{
+  uiNumMipLevels = ezMath::Min(uiNumMipLevels, GetNumMipLevels());
+
+  ezUInt64 uiSize = 0;
+  for (ezUInt32 i = 0; i < uiNumMipLevels; ++i)
+  {
+    uiSize += m_MipLevels[GetNumMipLevels() - 1 - i].m_uiSize;
+  }
+
+  return uiSize;
+}
+
+EZ_STATICLINK_FILE(Texture, Texture_ezTexFormat_ezTexMipChain);
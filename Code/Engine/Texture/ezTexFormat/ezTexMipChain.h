@@ -0,0 +1,45 @@
+#pragma once
+
+#include <Foundation/Containers/HybridArray.h>
+#include <Texture/Image/Image.h>
+
+class ezStreamWriter;
+class ezStreamReader;
+
+/// \brief A texture file layout that stores the mip levels smallest-first, so that a loader can read only the low resolution mips.
+///
+/// The layout consists of the image header of the full texture and a table with the offset and size of every mip level,
+/// followed by the mip data. Each mip level is stored with all its faces and array slices, starting with the smallest one.
+/// Reading the beginning of the data thus yields the mip tail of the texture, and the higher mips can be read later on demand.
+struct EZ_TEXTURE_DLL ezTexMipChain
+{
+  struct MipLevel
+  {
+    ezUInt64 m_uiOffset = 0; ///< Offset of the mip data, relative to the end of the header.
+    ezUInt64 m_uiSize = 0;   ///< Size of the mip data, including all faces and array slices.
+  };
+
+  /// \brief The header of the full resolution texture.
+  ezImageHeader m_Header;
+
+  /// \brief One entry per mip level, indexed like the mips of m_Header. Index 0 is the full resolution mip, which is stored last.
+  ezHybridArray<MipLevel, 16> m_MipLevels;
+
+  /// \brief Writes the header and the mip data of \a image in the smallest-first layout.
+  static ezResult WriteImage(ezStreamWriter& stream, const ezImageView& image);
+
+  /// \brief Reads the header and the mip table. The stream is positioned at the start of the mip data afterwards.
+  ezResult ReadHeader(ezStreamReader& stream);
+
+  /// \brief Reads the \a uiNumMipLevels smallest mips into \a out_Image. Must be called directly after ReadHeader().
+  ///
+  /// The resulting image starts at mip level 'GetNumMipLevels() - uiNumMipLevels' of the full texture.
+  /// Data for larger mips is not read from the stream.
+  ezResult ReadMipLevels(ezStreamReader& stream, ezUInt32 uiNumMipLevels, ezImage& out_Image) const;
+
+  /// \brief Returns the number of mip levels of the full texture.
+  ezUInt32 GetNumMipLevels() const { return m_MipLevels.GetCount(); }
+
+  /// \brief Returns how many bytes the \a uiNumMipLevels smallest mips take up.
+  ezUInt64 GetDataSize(ezUInt32 uiNumMipLevels) const;
+};
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <Foundation/Containers/Deque.h>
+#include <Foundation/Containers/DynamicArray.h>
 #include <Foundation/Math/Math.h>
 #include <Utilities/PathFinding/PathState.h>
 #include <Utilities/UtilitiesDLL.h>
@@ -11,6 +13,10 @@
 ///
 /// PathStateType must be derived from ezPathState and can be used for keeping track of certain state along a path and to modify
 /// the path search dynamically.
+///
+/// The nodes that still need to be expanded are kept in an indexed binary heap, so picking the next node and updating the costs of a
+/// node that is reached again on a cheaper path are both O(log n). All memory is kept between searches, so reusing one ezPathSearch
+/// object for many searches does not allocate anymore once it has seen its largest search.
 template <typename PathStateType>
 class ezPathSearch
 {
@@ -33,6 +39,13 @@ public:
   /// \brief Sets the ezPathStateGenerator that should be used by this ezPathSearch object.
   void SetPathStateGenerator(ezPathStateGenerator<PathStateType>* pStateGenerator) { m_pStateGenerator = pStateGenerator; }
 
+  /// \brief Makes the search look up node states in a flat array instead of a hash table.
+  ///
+  /// All node indices must then be in the range [0; uiNumNodes), which is the case for grid graphs where the node index is the cell index.
+  /// The array is allocated once and not cleared between searches, so this is only worth it when searches touch a decent part of the graph.
+  /// Pass 0 to go back to the hash table, which supports arbitrary node indices.
+  void SetDenseNodeCount(ezUInt32 uiNumNodes);
+
   /// \brief Searches for a path that starts at the graph node \a iStartNodeIndex with the start state \a StartState and shall terminate
   /// when the graph node \a iTargetNodeIndex was reached.
   ///
@@ -57,17 +70,40 @@ public:
   void AddPathNode(ezInt64 iNodeIndex, const PathStateType& NewState);
 
 private:
+  struct NodeState
+  {
+    PathStateType m_State;
+    ezInt64 m_iNodeIndex;
+
+    /// Position in the open heap, ezInvalidIndex once the node has been expanded.
+    ezUInt32 m_uiHeapIndex;
+  };
+
   void ClearPathStates();
+  ezUInt32 FindState(ezInt64 iNodeIndex) const;
+  ezUInt32 AddState(ezInt64 iNodeIndex);
   ezInt64 FindBestNodeToExpand(PathStateType*& out_pPathState);
   void FillOutPathResult(ezInt64 iEndNodeIndex, ezDeque<PathResultData>& out_Path);
 
-  ezPathStateGenerator<PathStateType>* m_pStateGenerator;
+  void HeapPush(ezUInt32 uiStateIndex);
+  ezUInt32 HeapPop();
+  void HeapSiftUp(ezUInt32 uiHeapIndex);
+  void HeapSiftDown(ezUInt32 uiHeapIndex);
+  bool HeapLess(ezUInt32 uiHeapIndexA, ezUInt32 uiHeapIndexB) const;
+  void HeapSet(ezUInt32 uiHeapIndex, ezUInt32 uiStateIndex);
+
+  ezPathStateGenerator<PathStateType>* m_pStateGenerator = nullptr;
+
+  ezDynamicArray<NodeState> m_States;
+  ezHashTable<ezInt64, ezUInt32> m_StateIndices;
 
-  ezHashTable<ezInt64, PathStateType> m_PathStates;
+  // For dense node indices. Entries are never reset, an entry is only valid if it points to a state that belongs to the same node.
+  ezDynamicArray<ezUInt32> m_DenseStateIndices;
 
-  ezDeque<ezInt64> m_StateQueue;
+  // The open list, holds indices into m_States.
+  ezDynamicArray<ezUInt32> m_OpenHeap;
 
-  ezInt64 m_iCurNodeIndex;
+  ezInt64 m_iCurNodeIndex = 0;
   PathStateType m_CurState;
 };
 
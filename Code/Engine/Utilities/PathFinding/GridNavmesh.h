@@ -62,6 +62,13 @@ public:
   /// \brief Returns the given area edge by index.
   const AreaEdge& GetAreaEdge(ezInt32 iAreaEdge) const { return m_GraphEdges[iAreaEdge]; }
 
+  /// \brief Searches a path over the convex areas only, from \a iStartArea to \a iTargetArea.
+  ///
+  /// This is the abstract level of a hierarchical search: the graph has one node per convex area instead of one per cell, so it is tiny
+  /// compared to the grid. The resulting list of areas can be used as a corridor to restrict a subsequent cell level search.
+  /// Costs are the distances between the area centers, so the result is close to, but not necessarily exactly, the shortest path.
+  ezResult FindAreaPath(ezInt32 iStartArea, ezInt32 iTargetArea, ezDynamicArray<ezInt32>& out_AreaPath) const;
+
 private:
   void UpdateRegion(ezRectU32 region, CellComparator IsSameCellType, void* pPassThrough1, CellBlocked IsCellBlocked, void* pPassThrough2);
 
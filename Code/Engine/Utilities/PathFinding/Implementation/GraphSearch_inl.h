@@ -1,39 +1,156 @@
 #pragma once
 
+template <typename PathStateType>
+void ezPathSearch<PathStateType>::SetDenseNodeCount(ezUInt32 uiNumNodes)
+{
+  m_DenseStateIndices.Clear();
+
+  // stale entries are detected in FindState, so the initial values don't matter, they only have to be initialized
+  m_DenseStateIndices.SetCount(uiNumNodes);
+}
+
 template <typename PathStateType>
 void ezPathSearch<PathStateType>::ClearPathStates()
 {
-  m_PathStates.Clear();
-  m_StateQueue.Clear();
+  // keeps the memory around for the next search
+  m_States.Clear();
+  m_StateIndices.Clear();
+  m_OpenHeap.Clear();
 }
 
 template <typename PathStateType>
-ezInt64 ezPathSearch<PathStateType>::FindBestNodeToExpand(PathStateType*& out_pPathState)
+ezUInt32 ezPathSearch<PathStateType>::FindState(ezInt64 iNodeIndex) const
 {
-  float fLowestEstimation = ezMath::Infinity<float>();
-  out_pPathState = nullptr;
-  ezUInt32 iBestInQueue = 0;
+  if (!m_DenseStateIndices.IsEmpty())
+  {
+    EZ_ASSERT_DEBUG(iNodeIndex >= 0 && iNodeIndex < static_cast<ezInt64>(m_DenseStateIndices.GetCount()), "Node index {0} is outside the dense node range", iNodeIndex);
+
+    const ezUInt32 uiStateIndex = m_DenseStateIndices[static_cast<ezUInt32>(iNodeIndex)];
+    if (uiStateIndex < m_States.GetCount() && m_States[uiStateIndex].m_iNodeIndex == iNodeIndex)
+      return uiStateIndex;
+
+    return ezInvalidIndex;
+  }
 
-  for (ezUInt32 i = 0; i < m_StateQueue.GetCount(); ++i)
+  ezUInt32 uiStateIndex = ezInvalidIndex;
+  m_StateIndices.TryGetValue(iNodeIndex, uiStateIndex);
+  return uiStateIndex;
+}
+
+template <typename PathStateType>
+ezUInt32 ezPathSearch<PathStateType>::AddState(ezInt64 iNodeIndex)
+{
+  const ezUInt32 uiStateIndex = m_States.GetCount();
+
+  NodeState& nodeState = m_States.ExpandAndGetRef();
+  nodeState.m_iNodeIndex = iNodeIndex;
+  nodeState.m_uiHeapIndex = ezInvalidIndex;
+
+  if (!m_DenseStateIndices.IsEmpty())
   {
-    const ezInt64 iNodeIndex = m_StateQueue[i];
+    EZ_ASSERT_DEBUG(iNodeIndex >= 0 && iNodeIndex < static_cast<ezInt64>(m_DenseStateIndices.GetCount()), "Node index {0} is outside the dense node range", iNodeIndex);
 
-    PathStateType* pState = &m_PathStates[iNodeIndex];
+    m_DenseStateIndices[static_cast<ezUInt32>(iNodeIndex)] = uiStateIndex;
+  }
+  else
+  {
+    m_StateIndices.Insert(iNodeIndex, uiStateIndex);
+  }
 
-    if (pState->m_fEstimatedCostToTarget < fLowestEstimation)
-    {
-      fLowestEstimation = pState->m_fEstimatedCostToTarget;
-      out_pPathState = pState;
-      iBestInQueue = i;
-    }
+  return uiStateIndex;
+}
+
+template <typename PathStateType>
+EZ_ALWAYS_INLINE bool ezPathSearch<PathStateType>::HeapLess(ezUInt32 uiHeapIndexA, ezUInt32 uiHeapIndexB) const
+{
+  return m_States[m_OpenHeap[uiHeapIndexA]].m_State.m_fEstimatedCostToTarget < m_States[m_OpenHeap[uiHeapIndexB]].m_State.m_fEstimatedCostToTarget;
+}
+
+template <typename PathStateType>
+EZ_ALWAYS_INLINE void ezPathSearch<PathStateType>::HeapSet(ezUInt32 uiHeapIndex, ezUInt32 uiStateIndex)
+{
+  m_OpenHeap[uiHeapIndex] = uiStateIndex;
+  m_States[uiStateIndex].m_uiHeapIndex = uiHeapIndex;
+}
+
+template <typename PathStateType>
+void ezPathSearch<PathStateType>::HeapSiftUp(ezUInt32 uiHeapIndex)
+{
+  const ezUInt32 uiStateIndex = m_OpenHeap[uiHeapIndex];
+  const float fCost = m_States[uiStateIndex].m_State.m_fEstimatedCostToTarget;
+
+  while (uiHeapIndex > 0)
+  {
+    const ezUInt32 uiParent = (uiHeapIndex - 1) / 2;
+    if (m_States[m_OpenHeap[uiParent]].m_State.m_fEstimatedCostToTarget <= fCost)
+      break;
+
+    HeapSet(uiHeapIndex, m_OpenHeap[uiParent]);
+    uiHeapIndex = uiParent;
+  }
+
+  HeapSet(uiHeapIndex, uiStateIndex);
+}
+
+template <typename PathStateType>
+void ezPathSearch<PathStateType>::HeapSiftDown(ezUInt32 uiHeapIndex)
+{
+  const ezUInt32 uiNumEntries = m_OpenHeap.GetCount();
+
+  while (true)
+  {
+    const ezUInt32 uiLeft = uiHeapIndex * 2 + 1;
+    if (uiLeft >= uiNumEntries)
+      break;
+
+    const ezUInt32 uiRight = uiLeft + 1;
+    const ezUInt32 uiSmaller = (uiRight < uiNumEntries && HeapLess(uiRight, uiLeft)) ? uiRight : uiLeft;
+
+    if (!HeapLess(uiSmaller, uiHeapIndex))
+      break;
+
+    const ezUInt32 uiStateIndex = m_OpenHeap[uiHeapIndex];
+    HeapSet(uiHeapIndex, m_OpenHeap[uiSmaller]);
+    HeapSet(uiSmaller, uiStateIndex);
+
+    uiHeapIndex = uiSmaller;
   }
+}
 
-  EZ_ASSERT_DEV(out_pPathState != nullptr, "Implementation Error");
+template <typename PathStateType>
+void ezPathSearch<PathStateType>::HeapPush(ezUInt32 uiStateIndex)
+{
+  m_OpenHeap.PushBack(uiStateIndex);
+  HeapSiftUp(m_OpenHeap.GetCount() - 1);
+}
+
+template <typename PathStateType>
+ezUInt32 ezPathSearch<PathStateType>::HeapPop()
+{
+  const ezUInt32 uiBestStateIndex = m_OpenHeap[0];
+  m_States[uiBestStateIndex].m_uiHeapIndex = ezInvalidIndex;
 
-  const ezInt64 iBestNodeIndex = m_StateQueue[iBestInQueue];
-  m_StateQueue.RemoveAtAndSwap(iBestInQueue);
+  const ezUInt32 uiLastStateIndex = m_OpenHeap.PeekBack();
+  m_OpenHeap.PopBack();
 
-  return iBestNodeIndex;
+  if (!m_OpenHeap.IsEmpty())
+  {
+    HeapSet(0, uiLastStateIndex);
+    HeapSiftDown(0);
+  }
+
+  return uiBestStateIndex;
+}
+
+template <typename PathStateType>
+ezInt64 ezPathSearch<PathStateType>::FindBestNodeToExpand(PathStateType*& out_pPathState)
+{
+  EZ_ASSERT_DEV(!m_OpenHeap.IsEmpty(), "Implementation Error");
+
+  NodeState& bestState = m_States[HeapPop()];
+
+  out_pPathState = &bestState.m_State;
+  return bestState.m_iNodeIndex;
 }
 
 template <typename PathStateType>
@@ -43,7 +160,7 @@ void ezPathSearch<PathStateType>::FillOutPathResult(ezInt64 iEndNodeIndex, ezDeq
 
   while (true)
   {
-    const PathStateType* pCurState = &m_PathStates[iEndNodeIndex];
+    const PathStateType* pCurState = &m_States[FindState(iEndNodeIndex)].m_State;
 
     PathResultData r;
     r.m_iNodeIndex = iEndNodeIndex;
@@ -69,28 +186,40 @@ void ezPathSearch<PathStateType>::AddPathNode(ezInt64 iNodeIndex, const PathStat
   // ezArgF(m_pCurPathState->m_fEstimatedCostToTarget, 2), ezArgF(NewState.m_fEstimatedCostToTarget, 2));
   EZ_ASSERT_DEV(NewState.m_fEstimatedCostToTarget >= NewState.m_fCostToNode, "Unrealistic expectations will get you nowhere.");
 
-  PathStateType* pExistingState;
+  ezUInt32 uiStateIndex = FindState(iNodeIndex);
 
-  if (m_PathStates.TryGetValue(iNodeIndex, pExistingState))
+  if (uiStateIndex != ezInvalidIndex)
   {
-    // state already exists in the hash table, and has a lower cost -> ignore the new state
-    if (pExistingState->m_fCostToNode <= NewState.m_fCostToNode)
+    NodeState& existingState = m_States[uiStateIndex];
+
+    // state already exists, and has a lower cost -> ignore the new state
+    if (existingState.m_State.m_fCostToNode <= NewState.m_fCostToNode)
       return;
 
     // incoming state is better than the existing state -> update existing state
-    *pExistingState = NewState;
-    pExistingState->m_iReachedThroughNode = m_iCurNodeIndex;
+    existingState.m_State = NewState;
+    existingState.m_State.m_iReachedThroughNode = m_iCurNodeIndex;
+
+    // if it still waits for expansion, move it to its new place in the queue
+    // the estimation usually goes down, but a generator with direction dependent costs may also raise it
+    if (existingState.m_uiHeapIndex != ezInvalidIndex)
+    {
+      HeapSiftUp(existingState.m_uiHeapIndex);
+      HeapSiftDown(existingState.m_uiHeapIndex);
+    }
+
     return;
   }
 
   // the state has not been reached before -> insert it
-  pExistingState = &m_PathStates[iNodeIndex];
+  uiStateIndex = AddState(iNodeIndex);
 
-  *pExistingState = NewState;
-  pExistingState->m_iReachedThroughNode = m_iCurNodeIndex;
+  NodeState& newState = m_States[uiStateIndex];
+  newState.m_State = NewState;
+  newState.m_State.m_iReachedThroughNode = m_iCurNodeIndex;
 
   // put it into the queue of states that still need to be expanded
-  m_StateQueue.PushBack(iNodeIndex);
+  HeapPush(uiStateIndex);
 }
 
 template <typename PathStateType>
@@ -103,13 +232,12 @@ ezResult ezPathSearch<PathStateType>::FindPath(ezInt64 iStartNodeIndex, const Pa
 
   if (iStartNodeIndex == iTargetNodeIndex)
   {
-    m_PathStates.Reserve(1);
-
-    m_PathStates[iTargetNodeIndex] = StartState;
+    NodeState& targetState = m_States[AddState(iTargetNodeIndex)];
+    targetState.m_State = StartState;
 
     PathResultData r;
     r.m_iNodeIndex = iTargetNodeIndex;
-    r.m_pPathState = &m_PathStates[iTargetNodeIndex];
+    r.m_pPathState = &targetState.m_State;
 
     out_Path.Clear();
     out_Path.PushBack(r);
@@ -117,9 +245,8 @@ ezResult ezPathSearch<PathStateType>::FindPath(ezInt64 iStartNodeIndex, const Pa
     return EZ_SUCCESS;
   }
 
-  m_PathStates.Reserve(10000);
-
-  PathStateType& FirstState = m_PathStates[iStartNodeIndex];
+  const ezUInt32 uiFirstStateIndex = AddState(iStartNodeIndex);
+  PathStateType& FirstState = m_States[uiFirstStateIndex].m_State;
 
   m_pStateGenerator->StartSearch(iStartNodeIndex, &FirstState, iTargetNodeIndex);
 
@@ -128,10 +255,10 @@ ezResult ezPathSearch<PathStateType>::FindPath(ezInt64 iStartNodeIndex, const Pa
   FirstState.m_iReachedThroughNode = iStartNodeIndex;
 
   // put the start state into the to-be-expanded queue
-  m_StateQueue.PushBack(iStartNodeIndex);
+  HeapPush(uiFirstStateIndex);
 
   // while the queue is not empty, expand the next node and see where that gets us
-  while (!m_StateQueue.IsEmpty())
+  while (!m_OpenHeap.IsEmpty())
   {
     PathStateType* pCurState;
     m_iCurNodeIndex = FindBestNodeToExpand(pCurState);
@@ -172,9 +299,8 @@ ezResult ezPathSearch<PathStateType>::FindClosest(
 
   ClearPathStates();
 
-  m_PathStates.Reserve(10000);
-
-  PathStateType& FirstState = m_PathStates[iStartNodeIndex];
+  const ezUInt32 uiFirstStateIndex = AddState(iStartNodeIndex);
+  PathStateType& FirstState = m_States[uiFirstStateIndex].m_State;
 
   m_pStateGenerator->StartSearchForClosest(iStartNodeIndex, &FirstState);
 
@@ -183,10 +309,10 @@ ezResult ezPathSearch<PathStateType>::FindClosest(
   FirstState.m_iReachedThroughNode = iStartNodeIndex;
 
   // put the start state into the to-be-expanded queue
-  m_StateQueue.PushBack(iStartNodeIndex);
+  HeapPush(uiFirstStateIndex);
 
   // while the queue is not empty, expand the next node and see where that gets us
-  while (!m_StateQueue.IsEmpty())
+  while (!m_OpenHeap.IsEmpty())
   {
     PathStateType* pCurState;
     m_iCurNodeIndex = FindBestNodeToExpand(pCurState);
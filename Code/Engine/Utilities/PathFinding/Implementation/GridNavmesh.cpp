@@ -1,7 +1,80 @@
 #include <Utilities/UtilitiesPCH.h>
 
+#include <Utilities/PathFinding/GraphSearch.h>
 #include <Utilities/PathFinding/GridNavmesh.h>
 
+namespace
+{
+  class AreaStateGenerator : public ezPathStateGenerator<ezPathState>
+  {
+  public:
+    AreaStateGenerator(const ezGridNavmesh& navmesh)
+      : m_Navmesh(navmesh)
+    {
+    }
+
+    virtual void StartSearch(ezInt64 iStartNodeIndex, const ezPathState* pStartState, ezInt64 iTargetNodeIndex) override
+    {
+      m_vTargetCenter = GetAreaCenter(static_cast<ezInt32>(iTargetNodeIndex));
+    }
+
+    virtual void GenerateAdjacentStates(ezInt64 iNodeIndex, const ezPathState& StartState, ezPathSearch<ezPathState>* pPathSearch) override
+    {
+      const ezGridNavmesh::ConvexArea& area = m_Navmesh.GetConvexArea(static_cast<ezInt32>(iNodeIndex));
+      const ezVec2 vCenter = GetAreaCenter(static_cast<ezInt32>(iNodeIndex));
+
+      for (ezUInt32 e = 0; e < area.m_uiNumEdges; ++e)
+      {
+        const ezInt32 iNeighbor = m_Navmesh.GetAreaEdge(area.m_uiFirstEdge + e).m_iNeighborArea;
+        const ezVec2 vNeighborCenter = GetAreaCenter(iNeighbor);
+
+        ezPathState state;
+        // large areas can have almost coinciding centers, but every step has to cost something
+        state.m_fCostToNode = StartState.m_fCostToNode + ezMath::Max((vNeighborCenter - vCenter).GetLength(), 0.5f);
+        state.m_fEstimatedCostToTarget = state.m_fCostToNode + (m_vTargetCenter - vNeighborCenter).GetLength();
+
+        pPathSearch->AddPathNode(iNeighbor, state);
+      }
+    }
+
+  private:
+    ezVec2 GetAreaCenter(ezInt32 iArea) const
+    {
+      const ezRectU32& r = m_Navmesh.GetConvexArea(iArea).m_Rect;
+      return ezVec2(r.x + r.width * 0.5f, r.y + r.height * 0.5f);
+    }
+
+    const ezGridNavmesh& m_Navmesh;
+    ezVec2 m_vTargetCenter = ezVec2::ZeroVector();
+  };
+} // namespace
+
+ezResult ezGridNavmesh::FindAreaPath(ezInt32 iStartArea, ezInt32 iTargetArea, ezDynamicArray<ezInt32>& out_AreaPath) const
+{
+  out_AreaPath.Clear();
+
+  if (iStartArea < 0 || iTargetArea < 0)
+    return EZ_FAILURE;
+
+  AreaStateGenerator generator(*this);
+
+  ezPathSearch<ezPathState> search;
+  search.SetPathStateGenerator(&generator);
+  search.SetDenseNodeCount(GetNumConvexAreas());
+
+  ezDeque<ezPathSearch<ezPathState>::PathResultData> path;
+  if (search.FindPath(iStartArea, ezPathState(), iTargetArea, path).Failed())
+    return EZ_FAILURE;
+
+  out_AreaPath.Reserve(path.GetCount());
+  for (const auto& node : path)
+  {
+    out_AreaPath.PushBack(static_cast<ezInt32>(node.m_iNodeIndex));
+  }
+
+  return EZ_SUCCESS;
+}
+
 void ezGridNavmesh::UpdateRegion(ezRectU32 region, CellComparator IsSameCellType, void* pPassThrough1, CellBlocked IsCellBlocked, void* pPassThrough2)
 {
   ezInt32 iInvalidNode = -(ezInt32)m_ConvexAreas.GetCount();
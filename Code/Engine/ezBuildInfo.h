@@ -0,0 +1,10 @@
+//
+// This file is auto-generated by CMake.
+//
+
+#pragma once
+
+#define EZ_GIT_COMMIT_HASH_SHORT 96bf26f781d3
+#define EZ_GIT_COMMIT_HASH_LONG 96bf26f781d345f90e5b8d914a30d65dcc0bf126
+#define EZ_GIT_BRANCH_NAME "master"
+
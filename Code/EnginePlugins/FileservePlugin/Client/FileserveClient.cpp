@@ -2,6 +2,7 @@
 
 #include <FileservePlugin/Client/FileserveClient.h>
 #include <FileservePlugin/Fileserver/ClientContext.h>
+#include <Foundation/Algorithm/BinaryDelta.h>
 #include <Foundation/Communication/GlobalEvent.h>
 #include <Foundation/Communication/RemoteInterfaceEnet.h>
 #include <Foundation/IO/FileSystem/FileWriter.h>
@@ -9,9 +10,19 @@
 #include <Foundation/Logging/Log.h>
 #include <Foundation/Types/ScopeExit.h>
 #include <Foundation/Utilities/CommandLineUtils.h>
+#include <Foundation/Utilities/Compression.h>
 
 EZ_IMPLEMENT_SINGLETON(ezFileserveClient);
 
+namespace
+{
+  /// Prefetches are only sent while fewer requests than this are waiting for an answer.
+  constexpr ezUInt32 s_uiMaxPendingRequests = 32;
+
+  /// Cached files smaller than this are always transferred completely, the signature would not save much.
+  constexpr ezUInt64 s_uiMinDeltaFileSize = 64 * 1024;
+} // namespace
+
 bool ezFileserveClient::s_bEnableFileserve = true;
 
 ezFileserveClient::ezFileserveClient()
@@ -69,11 +80,10 @@ void ezFileserveClient::ShutdownConnection()
 
 void ezFileserveClient::ClearState()
 {
-  m_bDownloading = false;
+  m_bWaitingForDownload = false;
   m_bWaitingForUploadFinished = false;
-  m_CurFileRequestGuid = ezUuid();
-  m_sCurFileRequest.Clear();
-  m_Download.Clear();
+  m_PendingRequests.Clear();
+  m_PrefetchQueue.Clear();
 }
 
 ezResult ezFileserveClient::EnsureConnected(ezTime timeout)
@@ -154,6 +164,8 @@ void ezFileserveClient::UpdateClient()
   m_CurrentTime = ezTime::Now();
 
   m_Network->ExecuteAllMessageHandlers();
+
+  SendQueuedPrefetches();
 }
 
 void ezFileserveClient::AddServerAddressToTry(const char* szAddress)
@@ -355,7 +367,7 @@ void ezFileserveClient::NetworkMsgHandler(ezRemoteMessage& msg)
     s_bReloadResources = true;
   }
 
-  if (!m_bDownloading && s_bReloadResources)
+  if (!m_bWaitingForDownload && s_bReloadResources)
   {
     EZ_BROADCAST_EVENT(ezResourceManager_ReloadAllResources);
     s_bReloadResources = false;
@@ -439,11 +451,13 @@ void ezFileserveClient::DeleteFile(ezUInt16 uiDataDir, const char* szFile)
 void ezFileserveClient::HandleFileTransferMsg(ezRemoteMessage& msg)
 {
   EZ_LOCK(m_Mutex);
+
+  FileRequest* pRequest = nullptr;
   {
     ezUuid fileRequestGuid;
     msg.GetReader() >> fileRequestGuid;
 
-    if (fileRequestGuid != m_CurFileRequestGuid)
+    if (!m_PendingRequests.TryGetValue(fileRequestGuid, pRequest))
     {
       // ezLog::Debug("Fileserver is answering someone else");
       return;
@@ -453,17 +467,17 @@ void ezFileserveClient::HandleFileTransferMsg(ezRemoteMessage& msg)
   ezUInt16 uiChunkSize = 0;
   msg.GetReader() >> uiChunkSize;
 
-  ezUInt32 uiFileSize = 0;
-  msg.GetReader() >> uiFileSize;
+  ezUInt32 uiPayloadSize = 0;
+  msg.GetReader() >> uiPayloadSize;
 
   // make sure we don't need to reallocate
-  m_Download.Reserve(uiFileSize);
+  pRequest->m_Download.Reserve(uiPayloadSize);
 
   if (uiChunkSize > 0)
   {
-    const ezUInt32 uiStartPos = m_Download.GetCount();
-    m_Download.SetCountUninitialized(uiStartPos + uiChunkSize);
-    msg.GetReader().ReadBytes(&m_Download[uiStartPos], uiChunkSize);
+    const ezUInt32 uiStartPos = pRequest->m_Download.GetCount();
+    pRequest->m_Download.SetCountUninitialized(uiStartPos + uiChunkSize);
+    msg.GetReader().ReadBytes(&pRequest->m_Download[uiStartPos], uiChunkSize);
   }
 }
 
@@ -471,17 +485,15 @@ void ezFileserveClient::HandleFileTransferMsg(ezRemoteMessage& msg)
 void ezFileserveClient::HandleFileTransferFinishedMsg(ezRemoteMessage& msg)
 {
   EZ_LOCK(m_Mutex);
-  EZ_SCOPE_EXIT(m_bDownloading = false);
 
-  {
-    ezUuid fileRequestGuid;
-    msg.GetReader() >> fileRequestGuid;
+  ezUuid fileRequestGuid;
+  msg.GetReader() >> fileRequestGuid;
 
-    if (fileRequestGuid != m_CurFileRequestGuid)
-    {
-      // ezLog::Debug("Fileserver is answering someone else");
-      return;
-    }
+  FileRequest* pRequest = nullptr;
+  if (!m_PendingRequests.TryGetValue(fileRequestGuid, pRequest))
+  {
+    // ezLog::Debug("Fileserver is answering someone else");
+    return;
   }
 
   ezFileserveFileState fileState;
@@ -500,13 +512,58 @@ void ezFileserveClient::HandleFileTransferFinishedMsg(ezRemoteMessage& msg)
   ezUInt16 uiFoundInDataDir = 0;
   msg.GetReader() >> uiFoundInDataDir;
 
+  ezUInt8 uiEncoding = ezFileserveTransferEncoding::Raw;
+  msg.GetReader() >> uiEncoding;
+
+  FileRequest& request = *pRequest;
+
+  // decode and verify the content first, a broken delta is retried before any cache state is touched
+  ezDynamicArray<ezUInt8> decoded;
+  ezArrayPtr<const ezUInt8> content = request.m_Download;
+  bool bContentValid = true;
+
+  if (fileState == ezFileserveFileState::Different)
+  {
+    if (uiEncoding != ezFileserveTransferEncoding::Raw)
+    {
+      bContentValid = DecodeDownload(request, uiEncoding, decoded).Succeeded();
+      content = decoded;
+    }
+
+    if (bContentValid)
+    {
+      const ezUInt64 uiContentHash = content.IsEmpty() ? 1 : ezHashingUtils::xxHash64(content.GetPtr(), content.GetCount(), 1);
+      bContentValid = (uiContentHash == uiFileHash);
+    }
+
+    if (!bContentValid && request.m_bAllowDelta && (uiEncoding & ezFileserveTransferEncoding::Delta) != 0)
+    {
+      ezLog::Warning("Fileserve delta for '{0}' could not be applied, requesting the full file", request.m_sFile);
+
+      request.m_bAllowDelta = false;
+      request.m_Download.Clear();
+      SendFileRequest(fileRequestGuid, request);
+      return;
+    }
+  }
+
+  EZ_SCOPE_EXIT(if (request.m_bWaitedOn) request.m_bFinished = true; else m_PendingRequests.Remove(fileRequestGuid););
+
+  const ezString& sFile = request.m_sFile;
+
+  if (!bContentValid)
+  {
+    ezLog::Error("Fileserve download of '{0}' is corrupted", sFile);
+    uiFoundInDataDir = 0xffff;
+  }
+
   if (uiFoundInDataDir == 0xffff) // file does not exist on server in any data dir
   {
-    m_FileDataDir[m_sCurFileRequest] = 0; // placeholder
+    m_FileDataDir[sFile] = 0; // placeholder
 
     for (ezUInt32 i = 0; i < m_MountedDataDirs.GetCount(); ++i)
     {
-      auto& ref = m_MountedDataDirs[i].m_CacheStatus[m_sCurFileRequest];
+      auto& ref = m_MountedDataDirs[i].m_CacheStatus[sFile];
       ref.m_FileHash = 0;
       ref.m_TimeStamp = 0;
       ref.m_LastCheck = m_CurrentTime;
@@ -516,9 +573,9 @@ void ezFileserveClient::HandleFileTransferFinishedMsg(ezRemoteMessage& msg)
   }
   else
   {
-    m_FileDataDir[m_sCurFileRequest] = uiFoundInDataDir;
+    m_FileDataDir[sFile] = uiFoundInDataDir;
 
-    auto& ref = m_MountedDataDirs[uiFoundInDataDir].m_CacheStatus[m_sCurFileRequest];
+    auto& ref = m_MountedDataDirs[uiFoundInDataDir].m_CacheStatus[sFile];
     ref.m_FileHash = uiFileHash;
     ref.m_TimeStamp = iFileTimeStamp;
     ref.m_LastCheck = m_CurrentTime;
@@ -530,7 +587,7 @@ void ezFileserveClient::HandleFileTransferFinishedMsg(ezRemoteMessage& msg)
 
   const ezString& sMountPoint = m_MountedDataDirs[uiFoundInDataDir].m_sMountPoint;
   ezStringBuilder sCachedFile, sCachedMetaFile;
-  BuildPathInCache(m_sCurFileRequest, sMountPoint, &sCachedFile, &sCachedMetaFile);
+  BuildPathInCache(sFile, sMountPoint, &sCachedFile, &sCachedMetaFile);
 
   if (fileState == ezFileserveFileState::NonExistant)
   {
@@ -548,11 +605,41 @@ void ezFileserveClient::HandleFileTransferFinishedMsg(ezRemoteMessage& msg)
 
   if (fileState == ezFileserveFileState::Different)
   {
-    WriteDownloadToDisk(sCachedFile);
+    WriteDownloadToDisk(sCachedFile, content);
     WriteMetaFile(sCachedMetaFile, iFileTimeStamp, uiFileHash);
   }
 }
 
+ezResult ezFileserveClient::DecodeDownload(const FileRequest& request, ezUInt8 uiEncoding, ezDynamicArray<ezUInt8>& out_Content) const
+{
+  ezArrayPtr<const ezUInt8> payload = request.m_Download;
+
+  ezDynamicArray<ezUInt8> decompressed;
+  if ((uiEncoding & ezFileserveTransferEncoding::Compressed) != 0)
+  {
+    EZ_SUCCEED_OR_RETURN(ezCompressionUtils::Decompress(payload, ezCompressionMethod::ZStd, decompressed));
+    payload = decompressed;
+  }
+
+  if ((uiEncoding & ezFileserveTransferEncoding::Delta) != 0)
+  {
+    // the delta was computed against the signature of the cached file that was sent along with the request
+    ezStringBuilder sCachedFile;
+    BuildPathInCache(request.m_sFile, m_MountedDataDirs[request.m_uiDataDirID].m_sMountPoint, &sCachedFile, nullptr);
+
+    ezOSFile file;
+    EZ_SUCCEED_OR_RETURN(file.Open(sCachedFile, ezFileOpenMode::Read));
+
+    ezDynamicArray<ezUInt8> baseContent;
+    file.ReadAll(baseContent);
+    file.Close();
+
+    return ezBinaryDelta::ApplyDelta(baseContent, payload, out_Content);
+  }
+
+  out_Content = payload;
+  return EZ_SUCCESS;
+}
 
 void ezFileserveClient::WriteMetaFile(ezStringBuilder sCachedMetaFile, ezInt64 iFileTimeStamp, ezUInt64 uiFileHash)
 {
@@ -570,14 +657,13 @@ void ezFileserveClient::WriteMetaFile(ezStringBuilder sCachedMetaFile, ezInt64 i
   }
 }
 
-void ezFileserveClient::WriteDownloadToDisk(ezStringBuilder sCachedFile)
+void ezFileserveClient::WriteDownloadToDisk(ezStringBuilder sCachedFile, ezArrayPtr<const ezUInt8> content)
 {
-  EZ_LOCK(m_Mutex);
   ezOSFile file;
   if (file.Open(sCachedFile, ezFileOpenMode::Write).Succeeded())
   {
-    if (!m_Download.IsEmpty())
-      file.Write(m_Download.GetData(), m_Download.GetCount()).IgnoreResult();
+    if (!content.IsEmpty())
+      file.Write(content.GetPtr(), content.GetCount()).IgnoreResult();
 
     file.Close();
   }
@@ -591,7 +677,7 @@ ezResult ezFileserveClient::DownloadFile(ezUInt16 uiDataDirID, const char* szFil
 {
   // bForceThisDataDir = true;
   EZ_LOCK(m_Mutex);
-  if (m_bDownloading)
+  if (m_bWaitingForDownload)
   {
     ezLog::Warning("Trying to download a file over fileserve while another file is already downloading. Recursive download is ignored.");
     return EZ_FAILURE;
@@ -599,7 +685,6 @@ ezResult ezFileserveClient::DownloadFile(ezUInt16 uiDataDirID, const char* szFil
 
   EZ_ASSERT_DEV(uiDataDirID < m_MountedDataDirs.GetCount(), "Invalid data dir index {0}", uiDataDirID);
   EZ_ASSERT_DEV(m_MountedDataDirs[uiDataDirID].m_bMounted, "Data directory {0} is not mounted", uiDataDirID);
-  EZ_ASSERT_DEV(!m_bDownloading, "Cannot start a download, while one is still running");
 
   if (!m_Network->IsConnectedToServer())
     return EZ_FAILURE;
@@ -614,7 +699,7 @@ ezResult ezFileserveClient::DownloadFile(ezUInt16 uiDataDirID, const char* szFil
   const ezUInt16 uiUseDataDirCache = bForceThisDataDir ? uiDataDirID : itFileDataDir.Value();
   const FileCacheStatus& CacheStatus = m_MountedDataDirs[uiUseDataDirCache].m_CacheStatus[szFile];
 
-  if (m_CurrentTime - CacheStatus.m_LastCheck < ezTime::Seconds(5.0f))
+  if (IsCacheStatusUpToDate(CacheStatus))
   {
     if (CacheStatus.m_FileHash == 0) // file does not exist
       return EZ_FAILURE;
@@ -625,30 +710,20 @@ ezResult ezFileserveClient::DownloadFile(ezUInt16 uiDataDirID, const char* szFil
     return EZ_SUCCESS;
   }
 
-  m_Download.Clear();
-  m_sCurFileRequest = szFile;
-  m_CurFileRequestGuid.CreateNewUuid();
-  m_bDownloading = true;
-
-  ezRemoteMessage msg('FSRV', 'READ');
-  msg.GetWriter() << uiUseDataDirCache;
-  msg.GetWriter() << bForceThisDataDir;
-  msg.GetWriter() << szFile;
-  msg.GetWriter() << m_CurFileRequestGuid;
-  msg.GetWriter() << CacheStatus.m_TimeStamp;
-  msg.GetWriter() << CacheStatus.m_FileHash;
-
-  m_Network->Send(ezRemoteTransmitMode::Reliable, msg);
-
-  while (m_bDownloading)
+  // a prefetch may already be on its way, wait for that one instead of asking again
+  ezUuid requestGuid;
+  if (!FindPendingRequest(szFile, uiUseDataDirCache, bForceThisDataDir, requestGuid))
   {
-    m_Network->UpdateRemoteInterface();
-    m_Network->ExecuteAllMessageHandlers();
+    requestGuid = StartFileRequest(uiUseDataDirCache, szFile, bForceThisDataDir);
   }
 
+  m_PendingRequests[requestGuid].m_bWaitedOn = true;
+
+  EZ_SUCCEED_OR_RETURN(WaitForFileRequest(requestGuid));
+
   if (bForceThisDataDir)
   {
-    if (m_MountedDataDirs[uiDataDirID].m_CacheStatus[m_sCurFileRequest].m_FileHash == 0)
+    if (m_MountedDataDirs[uiDataDirID].m_CacheStatus[szFile].m_FileHash == 0)
       return EZ_FAILURE;
 
     if (out_pFullPath)
@@ -662,7 +737,7 @@ ezResult ezFileserveClient::DownloadFile(ezUInt16 uiDataDirID, const char* szFil
     if (uiBestDir == uiDataDirID) // best match is still this? -> success
     {
       // file does not exist
-      if (m_MountedDataDirs[uiBestDir].m_CacheStatus[m_sCurFileRequest].m_FileHash == 0)
+      if (m_MountedDataDirs[uiBestDir].m_CacheStatus[szFile].m_FileHash == 0)
         return EZ_FAILURE;
 
       if (out_pFullPath)
@@ -675,6 +750,219 @@ ezResult ezFileserveClient::DownloadFile(ezUInt16 uiDataDirID, const char* szFil
   }
 }
 
+ezUuid ezFileserveClient::StartFileRequest(ezUInt16 uiDataDirID, const char* szFile, bool bForceThisDataDir)
+{
+  EZ_LOCK(m_Mutex);
+
+  ezUuid requestGuid;
+  requestGuid.CreateNewUuid();
+
+  FileRequest& request = m_PendingRequests[requestGuid];
+  request.m_sFile = szFile;
+  request.m_uiDataDirID = uiDataDirID;
+  request.m_bForceThisDataDir = bForceThisDataDir;
+
+  SendFileRequest(requestGuid, request);
+  return requestGuid;
+}
+
+void ezFileserveClient::SendFileRequest(const ezUuid& requestGuid, const FileRequest& request)
+{
+  EZ_LOCK(m_Mutex);
+
+  const DataDir& dd = m_MountedDataDirs[request.m_uiDataDirID];
+
+  ezInt64 iTimeStamp = 0;
+  ezUInt64 uiFileHash = 0;
+
+  // without delta, send an empty status, so that the server transfers the file in any case
+  if (request.m_bAllowDelta)
+  {
+    const FileCacheStatus& CacheStatus = dd.m_CacheStatus[request.m_sFile];
+    iTimeStamp = CacheStatus.m_TimeStamp;
+    uiFileHash = CacheStatus.m_FileHash;
+  }
+
+  ezUInt8 uiRequestFlags = ezFileserveRequestFlags::None;
+
+#ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+  uiRequestFlags |= ezFileserveRequestFlags::SupportsCompression;
+#endif
+
+  // for larger files that are already in the cache, let the server only send the blocks that changed
+  ezBinaryDelta::Signature signature;
+  if (uiFileHash != 0)
+  {
+    ezStringBuilder sCachedFile;
+    BuildPathInCache(request.m_sFile, dd.m_sMountPoint, &sCachedFile, nullptr);
+
+    ezFileStats stats;
+    if (ezOSFile::GetFileStats(sCachedFile, stats).Succeeded() && stats.m_uiFileSize >= s_uiMinDeltaFileSize)
+    {
+      ezOSFile file;
+      if (file.Open(sCachedFile, ezFileOpenMode::Read).Succeeded())
+      {
+        ezDynamicArray<ezUInt8> content;
+        file.ReadAll(content);
+        file.Close();
+
+        ezBinaryDelta::ComputeSignature(content, signature);
+        uiRequestFlags |= ezFileserveRequestFlags::HasSignature;
+      }
+    }
+  }
+
+  ezRemoteMessage msg('FSRV', 'READ');
+  msg.GetWriter() << request.m_uiDataDirID;
+  msg.GetWriter() << request.m_bForceThisDataDir;
+  msg.GetWriter() << request.m_sFile;
+  msg.GetWriter() << requestGuid;
+  msg.GetWriter() << iTimeStamp;
+  msg.GetWriter() << uiFileHash;
+  msg.GetWriter() << uiRequestFlags;
+
+  if ((uiRequestFlags & ezFileserveRequestFlags::HasSignature) != 0)
+  {
+    ezBinaryDelta::WriteSignature(msg.GetWriter(), signature);
+  }
+
+  m_Network->Send(ezRemoteTransmitMode::Reliable, msg);
+}
+
+bool ezFileserveClient::FindPendingRequest(const char* szFile, ezUInt16 uiDataDirID, bool bForceThisDataDir, ezUuid& out_RequestGuid) const
+{
+  EZ_LOCK(m_Mutex);
+
+  for (auto it = m_PendingRequests.GetIterator(); it.IsValid(); ++it)
+  {
+    const FileRequest& request = it.Value();
+
+    if (request.m_bFinished || request.m_bForceThisDataDir != bForceThisDataDir || request.m_sFile != szFile)
+      continue;
+
+    // without bForceThisDataDir the server searches all data dirs anyway
+    if (bForceThisDataDir && request.m_uiDataDirID != uiDataDirID)
+      continue;
+
+    out_RequestGuid = it.Key();
+    return true;
+  }
+
+  return false;
+}
+
+ezResult ezFileserveClient::WaitForFileRequest(const ezUuid& requestGuid)
+{
+  EZ_LOCK(m_Mutex);
+
+  m_bWaitingForDownload = true;
+  EZ_SCOPE_EXIT(m_bWaitingForDownload = false);
+
+  while (true)
+  {
+    FileRequest* pRequest = nullptr;
+    if (!m_PendingRequests.TryGetValue(requestGuid, pRequest))
+      return EZ_FAILURE;
+
+    if (pRequest->m_bFinished)
+    {
+      m_PendingRequests.Remove(requestGuid);
+      return EZ_SUCCESS;
+    }
+
+    if (!m_Network->IsConnectedToServer())
+    {
+      m_PendingRequests.Remove(requestGuid);
+      return EZ_FAILURE;
+    }
+
+    m_Network->UpdateRemoteInterface();
+    m_Network->ExecuteAllMessageHandlers();
+
+    SendQueuedPrefetches();
+  }
+}
+
+void ezFileserveClient::PrefetchFiles(ezArrayPtr<const ezString> files)
+{
+  EZ_LOCK(m_Mutex);
+
+  if (m_Network == nullptr || !m_Network->IsConnectedToServer() || m_MountedDataDirs.IsEmpty())
+    return;
+
+  for (const ezString& sFile : files)
+  {
+    m_PrefetchQueue.PushBack(sFile);
+  }
+
+  SendQueuedPrefetches();
+}
+
+ezUInt32 ezFileserveClient::GetNumPendingFileRequests() const
+{
+  EZ_LOCK(m_Mutex);
+  return m_PendingRequests.GetCount() + m_PrefetchQueue.GetCount();
+}
+
+ezResult ezFileserveClient::WaitForPendingFileRequests(ezTime timeout /*= ezTime::Seconds(60)*/)
+{
+  EZ_LOCK(m_Mutex);
+
+  if (m_Network == nullptr)
+    return EZ_FAILURE;
+
+  const ezTime tStart = ezTime::Now();
+
+  while (GetNumPendingFileRequests() > 0)
+  {
+    if (!m_Network->IsConnectedToServer() || ezTime::Now() - tStart > timeout)
+      return EZ_FAILURE;
+
+    m_Network->UpdateRemoteInterface();
+    m_Network->ExecuteAllMessageHandlers();
+
+    SendQueuedPrefetches();
+  }
+
+  return EZ_SUCCESS;
+}
+
+void ezFileserveClient::SendQueuedPrefetches()
+{
+  EZ_LOCK(m_Mutex);
+
+  while (!m_PrefetchQueue.IsEmpty() && m_PendingRequests.GetCount() < s_uiMaxPendingRequests)
+  {
+    const ezString sFile = m_PrefetchQueue.PeekFront();
+    m_PrefetchQueue.PopFront();
+
+    ezUuid pendingGuid;
+    if (FindPendingRequest(sFile, 0, false, pendingGuid))
+      continue;
+
+    bool bCachedYet = false;
+    auto itFileDataDir = m_FileDataDir.FindOrAdd(sFile, &bCachedYet);
+    if (!bCachedYet)
+    {
+      FillFileStatusCache(sFile);
+    }
+
+    const ezUInt16 uiDataDirID = itFileDataDir.Value();
+    if (uiDataDirID >= m_MountedDataDirs.GetCount() || !m_MountedDataDirs[uiDataDirID].m_bMounted)
+      continue;
+
+    if (IsCacheStatusUpToDate(m_MountedDataDirs[uiDataDirID].m_CacheStatus[sFile]))
+      continue;
+
+    StartFileRequest(uiDataDirID, sFile, false);
+  }
+}
+
+bool ezFileserveClient::IsCacheStatusUpToDate(const FileCacheStatus& status) const
+{
+  return m_CurrentTime - status.m_LastCheck < ezTime::Seconds(5.0f);
+}
+
 void ezFileserveClient::DetermineCacheStatus(ezUInt16 uiDataDirID, const char* szFile, FileCacheStatus& out_Status) const
 {
   EZ_LOCK(m_Mutex);
@@ -4,6 +4,8 @@
 
 #include <Foundation/Communication/RemoteInterface.h>
 #include <Foundation/Configuration/Singleton.h>
+#include <Foundation/Containers/Deque.h>
+#include <Foundation/Containers/HashTable.h>
 #include <Foundation/Types/UniquePtr.h>
 #include <Foundation/Types/Uuid.h>
 
@@ -24,6 +26,10 @@ namespace ezDataDirectory
 /// The timeout for connecting to the server can be configured through the command line option "-fs_timeout seconds"
 /// The server to connect to can be configured through command line option "-fs_server address".
 /// The default address is "localhost:1042".
+///
+/// File requests are pipelined: PrefetchFiles() sends many requests at once, without waiting for each answer.
+/// Files that already exist in the local cache are updated with a block delta, if they are large enough, and all transfers are compressed,
+/// if zstd support is available.
 class EZ_FILESERVEPLUGIN_DLL ezFileserveClient
 {
   EZ_DECLARE_SINGLETON(ezFileserveClient);
@@ -60,6 +66,9 @@ public:
   /// Also achieved through the command line argument "-fs_off"
   static void DisabledFileserveClient() { s_bEnableFileserve = false; }
 
+  /// \brief Enables the file serving functionality again, e.g. after an ezFileserver was created in the same process, which disables it.
+  static void EnableFileserveClient() { s_bEnableFileserve = true; }
+
   /// \brief Returns the address through which the Fileserve client tried to connect with the server last.
   const char* GetServerConnectionAddress() { return m_sServerConnectionAddress; }
 
@@ -79,6 +88,20 @@ public:
   /// \brief Adds an address that should be tried for connecting with the server.
   void AddServerAddressToTry(const char* szAddress);
 
+  /// \brief Requests the given files from the server in the background, so that later accesses don't pay for a round trip each.
+  ///
+  /// The paths have to be relative to the mounted data directories, asset GUIDs have to be resolved already.
+  /// The best matching data directory is used, just like for regular file accesses.
+  /// Only a limited number of requests is in flight at a time, the rest is queued and sent during UpdateClient().
+  /// When a file is accessed while its request is still pending, the access waits for that request instead of sending another one.
+  void PrefetchFiles(ezArrayPtr<const ezString> files);
+
+  /// \brief Returns how many file requests are queued or waiting for an answer from the server.
+  ezUInt32 GetNumPendingFileRequests() const;
+
+  /// \brief Updates the network until all pending file requests are answered or the timeout is reached.
+  ezResult WaitForPendingFileRequests(ezTime timeout = ezTime::Seconds(60));
+
 private:
   friend class ezDataDirectory::FileserveType;
 
@@ -92,6 +115,17 @@ private:
     ezTime m_LastCheck;
   };
 
+  struct FileRequest
+  {
+    ezString m_sFile;
+    ezUInt16 m_uiDataDirID = 0;
+    bool m_bForceThisDataDir = false;
+    bool m_bAllowDelta = true;  ///< Cleared when a delta could not be applied, the file is then requested again in full.
+    bool m_bWaitedOn = false;   ///< DownloadFile() waits for this request and removes it once it is finished.
+    bool m_bFinished = false;
+    ezDynamicArray<ezUInt8> m_Download;
+  };
+
   struct DataDir
   {
     // ezString m_sRootName;
@@ -112,8 +146,15 @@ private:
   void HandleFileTransferMsg(ezRemoteMessage& msg);
   void HandleFileTransferFinishedMsg(ezRemoteMessage& msg);
   static void WriteMetaFile(ezStringBuilder sCachedMetaFile, ezInt64 iFileTimeStamp, ezUInt64 uiFileHash);
-  void WriteDownloadToDisk(ezStringBuilder sCachedFile);
+  static void WriteDownloadToDisk(ezStringBuilder sCachedFile, ezArrayPtr<const ezUInt8> content);
+  ezResult DecodeDownload(const FileRequest& request, ezUInt8 uiEncoding, ezDynamicArray<ezUInt8>& out_Content) const;
   ezResult DownloadFile(ezUInt16 uiDataDirID, const char* szFile, bool bForceThisDataDir, ezStringBuilder* out_pFullPath);
+  ezUuid StartFileRequest(ezUInt16 uiDataDirID, const char* szFile, bool bForceThisDataDir);
+  void SendFileRequest(const ezUuid& requestGuid, const FileRequest& request);
+  bool FindPendingRequest(const char* szFile, ezUInt16 uiDataDirID, bool bForceThisDataDir, ezUuid& out_RequestGuid) const;
+  ezResult WaitForFileRequest(const ezUuid& requestGuid);
+  void SendQueuedPrefetches();
+  bool IsCacheStatusUpToDate(const FileCacheStatus& status) const;
   void DetermineCacheStatus(ezUInt16 uiDataDirID, const char* szFile, FileCacheStatus& out_Status) const;
   void UploadFile(ezUInt16 uiDataDirID, const char* szFile, const ezDynamicArray<ezUInt8>& fileContent);
   void InvalidateFileCache(ezUInt16 uiDataDirID, const char* szFile, ezUInt64 uiHash);
@@ -127,13 +168,12 @@ private:
   mutable ezString m_sServerConnectionAddress;
   ezString m_sFileserveCacheFolder;
   ezString m_sFileserveCacheMetaFolder;
-  bool m_bDownloading = false;
+  bool m_bWaitingForDownload = false;
   bool m_bFailedToConnect = false;
   bool m_bWaitingForUploadFinished = false;
-  ezUuid m_CurFileRequestGuid;
-  ezStringBuilder m_sCurFileRequest;
   ezUniquePtr<ezRemoteInterface> m_Network;
-  ezDynamicArray<ezUInt8> m_Download;
+  ezHashTable<ezUuid, FileRequest> m_PendingRequests;
+  ezDeque<ezString> m_PrefetchQueue;
   ezTime m_CurrentTime;
   ezHybridArray<ezString, 4> m_TryServerAddresses;
 
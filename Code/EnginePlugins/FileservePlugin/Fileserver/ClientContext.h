@@ -14,6 +14,28 @@ enum class ezFileserveFileState
   Different = 5,
 };
 
+/// \brief Describes how the payload of a file download is encoded. The flags are combined, decompression happens before applying a delta.
+struct ezFileserveTransferEncoding
+{
+  enum Enum : ezUInt8
+  {
+    Raw = 0,                ///< The payload is the file content.
+    Compressed = EZ_BIT(0), ///< The payload is compressed with zstd.
+    Delta = EZ_BIT(1),      ///< The payload is an ezBinaryDelta against the version of the file that the client has in its cache.
+  };
+};
+
+/// \brief Flags that the client sends along with a file request.
+struct ezFileserveRequestFlags
+{
+  enum Enum : ezUInt8
+  {
+    None = 0,
+    SupportsCompression = EZ_BIT(0), ///< The client is able to decompress zstd payloads.
+    HasSignature = EZ_BIT(1),        ///< An ezBinaryDelta::Signature of the cached file follows, the server may answer with a delta.
+  };
+};
+
 class EZ_FILESERVEPLUGIN_DLL ezFileserveClientContext
 {
 public:
@@ -6,6 +6,16 @@
 #include <Foundation/Communication/RemoteInterfaceEnet.h>
 #include <Foundation/IO/FileSystem/FileReader.h>
 #include <Foundation/Utilities/CommandLineUtils.h>
+#include <Foundation/Utilities/Compression.h>
+
+namespace
+{
+  /// Downloads are split into messages of this size. Larger messages mean less overhead, but ENet has to fragment them.
+  constexpr ezUInt32 s_uiDownloadChunkSize = 16 * 1024;
+
+  /// Smaller payloads are not worth the effort of compressing them.
+  constexpr ezUInt32 s_uiMinCompressionSize = 256;
+} // namespace
 
 EZ_IMPLEMENT_SINGLETON(ezFileserver);
 
@@ -268,16 +278,38 @@ void ezFileserver::HandleFileRequest(ezFileserveClientContext& client, ezRemoteM
   msg.GetReader() >> status.m_iTimestamp;
   msg.GetReader() >> status.m_uiHash;
 
+  ezUInt8 uiRequestFlags = ezFileserveRequestFlags::None;
+  msg.GetReader() >> uiRequestFlags;
+
+  bool bHasSignature = false;
+  if ((uiRequestFlags & ezFileserveRequestFlags::HasSignature) != 0)
+  {
+    bHasSignature = ezBinaryDelta::ReadSignature(msg.GetReader(), m_ClientSignature).Succeeded();
+  }
+
   ezFileserverEvent e;
   e.m_uiClientID = client.m_uiApplicationID;
   e.m_szPath = sRequestedFile;
   e.m_uiSentTotal = 0;
 
+  const ezUInt16 uiRequestedDataDirID = uiDataDirID;
   const ezFileserveFileState filestate = client.GetFileStatus(uiDataDirID, sRequestedFile, status, m_SendToClient, bForceThisDataDir);
 
+  ezUInt8 uiEncoding = ezFileserveTransferEncoding::Raw;
+  ezArrayPtr<const ezUInt8> payload;
+
+  if (filestate == ezFileserveFileState::Different)
+  {
+    // the signature describes the file in the requested data dir, a delta is useless if the file was found elsewhere
+    const bool bUseDelta = bHasSignature && uiDataDirID == uiRequestedDataDirID;
+    const bool bCompress = (uiRequestFlags & ezFileserveRequestFlags::SupportsCompression) != 0;
+
+    uiEncoding = EncodeDownload(bUseDelta ? &m_ClientSignature : nullptr, bCompress, payload);
+  }
+
   {
     e.m_Type = ezFileserverEvent::Type::FileDownloadRequest;
-    e.m_uiSizeTotal = m_SendToClient.GetCount();
+    e.m_uiSizeTotal = payload.GetCount();
     e.m_FileState = filestate;
     m_Events.Broadcast(e);
   }
@@ -285,21 +317,21 @@ void ezFileserver::HandleFileRequest(ezFileserveClientContext& client, ezRemoteM
   if (filestate == ezFileserveFileState::Different)
   {
     ezUInt32 uiNextByte = 0;
-    const ezUInt32 uiFileSize = m_SendToClient.GetCount();
+    const ezUInt32 uiPayloadSize = payload.GetCount();
 
-    // send the file over in multiple packages of 1KB each
+    // send the payload over in multiple packages
     // send at least one package, even for empty files
     do
     {
-      const ezUInt16 uiChunkSize = (ezUInt16)ezMath::Min<ezUInt32>(1024, m_SendToClient.GetCount() - uiNextByte);
+      const ezUInt16 uiChunkSize = (ezUInt16)ezMath::Min<ezUInt32>(s_uiDownloadChunkSize, uiPayloadSize - uiNextByte);
 
       ezRemoteMessage ret;
       ret.GetWriter() << downloadGuid;
       ret.GetWriter() << uiChunkSize;
-      ret.GetWriter() << uiFileSize;
+      ret.GetWriter() << uiPayloadSize;
 
-      if (!m_SendToClient.IsEmpty())
-        ret.GetWriter().WriteBytes(&m_SendToClient[uiNextByte], uiChunkSize).IgnoreResult();
+      if (uiChunkSize > 0)
+        ret.GetWriter().WriteBytes(&payload[uiNextByte], uiChunkSize).IgnoreResult();
 
       ret.SetMessageID('FSRV', 'DWNL');
       m_Network->Send(ezRemoteTransmitMode::Reliable, ret);
@@ -312,7 +344,7 @@ void ezFileserver::HandleFileRequest(ezFileserveClientContext& client, ezRemoteM
         e.m_uiSentTotal = uiNextByte;
         m_Events.Broadcast(e);
       }
-    } while (uiNextByte < m_SendToClient.GetCount());
+    } while (uiNextByte < uiPayloadSize);
   }
 
   // final answer to client
@@ -323,6 +355,7 @@ void ezFileserver::HandleFileRequest(ezFileserveClientContext& client, ezRemoteM
     ret.GetWriter() << status.m_iTimestamp;
     ret.GetWriter() << status.m_uiHash;
     ret.GetWriter() << uiDataDirID;
+    ret.GetWriter() << uiEncoding;
 
     m_Network->Send(ezRemoteTransmitMode::Reliable, ret);
   }
@@ -334,6 +367,37 @@ void ezFileserver::HandleFileRequest(ezFileserveClientContext& client, ezRemoteM
   }
 }
 
+ezUInt8 ezFileserver::EncodeDownload(const ezBinaryDelta::Signature* pBaseSignature, bool bCompress, ezArrayPtr<const ezUInt8>& out_Payload)
+{
+  ezUInt8 uiEncoding = ezFileserveTransferEncoding::Raw;
+  out_Payload = m_SendToClient;
+
+  if (pBaseSignature != nullptr)
+  {
+    ezBinaryDelta::ComputeDelta(*pBaseSignature, m_SendToClient, m_DeltaPayload);
+
+    if (m_DeltaPayload.GetCount() < m_SendToClient.GetCount())
+    {
+      out_Payload = m_DeltaPayload;
+      uiEncoding |= ezFileserveTransferEncoding::Delta;
+    }
+  }
+
+#ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+  if (bCompress && out_Payload.GetCount() >= s_uiMinCompressionSize)
+  {
+    // already compressed data (e.g. textures) may not get any smaller, send it as it is then
+    if (ezCompressionUtils::Compress(out_Payload, ezCompressionMethod::ZStd, m_CompressedPayload).Succeeded() && m_CompressedPayload.GetCount() < out_Payload.GetCount())
+    {
+      out_Payload = m_CompressedPayload;
+      uiEncoding |= ezFileserveTransferEncoding::Compressed;
+    }
+  }
+#endif
+
+  return uiEncoding;
+}
+
 void ezFileserver::HandleDeleteFileRequest(ezFileserveClientContext& client, ezRemoteMessage& msg)
 {
   ezUInt16 uiDataDirID = 0xffff;
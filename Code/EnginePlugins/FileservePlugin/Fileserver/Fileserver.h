@@ -1,6 +1,7 @@
 #pragma once
 
 #include <FileservePlugin/Fileserver/ClientContext.h>
+#include <Foundation/Algorithm/BinaryDelta.h>
 #include <Foundation/Communication/RemoteInterface.h>
 #include <Foundation/Configuration/Singleton.h>
 #include <Foundation/Containers/HashTable.h>
@@ -53,6 +54,10 @@ struct ezFileserverEvent
 /// needs to know what local path to map them to (it uses the configuration on ezFileSystem).
 /// That means it cannot serve two clients that require different settings for the same special directory.
 ///
+/// Clients may send many file requests without waiting for the answers, the server answers them in the order in which they arrive.
+/// If a client already has an older version of a large file, it sends a block signature of it along with the request and the server
+/// only transfers the blocks that changed (see ezBinaryDelta). Transfers are additionally compressed with zstd, if both sides support it.
+///
 /// The port on which the server connects to clients can be configured through the command line option "-fs_port X"
 class EZ_FILESERVEPLUGIN_DLL ezFileserver
 {
@@ -100,10 +105,14 @@ private:
   void HandleUploadFileHeader(ezFileserveClientContext& client, ezRemoteMessage& msg);
   void HandleUploadFileTransfer(ezFileserveClientContext& client, ezRemoteMessage& msg);
   void HandleUploadFileFinished(ezFileserveClientContext& client, ezRemoteMessage& msg);
+  ezUInt8 EncodeDownload(const ezBinaryDelta::Signature* pBaseSignature, bool bCompress, ezArrayPtr<const ezUInt8>& out_Payload);
 
   ezHashTable<ezUInt32, ezFileserveClientContext> m_Clients;
   ezUniquePtr<ezRemoteInterface> m_Network;
   ezDynamicArray<ezUInt8> m_SendToClient;   // ie. 'downloads' from server to client
+  ezDynamicArray<ezUInt8> m_DeltaPayload;   // m_SendToClient encoded as a delta to the client's version
+  ezDynamicArray<ezUInt8> m_CompressedPayload;
+  ezBinaryDelta::Signature m_ClientSignature;
   ezDynamicArray<ezUInt8> m_SentFromClient; // ie. 'uploads' from client to server
   ezStringBuilder m_sCurFileUpload;
   ezUuid m_FileUploadGuid;
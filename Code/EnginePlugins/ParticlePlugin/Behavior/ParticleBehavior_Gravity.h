@@ -36,11 +36,14 @@ public:
 protected:
   friend class ezParticleBehaviorFactory_Gravity;
 
-  virtual void Process(ezUInt64 uiNumElements) override;
+  virtual bool PrepareRangeProcessing(ezUInt64 uiNumElements) override;
+  virtual void ProcessRange(ezUInt64 uiStartIndex, ezUInt64 uiNumElements) override;
 
   void RequestRequiredWorldModulesForCache(ezParticleWorldModule* pParticleModule) override;
 
   ezPhysicsWorldModuleInterface* m_pPhysicsModule;
 
   ezProcessingStream* m_pStreamVelocity;
+
+  ezVec3 m_vAddGravity;
 };
@@ -1,10 +1,9 @@
 #pragma once
 
+#include <Core/Interfaces/PhysicsWorldModule.h>
 #include <Foundation/Strings/String.h>
 #include <ParticlePlugin/Behavior/ParticleBehavior.h>
 
-class ezPhysicsWorldModuleInterface;
-
 struct EZ_PARTICLEPLUGIN_DLL ezParticleRaycastHitReaction
 {
   typedef ezUInt8 StorageType;
@@ -70,4 +69,10 @@ protected:
   ezProcessingStream* m_pStreamPosition = nullptr;
   ezProcessingStream* m_pStreamLastPosition = nullptr;
   ezProcessingStream* m_pStreamVelocity = nullptr;
+
+  // all rays of one update are cast as one batch, kept across updates to reuse the memory
+  ezDynamicArray<ezPhysicsCastRequest> m_Rays;
+  ezDynamicArray<ezUInt32> m_RayElementIndices;
+  ezDynamicArray<ezPhysicsCastResult> m_HitResults;
+  ezDynamicArray<bool> m_Hits;
 };
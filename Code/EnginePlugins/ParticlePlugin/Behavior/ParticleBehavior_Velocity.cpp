@@ -4,11 +4,11 @@
 #include <Core/Interfaces/WindWorldModule.h>
 #include <Core/World/World.h>
 #include <Core/World/WorldModule.h>
-#include <Foundation/DataProcessing/Stream/ProcessingStreamIterator.h>
 #include <Foundation/Profiling/Profiling.h>
 #include <Foundation/Time/Clock.h>
 #include <ParticlePlugin/Behavior/ParticleBehavior_Velocity.h>
 #include <ParticlePlugin/Finalizer/ParticleFinalizer_ApplyVelocity.h>
+#include <ParticlePlugin/Module/ParticleSimdKernels.h>
 #include <ParticlePlugin/System/ParticleSystemInstance.h>
 #include <ParticlePlugin/WorldModule/ParticleWorldModule.h>
 #include <RendererCore/RenderWorld/RenderWorld.h>
@@ -101,10 +101,8 @@ void ezParticleBehavior_Velocity::CreateRequiredStreams()
   CreateStream("Velocity", ezProcessingStream::DataType::Float3, &m_pStreamVelocity, false);
 }
 
-void ezParticleBehavior_Velocity::Process(ezUInt64 uiNumElements)
+bool ezParticleBehavior_Velocity::PrepareRangeProcessing(ezUInt64 uiNumElements)
 {
-  EZ_PROFILE_SCOPE("PFX: Velocity");
-
   const float tDiff = (float)m_TimeDiff.GetSeconds();
   const ezVec3 vDown = m_pPhysicsModule != nullptr ? m_pPhysicsModule->GetGravity().GetNormalized() : ezVec3(0.0f, 0.0f, -1.0f);
   const ezVec3 vRise = vDown * tDiff * -m_fRiseSpeed;
@@ -129,25 +127,23 @@ void ezParticleBehavior_Velocity::Process(ezUInt64 uiNumElements)
     m_iWindSampleIdx = pOwner->AddWindSampleLocation(GetOwnerSystem()->GetTransform().m_vPosition);
   }
 
-  const ezVec3 vAddPos0 = vRise + vWind;
-
-  ezSimdVec4f vAddPos;
-  vAddPos.Load<3>(&vAddPos0.x);
+  m_vAddPosition = vRise + vWind;
 
   const float fFriction = ezMath::Clamp(m_fFriction, 0.0f, 100.0f);
-  const float fFrictionFactor = ezMath::Pow(0.5f, tDiff * fFriction);
+  m_fFrictionFactor = ezMath::Pow(0.5f, tDiff * fFriction);
 
-  ezProcessingStreamIterator<ezSimdVec4f> itPosition(m_pStreamPosition, uiNumElements, 0);
-  ezProcessingStreamIterator<ezVec3> itVelocity(m_pStreamVelocity, uiNumElements, 0);
+  return true;
+}
 
-  while (!itPosition.HasReachedEnd())
-  {
-    itPosition.Current() += vAddPos;
-    itVelocity.Current() *= fFrictionFactor;
+void ezParticleBehavior_Velocity::ProcessRange(ezUInt64 uiStartIndex, ezUInt64 uiNumElements)
+{
+  EZ_PROFILE_SCOPE("PFX: Velocity");
 
-    itPosition.Advance();
-    itVelocity.Advance();
-  }
+  ezSimdVec4f vAddPos;
+  vAddPos.Load<3>(&m_vAddPosition.x);
+
+  ezParticleSimdKernels::AddToFloat4(m_pStreamPosition->GetWritableData<ezSimdVec4f>() + uiStartIndex, uiNumElements, vAddPos);
+  ezParticleSimdKernels::ScaleFloat3(m_pStreamVelocity->GetWritableData<ezVec3>() + uiStartIndex, uiNumElements, m_fFrictionFactor);
 }
 
 void ezParticleBehavior_Velocity::RequestRequiredWorldModulesForCache(ezParticleWorldModule* pParticleModule)
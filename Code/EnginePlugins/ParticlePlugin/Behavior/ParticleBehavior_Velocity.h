@@ -41,7 +41,8 @@ public:
 protected:
   friend class ezParticleBehaviorFactory_Velocity;
 
-  virtual void Process(ezUInt64 uiNumElements) override;
+  virtual bool PrepareRangeProcessing(ezUInt64 uiNumElements) override;
+  virtual void ProcessRange(ezUInt64 uiStartIndex, ezUInt64 uiNumElements) override;
 
   void RequestRequiredWorldModulesForCache(ezParticleWorldModule* pParticleModule) override;
 
@@ -54,4 +55,8 @@ protected:
   ezProcessingStream* m_pStreamVelocity;
 
   ezVec3 m_vLastWind = ezVec3::ZeroVector();
+
+  // computed once per update in PrepareRangeProcessing()
+  ezVec3 m_vAddPosition = ezVec3::ZeroVector();
+  float m_fFrictionFactor = 1.0f;
 };
@@ -1,10 +1,10 @@
 #include <ParticlePlugin/ParticlePluginPCH.h>
 
 #include <Core/World/World.h>
-#include <Foundation/DataProcessing/Stream/ProcessingStreamIterator.h>
 #include <Foundation/Math/Declarations.h>
 #include <Foundation/Profiling/Profiling.h>
 #include <ParticlePlugin/Finalizer/ParticleFinalizer_LastPosition.h>
+#include <ParticlePlugin/Module/ParticleSimdKernels.h>
 
 // clang-format off
 EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(ezParticleFinalizerFactory_LastPosition, 1, ezRTTIDefaultAllocator<ezParticleFinalizerFactory_LastPosition>)
@@ -42,21 +42,9 @@ void ezParticleFinalizer_LastPosition::CreateRequiredStreams()
   CreateStream("LastPosition", ezProcessingStream::DataType::Float3, &m_pStreamLastPosition, false);
 }
 
-void ezParticleFinalizer_LastPosition::Process(ezUInt64 uiNumElements)
+void ezParticleFinalizer_LastPosition::ProcessRange(ezUInt64 uiStartIndex, ezUInt64 uiNumElements)
 {
   EZ_PROFILE_SCOPE("PFX: LastPosition");
 
-  ezProcessingStreamIterator<ezVec4> itPosition(m_pStreamPosition, uiNumElements, 0);
-  ezProcessingStreamIterator<ezVec3> itLastPosition(m_pStreamLastPosition, uiNumElements, 0);
-
-  while (!itPosition.HasReachedEnd())
-  {
-    ezVec3 curPos = itPosition.Current().GetAsVec3();
-    ezVec3& lastPos = itLastPosition.Current();
-
-    lastPos = curPos;
-
-    itPosition.Advance();
-    itLastPosition.Advance();
-  }
+  ezParticleSimdKernels::CopyFloat4ToFloat3(m_pStreamLastPosition->GetWritableData<ezVec3>() + uiStartIndex, m_pStreamPosition->GetData<ezSimdVec4f>() + uiStartIndex, uiNumElements);
 }
@@ -85,6 +85,7 @@ void ezParticleInitializer_VelocityCone::InitializeElements(ezUInt64 uiStartInde
   EZ_PROFILE_SCOPE("PFX: Velocity Cone");
 
   const ezVec3 startVel = GetOwnerSystem()->GetParticleStartVelocity();
+  const ezQuat qRotation = GetOwnerSystem()->GetTransform().m_qRotation;
 
   ezVec3* pVelocity = m_pStreamVelocity->GetWritableData<ezVec3>();
 
@@ -113,7 +114,7 @@ void ezParticleInitializer_VelocityCone::InitializeElements(ezUInt64 uiStartInde
 
     const float fSpeed = (float)rng.DoubleVariance(m_Speed.m_Value, m_Speed.m_fVariance);
 
-    pVelocity[i] = startVel + GetOwnerSystem()->GetTransform().m_qRotation * dir * fSpeed;
+    pVelocity[i] = startVel + qRotation * dir * fSpeed;
   }
 }
 
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <Foundation/SimdMath/SimdVec4f.h>
+#include <ParticlePlugin/ParticlePluginDLL.h>
+
+/// \brief SIMD loops over the typical particle stream layouts, shared by the built-in particle modules.
+///
+/// Float3 streams are tightly packed, so four elements occupy exactly three SIMD registers. The Float3 kernels work on blocks of four elements
+/// and handle the remainder one by one. Float4 streams are 16 byte aligned and are processed one element per register.
+namespace ezParticleSimdKernels
+{
+  /// \brief pData[i] += vAdd
+  inline void AddToFloat3(ezVec3* pData, ezUInt64 uiNumElements, const ezVec3& vAdd)
+  {
+    // the addend repeats every three floats, which gives three different register patterns for a block of four elements
+    const ezSimdVec4f vAdd0(vAdd.x, vAdd.y, vAdd.z, vAdd.x);
+    const ezSimdVec4f vAdd1(vAdd.y, vAdd.z, vAdd.x, vAdd.y);
+    const ezSimdVec4f vAdd2(vAdd.z, vAdd.x, vAdd.y, vAdd.z);
+
+    const ezUInt64 uiNumBlocks = uiNumElements / 4;
+    float* pFloats = &pData->x;
+
+    for (ezUInt64 i = 0; i < uiNumBlocks; ++i, pFloats += 12)
+    {
+      ezSimdVec4f v0, v1, v2;
+      v0.Load<4>(pFloats + 0);
+      v1.Load<4>(pFloats + 4);
+      v2.Load<4>(pFloats + 8);
+
+      (v0 + vAdd0).Store<4>(pFloats + 0);
+      (v1 + vAdd1).Store<4>(pFloats + 4);
+      (v2 + vAdd2).Store<4>(pFloats + 8);
+    }
+
+    for (ezUInt64 i = uiNumBlocks * 4; i < uiNumElements; ++i)
+    {
+      pData[i] += vAdd;
+    }
+  }
+
+  /// \brief pData[i] *= fScale
+  inline void ScaleFloat3(ezVec3* pData, ezUInt64 uiNumElements, float fScale)
+  {
+    const ezSimdFloat scale(fScale);
+
+    const ezUInt64 uiNumBlocks = uiNumElements / 4;
+    float* pFloats = &pData->x;
+
+    for (ezUInt64 i = 0; i < uiNumBlocks; ++i, pFloats += 12)
+    {
+      ezSimdVec4f v0, v1, v2;
+      v0.Load<4>(pFloats + 0);
+      v1.Load<4>(pFloats + 4);
+      v2.Load<4>(pFloats + 8);
+
+      (v0 * scale).Store<4>(pFloats + 0);
+      (v1 * scale).Store<4>(pFloats + 4);
+      (v2 * scale).Store<4>(pFloats + 8);
+    }
+
+    for (ezUInt64 i = uiNumBlocks * 4; i < uiNumElements; ++i)
+    {
+      pData[i] *= fScale;
+    }
+  }
+
+  /// \brief pData[i] += vAdd
+  inline void AddToFloat4(ezSimdVec4f* pData, ezUInt64 uiNumElements, const ezSimdVec4f& vAdd)
+  {
+    for (ezUInt64 i = 0; i < uiNumElements; ++i)
+    {
+      pData[i] += vAdd;
+    }
+  }
+
+  /// \brief pPositions[i].xyz += pVelocities[i] * fTimeDiff, w is left untouched.
+  inline void IntegrateVelocity(ezSimdVec4f* pPositions, const ezVec3* pVelocities, ezUInt64 uiNumElements, float fTimeDiff)
+  {
+    const ezSimdFloat timeDiff(fTimeDiff);
+    const float* pVel = &pVelocities->x;
+
+    for (ezUInt64 i = 0; i < uiNumElements; ++i, pVel += 3)
+    {
+      ezSimdVec4f vel;
+      vel.Load<3>(pVel); // w = 0
+
+      pPositions[i] = ezSimdVec4f::MulAdd(vel, timeDiff, pPositions[i]);
+    }
+  }
+
+  /// \brief pDst[i] = pSrc[i].xyz
+  inline void CopyFloat4ToFloat3(ezVec3* pDst, const ezSimdVec4f* pSrc, ezUInt64 uiNumElements)
+  {
+    const ezUInt64 uiNumBlocks = uiNumElements / 4;
+    float* pFloats = &pDst->x;
+
+    for (ezUInt64 i = 0; i < uiNumBlocks; ++i, pFloats += 12, pSrc += 4)
+    {
+      // pack xyz of four elements into three registers
+      const ezSimdVec4f p0 = pSrc[0];
+      const ezSimdVec4f p1 = pSrc[1];
+      const ezSimdVec4f p2 = pSrc[2];
+      const ezSimdVec4f p3 = pSrc[3];
+
+      const ezSimdVec4f y1z1x2y2 = p1.GetCombined<ezSwizzle::YZXY>(p2);
+      const ezSimdVec4f z0x1 = p0.GetCombined<ezSwizzle::ZZXX>(p1);
+      const ezSimdVec4f z2x3 = p2.GetCombined<ezSwizzle::ZZXX>(p3);
+
+      p0.GetCombined<ezSwizzle::XYXZ>(z0x1).Store<4>(pFloats + 0);
+      y1z1x2y2.Store<4>(pFloats + 4);
+      z2x3.GetCombined<ezSwizzle::XZYZ>(p3).Store<4>(pFloats + 8);
+    }
+
+    for (ezUInt64 i = uiNumBlocks * 4; i < uiNumElements; ++i, ++pSrc)
+    {
+      pSrc->Store<3>(&pDst[i].x);
+    }
+  }
+} // namespace ezParticleSimdKernels
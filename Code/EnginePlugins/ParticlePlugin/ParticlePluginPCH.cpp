@@ -92,6 +92,7 @@ EZ_STATICLINK_LIBRARY(ParticlePlugin)
   EZ_STATICLINK_REFERENCE(ParticlePlugin_System_ParticleSystemInstance);
   EZ_STATICLINK_REFERENCE(ParticlePlugin_Type_Effect_ParticleTypeEffect);
   EZ_STATICLINK_REFERENCE(ParticlePlugin_Type_Light_ParticleTypeLight);
+  EZ_STATICLINK_REFERENCE(ParticlePlugin_Type_ParticleDepthSort);
   EZ_STATICLINK_REFERENCE(ParticlePlugin_Type_ParticleType);
   EZ_STATICLINK_REFERENCE(ParticlePlugin_Type_Point_ParticleTypePoint);
   EZ_STATICLINK_REFERENCE(ParticlePlugin_Type_Point_PointRenderer);
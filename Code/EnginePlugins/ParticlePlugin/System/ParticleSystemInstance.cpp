@@ -2,6 +2,7 @@
 
 #include <Core/Interfaces/PhysicsWorldModule.h>
 #include <Core/World/World.h>
+#include <Foundation/Configuration/CVar.h>
 #include <Foundation/DataProcessing/Stream/DefaultImplementations/ZeroInitializer.h>
 #include <Foundation/DataProcessing/Stream/ProcessingStreamIterator.h>
 #include <Foundation/DataProcessing/Stream/ProcessingStreamProcessor.h>
@@ -18,6 +19,8 @@
 #include <ParticlePlugin/WorldModule/ParticleWorldModule.h>
 #include <RendererCore/RenderWorld/RenderWorld.h>
 
+ezCVarInt cvar_ParticlesParallelChunkSize("Particles.ParallelChunkSize", 2048, ezCVarFlags::Default, "Systems with at least twice this many particles are simulated in chunks on multiple threads. 0 disables this.");
+
 bool ezParticleSystemInstance::HasActiveParticles() const
 {
   return m_StreamGroup.GetNumActiveElements() > 0;
@@ -448,6 +451,9 @@ ezParticleSystemState::Enum ezParticleSystemInstance::Update(const ezTime& tDiff
 
   {
     EZ_PROFILE_SCOPE("PFX: System Process");
+
+    // keep the chunks a multiple of the SIMD width
+    m_StreamGroup.SetParallelChunkSize(ezMemoryUtils::AlignSize<ezUInt32>(static_cast<ezUInt32>(ezMath::Max(cvar_ParticlesParallelChunkSize.GetValue(), 0)), 4));
     m_StreamGroup.Process();
   }
 
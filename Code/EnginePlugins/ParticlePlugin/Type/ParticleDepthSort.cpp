@@ -0,0 +1,154 @@
+#include <ParticlePlugin/ParticlePluginPCH.h>
+
+#include <ParticlePlugin/Type/ParticleDepthSort.h>
+
+namespace
+{
+  EZ_ALWAYS_INLINE ezUInt32 ComputeSortKey(const ezVec4& vPosition, const ezVec3& vCameraPos)
+  {
+    // squared distances are never negative, so their bit patterns sort the same way as the floats do
+    // inverting the bits makes farther particles come first
+    const float fDistSqr = (vPosition.GetAsVec3() - vCameraPos).GetLengthSquared();
+    return ~*reinterpret_cast<const ezUInt32*>(&fDistSqr);
+  }
+} // namespace
+
+ezArrayPtr<const ezUInt32> ezParticleDepthSort::Sort(const ezVec4* pPositions, ezUInt32 uiNumParticles, const ezVec3& vCameraPos)
+{
+  // bring the previous order up to date: removed particles were replaced by the last one, new particles were appended
+  {
+    const ezUInt32 uiPrevNumParticles = m_Order.GetCount();
+
+    ezUInt32 uiNumKept = 0;
+    for (ezUInt32 i = 0; i < uiPrevNumParticles; ++i)
+    {
+      if (m_Order[i] < uiNumParticles)
+      {
+        m_Order[uiNumKept] = m_Order[i];
+        ++uiNumKept;
+      }
+    }
+
+    m_Order.SetCountUninitialized(uiNumParticles);
+
+    for (ezUInt32 i = uiPrevNumParticles; i < uiNumParticles; ++i)
+    {
+      m_Order[uiNumKept] = i;
+      ++uiNumKept;
+    }
+  }
+
+  m_Keys.SetCountUninitialized(uiNumParticles);
+
+  for (ezUInt32 i = 0; i < uiNumParticles; ++i)
+  {
+    m_Keys[i] = ComputeSortKey(pPositions[m_Order[i]], vCameraPos);
+  }
+
+  // if the order is mostly unchanged, the insertion sort is done after a single pass
+  // once it exceeds a few moves per particle, the radix sort's fixed cost is cheaper
+  if (!InsertionSort(uiNumParticles * 4))
+  {
+    RadixSort();
+  }
+
+  return m_Order;
+}
+
+void ezParticleDepthSort::Reset()
+{
+  m_Order.Clear();
+  m_Keys.Clear();
+  m_TempOrder.Clear();
+  m_TempKeys.Clear();
+}
+
+bool ezParticleDepthSort::InsertionSort(ezUInt32 uiMaxMoves)
+{
+  ezUInt32* pKeys = m_Keys.GetData();
+  ezUInt32* pOrder = m_Order.GetData();
+  const ezUInt32 uiNumElements = m_Keys.GetCount();
+
+  ezUInt32 uiNumMoves = 0;
+
+  for (ezUInt32 i = 1; i < uiNumElements; ++i)
+  {
+    const ezUInt32 uiKey = pKeys[i];
+
+    if (pKeys[i - 1] <= uiKey)
+      continue;
+
+    const ezUInt32 uiIndex = pOrder[i];
+
+    ezUInt32 j = i;
+    do
+    {
+      pKeys[j] = pKeys[j - 1];
+      pOrder[j] = pOrder[j - 1];
+      --j;
+    } while (j > 0 && pKeys[j - 1] > uiKey);
+
+    pKeys[j] = uiKey;
+    pOrder[j] = uiIndex;
+
+    // the arrays are a valid (partially sorted) permutation after every step, so the radix sort can take over from here
+    uiNumMoves += i - j;
+    if (uiNumMoves > uiMaxMoves)
+      return false;
+  }
+
+  return true;
+}
+
+void ezParticleDepthSort::RadixSort()
+{
+  const ezUInt32 uiNumElements = m_Keys.GetCount();
+
+  m_TempKeys.SetCountUninitialized(uiNumElements);
+  m_TempOrder.SetCountUninitialized(uiNumElements);
+
+  ezUInt32* pSrcKeys = m_Keys.GetData();
+  ezUInt32* pSrcOrder = m_Order.GetData();
+  ezUInt32* pDstKeys = m_TempKeys.GetData();
+  ezUInt32* pDstOrder = m_TempOrder.GetData();
+
+  for (ezUInt32 uiShift = 0; uiShift < 32; uiShift += 8)
+  {
+    ezUInt32 offsets[256] = {};
+
+    for (ezUInt32 i = 0; i < uiNumElements; ++i)
+    {
+      ++offsets[(pSrcKeys[i] >> uiShift) & 0xFF];
+    }
+
+    // particles at similar distances share the upper bits, those passes would not change anything
+    if (offsets[(pSrcKeys[0] >> uiShift) & 0xFF] == uiNumElements)
+      continue;
+
+    ezUInt32 uiOffset = 0;
+    for (ezUInt32 b = 0; b < 256; ++b)
+    {
+      const ezUInt32 uiCount = offsets[b];
+      offsets[b] = uiOffset;
+      uiOffset += uiCount;
+    }
+
+    for (ezUInt32 i = 0; i < uiNumElements; ++i)
+    {
+      const ezUInt32 uiDst = offsets[(pSrcKeys[i] >> uiShift) & 0xFF]++;
+      pDstKeys[uiDst] = pSrcKeys[i];
+      pDstOrder[uiDst] = pSrcOrder[i];
+    }
+
+    ezMath::Swap(pSrcKeys, pDstKeys);
+    ezMath::Swap(pSrcOrder, pDstOrder);
+  }
+
+  if (pSrcKeys != m_Keys.GetData())
+  {
+    m_Keys.Swap(m_TempKeys);
+    m_Order.Swap(m_TempOrder);
+  }
+}
+
+EZ_STATICLINK_FILE(ParticlePlugin, ParticlePlugin_Type_ParticleDepthSort);
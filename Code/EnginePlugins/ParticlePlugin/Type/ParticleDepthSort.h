@@ -0,0 +1,32 @@
+#pragma once
+
+#include <ParticlePlugin/ParticlePluginDLL.h>
+
+/// \brief Sorts particles back to front by their distance to the camera.
+///
+/// The order of the previous call is used as the starting point, because from one frame to the next most particles keep their relative order.
+/// Nearly sorted input is finished with an insertion sort, if that needs too many moves (e.g. the camera jumped) a radix sort on the
+/// distance bits is used instead. Neither needs any comparison callbacks or allocations once the arrays have reached their size.
+///
+/// One instance has to be used per particle system and view (or instance) that is sorted, otherwise there is no coherence to exploit.
+class EZ_PARTICLEPLUGIN_DLL ezParticleDepthSort
+{
+public:
+  /// \brief Returns the particle indices ordered from the farthest to the closest particle.
+  ///
+  /// Particles that were removed since the last call are expected to have been replaced by the last particle (as ezProcessingStreamGroup does it).
+  /// The returned array stays valid until the next call.
+  ezArrayPtr<const ezUInt32> Sort(const ezVec4* pPositions, ezUInt32 uiNumParticles, const ezVec3& vCameraPos);
+
+  /// \brief Forgets the previous order.
+  void Reset();
+
+private:
+  bool InsertionSort(ezUInt32 uiMaxMoves);
+  void RadixSort();
+
+  ezDynamicArray<ezUInt32> m_Order;
+  ezDynamicArray<ezUInt32> m_Keys;
+  ezDynamicArray<ezUInt32> m_TempOrder;
+  ezDynamicArray<ezUInt32> m_TempKeys;
+};
@@ -3,11 +3,13 @@
 #include <ParticlePlugin/Type/Quad/ParticleTypeQuad.h>
 
 #include <Core/World/World.h>
+#include <Foundation/Configuration/CVar.h>
 #include <Foundation/Math/Color16f.h>
 #include <Foundation/Math/Float16.h>
 #include <Foundation/Profiling/Profiling.h>
 #include <ParticlePlugin/Effect/ParticleEffectInstance.h>
 #include <ParticlePlugin/Finalizer/ParticleFinalizer_LastPosition.h>
+#include <ParticlePlugin/Resources/ParticleEffectResource.h>
 #include <RendererCore/Pipeline/View.h>
 #include <RendererCore/RenderWorld/RenderWorld.h>
 #include <RendererFoundation/Shader/ShaderUtils.h>
@@ -187,12 +189,7 @@ void ezParticleTypeQuad::CreateRequiredStreams()
   }
 }
 
-struct sodComparer
-{
-  // sort farther particles to the front, so that they get rendered first (back to front)
-  EZ_ALWAYS_INLINE bool Less(const ezParticleTypeQuad::sod& a, const ezParticleTypeQuad::sod& b) const { return a.dist > b.dist; }
-  EZ_ALWAYS_INLINE bool Equal(const ezParticleTypeQuad::sod& a, const ezParticleTypeQuad::sod& b) const { return a.dist == b.dist; }
-};
+ezCVarBool cvar_ParticlesSortPerView("Particles.SortPerView", true, ezCVarFlags::Default, "Sort blended particles of shared effects separately for every view and instance, instead of once per frame.");
 
 void ezParticleTypeQuad::ExtractTypeRenderData(ezMsgExtractRenderData& msg, const ezTransform& instanceTransform) const
 {
@@ -204,31 +201,65 @@ void ezParticleTypeQuad::ExtractTypeRenderData(ezMsgExtractRenderData& msg, cons
 
   const bool bNeedsSorting = (m_RenderMode == ezParticleTypeRenderMode::Blended) || (m_RenderMode == ezParticleTypeRenderMode::BlendedForeground) || (m_RenderMode == ezParticleTypeRenderMode::BlendedBackground) || (m_RenderMode == ezParticleTypeRenderMode::BlendAdd);
 
+  ezVec3 vCameraPos = msg.m_pView->GetCullingCamera()->GetCenterPosition();
+
+  if (GetOwnerEffect()->NeedsToApplyTransform())
+  {
+    // the particles are simulated relative to the effect and rendered at every instance transform
+    vCameraPos = instanceTransform.GetInverse().TransformPosition(vCameraPos);
+  }
+
+  EZ_LOCK(m_ExtractionMutex);
+
   // don't copy the data multiple times in the same frame, if the effect is instanced
-  if ((m_uiLastExtractedFrame != ezRenderWorld::GetFrameCounter())
-    /*&& !bNeedsSorting*/) // TODO: in theory every shared instance has to sort the Quads, in practice this maybe should be an option
+  // unless the particles need to be sorted and the camera is somewhere else relative to them
+  bool bExtract = m_uiLastExtractedFrame != ezRenderWorld::GetFrameCounter();
+  if (!bExtract && bNeedsSorting && cvar_ParticlesSortPerView)
   {
-    m_uiLastExtractedFrame = ezRenderWorld::GetFrameCounter();
+    bExtract = !m_vLastSortCameraPos.IsEqual(vCameraPos, 0.01f);
+  }
+
+  if (bExtract)
+  {
+    const ezUInt64 uiFrameCounter = ezRenderWorld::GetFrameCounter();
+
+    if (m_uiLastExtractedFrame != uiFrameCounter)
+    {
+      // forget the order of views that haven't shown this effect for a while
+      for (auto it = m_DepthSorts.GetIterator(); it.IsValid();)
+      {
+        if (it.Value().m_uiLastUsedFrame + 60 < uiFrameCounter)
+          it = m_DepthSorts.Remove(it);
+        else
+          ++it;
+      }
+    }
+
+    m_uiLastExtractedFrame = uiFrameCounter;
 
     if (bNeedsSorting)
     {
-      // TODO: Using the frame allocator this way results in memory corruptions.
-      // Not sure, whether this is supposed to work.
-      ezHybridArray<sod, 64> sorted; // (ezFrameAllocator::GetCurrentAllocator());
-      sorted.SetCountUninitialized(numParticles);
+      m_vLastSortCameraPos = vCameraPos;
 
-      const ezVec3 vCameraPos = msg.m_pView->GetCullingCamera()->GetCenterPosition();
-      const ezVec4* pPosition = m_pStreamPosition->GetData<ezVec4>();
+      // every view keeps its own order, otherwise views would destroy each other's coherence
+      ViewDepthSort& viewSort = m_DepthSorts[msg.m_pView->GetHandle()];
+      viewSort.m_uiLastUsedFrame = uiFrameCounter;
+
+      ezArrayPtr<const ezUInt32> sorted;
 
-      for (ezUInt32 p = 0; p < numParticles; ++p)
       {
-        sorted[p].dist = (pPosition[p].GetAsVec3() - vCameraPos).GetLengthSquared();
-        sorted[p].index = p;
-      }
+#if EZ_ENABLED(EZ_USE_PROFILING)
+        ezResourceLock<ezParticleEffectResource> pEffect(GetOwnerEffect()->GetResource(), ezResourceAcquireMode::PointerOnly);
+        const ezString& sEffectName = pEffect->GetResourceDescription().IsEmpty() ? pEffect->GetResourceID() : pEffect->GetResourceDescription();
 
-      sorted.Sort(sodComparer());
+        ezStringBuilder sScopeName("PFX Sort: ", sEffectName);
+        EZ_PROFILE_SCOPE(sScopeName.GetData());
+#endif
+
+        sorted = viewSort.m_DepthSort.Sort(m_pStreamPosition->GetData<ezVec4>(), numParticles, vCameraPos);
+      }
 
-      CreateExtractedData(&sorted);
+      CreateExtractedData(sorted.GetPtr());
     }
     else
     {
@@ -239,17 +270,17 @@ void ezParticleTypeQuad::ExtractTypeRenderData(ezMsgExtractRenderData& msg, cons
   AddParticleRenderData(msg, instanceTransform);
 }
 
-EZ_ALWAYS_INLINE ezUInt32 noRedirect(ezUInt32 idx, const ezHybridArray<ezParticleTypeQuad::sod, 64>* pSorted)
+EZ_ALWAYS_INLINE ezUInt32 noRedirect(ezUInt32 idx, const ezUInt32* pSorted)
 {
   return idx;
 }
 
-EZ_ALWAYS_INLINE ezUInt32 sortedRedirect(ezUInt32 idx, const ezHybridArray<ezParticleTypeQuad::sod, 64>* pSorted)
+EZ_ALWAYS_INLINE ezUInt32 sortedRedirect(ezUInt32 idx, const ezUInt32* pSorted)
 {
-  return (*pSorted)[idx].index;
+  return pSorted[idx];
 }
 
-void ezParticleTypeQuad::CreateExtractedData(const ezHybridArray<sod, 64>* pSorted) const
+void ezParticleTypeQuad::CreateExtractedData(const ezUInt32* pSorted) const
 {
   auto redirect = (pSorted != nullptr) ? sortedRedirect : noRedirect;
 
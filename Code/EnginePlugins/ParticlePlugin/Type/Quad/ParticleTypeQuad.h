@@ -1,7 +1,11 @@
 #pragma once
 
+#include <Foundation/Containers/HashTable.h>
+#include <Foundation/Threading/Mutex.h>
+#include <ParticlePlugin/Type/ParticleDepthSort.h>
 #include <ParticlePlugin/Type/ParticleType.h>
 #include <ParticlePlugin/Type/Quad/QuadParticleRenderer.h>
+#include <RendererCore/Pipeline/Declarations.h>
 #include <RendererFoundation/RendererFoundationDLL.h>
 
 using ezTexture2DResourceHandle = ezTypedResourceHandle<class ezTexture2DResource>;
@@ -80,21 +84,12 @@ public:
 
   virtual void ExtractTypeRenderData(ezMsgExtractRenderData& msg, const ezTransform& instanceTransform) const override;
 
-  struct sod
-  {
-    EZ_DECLARE_POD_TYPE();
-
-    float dist;
-    ezUInt32 index;
-  };
-
-
 protected:
   virtual void InitializeElements(ezUInt64 uiStartIndex, ezUInt64 uiNumElements) override;
   virtual void Process(ezUInt64 uiNumElements) override {}
   void AllocateParticleData(const ezUInt32 numParticles, const bool bNeedsBillboardData, const bool bNeedsTangentData) const;
   void AddParticleRenderData(ezMsgExtractRenderData& msg, const ezTransform& instanceTransform) const;
-  void CreateExtractedData(const ezHybridArray<sod, 64>* pSorted) const;
+  void CreateExtractedData(const ezUInt32* pSorted) const;
 
   ezProcessingStream* m_pStreamLifeTime = nullptr;
   ezProcessingStream* m_pStreamPosition = nullptr;
@@ -109,4 +104,15 @@ protected:
   mutable ezArrayPtr<ezBaseParticleShaderData> m_BaseParticleData;
   mutable ezArrayPtr<ezBillboardQuadParticleShaderData> m_BillboardParticleData;
   mutable ezArrayPtr<ezTangentQuadParticleShaderData> m_TangentParticleData;
+
+  struct ViewDepthSort
+  {
+    ezParticleDepthSort m_DepthSort;
+    ezUInt64 m_uiLastUsedFrame = 0;
+  };
+
+  /// Views may be extracted in parallel, the extracted data and the sort state are only touched while holding this mutex.
+  mutable ezMutex m_ExtractionMutex;
+  mutable ezHashTable<ezViewHandle, ViewDepthSort> m_DepthSorts;
+  mutable ezVec3 m_vLastSortCameraPos = ezVec3::ZeroVector();
 };
@@ -7,6 +7,7 @@
 #include <Foundation/Configuration/CVar.h>
 #include <Foundation/Memory/FrameAllocator.h>
 #include <Foundation/Profiling/Profiling.h>
+#include <Foundation/Threading/TaskSystem.h>
 #include <PhysXPlugin/Components/PxDynamicActorComponent.h>
 #include <PhysXPlugin/Components/PxQueryShapeActorComponent.h>
 #include <PhysXPlugin/Components/PxSettingsComponent.h>
@@ -222,6 +223,53 @@ namespace
       out_Result.m_hSurface = ezSurfaceResourceHandle(pSurface);
     }
   }
+
+  PxQueryFilterData CreateQueryFilterData(const ezPhysicsQueryParameters& params, ezPhysicsHitCollection collection)
+  {
+    PxQueryFilterData filterData;
+    filterData.data = ezPhysX::CreateFilterData(params.m_uiCollisionLayer, params.m_uiIgnoreShapeId);
+    filterData.flags = PxQueryFlag::ePREFILTER;
+
+    if (params.m_ShapeTypes.IsSet(ezPhysicsShapeType::Static))
+    {
+      filterData.flags |= PxQueryFlag::eSTATIC;
+    }
+
+    if (params.m_ShapeTypes.IsSet(ezPhysicsShapeType::Dynamic))
+    {
+      filterData.flags |= PxQueryFlag::eDYNAMIC;
+    }
+
+    if (collection == ezPhysicsHitCollection::Any)
+    {
+      filterData.flags |= PxQueryFlag::eANY_HIT;
+    }
+
+    return filterData;
+  }
+
+  /// \brief Calls castFunc(uiStartIndex, uiEndIndex) for all casts of a batch, which returns the number of hits in that range.
+  /// Large batches are distributed across the task system, if allowed.
+  template <typename CastFunc>
+  ezUInt32 ExecuteCastBatch(ezUInt32 uiNumCasts, bool bAllowMultiThreading, const CastFunc& castFunc)
+  {
+    constexpr ezUInt32 uiCastsPerTask = 64;
+
+    if (!bAllowMultiThreading || uiNumCasts < uiCastsPerTask * 2)
+    {
+      return castFunc(0, uiNumCasts);
+    }
+
+    ezAtomicInteger32 iNumHits;
+
+    ezParallelForParams parallelForParams;
+    parallelForParams.uiBinSize = uiCastsPerTask;
+
+    ezTaskSystem::ParallelForIndexed(
+      0, uiNumCasts, [&](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) { iNumHits.Add(castFunc(uiStartIndex, uiEndIndex)); }, "PhysX Cast Batch", parallelForParams);
+
+    return static_cast<ezUInt32>(static_cast<ezInt32>(iNumHits));
+  }
 } // namespace
 
 EZ_DEFINE_AS_POD_TYPE(PxOverlapHit);
@@ -409,9 +457,7 @@ bool ezPhysXWorldModule::Raycast(ezPhysicsCastResult& out_Result, const ezVec3&
   if (fDistance <= 0.001f || vDir.IsZero())
     return false;
 
-  PxQueryFilterData filterData;
-  filterData.data = ezPhysX::CreateFilterData(params.m_uiCollisionLayer, params.m_uiIgnoreShapeId);
-  filterData.flags = PxQueryFlag::ePREFILTER;
+  PxQueryFilterData filterData = CreateQueryFilterData(params, collection);
 
   if (params.m_bIgnoreInitialOverlap)
   {
@@ -419,21 +465,6 @@ bool ezPhysXWorldModule::Raycast(ezPhysicsCastResult& out_Result, const ezVec3&
     filterData.flags |= PxQueryFlag::ePOSTFILTER;
   }
 
-  if (params.m_ShapeTypes.IsSet(ezPhysicsShapeType::Static))
-  {
-    filterData.flags |= PxQueryFlag::eSTATIC;
-  }
-
-  if (params.m_ShapeTypes.IsSet(ezPhysicsShapeType::Dynamic))
-  {
-    filterData.flags |= PxQueryFlag::eDYNAMIC;
-  }
-
-  if (collection == ezPhysicsHitCollection::Any)
-  {
-    filterData.flags |= PxQueryFlag::eANY_HIT;
-  }
-
   ezPxRaycastCallback closestHit;
   ezPxQueryFilter queryFilter;
   queryFilter.m_bIncludeQueryShapes = params.m_bIncludeQueryShapes;
@@ -450,6 +481,47 @@ bool ezPhysXWorldModule::Raycast(ezPhysicsCastResult& out_Result, const ezVec3&
   return false;
 }
 
+ezUInt32 ezPhysXWorldModule::RaycastBatch(ezArrayPtr<const ezPhysicsCastRequest> rays, ezArrayPtr<ezPhysicsCastResult> out_Results, ezArrayPtr<bool> out_Hits, const ezPhysicsQueryParameters& params, ezPhysicsHitCollection collection, bool bAllowMultiThreading) const
+{
+  EZ_ASSERT_DEV(out_Results.GetCount() >= rays.GetCount() && out_Hits.GetCount() >= rays.GetCount(), "Result arrays are too small");
+
+  PxQueryFilterData filterData = CreateQueryFilterData(params, collection);
+
+  if (params.m_bIgnoreInitialOverlap)
+  {
+    filterData.flags |= PxQueryFlag::ePOSTFILTER;
+  }
+
+  ezPxQueryFilter queryFilter;
+  queryFilter.m_bIncludeQueryShapes = params.m_bIncludeQueryShapes;
+
+  return ExecuteCastBatch(rays.GetCount(), bAllowMultiThreading, [&](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) {
+    EZ_PX_READ_LOCK(*m_pPxScene);
+
+    ezUInt32 uiNumHits = 0;
+
+    for (ezUInt32 i = uiStartIndex; i < uiEndIndex; ++i)
+    {
+      const ezPhysicsCastRequest& ray = rays[i];
+      out_Hits[i] = false;
+
+      if (ray.m_fDistance <= 0.001f || ray.m_vDir.IsZero())
+        continue;
+
+      ezPxRaycastCallback closestHit;
+
+      if (m_pPxScene->raycast(ezPxConversionUtils::ToVec3(ray.m_vStart), ezPxConversionUtils::ToVec3(ray.m_vDir), ray.m_fDistance, closestHit, PxHitFlag::eDEFAULT, filterData, &queryFilter))
+      {
+        FillHitResult(closestHit.block, out_Results[i]);
+        out_Hits[i] = true;
+        ++uiNumHits;
+      }
+    }
+
+    return uiNumHits;
+  });
+}
+
 bool ezPhysXWorldModule::RaycastAll(ezPhysicsCastResultArray& out_Results, const ezVec3& vStart, const ezVec3& vDir, float fDistance, const ezPhysicsQueryParameters& params) const
 {
   if (fDistance <= 0.001f || vDir.IsZero())
@@ -504,6 +576,46 @@ bool ezPhysXWorldModule::SweepTestSphere(ezPhysicsCastResult& out_Result, float
   return SweepTest(out_Result, sphere, transform, vDir, fDistance, params, collection);
 }
 
+ezUInt32 ezPhysXWorldModule::SweepTestSphereBatch(float fSphereRadius, ezArrayPtr<const ezPhysicsCastRequest> sweeps, ezArrayPtr<ezPhysicsCastResult> out_Results, ezArrayPtr<bool> out_Hits, const ezPhysicsQueryParameters& params, ezPhysicsHitCollection collection, bool bAllowMultiThreading) const
+{
+  EZ_ASSERT_DEV(out_Results.GetCount() >= sweeps.GetCount() && out_Hits.GetCount() >= sweeps.GetCount(), "Result arrays are too small");
+
+  PxSphereGeometry sphere;
+  sphere.radius = fSphereRadius;
+
+  const PxQueryFilterData filterData = CreateQueryFilterData(params, collection);
+
+  ezPxQueryFilter queryFilter;
+  queryFilter.m_bIncludeQueryShapes = params.m_bIncludeQueryShapes;
+
+  return ExecuteCastBatch(sweeps.GetCount(), bAllowMultiThreading, [&](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) {
+    EZ_PX_READ_LOCK(*m_pPxScene);
+
+    ezUInt32 uiNumHits = 0;
+
+    for (ezUInt32 i = uiStartIndex; i < uiEndIndex; ++i)
+    {
+      const ezPhysicsCastRequest& sweep = sweeps[i];
+      out_Hits[i] = false;
+
+      if (sweep.m_fDistance <= 0.001f || sweep.m_vDir.IsZero())
+        continue;
+
+      const PxTransform transform = ezPxConversionUtils::ToTransform(sweep.m_vStart, ezQuat::IdentityQuaternion());
+      ezPxSweepCallback closestHit;
+
+      if (m_pPxScene->sweep(sphere, transform, ezPxConversionUtils::ToVec3(sweep.m_vDir), sweep.m_fDistance, closestHit, PxHitFlag::eDEFAULT, filterData, &queryFilter))
+      {
+        FillHitResult(closestHit.block, out_Results[i]);
+        out_Hits[i] = true;
+        ++uiNumHits;
+      }
+    }
+
+    return uiNumHits;
+  });
+}
+
 bool ezPhysXWorldModule::SweepTestBox(ezPhysicsCastResult& out_Result, ezVec3 vBoxExtends, const ezTransform& transform, const ezVec3& vDir, float fDistance, const ezPhysicsQueryParameters& params, ezPhysicsHitCollection collection) const
 {
   PxBoxGeometry box;
@@ -531,25 +643,10 @@ bool ezPhysXWorldModule::SweepTestCapsule(ezPhysicsCastResult& out_Result, float
 
 bool ezPhysXWorldModule::SweepTest(ezPhysicsCastResult& out_Result, const physx::PxGeometry& geometry, const physx::PxTransform& transform, const ezVec3& vDir, float fDistance, const ezPhysicsQueryParameters& params, ezPhysicsHitCollection collection) const
 {
-  PxQueryFilterData filterData;
-  filterData.data = ezPhysX::CreateFilterData(params.m_uiCollisionLayer, params.m_uiIgnoreShapeId);
-
-  filterData.flags = PxQueryFlag::ePREFILTER;
-
-  if (params.m_ShapeTypes.IsSet(ezPhysicsShapeType::Static))
-  {
-    filterData.flags |= PxQueryFlag::eSTATIC;
-  }
-
-  if (params.m_ShapeTypes.IsSet(ezPhysicsShapeType::Dynamic))
-  {
-    filterData.flags |= PxQueryFlag::eDYNAMIC;
-  }
+  if (fDistance <= 0.001f || vDir.IsZero())
+    return false;
 
-  if (collection == ezPhysicsHitCollection::Any)
-  {
-    filterData.flags |= PxQueryFlag::eANY_HIT;
-  }
+  const PxQueryFilterData filterData = CreateQueryFilterData(params, collection);
 
   ezPxSweepCallback closestHit;
   ezPxQueryFilter queryFilter;
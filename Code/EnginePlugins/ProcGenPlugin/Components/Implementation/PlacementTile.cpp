@@ -6,6 +6,7 @@
 #include <Foundation/SimdMath/SimdConversion.h>
 #include <ProcGenPlugin/Components/Implementation/PlacementTile.h>
 #include <ProcGenPlugin/Tasks/PlacementData.h>
+#include <RendererCore/Meshes/MeshResource.h>
 
 using namespace ezProcGenInternal;
 
@@ -24,6 +25,14 @@ PlacementTile::PlacementTile(PlacementTile&& other)
   other.m_State = State::Invalid;
 
   m_PlacedObjects = std::move(other.m_PlacedObjects);
+  m_uiNextTransformIndex = other.m_uiNextTransformIndex;
+
+  m_InstanceBatches = std::move(other.m_InstanceBatches);
+  m_uiNumPlacedInstances = other.m_uiNumPlacedInstances;
+  m_InstanceBounds = other.m_InstanceBounds;
+
+  m_AllocationTime = other.m_AllocationTime;
+  m_SpawnLatency = other.m_SpawnLatency;
 }
 
 PlacementTile::~PlacementTile()
@@ -37,6 +46,14 @@ void PlacementTile::Initialize(const PlacementTileDesc& desc, ezSharedPtr<const
   m_pOutput = pOutput;
 
   m_State = State::Initialized;
+  m_uiNextTransformIndex = 0;
+
+  m_InstanceBatches.Clear();
+  m_uiNumPlacedInstances = 0;
+  m_InstanceBounds.SetInvalid();
+
+  m_AllocationTime = ezTime::Now();
+  m_SpawnLatency.SetZero();
 }
 
 void PlacementTile::Deinitialize(ezWorld& world)
@@ -47,6 +64,13 @@ void PlacementTile::Deinitialize(ezWorld& world)
   }
   m_PlacedObjects.Clear();
 
+  for (auto& instanceBatch : m_InstanceBatches)
+  {
+    EZ_ASSERT_DEV(instanceBatch.m_pInstanceData == nullptr, "Instance data must be released by the component manager before the tile is deinitialized");
+  }
+  m_InstanceBatches.Clear();
+  m_uiNumPlacedInstances = 0;
+
   m_Desc.m_hComponent.Invalidate();
   m_pOutput = nullptr;
   m_State = State::Invalid;
@@ -85,6 +109,8 @@ ezColor PlacementTile::GetDebugColor() const
       return ezColor::Orange;
     case State::Scheduled:
       return ezColor::Yellow;
+    case State::Placing:
+      return ezColor::YellowGreen;
     case State::Finished:
       return ezColor::Green;
     default:
@@ -101,31 +127,62 @@ void PlacementTile::PreparePlacementData(const ezWorld* pWorld, const ezPhysicsW
   placementData.m_TileBoundingBox = GetBoundingBox();
   placementData.m_GlobalToLocalBoxTransforms = m_Desc.m_GlobalToLocalBoxTransforms;
 
+  // start loading the prefabs or meshes in the background, so they are hopefully available once the placement task is done
+  if (m_pOutput->IsInstanceOnly())
+  {
+    for (auto& hMesh : m_pOutput->m_MeshesToPlace)
+    {
+      ezResourceManager::PreloadResource(hMesh);
+    }
+  }
+  else
+  {
+    for (auto& hPrefab : m_pOutput->m_ObjectsToPlace)
+    {
+      ezResourceManager::PreloadResource(hPrefab);
+    }
+  }
+
   m_State = State::Scheduled;
 }
 
-ezUInt32 PlacementTile::PlaceObjects(ezWorld& world, ezArrayPtr<const PlacementTransform> objectTransforms)
+bool PlacementTile::PlaceObjects(ezWorld& world, ezArrayPtr<const PlacementTransform> objectTransforms, ezTime endTime, ezUInt32 uiMaxNewObjects)
 {
   EZ_PROFILE_SCOPE("PlacementTile::PlaceObjects");
 
-  ezGameObjectDesc desc;
   auto& objectsToPlace = m_pOutput->m_ObjectsToPlace;
 
   ezHybridArray<ezPrefabResource*, 4> prefabs;
   prefabs.SetCount(objectsToPlace.GetCount());
 
-
-
-  for (auto& objectTransform : objectTransforms)
+  // don't block the main thread on loading, try again next frame instead
+  bool bAllPrefabsLoaded = true;
+  for (ezUInt32 i = 0; i < objectsToPlace.GetCount(); ++i)
   {
-    const ezUInt32 uiObjectIndex = objectTransform.m_uiObjectIndex;
-    ezPrefabResource* pPrefab = prefabs[uiObjectIndex];
+    prefabs[i] = ezResourceManager::BeginAcquireResource(objectsToPlace[i], ezResourceAcquireMode::PointerOnly);
 
-    if (pPrefab == nullptr)
+    const ezResourceState state = prefabs[i]->GetLoadingState();
+    if (state != ezResourceState::Loaded && state != ezResourceState::LoadedResourceMissing)
     {
-      pPrefab = ezResourceManager::BeginAcquireResource(objectsToPlace[uiObjectIndex], ezResourceAcquireMode::BlockTillLoaded);
-      prefabs[uiObjectIndex] = pPrefab;
+      ezResourceManager::PreloadResource(objectsToPlace[i]);
+      bAllPrefabsLoaded = false;
     }
+  }
+
+  const ezUInt32 uiNumTransforms = bAllPrefabsLoaded ? objectTransforms.GetCount() : 0;
+  ezUInt32 uiNumNewObjects = 0;
+
+  if (bAllPrefabsLoaded)
+  {
+    m_State = State::Placing;
+  }
+
+  while (m_uiNextTransformIndex < uiNumTransforms)
+  {
+    auto& objectTransform = objectTransforms[m_uiNextTransformIndex];
+    ++m_uiNextTransformIndex;
+
+    ezPrefabResource* pPrefab = prefabs[objectTransform.m_uiObjectIndex];
 
     ezTransform transform = ezSimdConversion::ToTransform(objectTransform.m_Transform);
     ezHybridArray<ezGameObject*, 8> rootObjects;
@@ -151,17 +208,136 @@ ezUInt32 PlacementTile::PlaceObjects(ezWorld& world, ezArrayPtr<const PlacementT
     {
       m_PlacedObjects.PushBack(pRootObject->GetHandle());
     }
+
+    uiNumNewObjects += rootObjects.GetCount();
+
+    // stop after the object that exceeded the budget, so that every call makes progress
+    if (uiNumNewObjects >= uiMaxNewObjects || ezTime::Now() >= endTime)
+    {
+      break;
+    }
   }
 
   for (auto pPrefab : prefabs)
   {
-    if (pPrefab != nullptr)
+    ezResourceManager::EndAcquireResource(pPrefab);
+  }
+
+  if (!bAllPrefabsLoaded || m_uiNextTransformIndex < objectTransforms.GetCount())
+  {
+    return false;
+  }
+
+  m_State = State::Finished;
+  m_SpawnLatency = ezTime::Now() - m_AllocationTime;
+
+  return true;
+}
+
+bool PlacementTile::PlaceInstances(ezArrayPtr<const PlacementTransform> objectTransforms, ezUInt32 uiUniqueID)
+{
+  EZ_PROFILE_SCOPE("PlacementTile::PlaceInstances");
+
+  auto& meshesToPlace = m_pOutput->m_MeshesToPlace;
+
+  // the mesh bounds are needed for the instance bounding spheres, don't block the main thread on loading though
+  ezHybridArray<ezBoundingBoxSphere, 4> meshBounds;
+  meshBounds.SetCount(meshesToPlace.GetCount());
+
+  for (ezUInt32 i = 0; i < meshesToPlace.GetCount(); ++i)
+  {
+    ezResourceLock<ezMeshResource> pMesh(meshesToPlace[i], ezResourceAcquireMode::PointerOnly);
+
+    const ezResourceState state = pMesh->GetLoadingState();
+    if (state != ezResourceState::Loaded && state != ezResourceState::LoadedResourceMissing)
+    {
+      ezResourceManager::PreloadResource(meshesToPlace[i]);
+      return false;
+    }
+
+    meshBounds[i] = pMesh->GetBounds();
+  }
+
+  m_State = State::Placing;
+
+  m_InstanceBatches.SetCount(meshesToPlace.GetCount());
+  for (ezUInt32 i = 0; i < meshesToPlace.GetCount(); ++i)
+  {
+    m_InstanceBatches[i].m_hMesh = meshesToPlace[i];
+  }
+
+  for (auto& objectTransform : objectTransforms)
+  {
+    const ezTransform transform = ezSimdConversion::ToTransform(objectTransform.m_Transform);
+    const ezMat4 objectToWorld = transform.GetAsMat4();
+
+    ezPerInstanceData& instanceData = m_InstanceBatches[objectTransform.m_uiObjectIndex].m_InstanceData.ExpandAndGetRef();
+    instanceData.ObjectToWorld = objectToWorld;
+
+    if (transform.ContainsUniformScale())
     {
-      ezResourceManager::EndAcquireResource(pPrefab);
+      instanceData.ObjectToWorldNormal = objectToWorld;
     }
+    else
+    {
+      ezMat3 mInverse = objectToWorld.GetRotationalPart();
+      mInverse.Invert(0.0f).IgnoreResult();
+
+      ezShaderTransform shaderT;
+      shaderT = mInverse.GetTranspose();
+      instanceData.ObjectToWorldNormal = shaderT;
+    }
+
+    const ezBoundingBoxSphere& bounds = meshBounds[objectTransform.m_uiObjectIndex];
+
+    instanceData.BoundingSphereRadius = bounds.m_fSphereRadius * transform.GetMaxScale();
+    instanceData.GameObjectID = uiUniqueID;
+    instanceData.VertexColorAccessData = 0;
+    instanceData.Color = objectTransform.m_uiSetColor != 0 ? objectTransform.m_ObjectColor : ezColor::White;
+
+    ezBoundingBoxSphere instanceBounds = bounds;
+    instanceBounds.Transform(objectToWorld);
+    m_InstanceBounds.ExpandToInclude(instanceBounds.GetBox());
   }
 
+  // drop meshes that did not get any instances, they would only cost empty draw calls
+  for (ezUInt32 i = m_InstanceBatches.GetCount(); i-- > 0;)
+  {
+    if (m_InstanceBatches[i].m_InstanceData.IsEmpty())
+    {
+      m_InstanceBatches.RemoveAtAndSwap(i);
+    }
+  }
+
+  m_uiNumPlacedInstances = objectTransforms.GetCount();
+
   m_State = State::Finished;
+  m_SpawnLatency = ezTime::Now() - m_AllocationTime;
+
+  return true;
+}
+
+ezArrayPtr<PlacementTile::InstanceBatch> PlacementTile::GetInstanceBatches()
+{
+  return m_InstanceBatches;
+}
 
-  return m_PlacedObjects.GetCount();
+ezArrayPtr<const PlacementTile::InstanceBatch> PlacementTile::GetInstanceBatches() const
+{
+  return m_InstanceBatches;
+}
+
+ezUInt32 PlacementTile::GetNumPlacedInstances() const
+{
+  return m_uiNumPlacedInstances;
+}
+
+const ezBoundingBox& PlacementTile::GetInstanceBounds() const
+{
+  return m_InstanceBounds;
+}
+
+ezTime PlacementTile::GetSpawnLatency() const
+{
+  return m_SpawnLatency;
 }
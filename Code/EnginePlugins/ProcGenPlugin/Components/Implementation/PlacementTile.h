@@ -3,8 +3,10 @@
 #include <Core/World/Declarations.h>
 #include <Foundation/Types/UniquePtr.h>
 #include <ProcGenPlugin/Declarations.h>
+#include <RendererCore/../../../Data/Base/Shaders/Common/ObjectConstants.h>
 
 class ezPhysicsWorldModuleInterface;
+struct ezInstanceData;
 
 namespace ezProcGenInternal
 {
@@ -28,7 +30,34 @@ namespace ezProcGenInternal
 
     void PreparePlacementData(const ezWorld* pWorld, const ezPhysicsWorldModuleInterface* pPhysicsModule, PlacementData& placementData);
 
-    ezUInt32 PlaceObjects(ezWorld& world, ezArrayPtr<const PlacementTransform> objectTransforms);
+    /// \brief Instantiates the prefabs for the given transforms, continuing where the previous call stopped.
+    ///
+    /// Stops after the first object that exceeds the time or object budget. Does nothing while the prefabs are still being loaded.
+    /// Returns true once all transforms have been processed.
+    bool PlaceObjects(ezWorld& world, ezArrayPtr<const PlacementTransform> objectTransforms, ezTime endTime, ezUInt32 uiMaxNewObjects);
+
+    /// \brief Converts the transforms into per instance data for the meshes of an instance-only output, no game objects are created.
+    ///
+    /// Does nothing while the meshes are still being loaded. Returns true once the instance data has been created.
+    bool PlaceInstances(ezArrayPtr<const PlacementTransform> objectTransforms, ezUInt32 uiUniqueID);
+
+    /// \brief The instances of one mesh of an instance-only output.
+    struct InstanceBatch
+    {
+      ezMeshResourceHandle m_hMesh;
+      ezDynamicArray<ezPerInstanceData, ezAlignedAllocatorWrapper> m_InstanceData;
+      ezInstanceData* m_pInstanceData = nullptr; ///< GPU buffer owned by the component manager, only set once the instances are uploaded.
+    };
+
+    ezArrayPtr<InstanceBatch> GetInstanceBatches();
+    ezArrayPtr<const InstanceBatch> GetInstanceBatches() const;
+    ezUInt32 GetNumPlacedInstances() const;
+
+    /// \brief Bounds of all placed instances, unlike the tile bounds this includes the mesh extents.
+    const ezBoundingBox& GetInstanceBounds() const;
+
+    /// \brief The time from allocating the tile until all of its objects were placed.
+    ezTime GetSpawnLatency() const;
 
   private:
     PlacementTileDesc m_Desc;
@@ -41,11 +70,20 @@ namespace ezProcGenInternal
         Invalid,
         Initialized,
         Scheduled,
+        Placing,
         Finished
       };
     };
 
     State::Enum m_State;
     ezDynamicArray<ezGameObjectHandle> m_PlacedObjects;
+    ezUInt32 m_uiNextTransformIndex = 0;
+
+    ezHybridArray<InstanceBatch, 4> m_InstanceBatches;
+    ezUInt32 m_uiNumPlacedInstances = 0;
+    ezBoundingBox m_InstanceBounds;
+
+    ezTime m_AllocationTime;
+    ezTime m_SpawnLatency;
   };
 } // namespace ezProcGenInternal
@@ -5,22 +5,31 @@
 #include <Core/WorldSerializer/WorldReader.h>
 #include <Core/WorldSerializer/WorldWriter.h>
 #include <Foundation/Configuration/CVar.h>
+#include <Foundation/Math/Frustum.h>
 #include <Foundation/Profiling/Profiling.h>
+#include <Foundation/Utilities/Stats.h>
 #include <ProcGenPlugin/Components/Implementation/PlacementTile.h>
 #include <ProcGenPlugin/Components/ProcPlacementComponent.h>
 #include <ProcGenPlugin/Tasks/FindPlacementTilesTask.h>
 #include <ProcGenPlugin/Tasks/PlacementData.h>
 #include <ProcGenPlugin/Tasks/PlacementTask.h>
 #include <ProcGenPlugin/Tasks/PreparePlacementTask.h>
+#include <RendererCore/Components/RenderComponent.h>
 #include <RendererCore/Debug/DebugRenderer.h>
+#include <RendererCore/Material/MaterialResource.h>
+#include <RendererCore/Meshes/InstancedMeshComponent.h>
+#include <RendererCore/Meshes/MeshResource.h>
 #include <RendererCore/Pipeline/ExtractedRenderData.h>
+#include <RendererCore/Pipeline/InstanceDataProvider.h>
 #include <RendererCore/Pipeline/View.h>
+#include <RendererCore/RenderContext/RenderContext.h>
 #include <RendererCore/RenderWorld/RenderWorld.h>
 
 using namespace ezProcGenInternal;
 
 ezCVarInt cvar_ProcGenProcessingMaxTiles("ProcGen.Processing.MaxTiles", 8, ezCVarFlags::Default, "Maximum number of tiles in process");
 ezCVarInt cvar_ProcGenProcessingMaxNewObjectsPerFrame("ProcGen.Processing.MaxNewObjectsPerFrame", 128, ezCVarFlags::Default, "Maximum number of objects placed per frame");
+ezCVarFloat cvar_ProcGenProcessingMaxPlacementTime("ProcGen.Processing.MaxPlacementTimeMS", 2.0f, ezCVarFlags::Default, "Maximum time in milliseconds spent on placing objects per frame");
 ezCVarBool cvar_ProcGenVisTiles("ProcGen.VisTiles", false, ezCVarFlags::Default, "Enables debug visualization of procedural placement tiles");
 
 ezProcPlacementComponentManager::ezProcPlacementComponentManager(ezWorld* pWorld)
@@ -57,18 +66,27 @@ void ezProcPlacementComponentManager::Initialize()
   }
 
   ezResourceManager::GetResourceEvents().AddEventHandler(ezMakeDelegate(&ezProcPlacementComponentManager::OnResourceEvent, this));
+  ezRenderWorld::GetRenderEvent().AddEventHandler(ezMakeDelegate(&ezProcPlacementComponentManager::OnRenderEvent, this));
 }
 
 void ezProcPlacementComponentManager::Deinitialize()
 {
   ezResourceManager::GetResourceEvents().RemoveEventHandler(ezMakeDelegate(&ezProcPlacementComponentManager::OnResourceEvent, this));
+  ezRenderWorld::GetRenderEvent().RemoveEventHandler(ezMakeDelegate(&ezProcPlacementComponentManager::OnRenderEvent, this));
 
   for (auto& activeTile : m_ActiveTiles)
   {
+    ReleaseInstanceData(activeTile);
     activeTile.Deinitialize(*GetWorld());
   }
   m_ActiveTiles.Clear();
 
+  {
+    EZ_LOCK(m_InstanceDataUploadsMutex);
+    m_InstanceDataUploads.Clear();
+  }
+  m_InstanceDataPool.Clear();
+
   SUPER::Deinitialize();
 }
 
@@ -216,6 +234,7 @@ void ezProcPlacementComponentManager::PreparePlace(const ezWorldModule::UpdateCo
   {
     ezStringBuilder sb;
     sb.Format("Procedural Placement Stats:\nNum Tiles to process: {}", m_NewTiles.GetCount());
+    sb.AppendFormat("\nSpawn Latency: {}ms last, {}ms avg, {}ms max", ezArgF(m_SpawnLatencyStats.m_Last.GetMilliseconds(), 1), ezArgF(m_SpawnLatencyStats.m_Average.GetMilliseconds(), 1), ezArgF(m_SpawnLatencyStats.m_Max.GetMilliseconds(), 1));
 
     ezDebugRenderer::DrawInfoText(GetWorld(), ezDebugRenderer::ScreenPlacement::TopLeft, "ProcPlaceStats", sb, ezColor::Magenta);
 
@@ -306,6 +325,9 @@ void ezProcPlacementComponentManager::PlaceObjects(const ezWorldModule::UpdateCo
 
   m_SortedProcessingTasks.Sort([](auto& taskA, auto& taskB) { return taskA.m_uiScheduledFrame < taskB.m_uiScheduledFrame; });
 
+  const ezUInt32 uiMaxNewObjects = (ezUInt32)ezMath::Max((int)cvar_ProcGenProcessingMaxNewObjectsPerFrame, 1);
+  const ezTime endTime = ezTime::Now() + ezTime::Milliseconds(cvar_ProcGenProcessingMaxPlacementTime);
+
   ezUInt32 uiTotalNumPlacedObjects = 0;
 
   for (auto& sortedTask : m_SortedProcessingTasks)
@@ -317,9 +339,12 @@ void ezProcPlacementComponentManager::PlaceObjects(const ezWorldModule::UpdateCo
     if (task.m_pPlacementTask->IsTaskFinished())
     {
       ezUInt32 uiPlacedObjects = 0;
+      bool bTileFinished = true;
 
       ezUInt32 uiTileIndex = task.m_uiTileIndex;
       auto& activeTile = m_ActiveTiles[uiTileIndex];
+      const ezUInt32 uiPrevPlacedObjects = activeTile.GetPlacedObjects().GetCount();
+      const bool bInstanceOnly = activeTile.GetOutput()->IsInstanceOnly();
 
       auto& tileDesc = activeTile.GetDesc();
       ezProcPlacementComponent* pComponent = nullptr;
@@ -330,32 +355,71 @@ void ezProcPlacementComponentManager::PlaceObjects(const ezWorldModule::UpdateCo
         ezUInt64 uiTileKey = GetTileKey(tileDesc.m_iPosX, tileDesc.m_iPosY);
         if (auto pTile = outputContext.m_TileIndices.GetValue(uiTileKey))
         {
-          uiPlacedObjects = activeTile.PlaceObjects(*GetWorld(), task.m_pPlacementTask->GetOutputTransforms());
+          if (bInstanceOnly)
+          {
+            // instances don't create any game objects, so they are not limited by the object budget
+            bTileFinished = activeTile.PlaceInstances(task.m_pPlacementTask->GetOutputTransforms(), ezRenderComponent::GetUniqueIdForRendering(pComponent));
+
+            uiPlacedObjects = activeTile.GetNumPlacedInstances();
+            if (bTileFinished && uiPlacedObjects > 0)
+            {
+              AllocateInstanceData(activeTile);
+            }
+          }
+          else
+          {
+            // a tile may need several frames to place all of its objects, the task keeps the transforms alive until then
+            bTileFinished = activeTile.PlaceObjects(*GetWorld(), task.m_pPlacementTask->GetOutputTransforms(), endTime, uiMaxNewObjects - uiTotalNumPlacedObjects);
+
+            uiPlacedObjects = activeTile.GetPlacedObjects().GetCount();
+            uiTotalNumPlacedObjects += uiPlacedObjects - uiPrevPlacedObjects;
+          }
+
+          if (bTileFinished)
+          {
+            pTile->m_uiIndex = uiPlacedObjects > 0 ? uiTileIndex : EmptyTileIndex;
+            pTile->m_uiLastSeenFrame = ezRenderWorld::GetFrameCounter();
 
-          pTile->m_uiIndex = uiPlacedObjects > 0 ? uiTileIndex : EmptyTileIndex;
-          pTile->m_uiLastSeenFrame = ezRenderWorld::GetFrameCounter();
+            AddSpawnLatency(activeTile.GetSpawnLatency());
+          }
         }
       }
 
-      if (uiPlacedObjects == 0)
+      if (bTileFinished)
       {
-        // mark tile for re-use
-        DeallocateTile(uiTileIndex);
-      }
-
-      // mark task for re-use
-      DeallocateProcessingTask(sortedTask.m_uiTaskIndex);
+        if (uiPlacedObjects == 0)
+        {
+          // mark tile for re-use
+          DeallocateTile(uiTileIndex);
+        }
 
-      uiTotalNumPlacedObjects += uiPlacedObjects;
+        // mark task for re-use
+        DeallocateProcessingTask(sortedTask.m_uiTaskIndex);
+      }
     }
 
-    if (uiTotalNumPlacedObjects >= (ezUInt32)cvar_ProcGenProcessingMaxNewObjectsPerFrame)
+    if (uiTotalNumPlacedObjects >= uiMaxNewObjects || ezTime::Now() >= endTime)
     {
       break;
     }
   }
 }
 
+void ezProcPlacementComponentManager::AddSpawnLatency(ezTime latency)
+{
+  auto& stats = m_SpawnLatencyStats;
+
+  stats.m_Last = latency;
+  stats.m_Max = ezMath::Max(stats.m_Max, latency);
+  stats.m_Average = (stats.m_uiNumTiles == 0) ? latency : ezMath::Lerp(stats.m_Average, latency, 0.05);
+  ++stats.m_uiNumTiles;
+
+  ezStats::SetStat("ProcGen/SpawnLatency/LastMS", stats.m_Last.GetMilliseconds());
+  ezStats::SetStat("ProcGen/SpawnLatency/AverageMS", stats.m_Average.GetMilliseconds());
+  ezStats::SetStat("ProcGen/SpawnLatency/MaxMS", stats.m_Max.GetMilliseconds());
+  ezStats::SetStat("ProcGen/SpawnLatency/NumTiles", stats.m_uiNumTiles);
+}
+
 void ezProcPlacementComponentManager::DebugDrawTile(const ezProcGenInternal::PlacementTileDesc& desc, const ezColor& color, ezUInt32 uiQueueIndex)
 {
   const ezProcPlacementComponent* pComponent = nullptr;
@@ -423,6 +487,7 @@ ezUInt32 ezProcPlacementComponentManager::AllocateTile(const PlacementTileDesc&
 
 void ezProcPlacementComponentManager::DeallocateTile(ezUInt32 uiTileIndex)
 {
+  ReleaseInstanceData(m_ActiveTiles[uiTileIndex]);
   m_ActiveTiles[uiTileIndex].Deinitialize(*GetWorld());
   m_FreeTiles.PushBack(uiTileIndex);
 }
@@ -497,6 +562,7 @@ void ezProcPlacementComponentManager::RemoveTilesForComponent(ezProcPlacementCom
     auto& tileDesc = activeTile.GetDesc();
     if (tileDesc.m_hComponent == hComponent)
     {
+      // instances are gone as soon as the tile is, only game objects are deleted delayed
       if (out_bAnyObjectsRemoved != nullptr && !m_ActiveTiles[uiTileIndex].GetPlacedObjects().IsEmpty())
       {
         *out_bAnyObjectsRemoved = true;
@@ -535,6 +601,179 @@ void ezProcPlacementComponentManager::OnResourceEvent(const ezResourceEvent& res
   }
 }
 
+void ezProcPlacementComponentManager::AllocateInstanceData(PlacementTile& tile)
+{
+  const ezUInt64 uiCurrentFrame = ezRenderWorld::GetFrameCounter();
+
+  for (auto& instanceBatch : tile.GetInstanceBatches())
+  {
+    const ezUInt32 uiNumInstances = instanceBatch.m_InstanceData.GetCount();
+
+    // render data of the previous owner might still be in flight on the render thread, so released buffers are only reused one frame later
+    PooledInstanceData* pPooledData = nullptr;
+    for (auto& pooledData : m_InstanceDataPool)
+    {
+      if (!pooledData.m_bInUse && pooledData.m_uiCapacity >= uiNumInstances && pooledData.m_uiReleasedFrame + 1 < uiCurrentFrame)
+      {
+        pPooledData = &pooledData;
+        break;
+      }
+    }
+
+    if (pPooledData == nullptr)
+    {
+      const ezUInt32 uiCapacity = ezMath::Max<ezUInt32>(uiNumInstances, tile.GetOutput()->m_pPattern->m_Points.GetCount());
+
+      pPooledData = &m_InstanceDataPool.ExpandAndGetRef();
+      pPooledData->m_pInstanceData = EZ_DEFAULT_NEW(ezInstanceData, uiCapacity);
+      pPooledData->m_uiCapacity = uiCapacity;
+    }
+
+    pPooledData->m_bInUse = true;
+    instanceBatch.m_pInstanceData = pPooledData->m_pInstanceData.Borrow();
+
+    // the data is uploaded only once, the GPU buffer keeps it for as long as the tile lives
+    auto instanceData = EZ_NEW_ARRAY(ezFrameAllocator::GetCurrentAllocator(), ezPerInstanceData, uiNumInstances);
+    instanceData.CopyFrom(instanceBatch.m_InstanceData);
+
+    EZ_LOCK(m_InstanceDataUploadsMutex);
+    m_InstanceDataUploads.PushBack({instanceBatch.m_pInstanceData, instanceData});
+  }
+}
+
+void ezProcPlacementComponentManager::ReleaseInstanceData(PlacementTile& tile)
+{
+  const ezUInt64 uiCurrentFrame = ezRenderWorld::GetFrameCounter();
+
+  for (auto& instanceBatch : tile.GetInstanceBatches())
+  {
+    if (instanceBatch.m_pInstanceData == nullptr)
+      continue;
+
+    for (auto& pooledData : m_InstanceDataPool)
+    {
+      if (pooledData.m_pInstanceData.Borrow() == instanceBatch.m_pInstanceData)
+      {
+        pooledData.m_bInUse = false;
+        pooledData.m_uiReleasedFrame = uiCurrentFrame;
+        break;
+      }
+    }
+
+    instanceBatch.m_pInstanceData = nullptr;
+  }
+}
+
+void ezProcPlacementComponentManager::OnRenderEvent(const ezRenderWorldRenderEvent& e)
+{
+  if (e.m_Type != ezRenderWorldRenderEvent::Type::BeginRender)
+    return;
+
+  EZ_LOCK(m_InstanceDataUploadsMutex);
+
+  if (m_InstanceDataUploads.IsEmpty())
+    return;
+
+  ezGALDevice* pDevice = ezGALDevice::GetDefaultDevice();
+  ezGALPass* pGALPass = pDevice->BeginPass("Update Procedural Placement Instance Data");
+
+  ezRenderContext* pRenderContext = ezRenderContext::GetDefaultInstance();
+  pRenderContext->BeginCompute(pGALPass);
+
+  for (const auto& upload : m_InstanceDataUploads)
+  {
+    ezUInt32 uiOffset = 0;
+    auto instanceData = upload.m_pInstanceData->GetInstanceData(upload.m_InstanceData.GetCount(), uiOffset);
+    instanceData.CopyFrom(upload.m_InstanceData);
+
+    upload.m_pInstanceData->UpdateInstanceData(pRenderContext, instanceData.GetCount());
+  }
+
+  pRenderContext->EndCompute();
+  pDevice->EndPass(pGALPass);
+
+  m_InstanceDataUploads.Clear();
+}
+
+void ezProcPlacementComponentManager::ExtractInstances(ezMsgExtractRenderData& msg, const ezProcPlacementComponent* pComponent) const
+{
+  ezFrustum frustum;
+  msg.m_pView->ComputeCullingFrustum(frustum);
+
+  const ezUInt32 uiComponentID = ezRenderComponent::GetUniqueIdForRendering(pComponent);
+
+  for (auto& outputContext : pComponent->m_OutputContexts)
+  {
+    if (!outputContext.m_pOutput->IsInstanceOnly())
+      continue;
+
+    for (auto it = outputContext.m_TileIndices.GetIterator(); it.IsValid(); ++it)
+    {
+      const ezUInt32 uiTileIndex = it.Value().m_uiIndex;
+      if (uiTileIndex == NewTileIndex || uiTileIndex == EmptyTileIndex)
+        continue;
+
+      // cull whole tiles, the instances of a tile are always drawn together
+      const PlacementTile& tile = m_ActiveTiles[uiTileIndex];
+      if (!frustum.Overlaps(ezSimdConversion::ToBBox(tile.GetInstanceBounds())))
+        continue;
+
+      auto instanceBatches = tile.GetInstanceBatches();
+      for (ezUInt32 uiBatchIndex = 0; uiBatchIndex < instanceBatches.GetCount(); ++uiBatchIndex)
+      {
+        auto& instanceBatch = instanceBatches[uiBatchIndex];
+        if (instanceBatch.m_pInstanceData == nullptr)
+          continue;
+
+        ezResourceLock<ezMeshResource> pMesh(instanceBatch.m_hMesh, ezResourceAcquireMode::AllowLoadingFallback);
+        ezArrayPtr<const ezMeshResourceDescriptor::SubMesh> parts = pMesh->GetSubMeshes();
+
+        // every tile has its own instance buffer and thus needs its own batch
+        ezUInt32 data[] = {uiComponentID, uiTileIndex, uiBatchIndex};
+        const ezUInt32 uiBatchUniqueID = ezHashingUtils::xxHash32(data, sizeof(data));
+
+        for (ezUInt32 uiPartIndex = 0; uiPartIndex < parts.GetCount(); ++uiPartIndex)
+        {
+          const ezMaterialResourceHandle& hMaterial = pMesh->GetMaterials()[parts[uiPartIndex].m_uiMaterialIndex];
+
+          ezInstancedMeshRenderData* pRenderData = ezCreateRenderDataForThisFrame<ezInstancedMeshRenderData>(pComponent->GetOwner());
+          {
+            pRenderData->m_GlobalTransform.SetIdentity();
+            pRenderData->m_GlobalBounds = tile.GetInstanceBounds();
+            pRenderData->m_hMesh = instanceBatch.m_hMesh;
+            pRenderData->m_hMaterial = hMaterial;
+            pRenderData->m_Color = ezColor::White;
+            pRenderData->m_uiSubMeshIndex = uiPartIndex;
+            pRenderData->m_uiUniqueID = uiBatchUniqueID;
+            pRenderData->m_pExplicitInstanceData = instanceBatch.m_pInstanceData;
+            pRenderData->m_uiExplicitInstanceCount = instanceBatch.m_InstanceData.GetCount();
+
+            pRenderData->FillBatchIdAndSortingKey();
+          }
+
+          ezRenderData::Category category = ezDefaultRenderDataCategories::LitOpaque;
+          if (hMaterial.IsValid())
+          {
+            ezResourceLock<ezMaterialResource> pMaterial(hMaterial, ezResourceAcquireMode::AllowLoadingFallback);
+
+            ezTempHashedString blendModeValue = pMaterial->GetPermutationValue("BLEND_MODE");
+            if (blendModeValue == "BLEND_MODE_MASKED")
+            {
+              category = ezDefaultRenderDataCategories::LitMasked;
+            }
+            else if (blendModeValue != "BLEND_MODE_OPAQUE" && blendModeValue != "")
+            {
+              category = ezDefaultRenderDataCategories::LitTransparent;
+            }
+          }
+
+          msg.AddRenderData(pRenderData, category, ezRenderData::Caching::Never);
+        }
+      }
+    }
+  }
+}
+
 void ezProcPlacementComponentManager::AddVisibleComponent(const ezComponentHandle& hComponent, const ezVec3& cameraPosition, const ezVec3& cameraDirection) const
 {
   EZ_LOCK(m_VisibleComponentsMutex);
@@ -682,10 +921,14 @@ void ezProcPlacementComponent::OnUpdateLocalBounds(ezMsgUpdateLocalBounds& msg)
 
 void ezProcPlacementComponent::OnMsgExtractRenderData(ezMsgExtractRenderData& msg) const
 {
-  // Don't extract render data for selection or in shadow views.
+  // Don't extract render data for selection.
   if (msg.m_OverrideCategory != ezInvalidRenderDataCategory)
     return;
 
+  // instances are rendered in every view, including shadows, only placement is driven by the main views
+  auto pManager = static_cast<const ezProcPlacementComponentManager*>(GetOwningManager());
+  pManager->ExtractInstances(msg, this);
+
   if (msg.m_pView->GetCameraUsageHint() == ezCameraUsageHint::MainView || msg.m_pView->GetCameraUsageHint() == ezCameraUsageHint::EditorView)
   {
     const ezCamera* pCamera = msg.m_pView->GetCullingCamera();
@@ -695,7 +938,6 @@ void ezProcPlacementComponent::OnMsgExtractRenderData(ezMsgExtractRenderData& ms
 
     if (m_hResource.IsValid())
     {
-      auto pManager = static_cast<const ezProcPlacementComponentManager*>(GetOwningManager());
       pManager->AddVisibleComponent(GetHandle(), cameraPosition, cameraDirection);
     }
   }
@@ -49,3 +49,9 @@ void ezProcVertexColorRenderer::FillPerInstanceData(
 
   out_uiFilteredCount = uiCurrentIndex;
 }
+
+void ezProcVertexColorRenderer::FillPersistentInstanceData(ezPerInstanceData& instanceData, const ezMeshRenderData* pRenderData) const
+{
+  ezInternal::FillPerInstanceData(instanceData, pRenderData);
+  instanceData.VertexColorAccessData = static_cast<const ezProcVertexColorRenderData*>(pRenderData)->m_uiBufferAccessData;
+}
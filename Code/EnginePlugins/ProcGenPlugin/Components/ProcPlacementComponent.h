@@ -8,6 +8,9 @@
 class ezProcPlacementComponent;
 struct ezMsgUpdateLocalBounds;
 struct ezMsgExtractRenderData;
+struct ezRenderWorldRenderEvent;
+struct ezInstanceData;
+struct ezPerInstanceData;
 
 //////////////////////////////////////////////////////////////////////////
 
@@ -20,6 +23,17 @@ public:
   virtual void Initialize() override;
   virtual void Deinitialize() override;
 
+  /// \brief Time from a tile becoming active until all of its objects are placed, over all tiles placed so far.
+  struct SpawnLatencyStats
+  {
+    ezTime m_Last;
+    ezTime m_Average; ///< Exponential moving average
+    ezTime m_Max;
+    ezUInt32 m_uiNumTiles = 0;
+  };
+
+  const SpawnLatencyStats& GetSpawnLatencyStats() const { return m_SpawnLatencyStats; }
+
 private:
   friend class ezProcPlacementComponent;
 
@@ -28,6 +42,7 @@ private:
   void PlaceObjects(const ezWorldModule::UpdateContext& context);
 
   void DebugDrawTile(const ezProcGenInternal::PlacementTileDesc& desc, const ezColor& color, ezUInt32 uiQueueIndex = ezInvalidIndex);
+  void AddSpawnLatency(ezTime latency);
 
   void AddComponent(ezProcPlacementComponent* pComponent);
   void RemoveComponent(ezProcPlacementComponent* pComponent);
@@ -42,6 +57,11 @@ private:
   void RemoveTilesForComponent(ezProcPlacementComponent* pComponent, bool* out_bAnyObjectsRemoved = nullptr);
   void OnResourceEvent(const ezResourceEvent& resourceEvent);
 
+  void AllocateInstanceData(ezProcGenInternal::PlacementTile& tile);
+  void ReleaseInstanceData(ezProcGenInternal::PlacementTile& tile);
+  void OnRenderEvent(const ezRenderWorldRenderEvent& e);
+  void ExtractInstances(ezMsgExtractRenderData& msg, const ezProcPlacementComponent* pComponent) const;
+
   void AddVisibleComponent(const ezComponentHandle& hComponent, const ezVec3& cameraPosition, const ezVec3& cameraDirection) const;
   void ClearVisibleComponents();
 
@@ -92,6 +112,28 @@ private:
 
   ezDynamicArray<ezProcGenInternal::PlacementTileDesc, ezAlignedAllocatorWrapper> m_NewTiles;
   ezTaskGroupID m_UpdateTilesTaskGroupID;
+
+  SpawnLatencyStats m_SpawnLatencyStats;
+
+  // GPU buffers for the tiles of instance-only outputs. They are pooled, because tiles come and go all the time while the camera moves.
+  struct PooledInstanceData
+  {
+    ezUniquePtr<ezInstanceData> m_pInstanceData;
+    ezUInt32 m_uiCapacity = 0;
+    ezUInt64 m_uiReleasedFrame = 0;
+    bool m_bInUse = false;
+  };
+
+  ezDynamicArray<PooledInstanceData> m_InstanceDataPool;
+
+  struct InstanceDataUpload
+  {
+    ezInstanceData* m_pInstanceData = nullptr;
+    ezArrayPtr<ezPerInstanceData> m_InstanceData;
+  };
+
+  ezMutex m_InstanceDataUploadsMutex;
+  ezDynamicArray<InstanceDataUpload> m_InstanceDataUploads;
 };
 
 //////////////////////////////////////////////////////////////////////////
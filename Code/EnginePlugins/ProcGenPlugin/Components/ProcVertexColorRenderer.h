@@ -19,4 +19,5 @@ protected:
   virtual void SetAdditionalData(const ezRenderViewContext& renderViewContext, const ezMeshRenderData* pRenderData) const override;
   virtual void FillPerInstanceData(
     ezArrayPtr<ezPerInstanceData> instanceData, const ezRenderDataBatch& batch, ezUInt32 uiStartIndex, ezUInt32& out_uiFilteredCount) const override;
+  virtual void FillPersistentInstanceData(ezPerInstanceData& instanceData, const ezMeshRenderData* pRenderData) const override;
 };
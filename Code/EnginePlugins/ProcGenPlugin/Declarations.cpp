@@ -37,6 +37,10 @@ EZ_BEGIN_STATIC_REFLECTED_ENUM(ezProcPlacementMode, 1)
   EZ_ENUM_CONSTANTS(ezProcPlacementMode::Raycast, ezProcPlacementMode::Fixed)
 EZ_END_STATIC_REFLECTED_ENUM;
 
+EZ_BEGIN_STATIC_REFLECTED_ENUM(ezProcPlacementOutputMode, 1)
+  EZ_ENUM_CONSTANTS(ezProcPlacementOutputMode::Objects, ezProcPlacementOutputMode::Instances)
+EZ_END_STATIC_REFLECTED_ENUM;
+
 EZ_BEGIN_STATIC_REFLECTED_ENUM(ezProcVolumeImageMode, 1)
   EZ_ENUM_CONSTANTS(ezProcVolumeImageMode::ReferenceColor, ezProcVolumeImageMode::ChannelR, ezProcVolumeImageMode::ChannelG, ezProcVolumeImageMode::ChannelB, ezProcVolumeImageMode::ChannelA)
 EZ_END_STATIC_REFLECTED_ENUM;
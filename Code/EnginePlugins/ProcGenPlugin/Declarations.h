@@ -9,6 +9,7 @@
 
 class ezExpressionByteCode;
 using ezColorGradientResourceHandle = ezTypedResourceHandle<class ezColorGradientResource>;
+using ezMeshResourceHandle = ezTypedResourceHandle<class ezMeshResource>;
 using ezPrefabResourceHandle = ezTypedResourceHandle<class ezPrefabResource>;
 using ezSurfaceResourceHandle = ezTypedResourceHandle<class ezSurfaceResource>;
 
@@ -98,6 +99,21 @@ struct ezProcPlacementMode
 
 EZ_DECLARE_REFLECTABLE_TYPE(EZ_PROCGENPLUGIN_DLL, ezProcPlacementMode);
 
+struct ezProcPlacementOutputMode
+{
+  using StorageType = ezUInt8;
+
+  enum Enum
+  {
+    Objects,   ///< Instantiates a prefab for every placed object.
+    Instances, ///< Only stores the transforms per tile and renders them as mesh instances, no game objects are created.
+
+    Default = Objects
+  };
+};
+
+EZ_DECLARE_REFLECTABLE_TYPE(EZ_PROCGENPLUGIN_DLL, ezProcPlacementOutputMode);
+
 struct ezProcVolumeImageMode
 {
   using StorageType = ezUInt8;
@@ -166,12 +182,16 @@ namespace ezProcGenInternal
   {
     float GetTileSize() const { return m_pPattern->m_fSize * m_fFootprint; }
 
+    bool IsInstanceOnly() const { return m_OutputMode == ezProcPlacementOutputMode::Instances; }
+    ezUInt32 GetNumObjectTypes() const { return IsInstanceOnly() ? m_MeshesToPlace.GetCount() : m_ObjectsToPlace.GetCount(); }
+
     bool IsValid() const
     {
-      return !m_ObjectsToPlace.IsEmpty() && m_pPattern != nullptr && m_fFootprint > 0.0f && m_fCullDistance > 0.0f && m_pByteCode != nullptr;
+      return GetNumObjectTypes() > 0 && m_pPattern != nullptr && m_fFootprint > 0.0f && m_fCullDistance > 0.0f && m_pByteCode != nullptr;
     }
 
     ezHybridArray<ezPrefabResourceHandle, 4> m_ObjectsToPlace;
+    ezHybridArray<ezMeshResourceHandle, 4> m_MeshesToPlace;
 
     const Pattern* m_pPattern = nullptr;
     float m_fFootprint = 1.0f;
@@ -194,6 +214,8 @@ namespace ezProcGenInternal
     ezSurfaceResourceHandle m_hSurface;
 
     ezEnum<ezProcPlacementMode> m_Mode;
+
+    ezEnum<ezProcPlacementOutputMode> m_OutputMode;
   };
 
   struct VertexColorOutput : public Output
@@ -9,6 +9,7 @@
 #include <Foundation/IO/StringDeduplicationContext.h>
 #include <ProcGenPlugin/Resources/ProcGenGraphResource.h>
 #include <ProcGenPlugin/Resources/ProcGenGraphSharedData.h>
+#include <RendererCore/Meshes/MeshResource.h>
 
 namespace ezProcGenInternal
 {
@@ -177,6 +178,20 @@ ezResourceLoadDesc ezProcGenGraphResource::UpdateContent(ezStreamReader* Stream)
             chunk >> pOutput->m_Mode;
           }
 
+          if (chunk.GetCurrentChunk().m_uiChunkVersion >= 7)
+          {
+            chunk >> pOutput->m_OutputMode;
+
+            ezUInt64 uiNumMeshesToPlace = 0;
+            chunk >> uiNumMeshesToPlace;
+
+            for (ezUInt32 uiMeshIndex = 0; uiMeshIndex < static_cast<ezUInt32>(uiNumMeshesToPlace); ++uiMeshIndex)
+            {
+              chunk >> sTemp;
+              pOutput->m_MeshesToPlace.ExpandAndGetRef() = ezResourceManager::LoadResource<ezMeshResource>(sTemp);
+            }
+          }
+
           m_PlacementOutputs.PushBack(pOutput);
         }
       }
@@ -32,6 +32,9 @@ void PlacementTask::Clear()
   m_OutputTransforms.Clear();
   m_TempData.Clear();
   m_ValidPoints.Clear();
+  m_Rays.Clear();
+  m_HitResults.Clear();
+  m_Hits.Clear();
 }
 
 void PlacementTask::Execute()
@@ -65,23 +68,48 @@ void PlacementTask::FindPlacementPoints()
   ezUInt32 uiCollisionLayer = pOutput->m_uiCollisionLayer;
 
   auto& patternPoints = pOutput->m_pPattern->m_Points;
+  const ezUInt32 uiNumPatternPoints = patternPoints.GetCount();
 
-  for (ezUInt32 i = 0; i < patternPoints.GetCount(); ++i)
+  const bool bRaycast = m_pData->m_pPhysicsModule != nullptr && m_pData->m_pOutput->m_Mode == ezProcPlacementMode::Raycast;
+  if (bRaycast)
   {
-    auto& patternPoint = patternPoints[i];
-    ezSimdVec4f patternCoords = ezSimdConversion::ToVec3(patternPoint.m_Coordinates.GetAsVec3(0.0f));
+    // gather all rays first and cast them in one batch, so the physics engine only needs to set up the query once per tile
+    m_Rays.SetCountUninitialized(uiNumPatternPoints);
+    m_HitResults.SetCount(uiNumPatternPoints);
+    m_Hits.SetCountUninitialized(uiNumPatternPoints);
 
-    ezPhysicsCastResult hitResult;
-
-    if (m_pData->m_pPhysicsModule != nullptr && m_pData->m_pOutput->m_Mode == ezProcPlacementMode::Raycast)
+    for (ezUInt32 i = 0; i < uiNumPatternPoints; ++i)
     {
+      ezSimdVec4f patternCoords = ezSimdConversion::ToVec3(patternPoints[i].m_Coordinates.GetAsVec3(0.0f));
+
       ezSimdVec4f rayStart = (vXY + patternCoords * pOutput->m_fFootprint);
       rayStart += ezSimdRandom::FloatMinMax(ezSimdVec4i(i), vMinOffset, vMaxOffset, seed);
       rayStart.SetZ(fZStart);
 
-      if (!m_pData->m_pPhysicsModule->Raycast(hitResult, ezSimdConversion::ToVec3(rayStart), rayDir, fZRange, ezPhysicsQueryParameters(uiCollisionLayer, ezPhysicsShapeType::Static)))
+      ezPhysicsCastRequest& ray = m_Rays[i];
+      ray.m_vStart = ezSimdConversion::ToVec3(rayStart);
+      ray.m_vDir = rayDir;
+      ray.m_fDistance = fZRange;
+    }
+
+    // placement tasks already run in parallel per tile, no need to split the batch any further
+    m_pData->m_pPhysicsModule->RaycastBatch(m_Rays, m_HitResults, m_Hits, ezPhysicsQueryParameters(uiCollisionLayer, ezPhysicsShapeType::Static), ezPhysicsHitCollection::Closest, false);
+  }
+
+  for (ezUInt32 i = 0; i < uiNumPatternPoints; ++i)
+  {
+    auto& patternPoint = patternPoints[i];
+    ezSimdVec4f patternCoords = ezSimdConversion::ToVec3(patternPoint.m_Coordinates.GetAsVec3(0.0f));
+
+    ezPhysicsCastResult hitResult;
+
+    if (bRaycast)
+    {
+      if (!m_Hits[i])
         continue;
 
+      hitResult = m_HitResults[i];
+
       if (pOutput->m_hSurface.IsValid())
       {
         if (!hitResult.m_hSurface.IsValid())
@@ -182,7 +210,7 @@ void PlacementTask::ExecuteVM()
     }
 
     // Test density against point threshold and fill remaining input point data from expression
-    float fObjectCount = static_cast<float>(pOutput->m_ObjectsToPlace.GetCount());
+    float fObjectCount = static_cast<float>(pOutput->GetNumObjectTypes());
     const Pattern* pPattern = pOutput->m_pPattern;
     for (ezUInt32 i = 0; i < uiNumInstances; ++i)
     {
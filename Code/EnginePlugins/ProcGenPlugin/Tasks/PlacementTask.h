@@ -1,5 +1,6 @@
 #pragma once
 
+#include <Core/Interfaces/PhysicsWorldModule.h>
 #include <Foundation/CodeUtils/Expression/ExpressionVM.h>
 #include <Foundation/Threading/TaskSystem.h>
 #include <ProcGenPlugin/Declarations.h>
@@ -38,6 +39,10 @@ namespace ezProcGenInternal
     ezDynamicArray<float> m_TempData;
     ezDynamicArray<ezUInt32> m_ValidPoints;
 
+    ezDynamicArray<ezPhysicsCastRequest> m_Rays;
+    ezDynamicArray<ezPhysicsCastResult> m_HitResults;
+    ezDynamicArray<bool> m_Hits;
+
     ezExpressionVM m_VM;
   };
 } // namespace ezProcGenInternal
@@ -4,11 +4,13 @@
 #include <Core/ResourceManager/ResourceManager.h>
 #include <Core/WorldSerializer/WorldReader.h>
 #include <Core/WorldSerializer/WorldWriter.h>
+#include <Foundation/Types/ScopeExit.h>
 #include <GameEngine/Physics/CharacterControllerComponent.h>
 #include <Recast/DetourCrowd.h>
 #include <RecastPlugin/Components/RecastAgentComponent.h>
 #include <RecastPlugin/Resources/RecastNavMeshResource.h>
 #include <RecastPlugin/Utils/RcMath.h>
+#include <RecastPlugin/WorldModule/RecastCrowd.h>
 #include <RecastPlugin/WorldModule/RecastWorldModule.h>
 #include <RendererCore/Debug/DebugRenderer.h>
 
@@ -46,12 +48,31 @@ void ezRcAgentComponent::DeserializeComponent(ezWorldReader& stream)
   s >> m_fWalkSpeed;
 }
 
+void ezRcAgentComponent::OnDeactivated()
+{
+  if (m_uiCrowdAgent != ezInvalidIndex)
+  {
+    // the world module may already be gone when the world is destroyed
+    if (ezRecastWorldModule* pWorldModule = GetWorld()->GetModule<ezRecastWorldModule>())
+    {
+      pWorldModule->GetCrowd()->RemoveAgent(m_uiCrowdAgent);
+    }
+
+    m_uiCrowdAgent = ezInvalidIndex;
+    m_bPathRequested = false;
+  }
+
+  SUPER::OnDeactivated();
+}
+
 ezResult ezRcAgentComponent::InitializeRecast()
 {
   if (m_bRecastInitialized)
     return EZ_SUCCESS;
 
-  const dtNavMesh* pNavMesh = GetWorld()->GetOrCreateModule<ezRecastWorldModule>()->GetDetourNavMesh();
+  ezRecastWorldModule* pWorldModule = GetWorld()->GetOrCreateModule<ezRecastWorldModule>();
+
+  const dtNavMesh* pNavMesh = pWorldModule->GetDetourNavMesh();
   if (pNavMesh == nullptr)
     return EZ_FAILURE;
 
@@ -60,10 +81,16 @@ ezResult ezRcAgentComponent::InitializeRecast()
   m_pQuery = EZ_DEFAULT_NEW(dtNavMeshQuery);
   m_pCorridor = EZ_DEFAULT_NEW(dtPathCorridor);
 
+  // path searches are done by the crowd, this query is only used for moving along the corridor, which needs very few nodes
   /// \todo Hard-coded limits
-  m_pQuery->init(pNavMesh, 512);
+  m_pQuery->init(pNavMesh, 64);
   m_pCorridor->init(256);
 
+  if (m_uiCrowdAgent == ezInvalidIndex)
+  {
+    m_uiCrowdAgent = pWorldModule->GetCrowd()->AddAgent(GetOwner()->GetGlobalPosition(), pWorldModule->GetAgentRadius(), m_fWalkSpeed);
+  }
+
   return EZ_SUCCESS;
 }
 
@@ -84,6 +111,12 @@ void ezRcAgentComponent::UninitializeRecast()
 
 void ezRcAgentComponent::ClearTargetPosition()
 {
+  if (m_bPathRequested)
+  {
+    m_bPathRequested = false;
+    GetWorld()->GetOrCreateModule<ezRecastWorldModule>()->GetCrowd()->CancelPath(m_uiCrowdAgent);
+  }
+
   m_iNumNextSteps = 0;
   m_iFirstNextStep = 0;
   m_PathCorridor.Clear();
@@ -140,82 +173,61 @@ ezResult ezRcAgentComponent::FindNavMeshPolyAt(const ezVec3& vPosition, dtPolyRe
   return EZ_SUCCESS;
 }
 
-ezResult ezRcAgentComponent::ComputePathCorridor(dtPolyRef startPoly, dtPolyRef endPoly, bool& bFoundPartialPath)
-{
-  bFoundPartialPath = false;
-
-  ezRcPos rcStart = m_vCurrentPositionOnNavmesh;
-  ezRcPos rcEnd = m_vTargetPosition;
-
-  ezInt32 iPathCorridorLength = 0;
-
-  // make enough room
-  m_PathCorridor.SetCountUninitialized(256);
-  if (dtStatusFailed(m_pQuery->findPath(startPoly, endPoly, rcStart, rcEnd, &m_QueryFilter, m_PathCorridor.GetData(), &iPathCorridorLength, (int)m_PathCorridor.GetCount())) || iPathCorridorLength <= 0)
-  {
-    m_PathCorridor.Clear();
-    return EZ_FAILURE;
-  }
-
-  // reduce to actual length
-  m_PathCorridor.SetCountUninitialized(iPathCorridorLength);
-
-  if (m_PathCorridor[iPathCorridorLength - 1] != endPoly)
-  {
-    // if this is the case, the target position cannot be reached, but we can walk close to it
-    bFoundPartialPath = true;
-  }
-
-  m_pCorridor->reset(startPoly, rcStart);
-  m_pCorridor->setCorridor(rcEnd, m_PathCorridor.GetData(), iPathCorridorLength);
-
-  return EZ_SUCCESS;
-}
-
 ezResult ezRcAgentComponent::ComputePathToTarget()
 {
-  const ezVec3 vStartPos = GetOwner()->GetGlobalPosition();
+  ezRecastCrowd* pCrowd = GetWorld()->GetOrCreateModule<ezRecastWorldModule>()->GetCrowd();
 
-  dtPolyRef startPoly;
-  if (FindNavMeshPolyAt(vStartPos, startPoly, &m_vCurrentPositionOnNavmesh).Failed())
+  if (!m_bPathRequested)
   {
-    m_PathToTargetState = ezAgentPathFindingState::HasTargetPathFindingFailed;
-
-    ezAgentSteeringEvent e;
-    e.m_pComponent = this;
-    e.m_Type = ezAgentSteeringEvent::ErrorOutsideNavArea;
-    m_SteeringEvents.Broadcast(e);
+    // the search is done by the crowd in the world module update, within a per-frame budget
+    pCrowd->RequestPath(m_uiCrowdAgent, GetOwner()->GetGlobalPosition(), m_vTargetPosition);
+    m_bPathRequested = true;
     return EZ_FAILURE;
   }
 
-  dtPolyRef endPoly;
-  if (FindNavMeshPolyAt(m_vTargetPosition, endPoly).Failed())
-  {
-    m_PathToTargetState = ezAgentPathFindingState::HasTargetPathFindingFailed;
+  const ezRecastPathResult::Enum result = pCrowd->RetrievePathResult(m_uiCrowdAgent, m_PathCorridor, m_vCurrentPositionOnNavmesh);
 
-    ezAgentSteeringEvent e;
-    e.m_pComponent = this;
-    e.m_Type = ezAgentSteeringEvent::ErrorInvalidTargetPosition;
-    m_SteeringEvents.Broadcast(e);
+  if (result == ezRecastPathResult::Queued)
     return EZ_FAILURE;
-  }
 
-  /// \todo Optimize case when endPoly is same as previously ?
+  m_bPathRequested = false;
 
-  bool bFoundPartialPath = false;
-  if (ComputePathCorridor(startPoly, endPoly, bFoundPartialPath).Failed() || bFoundPartialPath)
+  if (result != ezRecastPathResult::Found)
   {
     m_PathToTargetState = ezAgentPathFindingState::HasTargetPathFindingFailed;
+    m_PathCorridor.Clear();
 
     /// \todo For now a partial path is considered an error
 
     ezAgentSteeringEvent e;
     e.m_pComponent = this;
-    e.m_Type = bFoundPartialPath ? ezAgentSteeringEvent::WarningNoFullPathToTarget : ezAgentSteeringEvent::ErrorNoPathToTarget;
+
+    switch (result)
+    {
+      case ezRecastPathResult::StartOutsideNavMesh:
+        e.m_Type = ezAgentSteeringEvent::ErrorOutsideNavArea;
+        break;
+      case ezRecastPathResult::TargetOutsideNavMesh:
+        e.m_Type = ezAgentSteeringEvent::ErrorInvalidTargetPosition;
+        break;
+      case ezRecastPathResult::Partial:
+        e.m_Type = ezAgentSteeringEvent::WarningNoFullPathToTarget;
+        break;
+      default:
+        e.m_Type = ezAgentSteeringEvent::ErrorNoPathToTarget;
+        break;
+    }
+
     m_SteeringEvents.Broadcast(e);
     return EZ_FAILURE;
   }
 
+  const ezRcPos rcStart = m_vCurrentPositionOnNavmesh;
+  const ezRcPos rcEnd = m_vTargetPosition;
+
+  m_pCorridor->reset(m_PathCorridor[0], rcStart);
+  m_pCorridor->setCorridor(rcEnd, m_PathCorridor.GetData(), (int)m_PathCorridor.GetCount());
+
   m_PathToTargetState = ezAgentPathFindingState::HasTargetAndValidPath;
 
   ezAgentSteeringEvent e;
@@ -361,6 +373,9 @@ void ezRcAgentComponent::Update()
   if (InitializeRecast().Failed())
     return;
 
+  // the crowd needs to know where every agent is, even if it does not move
+  EZ_SCOPE_EXIT(UpdateCrowdAgent());
+
   // visualize various things
   {
     VisualizePathCorridorPosition();
@@ -404,7 +419,34 @@ void ezRcAgentComponent::Update()
     return;
   }
 
-  ApplySteering(m_vCurrentSteeringDirection, m_fWalkSpeed);
+  // the movement is applied in ApplyCrowdSteering(), once the crowd has adjusted the direction to avoid other agents
+}
+
+void ezRcAgentComponent::UpdateCrowdAgent()
+{
+  ezVec3 vDesiredVelocity = ezVec3::ZeroVector();
+
+  if (GetPathToTargetState() == ezAgentPathFindingState::HasTargetAndValidPath)
+  {
+    vDesiredVelocity = m_vCurrentSteeringDirection * m_fWalkSpeed;
+  }
+
+  GetWorld()->GetOrCreateModule<ezRecastWorldModule>()->GetCrowd()->SetAgentState(m_uiCrowdAgent, GetOwner()->GetGlobalPosition(), vDesiredVelocity);
+}
+
+void ezRcAgentComponent::ApplyCrowdSteering()
+{
+  if (!m_bRecastInitialized || GetPathToTargetState() != ezAgentPathFindingState::HasTargetAndValidPath)
+    return;
+
+  ezVec3 vDirection = GetWorld()->GetOrCreateModule<ezRecastWorldModule>()->GetCrowd()->GetAgentVelocity(m_uiCrowdAgent);
+  vDirection.z = 0;
+  const float fSpeed = vDirection.GetLengthAndNormalize();
+
+  if (fSpeed > 0.0f)
+  {
+    ApplySteering(vDirection, fSpeed);
+  }
 
   SyncSteeringWithReality();
 }
@@ -609,4 +651,13 @@ void ezRcAgentComponentManager::Update(const ezWorldModule::UpdateContext& conte
     if (it->IsActiveAndSimulating())
       it->Update();
   }
+
+  // all agents have published their desired velocities, now they can avoid each other
+  m_pWorldModule->GetCrowd()->UpdateSteering();
+
+  for (auto it = this->m_ComponentStorage.GetIterator(context.m_uiFirstComponentIndex, context.m_uiComponentCount); it.IsValid(); ++it)
+  {
+    if (it->IsActiveAndSimulating())
+      it->ApplyCrowdSteering();
+  }
 }
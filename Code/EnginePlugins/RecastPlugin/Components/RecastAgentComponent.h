@@ -48,6 +48,7 @@ class EZ_RECASTPLUGIN_DLL ezRcAgentComponent : public ezAgentSteeringComponent
 protected:
   virtual void SerializeComponent(ezWorldWriter& stream) const override;
   virtual void DeserializeComponent(ezWorldReader& stream) override;
+  virtual void OnDeactivated() override;
 
   //////////////////////////////////////////////////////////////////////////
   // ezAgentSteeringComponent
@@ -85,11 +86,12 @@ private:
 
 private:
   ezResult ComputePathToTarget();
-  ezResult ComputePathCorridor(dtPolyRef startPoly, dtPolyRef endPoly, bool& bFoundPartialPath);
   void ComputeSteeringDirection(float fMaxDistance);
   void ApplySteering(const ezVec3& vDirection, float fSpeed);
   void SyncSteeringWithReality();
   void PlanNextSteps();
+  void UpdateCrowdAgent();
+  void ApplyCrowdSteering();
 
   ezVec3 m_vTargetPosition;
   ezEnum<ezAgentPathFindingState> m_PathToTargetState;
@@ -103,6 +105,9 @@ private:
   ezInt32 m_iNumNextSteps = 0;
   ezVec3 m_vNextSteps[16];
   ezVec3 m_vCurrentSteeringDirection;
+  // the path search and the avoidance are done by the world module's ezRecastCrowd
+  ezUInt32 m_uiCrowdAgent = ezInvalidIndex;
+  bool m_bPathRequested = false;
 
 
   //////////////////////////////////////////////////////////////////////////
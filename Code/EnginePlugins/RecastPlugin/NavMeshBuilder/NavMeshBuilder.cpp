@@ -1,6 +1,8 @@
 #include <RecastPlugin/RecastPluginPCH.h>
 
 #include <Core/World/World.h>
+#include <Foundation/Algorithm/HashingUtils.h>
+#include <Foundation/Threading/TaskSystem.h>
 #include <Foundation/Time/Stopwatch.h>
 #include <Foundation/Types/ScopeExit.h>
 #include <Foundation/Utilities/GraphicsUtils.h>
@@ -31,6 +33,7 @@ EZ_BEGIN_STATIC_REFLECTED_TYPE(ezRecastConfig, ezNoBase, 1, ezRTTIDefaultAllocat
     EZ_MEMBER_PROPERTY("SampleErrorFactor", m_fDetailMeshSampleErrorFactor)->AddAttributes(new ezDefaultValueAttribute(1.0f)),
     EZ_MEMBER_PROPERTY("MaxSimplification", m_fMaxSimplificationError)->AddAttributes(new ezDefaultValueAttribute(1.3f)),
     EZ_MEMBER_PROPERTY("MaxEdgeLength", m_fMaxEdgeLength)->AddAttributes(new ezDefaultValueAttribute(4.0f)),
+    EZ_MEMBER_PROPERTY("TileSize", m_fTileSize)->AddAttributes(new ezDefaultValueAttribute(32.0f), new ezClampValueAttribute(4.0f, ezVariant())),
   }
   EZ_END_PROPERTIES;
 }
@@ -64,6 +67,47 @@ protected:
   }
 };
 
+namespace
+{
+  enum BuildStage
+  {
+    Rasterize,
+    Filter,
+    CompactHeightfield,
+    Regions,
+    Contours,
+    PolyMesh,
+    DetourData,
+    NumStages
+  };
+
+  const char* s_szBuildStageNames[BuildStage::NumStages] = {
+    "Rasterize", "Filter Spans", "Compact Heightfield", "Build Regions", "Build Contours", "Build Poly Mesh", "Build Detour Data"};
+
+  EZ_ALWAYS_INLINE ezUInt64 GetTileKey(ezInt32 x, ezInt32 y)
+  {
+    return (static_cast<ezUInt64>(static_cast<ezUInt32>(x)) << 32) | static_cast<ezUInt32>(y);
+  }
+} // namespace
+
+struct ezRecastNavMeshBuilder::TileBuildData
+{
+  ezInt32 m_iTileX = 0;
+  ezInt32 m_iTileY = 0;
+
+  /// Vertex indices, three per triangle that overlaps the tile (including its border).
+  ezDynamicArray<ezInt32> m_TriangleIndices;
+
+  /// A matching tile from the previous build, if any.
+  ezRecastNavMeshResourceDescriptor::Tile* m_pPreviousTile = nullptr;
+
+  ezRecastNavMeshResourceDescriptor::Tile m_Result;
+  bool m_bReused = false;
+  bool m_bFailed = false;
+
+  ezTime m_StageTimes[BuildStage::NumStages];
+};
+
 ezRecastNavMeshBuilder::ezRecastNavMeshBuilder() = default;
 ezRecastNavMeshBuilder::~ezRecastNavMeshBuilder() = default;
 
@@ -72,8 +116,6 @@ void ezRecastNavMeshBuilder::Clear()
   m_BoundingBox.SetInvalid();
   m_Vertices.Clear();
   m_Triangles.Clear();
-  m_TriangleAreaIDs.Clear();
-  m_pRecastContext = nullptr;
 }
 
 ezResult ezRecastNavMeshBuilder::ExtractWorldGeometry(const ezWorld& world, ezWorldGeoExtractionUtil::MeshObjectList& out_worldGeo)
@@ -84,21 +126,20 @@ ezResult ezRecastNavMeshBuilder::ExtractWorldGeometry(const ezWorld& world, ezWo
 }
 
 ezResult ezRecastNavMeshBuilder::Build(const ezRecastConfig& config, const ezWorldGeoExtractionUtil::MeshObjectList& geo,
-  ezRecastNavMeshResourceDescriptor& out_NavMeshDesc, ezProgress& progress)
+  ezRecastNavMeshResourceDescriptor& out_NavMeshDesc, ezProgress& progress, ezRecastNavMeshResourceDescriptor* pPreviousNavMesh /*= nullptr*/)
 {
   EZ_LOG_BLOCK("ezRecastNavMeshBuilder::Build");
 
   ezProgressRange pg("Generating NavMesh", 4, true, &progress);
   pg.SetStepWeighting(0, 0.1f);
   pg.SetStepWeighting(1, 0.1f);
-  pg.SetStepWeighting(2, 0.6f);
-  pg.SetStepWeighting(3, 0.2f);
+  pg.SetStepWeighting(2, 0.7f);
+  pg.SetStepWeighting(3, 0.1f);
 
   Clear();
   out_NavMeshDesc.Clear();
 
-  ezUniquePtr<ezRcBuildContext> recastContext = EZ_DEFAULT_NEW(ezRcBuildContext);
-  m_pRecastContext = recastContext.Borrow();
+  ezStopwatch stopwatch;
 
   if (!pg.BeginNextStep("Triangulate Mesh"))
     return EZ_FAILURE;
@@ -111,25 +152,171 @@ ezResult ezRecastNavMeshBuilder::Build(const ezRecastConfig& config, const ezWor
     return EZ_SUCCESS;
   }
 
-  if (!pg.BeginNextStep("Compute AABB"))
-    return EZ_FAILURE;
-
   ComputeBoundingBox();
 
-  if (!pg.BeginNextStep("Build Poly Mesh"))
+  const ezTime tTriangulate = stopwatch.Checkpoint();
+
+  if (!pg.BeginNextStep("Assign Triangles to Tiles"))
     return EZ_FAILURE;
 
-  out_NavMeshDesc.m_pNavMeshPolygons = EZ_DEFAULT_NEW(rcPolyMesh);
+  rcConfig cfg;
+  FillOutConfig(cfg, config, m_BoundingBox);
 
-  if (BuildRecastPolyMesh(config, *out_NavMeshDesc.m_pNavMeshPolygons, progress).Failed())
-    return EZ_FAILURE;
+  // the tile grid starts at the origin, so tiles keep their coordinates when the level grows, which allows reusing them
+  const ezInt32 iTileCells = ezMath::Max((ezInt32)(config.m_fTileSize / cfg.cs), 16);
+  const float fTileSize = iTileCells * cfg.cs;
+  const float fBorderSize = (cfg.walkableRadius + 3) * cfg.cs;
 
-  if (!pg.BeginNextStep("Build NavMesh"))
-    return EZ_FAILURE;
+  out_NavMeshDesc.m_vTileOrigin.SetZero();
+  out_NavMeshDesc.m_fTileSize = fTileSize;
+
+  const ezInt32 iMinTileX = (ezInt32)ezMath::Floor((m_BoundingBox.m_vMin.x - fBorderSize) / fTileSize);
+  const ezInt32 iMinTileY = (ezInt32)ezMath::Floor((m_BoundingBox.m_vMin.z - fBorderSize) / fTileSize);
+  const ezInt32 iMaxTileX = (ezInt32)ezMath::Floor((m_BoundingBox.m_vMax.x + fBorderSize) / fTileSize);
+  const ezInt32 iMaxTileY = (ezInt32)ezMath::Floor((m_BoundingBox.m_vMax.z + fBorderSize) / fTileSize);
+  const ezUInt32 uiNumTilesX = iMaxTileX - iMinTileX + 1;
+  const ezUInt32 uiNumTilesY = iMaxTileY - iMinTileY + 1;
+
+  ezDynamicArray<TileBuildData> tiles;
+  tiles.SetCount(uiNumTilesX * uiNumTilesY);
+
+  for (ezUInt32 y = 0; y < uiNumTilesY; ++y)
+  {
+    for (ezUInt32 x = 0; x < uiNumTilesX; ++x)
+    {
+      TileBuildData& tile = tiles[y * uiNumTilesX + x];
+      tile.m_iTileX = iMinTileX + x;
+      tile.m_iTileY = iMinTileY + y;
+    }
+  }
+
+  // a triangle goes into every tile that it overlaps, including the border that each tile needs for the erosion
+  for (const Triangle& triangle : m_Triangles)
+  {
+    ezVec3 vMin = m_Vertices[triangle.m_VertexIdx[0]];
+    ezVec3 vMax = vMin;
+    for (ezUInt32 v = 1; v < 3; ++v)
+    {
+      vMin = vMin.CompMin(m_Vertices[triangle.m_VertexIdx[v]]);
+      vMax = vMax.CompMax(m_Vertices[triangle.m_VertexIdx[v]]);
+    }
 
-  if (BuildDetourNavMeshData(config, *out_NavMeshDesc.m_pNavMeshPolygons, out_NavMeshDesc.m_DetourNavmeshData).Failed())
+    const ezInt32 x0 = (ezInt32)ezMath::Floor((vMin.x - fBorderSize) / fTileSize) - iMinTileX;
+    const ezInt32 y0 = (ezInt32)ezMath::Floor((vMin.z - fBorderSize) / fTileSize) - iMinTileY;
+    const ezInt32 x1 = (ezInt32)ezMath::Floor((vMax.x + fBorderSize) / fTileSize) - iMinTileX;
+    const ezInt32 y1 = (ezInt32)ezMath::Floor((vMax.z + fBorderSize) / fTileSize) - iMinTileY;
+
+    for (ezInt32 y = ezMath::Max(y0, 0); y <= ezMath::Min(y1, (ezInt32)uiNumTilesY - 1); ++y)
+    {
+      for (ezInt32 x = ezMath::Max(x0, 0); x <= ezMath::Min(x1, (ezInt32)uiNumTilesX - 1); ++x)
+      {
+        ezDynamicArray<ezInt32>& indices = tiles[y * uiNumTilesX + x].m_TriangleIndices;
+        indices.PushBack(triangle.m_VertexIdx[0]);
+        indices.PushBack(triangle.m_VertexIdx[1]);
+        indices.PushBack(triangle.m_VertexIdx[2]);
+      }
+    }
+  }
+
+  // tiles from the previous build are only reused if they were built with the same tile grid
+  if (pPreviousNavMesh != nullptr && pPreviousNavMesh->m_fTileSize == fTileSize && pPreviousNavMesh->m_vTileOrigin.IsZero())
+  {
+    ezHashTable<ezUInt64, ezUInt32> tileIndices;
+    for (ezUInt32 i = 0; i < tiles.GetCount(); ++i)
+    {
+      tileIndices.Insert(GetTileKey(tiles[i].m_iTileX, tiles[i].m_iTileY), i);
+    }
+
+    for (auto& previousTile : pPreviousNavMesh->m_Tiles)
+    {
+      ezUInt32 uiTileIndex;
+      if (tileIndices.TryGetValue(GetTileKey(previousTile.m_iTileX, previousTile.m_iTileY), uiTileIndex))
+      {
+        tiles[uiTileIndex].m_pPreviousTile = &previousTile;
+      }
+    }
+  }
+
+  const ezTime tAssignTriangles = stopwatch.Checkpoint();
+
+  // build the tiles in batches, so that the progress bar moves and the build can be canceled
+  {
+    const ezUInt32 uiTilesPerBatch = 64;
+    const ezUInt32 uiNumBatches = (tiles.GetCount() + uiTilesPerBatch - 1) / uiTilesPerBatch;
+
+    if (!pg.BeginNextStep("Build Tiles"))
+      return EZ_FAILURE;
+
+    ezProgressRange pgTiles("Build Tiles", uiNumBatches, true, &progress);
+
+    ezParallelForParams parallelForParams;
+    parallelForParams.uiBinSize = 1;
+    parallelForParams.uiMaxTasksPerThread = 4;
+
+    for (ezUInt32 uiFirstTile = 0; uiFirstTile < tiles.GetCount(); uiFirstTile += uiTilesPerBatch)
+    {
+      if (!pgTiles.BeginNextStep("Build Tiles"))
+        return EZ_FAILURE;
+
+      const ezUInt32 uiNumTiles = ezMath::Min(uiTilesPerBatch, tiles.GetCount() - uiFirstTile);
+
+      ezTaskSystem::ParallelForIndexed(
+        uiFirstTile, uiNumTiles,
+        [&](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) {
+          for (ezUInt32 i = uiStartIndex; i < uiEndIndex; ++i)
+          {
+            BuildTile(config, fTileSize, tiles[i]);
+          }
+        },
+        "NavMesh Tiles", parallelForParams);
+    }
+  }
+
+  const ezTime tBuildTiles = stopwatch.Checkpoint();
+
+  if (!pg.BeginNextStep("Collect Tiles"))
     return EZ_FAILURE;
 
+  ezUInt32 uiNumBuiltTiles = 0;
+  ezUInt32 uiNumReusedTiles = 0;
+  ezTime stageTimes[BuildStage::NumStages];
+
+  for (TileBuildData& tile : tiles)
+  {
+    if (tile.m_bFailed)
+      return EZ_FAILURE;
+
+    if (tile.m_TriangleIndices.IsEmpty())
+      continue;
+
+    if (tile.m_bReused)
+    {
+      ++uiNumReusedTiles;
+    }
+    else
+    {
+      ++uiNumBuiltTiles;
+
+      for (ezUInt32 s = 0; s < BuildStage::NumStages; ++s)
+      {
+        stageTimes[s] += tile.m_StageTimes[s];
+      }
+    }
+
+    out_NavMeshDesc.m_Tiles.PushBack(std::move(tile.m_Result));
+  }
+
+  ezLog::Info("Navmesh: {0} tiles built, {1} unchanged tiles reused", uiNumBuiltTiles, uiNumReusedTiles);
+  ezLog::Info("Triangulate Mesh: {0}", tTriangulate);
+  ezLog::Info("Assign Triangles to Tiles: {0}", tAssignTriangles);
+  ezLog::Info("Build Tiles: {0}", tBuildTiles);
+
+  // summed up over all threads
+  for (ezUInt32 s = 0; s < BuildStage::NumStages; ++s)
+  {
+    ezLog::Info("  {0}: {1}", s_szBuildStageNames[s], stageTimes[s]);
+  }
+
   return EZ_SUCCESS;
 }
 
@@ -138,7 +325,6 @@ void ezRecastNavMeshBuilder::GenerateTriangleMeshFromDescription(const ezWorldGe
   EZ_LOG_BLOCK("ezRecastNavMeshBuilder::GenerateTriangleMesh");
 
   m_Triangles.Clear();
-  m_TriangleAreaIDs.Clear();
   m_Vertices.Clear();
 
   ezUInt32 uiVertexOffset = 0;
@@ -209,9 +395,6 @@ void ezRecastNavMeshBuilder::GenerateTriangleMeshFromDescription(const ezWorldGe
     uiVertexOffset += meshBufferDesc.GetVertexCount();
   }
 
-  // initialize the IDs to zero
-  m_TriangleAreaIDs.SetCount(m_Triangles.GetCount());
-
   ezLog::Debug("Vertices: {0}, Triangles: {1}", m_Vertices.GetCount(), m_Triangles.GetCount());
 }
 
@@ -250,69 +433,128 @@ void ezRecastNavMeshBuilder::FillOutConfig(rcConfig& cfg, const ezRecastConfig&
   rcCalcGridSize(cfg.bmin, cfg.bmax, cfg.cs, &cfg.width, &cfg.height);
 }
 
-ezResult ezRecastNavMeshBuilder::BuildRecastPolyMesh(const ezRecastConfig& config, rcPolyMesh& out_PolyMesh, ezProgress& progress)
+void ezRecastNavMeshBuilder::BuildTile(const ezRecastConfig& config, float fTileSize, TileBuildData& tile) const
 {
-  ezProgressRange pgRange("Build Poly Mesh", 13, true, &progress);
+  if (tile.m_TriangleIndices.IsEmpty())
+    return;
+
+  tile.m_Result.m_iTileX = tile.m_iTileX;
+  tile.m_Result.m_iTileY = tile.m_iTileY;
+
+  // the tile is rebuilt if the settings, the height range of the level or any of its triangles changed
+  // rcMergePolyMeshes expects all tiles to share the same vertical origin, which is why the overall height range is part of the hash
+  {
+    ezUInt64 uiHash = ezHashingUtils::xxHash64(&config, sizeof(ezRecastConfig)); // only floats, no padding
+    uiHash = ezHashingUtils::xxHash64(&m_BoundingBox.m_vMin.y, sizeof(float), uiHash);
+    uiHash = ezHashingUtils::xxHash64(&m_BoundingBox.m_vMax.y, sizeof(float), uiHash);
+
+    for (ezInt32 iVertex : tile.m_TriangleIndices)
+    {
+      uiHash = ezHashingUtils::xxHash64(&m_Vertices[iVertex], sizeof(ezVec3), uiHash);
+    }
+
+    tile.m_Result.m_uiGeometryHash = uiHash;
+  }
+
+  if (tile.m_pPreviousTile != nullptr && tile.m_pPreviousTile->m_uiGeometryHash == tile.m_Result.m_uiGeometryHash)
+  {
+    tile.m_Result = std::move(*tile.m_pPreviousTile);
+    tile.m_bReused = true;
+    return;
+  }
+
+  ezBoundingBox tileBox;
+  tileBox.m_vMin.Set(tile.m_iTileX * fTileSize, m_BoundingBox.m_vMin.y, tile.m_iTileY * fTileSize);
+  tileBox.m_vMax.Set((tile.m_iTileX + 1) * fTileSize, m_BoundingBox.m_vMax.y, (tile.m_iTileY + 1) * fTileSize);
 
   rcConfig cfg;
-  FillOutConfig(cfg, config, m_BoundingBox);
+  FillOutConfig(cfg, config, tileBox);
+
+  // the border makes sure that the erosion and the region building at the tile edges see the neighboring geometry
+  cfg.tileSize = (int)(fTileSize / cfg.cs + 0.5f);
+  cfg.borderSize = cfg.walkableRadius + 3;
+  cfg.width = cfg.tileSize + cfg.borderSize * 2;
+  cfg.height = cfg.tileSize + cfg.borderSize * 2;
+  cfg.bmin[0] -= cfg.borderSize * cfg.cs;
+  cfg.bmin[2] -= cfg.borderSize * cfg.cs;
+  cfg.bmax[0] += cfg.borderSize * cfg.cs;
+  cfg.bmax[2] += cfg.borderSize * cfg.cs;
+
+  rcPolyMesh* pPolyMesh = EZ_DEFAULT_NEW(rcPolyMesh);
+  tile.m_Result.m_pNavMeshPolygons = ezUniquePtr<rcPolyMesh>(pPolyMesh, ezFoundation::GetDefaultAllocator());
+
+  if (BuildRecastPolyMesh(config, cfg, tile, *pPolyMesh).Failed())
+  {
+    tile.m_bFailed = true;
+    return;
+  }
+
+  if (pPolyMesh->npolys == 0)
+  {
+    // nothing walkable in this tile, Detour does not accept empty tiles
+    tile.m_Result.m_pNavMeshPolygons.Clear();
+    return;
+  }
+
+  ezStopwatch stopwatch;
+
+  if (BuildDetourNavMeshData(config, *pPolyMesh, tile.m_iTileX, tile.m_iTileY, tile.m_Result.m_DetourNavmeshData).Failed())
+  {
+    tile.m_bFailed = true;
+    return;
+  }
+
+  tile.m_StageTimes[BuildStage::DetourData] = stopwatch.Checkpoint();
+}
+
+ezResult ezRecastNavMeshBuilder::BuildRecastPolyMesh(const ezRecastConfig& config, const rcConfig& cfg, TileBuildData& tile, rcPolyMesh& out_PolyMesh) const
+{
+  // tiles are built in parallel, each one gets its own context
+  ezRcBuildContext context;
+  ezRcBuildContext* pContext = &context;
+  ezStopwatch stopwatch;
 
-  ezRcBuildContext* pContext = m_pRecastContext;
   const float* pVertices = &m_Vertices[0].x;
-  const ezInt32* pTriangles = &m_Triangles[0].m_VertexIdx[0];
+  const ezInt32* pTriangles = tile.m_TriangleIndices.GetData();
+  const ezUInt32 uiNumTriangles = tile.m_TriangleIndices.GetCount() / 3;
 
   rcHeightfield* heightfield = rcAllocHeightfield();
   EZ_SCOPE_EXIT(rcFreeHeightField(heightfield));
 
-  if (!pgRange.BeginNextStep("Creating Heightfield"))
-    return EZ_FAILURE;
-
   if (!rcCreateHeightfield(pContext, *heightfield, cfg.width, cfg.height, cfg.bmin, cfg.bmax, cfg.cs, cfg.ch))
   {
     pContext->log(RC_LOG_ERROR, "Could not create solid heightfield");
     return EZ_FAILURE;
   }
 
-  if (!pgRange.BeginNextStep("Mark Walkable Area"))
-    return EZ_FAILURE;
+  // initialize the IDs to zero
+  ezDynamicArray<ezUInt8> triangleAreaIDs;
+  triangleAreaIDs.SetCount(uiNumTriangles);
 
   // TODO Instead of this, it should use area IDs and then clear the non-walkable triangles
-  rcMarkWalkableTriangles(
-    pContext, cfg.walkableSlopeAngle, pVertices, m_Vertices.GetCount(), pTriangles, m_Triangles.GetCount(), m_TriangleAreaIDs.GetData());
-
-  if (!pgRange.BeginNextStep("Rasterize Triangles"))
-    return EZ_FAILURE;
+  rcMarkWalkableTriangles(pContext, cfg.walkableSlopeAngle, pVertices, m_Vertices.GetCount(), pTriangles, uiNumTriangles, triangleAreaIDs.GetData());
 
-  if (!rcRasterizeTriangles(
-        pContext, pVertices, m_Vertices.GetCount(), pTriangles, m_TriangleAreaIDs.GetData(), m_Triangles.GetCount(), *heightfield, cfg.walkableClimb))
+  if (!rcRasterizeTriangles(pContext, pVertices, m_Vertices.GetCount(), pTriangles, triangleAreaIDs.GetData(), uiNumTriangles, *heightfield, cfg.walkableClimb))
   {
     pContext->log(RC_LOG_ERROR, "Could not rasterize triangles");
     return EZ_FAILURE;
   }
 
+  tile.m_StageTimes[BuildStage::Rasterize] = stopwatch.Checkpoint();
+
   // Optional stuff
   {
-    if (!pgRange.BeginNextStep("Filter Low Hanging Obstacles"))
-      return EZ_FAILURE;
-
     // if (m_filterLowHangingObstacles)
     rcFilterLowHangingWalkableObstacles(pContext, cfg.walkableClimb, *heightfield);
 
-    if (!pgRange.BeginNextStep("Filter Ledge Spans"))
-      return EZ_FAILURE;
-
     // if (m_filterLedgeSpans)
     rcFilterLedgeSpans(pContext, cfg.walkableHeight, cfg.walkableClimb, *heightfield);
 
-    if (!pgRange.BeginNextStep("Filter Low Height Spans"))
-      return EZ_FAILURE;
-
     // if (m_filterWalkableLowHeightSpans)
     rcFilterWalkableLowHeightSpans(pContext, cfg.walkableHeight, *heightfield);
   }
 
-  if (!pgRange.BeginNextStep("Build Compact Heightfield"))
-    return EZ_FAILURE;
+  tile.m_StageTimes[BuildStage::Filter] = stopwatch.Checkpoint();
 
   rcCompactHeightfield* compactHeightfield = rcAllocCompactHeightfield();
   EZ_SCOPE_EXIT(rcFreeCompactHeightfield(compactHeightfield));
@@ -323,15 +565,14 @@ ezResult ezRecastNavMeshBuilder::BuildRecastPolyMesh(const ezRecastConfig& confi
     return EZ_FAILURE;
   }
 
-  if (!pgRange.BeginNextStep("Erode Walkable Area"))
-    return EZ_FAILURE;
-
   if (!rcErodeWalkableArea(pContext, cfg.walkableRadius, *compactHeightfield))
   {
     pContext->log(RC_LOG_ERROR, "Could not erode with character radius");
     return EZ_FAILURE;
   }
 
+  tile.m_StageTimes[BuildStage::CompactHeightfield] = stopwatch.Checkpoint();
+
   // (Optional) Mark areas.
   //{
   //  const ConvexVolume* vols = m_geom->getConvexVolumes();
@@ -346,9 +587,6 @@ ezResult ezRecastNavMeshBuilder::BuildRecastPolyMesh(const ezRecastConfig& confi
   {
     // PARTITION_WATERSHED
     {
-      if (!pgRange.BeginNextStep("Build Distance Field"))
-        return EZ_FAILURE;
-
       // Prepare for region partitioning, by calculating distance field along the walkable surface.
       if (!rcBuildDistanceField(pContext, *compactHeightfield))
       {
@@ -356,11 +594,8 @@ ezResult ezRecastNavMeshBuilder::BuildRecastPolyMesh(const ezRecastConfig& confi
         return EZ_FAILURE;
       }
 
-      if (!pgRange.BeginNextStep("Build Regions"))
-        return EZ_FAILURE;
-
       // Partition the walkable surface into simple regions without holes.
-      if (!rcBuildRegions(pContext, *compactHeightfield, 0, cfg.minRegionArea, cfg.mergeRegionArea))
+      if (!rcBuildRegions(pContext, *compactHeightfield, cfg.borderSize, cfg.minRegionArea, cfg.mergeRegionArea))
       {
         pContext->log(RC_LOG_ERROR, "Could not build watershed regions.");
         return EZ_FAILURE;
@@ -371,7 +606,7 @@ ezResult ezRecastNavMeshBuilder::BuildRecastPolyMesh(const ezRecastConfig& confi
     //{
     //  // Partition the walkable surface into simple regions without holes.
     //  // Monotone partitioning does not need distance field.
-    //  if (!rcBuildRegionsMonotone(pContext, *compactHeightfield, 0, cfg.minRegionArea, cfg.mergeRegionArea))
+    //  if (!rcBuildRegionsMonotone(pContext, *compactHeightfield, cfg.borderSize, cfg.minRegionArea, cfg.mergeRegionArea))
     //  {
     //    pContext->log(RC_LOG_ERROR, "Could not build monotone regions.");
     //    return EZ_FAILURE;
@@ -381,7 +616,7 @@ ezResult ezRecastNavMeshBuilder::BuildRecastPolyMesh(const ezRecastConfig& confi
     //// PARTITION_LAYERS
     //{
     //  // Partition the walkable surface into simple regions without holes.
-    //  if (!rcBuildLayerRegions(pContext, *compactHeightfield, 0, cfg.minRegionArea))
+    //  if (!rcBuildLayerRegions(pContext, *compactHeightfield, cfg.borderSize, cfg.minRegionArea))
     //  {
     //    pContext->log(RC_LOG_ERROR, "Could not build layer regions.");
     //    return EZ_FAILURE;
@@ -389,8 +624,7 @@ ezResult ezRecastNavMeshBuilder::BuildRecastPolyMesh(const ezRecastConfig& confi
     //}
   }
 
-  if (!pgRange.BeginNextStep("Build Contours"))
-    return EZ_FAILURE;
+  tile.m_StageTimes[BuildStage::Regions] = stopwatch.Checkpoint();
 
   rcContourSet* contourSet = rcAllocContourSet();
   EZ_SCOPE_EXIT(rcFreeContourSet(contourSet));
@@ -401,8 +635,10 @@ ezResult ezRecastNavMeshBuilder::BuildRecastPolyMesh(const ezRecastConfig& confi
     return EZ_FAILURE;
   }
 
-  if (!pgRange.BeginNextStep("Build Poly Mesh"))
-    return EZ_FAILURE;
+  tile.m_StageTimes[BuildStage::Contours] = stopwatch.Checkpoint();
+
+  if (contourSet->nconts == 0)
+    return EZ_SUCCESS;
 
   if (!rcBuildPolyMesh(pContext, *contourSet, cfg.maxVertsPerPoly, out_PolyMesh))
   {
@@ -413,9 +649,6 @@ ezResult ezRecastNavMeshBuilder::BuildRecastPolyMesh(const ezRecastConfig& confi
   //////////////////////////////////////////////////////////////////////////
   // Detour Navmesh
 
-  if (!pgRange.BeginNextStep("Set Area Flags"))
-    return EZ_FAILURE;
-
   // TODO modify area IDs and flags
 
   for (int i = 0; i < out_PolyMesh.npolys; ++i)
@@ -426,10 +659,12 @@ ezResult ezRecastNavMeshBuilder::BuildRecastPolyMesh(const ezRecastConfig& confi
     }
   }
 
+  tile.m_StageTimes[BuildStage::PolyMesh] = stopwatch.Checkpoint();
+
   return EZ_SUCCESS;
 }
 
-ezResult ezRecastNavMeshBuilder::BuildDetourNavMeshData(const ezRecastConfig& config, const rcPolyMesh& polyMesh, ezDataBuffer& NavmeshData)
+ezResult ezRecastNavMeshBuilder::BuildDetourNavMeshData(const ezRecastConfig& config, const rcPolyMesh& polyMesh, ezInt32 iTileX, ezInt32 iTileY, ezDataBuffer& NavmeshData)
 {
   dtNavMeshCreateParams params;
   ezMemoryUtils::ZeroFill(&params, 1);
@@ -444,6 +679,8 @@ ezResult ezRecastNavMeshBuilder::BuildDetourNavMeshData(const ezRecastConfig& co
   params.walkableHeight = config.m_fAgentHeight;
   params.walkableRadius = config.m_fAgentRadius;
   params.walkableClimb = config.m_fAgentClimbHeight;
+  params.tileX = iTileX;
+  params.tileY = iTileY;
   rcVcopy(params.bmin, polyMesh.bmin);
   rcVcopy(params.bmax, polyMesh.bmax);
   params.cs = config.m_fCellSize;
@@ -468,7 +705,7 @@ ezResult ezRecastNavMeshBuilder::BuildDetourNavMeshData(const ezRecastConfig& co
 
 ezResult ezRecastConfig::Serialize(ezStreamWriter& stream) const
 {
-  stream.WriteVersion(1);
+  stream.WriteVersion(2);
 
   stream << m_fAgentHeight;
   stream << m_fAgentRadius;
@@ -482,13 +719,14 @@ ezResult ezRecastConfig::Serialize(ezStreamWriter& stream) const
   stream << m_fRegionMergeSize;
   stream << m_fDetailMeshSampleDistanceFactor;
   stream << m_fDetailMeshSampleErrorFactor;
+  stream << m_fTileSize;
 
   return EZ_SUCCESS;
 }
 
 ezResult ezRecastConfig::Deserialize(ezStreamReader& stream)
 {
-  stream.ReadVersion(1);
+  const ezTypeVersion version = stream.ReadVersion(2);
 
   stream >> m_fAgentHeight;
   stream >> m_fAgentRadius;
@@ -503,5 +741,10 @@ ezResult ezRecastConfig::Deserialize(ezStreamReader& stream)
   stream >> m_fDetailMeshSampleDistanceFactor;
   stream >> m_fDetailMeshSampleErrorFactor;
 
+  if (version >= 2)
+  {
+    stream >> m_fTileSize;
+  }
+
   return EZ_SUCCESS;
 }
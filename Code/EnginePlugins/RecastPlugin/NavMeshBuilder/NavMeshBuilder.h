@@ -30,6 +30,10 @@ struct EZ_RECASTPLUGIN_DLL ezRecastConfig
   float m_fDetailMeshSampleDistanceFactor = 1.0f;
   float m_fDetailMeshSampleErrorFactor = 1.0f;
 
+  /// \brief The navmesh is built in square tiles of this size (in world units). Tiles are built in parallel and only tiles whose geometry
+  /// changed are rebuilt.
+  float m_fTileSize = 32.0f;
+
   ezResult Serialize(ezStreamWriter& stream) const;
   ezResult Deserialize(ezStreamReader& stream);
 };
@@ -46,17 +50,24 @@ public:
 
   static ezResult ExtractWorldGeometry(const ezWorld& world, ezWorldGeoExtractionUtil::MeshObjectList& out_worldGeo);
 
+  /// \brief Builds a tiled navmesh from the given geometry.
+  ///
+  /// If \a pPreviousNavMesh is given (typically the result of the last build), tiles whose geometry and settings did not change are moved
+  /// over from it instead of being built again.
   ezResult Build(const ezRecastConfig& config, const ezWorldGeoExtractionUtil::MeshObjectList& worldGeo, ezRecastNavMeshResourceDescriptor& out_NavMeshDesc,
-    ezProgress& progress);
+    ezProgress& progress, ezRecastNavMeshResourceDescriptor* pPreviousNavMesh = nullptr);
 
 private:
+  struct TileBuildData;
+
   static void FillOutConfig(struct rcConfig& cfg, const ezRecastConfig& config, const ezBoundingBox& bbox);
 
   void Clear();
   void GenerateTriangleMeshFromDescription(const ezWorldGeoExtractionUtil::MeshObjectList& objects);
   void ComputeBoundingBox();
-  ezResult BuildRecastPolyMesh(const ezRecastConfig& config, rcPolyMesh& out_PolyMesh, ezProgress& progress);
-  static ezResult BuildDetourNavMeshData(const ezRecastConfig& config, const rcPolyMesh& polyMesh, ezDataBuffer& NavmeshData);
+  void BuildTile(const ezRecastConfig& config, float fTileSize, TileBuildData& tile) const;
+  ezResult BuildRecastPolyMesh(const ezRecastConfig& config, const struct rcConfig& cfg, TileBuildData& tile, rcPolyMesh& out_PolyMesh) const;
+  static ezResult BuildDetourNavMeshData(const ezRecastConfig& config, const rcPolyMesh& polyMesh, ezInt32 iTileX, ezInt32 iTileY, ezDataBuffer& NavmeshData);
 
   struct Triangle
   {
@@ -74,6 +85,4 @@ private:
   ezBoundingBox m_BoundingBox;
   ezDynamicArray<ezVec3> m_Vertices;
   ezDynamicArray<Triangle> m_Triangles;
-  ezDynamicArray<ezUInt8> m_TriangleAreaIDs;
-  ezRcBuildContext* m_pRecastContext = nullptr;
 };
@@ -16,46 +16,19 @@ EZ_RESOURCE_IMPLEMENT_COMMON_CODE(ezRecastNavMeshResource);
 
 //////////////////////////////////////////////////////////////////////////
 
-ezRecastNavMeshResourceDescriptor::ezRecastNavMeshResourceDescriptor() = default;
-ezRecastNavMeshResourceDescriptor::ezRecastNavMeshResourceDescriptor(ezRecastNavMeshResourceDescriptor&& rhs)
-{
-  *this = std::move(rhs);
-}
-
-ezRecastNavMeshResourceDescriptor::~ezRecastNavMeshResourceDescriptor()
+namespace
 {
-  Clear();
-}
-
-void ezRecastNavMeshResourceDescriptor::operator=(ezRecastNavMeshResourceDescriptor&& rhs)
-{
-  m_DetourNavmeshData = std::move(rhs.m_DetourNavmeshData);
-
-  m_pNavMeshPolygons = rhs.m_pNavMeshPolygons;
-  rhs.m_pNavMeshPolygons = nullptr;
-}
-
-void ezRecastNavMeshResourceDescriptor::Clear()
-{
-  m_DetourNavmeshData.Clear();
-  EZ_DEFAULT_DELETE(m_pNavMeshPolygons);
-}
-
-//////////////////////////////////////////////////////////////////////////
-
-ezResult ezRecastNavMeshResourceDescriptor::Serialize(ezStreamWriter& stream) const
-{
-  stream.WriteVersion(1);
-  EZ_SUCCEED_OR_RETURN(stream.WriteArray(m_DetourNavmeshData));
+  ezResult WritePolyMesh(ezStreamWriter& stream, const rcPolyMesh* pMesh)
+  {
+    const bool hasPolygons = pMesh != nullptr;
+    stream << hasPolygons;
 
-  const bool hasPolygons = m_pNavMeshPolygons != nullptr;
-  stream << hasPolygons;
+    if (!hasPolygons)
+      return EZ_SUCCESS;
 
-  if (hasPolygons)
-  {
     EZ_CHECK_AT_COMPILETIME_MSG(sizeof(rcPolyMesh) == sizeof(void*) * 5 + sizeof(int) * 14, "rcPolyMesh data structure has changed");
 
-    const auto& mesh = *m_pNavMeshPolygons;
+    const auto& mesh = *pMesh;
 
     stream << (int)mesh.nverts;
     stream << (int)mesh.npolys;
@@ -79,28 +52,23 @@ ezResult ezRecastNavMeshResourceDescriptor::Serialize(ezStreamWriter& stream) co
     EZ_SUCCEED_OR_RETURN(stream.WriteBytes(mesh.regs, sizeof(ezUInt16) * mesh.npolys));
     EZ_SUCCEED_OR_RETURN(stream.WriteBytes(mesh.flags, sizeof(ezUInt16) * mesh.npolys));
     EZ_SUCCEED_OR_RETURN(stream.WriteBytes(mesh.areas, sizeof(ezUInt8) * mesh.npolys));
-  }
-
-  return EZ_SUCCESS;
-}
 
-ezResult ezRecastNavMeshResourceDescriptor::Deserialize(ezStreamReader& stream)
-{
-  Clear();
+    return EZ_SUCCESS;
+  }
 
-  const ezTypeVersion version = stream.ReadVersion(1);
-  EZ_SUCCEED_OR_RETURN(stream.ReadArray(m_DetourNavmeshData));
+  ezResult ReadPolyMesh(ezStreamReader& stream, rcPolyMesh*& out_pMesh)
+  {
+    bool hasPolygons = false;
+    stream >> hasPolygons;
 
-  bool hasPolygons = false;
-  stream >> hasPolygons;
+    if (!hasPolygons)
+      return EZ_SUCCESS;
 
-  if (hasPolygons)
-  {
     EZ_CHECK_AT_COMPILETIME_MSG(sizeof(rcPolyMesh) == sizeof(void*) * 5 + sizeof(int) * 14, "rcPolyMesh data structure has changed");
 
-    m_pNavMeshPolygons = EZ_DEFAULT_NEW(rcPolyMesh);
+    out_pMesh = EZ_DEFAULT_NEW(rcPolyMesh);
 
-    auto& mesh = *m_pNavMeshPolygons;
+    auto& mesh = *out_pMesh;
 
     stream >> mesh.nverts;
     stream >> mesh.npolys;
@@ -122,6 +90,7 @@ ezResult ezRecastNavMeshResourceDescriptor::Deserialize(ezStreamReader& stream)
     mesh.verts = (ezUInt16*)rcAlloc(sizeof(ezUInt16) * mesh.nverts * 3, RC_ALLOC_PERM);
     mesh.polys = (ezUInt16*)rcAlloc(sizeof(ezUInt16) * mesh.maxpolys * mesh.nvp * 2, RC_ALLOC_PERM);
     mesh.regs = (ezUInt16*)rcAlloc(sizeof(ezUInt16) * mesh.maxpolys, RC_ALLOC_PERM);
+    mesh.flags = (ezUInt16*)rcAlloc(sizeof(ezUInt16) * mesh.maxpolys, RC_ALLOC_PERM);
     mesh.areas = (ezUInt8*)rcAlloc(sizeof(ezUInt8) * mesh.maxpolys, RC_ALLOC_PERM);
 
     stream.ReadBytes(mesh.verts, sizeof(ezUInt16) * mesh.nverts * 3);
@@ -129,6 +98,97 @@ ezResult ezRecastNavMeshResourceDescriptor::Deserialize(ezStreamReader& stream)
     stream.ReadBytes(mesh.regs, sizeof(ezUInt16) * mesh.maxpolys);
     stream.ReadBytes(mesh.flags, sizeof(ezUInt16) * mesh.maxpolys);
     stream.ReadBytes(mesh.areas, sizeof(ezUInt8) * mesh.maxpolys);
+
+    return EZ_SUCCESS;
+  }
+} // namespace
+
+ezRecastNavMeshResourceDescriptor::ezRecastNavMeshResourceDescriptor() = default;
+ezRecastNavMeshResourceDescriptor::ezRecastNavMeshResourceDescriptor(ezRecastNavMeshResourceDescriptor&& rhs)
+{
+  *this = std::move(rhs);
+}
+
+ezRecastNavMeshResourceDescriptor::~ezRecastNavMeshResourceDescriptor()
+{
+  Clear();
+}
+
+void ezRecastNavMeshResourceDescriptor::operator=(ezRecastNavMeshResourceDescriptor&& rhs)
+{
+  m_DetourNavmeshData = std::move(rhs.m_DetourNavmeshData);
+
+  m_pNavMeshPolygons = rhs.m_pNavMeshPolygons;
+  rhs.m_pNavMeshPolygons = nullptr;
+
+  m_vTileOrigin = rhs.m_vTileOrigin;
+  m_fTileSize = rhs.m_fTileSize;
+  m_Tiles = std::move(rhs.m_Tiles);
+}
+
+void ezRecastNavMeshResourceDescriptor::Clear()
+{
+  m_DetourNavmeshData.Clear();
+  EZ_DEFAULT_DELETE(m_pNavMeshPolygons);
+
+  m_vTileOrigin.SetZero();
+  m_fTileSize = 0.0f;
+  m_Tiles.Clear();
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+ezResult ezRecastNavMeshResourceDescriptor::Serialize(ezStreamWriter& stream) const
+{
+  stream.WriteVersion(2);
+  EZ_SUCCEED_OR_RETURN(stream.WriteArray(m_DetourNavmeshData));
+  EZ_SUCCEED_OR_RETURN(WritePolyMesh(stream, m_pNavMeshPolygons));
+
+  // version 2
+  stream << m_vTileOrigin;
+  stream << m_fTileSize;
+  stream << m_Tiles.GetCount();
+
+  for (const Tile& tile : m_Tiles)
+  {
+    stream << tile.m_iTileX;
+    stream << tile.m_iTileY;
+    stream << tile.m_uiGeometryHash;
+    EZ_SUCCEED_OR_RETURN(stream.WriteArray(tile.m_DetourNavmeshData));
+    EZ_SUCCEED_OR_RETURN(WritePolyMesh(stream, tile.m_pNavMeshPolygons.Borrow()));
+  }
+
+  return EZ_SUCCESS;
+}
+
+ezResult ezRecastNavMeshResourceDescriptor::Deserialize(ezStreamReader& stream)
+{
+  Clear();
+
+  const ezTypeVersion version = stream.ReadVersion(2);
+  EZ_SUCCEED_OR_RETURN(stream.ReadArray(m_DetourNavmeshData));
+  EZ_SUCCEED_OR_RETURN(ReadPolyMesh(stream, m_pNavMeshPolygons));
+
+  if (version >= 2)
+  {
+    stream >> m_vTileOrigin;
+    stream >> m_fTileSize;
+
+    ezUInt32 uiNumTiles = 0;
+    stream >> uiNumTiles;
+    m_Tiles.SetCount(uiNumTiles);
+
+    for (Tile& tile : m_Tiles)
+    {
+      stream >> tile.m_iTileX;
+      stream >> tile.m_iTileY;
+      stream >> tile.m_uiGeometryHash;
+      EZ_SUCCEED_OR_RETURN(stream.ReadArray(tile.m_DetourNavmeshData));
+
+      rcPolyMesh* pPolygons = nullptr;
+      EZ_SUCCEED_OR_RETURN(ReadPolyMesh(stream, pPolygons));
+      tile.m_pNavMeshPolygons = ezUniquePtr<rcPolyMesh>(pPolygons, ezFoundation::GetDefaultAllocator());
+    }
   }
 
   return EZ_SUCCESS;
@@ -155,8 +215,10 @@ ezResourceLoadDesc ezRecastNavMeshResource::UnloadData(Unload WhatToUnload)
   res.m_uiQualityLevelsLoadable = 0;
   res.m_State = ezResourceState::Unloaded;
 
-  m_DetourNavmeshData.Clear();
+  // the navmesh references the data, so it has to go first
   EZ_DEFAULT_DELETE(m_pNavMesh);
+  m_DetourNavmeshData.Clear();
+  m_DetourTileData.Clear();
   EZ_DEFAULT_DELETE(m_pNavMeshPolygons);
 
   return res;
@@ -195,6 +257,11 @@ void ezRecastNavMeshResource::UpdateMemoryUsage(MemoryUsage& out_NewMemoryUsage)
 {
   out_NewMemoryUsage.m_uiMemoryCPU = sizeof(ezRecastNavMeshResource);
   out_NewMemoryUsage.m_uiMemoryCPU += m_DetourNavmeshData.GetHeapMemoryUsage();
+  out_NewMemoryUsage.m_uiMemoryCPU += m_DetourTileData.GetHeapMemoryUsage();
+  for (const ezDataBuffer& tileData : m_DetourTileData)
+  {
+    out_NewMemoryUsage.m_uiMemoryCPU += tileData.GetHeapMemoryUsage();
+  }
   out_NewMemoryUsage.m_uiMemoryCPU += m_pNavMesh != nullptr ? sizeof(dtNavMesh) : 0;
   out_NewMemoryUsage.m_uiMemoryCPU += m_pNavMeshPolygons != nullptr ? sizeof(rcPolyMesh) : 0;
   out_NewMemoryUsage.m_uiMemoryGPU = 0;
@@ -220,6 +287,79 @@ ezResourceLoadDesc ezRecastNavMeshResource::CreateResource(ezRecastNavMeshResour
     const int dtMeshFlags = 0;
     m_pNavMesh->init(m_DetourNavmeshData.GetData(), m_DetourNavmeshData.GetCount(), dtMeshFlags);
   }
+  else if (!descriptor.m_Tiles.IsEmpty())
+  {
+    ezUInt32 uiMaxPolysPerTile = 1;
+    for (const auto& tile : descriptor.m_Tiles)
+    {
+      if (tile.m_pNavMeshPolygons != nullptr)
+      {
+        uiMaxPolysPerTile = ezMath::Max<ezUInt32>(uiMaxPolysPerTile, tile.m_pNavMeshPolygons->npolys);
+      }
+    }
+
+    // tile and polygon indices share the bits of a polygon reference, the rest is used for the salt
+    const ezUInt32 uiTileBits = ezMath::Log2i(ezMath::PowerOfTwo_Ceil(descriptor.m_Tiles.GetCount()));
+    const ezUInt32 uiPolyBits = ezMath::Log2i(ezMath::PowerOfTwo_Ceil(uiMaxPolysPerTile));
+
+    if (uiTileBits + uiPolyBits > 22)
+    {
+      ezLog::Error("Navmesh has too many tiles ({0}) or polygons per tile ({1}), use a smaller tile size", descriptor.m_Tiles.GetCount(), uiMaxPolysPerTile);
+    }
+    else
+    {
+      dtNavMeshParams params;
+      ezMemoryUtils::ZeroFill(&params, 1);
+      params.orig[0] = descriptor.m_vTileOrigin.x;
+      params.orig[1] = descriptor.m_vTileOrigin.y;
+      params.orig[2] = descriptor.m_vTileOrigin.z;
+      params.tileWidth = descriptor.m_fTileSize;
+      params.tileHeight = descriptor.m_fTileSize;
+      params.maxTiles = 1 << uiTileBits;
+      params.maxPolys = 1 << uiPolyBits;
+
+      m_pNavMesh = EZ_DEFAULT_NEW(dtNavMesh);
+      m_pNavMesh->init(&params);
+
+      ezHybridArray<rcPolyMesh*, 64> tilePolygons;
+      m_DetourTileData.Reserve(descriptor.m_Tiles.GetCount());
+
+      for (auto& tile : descriptor.m_Tiles)
+      {
+        if (tile.m_pNavMeshPolygons != nullptr)
+        {
+          tilePolygons.PushBack(tile.m_pNavMeshPolygons.Borrow());
+        }
+
+        if (tile.m_DetourNavmeshData.IsEmpty())
+          continue;
+
+        ezDataBuffer& tileData = m_DetourTileData.ExpandAndGetRef();
+        tileData = std::move(tile.m_DetourNavmeshData);
+
+        // the dtNavMesh does not need to free the data, the resource owns it
+        const int dtTileFlags = 0;
+        if (dtStatusFailed(m_pNavMesh->addTile(tileData.GetData(), tileData.GetCount(), dtTileFlags, 0, nullptr)))
+        {
+          ezLog::Error("Could not add navmesh tile ({0}, {1})", tile.m_iTileX, tile.m_iTileY);
+          m_DetourTileData.PopBack();
+        }
+      }
+
+      // visualization and the points of interest work on a single polygon mesh
+      if (!tilePolygons.IsEmpty() && m_pNavMeshPolygons == nullptr)
+      {
+        rcContext context(false);
+        m_pNavMeshPolygons = EZ_DEFAULT_NEW(rcPolyMesh);
+
+        if (!rcMergePolyMeshes(&context, tilePolygons.GetData(), tilePolygons.GetCount(), *m_pNavMeshPolygons))
+        {
+          ezLog::Error("Could not merge the navmesh tile polygons");
+          EZ_DEFAULT_DELETE(m_pNavMeshPolygons);
+        }
+      }
+    }
+  }
 
   return res;
 }
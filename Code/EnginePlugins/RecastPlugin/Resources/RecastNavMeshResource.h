@@ -1,6 +1,7 @@
 #pragma once
 
 #include <Core/ResourceManager/Resource.h>
+#include <Foundation/Types/UniquePtr.h>
 #include <RecastPlugin/RecastPluginDLL.h>
 
 struct rcPolyMesh;
@@ -17,12 +18,38 @@ struct EZ_RECASTPLUGIN_DLL ezRecastNavMeshResourceDescriptor
   void operator=(ezRecastNavMeshResourceDescriptor&& rhs);
   void operator=(const ezRecastNavMeshResourceDescriptor& rhs) = delete;
 
+  /// \brief One tile of a tiled navmesh.
+  struct Tile
+  {
+    ezInt32 m_iTileX = 0;
+    ezInt32 m_iTileY = 0;
+
+    /// \brief Hash over the build settings and the geometry that was used for this tile. Used to skip unchanged tiles during a rebuild.
+    ezUInt64 m_uiGeometryHash = 0;
+
+    /// \brief Data that was created by dtCreateNavMeshData() and will be used for dtNavMesh::addTile()
+    ezDataBuffer m_DetourNavmeshData;
+
+    /// \brief The polygons of this tile, they are merged into one mesh for visualization when the resource is created.
+    ezUniquePtr<rcPolyMesh> m_pNavMeshPolygons;
+  };
+
   /// \brief Data that was created by dtCreateNavMeshData() and will be used for dtNavMesh::init()
+  ///
+  /// Only used by navmeshes that were built as a single mesh, tiled navmeshes store their data in m_Tiles.
   ezDataBuffer m_DetourNavmeshData;
 
   /// \brief Optional, if available the navmesh can be visualized at runtime
   rcPolyMesh* m_pNavMeshPolygons = nullptr;
 
+  /// \brief The origin of tile (0, 0) in Recast coordinates (Y up).
+  ezVec3 m_vTileOrigin = ezVec3::ZeroVector();
+
+  /// \brief The size of a tile along X and Z in world units.
+  float m_fTileSize = 0.0f;
+
+  ezDynamicArray<Tile> m_Tiles;
+
   void Clear();
 
   ezResult Serialize(ezStreamWriter& stream) const;
@@ -48,6 +75,7 @@ private:
   virtual void UpdateMemoryUsage(MemoryUsage& out_NewMemoryUsage) override;
 
   ezDataBuffer m_DetourNavmeshData;
+  ezDynamicArray<ezDataBuffer> m_DetourTileData;
   dtNavMesh* m_pNavMesh = nullptr;
   rcPolyMesh* m_pNavMeshPolygons = nullptr;
 };
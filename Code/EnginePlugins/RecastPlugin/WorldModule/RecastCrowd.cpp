@@ -0,0 +1,402 @@
+#include <RecastPlugin/RecastPluginPCH.h>
+
+#include <Foundation/Configuration/CVar.h>
+#include <Foundation/Threading/TaskSystem.h>
+#include <Foundation/Utilities/Stats.h>
+#include <Recast/DetourNavMeshQuery.h>
+#include <RecastPlugin/Utils/RcMath.h>
+#include <RecastPlugin/WorldModule/RecastCrowd.h>
+
+ezCVarInt cvar_RecastCrowdMaxPathRequests("Recast.Crowd.MaxPathRequestsPerFrame", 16, ezCVarFlags::Default, "Maximum number of agent path searches per frame");
+ezCVarFloat cvar_RecastCrowdMaxPathTime("Recast.Crowd.MaxPathTimeMS", 1.0f, ezCVarFlags::Default, "Maximum time in milliseconds spent on agent path searches per frame");
+ezCVarFloat cvar_RecastCrowdAvoidanceRange("Recast.Crowd.AvoidanceRange", 1.0f, ezCVarFlags::Default, "Distance between two agents at which they start to steer away from each other");
+ezCVarInt cvar_RecastCrowdParallelSteering("Recast.Crowd.ParallelSteeringMinAgents", 256, ezCVarFlags::Default, "Steering runs on multiple threads once there are at least this many agents. 0 disables this.");
+
+namespace
+{
+  /// \todo Hard-coded limits
+  constexpr ezUInt32 s_uiMaxSearchNodes = 2048;
+  constexpr ezUInt32 s_uiMaxCorridorLength = 256;
+  constexpr ezUInt32 s_uiMaxNeighbors = 16;
+} // namespace
+
+ezRecastCrowd::ezRecastCrowd() = default;
+ezRecastCrowd::~ezRecastCrowd() = default;
+
+void ezRecastCrowd::SetNavMesh(const dtNavMesh* pNavMesh)
+{
+  if (m_pNavMesh == pNavMesh)
+    return;
+
+  m_pNavMesh = pNavMesh;
+  m_pQuery.Clear();
+
+  if (m_pNavMesh != nullptr)
+  {
+    m_pQuery = EZ_DEFAULT_NEW(dtNavMeshQuery);
+    m_pQuery->init(m_pNavMesh, s_uiMaxSearchNodes);
+  }
+}
+
+ezUInt32 ezRecastCrowd::AddAgent(const ezVec3& vPosition, float fRadius, float fMaxSpeed)
+{
+  ezUInt32 uiAgent;
+
+  if (!m_FreeAgents.IsEmpty())
+  {
+    uiAgent = m_FreeAgents.PeekBack();
+    m_FreeAgents.PopBack();
+  }
+  else
+  {
+    uiAgent = m_Positions.GetCount();
+
+    m_Positions.ExpandAndGetRef();
+    m_DesiredVelocities.ExpandAndGetRef();
+    m_Velocities.ExpandAndGetRef();
+    m_Radii.ExpandAndGetRef();
+    m_MaxSpeeds.ExpandAndGetRef();
+    m_IsActive.ExpandAndGetRef();
+    m_PathData.ExpandAndGetRef();
+  }
+
+  m_Positions[uiAgent] = vPosition;
+  m_DesiredVelocities[uiAgent].SetZero();
+  m_Velocities[uiAgent].SetZero();
+  m_Radii[uiAgent] = fRadius;
+  m_MaxSpeeds[uiAgent] = fMaxSpeed;
+  m_IsActive[uiAgent] = true;
+
+  ++m_uiNumActiveAgents;
+  return uiAgent;
+}
+
+void ezRecastCrowd::RemoveAgent(ezUInt32 uiAgent)
+{
+  EZ_ASSERT_DEV(m_IsActive[uiAgent], "Agent {0} was already removed", uiAgent);
+
+  CancelPath(uiAgent);
+
+  m_IsActive[uiAgent] = false;
+  m_FreeAgents.PushBack(uiAgent);
+
+  --m_uiNumActiveAgents;
+}
+
+void ezRecastCrowd::SetAgentState(ezUInt32 uiAgent, const ezVec3& vPosition, const ezVec3& vDesiredVelocity)
+{
+  m_Positions[uiAgent] = vPosition;
+  m_DesiredVelocities[uiAgent] = vDesiredVelocity;
+}
+
+void ezRecastCrowd::RequestPath(ezUInt32 uiAgent, const ezVec3& vStart, const ezVec3& vTarget)
+{
+  PathData& data = m_PathData[uiAgent];
+
+  // a request that is still in the queue is recognized as outdated by its counter
+  ++data.m_uiRequestCounter;
+  data.m_State = ezRecastPathResult::Queued;
+  data.m_Corridor.Clear();
+
+  PathRequest& request = m_PathQueue.ExpandAndGetRef();
+  request.m_uiAgent = uiAgent;
+  request.m_uiRequestCounter = data.m_uiRequestCounter;
+  request.m_RequestTime = ezTime::Now();
+  request.m_vStart = vStart;
+  request.m_vTarget = vTarget;
+}
+
+void ezRecastCrowd::CancelPath(ezUInt32 uiAgent)
+{
+  PathData& data = m_PathData[uiAgent];
+
+  ++data.m_uiRequestCounter;
+  data.m_State = ezRecastPathResult::None;
+  data.m_Corridor.Clear();
+}
+
+ezRecastPathResult::Enum ezRecastCrowd::RetrievePathResult(ezUInt32 uiAgent, ezDynamicArray<dtPolyRef>& out_Corridor, ezVec3& out_vStartOnNavMesh)
+{
+  PathData& data = m_PathData[uiAgent];
+
+  const ezRecastPathResult::Enum state = data.m_State;
+  if (state == ezRecastPathResult::None || state == ezRecastPathResult::Queued)
+    return state;
+
+  out_Corridor.Swap(data.m_Corridor);
+  out_vStartOnNavMesh = data.m_vStartOnNavMesh;
+
+  data.m_State = ezRecastPathResult::None;
+  data.m_Corridor.Clear();
+
+  return state;
+}
+
+void ezRecastCrowd::ProcessPathRequests()
+{
+  if (m_pQuery != nullptr)
+  {
+    const ezTime endTime = ezTime::Now() + ezTime::Milliseconds(cvar_RecastCrowdMaxPathTime);
+    const ezUInt32 uiMaxRequests = ezMath::Max(cvar_RecastCrowdMaxPathRequests.GetValue(), 1);
+
+    ezUInt32 uiNumProcessed = 0;
+    while (!m_PathQueue.IsEmpty() && uiNumProcessed < uiMaxRequests)
+    {
+      const PathRequest request = m_PathQueue.PeekFront();
+      m_PathQueue.PopFront();
+
+      // the agent was removed or has requested another path in the meantime
+      PathData& data = m_PathData[request.m_uiAgent];
+      if (!m_IsActive[request.m_uiAgent] || data.m_uiRequestCounter != request.m_uiRequestCounter)
+        continue;
+
+      ProcessPathRequest(request, data);
+      ++uiNumProcessed;
+
+      AddPathLatency(ezTime::Now() - request.m_RequestTime);
+
+      if (ezTime::Now() >= endTime)
+        break;
+    }
+  }
+
+  ezStats::SetStat("Recast/Crowd/PathQueueDepth", m_PathQueue.GetCount());
+  ezStats::SetStat("Recast/Crowd/NumAgents", m_uiNumActiveAgents);
+}
+
+void ezRecastCrowd::ProcessPathRequest(const PathRequest& request, PathData& data)
+{
+  data.m_Corridor.Clear();
+
+  dtPolyRef startPoly;
+  if (FindNavMeshPolyAt(request.m_vStart, startPoly, &data.m_vStartOnNavMesh).Failed())
+  {
+    data.m_State = ezRecastPathResult::StartOutsideNavMesh;
+    return;
+  }
+
+  dtPolyRef endPoly;
+  if (FindNavMeshPolyAt(request.m_vTarget, endPoly).Failed())
+  {
+    data.m_State = ezRecastPathResult::TargetOutsideNavMesh;
+    return;
+  }
+
+  ezRcPos rcStart = data.m_vStartOnNavMesh;
+  ezRcPos rcEnd = request.m_vTarget;
+
+  dtQueryFilter filter; /// \todo Hard-coded filter
+
+  ezInt32 iPathCorridorLength = 0;
+
+  // make enough room
+  data.m_Corridor.SetCountUninitialized(s_uiMaxCorridorLength);
+  if (dtStatusFailed(m_pQuery->findPath(startPoly, endPoly, rcStart, rcEnd, &filter, data.m_Corridor.GetData(), &iPathCorridorLength, (int)data.m_Corridor.GetCount())) || iPathCorridorLength <= 0)
+  {
+    data.m_Corridor.Clear();
+    data.m_State = ezRecastPathResult::NoPath;
+    return;
+  }
+
+  // reduce to actual length
+  data.m_Corridor.SetCountUninitialized(iPathCorridorLength);
+
+  // if the last polygon is not the target, the target position cannot be reached, but we can walk close to it
+  data.m_State = (data.m_Corridor.PeekBack() == endPoly) ? ezRecastPathResult::Found : ezRecastPathResult::Partial;
+}
+
+ezResult ezRecastCrowd::FindNavMeshPolyAt(const ezVec3& vPosition, dtPolyRef& out_PolyRef, ezVec3* out_vAdjustedPosition /*= nullptr*/) const
+{
+  const float fPlaneEpsilon = 0.01f;
+  const float fHeightEpsilon = 1.0f;
+
+  ezRcPos rcPos = vPosition;
+  ezVec3 vSize(fPlaneEpsilon, fHeightEpsilon, fPlaneEpsilon);
+
+  ezRcPos resultPos;
+  dtQueryFilter filter; /// \todo Hard-coded filter
+  if (dtStatusFailed(m_pQuery->findNearestPoly(rcPos, &vSize.x, &filter, &out_PolyRef, resultPos)))
+    return EZ_FAILURE;
+
+  if (!ezMath::IsEqual(vPosition.x, resultPos.m_Pos[0], fPlaneEpsilon) || !ezMath::IsEqual(vPosition.y, resultPos.m_Pos[2], fPlaneEpsilon) || !ezMath::IsEqual(vPosition.z, resultPos.m_Pos[1], fHeightEpsilon))
+    return EZ_FAILURE;
+
+  if (out_vAdjustedPosition != nullptr)
+  {
+    *out_vAdjustedPosition = resultPos;
+  }
+
+  return EZ_SUCCESS;
+}
+
+void ezRecastCrowd::AddPathLatency(ezTime latency)
+{
+  auto& stats = m_PathLatencyStats;
+
+  stats.m_Last = latency;
+  stats.m_Max = ezMath::Max(stats.m_Max, latency);
+  stats.m_Average = (stats.m_uiNumPaths == 0) ? latency : ezMath::Lerp(stats.m_Average, latency, 0.05);
+  ++stats.m_uiNumPaths;
+
+  ezStats::SetStat("Recast/Crowd/PathLatency/LastMS", stats.m_Last.GetMilliseconds());
+  ezStats::SetStat("Recast/Crowd/PathLatency/AverageMS", stats.m_Average.GetMilliseconds());
+  ezStats::SetStat("Recast/Crowd/PathLatency/MaxMS", stats.m_Max.GetMilliseconds());
+  ezStats::SetStat("Recast/Crowd/PathLatency/NumPaths", stats.m_uiNumPaths);
+}
+
+void ezRecastCrowd::UpdateSteering()
+{
+  if (m_uiNumActiveAgents == 0)
+    return;
+
+  UpdateSpatialGrid();
+
+  const ezUInt32 uiNumAgents = m_Positions.GetCount();
+  const ezUInt32 uiMinParallelAgents = cvar_RecastCrowdParallelSteering;
+
+  if (uiMinParallelAgents == 0 || m_uiNumActiveAgents < uiMinParallelAgents)
+  {
+    ComputeVelocities(0, uiNumAgents);
+    return;
+  }
+
+  ezParallelForParams params;
+  params.uiBinSize = 64;
+
+  ezTaskSystem::ParallelForIndexed(
+    0, uiNumAgents, [this](ezUInt32 uiStartAgent, ezUInt32 uiEndAgent) { ComputeVelocities(uiStartAgent, uiEndAgent); }, "Recast Crowd Steering", params);
+}
+
+ezUInt64 ezRecastCrowd::GetGridCell(const ezVec3& vPosition) const
+{
+  const ezInt32 x = (ezInt32)ezMath::Floor(vPosition.x / m_fGridCellSize);
+  const ezInt32 y = (ezInt32)ezMath::Floor(vPosition.y / m_fGridCellSize);
+
+  return (static_cast<ezUInt64>(static_cast<ezUInt32>(x)) << 32) | static_cast<ezUInt32>(y);
+}
+
+void ezRecastCrowd::UpdateSpatialGrid()
+{
+  float fMaxRadius = 0.0f;
+  for (ezUInt32 i = 0; i < m_Radii.GetCount(); ++i)
+  {
+    if (m_IsActive[i])
+    {
+      fMaxRadius = ezMath::Max(fMaxRadius, m_Radii[i]);
+    }
+  }
+
+  // with this cell size all agents that can influence each other are at most one cell apart
+  m_fGridCellSize = ezMath::Max(2.0f * fMaxRadius + cvar_RecastCrowdAvoidanceRange, 0.1f);
+
+  m_GridEntries.Clear();
+  m_GridCellStart.Clear();
+
+  for (ezUInt32 i = 0; i < m_Positions.GetCount(); ++i)
+  {
+    if (!m_IsActive[i])
+      continue;
+
+    GridEntry& entry = m_GridEntries.ExpandAndGetRef();
+    entry.m_uiCell = GetGridCell(m_Positions[i]);
+    entry.m_uiAgent = i;
+  }
+
+  m_GridEntries.Sort();
+
+  for (ezUInt32 i = 0; i < m_GridEntries.GetCount(); ++i)
+  {
+    if (i == 0 || m_GridEntries[i - 1].m_uiCell != m_GridEntries[i].m_uiCell)
+    {
+      m_GridCellStart.Insert(m_GridEntries[i].m_uiCell, i);
+    }
+  }
+}
+
+void ezRecastCrowd::ComputeVelocities(ezUInt32 uiStartAgent, ezUInt32 uiEndAgent)
+{
+  const float fAvoidanceRange = ezMath::Max(cvar_RecastCrowdAvoidanceRange.GetValue(), 0.01f);
+
+  for (ezUInt32 i = uiStartAgent; i < uiEndAgent; ++i)
+  {
+    if (!m_IsActive[i])
+      continue;
+
+    const ezVec3 vDesiredVelocity = m_DesiredVelocities[i];
+
+    // agents that stand still are not pushed around
+    if (vDesiredVelocity.IsZero())
+    {
+      m_Velocities[i].SetZero();
+      continue;
+    }
+
+    const ezVec3 vPosition = m_Positions[i];
+    const float fRadius = m_Radii[i];
+
+    ezVec3 vSeparation = ezVec3::ZeroVector();
+    ezUInt32 uiNumNeighbors = 0;
+
+    const ezInt32 iCellX = (ezInt32)ezMath::Floor(vPosition.x / m_fGridCellSize);
+    const ezInt32 iCellY = (ezInt32)ezMath::Floor(vPosition.y / m_fGridCellSize);
+
+    for (ezInt32 y = iCellY - 1; y <= iCellY + 1 && uiNumNeighbors < s_uiMaxNeighbors; ++y)
+    {
+      for (ezInt32 x = iCellX - 1; x <= iCellX + 1 && uiNumNeighbors < s_uiMaxNeighbors; ++x)
+      {
+        const ezUInt64 uiCell = (static_cast<ezUInt64>(static_cast<ezUInt32>(x)) << 32) | static_cast<ezUInt32>(y);
+
+        ezUInt32 uiEntry;
+        if (!m_GridCellStart.TryGetValue(uiCell, uiEntry))
+          continue;
+
+        for (; uiEntry < m_GridEntries.GetCount() && m_GridEntries[uiEntry].m_uiCell == uiCell; ++uiEntry)
+        {
+          const ezUInt32 uiOther = m_GridEntries[uiEntry].m_uiAgent;
+          if (uiOther == i)
+            continue;
+
+          ezVec3 vDiff = vPosition - m_Positions[uiOther];
+          vDiff.z = 0.0f;
+
+          const float fMinDist = fRadius + m_Radii[uiOther];
+          const float fDist = vDiff.GetLength();
+
+          if (fDist >= fMinDist + fAvoidanceRange)
+            continue;
+
+          // agents at the same spot need some deterministic direction to separate
+          if (fDist < 0.001f)
+          {
+            vDiff.Set(i < uiOther ? 1.0f : -1.0f, 0.0f, 0.0f);
+          }
+          else
+          {
+            vDiff /= fDist;
+          }
+
+          // goes from 0 at the edge of the avoidance range to 1 when the agents touch
+          const float fWeight = ezMath::Clamp((fMinDist + fAvoidanceRange - fDist) / fAvoidanceRange, 0.0f, 1.0f);
+          vSeparation += vDiff * (fWeight * fWeight);
+
+          if (++uiNumNeighbors >= s_uiMaxNeighbors)
+            break;
+        }
+      }
+    }
+
+    const float fMaxSpeed = m_MaxSpeeds[i];
+    ezVec3 vVelocity = vDesiredVelocity + vSeparation * fMaxSpeed;
+    vVelocity.z = vDesiredVelocity.z;
+
+    const float fSpeed = vVelocity.GetLength();
+    if (fSpeed > fMaxSpeed)
+    {
+      vVelocity *= fMaxSpeed / fSpeed;
+    }
+
+    m_Velocities[i] = vVelocity;
+  }
+}
+
+EZ_STATICLINK_FILE(RecastPlugin, RecastPlugin_WorldModule_RecastCrowd);
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <Foundation/Containers/Deque.h>
+#include <Foundation/Containers/DynamicArray.h>
+#include <Foundation/Containers/HashTable.h>
+#include <Foundation/Time/Time.h>
+#include <Foundation/Types/UniquePtr.h>
+#include <Recast/DetourNavMesh.h>
+#include <RecastPlugin/RecastPluginDLL.h>
+
+class dtNavMeshQuery;
+
+/// \brief The outcome of a path request that was queued with ezRecastCrowd::RequestPath().
+struct ezRecastPathResult
+{
+  enum Enum
+  {
+    None,                  ///< No path was requested, or the result was already retrieved.
+    Queued,                ///< The request waits in the queue.
+    Found,                 ///< The target can be reached.
+    Partial,               ///< The target cannot be reached, the path leads as close as possible.
+    NoPath,                ///< No path was found at all.
+    StartOutsideNavMesh,   ///< The start position is not on the navmesh.
+    TargetOutsideNavMesh,  ///< The target position is not on the navmesh.
+  };
+};
+
+/// \brief Manages all navmesh agents of a world, so that their path searches and steering can be batched.
+///
+/// Path requests are queued and worked off in ezRecastWorldModule's update, with a per-frame budget
+/// (see the cvars Recast.Crowd.MaxPathRequestsPerFrame and Recast.Crowd.MaxPathTimeMS). All searches share one navmesh query,
+/// instead of every agent owning a query with a large node pool.
+///
+/// The steering data of all agents is stored as separate arrays. UpdateSteering() adds local avoidance to the desired velocities of all
+/// agents in parallel, looking up close agents through a spatial grid.
+///
+/// Queue depth and path latency are published as stats under "Recast/Crowd".
+class EZ_RECASTPLUGIN_DLL ezRecastCrowd
+{
+  EZ_DISALLOW_COPY_AND_ASSIGN(ezRecastCrowd);
+
+public:
+  ezRecastCrowd();
+  ~ezRecastCrowd();
+
+  /// \brief Sets the navmesh that path searches are done on. Queued requests are kept.
+  void SetNavMesh(const dtNavMesh* pNavMesh);
+  const dtNavMesh* GetNavMesh() const { return m_pNavMesh; }
+
+  /// \brief Adds an agent and returns its index, which stays valid until RemoveAgent() is called.
+  ezUInt32 AddAgent(const ezVec3& vPosition, float fRadius, float fMaxSpeed);
+  void RemoveAgent(ezUInt32 uiAgent);
+
+  /// \brief Updates where the agent currently is and where it wants to go. Both are used for the avoidance in the next UpdateSteering().
+  void SetAgentState(ezUInt32 uiAgent, const ezVec3& vPosition, const ezVec3& vDesiredVelocity);
+
+  /// \brief Returns the velocity that UpdateSteering() computed from the desired velocity, taking nearby agents into account.
+  const ezVec3& GetAgentVelocity(ezUInt32 uiAgent) const { return m_Velocities[uiAgent]; }
+
+  /// \brief Queues a path search for the given agent. A previous request of the same agent is discarded.
+  void RequestPath(ezUInt32 uiAgent, const ezVec3& vStart, const ezVec3& vTarget);
+
+  /// \brief Discards a queued request or a result that was not retrieved yet.
+  void CancelPath(ezUInt32 uiAgent);
+
+  /// \brief Returns the state of the agent's last path request.
+  ///
+  /// Once the request was processed, the polygon corridor and the start position on the navmesh are moved into the out parameters
+  /// and the state of the agent goes back to None.
+  ezRecastPathResult::Enum RetrievePathResult(ezUInt32 uiAgent, ezDynamicArray<dtPolyRef>& out_Corridor, ezVec3& out_vStartOnNavMesh);
+
+  /// \brief Works off the queued path requests until the per-frame budget is used up.
+  void ProcessPathRequests();
+
+  /// \brief Computes the velocities of all agents. Runs on multiple threads if there are enough agents.
+  void UpdateSteering();
+
+  ezUInt32 GetNumQueuedPathRequests() const { return m_PathQueue.GetCount(); }
+
+private:
+  struct PathRequest
+  {
+    ezUInt32 m_uiAgent;
+    ezUInt32 m_uiRequestCounter;
+    ezTime m_RequestTime;
+    ezVec3 m_vStart;
+    ezVec3 m_vTarget;
+  };
+
+  struct PathData
+  {
+    ezUInt32 m_uiRequestCounter = 0;
+    ezRecastPathResult::Enum m_State = ezRecastPathResult::None;
+    ezVec3 m_vStartOnNavMesh;
+    ezDynamicArray<dtPolyRef> m_Corridor;
+  };
+
+  struct GridEntry
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezUInt64 m_uiCell;
+    ezUInt32 m_uiAgent;
+
+    bool operator<(const GridEntry& other) const { return m_uiCell < other.m_uiCell; }
+  };
+
+  void ProcessPathRequest(const PathRequest& request, PathData& data);
+  ezResult FindNavMeshPolyAt(const ezVec3& vPosition, dtPolyRef& out_PolyRef, ezVec3* out_vAdjustedPosition = nullptr) const;
+  void UpdateSpatialGrid();
+  void ComputeVelocities(ezUInt32 uiStartAgent, ezUInt32 uiEndAgent);
+  ezUInt64 GetGridCell(const ezVec3& vPosition) const;
+  void AddPathLatency(ezTime latency);
+
+  const dtNavMesh* m_pNavMesh = nullptr;
+  ezUniquePtr<dtNavMeshQuery> m_pQuery;
+  ezDeque<PathRequest> m_PathQueue;
+
+  // per agent data, indexed by the agent index
+  ezDynamicArray<ezVec3> m_Positions;
+  ezDynamicArray<ezVec3> m_DesiredVelocities;
+  ezDynamicArray<ezVec3> m_Velocities;
+  ezDynamicArray<float> m_Radii;
+  ezDynamicArray<float> m_MaxSpeeds;
+  ezDynamicArray<bool> m_IsActive;
+  ezDynamicArray<PathData> m_PathData;
+  ezDynamicArray<ezUInt32> m_FreeAgents;
+  ezUInt32 m_uiNumActiveAgents = 0;
+
+  // spatial grid, rebuilt by every UpdateSteering()
+  float m_fGridCellSize = 1.0f;
+  ezDynamicArray<GridEntry> m_GridEntries;
+  ezHashTable<ezUInt64, ezUInt32> m_GridCellStart;
+
+  struct LatencyStats
+  {
+    ezTime m_Last;
+    ezTime m_Average;
+    ezTime m_Max;
+    ezUInt32 m_uiNumPaths = 0;
+  };
+
+  LatencyStats m_PathLatencyStats;
+};
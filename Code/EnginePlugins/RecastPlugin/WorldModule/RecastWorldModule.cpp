@@ -2,7 +2,9 @@
 
 #include <Core/World/World.h>
 #include <Recast/DetourCrowd.h>
+#include <Recast/DetourNavMesh.h>
 #include <RecastPlugin/Resources/RecastNavMeshResource.h>
+#include <RecastPlugin/WorldModule/RecastCrowd.h>
 #include <RecastPlugin/WorldModule/RecastWorldModule.h>
 
 // clang-format off
@@ -14,6 +16,7 @@ EZ_END_DYNAMIC_REFLECTED_TYPE;
 ezRecastWorldModule::ezRecastWorldModule(ezWorld* pWorld)
   : ezWorldModule(pWorld)
 {
+  m_pCrowd = EZ_DEFAULT_NEW(ezRecastCrowd);
 }
 
 ezRecastWorldModule::~ezRecastWorldModule() = default;
@@ -61,6 +64,17 @@ void ezRecastWorldModule::UpdateNavMesh(const UpdateContext& ctxt)
 
     if (m_pDetourNavMesh)
     {
+      // all tiles are built with the same config
+      for (int i = 0; i < m_pDetourNavMesh->getMaxTiles(); ++i)
+      {
+        const dtMeshTile* pTile = m_pDetourNavMesh->getTile(i);
+        if (pTile->header != nullptr)
+        {
+          m_fAgentRadius = pTile->header->walkableRadius;
+          break;
+        }
+      }
+
       m_pNavMeshPointsOfInterest = EZ_DEFAULT_NEW(ezNavMeshPointOfInterestGraph);
       m_pNavMeshPointsOfInterest->ExtractInterestPointsFromMesh(*pNavMesh->GetNavMeshPolygons());
     }
@@ -70,6 +84,10 @@ void ezRecastWorldModule::UpdateNavMesh(const UpdateContext& ctxt)
   {
     m_pNavMeshPointsOfInterest->IncreaseCheckVisibiblityTimeStamp(GetWorld()->GetClock().GetAccumulatedTime());
   }
+
+  // the results are picked up by the agents in their next update
+  m_pCrowd->SetNavMesh(m_pDetourNavMesh);
+  m_pCrowd->ProcessPathRequests();
 }
 
 void ezRecastWorldModule::ResourceEventHandler(const ezResourceEvent& e)
@@ -8,6 +8,7 @@
 
 class dtCrowd;
 class dtNavMesh;
+class ezRecastCrowd;
 struct ezResourceEvent;
 
 using ezRecastNavMeshResourceHandle = ezTypedResourceHandle<class ezRecastNavMeshResource>;
@@ -28,14 +29,22 @@ public:
   const ezRecastNavMeshResourceHandle& GetNavMeshResource() { return m_hNavMesh; }
 
   const dtNavMesh* GetDetourNavMesh() const { return m_pDetourNavMesh; }
+
+  /// \brief The agent radius that the current navmesh was built with, see ezRecastConfig::m_fAgentRadius.
+  float GetAgentRadius() const { return m_fAgentRadius; }
   const ezNavMeshPointOfInterestGraph* GetNavMeshPointsOfInterestGraph() const { return m_pNavMeshPointsOfInterest.Borrow(); }
   ezNavMeshPointOfInterestGraph* AccessNavMeshPointsOfInterestGraph() const { return m_pNavMeshPointsOfInterest.Borrow(); }
 
+  /// \brief Batches the path searches and the steering of all agents in this world.
+  ezRecastCrowd* GetCrowd() const { return m_pCrowd.Borrow(); }
+
 private:
   void UpdateNavMesh(const UpdateContext& ctxt);
   void ResourceEventHandler(const ezResourceEvent& e);
 
   const dtNavMesh* m_pDetourNavMesh = nullptr;
+  float m_fAgentRadius = 0.3f; // taken from the navmesh once it is loaded
   ezRecastNavMeshResourceHandle m_hNavMesh;
   ezUniquePtr<ezNavMeshPointOfInterestGraph> m_pNavMeshPointsOfInterest;
+  ezUniquePtr<ezRecastCrowd> m_pCrowd;
 };
@@ -2,7 +2,9 @@
 #include <Foundation/IO/FileSystem/FileReader.h>
 #include <Foundation/IO/OSFile.h>
 #include <Foundation/Logging/Log.h>
+#include <Foundation/Threading/TaskSystem.h>
 #include <Foundation/Utilities/CommandLineOptions.h>
+#include <RendererCore/Shader/ShaderStagePack.h>
 #include <RendererCore/ShaderCompiler/ShaderCompiler.h>
 #include <RendererCore/ShaderCompiler/ShaderManager.h>
 #include <RendererCore/ShaderCompiler/ShaderParser.h>
@@ -30,6 +32,11 @@ Examples:\n\
 
 ezCommandLineOptionBool opt_IgnoreErrors("_ShaderCompiler", "-IgnoreErrors", "If set, a compile error won't stop other shaders from being compiled.", false);
 
+ezCommandLineOptionBool opt_Pack("_ShaderCompiler", "-pack", "\
+If set, all shader stage binaries of the platform are written into a single pack file after compilation.\n\
+The pack is memory mapped at runtime and stores identical byte code only once.",
+  false);
+
 ezCommandLineOptionDoc opt_Perm("_ShaderCompiler", "-perm", "<string list>", "List of permutation variables to set to fixed values.\n\
 Spaces are used to separate multiple arguments, therefore each argument mustn't use spaces.\n\
 In the form of 'SOME_VAR=VALUE'\n\
@@ -77,6 +84,8 @@ ezResult ezShaderCompilerApplication::BeforeCoreSystemsStartup()
 
   m_bIgnoreErrors = opt_IgnoreErrors.GetOptionValue(ezCommandLineOption::LogMode::Always);
 
+  m_bWritePack = opt_Pack.GetOptionValue(ezCommandLineOption::LogMode::Always);
+
   const ezUInt32 pvs = cmd->GetStringOptionArguments("-perm");
 
   for (ezUInt32 pv = 0; pv < pvs; ++pv)
@@ -132,21 +141,34 @@ ezResult ezShaderCompilerApplication::CompileShader(const char* szShaderFile)
   if (ExtractPermutationVarValues(szShaderFile).Failed())
     return EZ_FAILURE;
 
-  ezHybridArray<ezPermutationVar, 16> PermVars;
-
   const ezUInt32 uiMaxPerms = m_PermutationGenerator.GetPermutationCount();
 
   ezLog::Info("Shader has {0} permutations", uiMaxPerms);
 
-  for (ezUInt32 perm = 0; perm < uiMaxPerms; ++perm)
-  {
-    EZ_LOG_BLOCK("Compiling Permutation");
+  // Every permutation uses its own ezShaderCompiler, stage binaries with the same source are shared through ezShaderStageBinary.
+  ezAtomicBool bFailed;
 
-    m_PermutationGenerator.GetPermutation(perm, PermVars);
-    ezShaderCompiler sc;
-    if (sc.CompileShaderPermutationForPlatforms(szShaderFile, PermVars, ezLog::GetThreadLocalLogSystem(), m_sPlatforms).Failed())
-      return EZ_FAILURE;
-  }
+  ezTaskSystem::ParallelForIndexed(
+    0, uiMaxPerms,
+    [&](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) {
+      ezHybridArray<ezPermutationVar, 16> PermVars;
+
+      for (ezUInt32 perm = uiStartIndex; perm < uiEndIndex && !bFailed; ++perm)
+      {
+        EZ_LOG_BLOCK("Compiling Permutation");
+
+        m_PermutationGenerator.GetPermutation(perm, PermVars);
+        ezShaderCompiler sc;
+        if (sc.CompileShaderPermutationForPlatforms(szShaderFile, PermVars, ezLog::GetThreadLocalLogSystem(), m_sPlatforms).Failed())
+        {
+          bFailed = true;
+        }
+      }
+    },
+    "CompileShaderPermutations");
+
+  if (bFailed)
+    return EZ_FAILURE;
 
   ezLog::Success("Compiled Shader '{0}'", szShaderFile);
   return EZ_SUCCESS;
@@ -289,6 +311,15 @@ ezApplication::Execution ezShaderCompilerApplication::Run()
     }
   }
 
+  if (m_bWritePack)
+  {
+    if (ezShaderStagePack::WritePack(ezShaderManager::GetActivePlatform()).Failed())
+    {
+      ezLog::Error("Failed to write the shader stage pack for platform '{0}'", ezShaderManager::GetActivePlatform());
+      SetReturnCode(1);
+    }
+  }
+
   return ezApplication::Execution::Quit;
 }
 
@@ -28,6 +28,7 @@ private:
 
   ezPermutationGenerator m_PermutationGenerator;
   ezString m_sPlatforms;
+  bool m_bWritePack = false;
   ezString m_sShaderFiles;
   ezMap<ezString, ezHybridArray<ezString, 4>> m_FixedPermVars;
 };
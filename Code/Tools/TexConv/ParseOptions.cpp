@@ -101,6 +101,15 @@ ezCommandLineOptionEnum opt_BumpMapFilter("_TexConv", "-bumpMapFilter", "Filter
 
 ezCommandLineOptionEnum opt_Platform("_TexConv", "-platform", "What platform to generate the textures for.", "PC | Android", 0);
 
+ezCommandLineOptionPath opt_CacheDir("_TexConv", "-cacheDir",
+  "\
+  Directory in which intermediate results are cached.\n\
+  Repeated conversions of the same input files only redo the stages whose settings changed.\n\
+",
+  "");
+
+ezCommandLineOptionInt opt_CacheSizeLimit("_TexConv", "-cacheSizeLimit", "Maximum size of the -cacheDir in megabytes. The least recently used entries are deleted when it grows larger. 0 means unlimited.", 2048, 0, 1024 * 1024);
+
 ezResult ezTexConv::ParseCommandLine()
 {
   if (ezCommandLineOption::LogAvailableOptions(ezCommandLineOption::LogAvailableModes::IfHelpRequested, "_TexConv"))
@@ -122,6 +131,7 @@ ezResult ezTexConv::ParseCommandLine()
   EZ_SUCCEED_OR_RETURN(ParseInputFiles());
   EZ_SUCCEED_OR_RETURN(ParseChannelMappings());
   EZ_SUCCEED_OR_RETURN(ParseBumpMapFilter());
+  EZ_SUCCEED_OR_RETURN(ParseCacheOptions());
 
   return EZ_SUCCESS;
 }
@@ -458,3 +468,16 @@ ezResult ezTexConv::ParseBumpMapFilter()
   m_Processor.m_Descriptor.m_BumpMapFilter = static_cast<ezTexConvBumpMapFilter::Enum>(value);
   return EZ_SUCCESS;
 }
+
+ezResult ezTexConv::ParseCacheOptions()
+{
+  const ezString sCacheDir = opt_CacheDir.GetOptionValue(ezCommandLineOption::LogMode::AlwaysIfSpecified);
+
+  if (sCacheDir.IsEmpty())
+    return EZ_SUCCESS;
+
+  m_Processor.m_Descriptor.m_sCacheDirectory = sCacheDir;
+  m_Processor.m_Descriptor.m_uiCacheSizeLimit = static_cast<ezUInt64>(opt_CacheSizeLimit.GetOptionValue(ezCommandLineOption::LogMode::Always)) * 1024 * 1024;
+
+  return EZ_SUCCESS;
+}
@@ -6,6 +6,7 @@
 #include <Texture/Image/Formats/DdsFileFormat.h>
 #include <Texture/Image/Formats/StbImageFileFormats.h>
 #include <Texture/ezTexFormat/ezTexFormat.h>
+#include <Texture/ezTexFormat/ezTexMipChain.h>
 
 ezTexConv::ezTexConv()
   : ezApplication("TexConv")
@@ -150,8 +151,23 @@ ezResult ezTexConv::WriteTexFile(ezStreamWriter& stream, const ezImage& image)
   texFormat.m_AddressModeW = m_Processor.m_Descriptor.m_AddressModeW;
   texFormat.m_TextureFilter = m_Processor.m_Descriptor.m_FilterMode;
 
+  // regular 2D textures store their mips smallest-first, so that the runtime can stream in the higher mips on demand
+  texFormat.m_bStreamableMips = m_Processor.m_Descriptor.m_OutputType == ezTexConvOutputType::Texture2D && image.GetNumFaces() == 1 &&
+                                image.GetNumArrayIndices() == 1 && image.GetDepth() == 1 && image.GetNumMipLevels() > 1;
+
   texFormat.WriteTextureHeader(stream);
 
+  if (texFormat.m_bStreamableMips)
+  {
+    if (ezTexMipChain::WriteImage(stream, image).Failed())
+    {
+      ezLog::Error("Failed to write mip chain to ezTex file.");
+      return EZ_FAILURE;
+    }
+
+    return EZ_SUCCESS;
+  }
+
   ezDdsFileFormat ddsWriter;
   if (ddsWriter.WriteImage(stream, image, ezLog::GetThreadLocalLogSystem(), "dds").Failed())
   {
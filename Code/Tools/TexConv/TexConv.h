@@ -47,6 +47,7 @@ public:
   ezResult ParseMiscOptions();
   ezResult ParseAssetHeader();
   ezResult ParseBumpMapFilter();
+  ezResult ParseCacheOptions();
 
   ezResult ParseUIntOption(const char* szOption, ezInt32 iMinValue, ezInt32 iMaxValue, ezUInt32& uiResult) const;
   ezResult ParseStringOption(const char* szOption, const ezDynamicArray<KeyEnumValuePair>& allowed, ezInt32& iResult) const;
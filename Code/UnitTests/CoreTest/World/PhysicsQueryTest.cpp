@@ -0,0 +1,184 @@
+#include <CoreTest/CoreTestPCH.h>
+
+#include <Core/Interfaces/PhysicsWorldModule.h>
+#include <Core/World/World.h>
+
+#define EZ_PERFORMANCE_TESTS_STATE ezTestBlock::DisabledNoWarning
+
+namespace
+{
+  enum constants
+  {
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEBUG)
+    NUM_RAYS = 10000,
+#else
+    NUM_RAYS = 500000,
+#endif
+  };
+
+  /// A physics module that only knows a ground plane at z = 0, with a hole in every seventh cell of a 1m grid.
+  class TestPhysicsModule : public ezPhysicsWorldModuleInterface
+  {
+  public:
+    TestPhysicsModule(ezWorld* pWorld)
+      : ezPhysicsWorldModuleInterface(pWorld)
+    {
+    }
+
+    virtual bool Raycast(ezPhysicsCastResult& out_Result, const ezVec3& vStart, const ezVec3& vDir, float fDistance, const ezPhysicsQueryParameters& params, ezPhysicsHitCollection collection = ezPhysicsHitCollection::Closest) const override
+    {
+      if (vDir.z >= 0.0f)
+        return false;
+
+      const float fHitDistance = -vStart.z / vDir.z;
+      if (fHitDistance < 0.0f || fHitDistance > fDistance)
+        return false;
+
+      const ezVec3 vPos = vStart + vDir * fHitDistance;
+      if ((static_cast<ezInt32>(ezMath::Floor(vPos.x)) + static_cast<ezInt32>(ezMath::Floor(vPos.y))) % 7 == 0)
+        return false;
+
+      out_Result.m_vPosition = vPos;
+      out_Result.m_vNormal.Set(0, 0, 1);
+      out_Result.m_fDistance = fHitDistance;
+      return true;
+    }
+
+    virtual bool RaycastAll(ezPhysicsCastResultArray& out_Results, const ezVec3& vStart, const ezVec3& vDir, float fDistance, const ezPhysicsQueryParameters& params) const override
+    {
+      ezPhysicsCastResult result;
+      if (!Raycast(result, vStart, vDir, fDistance, params))
+        return false;
+
+      out_Results.m_Results.PushBack(result);
+      return true;
+    }
+
+    virtual bool SweepTestSphere(ezPhysicsCastResult& out_Result, float fSphereRadius, const ezVec3& vStart, const ezVec3& vDir, float fDistance, const ezPhysicsQueryParameters& params, ezPhysicsHitCollection collection = ezPhysicsHitCollection::Closest) const override
+    {
+      return Raycast(out_Result, vStart - ezVec3(0, 0, fSphereRadius), vDir, fDistance, params, collection);
+    }
+
+    virtual bool SweepTestBox(ezPhysicsCastResult& out_Result, ezVec3 vBoxExtends, const ezTransform& transform, const ezVec3& vDir, float fDistance, const ezPhysicsQueryParameters& params, ezPhysicsHitCollection collection = ezPhysicsHitCollection::Closest) const override { return false; }
+    virtual bool SweepTestCapsule(ezPhysicsCastResult& out_Result, float fCapsuleRadius, float fCapsuleHeight, const ezTransform& transform, const ezVec3& vDir, float fDistance, const ezPhysicsQueryParameters& params, ezPhysicsHitCollection collection = ezPhysicsHitCollection::Closest) const override { return false; }
+    virtual bool OverlapTestSphere(float fSphereRadius, const ezVec3& vPosition, const ezPhysicsQueryParameters& params) const override { return false; }
+    virtual bool OverlapTestCapsule(float fCapsuleRadius, float fCapsuleHeight, const ezTransform& transform, const ezPhysicsQueryParameters& params) const override { return false; }
+    virtual void QueryShapesInSphere(ezPhysicsOverlapResultArray& out_Results, float fSphereRadius, const ezVec3& vPosition, const ezPhysicsQueryParameters& params) const override {}
+    virtual ezVec3 GetGravity() const override { return ezVec3(0, 0, -10); }
+  };
+
+  void CreateRays(ezDynamicArray<ezPhysicsCastRequest>& out_Rays, ezUInt32 uiNumRays)
+  {
+    out_Rays.SetCountUninitialized(uiNumRays);
+
+    for (ezUInt32 i = 0; i < uiNumRays; ++i)
+    {
+      ezPhysicsCastRequest& ray = out_Rays[i];
+      ray.m_vStart.Set((i % 1000) * 0.37f, (i / 1000) * 0.53f, 5.0f);
+      ray.m_vDir.Set(0.1f * ((i % 5) - 2.0f), 0.0f, -1.0f);
+      ray.m_vDir.Normalize();
+      ray.m_fDistance = (i % 3 == 0) ? 4.0f : 10.0f;
+    }
+  }
+} // namespace
+
+EZ_CREATE_SIMPLE_TEST(World, PhysicsQueries)
+{
+  ezWorldDesc worldDesc("Test");
+  ezWorld world(worldDesc);
+  TestPhysicsModule physics(&world);
+
+  const ezPhysicsQueryParameters params(0);
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "RaycastBatch")
+  {
+    ezDynamicArray<ezPhysicsCastRequest> rays;
+    CreateRays(rays, 1000);
+
+    ezDynamicArray<ezPhysicsCastResult> results;
+    results.SetCount(rays.GetCount());
+    ezDynamicArray<bool> hits;
+    hits.SetCount(rays.GetCount());
+
+    const ezUInt32 uiNumHits = physics.RaycastBatch(rays, results, hits, params);
+
+    ezUInt32 uiExpectedHits = 0;
+    for (ezUInt32 i = 0; i < rays.GetCount(); ++i)
+    {
+      ezPhysicsCastResult expected;
+      const bool bHit = physics.Raycast(expected, rays[i].m_vStart, rays[i].m_vDir, rays[i].m_fDistance, params);
+
+      EZ_TEST_BOOL(hits[i] == bHit);
+
+      if (bHit)
+      {
+        ++uiExpectedHits;
+        EZ_TEST_VEC3(results[i].m_vPosition, expected.m_vPosition, 0.0f);
+        EZ_TEST_FLOAT(results[i].m_fDistance, expected.m_fDistance, 0.0f);
+      }
+    }
+
+    EZ_TEST_INT(uiNumHits, uiExpectedHits);
+    EZ_TEST_BOOL(uiNumHits > 0 && uiNumHits < rays.GetCount());
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "SweepTestSphereBatch")
+  {
+    ezDynamicArray<ezPhysicsCastRequest> sweeps;
+    CreateRays(sweeps, 100);
+
+    // degenerate requests are misses, not errors
+    sweeps[0].m_fDistance = 0.0f;
+    sweeps[1].m_vDir.SetZero();
+
+    ezDynamicArray<ezPhysicsCastResult> results;
+    results.SetCount(sweeps.GetCount());
+    ezDynamicArray<bool> hits;
+    hits.SetCount(sweeps.GetCount());
+
+    const ezUInt32 uiNumHits = physics.SweepTestSphereBatch(0.5f, sweeps, results, hits, params);
+
+    ezUInt32 uiExpectedHits = 0;
+    for (ezUInt32 i = 0; i < sweeps.GetCount(); ++i)
+    {
+      ezPhysicsCastResult expected;
+      const bool bHit = physics.SweepTestSphere(expected, 0.5f, sweeps[i].m_vStart, sweeps[i].m_vDir, sweeps[i].m_fDistance, params);
+
+      EZ_TEST_BOOL(hits[i] == bHit);
+      uiExpectedHits += bHit ? 1 : 0;
+    }
+
+    EZ_TEST_INT(uiNumHits, uiExpectedHits);
+    EZ_TEST_BOOL(!hits[0] && !hits[1]);
+  }
+
+  EZ_TEST_BLOCK(EZ_PERFORMANCE_TESTS_STATE, "Per-ray vs. batched throughput")
+  {
+    ezDynamicArray<ezPhysicsCastRequest> rays;
+    CreateRays(rays, NUM_RAYS);
+
+    ezDynamicArray<ezPhysicsCastResult> results;
+    results.SetCount(rays.GetCount());
+    ezDynamicArray<bool> hits;
+    hits.SetCount(rays.GetCount());
+
+    const ezPhysicsWorldModuleInterface* pInterface = &physics;
+
+    ezTime tStart = ezTime::Now();
+    ezUInt32 uiNumHitsSingle = 0;
+    for (ezUInt32 i = 0; i < rays.GetCount(); ++i)
+    {
+      uiNumHitsSingle += pInterface->Raycast(results[i], rays[i].m_vStart, rays[i].m_vDir, rays[i].m_fDistance, params) ? 1 : 0;
+    }
+    const ezTime tSingle = ezTime::Now() - tStart;
+
+    tStart = ezTime::Now();
+    const ezUInt32 uiNumHitsBatch = pInterface->RaycastBatch(rays, results, hits, params, ezPhysicsHitCollection::Closest, true);
+    const ezTime tBatch = ezTime::Now() - tStart;
+
+    EZ_TEST_INT(uiNumHitsSingle, uiNumHitsBatch);
+
+    ezLog::Info("[test]{0} rays, one by one: {1}ms, {2} rays/ms", NUM_RAYS, ezArgF(tSingle.GetMilliseconds(), 3), ezArgF(NUM_RAYS / ezMath::Max(tSingle.GetMilliseconds(), 0.001), 0));
+    ezLog::Info("[test]{0} rays, batched: {1}ms, {2} rays/ms", NUM_RAYS, ezArgF(tBatch.GetMilliseconds(), 3), ezArgF(NUM_RAYS / ezMath::Max(tBatch.GetMilliseconds(), 0.001), 0));
+  }
+}
@@ -0,0 +1,183 @@
+#include <FoundationTest/FoundationTestPCH.h>
+
+#include <Foundation/Algorithm/BinaryDelta.h>
+#include <Foundation/IO/MemoryStream.h>
+
+namespace
+{
+  void FillRandom(ezDynamicArray<ezUInt8>& data, ezUInt32 uiSize, ezUInt32 uiSeed)
+  {
+    data.SetCountUninitialized(uiSize);
+
+    // simple LCG, to get reproducible data
+    for (ezUInt32 i = 0; i < uiSize; ++i)
+    {
+      uiSeed = uiSeed * 1664525u + 1013904223u;
+      data[i] = static_cast<ezUInt8>(uiSeed >> 24);
+    }
+  }
+
+  ezUInt32 RoundTrip(const ezDynamicArray<ezUInt8>& base, const ezDynamicArray<ezUInt8>& changed, ezUInt32 uiBlockSize)
+  {
+    ezBinaryDelta::Signature signature;
+    ezBinaryDelta::ComputeSignature(base, signature, uiBlockSize);
+
+    ezDynamicArray<ezUInt8> delta;
+    ezBinaryDelta::ComputeDelta(signature, changed, delta);
+
+    ezDynamicArray<ezUInt8> result;
+    EZ_TEST_BOOL(ezBinaryDelta::ApplyDelta(base, delta, result).Succeeded());
+    EZ_TEST_BOOL(result == changed);
+
+    return delta.GetCount();
+  }
+} // namespace
+
+EZ_CREATE_SIMPLE_TEST(Algorithm, BinaryDelta)
+{
+  const ezUInt32 uiBlockSize = 512;
+
+  ezDynamicArray<ezUInt8> base;
+  FillRandom(base, 64 * 1024 + 123, 42);
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Identical")
+  {
+    const ezUInt32 uiDeltaSize = RoundTrip(base, base, uiBlockSize);
+
+    // only the partial last block has to be sent literally
+    EZ_TEST_BOOL(uiDeltaSize < 256);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Modified")
+  {
+    ezDynamicArray<ezUInt8> changed = base;
+    for (ezUInt32 i = 1000; i < 1100; ++i)
+      changed[i] ^= 0xFF;
+
+    const ezUInt32 uiDeltaSize = RoundTrip(base, changed, uiBlockSize);
+    EZ_TEST_BOOL(uiDeltaSize < 4 * uiBlockSize);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Inserted and Removed")
+  {
+    // inserting data shifts all following blocks, which must still be found at their new, unaligned offset
+    ezDynamicArray<ezUInt8> changed = base;
+    ezDynamicArray<ezUInt8> inserted;
+    FillRandom(inserted, 77, 7);
+    changed.InsertRange(inserted.GetArrayPtr(), 3000);
+    changed.RemoveAtAndCopy(40000, 300);
+
+    const ezUInt32 uiDeltaSize = RoundTrip(base, changed, uiBlockSize);
+    EZ_TEST_BOOL(uiDeltaSize < 4 * uiBlockSize);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Unrelated")
+  {
+    ezDynamicArray<ezUInt8> other;
+    FillRandom(other, 10 * 1024, 1234);
+
+    const ezUInt32 uiDeltaSize = RoundTrip(base, other, uiBlockSize);
+    EZ_TEST_BOOL(uiDeltaSize > other.GetCount());
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Empty")
+  {
+    ezDynamicArray<ezUInt8> empty;
+    RoundTrip(base, empty, uiBlockSize);
+    RoundTrip(empty, base, 0);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Invalid Delta")
+  {
+    ezBinaryDelta::Signature signature;
+    ezBinaryDelta::ComputeSignature(base, signature, uiBlockSize);
+
+    ezDynamicArray<ezUInt8> delta;
+    ezBinaryDelta::ComputeDelta(signature, base, delta);
+
+    // without the base data, the copy operations reference blocks that do not exist
+    ezDynamicArray<ezUInt8> result;
+    EZ_TEST_BOOL(ezBinaryDelta::ApplyDelta(ezArrayPtr<const ezUInt8>(), delta, result).Failed());
+
+    // truncated delta
+    delta.SetCount(delta.GetCount() / 2);
+    EZ_TEST_BOOL(ezBinaryDelta::ApplyDelta(base, delta, result).Failed());
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Signature Serialization")
+  {
+    ezBinaryDelta::Signature signature;
+    ezBinaryDelta::ComputeSignature(base, signature);
+
+    ezMemoryStreamStorage storage;
+    ezMemoryStreamWriter writer(&storage);
+    ezBinaryDelta::WriteSignature(writer, signature);
+
+    ezMemoryStreamReader reader(&storage);
+    ezBinaryDelta::Signature signature2;
+    EZ_TEST_BOOL(ezBinaryDelta::ReadSignature(reader, signature2).Succeeded());
+
+    EZ_TEST_INT(signature2.m_uiBlockSize, signature.m_uiBlockSize);
+    EZ_TEST_INT(signature2.m_Blocks.GetCount(), signature.m_Blocks.GetCount());
+
+    for (ezUInt32 i = 0; i < signature.m_Blocks.GetCount(); ++i)
+    {
+      EZ_TEST_INT(signature2.m_Blocks[i].m_uiWeakHash, signature.m_Blocks[i].m_uiWeakHash);
+      EZ_TEST_BOOL(signature2.m_Blocks[i].m_uiStrongHash == signature.m_Blocks[i].m_uiStrongHash);
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Malformed Signature")
+  {
+    auto ReadMalformed = [](ezUInt32 uiBlockSize, ezUInt32 uiNumBlocks, ezUInt32 uiBlocksWritten) {
+      ezMemoryStreamStorage storage;
+      ezMemoryStreamWriter writer(&storage);
+      writer << uiBlockSize;
+      writer << uiNumBlocks;
+
+      for (ezUInt32 i = 0; i < uiBlocksWritten; ++i)
+      {
+        writer << i;
+        writer << static_cast<ezUInt64>(i);
+      }
+
+      ezMemoryStreamReader reader(&storage);
+      ezBinaryDelta::Signature signature;
+      const ezResult res = ezBinaryDelta::ReadSignature(reader, signature);
+
+      if (res.Failed())
+      {
+        EZ_TEST_INT(signature.m_uiBlockSize, 0);
+        EZ_TEST_BOOL(signature.m_Blocks.IsEmpty());
+      }
+
+      return res;
+    };
+
+    EZ_TEST_BOOL(ReadMalformed(512, 4, 4).Succeeded());
+    EZ_TEST_BOOL(ReadMalformed(0, 4, 4).Failed());
+    EZ_TEST_BOOL(ReadMalformed(512, 4, 3).Failed());
+    EZ_TEST_BOOL(ReadMalformed(512, 0xFFFFFFFF, 1).Failed());
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Malformed Delta Header")
+  {
+    // a tiny delta that claims a huge result must not allocate it up front, and fails since it does not produce that much data
+    ezDynamicArray<ezUInt8> delta;
+    ezMemoryStreamContainerWrapperStorage<ezDynamicArray<ezUInt8>> storage(&delta);
+    ezMemoryStreamWriter writer(&storage);
+    writer << static_cast<ezUInt8>(1);
+    writer << static_cast<ezUInt32>(512);
+    writer << static_cast<ezUInt32>(0xFFFFFFFF);
+    writer << static_cast<ezUInt8>(0);
+
+    ezDynamicArray<ezUInt8> result;
+    EZ_TEST_BOOL(ezBinaryDelta::ApplyDelta(base, delta, result).Failed());
+    EZ_TEST_BOOL(result.GetCapacity() < 1024 * 1024);
+
+    // zero block size
+    for (ezUInt32 i = 1; i < 5; ++i)
+      delta[i] = 0;
+    EZ_TEST_BOOL(ezBinaryDelta::ApplyDelta(base, delta, result).Failed());
+  }
+}
@@ -0,0 +1,190 @@
+#include <FoundationTest/FoundationTestPCH.h>
+
+#include <Foundation/Communication/RemoteInterfaceEnet.h>
+#include <Foundation/Time/Stopwatch.h>
+#include <Foundation/Types/UniquePtr.h>
+
+#ifdef BUILDSYSTEM_ENABLE_ENET_SUPPORT
+
+#  define EZ_PERFORMANCE_TESTS_STATE ezTestBlock::DisabledNoWarning
+
+namespace
+{
+  constexpr ezUInt32 s_uiTestSystemID = 'TEST';
+
+  struct ReceivedMessages
+  {
+    void OnMessage(ezRemoteMessage& msg)
+    {
+      m_MessageIDs.PushBack(msg.GetMessageID());
+      m_uiNumBytes += msg.GetMessageSize();
+
+      ezUInt32 uiHash = 0;
+      for (ezUInt32 i = 0; i < msg.GetMessageSize(); ++i)
+      {
+        uiHash = uiHash * 31 + msg.GetMessageData()[i];
+      }
+      m_Hashes.PushBack(uiHash);
+    }
+
+    void Clear()
+    {
+      m_MessageIDs.Clear();
+      m_Hashes.Clear();
+      m_uiNumBytes = 0;
+    }
+
+    ezDynamicArray<ezUInt32> m_MessageIDs;
+    ezDynamicArray<ezUInt32> m_Hashes;
+    ezUInt64 m_uiNumBytes = 0;
+  };
+
+  void FillMessage(ezDynamicArray<ezUInt8>& data, ezUInt32 uiSize, ezUInt32 uiSeed, bool bCompressible)
+  {
+    data.SetCountUninitialized(uiSize);
+
+    for (ezUInt32 i = 0; i < uiSize; ++i)
+    {
+      uiSeed = uiSeed * 1664525u + 1013904223u;
+      data[i] = bCompressible ? static_cast<ezUInt8>(i / 64) : static_cast<ezUInt8>(uiSeed >> 24);
+    }
+  }
+
+  ezUInt32 HashMessage(const ezDynamicArray<ezUInt8>& data)
+  {
+    ezUInt32 uiHash = 0;
+    for (ezUInt8 b : data)
+    {
+      uiHash = uiHash * 31 + b;
+    }
+    return uiHash;
+  }
+
+  /// Updates both sides until the receiver got the expected number of messages, or the time runs out.
+  bool WaitForMessages(ezRemoteInterface& sender, ezRemoteInterface& receiver, ReceivedMessages& received, ezUInt32 uiNumMessages)
+  {
+    const ezTime tEnd = ezTime::Now() + ezTime::Seconds(10);
+
+    while (received.m_MessageIDs.GetCount() < uiNumMessages && ezTime::Now() < tEnd)
+    {
+      sender.UpdateRemoteInterface();
+      receiver.UpdateRemoteInterface();
+      receiver.ExecuteAllMessageHandlers();
+    }
+
+    return received.m_MessageIDs.GetCount() == uiNumMessages;
+  }
+} // namespace
+
+EZ_CREATE_SIMPLE_TEST(Communication, RemoteInterface)
+{
+  ezUniquePtr<ezRemoteInterfaceEnet> pServer = ezRemoteInterfaceEnet::Make();
+  ezUniquePtr<ezRemoteInterfaceEnet> pClient = ezRemoteInterfaceEnet::Make();
+
+  if (pServer->StartServer('EZRT', "2101", false).Failed() || pClient->ConnectToServer('EZRT', "localhost:2101", false).Failed())
+  {
+    ezLog::Warning("Could not set up a loopback connection, skipping the test.");
+    return;
+  }
+
+  const ezTime tEnd = ezTime::Now() + ezTime::Seconds(10);
+  while (!pClient->IsConnectedToServer() && ezTime::Now() < tEnd)
+  {
+    pServer->UpdateRemoteInterface();
+    pClient->UpdateRemoteInterface();
+  }
+
+  if (!pClient->IsConnectedToServer())
+  {
+    ezLog::Warning("Could not connect to the loopback server, skipping the test.");
+    pClient->ShutdownConnection();
+    pServer->ShutdownConnection();
+    return;
+  }
+
+  ReceivedMessages received;
+  pServer->SetMessageHandler(s_uiTestSystemID, ezMakeDelegate(&ReceivedMessages::OnMessage, &received));
+
+  ezDynamicArray<ezUInt8> data;
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Compression Handshake")
+  {
+    EZ_TEST_BOOL(!pClient->IsCompressionActive());
+
+    pClient->SetCompressionThreshold(4 * 1024);
+
+    // the server told the client during the handshake whether it can decompress packets
+#  ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+    EZ_TEST_BOOL(pClient->IsCompressionActive());
+#  else
+    EZ_TEST_BOOL(!pClient->IsCompressionActive());
+#  endif
+
+    pClient->SetCompressionThreshold(0);
+    EZ_TEST_BOOL(!pClient->IsCompressionActive());
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Batched, Large and Compressed Messages")
+  {
+    pClient->SetCompressionThreshold(4 * 1024);
+
+    ezDynamicArray<ezUInt32> expectedHashes;
+
+    // small messages are batched, large ones flush the batch first, so the order has to be preserved in any case
+    const ezUInt32 uiSizes[] = {0, 16, 200, 1000, 5000, 16, 64 * 1024, 8, 2000, 12 * 1024};
+
+    for (ezUInt32 i = 0; i < EZ_ARRAY_SIZE(uiSizes); ++i)
+    {
+      FillMessage(data, uiSizes[i], i, (i % 2) == 0);
+      expectedHashes.PushBack(HashMessage(data));
+
+      pClient->Send(ezRemoteTransmitMode::Reliable, s_uiTestSystemID, i, data);
+    }
+
+    EZ_TEST_BOOL(WaitForMessages(*pClient, *pServer, received, EZ_ARRAY_SIZE(uiSizes)));
+
+    for (ezUInt32 i = 0; i < received.m_MessageIDs.GetCount(); ++i)
+    {
+      EZ_TEST_INT(received.m_MessageIDs[i], i);
+      EZ_TEST_INT(received.m_Hashes[i], expectedHashes[i]);
+    }
+
+    pClient->SetCompressionThreshold(0);
+    received.Clear();
+  }
+
+  EZ_TEST_BLOCK(EZ_PERFORMANCE_TESTS_STATE, "Loopback Throughput")
+  {
+    const ezUInt32 uiNumMessages = 50000;
+    const ezUInt32 uiMessageSize = 64;
+
+    FillMessage(data, uiMessageSize, 0, false);
+
+    for (ezUInt32 uiBatching = 0; uiBatching < 2; ++uiBatching)
+    {
+      pClient->SetMessageBatching(uiBatching != 0);
+
+      ezStopwatch sw;
+
+      for (ezUInt32 i = 0; i < uiNumMessages; ++i)
+      {
+        pClient->Send(ezRemoteTransmitMode::Reliable, s_uiTestSystemID, i, data);
+      }
+
+      EZ_TEST_BOOL(WaitForMessages(*pClient, *pServer, received, uiNumMessages));
+
+      const double fSeconds = sw.GetRunningTotal().GetSeconds();
+      ezLog::Info("[test]Batching {}: {} messages of {} bytes in {} ms, {} msg/s, {} MB/s", uiBatching != 0 ? "on" : "off", uiNumMessages, uiMessageSize,
+        ezArgF(fSeconds * 1000.0, 1), ezArgF(uiNumMessages / fSeconds, 0), ezArgF(received.m_uiNumBytes / fSeconds / (1024.0 * 1024.0), 2));
+
+      received.Clear();
+    }
+
+    pClient->SetMessageBatching(true);
+  }
+
+  pClient->ShutdownConnection();
+  pServer->ShutdownConnection();
+}
+
+#endif
@@ -0,0 +1,212 @@
+#include <FoundationTest/FoundationTestPCH.h>
+
+#include <Foundation/Communication/TelemetryRecording.h>
+#include <Foundation/IO/MemoryStream.h>
+#include <Foundation/Time/Stopwatch.h>
+
+#define EZ_PERFORMANCE_TESTS_STATE ezTestBlock::DisabledNoWarning
+
+EZ_CREATE_SIMPLE_TEST(Communication, TelemetryRecording)
+{
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Round Trip")
+  {
+    ezMemoryStreamStorage storage;
+    ezMemoryStreamWriter writer(&storage);
+
+    ezTelemetryRecordingEncoder encoder;
+    ezTelemetryRecordingEncoder::WriteHeader(writer);
+
+    // frame 1: new stats of different types
+    encoder.SetStat("App/FPS", 60.0);
+    encoder.SetStat("App/Frame", ezUInt32(1));
+    encoder.SetStat("App/Name", "Test");
+    encoder.SetStat("Render/Drawcalls", ezInt32(-5));
+    EZ_TEST_BOOL(encoder.EncodeFrame(ezTime::Milliseconds(100), writer));
+
+    // empty frames are not written
+    EZ_TEST_BOOL(!encoder.EncodeFrame(ezTime::Milliseconds(110), writer));
+
+    // frame 2: deltas, coalescing, a type change and a removal
+    encoder.SetStat("App/FPS", 59.5);
+    encoder.SetStat("App/Frame", ezUInt32(2));
+    encoder.SetStat("App/Frame", ezUInt32(3));
+    encoder.SetStat("Render/Drawcalls", 1.5f);
+    encoder.RemoveStat("App/Name");
+    EZ_TEST_INT(encoder.GetNumPendingChanges(), 4);
+    EZ_TEST_BOOL(encoder.EncodeFrame(ezTime::Milliseconds(116.5), writer));
+
+    // frame 3: a removed stat comes back, the name is not written again
+    encoder.SetStat("App/Name", "Again");
+    encoder.SetStat("App/Frame", ezUInt32(0));
+    EZ_TEST_BOOL(encoder.EncodeFrame(ezTime::Milliseconds(133), writer));
+
+    ezMemoryStreamReader reader(&storage);
+
+    ezTelemetryRecordingDecoder decoder;
+    EZ_TEST_BOOL(decoder.ReadHeader(reader).Succeeded());
+
+    ezTime frameTime;
+    ezDynamicArray<ezTelemetryRecordingDecoder::StatChange> changes;
+
+    EZ_TEST_BOOL(decoder.DecodeFrame(reader, frameTime, changes).Succeeded());
+    EZ_TEST_DOUBLE(frameTime.GetMilliseconds(), 100.0, 0.001);
+    EZ_TEST_INT(changes.GetCount(), 4);
+    EZ_TEST_STRING(changes[0].m_szStatName, "App/FPS");
+    EZ_TEST_BOOL(changes[0].m_Value == ezVariant(60.0));
+    EZ_TEST_BOOL(changes[1].m_Value == ezVariant(ezUInt32(1)));
+    EZ_TEST_BOOL(changes[2].m_Value == ezVariant("Test"));
+    EZ_TEST_BOOL(changes[3].m_Value == ezVariant(ezInt32(-5)));
+
+    EZ_TEST_BOOL(decoder.DecodeFrame(reader, frameTime, changes).Succeeded());
+    EZ_TEST_DOUBLE(frameTime.GetMilliseconds(), 116.5, 0.001);
+    EZ_TEST_INT(changes.GetCount(), 4);
+    EZ_TEST_STRING(changes[0].m_szStatName, "App/FPS");
+    EZ_TEST_BOOL(changes[0].m_Value == ezVariant(59.5));
+    EZ_TEST_STRING(changes[1].m_szStatName, "App/Frame");
+    EZ_TEST_BOOL(changes[1].m_Value == ezVariant(ezUInt32(3)));
+    EZ_TEST_STRING(changes[2].m_szStatName, "Render/Drawcalls");
+    EZ_TEST_BOOL(changes[2].m_Value == ezVariant(1.5f));
+    EZ_TEST_STRING(changes[3].m_szStatName, "App/Name");
+    EZ_TEST_BOOL(changes[3].m_bRemoved);
+
+    EZ_TEST_BOOL(decoder.DecodeFrame(reader, frameTime, changes).Succeeded());
+    EZ_TEST_DOUBLE(frameTime.GetMilliseconds(), 133.0, 0.001);
+    EZ_TEST_INT(changes.GetCount(), 2);
+    EZ_TEST_STRING(changes[0].m_szStatName, "App/Name");
+    EZ_TEST_BOOL(changes[0].m_Value == ezVariant("Again"));
+    EZ_TEST_BOOL(changes[1].m_Value == ezVariant(ezUInt32(0)));
+
+    // end of the stream
+    EZ_TEST_BOOL(decoder.DecodeFrame(reader, frameTime, changes).Failed());
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Truncated Stream")
+  {
+    ezDynamicArray<ezUInt8> data;
+    ezMemoryStreamContainerWrapperStorage<ezDynamicArray<ezUInt8>> storage(&data);
+    ezMemoryStreamWriter writer(&storage);
+
+    ezTelemetryRecordingEncoder encoder;
+    ezTelemetryRecordingEncoder::WriteHeader(writer);
+
+    encoder.SetStat("A", 1.0);
+    encoder.EncodeFrame(ezTime::Milliseconds(10), writer);
+    const ezUInt32 uiFirstFrameEnd = data.GetCount();
+
+    encoder.SetStat("B", 2.0);
+    encoder.EncodeFrame(ezTime::Milliseconds(20), writer);
+
+    // a recording that was cut off in the middle of a frame still yields all complete frames
+    ezRawMemoryStreamReader reader(data.GetData(), data.GetCount() - 2);
+
+    ezTelemetryRecordingDecoder decoder;
+    EZ_TEST_BOOL(decoder.ReadHeader(reader).Succeeded());
+
+    ezTime frameTime;
+    ezDynamicArray<ezTelemetryRecordingDecoder::StatChange> changes;
+    EZ_TEST_BOOL(decoder.DecodeFrame(reader, frameTime, changes).Succeeded());
+    EZ_TEST_INT(reader.GetReadPosition(), uiFirstFrameEnd);
+    EZ_TEST_BOOL(decoder.DecodeFrame(reader, frameTime, changes).Failed());
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Corrupted Name")
+  {
+    // frame with a time delta of 0 and one Name entry for stat 0, whose length is given by the bytes below
+    const ezUInt8 hugeLength[] = {0xFF, 0xFF, 0xFF, 0xFF, 0x0F};  // 0xFFFFFFFF, wraps to zero when truncated to 32 bit
+    const ezUInt8 largeLength[] = {0x80, 0x80, 0x80, 0x80, 0x01}; // 256 MB, valid but far beyond any stat name
+    const ezArrayPtr<const ezUInt8> lengths[] = {ezMakeArrayPtr(hugeLength), ezMakeArrayPtr(largeLength)};
+
+    for (auto length : lengths)
+    {
+      ezDynamicArray<ezUInt8> data;
+      ezMemoryStreamContainerWrapperStorage<ezDynamicArray<ezUInt8>> storage(&data);
+      ezMemoryStreamWriter writer(&storage);
+
+      ezTelemetryRecordingEncoder::WriteHeader(writer);
+
+      const ezUInt8 frame[] = {0x00, 0x01, 0x03};
+      writer.WriteBytes(frame, sizeof(frame)).IgnoreResult();
+      writer.WriteBytes(length.GetPtr(), length.GetCount()).IgnoreResult();
+      writer.WriteBytes("Name", 4).IgnoreResult();
+
+      ezRawMemoryStreamReader reader(data.GetData(), data.GetCount());
+
+      ezTelemetryRecordingDecoder decoder;
+      EZ_TEST_BOOL(decoder.ReadHeader(reader).Succeeded());
+
+      ezTime frameTime;
+      ezDynamicArray<ezTelemetryRecordingDecoder::StatChange> changes;
+      EZ_TEST_BOOL(decoder.DecodeFrame(reader, frameTime, changes).Failed());
+      EZ_TEST_BOOL(changes.IsEmpty());
+    }
+  }
+
+  EZ_TEST_BLOCK(EZ_PERFORMANCE_TESTS_STATE, "Encode Cost")
+  {
+    const ezUInt32 uiNumStats = 200;
+    const ezUInt32 uiNumFrames = 2000;
+
+    ezDynamicArray<ezString> names;
+    for (ezUInt32 i = 0; i < uiNumStats; ++i)
+    {
+      ezStringBuilder sName;
+      sName.Format("Group{}/Stat{}", i / 10, i);
+      names.PushBack(sName);
+    }
+
+    ezDynamicArray<ezUInt8> data;
+    ezMemoryStreamContainerWrapperStorage<ezDynamicArray<ezUInt8>> storage(&data);
+    ezMemoryStreamWriter writer(&storage);
+
+    ezTelemetryRecordingEncoder encoder;
+    ezTelemetryRecordingEncoder::WriteHeader(writer);
+
+    // the size that individual 'STAT' telemetry messages would take: name, value and time stamp
+    ezUInt64 uiMessageBytes = 0;
+
+    ezStopwatch sw;
+
+    for (ezUInt32 uiFrame = 0; uiFrame < uiNumFrames; ++uiFrame)
+    {
+      for (ezUInt32 i = 0; i < uiNumStats; ++i)
+      {
+        // a mix of slowly changing floats and counters, similar to frame times and draw calls
+        if (i % 2 == 0)
+          encoder.SetStat(names[i], 16.6 + ezMath::Sin(ezAngle::Radian(uiFrame * 0.01f + i)) * 0.5);
+        else
+          encoder.SetStat(names[i], ezUInt32(1000 + (uiFrame * 7 + i) % 50));
+
+        uiMessageBytes += sizeof(ezUInt32) + names[i].GetElementCount() + 9 + sizeof(double);
+      }
+
+      encoder.EncodeFrame(ezTime::Milliseconds(uiFrame * 16.6), writer);
+    }
+
+    const ezTime tEncode = sw.GetRunningTotal();
+    const ezUInt32 uiNumUpdates = uiNumStats * uiNumFrames;
+
+    ezLog::Info("[test]{} stat updates: {} ns per update, {} bytes per update, {}x smaller than individual messages", uiNumUpdates,
+      ezArgF(tEncode.GetNanoseconds() / uiNumUpdates, 1), ezArgF((double)data.GetCount() / uiNumUpdates, 2),
+      ezArgF((double)uiMessageBytes / data.GetCount(), 1));
+
+    ezRawMemoryStreamReader reader(data);
+    ezTelemetryRecordingDecoder decoder;
+    EZ_TEST_BOOL(decoder.ReadHeader(reader).Succeeded());
+
+    ezTime frameTime;
+    ezDynamicArray<ezTelemetryRecordingDecoder::StatChange> changes;
+    ezUInt32 uiNumDecoded = 0;
+
+    sw.StopAndReset();
+    sw.Resume();
+
+    while (decoder.DecodeFrame(reader, frameTime, changes).Succeeded())
+    {
+      uiNumDecoded += changes.GetCount();
+    }
+
+    ezLog::Info("[test]Decoding: {} ns per update", ezArgF(sw.GetRunningTotal().GetNanoseconds() / uiNumUpdates, 1));
+
+    EZ_TEST_INT(uiNumDecoded, uiNumUpdates);
+  }
+}
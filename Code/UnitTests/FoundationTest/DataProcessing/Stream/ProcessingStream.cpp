@@ -52,6 +52,54 @@ protected:
 EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(AddOneStreamProcessor, 1, ezRTTIDefaultAllocator<AddOneStreamProcessor>)
 EZ_END_DYNAMIC_REFLECTED_TYPE;
 
+// Multiply processor, supports range processing
+
+class MulStreamProcessor : public ezProcessingStreamProcessor
+{
+  EZ_ADD_DYNAMIC_REFLECTION(MulStreamProcessor, ezProcessingStreamProcessor);
+
+public:
+  void SetStreamName(ezHashedString StreamName) { m_StreamName = StreamName; }
+
+  float m_fFactor = 2.0f;
+  bool m_bRangeProcessing = true;
+  ezUInt32 m_uiNumPrepareCalls = 0;
+
+protected:
+  virtual ezResult UpdateStreamBindings() override
+  {
+    m_pStream = m_pStreamGroup->GetStreamByName(m_StreamName);
+
+    return m_pStream ? EZ_SUCCESS : EZ_FAILURE;
+  }
+
+  virtual void InitializeElements(ezUInt64 uiStartIndex, ezUInt64 uiNumElements) override {}
+
+  virtual bool PrepareRangeProcessing(ezUInt64 uiNumElements) override
+  {
+    ++m_uiNumPrepareCalls;
+    return m_bRangeProcessing;
+  }
+
+  virtual void ProcessRange(ezUInt64 uiStartIndex, ezUInt64 uiNumElements) override
+  {
+    ezProcessingStreamIterator<float> streamIterator(m_pStream, uiNumElements, uiStartIndex);
+
+    while (!streamIterator.HasReachedEnd())
+    {
+      streamIterator.Current() *= m_fFactor;
+
+      streamIterator.Advance();
+    }
+  }
+
+  ezHashedString m_StreamName;
+  ezProcessingStream* m_pStream = nullptr;
+};
+
+EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(MulStreamProcessor, 1, ezRTTIDefaultAllocator<MulStreamProcessor>)
+EZ_END_DYNAMIC_REFLECTED_TYPE;
+
 EZ_CREATE_SIMPLE_TEST(DataProcessing, ProcessingStream)
 {
   ezProcessingStreamGroup Group;
@@ -157,3 +205,76 @@ EZ_CREATE_SIMPLE_TEST(DataProcessing, ProcessingStream)
     }
   }
 }
+
+EZ_CREATE_SIMPLE_TEST(DataProcessing, ProcessingStreamRanges)
+{
+  ezProcessingStreamGroup Group;
+  ezProcessingStream* pStream = Group.AddStream("Stream", ezProcessingStream::DataType::Float);
+
+  ezProcessingStreamSpawnerZeroInitialized* pSpawner = EZ_DEFAULT_NEW(ezProcessingStreamSpawnerZeroInitialized);
+  pSpawner->SetStreamName(pStream->GetName());
+  Group.AddProcessor(pSpawner);
+
+  // (x + 1) * 2 * 3, the range processors are batched, but must not be reordered with the regular processor
+  AddOneStreamProcessor* pAddOne = EZ_DEFAULT_NEW(AddOneStreamProcessor);
+  pAddOne->SetStreamName(pStream->GetName());
+  pAddOne->m_fPriority = 0.0f;
+  Group.AddProcessor(pAddOne);
+
+  MulStreamProcessor* pMul2 = EZ_DEFAULT_NEW(MulStreamProcessor);
+  pMul2->SetStreamName(pStream->GetName());
+  pMul2->m_fPriority = 1.0f;
+  Group.AddProcessor(pMul2);
+
+  MulStreamProcessor* pMul3 = EZ_DEFAULT_NEW(MulStreamProcessor);
+  pMul3->SetStreamName(pStream->GetName());
+  pMul3->m_fFactor = 3.0f;
+  pMul3->m_fPriority = 2.0f;
+  Group.AddProcessor(pMul3);
+
+  Group.SetSize(10000);
+  Group.InitializeElements(9999);
+  Group.Process();
+
+  EZ_TEST_INT(Group.GetNumActiveElements(), 9999);
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Sequential")
+  {
+    Group.SetParallelChunkSize(0);
+    Group.Process();
+
+    for (float f : ezArrayPtr<const float>(pStream->GetData<float>(), 9999))
+    {
+      EZ_TEST_FLOAT(f, 6.0f, 0.0f);
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Parallel")
+  {
+    // the element count is not a multiple of the chunk size, so the last chunk is a partial one
+    Group.SetParallelChunkSize(100);
+    Group.Process();
+
+    for (float f : ezArrayPtr<const float>(pStream->GetData<float>(), 9999))
+    {
+      EZ_TEST_FLOAT(f, 42.0f, 0.0f);
+    }
+
+    EZ_TEST_INT(pMul2->m_uiNumPrepareCalls, 3);
+    EZ_TEST_INT(pMul3->m_uiNumPrepareCalls, 3);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Process Falls Back to ProcessRange")
+  {
+    // the processor doesn't implement Process(), the default processes all elements as one range
+    pMul3->m_bRangeProcessing = false;
+    Group.Process();
+
+    for (float f : ezArrayPtr<const float>(pStream->GetData<float>(), 9999))
+    {
+      EZ_TEST_FLOAT(f, 258.0f, 0.0f);
+    }
+
+    pMul3->m_bRangeProcessing = true;
+  }
+}
@@ -103,6 +103,38 @@ Only concrete and clocks.\n\
     f.Close();
   }
 
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "MoveFileOrDirectory")
+  {
+    ezStringBuilder sMoveSource = sOutputFile2;
+    sMoveSource.ChangeFileName("OSFile_TestFileMoveSource");
+
+    ezStringBuilder sMoveTarget = sOutputFile2;
+    sMoveTarget.ChangeFileName("OSFile_TestFileMoveTarget");
+
+    EZ_TEST_BOOL(ezOSFile::CopyFile(sOutputFile, sMoveSource).Succeeded());
+
+    // an existing file is replaced
+    {
+      ezOSFile f;
+      EZ_TEST_BOOL(f.Open(sMoveTarget, ezFileOpenMode::Write).Succeeded());
+      EZ_TEST_BOOL(f.Write("old", 3).Succeeded());
+    }
+
+    EZ_TEST_BOOL(ezOSFile::MoveFileOrDirectory(sMoveSource, sMoveTarget).Succeeded());
+    EZ_TEST_BOOL(!ezOSFile::ExistsFile(sMoveSource));
+
+    {
+      ezOSFile f;
+      EZ_TEST_BOOL(f.Open(sMoveTarget, ezFileOpenMode::Read).Succeeded());
+      EZ_TEST_INT(f.GetFileSize(), uiTextLen * 2);
+    }
+
+    // the source is gone now
+    EZ_TEST_BOOL(ezOSFile::MoveFileOrDirectory(sMoveSource, sMoveTarget).Failed());
+
+    EZ_TEST_BOOL(ezOSFile::DeleteFile(sMoveTarget).Succeeded());
+  }
+
   EZ_TEST_BLOCK(ezTestBlock::Enabled, "ReadAll")
   {
     ezOSFile f;
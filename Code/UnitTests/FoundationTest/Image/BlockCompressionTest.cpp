@@ -0,0 +1,272 @@
+#include <FoundationTest/FoundationTestPCH.h>
+
+#include <Foundation/Configuration/CVar.h>
+#include <Foundation/Math/Color16f.h>
+#include <Foundation/Time/Stopwatch.h>
+#include <Texture/Image/Conversions/BlockCompression.h>
+#include <Texture/Image/Conversions/DXTConversions.h>
+#include <Texture/Image/Image.h>
+#include <Texture/Image/ImageConversion.h>
+
+#define EZ_PERFORMANCE_TESTS_STATE ezTestBlock::DisabledNoWarning
+
+namespace
+{
+  /// A smooth gradient with some noise on top, which is roughly what the compressors see in real textures.
+  void FillBlock(ezUInt32 uiSeed, ezColorBaseUB* pPixels)
+  {
+    for (ezUInt32 i = 0; i < 16; ++i)
+    {
+      const ezUInt32 t = i % 4 + i / 4;
+      const ezUInt32 uiNoise = ((uiSeed + i) * 2654435761u) >> 29;
+
+      pPixels[i].r = static_cast<ezUInt8>((uiSeed * 37) % 200 + 6 * t + uiNoise);
+      pPixels[i].g = static_cast<ezUInt8>((uiSeed * 11) % 200 + 4 * t);
+      pPixels[i].b = static_cast<ezUInt8>((uiSeed * 5) % 200 + 2 * t + uiNoise);
+      pPixels[i].a = static_cast<ezUInt8>(255 - 8 * t);
+    }
+  }
+
+  float ComputeRGBPSNR(const ezColorBaseUB* pSource, const ezColorBaseUB* pDecoded, ezUInt32 uiNumPixels)
+  {
+    double fSumSquaredError = 0.0;
+
+    for (ezUInt32 i = 0; i < uiNumPixels; ++i)
+    {
+      for (ezUInt32 c = 0; c < 3; ++c)
+      {
+        const double fDiff = static_cast<double>(pSource[i].GetData()[c]) - static_cast<double>(pDecoded[i].GetData()[c]);
+        fSumSquaredError += fDiff * fDiff;
+      }
+    }
+
+    if (fSumSquaredError == 0.0)
+      return 100.0f;
+
+    return 10.0f * ezMath::Log10(static_cast<float>(255.0 * 255.0 * uiNumPixels * 3 / fSumSquaredError));
+  }
+} // namespace
+
+EZ_CREATE_SIMPLE_TEST(Image, BlockCompression)
+{
+  const ezBlockCompressionQuality::Enum qualities[] = {ezBlockCompressionQuality::Fast, ezBlockCompressionQuality::Normal, ezBlockCompressionQuality::High};
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "BC1")
+  {
+    for (auto quality : qualities)
+    {
+      for (ezUInt32 uiSeed = 0; uiSeed < 64; ++uiSeed)
+      {
+        ezColorBaseUB source[16];
+        FillBlock(uiSeed, source);
+
+        ezUInt8 block[8];
+        ezCompressBlockBC1(source, block, quality);
+
+        ezColorBaseUB decoded[16];
+        ezDecompressBlockBC1(block, decoded, false);
+
+        EZ_TEST_BOOL(ComputeRGBPSNR(source, decoded, 16) > 34.0f);
+      }
+    }
+
+    // pixels with low alpha make the block use the punch-through mode
+    ezColorBaseUB source[16];
+    FillBlock(0, source);
+    source[5].a = 0;
+
+    ezUInt8 block[8];
+    ezCompressBlockBC1(source, block, ezBlockCompressionQuality::Normal);
+
+    ezColorBaseUB decoded[16];
+    ezDecompressBlockBC1(block, decoded, false);
+
+    for (ezUInt32 i = 0; i < 16; ++i)
+    {
+      EZ_TEST_INT(decoded[i].a, i == 5 ? 0 : 255);
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "BC4")
+  {
+    for (auto quality : qualities)
+    {
+      for (ezUInt32 uiSeed = 0; uiSeed < 64; ++uiSeed)
+      {
+        ezColorBaseUB pixels[16];
+        FillBlock(uiSeed, pixels);
+
+        ezUInt8 source[16];
+        for (ezUInt32 i = 0; i < 16; ++i)
+        {
+          source[i] = pixels[i].r;
+        }
+
+        ezUInt8 block[8];
+        ezCompressBlockBC4(source, block, quality);
+
+        ezUInt8 decoded[16];
+        ezDecompressBlockBC4(block, decoded, 1, 0);
+
+        for (ezUInt32 i = 0; i < 16; ++i)
+        {
+          EZ_TEST_BOOL_MSG(ezMath::Abs(static_cast<ezInt32>(source[i]) - static_cast<ezInt32>(decoded[i])) <= 8, "Value {} decoded as {}", source[i], decoded[i]);
+        }
+      }
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "BC6H")
+  {
+    for (auto quality : qualities)
+    {
+      // BC6H interpolates the bit patterns of half floats, which is only linear while the exponent stays the same
+      ezColor source[16];
+      for (ezUInt32 i = 0; i < 16; ++i)
+      {
+        source[i] = ezColor(1.0f + i / 16.0f, 2.0f, 7.75f - i * 0.25f, 1.0f);
+      }
+
+      ezUInt8 block[16];
+      ezCompressBlockBC6(source, block, quality);
+
+      ezColorLinear16f decoded[16];
+      ezDecompressBlockBC6(block, decoded, false);
+
+      for (ezUInt32 i = 0; i < 16; ++i)
+      {
+        EZ_TEST_FLOAT(decoded[i].r, source[i].r, source[i].r * 0.02f);
+        EZ_TEST_FLOAT(decoded[i].g, source[i].g, source[i].g * 0.02f);
+        EZ_TEST_FLOAT(decoded[i].b, source[i].b, source[i].b * 0.02f);
+      }
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "BC7")
+  {
+    for (auto quality : qualities)
+    {
+      for (ezUInt32 uiSeed = 0; uiSeed < 64; ++uiSeed)
+      {
+        ezColorBaseUB source[16];
+        FillBlock(uiSeed, source);
+
+        ezUInt8 block[16];
+        ezCompressBlockBC7(source, block, quality);
+
+        ezColorBaseUB decoded[16];
+        ezDecompressBlockBC7(block, decoded);
+
+        EZ_TEST_BOOL(ComputeRGBPSNR(source, decoded, 16) > 40.0f);
+
+        for (ezUInt32 i = 0; i < 16; ++i)
+        {
+          EZ_TEST_BOOL_MSG(ezMath::Abs(static_cast<ezInt32>(source[i].a) - static_cast<ezInt32>(decoded[i].a)) <= 8, "Alpha {} decoded as {}", source[i].a, decoded[i].a);
+        }
+      }
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "BC3 Image")
+  {
+    // BC3 has no reference images in the Image Conversion test, so round-trip a whole image through the conversion steps
+    ezImageHeader header;
+    header.SetImageFormat(ezImageFormat::R8G8B8A8_UNORM);
+    header.SetWidth(64);
+    header.SetHeight(64);
+
+    ezImage source;
+    source.ResetAndAlloc(header);
+
+    for (ezUInt32 blockY = 0; blockY < 16; ++blockY)
+    {
+      for (ezUInt32 blockX = 0; blockX < 16; ++blockX)
+      {
+        ezColorBaseUB pixels[16];
+        FillBlock(blockY * 16 + blockX, pixels);
+
+        for (ezUInt32 y = 0; y < 4; ++y)
+        {
+          ezMemoryUtils::Copy(source.GetPixelPointer<ezColorBaseUB>(0, 0, 0, 4 * blockX, 4 * blockY + y), pixels + 4 * y, 4);
+        }
+      }
+    }
+
+    ezImage compressed;
+    EZ_TEST_BOOL(ezImageConversion::Convert(source, compressed, ezImageFormat::BC3_UNORM).Succeeded());
+    EZ_TEST_INT(compressed.GetImageFormat(), ezImageFormat::BC3_UNORM);
+
+    ezImage decoded;
+    EZ_TEST_BOOL(ezImageConversion::Convert(compressed, decoded, ezImageFormat::R8G8B8A8_UNORM).Succeeded());
+
+    const ezColorBaseUB* pSource = source.GetPixelPointer<ezColorBaseUB>();
+    const ezColorBaseUB* pDecoded = decoded.GetPixelPointer<ezColorBaseUB>();
+
+    EZ_TEST_BOOL(ComputeRGBPSNR(pSource, pDecoded, 64 * 64) > 34.0f);
+
+    for (ezUInt32 i = 0; i < 64 * 64; ++i)
+    {
+      EZ_TEST_BOOL_MSG(ezMath::Abs(static_cast<ezInt32>(pSource[i].a) - static_cast<ezInt32>(pDecoded[i].a)) <= 8, "Alpha {} decoded as {}", pSource[i].a, pDecoded[i].a);
+    }
+  }
+
+  EZ_TEST_BLOCK(EZ_PERFORMANCE_TESTS_STATE, "Compress 2048x2048")
+  {
+    ezImageHeader header;
+    header.SetImageFormat(ezImageFormat::R8G8B8A8_UNORM);
+    header.SetWidth(2048);
+    header.SetHeight(2048);
+
+    ezImage source;
+    source.ResetAndAlloc(header);
+
+    for (ezUInt32 blockY = 0; blockY < 512; ++blockY)
+    {
+      for (ezUInt32 blockX = 0; blockX < 512; ++blockX)
+      {
+        ezColorBaseUB pixels[16];
+        FillBlock(blockY * 512 + blockX, pixels);
+
+        for (ezUInt32 y = 0; y < 4; ++y)
+        {
+          ezMemoryUtils::Copy(source.GetPixelPointer<ezColorBaseUB>(0, 0, 0, 4 * blockX, 4 * blockY + y), pixels + 4 * y, 4);
+        }
+      }
+    }
+
+    ezCVarInt* pQuality = static_cast<ezCVarInt*>(ezCVar::FindCVarByName("Texture.CompressionQuality"));
+    if (!EZ_TEST_BOOL(pQuality != nullptr))
+      return;
+
+    const int iPrevQuality = *pQuality;
+
+    const ezImageFormat::Enum formats[] = {ezImageFormat::BC1_UNORM, ezImageFormat::BC3_UNORM, ezImageFormat::BC7_UNORM};
+
+    for (auto format : formats)
+    {
+      for (auto quality : qualities)
+      {
+        *pQuality = quality;
+
+        ezStopwatch sw;
+
+        ezImage compressed;
+        if (!EZ_TEST_BOOL(ezImageConversion::Convert(source, compressed, format).Succeeded()))
+          continue;
+
+        const ezTime tCompress = sw.GetRunningTotal();
+
+        ezImage decoded;
+        if (!EZ_TEST_BOOL(ezImageConversion::Convert(compressed, decoded, ezImageFormat::R8G8B8A8_UNORM).Succeeded()))
+          continue;
+
+        const float fPSNR = ComputeRGBPSNR(source.GetPixelPointer<ezColorBaseUB>(), decoded.GetPixelPointer<ezColorBaseUB>(), 2048 * 2048);
+
+        ezLog::Info("[test]{0} quality {1}: {2}ms, {3} MPixel/s, {4} dB", ezImageFormat::GetName(format), static_cast<int>(quality),
+          ezArgF(tCompress.GetMilliseconds(), 1), ezArgF(4.0 / tCompress.GetSeconds(), 1), ezArgF(fPSNR, 2));
+      }
+    }
+
+    *pQuality = iPrevQuality;
+  }
+}
@@ -6,6 +6,7 @@
 #include <Foundation/IO/FileSystem/FileReader.h>
 #include <Foundation/IO/FileSystem/FileSystem.h>
 #include <Foundation/Memory/MemoryTracker.h>
+#include <Foundation/SimdMath/SimdTypes.h>
 #include <Texture/Image/Formats/BmpFileFormat.h>
 #include <Texture/Image/Formats/DdsFileFormat.h>
 #include <Texture/Image/Formats/ImageFileFormat.h>
@@ -14,6 +15,40 @@
 
 static const ezImageFormat::Enum defaultFormat = ezImageFormat::R32G32B32A32_FLOAT;
 
+/// \brief Whether the reference images of a format were created with the same encoder that is used on this platform.
+///
+/// The portable block compressor produces different blocks than DirectXTex and the SSE4.1 BC4/BC5 compressor,
+/// its quality is covered by the Image/BlockCompression test instead.
+static bool HasReferenceImages(ezImageFormat::Enum format)
+{
+  switch (format)
+  {
+    case ezImageFormat::BC3_UNORM:
+    case ezImageFormat::BC3_UNORM_SRGB:
+      return false;
+
+#if EZ_DISABLED(EZ_PLATFORM_WINDOWS_DESKTOP)
+    case ezImageFormat::BC1_UNORM:
+    case ezImageFormat::BC1_UNORM_SRGB:
+    case ezImageFormat::BC6H_UF16:
+    case ezImageFormat::BC7_UNORM:
+    case ezImageFormat::BC7_UNORM_SRGB:
+      return false;
+#endif
+
+#if EZ_SSE_LEVEL < EZ_SSE_41 || EZ_SIMD_IMPLEMENTATION != EZ_SIMD_IMPLEMENTATION_SSE
+    case ezImageFormat::BC4_UNORM:
+    case ezImageFormat::BC4_SNORM:
+    case ezImageFormat::BC5_UNORM:
+    case ezImageFormat::BC5_SNORM:
+      return false;
+#endif
+
+    default:
+      return true;
+  }
+}
+
 class ezImageConversionTest : public ezTestBaseClass
 {
 
@@ -44,6 +79,11 @@ private:
         continue;
       }
 
+      if (!HasReferenceImages(format))
+      {
+        continue;
+      }
+
       AddSubTest(name, i);
     }
   }
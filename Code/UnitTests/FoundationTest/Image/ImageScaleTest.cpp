@@ -0,0 +1,229 @@
+#include <FoundationTest/FoundationTestPCH.h>
+
+#include <Foundation/Time/Stopwatch.h>
+#include <Texture/Image/ImageFilter.h>
+#include <Texture/Image/ImageUtils.h>
+
+#define EZ_PERFORMANCE_TESTS_STATE ezTestBlock::DisabledNoWarning
+
+namespace
+{
+  void CreateImage(ezImage& image, ezUInt32 uiWidth, ezUInt32 uiHeight, ezUInt32 uiDepth, const ezColor& color)
+  {
+    ezImageHeader header;
+    header.SetImageFormat(ezImageFormat::R32G32B32A32_FLOAT);
+    header.SetWidth(uiWidth);
+    header.SetHeight(uiHeight);
+    header.SetDepth(uiDepth);
+    image.ResetAndAlloc(header);
+
+    for (ezColor& pixel : image.GetBlobPtr<ezColor>())
+    {
+      pixel = color;
+    }
+  }
+
+  bool AllPixelsEqual(const ezImageView& image, const ezColor& color)
+  {
+    for (const ezColor& pixel : image.GetBlobPtr<ezColor>())
+    {
+      if (!pixel.IsEqualRGBA(color, 0.0001f))
+        return false;
+    }
+
+    return true;
+  }
+
+  /// Stores the pixel coordinates in RGB, so every axis can be checked separately.
+  void CreateGradientImage(ezImage& image, ezUInt32 uiWidth, ezUInt32 uiHeight, ezUInt32 uiDepth)
+  {
+    CreateImage(image, uiWidth, uiHeight, uiDepth, ezColor::White);
+
+    for (ezUInt32 z = 0; z < uiDepth; ++z)
+    {
+      for (ezUInt32 y = 0; y < uiHeight; ++y)
+      {
+        for (ezUInt32 x = 0; x < uiWidth; ++x)
+        {
+          *image.GetPixelPointer<ezColor>(0, 0, 0, x, y, z) = ezColor((float)x, (float)y, (float)z, 1.0f);
+        }
+      }
+    }
+  }
+
+  void CreateCheckerboardImage(ezImage& image, ezUInt32 uiWidth, ezUInt32 uiHeight, ezUInt32 uiDepth)
+  {
+    CreateImage(image, uiWidth, uiHeight, uiDepth, ezColor::White);
+
+    for (ezUInt32 z = 0; z < uiDepth; ++z)
+    {
+      for (ezUInt32 y = 0; y < uiHeight; ++y)
+      {
+        for (ezUInt32 x = 0; x < uiWidth; ++x)
+        {
+          const float fValue = ((x + y + z) % 2 == 0) ? 0.0f : 1.0f;
+          *image.GetPixelPointer<ezColor>(0, 0, 0, x, y, z) = ezColor(fValue, fValue, fValue, 1.0f);
+        }
+      }
+    }
+  }
+
+  /// A symmetric filter reproduces a linear function exactly, as long as it doesn't reach over the border.
+  /// The destination pixel i lies at (i + 0.5) * src / dst in source space, the source pixel x stores x, which lies at x + 0.5.
+  float ExpectedGradientValue(ezUInt32 uiIndex, ezUInt32 uiSrcSize, ezUInt32 uiDstSize)
+  {
+    return (uiIndex + 0.5f) * uiSrcSize / uiDstSize - 0.5f;
+  }
+
+  bool IsGradientScaledCorrectly(const ezImageView& source, const ezImageView& target)
+  {
+    // skip the border pixels, those are influenced by the address mode
+    for (ezUInt32 z = 1; z + 1 < target.GetDepth(); ++z)
+    {
+      for (ezUInt32 y = 1; y + 1 < target.GetHeight(); ++y)
+      {
+        for (ezUInt32 x = 1; x + 1 < target.GetWidth(); ++x)
+        {
+          const ezColor expected(ExpectedGradientValue(x, source.GetWidth(), target.GetWidth()),
+            ExpectedGradientValue(y, source.GetHeight(), target.GetHeight()), ExpectedGradientValue(z, source.GetDepth(), target.GetDepth()), 1.0f);
+
+          if (!target.GetPixelPointer<ezColor>(0, 0, 0, x, y, z)->IsEqualRGBA(expected, 0.0001f))
+            return false;
+        }
+      }
+    }
+
+    return true;
+  }
+} // namespace
+
+EZ_CREATE_SIMPLE_TEST(Image, ImageScale)
+{
+  const ezColor color(0.25f, 0.5f, 1.0f, 0.75f);
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Scale")
+  {
+    ezImage source;
+    CreateImage(source, 512, 384, 1, color);
+
+    const ezImageFilterTriangle triangleFilter;
+    const ezImageFilterSincWithKaiserWindow sincFilter;
+    const ezImageFilter* filters[] = {&triangleFilter, &sincFilter};
+
+    for (const ezImageFilter* pFilter : filters)
+    {
+      ezImage target;
+      EZ_TEST_BOOL(ezImageUtils::Scale(source, target, 200, 97, pFilter).Succeeded());
+      EZ_TEST_INT(target.GetWidth(), 200);
+      EZ_TEST_INT(target.GetHeight(), 97);
+      EZ_TEST_BOOL(AllPixelsEqual(target, color));
+
+      EZ_TEST_BOOL(ezImageUtils::Scale(source, target, 1024, 700, pFilter).Succeeded());
+      EZ_TEST_BOOL(AllPixelsEqual(target, color));
+    }
+
+    // samples outside of the image use the border color
+    ezImage target;
+    EZ_TEST_BOOL(ezImageUtils::Scale(source, target, 512, 100, &sincFilter, ezImageAddressMode::ClampBorder, ezImageAddressMode::ClampBorder, color).Succeeded());
+    EZ_TEST_BOOL(AllPixelsEqual(target, color));
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Scale3D")
+  {
+    ezImage source;
+    CreateImage(source, 64, 32, 16, color);
+
+    ezImage target;
+    EZ_TEST_BOOL(ezImageUtils::Scale3D(source, target, 32, 48, 5).Succeeded());
+    EZ_TEST_INT(target.GetWidth(), 32);
+    EZ_TEST_INT(target.GetHeight(), 48);
+    EZ_TEST_INT(target.GetDepth(), 5);
+    EZ_TEST_BOOL(AllPixelsEqual(target, color));
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Scale3D Gradient")
+  {
+    ezImage source;
+    CreateGradientImage(source, 16, 6, 8);
+
+    const ezImageFilterTriangle triangleFilter;
+
+    // every axis is scaled differently, so mixing up rows and slices is detected
+    ezImage target;
+    EZ_TEST_BOOL(ezImageUtils::Scale3D(source, target, 8, 12, 8, &triangleFilter).Succeeded());
+    EZ_TEST_BOOL(IsGradientScaledCorrectly(source, target));
+
+    EZ_TEST_BOOL(ezImageUtils::Scale3D(source, target, 32, 3, 4, &triangleFilter).Succeeded());
+    EZ_TEST_BOOL(IsGradientScaledCorrectly(source, target));
+
+    // the triangle filter averages the two middle source pixels with 0.375 and the outer ones with 0.125
+    EZ_TEST_BOOL(ezImageUtils::Scale3D(source, target, 8, 3, 4, &triangleFilter).Succeeded());
+    EZ_TEST_BOOL(target.GetPixelPointer<ezColor>(0, 0, 0, 1, 1, 1)->IsEqualRGBA(ezColor(2.5f, 2.5f, 2.5f, 1.0f), 0.0001f));
+    EZ_TEST_BOOL(IsGradientScaledCorrectly(source, target));
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Scale3D Checkerboard")
+  {
+    ezImage source;
+    CreateCheckerboardImage(source, 32, 16, 8);
+
+    // halving a repeating checkerboard weights both colors equally with any symmetric filter
+    const ezImageFilterTriangle triangleFilter;
+    const ezImageFilterSincWithKaiserWindow sincFilter;
+    const ezImageFilter* filters[] = {&triangleFilter, &sincFilter};
+
+    for (const ezImageFilter* pFilter : filters)
+    {
+      ezImage target;
+      EZ_TEST_BOOL(ezImageUtils::Scale3D(source, target, 16, 8, 4, pFilter, ezImageAddressMode::Repeat, ezImageAddressMode::Repeat, ezImageAddressMode::Repeat).Succeeded());
+      EZ_TEST_BOOL(AllPixelsEqual(target, ezColor(0.5f, 0.5f, 0.5f, 1.0f)));
+
+      // scaling only one axis must not touch the pattern along the others
+      EZ_TEST_BOOL(ezImageUtils::Scale3D(source, target, 32, 16, 4, pFilter, ezImageAddressMode::Repeat, ezImageAddressMode::Repeat, ezImageAddressMode::Repeat).Succeeded());
+      EZ_TEST_BOOL(AllPixelsEqual(target, ezColor(0.5f, 0.5f, 0.5f, 1.0f)));
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "GenerateMipMaps")
+  {
+    ezImage source;
+    CreateImage(source, 300, 128, 1, color);
+
+    ezImage target;
+    ezImageUtils::GenerateMipMaps(source, target, ezImageUtils::MipMapOptions());
+
+    EZ_TEST_INT(target.GetNumMipLevels(), 9);
+    EZ_TEST_INT(target.GetWidth(8), 1);
+    EZ_TEST_BOOL(AllPixelsEqual(target, color));
+  }
+
+  EZ_TEST_BLOCK(EZ_PERFORMANCE_TESTS_STATE, "GenerateMipMaps 4k/8k/16k")
+  {
+#if EZ_ENABLED(EZ_PLATFORM_64BIT)
+    const ezUInt32 sizes[] = {4096, 8192, 16384};
+#else
+    const ezUInt32 sizes[] = {4096};
+#endif
+
+    for (ezUInt32 uiSize : sizes)
+    {
+      ezImage source;
+      CreateImage(source, uiSize, uiSize, 1, color);
+
+      ezStopwatch sw;
+
+      ezImage halfSize;
+      ezImageUtils::Scale(source, halfSize, uiSize / 2, uiSize / 2, nullptr).IgnoreResult();
+
+      const ezTime tScale = sw.Checkpoint();
+
+      ezImage mipMaps;
+      ezImageUtils::GenerateMipMaps(source, mipMaps, ezImageUtils::MipMapOptions());
+
+      const ezTime tMipMaps = sw.Checkpoint();
+
+      ezLog::Info("[test]{0}x{0}: Scale to half size {1}ms, GenerateMipMaps {2}ms ({3} MPixel/s)", uiSize, ezArgF(tScale.GetMilliseconds(), 1),
+        ezArgF(tMipMaps.GetMilliseconds(), 1), ezArgF(static_cast<double>(uiSize) * uiSize / tMipMaps.GetSeconds() / 1000000.0, 1));
+    }
+  }
+}
@@ -0,0 +1,183 @@
+#include <FoundationTest/FoundationTestPCH.h>
+
+#include <Foundation/IO/OSFile.h>
+#include <Texture/TexConv/TexConvCache.h>
+
+#if EZ_ENABLED(EZ_SUPPORTS_FILE_ITERATORS) && EZ_ENABLED(EZ_SUPPORTS_FILE_STATS)
+
+namespace
+{
+  void CreateImage(ezUInt32 uiSize, ezUInt8 uiValue, ezImage& out_Image)
+  {
+    ezImageHeader header;
+    header.SetImageFormat(ezImageFormat::R8G8B8A8_UNORM);
+    header.SetWidth(uiSize);
+    header.SetHeight(uiSize);
+    header.SetNumMipLevels(2);
+
+    out_Image.ResetAndAlloc(header);
+    ezMemoryUtils::PatternFill(out_Image.GetByteBlobPtr().GetPtr(), uiValue, static_cast<ezUInt32>(out_Image.GetByteBlobPtr().GetCount()));
+  }
+} // namespace
+
+EZ_CREATE_SIMPLE_TEST(Image, TexConvCache)
+{
+  ezStringBuilder sCacheDir = ezTestFramework::GetInstance()->GetAbsOutputPath();
+  sCacheDir.AppendPath("TexConvCache");
+
+  ezOSFile::DeleteFolder(sCacheDir).IgnoreResult();
+
+  ezTexConvCache cache;
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Disabled")
+  {
+    ezImage img;
+    CreateImage(16, 1, img);
+
+    cache.Store(ezTexConvCacheStage::Output, 1, img);
+    EZ_TEST_BOOL(!cache.Load(ezTexConvCacheStage::Output, 1, img));
+    EZ_TEST_INT(cache.GetStatistics().m_uiMisses[ezTexConvCacheStage::Output], 0);
+  }
+
+  cache.SetCacheDirectory(sCacheDir);
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Store and Load")
+  {
+    ezImage img;
+    CreateImage(16, 42, img);
+
+    EZ_TEST_BOOL(!cache.Load(ezTexConvCacheStage::Mipmaps, 0x1234, img));
+    cache.Store(ezTexConvCacheStage::Mipmaps, 0x1234, img);
+
+    ezImage loaded;
+    EZ_TEST_BOOL(cache.Load(ezTexConvCacheStage::Mipmaps, 0x1234, loaded));
+    EZ_TEST_INT(loaded.GetImageFormat(), ezImageFormat::R8G8B8A8_UNORM);
+    EZ_TEST_INT(loaded.GetWidth(), 16);
+    EZ_TEST_INT(loaded.GetHeight(), 16);
+    EZ_TEST_INT(loaded.GetNumMipLevels(), 2);
+    EZ_TEST_INT(loaded.GetByteBlobPtr().GetCount(), img.GetByteBlobPtr().GetCount());
+    EZ_TEST_BOOL(ezMemoryUtils::IsEqual(loaded.GetByteBlobPtr().GetPtr(), img.GetByteBlobPtr().GetPtr(), static_cast<size_t>(img.GetByteBlobPtr().GetCount())));
+
+    // the stage is part of the key
+    EZ_TEST_BOOL(!cache.Load(ezTexConvCacheStage::Output, 0x1234, loaded));
+
+    const ezTexConvCacheStatistics& stats = cache.GetStatistics();
+    EZ_TEST_INT(stats.m_uiHits[ezTexConvCacheStage::Mipmaps], 1);
+    EZ_TEST_INT(stats.m_uiMisses[ezTexConvCacheStage::Mipmaps], 1);
+    EZ_TEST_INT(stats.m_uiMisses[ezTexConvCacheStage::Output], 1);
+    EZ_TEST_BOOL(stats.m_uiBytesWritten > img.GetByteBlobPtr().GetCount());
+    EZ_TEST_INT(stats.m_uiBytesRead, stats.m_uiBytesWritten);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Size Limit")
+  {
+    cache.ResetStatistics();
+
+    ezImage img;
+    CreateImage(64, 7, img);
+
+    cache.Store(ezTexConvCacheStage::Assembled, 1, img);
+    cache.Store(ezTexConvCacheStage::Assembled, 2, img);
+    cache.Store(ezTexConvCacheStage::Assembled, 3, img);
+
+    // room for roughly two of the large entries
+    cache.SetSizeLimit(cache.GetStatistics().m_uiBytesWritten * 2 / 3 + 1024);
+    cache.EnforceSizeLimit();
+
+    EZ_TEST_BOOL(cache.GetStatistics().m_uiEvictedEntries >= 1);
+
+    ezUInt32 uiRemaining = 0;
+    for (ezUInt64 uiKey = 1; uiKey <= 3; ++uiKey)
+    {
+      ezImage loaded;
+      uiRemaining += cache.Load(ezTexConvCacheStage::Assembled, uiKey, loaded) ? 1 : 0;
+    }
+
+    EZ_TEST_INT(uiRemaining + cache.GetStatistics().m_uiEvictedEntries, 3);
+
+    cache.SetSizeLimit(0);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Least Recently Used")
+  {
+    ezOSFile::DeleteFolder(sCacheDir).IgnoreResult();
+    cache.ResetStatistics();
+
+    ezImage img;
+    CreateImage(64, 9, img);
+
+    cache.Store(ezTexConvCacheStage::Output, 1, img);
+    cache.Store(ezTexConvCacheStage::Output, 2, img);
+    cache.Store(ezTexConvCacheStage::Output, 3, img);
+    cache.EnforceSizeLimit();
+
+    const ezUInt64 uiEntrySize = cache.GetStatistics().m_uiBytesWritten / 3;
+
+    // the oldest entry is read again, in a new session
+    {
+      ezTexConvCache cache2;
+      cache2.SetCacheDirectory(sCacheDir);
+
+      ezImage loaded;
+      EZ_TEST_BOOL(cache2.Load(ezTexConvCacheStage::Output, 1, loaded));
+
+      // room for two entries
+      cache2.SetSizeLimit(uiEntrySize * 2 + uiEntrySize / 2);
+      cache2.EnforceSizeLimit();
+
+      EZ_TEST_INT(cache2.GetStatistics().m_uiEvictedEntries, 1);
+    }
+
+    // the least recently used entry was evicted, not the least recently written one
+    ezImage loaded;
+    EZ_TEST_BOOL(cache.Load(ezTexConvCacheStage::Output, 1, loaded));
+    EZ_TEST_BOOL(!cache.Load(ezTexConvCacheStage::Output, 2, loaded));
+    EZ_TEST_BOOL(cache.Load(ezTexConvCacheStage::Output, 3, loaded));
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Interrupted Writes")
+  {
+    ezOSFile::DeleteFolder(sCacheDir).IgnoreResult();
+    cache.ResetStatistics();
+
+    ezImage img;
+    CreateImage(64, 11, img);
+
+    cache.Store(ezTexConvCacheStage::Output, 1, img);
+
+    ezStringBuilder sEntry, sTemp;
+    sEntry = sCacheDir;
+    sEntry.AppendPath("Output-0000000000000001.ezTexConvCache");
+    sTemp = sEntry;
+    sTemp.ChangeFileExtension("ezTexConvCacheTmp");
+
+    // entries are written to a temp file first, which is renamed once it is complete
+    EZ_TEST_BOOL(ezOSFile::ExistsFile(sEntry));
+    EZ_TEST_BOOL(!ezOSFile::ExistsFile(sTemp));
+
+    // what a run leaves behind when it is interrupted while writing entry 2
+    sTemp = sCacheDir;
+    sTemp.AppendPath("Output-0000000000000002.ezTexConvCacheTmp");
+    {
+      ezOSFile file;
+      EZ_TEST_BOOL(file.Open(sTemp, ezFileOpenMode::Write).Succeeded());
+      EZ_TEST_BOOL(file.Write(img.GetByteBlobPtr().GetPtr(), 1024).Succeeded());
+    }
+
+    ezImage loaded;
+    EZ_TEST_BOOL(!cache.Load(ezTexConvCacheStage::Output, 2, loaded));
+
+    // the leftover is evicted before any real entry
+    cache.SetSizeLimit(cache.GetStatistics().m_uiBytesWritten + 512);
+    cache.EnforceSizeLimit();
+    cache.SetSizeLimit(0);
+
+    EZ_TEST_INT(cache.GetStatistics().m_uiEvictedEntries, 1);
+    EZ_TEST_BOOL(!ezOSFile::ExistsFile(sTemp));
+    EZ_TEST_BOOL(cache.Load(ezTexConvCacheStage::Output, 1, loaded));
+  }
+
+  ezOSFile::DeleteFolder(sCacheDir).IgnoreResult();
+}
+
+#endif
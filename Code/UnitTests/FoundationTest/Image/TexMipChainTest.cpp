@@ -0,0 +1,76 @@
+#include <FoundationTest/FoundationTestPCH.h>
+
+#include <Foundation/IO/MemoryStream.h>
+#include <Texture/ezTexFormat/ezTexMipChain.h>
+
+EZ_CREATE_SIMPLE_TEST(Image, TexMipChain)
+{
+  ezImageHeader header;
+  header.SetImageFormat(ezImageFormat::R8G8B8A8_UNORM);
+  header.SetWidth(64);
+  header.SetHeight(32);
+  header.SetNumMipLevels(header.ComputeNumberOfMipMaps());
+
+  ezImage image;
+  image.ResetAndAlloc(header);
+
+  // every mip gets its own fill value, so that mixed up mips are detected
+  for (ezUInt32 mip = 0; mip < image.GetNumMipLevels(); ++mip)
+  {
+    ezByteBlobPtr data = image.GetSubImageView(mip).GetByteBlobPtr();
+    ezMemoryUtils::PatternFill(data.GetPtr(), static_cast<ezUInt8>(mip + 1), static_cast<ezUInt32>(data.GetCount()));
+  }
+
+  ezMemoryStreamStorage storage;
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "WriteImage")
+  {
+    ezMemoryStreamWriter writer(&storage);
+    EZ_TEST_BOOL(ezTexMipChain::WriteImage(writer, image).Succeeded());
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "ReadHeader")
+  {
+    ezMemoryStreamReader reader(&storage);
+
+    ezTexMipChain mipChain;
+    EZ_TEST_BOOL(mipChain.ReadHeader(reader).Succeeded());
+    EZ_TEST_INT(mipChain.GetNumMipLevels(), 7);
+    EZ_TEST_INT(mipChain.m_Header.GetWidth(), 64);
+    EZ_TEST_INT(mipChain.m_Header.GetHeight(), 32);
+    EZ_TEST_INT(mipChain.GetDataSize(7), image.GetByteBlobPtr().GetCount());
+
+    // smallest mip first
+    EZ_TEST_INT(mipChain.m_MipLevels[6].m_uiOffset, 0);
+    EZ_TEST_INT(mipChain.m_MipLevels[0].m_uiOffset, mipChain.GetDataSize(6));
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "ReadMipLevels")
+  {
+    for (ezUInt32 uiNumMipLevels = 1; uiNumMipLevels <= 7; ++uiNumMipLevels)
+    {
+      ezMemoryStreamReader reader(&storage);
+
+      ezTexMipChain mipChain;
+      EZ_TEST_BOOL(mipChain.ReadHeader(reader).Succeeded());
+
+      ezImage loaded;
+      EZ_TEST_BOOL(mipChain.ReadMipLevels(reader, uiNumMipLevels, loaded).Succeeded());
+
+      const ezUInt32 uiFirstMipLevel = 7 - uiNumMipLevels;
+
+      EZ_TEST_INT(loaded.GetNumMipLevels(), uiNumMipLevels);
+      EZ_TEST_INT(loaded.GetWidth(), image.GetWidth(uiFirstMipLevel));
+      EZ_TEST_INT(loaded.GetHeight(), image.GetHeight(uiFirstMipLevel));
+
+      for (ezUInt32 mip = 0; mip < uiNumMipLevels; ++mip)
+      {
+        ezConstByteBlobPtr expected = image.GetSubImageView(uiFirstMipLevel + mip).GetByteBlobPtr();
+        ezConstByteBlobPtr actual = loaded.GetSubImageView(mip).GetByteBlobPtr();
+
+        EZ_TEST_INT(actual.GetCount(), expected.GetCount());
+        EZ_TEST_BOOL(ezMemoryUtils::IsEqual(actual.GetPtr(), expected.GetPtr(), static_cast<size_t>(expected.GetCount())));
+      }
+    }
+  }
+}
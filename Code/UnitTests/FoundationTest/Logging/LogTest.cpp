@@ -7,8 +7,14 @@
 #include <Foundation/Logging/Log.h>
 #include <Foundation/Logging/VisualStudioWriter.h>
 #include <Foundation/Threading/Thread.h>
+#include <Foundation/Threading/ThreadUtils.h>
+#include <Foundation/Time/Stopwatch.h>
+#include <Foundation/Types/UniquePtr.h>
+#include <Foundation/Utilities/ConversionUtils.h>
 #include <TestFramework/Utilities/TestLogInterface.h>
 
+#define EZ_PERFORMANCE_TESTS_STATE ezTestBlock::DisabledNoWarning
+
 EZ_CREATE_SIMPLE_TEST_GROUP(Logging);
 
 namespace
@@ -254,3 +260,198 @@ EZ_CREATE_SIMPLE_TEST(Logging, GlobalTestLog)
     }
   }
 }
+
+namespace
+{
+  /// Collects the messages with a specific tag, which may arrive on any thread.
+  struct AsyncLogCollector
+  {
+    AsyncLogCollector(const char* szTag)
+      : m_szTag(szTag)
+    {
+      m_SubscriptionID = ezGlobalLog::AddLogWriter(ezMakeDelegate(&AsyncLogCollector::LogMessageHandler, this));
+    }
+
+    ~AsyncLogCollector() { ezGlobalLog::RemoveLogWriter(m_SubscriptionID); }
+
+    void LogMessageHandler(const ezLoggingEventData& le)
+    {
+      if (!ezStringUtils::IsEqual(le.m_szTag, m_szTag))
+        return;
+
+      EZ_LOCK(m_Mutex);
+
+      if (le.m_EventType == ezLogMsgType::BeginGroup)
+        ++m_uiNumGroupsBegun;
+      else if (le.m_EventType == ezLogMsgType::EndGroup)
+        ++m_uiNumGroupsEnded;
+      else
+        m_Messages.PushBack(le.m_szText);
+
+      if (m_SimulatedWriteTime.IsPositive())
+        ezThreadUtils::Sleep(m_SimulatedWriteTime);
+    }
+
+    const char* m_szTag;
+    ezEventSubscriptionID m_SubscriptionID;
+    ezMutex m_Mutex;
+    ezDynamicArray<ezString> m_Messages;
+    ezUInt32 m_uiNumGroupsBegun = 0;
+    ezUInt32 m_uiNumGroupsEnded = 0;
+    ezTime m_SimulatedWriteTime;
+  };
+
+  class AsyncLogThread : public ezThread
+  {
+  public:
+    ezUInt32 m_uiThreadIndex = 0;
+    ezUInt32 m_uiNumMessages = 0;
+    bool m_bUseGroups = false;
+
+    virtual ezUInt32 Run() override
+    {
+      // new threads always log to ezGlobalLog
+      ezLog::GetThreadLocalLogSystem()->SetLogLevel(ezLogMsgType::All);
+
+      for (ezUInt32 i = 0; i < m_uiNumMessages; ++i)
+      {
+        if (m_bUseGroups && i % 10 == 0)
+        {
+          EZ_LOG_BLOCK("Group", "AsyncTest");
+          ezLog::Info("[AsyncTest]{} {} Message inside of a group, long enough to fill the buffer quickly", m_uiThreadIndex, i);
+        }
+        else
+        {
+          ezLog::Info("[AsyncTest]{} {}", m_uiThreadIndex, i);
+        }
+      }
+
+      return 0;
+    }
+  };
+} // namespace
+
+EZ_CREATE_SIMPLE_TEST(Logging, AsyncLog)
+{
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Order")
+  {
+    AsyncLogCollector collector("AsyncTest");
+
+    ezGlobalLog::SetAsyncMode(true);
+    EZ_TEST_BOOL(ezGlobalLog::IsAsyncModeEnabled());
+
+    const ezUInt64 uiDroppedBefore = ezGlobalLog::GetNumDroppedMessages();
+
+    AsyncLogThread threads[4];
+    for (ezUInt32 i = 0; i < EZ_ARRAY_SIZE(threads); ++i)
+    {
+      threads[i].m_uiThreadIndex = i;
+      threads[i].m_uiNumMessages = 200;
+      threads[i].Start();
+    }
+
+    for (ezUInt32 i = 0; i < EZ_ARRAY_SIZE(threads); ++i)
+    {
+      threads[i].Join();
+    }
+
+    ezGlobalLog::WaitForAsyncMessages();
+
+    {
+      EZ_LOCK(collector.m_Mutex);
+      EZ_TEST_INT(collector.m_Messages.GetCount() + (ezGlobalLog::GetNumDroppedMessages() - uiDroppedBefore), 4 * 200);
+
+      // the messages of each thread arrive in the order in which they were logged
+      ezUInt32 uiNextMessage[4] = {};
+      bool bInOrder = true;
+
+      for (const ezString& sMessage : collector.m_Messages)
+      {
+        ezUInt32 uiThread = 0, uiMessage = 0;
+        const char* szEnd = nullptr;
+        ezConversionUtils::StringToUInt(sMessage, uiThread, &szEnd).IgnoreResult();
+        ezConversionUtils::StringToUInt(szEnd, uiMessage).IgnoreResult();
+
+        bInOrder &= uiThread < 4 && uiMessage >= uiNextMessage[uiThread];
+        uiNextMessage[uiThread] = uiMessage + 1;
+      }
+
+      EZ_TEST_BOOL(bInOrder);
+    }
+
+    ezGlobalLog::SetAsyncMode(false);
+    EZ_TEST_BOOL(!ezGlobalLog::IsAsyncModeEnabled());
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Dropped Messages")
+  {
+    AsyncLogCollector collector("AsyncTest");
+    collector.m_SimulatedWriteTime = ezTime::Microseconds(50);
+
+    // the smallest buffer and a slow writer, to make sure that messages are dropped
+    ezGlobalLog::SetAsyncMode(true, 1024);
+
+    const ezUInt64 uiDroppedBefore = ezGlobalLog::GetNumDroppedMessages();
+
+    AsyncLogThread thread;
+    thread.m_uiNumMessages = 5000;
+    thread.m_bUseGroups = true;
+    thread.Start();
+    thread.Join();
+
+    // waits for all messages, unlike WaitForAsyncMessages() there is no way to skip this
+    ezGlobalLog::SetAsyncMode(false);
+
+    const ezUInt64 uiNumDropped = ezGlobalLog::GetNumDroppedMessages() - uiDroppedBefore;
+    EZ_TEST_BOOL(uiNumDropped > 0);
+
+    // a group is either dropped completely, or its end is delivered as well
+    EZ_TEST_INT(collector.m_uiNumGroupsBegun, collector.m_uiNumGroupsEnded);
+
+    // the end messages of dropped groups are not counted as dropped
+    const ezUInt64 uiNumDelivered = collector.m_Messages.GetCount() + collector.m_uiNumGroupsBegun * 2;
+    EZ_TEST_BOOL(uiNumDelivered + uiNumDropped <= 5000 + 500 * 2);
+    EZ_TEST_BOOL(uiNumDelivered + uiNumDropped * 2 >= 5000 + 500 * 2);
+  }
+
+  EZ_TEST_BLOCK(EZ_PERFORMANCE_TESTS_STATE, "Log Calls per Second")
+  {
+    const ezUInt32 uiNumMessages = 20000;
+
+    for (ezUInt32 uiNumThreads : {1, 4, 8})
+    {
+      for (bool bAsync : {false, true})
+      {
+        AsyncLogCollector collector("AsyncTest");
+
+        // a writer that regularly blocks, like a file writer
+        collector.m_SimulatedWriteTime = ezTime::Microseconds(2);
+
+        ezGlobalLog::SetAsyncMode(bAsync, 1024 * 1024);
+
+        ezDynamicArray<ezUniquePtr<AsyncLogThread>> threads;
+        for (ezUInt32 i = 0; i < uiNumThreads; ++i)
+        {
+          threads.PushBack(EZ_DEFAULT_NEW(AsyncLogThread));
+          threads.PeekBack()->m_uiThreadIndex = i;
+          threads.PeekBack()->m_uiNumMessages = uiNumMessages;
+        }
+
+        ezStopwatch sw;
+
+        for (auto& pThread : threads)
+          pThread->Start();
+
+        for (auto& pThread : threads)
+          pThread->Join();
+
+        const ezTime tLogging = sw.GetRunningTotal();
+
+        ezGlobalLog::SetAsyncMode(false);
+
+        ezLog::Info("[test]{} threads, {}: {} log calls per second ({} dropped)", uiNumThreads, bAsync ? "async" : "sync",
+          ezArgF(uiNumThreads * uiNumMessages / tLogging.GetSeconds(), 0), ezGlobalLog::GetNumDroppedMessages());
+      }
+    }
+  }
+}
@@ -1,8 +1,14 @@
 #include <FoundationTest/FoundationTestPCH.h>
 
+#include <Foundation/IO/MemoryStream.h>
 #include <Foundation/Memory/CommonAllocators.h>
 #include <Foundation/Memory/LargeBlockAllocator.h>
 #include <Foundation/Memory/StackAllocator.h>
+#include <Foundation/Threading/Thread.h>
+#include <Foundation/Time/Stopwatch.h>
+#include <Foundation/Types/UniquePtr.h>
+
+#define EZ_PERFORMANCE_TESTS_STATE ezTestBlock::DisabledNoWarning
 
 struct EZ_ALIGN(NonAlignedVector, EZ_ALIGNMENT_MINIMUM)
 {
@@ -75,6 +81,118 @@ void TestAlignmentHelper(size_t uiExpectedAlignment)
   EZ_TEST_BOOL(stats.m_uiNumAllocations - stats.m_uiNumDeallocations == 0);
 }
 
+namespace
+{
+  typedef ezAllocator<ezMemoryPolicies::ezThreadCachingAllocation, ezMemoryTrackingFlags::None> ezUntrackedThreadCachingAllocator;
+  typedef ezAllocator<ezMemoryPolicies::ezHeapAllocation, ezMemoryTrackingFlags::RegisterAllocator | ezMemoryTrackingFlags::EnableSampling>
+    ezSampledHeapAllocator;
+
+  /// Frees the given allocations and then allocates new ones, so that both directions of cross-thread frees are tested.
+  class ThreadCachingTestThread : public ezThread
+  {
+  public:
+    ThreadCachingTestThread(ezAllocatorBase* pAllocator)
+      : ezThread("Allocator Test Thread")
+      , m_pAllocator(pAllocator)
+    {
+    }
+
+    ezAllocatorBase* m_pAllocator;
+    ezDynamicArray<void*> m_ToFree;
+    ezDynamicArray<void*> m_Allocated;
+    ezUInt32 m_uiNumToAllocate = 0;
+
+    virtual ezUInt32 Run()
+    {
+      for (void* ptr : m_ToFree)
+      {
+        m_pAllocator->Deallocate(ptr);
+      }
+
+      for (ezUInt32 i = 0; i < m_uiNumToAllocate; ++i)
+      {
+        const size_t uiSize = 8 + (i * 24) % 1000;
+        void* ptr = m_pAllocator->Allocate(uiSize, 8);
+        ezMemoryUtils::PatternFill(static_cast<ezUInt8*>(ptr), 0xAB, uiSize);
+        m_Allocated.PushBack(ptr);
+      }
+
+      return 0;
+    }
+  };
+
+  /// Keeps a window of live allocations of mixed sizes, some of which are freed by the neighboring thread.
+  class AllocatorBenchmarkThread : public ezThread
+  {
+  public:
+    AllocatorBenchmarkThread(ezAllocatorBase* pAllocator, ezUInt32 uiSeed)
+      : ezThread("Allocator Benchmark Thread")
+      , m_pAllocator(pAllocator)
+      , m_uiSeed(uiSeed)
+    {
+    }
+
+    ezAllocatorBase* m_pAllocator;
+    ezUInt32 m_uiSeed;
+    ezUInt32 m_uiNumIterations = 0;
+    ezDynamicArray<void*> m_Remaining;
+
+    virtual ezUInt32 Run()
+    {
+      constexpr ezUInt32 uiWindowSize = 256;
+      void* live[uiWindowSize] = {};
+
+      ezUInt32 uiRandom = m_uiSeed;
+      for (ezUInt32 i = 0; i < m_uiNumIterations; ++i)
+      {
+        uiRandom = uiRandom * 1664525u + 1013904223u;
+
+        const ezUInt32 uiSlot = i % uiWindowSize;
+        m_pAllocator->Deallocate(live[uiSlot]);
+
+        // mostly small allocations, like strings and container nodes
+        const size_t uiSize = (uiRandom >> 24) < 240 ? 8 + (uiRandom >> 16) % 256 : 256 + (uiRandom >> 8) % 4096;
+        live[uiSlot] = m_pAllocator->Allocate(uiSize, 8);
+        static_cast<ezUInt8*>(live[uiSlot])[0] = 1;
+      }
+
+      m_Remaining.SetCount(uiWindowSize);
+      ezMemoryUtils::Copy(m_Remaining.GetData(), live, uiWindowSize);
+      return 0;
+    }
+  };
+
+  ezTime RunAllocatorBenchmark(ezAllocatorBase* pAllocator, ezUInt32 uiNumThreads, ezUInt32 uiNumIterations)
+  {
+    ezDynamicArray<ezUniquePtr<AllocatorBenchmarkThread>> threads;
+
+    for (ezUInt32 i = 0; i < uiNumThreads; ++i)
+    {
+      threads.PushBack(EZ_DEFAULT_NEW(AllocatorBenchmarkThread, pAllocator, i + 1));
+      threads.PeekBack()->m_uiNumIterations = uiNumIterations;
+    }
+
+    ezStopwatch sw;
+
+    for (auto& pThread : threads)
+      pThread->Start();
+
+    for (auto& pThread : threads)
+      pThread->Join();
+
+    // the remaining allocations are freed by another thread
+    for (ezUInt32 i = 0; i < uiNumThreads; ++i)
+    {
+      for (void* ptr : threads[(i + 1) % uiNumThreads]->m_Remaining)
+      {
+        pAllocator->Deallocate(ptr);
+      }
+    }
+
+    return sw.GetRunningTotal();
+  }
+} // namespace
+
 EZ_CREATE_SIMPLE_TEST_GROUP(Memory);
 
 EZ_CREATE_SIMPLE_TEST(Memory, Allocator)
@@ -235,4 +353,195 @@ EZ_CREATE_SIMPLE_TEST(Memory, Allocator)
 
     EZ_TEST_BOOL(ezConstructionCounter::HasDestructed(50));
   }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "ThreadCachingAllocator")
+  {
+    ezUntrackedThreadCachingAllocator allocator("ThreadCachingTest");
+
+    ezDynamicArray<void*> allocations;
+
+    // all size classes, the largest small size and large allocations
+    for (size_t uiSize = 1; uiSize <= 20000; uiSize += 1 + uiSize / 8)
+    {
+      void* ptr = allocator.Allocate(uiSize, 8);
+      EZ_TEST_BOOL(ptr != nullptr);
+      EZ_TEST_BOOL(ezMemoryUtils::IsAligned(ptr, 16));
+      ezMemoryUtils::PatternFill(static_cast<ezUInt8*>(ptr), static_cast<ezUInt8>(uiSize), uiSize);
+      allocations.PushBack(ptr);
+    }
+
+    void* pAligned = allocator.Allocate(100, 64);
+    EZ_TEST_BOOL(ezMemoryUtils::IsAligned(pAligned, 64));
+    allocations.PushBack(pAligned);
+
+    // enough allocations of one size class to need multiple spans
+    for (ezUInt32 i = 0; i < 5000; ++i)
+    {
+      allocations.PushBack(allocator.Allocate(48, 16));
+    }
+
+    ezAllocatorBase::Stats stats = allocator.GetStats();
+    EZ_TEST_INT(stats.m_uiNumAllocations - stats.m_uiNumDeallocations, allocations.GetCount());
+    EZ_TEST_BOOL(stats.m_uiAllocationSize > 5000 * 48);
+    EZ_TEST_BOOL(stats.m_uiReservedSize >= 5000 * 48);
+    EZ_TEST_BOOL(stats.m_uiReservedSize % ezMemoryPolicies::ezThreadCachingAllocation::SpanSize == 0);
+
+    // memory that was written to is not modified by other allocations
+    bool bPatternIntact = true;
+    ezUInt32 uiIndex = 0;
+    for (size_t uiSize = 1; uiSize <= 20000; uiSize += 1 + uiSize / 8, ++uiIndex)
+    {
+      const ezUInt8* pData = static_cast<const ezUInt8*>(allocations[uiIndex]);
+      bPatternIntact &= pData[0] == static_cast<ezUInt8>(uiSize) && pData[uiSize - 1] == static_cast<ezUInt8>(uiSize);
+    }
+    EZ_TEST_BOOL(bPatternIntact);
+
+    // half of the allocations are freed by another thread, which also allocates memory that is freed here
+    ThreadCachingTestThread thread(&allocator);
+    thread.m_uiNumToAllocate = 2000;
+    for (ezUInt32 i = 0; i < allocations.GetCount(); i += 2)
+    {
+      thread.m_ToFree.PushBack(allocations[i]);
+    }
+
+    thread.Start();
+    thread.Join();
+
+    for (ezUInt32 i = 1; i < allocations.GetCount(); i += 2)
+    {
+      allocator.Deallocate(allocations[i]);
+    }
+
+    for (void* ptr : thread.m_Allocated)
+    {
+      EZ_TEST_INT(static_cast<ezUInt8*>(ptr)[0], 0xAB);
+      allocator.Deallocate(ptr);
+    }
+
+    stats = allocator.GetStats();
+    EZ_TEST_INT(stats.m_uiNumAllocations, stats.m_uiNumDeallocations);
+    EZ_TEST_INT(stats.m_uiAllocationSize, 0);
+
+    // a new thread takes over the cache of the exited thread and returns the memory that was freed remotely
+    ThreadCachingTestThread thread2(&allocator);
+    thread2.m_uiNumToAllocate = 10000;
+    thread2.Start();
+    thread2.Join();
+
+    for (void* ptr : thread2.m_Allocated)
+    {
+      allocator.Deallocate(ptr);
+    }
+
+    stats = allocator.GetStats();
+    EZ_TEST_INT(stats.m_uiAllocationSize, 0);
+    EZ_TEST_BOOL(stats.m_uiCachedSize <= stats.m_uiReservedSize);
+  }
+
+  EZ_TEST_BLOCK(EZ_PERFORMANCE_TESTS_STATE, "ThreadCachingAllocator Performance")
+  {
+    const ezUInt32 uiNumIterations = 1000000;
+
+    ezAllocator<ezMemoryPolicies::ezHeapAllocation, ezMemoryTrackingFlags::None> heapAllocator("HeapBenchmark");
+    ezUntrackedThreadCachingAllocator threadCachingAllocator("ThreadCachingBenchmark");
+
+    for (ezUInt32 uiNumThreads : {1, 4, 8})
+    {
+      const ezTime tHeap = RunAllocatorBenchmark(&heapAllocator, uiNumThreads, uiNumIterations);
+      const ezTime tThreadCaching = RunAllocatorBenchmark(&threadCachingAllocator, uiNumThreads, uiNumIterations);
+
+      ezLog::Info("[test]{} threads, {} alloc/free pairs each: heap {} ms, thread-caching {} ms ({}x)", uiNumThreads, uiNumIterations,
+        ezArgF(tHeap.GetMilliseconds(), 1), ezArgF(tThreadCaching.GetMilliseconds(), 1), ezArgF(tHeap.GetSeconds() / tThreadCaching.GetSeconds(), 2));
+    }
+
+    const ezAllocatorBase::Stats stats = threadCachingAllocator.GetStats();
+    ezLog::Info("[test]Thread-caching allocator: {} KB reserved, {} KB cached", stats.m_uiReservedSize / 1024, stats.m_uiCachedSize / 1024);
+    EZ_TEST_INT(stats.m_uiAllocationSize, 0);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Sampled Tracking")
+  {
+    const ezUInt32 uiPrevInterval = ezMemoryTracker::GetSamplingInterval();
+    ezMemoryTracker::SetSamplingInterval(4096);
+
+    {
+      ezSampledHeapAllocator allocator("SampledAllocatorTest");
+
+      const ezUInt32 uiNumAllocations = 20000;
+      const size_t uiSize = 200;
+
+      ezDynamicArray<void*> allocations;
+      allocations.Reserve(uiNumAllocations);
+      for (ezUInt32 i = 0; i < uiNumAllocations; ++i)
+      {
+        allocations.PushBack(allocator.Allocate(uiSize, 8));
+      }
+
+      // about 1000 samples, the estimate is within a few percent of the real size
+      const double fExpectedSize = static_cast<double>(uiNumAllocations * uiSize);
+      EZ_TEST_DOUBLE(ezMemoryTracker::GetEstimatedSampledSize(allocator.GetId()) / fExpectedSize, 1.0, 0.2);
+
+      for (ezUInt32 i = 0; i < uiNumAllocations; i += 2)
+      {
+        allocator.Deallocate(allocations[i]);
+      }
+
+      EZ_TEST_DOUBLE(ezMemoryTracker::GetEstimatedSampledSize(allocator.GetId()) / fExpectedSize, 0.5, 0.15);
+
+      ezDynamicArray<ezUInt8> profile;
+      ezMemoryStreamContainerWrapperStorage<ezDynamicArray<ezUInt8>> storage(&profile);
+      ezMemoryStreamWriter writer(&storage);
+      ezMemoryTracker::WriteHeapProfile(writer);
+      profile.PushBack('\0');
+
+      const char* szProfile = reinterpret_cast<const char*>(profile.GetData());
+      EZ_TEST_BOOL(ezStringUtils::StartsWith(szProfile, "ezHeapProfile 1"));
+      EZ_TEST_BOOL(ezStringUtils::FindSubString(szProfile, "Allocator \"SampledAllocatorTest\"") != nullptr);
+
+      for (ezUInt32 i = 1; i < uiNumAllocations; i += 2)
+      {
+        allocator.Deallocate(allocations[i]);
+      }
+
+      EZ_TEST_INT(ezMemoryTracker::GetEstimatedSampledSize(allocator.GetId()), 0);
+    }
+
+    ezMemoryTracker::SetSamplingInterval(uiPrevInterval);
+  }
+
+  EZ_TEST_BLOCK(EZ_PERFORMANCE_TESTS_STATE, "Sampled Tracking Performance")
+  {
+    const ezUInt32 uiNumAllocations = 200000;
+
+    ezAllocator<ezMemoryPolicies::ezHeapAllocation, ezMemoryTrackingFlags::None> untrackedAllocator("UntrackedBenchmark");
+    ezSampledHeapAllocator sampledAllocator("SampledBenchmark");
+    ezAllocator<ezMemoryPolicies::ezHeapAllocation, ezMemoryTrackingFlags::RegisterAllocator | ezMemoryTrackingFlags::EnableAllocationTracking>
+      trackedAllocator("TrackedBenchmark");
+    ezAllocator<ezMemoryPolicies::ezHeapAllocation, ezMemoryTrackingFlags::All> tracedAllocator("TracedBenchmark");
+
+    ezAllocatorBase* allocators[] = {&untrackedAllocator, &sampledAllocator, &trackedAllocator, &tracedAllocator};
+    const char* szNames[] = {"Untracked", "Sampled", "Tracked", "Tracked with stack traces"};
+
+    ezDynamicArray<void*> allocations;
+    allocations.SetCount(uiNumAllocations);
+
+    for (ezUInt32 uiAllocator = 0; uiAllocator < EZ_ARRAY_SIZE(allocators); ++uiAllocator)
+    {
+      ezAllocatorBase* pAllocator = allocators[uiAllocator];
+      ezStopwatch sw;
+
+      for (ezUInt32 i = 0; i < uiNumAllocations; ++i)
+      {
+        allocations[i] = pAllocator->Allocate(16 + (i * 40) % 512, 8);
+      }
+
+      for (ezUInt32 i = 0; i < uiNumAllocations; ++i)
+      {
+        pAllocator->Deallocate(allocations[i]);
+      }
+
+      ezLog::Info("[test]{}: {} ns per allocation and deallocation", szNames[uiAllocator],
+        ezArgF(sw.GetRunningTotal().GetNanoseconds() / uiNumAllocations, 1));
+    }
+  }
 }
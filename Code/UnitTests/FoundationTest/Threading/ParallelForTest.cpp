@@ -74,6 +74,47 @@ EZ_CREATE_SIMPLE_TEST(Threading, ParallelFor)
     EZ_TEST_INT(uiNumbersSum, uiNumbersCheckSum);
   }
 
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Parallel For (Indexed, Start Index)")
+  {
+    // reset
+    ResetSharedVariables();
+
+    // only the last three slices are processed, every range has to be offset by the start index
+    const ezUInt32 uiStartIndex = ::s_uiTaskItemSliceSize;
+    const ezUInt32 uiNumItems = ::s_uiTotalNumberOfTaskItems - uiStartIndex;
+
+    ezUInt32 uiExpectedSum = 0;
+    for (ezUInt32 i = uiStartIndex; i < ::s_uiTotalNumberOfTaskItems; ++i)
+    {
+      uiExpectedSum += numbers[i];
+    }
+
+    ezTaskSystem::ParallelForIndexed(
+      uiStartIndex, uiNumItems,
+      [&dataAccessMutex, &uiRangesEncounteredCheck, &uiNumbersSum, &numbers, uiStartIndex](ezUInt32 uiSliceStartIndex, ezUInt32 uiSliceEndIndex) {
+        EZ_LOCK(dataAccessMutex);
+
+        // range check
+        EZ_TEST_BOOL(uiSliceStartIndex >= uiStartIndex);
+        EZ_TEST_BOOL(uiSliceEndIndex <= ::s_uiTotalNumberOfTaskItems);
+        EZ_TEST_INT(uiSliceEndIndex - uiSliceStartIndex, ::s_uiTaskItemSliceSize);
+
+        // note down which range this is
+        uiRangesEncounteredCheck |= 1 << (uiSliceStartIndex / ::s_uiTaskItemSliceSize);
+
+        // sum up numbers in our slice
+        for (ezUInt32 uiIndex = uiSliceStartIndex; uiIndex < uiSliceEndIndex; ++uiIndex)
+        {
+          uiNumbersSum += numbers[uiIndex];
+        }
+      },
+      "ParallelForIndexed Test", parallelForParams);
+
+    // check results
+    EZ_TEST_INT(uiRangesEncounteredCheck, 0b1110);
+    EZ_TEST_INT(uiNumbersSum, uiExpectedSum);
+  }
+
   EZ_TEST_BLOCK(ezTestBlock::Enabled, "Parallel For (Array)")
   {
     // reset
@@ -45,6 +45,30 @@ namespace
       return 0;
     }
   };
+
+  volatile ezInt32 g_iExitCallbackOrder = 0;
+
+  void FirstExitCallback()
+  {
+    // called last
+    ezAtomicUtils::TestAndSet(g_iExitCallbackOrder, 1, 2);
+  }
+
+  void SecondExitCallback()
+  {
+    ezAtomicUtils::TestAndSet(g_iExitCallbackOrder, 0, 1);
+  }
+
+  class ExitCallbackThread : public ezThread
+  {
+  public:
+    virtual ezUInt32 Run() override
+    {
+      ezThreadUtils::AddThreadExitCallback(&FirstExitCallback);
+      ezThreadUtils::AddThreadExitCallback(&SecondExitCallback);
+      return 0;
+    }
+  };
 } // namespace
 
 EZ_CREATE_SIMPLE_TEST_GROUP(Threading);
@@ -133,4 +157,16 @@ EZ_CREATE_SIMPLE_TEST(Threading, Thread)
     EZ_TEST_BOOL(duration.GetSeconds() > 0.25);
     EZ_TEST_BOOL_MSG(duration.GetSeconds() < 1.0, "This test can fail when the machine is under too much load and blocks the process for too long.");
   }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Thread Exit Callbacks")
+  {
+    g_iExitCallbackOrder = 0;
+
+    ExitCallbackThread thread;
+    thread.Start();
+    thread.Join();
+
+    // the callbacks are called in reverse order of registration
+    EZ_TEST_INT(g_iExitCallbackOrder, 2);
+  }
 }
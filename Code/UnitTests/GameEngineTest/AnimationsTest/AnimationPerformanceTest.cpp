@@ -0,0 +1,267 @@
+#include <GameEngineTest/GameEngineTestPCH.h>
+
+#include <Core/ResourceManager/ResourceManager.h>
+#include <Foundation/Configuration/Startup.h>
+#include <Foundation/Threading/TaskSystem.h>
+#include <RendererCore/AnimationSystem/AnimPoseGenerator.h>
+#include <RendererCore/AnimationSystem/AnimationClipResource.h>
+#include <RendererCore/AnimationSystem/AnimationPose.h>
+#include <RendererCore/AnimationSystem/SkeletonBuilder.h>
+#include <RendererCore/AnimationSystem/SkeletonResource.h>
+#include <RendererCore/Shader/Types.h>
+
+#define EZ_PERFORMANCE_TESTS_STATE ezTestBlock::DisabledNoWarning
+
+namespace
+{
+  enum constants
+  {
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEBUG)
+    NUM_CHARACTERS = 64,
+    NUM_FRAMES = 16,
+#else
+    NUM_CHARACTERS = 500,
+    NUM_FRAMES = 100,
+#endif
+    NUM_JOINTS = 64,
+    NUM_KEYFRAMES = 16,
+  };
+
+  struct Character
+  {
+    ezAnimPoseGenerator m_PoseGenerator;
+    ezSkinningSpaceAnimationPose m_SkinningPose;
+  };
+
+  struct Scene
+  {
+    ezSkeletonResourceHandle m_hSkeleton;
+    ezAnimationClipResourceHandle m_hClip;
+    ezHashTable<ezHashedString, ezMeshResourceDescriptor::BoneData> m_Bones;
+    ezDynamicArray<ezUniquePtr<Character>> m_Characters;
+  };
+
+  void GetJointName(ezUInt32 uiJoint, ezHashedString& out_sName)
+  {
+    ezStringBuilder sName;
+    sName.Format("Joint{0}", uiJoint);
+    out_sName.Assign(sName);
+  }
+
+  void CreateScene(Scene& scene, ezUInt32 uiNumCharacters)
+  {
+    ezHashedString sJointName;
+
+    {
+      // a binary tree of joints, so that the hierarchy isn't just one long chain
+      ezSkeletonBuilder builder;
+
+      for (ezUInt32 i = 0; i < NUM_JOINTS; ++i)
+      {
+        GetJointName(i, sJointName);
+        builder.AddJoint(sJointName, ezTransform(ezVec3(0, 0, 0.1f)), i == 0 ? ezInvalidIndex : (i - 1) / 2);
+
+        auto& bone = scene.m_Bones[sJointName];
+        bone.m_uiBoneIndex = static_cast<ezUInt16>(i);
+        bone.m_GlobalInverseBindPoseMatrix.SetTranslationMatrix(ezVec3(0, 0, -0.1f * i));
+      }
+
+      ezSkeletonResourceDescriptor desc;
+      builder.BuildSkeleton(desc.m_Skeleton);
+
+      scene.m_hSkeleton = ezResourceManager::GetOrCreateResource<ezSkeletonResource>("AnimationPerformanceSkeleton", std::move(desc));
+    }
+
+    {
+      ezAnimationClipResourceDescriptor desc;
+      desc.SetDuration(ezTime::Seconds(1.0));
+
+      ezHybridArray<ezAnimationClipResourceDescriptor::JointInfo, NUM_JOINTS> joints;
+
+      for (ezUInt32 i = 0; i < NUM_JOINTS; ++i)
+      {
+        GetJointName(i, sJointName);
+        joints.PushBack(desc.CreateJoint(sJointName, 1, NUM_KEYFRAMES, 1));
+      }
+
+      desc.AllocateJointTransforms();
+
+      for (ezUInt32 i = 0; i < NUM_JOINTS; ++i)
+      {
+        auto positions = desc.GetPositionKeyframes(joints[i]);
+        positions[0].m_fTimeInSec = 0.0f;
+        positions[0].m_Value.Set(0, 0, 0.1f);
+
+        auto rotations = desc.GetRotationKeyframes(joints[i]);
+        for (ezUInt32 k = 0; k < NUM_KEYFRAMES; ++k)
+        {
+          rotations[k].m_fTimeInSec = k / static_cast<float>(NUM_KEYFRAMES - 1);
+          rotations[k].m_Value.SetFromAxisAndAngle(ezVec3(1, 0, 0), ezAngle::Degree(10.0f * k + i));
+        }
+
+        auto scales = desc.GetScaleKeyframes(joints[i]);
+        scales[0].m_fTimeInSec = 0.0f;
+        scales[0].m_Value.Set(1.0f);
+      }
+
+      scene.m_hClip = ezResourceManager::GetOrCreateResource<ezAnimationClipResource>("AnimationPerformanceClip", std::move(desc));
+    }
+
+    for (ezUInt32 i = 0; i < uiNumCharacters; ++i)
+    {
+      scene.m_Characters.PushBack(EZ_DEFAULT_NEW(Character));
+    }
+  }
+
+  void PrepareCharacter(const Scene& scene, const ezSkeletonResource* pSkeleton, Character& character, float fSamplePos, bool bBlend)
+  {
+    ezAnimPoseGenerator& poseGen = character.m_PoseGenerator;
+    poseGen.Reset(pSkeleton);
+
+    auto& cmdSample = poseGen.AllocCommandSampleTrack(0);
+    cmdSample.m_hAnimationClip = scene.m_hClip;
+    cmdSample.m_fPreviousNormalizedSamplePos = fSamplePos;
+    cmdSample.m_fNormalizedSamplePos = fSamplePos;
+
+    ezAnimPoseGeneratorCommandID localPose = cmdSample.GetCommandID();
+
+    if (bBlend)
+    {
+      auto& cmdSample2 = poseGen.AllocCommandSampleTrack(1);
+      cmdSample2.m_hAnimationClip = scene.m_hClip;
+      cmdSample2.m_fPreviousNormalizedSamplePos = 1.0f - fSamplePos;
+      cmdSample2.m_fNormalizedSamplePos = 1.0f - fSamplePos;
+
+      auto& cmdCombine = poseGen.AllocCommandCombinePoses();
+      cmdCombine.m_Inputs.PushBack(cmdSample.GetCommandID());
+      cmdCombine.m_Inputs.PushBack(cmdSample2.GetCommandID());
+      cmdCombine.m_InputWeights.PushBack(0.7f);
+      cmdCombine.m_InputWeights.PushBack(0.3f);
+
+      localPose = cmdCombine.GetCommandID();
+    }
+
+    auto& cmdL2M = poseGen.AllocCommandLocalToModelPose();
+    cmdL2M.m_Inputs.PushBack(localPose);
+
+    auto& cmdOut = poseGen.AllocCommandModelPoseToOutput();
+    cmdOut.m_Inputs.PushBack(cmdL2M.GetCommandID());
+  }
+
+  void AnimateCharacter(const Scene& scene, const ezSkeletonResource* pSkeleton, Character& character)
+  {
+    const ezArrayPtr<ezMat4> pose = character.m_PoseGenerator.GeneratePoseAsync();
+
+    character.m_SkinningPose.MapModelSpacePoseToSkinningSpace(scene.m_Bones, pSkeleton->GetDescriptor().m_Skeleton, pose, nullptr);
+  }
+
+  ezTime AnimateFrames(Scene& scene, bool bParallel, bool bBlend)
+  {
+    ezResourceLock<ezSkeletonResource> pSkeleton(scene.m_hSkeleton, ezResourceAcquireMode::BlockTillLoaded);
+
+    const ezUInt32 uiNumCharacters = scene.m_Characters.GetCount();
+    const ezTime tStart = ezTime::Now();
+
+    for (ezUInt32 uiFrame = 0; uiFrame < NUM_FRAMES; ++uiFrame)
+    {
+      for (ezUInt32 i = 0; i < uiNumCharacters; ++i)
+      {
+        PrepareCharacter(scene, pSkeleton.GetPointer(), *scene.m_Characters[i], ((uiFrame + i) % 60) / 60.0f, bBlend);
+      }
+
+      if (bParallel)
+      {
+        ezTaskSystem::ParallelForIndexed(0, uiNumCharacters, [&](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) {
+          for (ezUInt32 i = uiStartIndex; i < uiEndIndex; ++i)
+          {
+            AnimateCharacter(scene, pSkeleton.GetPointer(), *scene.m_Characters[i]);
+          }
+        });
+      }
+      else
+      {
+        for (ezUInt32 i = 0; i < uiNumCharacters; ++i)
+        {
+          AnimateCharacter(scene, pSkeleton.GetPointer(), *scene.m_Characters[i]);
+        }
+      }
+    }
+
+    return ezTime::Now() - tStart;
+  }
+} // namespace
+
+EZ_CREATE_SIMPLE_TEST_GROUP(Animation);
+
+EZ_CREATE_SIMPLE_TEST(Animation, PoseGenerationPerformance)
+{
+  ezStartup::StartupCoreSystems();
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Parallel matches sequential")
+  {
+    Scene scene;
+    CreateScene(scene, 32);
+
+    AnimateFrames(scene, false, true);
+
+    ezDynamicArray<ezShaderTransform> sequentialResult;
+    for (const auto& pCharacter : scene.m_Characters)
+    {
+      sequentialResult.PushBackRange(pCharacter->m_SkinningPose.m_Transforms);
+    }
+
+    AnimateFrames(scene, true, true);
+
+    ezDynamicArray<ezShaderTransform> parallelResult;
+    for (const auto& pCharacter : scene.m_Characters)
+    {
+      parallelResult.PushBackRange(pCharacter->m_SkinningPose.m_Transforms);
+    }
+
+    EZ_TEST_INT(sequentialResult.GetCount(), 32 * NUM_JOINTS);
+    EZ_TEST_BOOL(sequentialResult.GetArrayPtr().ToByteArray() == parallelResult.GetArrayPtr().ToByteArray());
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "No allocations per frame")
+  {
+    Scene scene;
+    CreateScene(scene, 8);
+
+    // the first frames allocate the sampling caches and the pose memory, which is reused afterwards
+    AnimateFrames(scene, false, true);
+
+    const ezUInt64 uiNumAllocations = ezFoundation::GetDefaultAllocator()->GetStats().m_uiNumAllocations + ezFoundation::GetAlignedAllocator()->GetStats().m_uiNumAllocations;
+
+    AnimateFrames(scene, false, true);
+
+    EZ_TEST_INT(ezFoundation::GetDefaultAllocator()->GetStats().m_uiNumAllocations + ezFoundation::GetAlignedAllocator()->GetStats().m_uiNumAllocations, uiNumAllocations);
+  }
+
+  EZ_TEST_BLOCK(EZ_PERFORMANCE_TESTS_STATE, "Animate N characters")
+  {
+    Scene scene;
+    CreateScene(scene, NUM_CHARACTERS);
+
+    const ezTime tSequential = AnimateFrames(scene, false, false);
+    const ezTime tParallel = AnimateFrames(scene, true, false);
+
+    ezLog::Info("[test]Animating {0} characters sequentially: {1}ms per frame", NUM_CHARACTERS, ezArgF(tSequential.GetMilliseconds() / NUM_FRAMES, 4));
+    ezLog::Info("[test]Animating {0} characters in parallel: {1}ms per frame", NUM_CHARACTERS, ezArgF(tParallel.GetMilliseconds() / NUM_FRAMES, 4));
+  }
+
+  EZ_TEST_BLOCK(EZ_PERFORMANCE_TESTS_STATE, "Animate N blended characters")
+  {
+    Scene scene;
+    CreateScene(scene, NUM_CHARACTERS);
+
+    const ezTime tSequential = AnimateFrames(scene, false, true);
+    const ezTime tParallel = AnimateFrames(scene, true, true);
+
+    ezLog::Info("[test]Animating {0} blended characters sequentially: {1}ms per frame", NUM_CHARACTERS, ezArgF(tSequential.GetMilliseconds() / NUM_FRAMES, 4));
+    ezLog::Info("[test]Animating {0} blended characters in parallel: {1}ms per frame", NUM_CHARACTERS, ezArgF(tParallel.GetMilliseconds() / NUM_FRAMES, 4));
+  }
+
+  ezResourceManager::FreeAllUnusedResources();
+
+  ezStartup::ShutdownCoreSystems();
+}
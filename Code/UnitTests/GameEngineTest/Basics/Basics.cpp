@@ -2,12 +2,14 @@
 
 #include "Basics.h"
 #include <Foundation/Basics/Platform/Win/IncludeWindows.h>
+#include <Foundation/Configuration/CVar.h>
 #include <Foundation/IO/OSFile.h>
 #include <Foundation/Logging/ConsoleWriter.h>
 #include <Foundation/Strings/StringConversion.h>
 #include <Foundation/System/MiniDumpUtils.h>
 #include <Foundation/System/Process.h>
 #include <RendererCore/Components/SkyBoxComponent.h>
+#include <RendererCore/Pipeline/InstanceDataProvider.h>
 #include <RendererCore/RenderContext/RenderContext.h>
 #include <RendererCore/RenderWorld/RenderWorld.h>
 #include <RendererCore/Textures/TextureCubeResource.h>
@@ -197,6 +199,7 @@ void ezGameEngineTestBasics::SetupSubTests()
   AddSubTest("Debug Rendering", SubTests::DebugRendering);
   AddSubTest("Debug Rendering - No Lines", SubTests::DebugRendering2);
   AddSubTest("Load Scene", SubTests::LoadScene);
+  AddSubTest("Persistent Instance Data", SubTests::PersistentInstanceData);
 }
 
 ezResult ezGameEngineTestBasics::InitializeSubTest(ezInt32 iIdentifier)
@@ -229,6 +232,12 @@ ezResult ezGameEngineTestBasics::InitializeSubTest(ezInt32 iIdentifier)
     return EZ_SUCCESS;
   }
 
+  if (iIdentifier == SubTests::PersistentInstanceData)
+  {
+    m_pOwnApplication->SubTestPersistentInstanceDataSetup();
+    return EZ_SUCCESS;
+  }
+
   return EZ_FAILURE;
 }
 
@@ -251,6 +260,9 @@ ezTestAppRun ezGameEngineTestBasics::RunSubTest(ezInt32 iIdentifier, ezUInt32 ui
   if (iIdentifier == SubTests::LoadScene)
     return m_pOwnApplication->SubTestLoadSceneExec(m_iFrame);
 
+  if (iIdentifier == SubTests::PersistentInstanceData)
+    return m_pOwnApplication->SubTestPersistentInstanceDataExec(m_iFrame);
+
   EZ_ASSERT_NOT_IMPLEMENTED;
   return ezTestAppRun::Quit;
 }
@@ -556,3 +568,103 @@ ezTestAppRun ezGameEngineTestApplication_Basics::SubTestLoadSceneExec(ezInt32 iC
 
   return ezTestAppRun::Continue;
 }
+
+//////////////////////////////////////////////////////////////////////////
+
+void ezGameEngineTestApplication_Basics::SubTestPersistentInstanceDataSetup()
+{
+  EZ_LOCK(m_pWorld->GetWriteMarker());
+
+  m_pWorld->Clear();
+
+  m_iPersistentPhaseStartFrame = -1;
+  m_uiPersistentIndexBytes = 0;
+
+  ezMeshResourceHandle hMesh = ezResourceManager::LoadResource<ezMeshResource>("Meshes/MissingMesh.ezMesh");
+
+  // few enough static meshes to all end up in the render data cache within a couple of frames
+  for (ezInt32 z = -1; z <= 1; ++z)
+  {
+    for (ezInt32 y = -1; y <= 1; ++y)
+    {
+      for (ezInt32 x = 0; x < 3; ++x)
+      {
+        ezGameObjectDesc go;
+        go.m_LocalPosition.Set(10.0f + x * 5.0f, y * 5.0f, z * 5.0f);
+
+        ezGameObject* pObject;
+        m_pWorld->CreateObject(go, pObject);
+
+        ezMeshComponent* pMesh;
+        m_pWorld->GetOrCreateComponentManager<ezMeshComponentManager>()->CreateComponent(pObject, pMesh);
+
+        pMesh->SetMesh(hMesh);
+      }
+    }
+  }
+}
+
+ezTestAppRun ezGameEngineTestApplication_Basics::SubTestPersistentInstanceDataExec(ezInt32 iCurFrame)
+{
+  {
+    auto pCamera = ezDynamicCast<ezGameState*>(GetActiveGameState())->GetMainCamera();
+    pCamera->SetCameraMode(ezCameraMode::PerspectiveFixedFovY, 100.0f, 1.0f, 1000.0f);
+    ezVec3 pos;
+    pos.SetZero();
+    pCamera->LookAt(pos, pos + ezVec3(1, 0, 0), ezVec3(0, 0, 1));
+  }
+
+  ezCVarBool* pCVar = static_cast<ezCVarBool*>(ezCVar::FindCVarByName("Rendering.PersistentInstanceData"));
+  if (!EZ_TEST_BOOL(pCVar != nullptr))
+    return ezTestAppRun::Quit;
+
+  if (iCurFrame == 0)
+  {
+    *pCVar = true;
+  }
+
+  ezResourceManager::ForceNoFallbackAcquisition(3);
+
+  if (Run() == ezApplication::Execution::Quit)
+    return ezTestAppRun::Quit;
+
+  if (iCurFrame < 4)
+    return ezTestAppRun::Continue;
+
+  const ezPersistentInstanceData::Statistics& stats = ezPersistentInstanceData::GetStatistics();
+
+  if (m_iPersistentPhaseStartFrame < 0)
+  {
+    // wait until all cached meshes have their slot, after that nothing should be uploaded into the persistent buffer anymore
+    if (stats.m_uiPersistentBytes != 0 || stats.m_uiNumSlots == 0)
+    {
+      if (iCurFrame < 100)
+        return ezTestAppRun::Continue;
+
+      EZ_TEST_FAILURE("Persistent instance data", "The cached meshes never reached a state without persistent uploads");
+      return ezTestAppRun::Quit;
+    }
+
+    EZ_TEST_BOOL(stats.m_uiNumSlots >= 27);
+    EZ_TEST_BOOL(stats.m_uiIndexBytes >= 27 * sizeof(ezUInt32));
+
+    // compare against the regular per frame upload path
+    m_uiPersistentIndexBytes = stats.m_uiIndexBytes;
+    m_iPersistentPhaseStartFrame = iCurFrame;
+    *pCVar = false;
+
+    return ezTestAppRun::Continue;
+  }
+
+  // give the render thread a frame to pick up the cvar change
+  if (iCurFrame < m_iPersistentPhaseStartFrame + 3)
+    return ezTestAppRun::Continue;
+
+  // without the persistent buffer every instance uploads its full per instance data again, instead of a single index
+  EZ_TEST_INT(stats.m_uiIndexBytes, 0);
+  EZ_TEST_BOOL(stats.m_uiTransientBytes > m_uiPersistentIndexBytes);
+
+  *pCVar = true;
+
+  return ezTestAppRun::Quit;
+}
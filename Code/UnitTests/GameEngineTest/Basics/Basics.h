@@ -22,6 +22,13 @@ public:
 
   void SubTestLoadSceneSetup();
   ezTestAppRun SubTestLoadSceneExec(ezInt32 iCurFrame);
+
+  void SubTestPersistentInstanceDataSetup();
+  ezTestAppRun SubTestPersistentInstanceDataExec(ezInt32 iCurFrame);
+
+private:
+  ezInt32 m_iPersistentPhaseStartFrame = -1;
+  ezUInt32 m_uiPersistentIndexBytes = 0;
 };
 
 class ezGameEngineTestBasics : public ezGameEngineTest
@@ -40,6 +47,7 @@ private:
     DebugRendering,
     DebugRendering2,
     LoadScene,
+    PersistentInstanceData,
   };
 
   virtual void SetupSubTests() override;
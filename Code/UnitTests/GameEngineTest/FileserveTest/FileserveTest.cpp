@@ -0,0 +1,361 @@
+#include <GameEngineTest/GameEngineTestPCH.h>
+
+#ifdef BUILDSYSTEM_ENABLE_ENET_SUPPORT
+
+#  include <FileservePlugin/Client/FileserveClient.h>
+#  include <FileservePlugin/Fileserver/Fileserver.h>
+#  include <Foundation/IO/FileSystem/FileReader.h>
+#  include <Foundation/IO/FileSystem/FileSystem.h>
+#  include <Foundation/IO/OSFile.h>
+#  include <Foundation/Math/Random.h>
+#  include <Foundation/Threading/AtomicInteger.h>
+#  include <Foundation/Threading/Thread.h>
+#  include <Foundation/Threading/ThreadUtils.h>
+#  include <Foundation/Types/ScopeExit.h>
+
+EZ_CREATE_SIMPLE_TEST_GROUP(Fileserve);
+
+namespace FileserveTestDetail
+{
+  static constexpr ezUInt16 s_uiPort = 1142;
+
+  /// Large enough that the client sends a block signature along with the request.
+  static constexpr ezUInt32 s_uiLargeFileSize = 256 * 1024;
+
+  static const char* s_szFiles[] = {"Small.txt", "Large1.bin", "Large2.bin"};
+
+  /// The client blocks while it waits for answers, so the server is updated on its own thread.
+  class ServerThread : public ezThread
+  {
+  public:
+    ServerThread()
+      : ezThread("Fileserve Test Server")
+    {
+    }
+
+    ezAtomicBool m_bStop;
+
+  private:
+    virtual ezUInt32 Run() override
+    {
+      while (!m_bStop)
+      {
+        if (!ezFileserver::GetSingleton()->UpdateServer())
+          ezThreadUtils::Sleep(ezTime::Milliseconds(1));
+      }
+
+      return 0;
+    }
+  };
+
+  static ezResult WriteFile(const char* szPath, ezArrayPtr<const ezUInt8> content)
+  {
+    ezOSFile file;
+    EZ_SUCCEED_OR_RETURN(file.Open(szPath, ezFileOpenMode::Write));
+    EZ_SUCCEED_OR_RETURN(file.Write(content.GetPtr(), content.GetCount()));
+    file.Close();
+    return EZ_SUCCESS;
+  }
+
+  /// Records the downloads that the server answers with and can break the client's cached copy of a file while a delta for it is on its way.
+  class DownloadRecorder
+  {
+  public:
+    struct Download
+    {
+      ezString m_sFile;
+      ezUInt32 m_uiPayloadSize = 0;
+    };
+
+    void OnServerEvent(const ezFileserverEvent& e)
+    {
+      if (e.m_Type != ezFileserverEvent::Type::FileDownloadRequest || e.m_FileState != ezFileserveFileState::Different)
+        return;
+
+      EZ_LOCK(m_Mutex);
+
+      Download& download = m_Downloads.ExpandAndGetRef();
+      download.m_sFile = e.m_szPath;
+      download.m_uiPayloadSize = e.m_uiSizeTotal;
+
+      if (!m_sCorruptFile.IsEmpty() && m_sCorruptFile == e.m_szPath)
+      {
+        m_sCorruptFile.Clear();
+
+        // the delta was computed for the old content, applied to anything else it produces garbage
+        ezDynamicArray<ezUInt8> zeros;
+        zeros.SetCount(s_uiLargeFileSize);
+
+        ezStringBuilder sCachedFile = m_sCacheFolder;
+        sCachedFile.AppendPath(e.m_szPath);
+        m_bCorrupted = WriteFile(sCachedFile, zeros).Succeeded();
+      }
+    }
+
+    void CorruptCachedFileOnDownload(const char* szFile, const char* szCacheFolder)
+    {
+      EZ_LOCK(m_Mutex);
+      m_sCorruptFile = szFile;
+      m_sCacheFolder = szCacheFolder;
+    }
+
+    void GetDownloads(const char* szFile, ezDynamicArray<Download>& out_Downloads) const
+    {
+      EZ_LOCK(m_Mutex);
+
+      out_Downloads.Clear();
+      for (const Download& download : m_Downloads)
+      {
+        if (download.m_sFile == szFile)
+          out_Downloads.PushBack(download);
+      }
+    }
+
+    ezUInt32 GetNumDownloads() const
+    {
+      EZ_LOCK(m_Mutex);
+      return m_Downloads.GetCount();
+    }
+
+    bool WasCorrupted() const
+    {
+      EZ_LOCK(m_Mutex);
+      return m_bCorrupted;
+    }
+
+  private:
+    mutable ezMutex m_Mutex;
+    ezDynamicArray<Download> m_Downloads;
+    ezString m_sCorruptFile;
+    ezString m_sCacheFolder;
+    bool m_bCorrupted = false;
+  };
+
+  /// Rewrites the file until its timestamp changed, otherwise the server would consider the client's copy up to date.
+  static ezResult ModifyFile(const char* szPath, ezArrayPtr<const ezUInt8> content)
+  {
+    ezFileStats oldStats;
+    EZ_SUCCEED_OR_RETURN(ezOSFile::GetFileStats(szPath, oldStats));
+
+    for (ezUInt32 i = 0; i < 50; ++i)
+    {
+      EZ_SUCCEED_OR_RETURN(WriteFile(szPath, content));
+
+      ezFileStats newStats;
+      EZ_SUCCEED_OR_RETURN(ezOSFile::GetFileStats(szPath, newStats));
+
+      if (!newStats.m_LastModificationTime.Compare(oldStats.m_LastModificationTime, ezTimestamp::CompareMode::Identical))
+        return EZ_SUCCESS;
+
+      // some file systems store timestamps with a resolution of seconds
+      ezThreadUtils::Sleep(ezTime::Milliseconds(100));
+    }
+
+    return EZ_FAILURE;
+  }
+
+  static void ClearClientCache(const char* szCacheFolder)
+  {
+    if (ezStringUtils::IsNullOrEmpty(szCacheFolder))
+      return;
+
+    // the cache and the meta folder are both named after the mount point
+    const ezStringBuilder sMountPoint = ezPathUtils::GetFileName(szCacheFolder);
+
+    ezStringBuilder sMetaFolder = ezOSFile::GetUserDataFolder("ezFileserve/Meta");
+    sMetaFolder.AppendPath(sMountPoint);
+
+    ezStringBuilder sPath;
+    for (const char* szFile : s_szFiles)
+    {
+      sPath = szCacheFolder;
+      sPath.AppendPath(szFile);
+      ezOSFile::DeleteFile(sPath).IgnoreResult();
+
+      sPath = sMetaFolder;
+      sPath.AppendPath(szFile);
+      ezOSFile::DeleteFile(sPath).IgnoreResult();
+    }
+  }
+
+  /// Creates a new client, which only knows about the files that are cached on disk, and mounts the served directory through it.
+  static ezResult ConnectClient(ezUniquePtr<ezFileserveClient>& out_pClient, ezStringBuilder& out_sCacheFolder)
+  {
+    // creating the server switched the client functionality off
+    ezFileserveClient::EnableFileserveClient();
+
+    out_pClient = EZ_DEFAULT_NEW(ezFileserveClient);
+
+    ezStringBuilder sAddress;
+    sAddress.Format("localhost:{0}", s_uiPort);
+    out_pClient->AddServerAddressToTry(sAddress);
+
+    EZ_SUCCEED_OR_RETURN(out_pClient->EnsureConnected(ezTime::Seconds(10)));
+    EZ_SUCCEED_OR_RETURN(ezFileSystem::AddDataDirectory(">fileservetest/", "FileserveTest", "fstest"));
+
+    ezDataDirectoryType* pDataDir = ezFileSystem::FindDataDirectoryWithRoot("fstest");
+    if (pDataDir == nullptr)
+      return EZ_FAILURE;
+
+    // otherwise the directory was mounted as a regular folder
+    out_sCacheFolder = pDataDir->GetRedirectedDataDirectoryPath();
+    if (!out_sCacheFolder.StartsWith(ezOSFile::GetUserDataFolder("ezFileserve/Cache")))
+      return EZ_FAILURE;
+
+    return EZ_SUCCESS;
+  }
+
+  static void DisconnectClient(ezUniquePtr<ezFileserveClient>& inout_pClient)
+  {
+    ezFileSystem::RemoveDataDirectoryGroup("FileserveTest");
+    inout_pClient.Clear();
+  }
+
+  static bool IsFileContentEqual(const char* szFile, ezArrayPtr<const ezUInt8> expected)
+  {
+    ezFileReader file;
+    if (file.Open(szFile).Failed())
+      return false;
+
+    ezDynamicArray<ezUInt8> content;
+    content.SetCountUninitialized((ezUInt32)file.GetFileSize());
+
+    if (file.ReadBytes(content.GetData(), content.GetCount()) != content.GetCount())
+      return false;
+
+    return content.GetArrayPtr() == expected;
+  }
+} // namespace FileserveTestDetail
+
+EZ_CREATE_SIMPLE_TEST(Fileserve, Loopback)
+{
+  using namespace FileserveTestDetail;
+
+  // where the test framework itself is served through fileserve, there can't be a second client
+  if (ezFileserveClient::GetSingleton() != nullptr)
+    return;
+
+  ezStringBuilder sServerFolder = ezTestFramework::GetInstance()->GetAbsOutputPath();
+  sServerFolder.AppendPath("FileserveTest");
+  EZ_TEST_BOOL(ezOSFile::CreateDirectoryStructure(sServerFolder).Succeeded());
+
+  ezFileSystem::SetSpecialDirectory("fileservetest", sServerFolder);
+  EZ_SCOPE_EXIT(ezFileSystem::SetSpecialDirectory("fileservetest", nullptr));
+
+  auto GetServerPath = [&](const char* szFile) {
+    ezStringBuilder sPath = sServerFolder;
+    sPath.AppendPath(szFile);
+    return sPath;
+  };
+
+  ezRandom rnd;
+  rnd.Initialize(42);
+
+  const char* szSmallText = "This file is small enough to always be transferred completely.";
+  const ezArrayPtr<const ezUInt8> smallFile(reinterpret_cast<const ezUInt8*>(szSmallText), ezStringUtils::GetStringElementCount(szSmallText));
+
+  // random content doesn't compress, so the payload sizes show whether a delta was sent
+  ezDynamicArray<ezUInt8> largeFile1, largeFile2;
+  largeFile1.SetCountUninitialized(s_uiLargeFileSize);
+  largeFile2.SetCountUninitialized(s_uiLargeFileSize);
+
+  for (ezUInt32 i = 0; i < s_uiLargeFileSize; ++i)
+  {
+    largeFile1[i] = static_cast<ezUInt8>(rnd.UInt());
+    largeFile2[i] = static_cast<ezUInt8>(rnd.UInt());
+  }
+
+  EZ_TEST_BOOL(WriteFile(GetServerPath("Small.txt"), smallFile).Succeeded());
+  EZ_TEST_BOOL(WriteFile(GetServerPath("Large1.bin"), largeFile1).Succeeded());
+  EZ_TEST_BOOL(WriteFile(GetServerPath("Large2.bin"), largeFile2).Succeeded());
+
+  DownloadRecorder recorder;
+
+  ezFileserver server;
+  server.SetPort(s_uiPort);
+  server.m_Events.AddEventHandler(ezMakeDelegate(&DownloadRecorder::OnServerEvent, &recorder));
+  server.StartServer();
+
+  ServerThread serverThread;
+  serverThread.Start();
+
+  EZ_SCOPE_EXIT(serverThread.m_bStop = true; serverThread.Join(); server.StopServer(););
+
+  ezUniquePtr<ezFileserveClient> pClient;
+  ezStringBuilder sCacheFolder;
+  EZ_SCOPE_EXIT(DisconnectClient(pClient); ClearClientCache(sCacheFolder););
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "PrefetchFiles")
+  {
+    EZ_TEST_BOOL(ConnectClient(pClient, sCacheFolder).Succeeded());
+
+    // leftovers of previous runs would turn the downloads into deltas
+    ClearClientCache(sCacheFolder);
+
+    const ezString files[] = {s_szFiles[0], s_szFiles[1], s_szFiles[2]};
+    pClient->PrefetchFiles(files);
+
+    EZ_TEST_INT(pClient->GetNumPendingFileRequests(), 3);
+    EZ_TEST_BOOL(pClient->WaitForPendingFileRequests(ezTime::Seconds(30)).Succeeded());
+    EZ_TEST_INT(pClient->GetNumPendingFileRequests(), 0);
+    EZ_TEST_INT(recorder.GetNumDownloads(), 3);
+
+    // the prefetched files are read from the cache, without asking the server again
+    EZ_TEST_BOOL(IsFileContentEqual(":fstest/Small.txt", smallFile));
+    EZ_TEST_BOOL(IsFileContentEqual(":fstest/Large1.bin", largeFile1));
+    EZ_TEST_BOOL(IsFileContentEqual(":fstest/Large2.bin", largeFile2));
+    EZ_TEST_INT(recorder.GetNumDownloads(), 3);
+
+    DisconnectClient(pClient);
+  }
+
+  // change a few bytes in the middle, everything else can be taken from the cached copies
+  for (ezUInt32 i = 100000; i < 100100; ++i)
+  {
+    largeFile1[i] ^= 0xFF;
+    largeFile2[i] ^= 0xFF;
+  }
+
+  EZ_TEST_BOOL(ModifyFile(GetServerPath("Large1.bin"), largeFile1).Succeeded());
+  EZ_TEST_BOOL(ModifyFile(GetServerPath("Large2.bin"), largeFile2).Succeeded());
+
+  ezDynamicArray<DownloadRecorder::Download> downloads;
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Delta")
+  {
+    EZ_TEST_BOOL(ConnectClient(pClient, sCacheFolder).Succeeded());
+
+    EZ_TEST_BOOL(IsFileContentEqual(":fstest/Large1.bin", largeFile1));
+
+    recorder.GetDownloads("Large1.bin", downloads);
+    EZ_TEST_INT(downloads.GetCount(), 2);
+
+    if (downloads.GetCount() == 2)
+    {
+      EZ_TEST_INT(downloads[0].m_uiPayloadSize, s_uiLargeFileSize);
+      EZ_TEST_BOOL(downloads[1].m_uiPayloadSize < s_uiLargeFileSize / 4);
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Delta Fallback")
+  {
+    recorder.CorruptCachedFileOnDownload("Large2.bin", sCacheFolder);
+
+    // the delta can't reproduce the file, so the client has to request all of it
+    EZ_TEST_BOOL(IsFileContentEqual(":fstest/Large2.bin", largeFile2));
+    EZ_TEST_BOOL(recorder.WasCorrupted());
+
+    recorder.GetDownloads("Large2.bin", downloads);
+    EZ_TEST_INT(downloads.GetCount(), 3);
+
+    if (downloads.GetCount() == 3)
+    {
+      EZ_TEST_BOOL(downloads[1].m_uiPayloadSize < s_uiLargeFileSize / 4);
+      EZ_TEST_INT(downloads[2].m_uiPayloadSize, s_uiLargeFileSize);
+    }
+
+    DisconnectClient(pClient);
+  }
+}
+
+#endif
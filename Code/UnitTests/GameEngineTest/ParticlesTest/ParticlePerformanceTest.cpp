@@ -0,0 +1,344 @@
+#include <GameEngineTest/GameEngineTestPCH.h>
+
+#include <Foundation/Configuration/Startup.h>
+#include <Foundation/DataProcessing/Stream/DefaultImplementations/ZeroInitializer.h>
+#include <Foundation/DataProcessing/Stream/ProcessingStreamGroup.h>
+#include <Foundation/DataProcessing/Stream/ProcessingStreamProcessor.h>
+#include <ParticlePlugin/Module/ParticleSimdKernels.h>
+#include <ParticlePlugin/Type/ParticleDepthSort.h>
+
+#define EZ_PERFORMANCE_TESTS_STATE ezTestBlock::DisabledNoWarning
+
+namespace
+{
+  enum constants
+  {
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEBUG)
+    NUM_PARTICLES = 10000,
+    NUM_FRAMES = 10,
+#else
+    NUM_PARTICLES = 200000,
+    NUM_FRAMES = 100,
+#endif
+  };
+
+  /// Does the same work as the gravity and velocity behaviors plus the apply velocity finalizer, either with the scalar loops that were used
+  /// before or with the SIMD kernels.
+  class ParticleStepProcessor : public ezProcessingStreamProcessor
+  {
+    EZ_ADD_DYNAMIC_REFLECTION(ParticleStepProcessor, ezProcessingStreamProcessor);
+
+  public:
+    bool m_bSimd = true;
+
+  protected:
+    virtual ezResult UpdateStreamBindings() override
+    {
+      m_pStreamPosition = m_pStreamGroup->GetStreamByName("Position");
+      m_pStreamVelocity = m_pStreamGroup->GetStreamByName("Velocity");
+
+      return (m_pStreamPosition != nullptr && m_pStreamVelocity != nullptr) ? EZ_SUCCESS : EZ_FAILURE;
+    }
+
+    virtual void InitializeElements(ezUInt64 uiStartIndex, ezUInt64 uiNumElements) override
+    {
+      ezSimdVec4f* pPosition = m_pStreamPosition->GetWritableData<ezSimdVec4f>();
+      ezVec3* pVelocity = m_pStreamVelocity->GetWritableData<ezVec3>();
+
+      for (ezUInt64 i = uiStartIndex; i < uiStartIndex + uiNumElements; ++i)
+      {
+        const float f = static_cast<float>(i % 1024);
+        pPosition[i].Set(f, -f, 0.5f * f, 1.0f);
+        pVelocity[i].Set(0.1f * f, 1.0f, -0.2f * f);
+      }
+    }
+
+    virtual bool PrepareRangeProcessing(ezUInt64 uiNumElements) override { return true; }
+
+    virtual void ProcessRange(ezUInt64 uiStartIndex, ezUInt64 uiNumElements) override
+    {
+      const float fTimeDiff = 1.0f / 60.0f;
+      const ezVec3 vAddGravity(0.0f, 0.0f, -10.0f * fTimeDiff);
+      const ezVec3 vAddPos(0.0f, 0.0f, 0.01f);
+      const float fFrictionFactor = 0.99f;
+
+      ezSimdVec4f* pPosition = m_pStreamPosition->GetWritableData<ezSimdVec4f>() + uiStartIndex;
+      ezVec3* pVelocity = m_pStreamVelocity->GetWritableData<ezVec3>() + uiStartIndex;
+
+      if (m_bSimd)
+      {
+        ezSimdVec4f vAddPosSimd;
+        vAddPosSimd.Load<3>(&vAddPos.x);
+
+        ezParticleSimdKernels::AddToFloat3(pVelocity, uiNumElements, vAddGravity);
+        ezParticleSimdKernels::AddToFloat4(pPosition, uiNumElements, vAddPosSimd);
+        ezParticleSimdKernels::ScaleFloat3(pVelocity, uiNumElements, fFrictionFactor);
+        ezParticleSimdKernels::IntegrateVelocity(pPosition, pVelocity, uiNumElements, fTimeDiff);
+      }
+      else
+      {
+        ezVec4* pPosition4 = reinterpret_cast<ezVec4*>(pPosition);
+
+        for (ezUInt64 i = 0; i < uiNumElements; ++i)
+          pVelocity[i] += vAddGravity;
+
+        for (ezUInt64 i = 0; i < uiNumElements; ++i)
+        {
+          pPosition4[i] += vAddPos.GetAsVec4(0.0f);
+          pVelocity[i] *= fFrictionFactor;
+        }
+
+        for (ezUInt64 i = 0; i < uiNumElements; ++i)
+          reinterpret_cast<ezVec3&>(pPosition4[i]) += pVelocity[i] * fTimeDiff;
+      }
+    }
+
+    ezProcessingStream* m_pStreamPosition = nullptr;
+    ezProcessingStream* m_pStreamVelocity = nullptr;
+  };
+
+  // clang-format off
+  EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(ParticleStepProcessor, 1, ezRTTIDefaultAllocator<ParticleStepProcessor>)
+  EZ_END_DYNAMIC_REFLECTED_TYPE;
+  // clang-format on
+
+  ezTime SimulateParticles(bool bSimd, ezUInt32 uiChunkSize)
+  {
+    ezProcessingStreamGroup group;
+    group.AddStream("Position", ezProcessingStream::DataType::Float4);
+    group.AddStream("Velocity", ezProcessingStream::DataType::Float3);
+
+    ParticleStepProcessor* pProcessor = EZ_DEFAULT_NEW(ParticleStepProcessor);
+    pProcessor->m_bSimd = bSimd;
+    group.AddProcessor(pProcessor);
+
+    group.SetSize(NUM_PARTICLES);
+    group.SetParallelChunkSize(uiChunkSize);
+    group.InitializeElements(NUM_PARTICLES);
+    group.Process();
+
+    const ezTime tStart = ezTime::Now();
+
+    for (ezUInt32 uiFrame = 0; uiFrame < NUM_FRAMES; ++uiFrame)
+    {
+      group.Process();
+    }
+
+    return ezTime::Now() - tStart;
+  }
+
+  void LogParticlesPerMs(const char* szName, ezTime t)
+  {
+    const double fParticlesPerMs = static_cast<double>(NUM_PARTICLES) * NUM_FRAMES / ezMath::Max(t.GetMilliseconds(), 0.001);
+    ezLog::Info("[test]{0}: {1}ms per frame, {2} particles/ms", szName, ezArgF(t.GetMilliseconds() / NUM_FRAMES, 4), ezArgF(fParticlesPerMs, 0));
+  }
+
+  struct DepthSortEntry
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    float m_fDistSqr;
+    ezUInt32 m_uiIndex;
+
+    EZ_ALWAYS_INLINE bool operator<(const DepthSortEntry& rhs) const { return m_fDistSqr > rhs.m_fDistSqr; }
+  };
+
+  void CreateSortPositions(ezDynamicArray<ezVec4>& out_Positions, ezUInt32 uiNumParticles, ezUInt32 uiFrame)
+  {
+    out_Positions.SetCountUninitialized(uiNumParticles);
+
+    for (ezUInt32 i = 0; i < uiNumParticles; ++i)
+    {
+      // particles drift slowly, so the order changes a little from frame to frame
+      const float f = static_cast<float>((i * 7919) % 1000);
+      out_Positions[i].Set(f * 0.1f + uiFrame * 0.002f * (i % 5), ezMath::Sin(ezAngle::Radian(f + uiFrame * 0.01f)) * 10.0f, f * 0.01f, 1.0f);
+    }
+  }
+
+  bool IsSortedBackToFront(const ezDynamicArray<ezVec4>& positions, ezArrayPtr<const ezUInt32> sorted, const ezVec3& vCameraPos)
+  {
+    if (sorted.GetCount() != positions.GetCount())
+      return false;
+
+    ezDynamicArray<bool> seen;
+    seen.SetCount(positions.GetCount());
+
+    float fPrevDistSqr = ezMath::MaxValue<float>();
+    for (ezUInt32 idx : sorted)
+    {
+      if (idx >= positions.GetCount() || seen[idx])
+        return false;
+
+      seen[idx] = true;
+
+      const float fDistSqr = (positions[idx].GetAsVec3() - vCameraPos).GetLengthSquared();
+      if (fDistSqr > fPrevDistSqr)
+        return false;
+
+      fPrevDistSqr = fDistSqr;
+    }
+
+    return true;
+  }
+} // namespace
+
+EZ_CREATE_SIMPLE_TEST_GROUP(Particles);
+
+EZ_CREATE_SIMPLE_TEST(Particles, SimulationPerformance)
+{
+  ezStartup::StartupCoreSystems();
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "SIMD kernels match scalar code")
+  {
+    // not a multiple of 4, to also run the remainder loops
+    constexpr ezUInt32 uiNum = 1003;
+
+    ezDynamicArray<ezVec3> velocities, velocitiesRef;
+    ezDynamicArray<ezSimdVec4f, ezAlignedAllocatorWrapper> positions;
+    ezDynamicArray<ezVec4> positionsRef;
+    ezDynamicArray<ezVec3> lastPositions;
+
+    for (ezUInt32 i = 0; i < uiNum; ++i)
+    {
+      const float f = static_cast<float>(i);
+      velocities.PushBack(ezVec3(f, 2.0f * f, -f));
+      positions.PushBack(ezSimdVec4f(-f, f, 0.5f * f, 7.0f));
+      positionsRef.PushBack(ezVec4(-f, f, 0.5f * f, 7.0f));
+    }
+
+    velocitiesRef = velocities;
+    lastPositions.SetCount(uiNum);
+
+    const ezVec3 vAdd(1.0f, -2.0f, 3.0f);
+    ezSimdVec4f vAddSimd;
+    vAddSimd.Load<3>(&vAdd.x);
+
+    ezParticleSimdKernels::AddToFloat3(velocities.GetData(), uiNum, vAdd);
+    ezParticleSimdKernels::ScaleFloat3(velocities.GetData(), uiNum, 0.5f);
+    ezParticleSimdKernels::AddToFloat4(positions.GetData(), uiNum, vAddSimd);
+    ezParticleSimdKernels::IntegrateVelocity(positions.GetData(), velocities.GetData(), uiNum, 0.25f);
+    ezParticleSimdKernels::CopyFloat4ToFloat3(lastPositions.GetData(), positions.GetData(), uiNum);
+
+    for (ezUInt32 i = 0; i < uiNum; ++i)
+    {
+      velocitiesRef[i] = (velocitiesRef[i] + vAdd) * 0.5f;
+      positionsRef[i] += vAdd.GetAsVec4(0.0f);
+      positionsRef[i] += (velocitiesRef[i] * 0.25f).GetAsVec4(0.0f);
+
+      ezVec4 pos;
+      positions[i].Store<4>(&pos.x);
+
+      EZ_TEST_VEC3(velocities[i], velocitiesRef[i], 0.0f);
+      EZ_TEST_VEC4(pos, positionsRef[i], 0.001f);
+      EZ_TEST_VEC3(lastPositions[i], pos.GetAsVec3(), 0.0f);
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Parallel matches sequential")
+  {
+    ezProcessingStreamGroup groups[2];
+
+    for (ezUInt32 g = 0; g < 2; ++g)
+    {
+      groups[g].AddStream("Position", ezProcessingStream::DataType::Float4);
+      groups[g].AddStream("Velocity", ezProcessingStream::DataType::Float3);
+      groups[g].AddProcessor(EZ_DEFAULT_NEW(ParticleStepProcessor));
+      groups[g].SetSize(10000);
+      groups[g].SetParallelChunkSize(g == 0 ? 0 : 256);
+      groups[g].InitializeElements(9998);
+
+      for (ezUInt32 uiFrame = 0; uiFrame < 4; ++uiFrame)
+      {
+        groups[g].Process();
+      }
+    }
+
+    const ezProcessingStream* pPos0 = groups[0].GetStreamByName("Position");
+    const ezProcessingStream* pPos1 = groups[1].GetStreamByName("Position");
+
+    EZ_TEST_INT(groups[1].GetNumActiveElements(), 9998);
+    EZ_TEST_BOOL(ezMemoryUtils::IsEqual(pPos0->GetData<ezUInt8>(), pPos1->GetData<ezUInt8>(), static_cast<size_t>(9998 * pPos0->GetElementStride())));
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Depth sort")
+  {
+    ezParticleDepthSort depthSort;
+    ezDynamicArray<ezVec4> positions;
+    ezVec3 vCameraPos(-5, 3, 2);
+
+    // coherent frames, including particles dying and spawning
+    for (ezUInt32 uiFrame = 0; uiFrame < 10; ++uiFrame)
+    {
+      CreateSortPositions(positions, 1000 + (uiFrame % 3) * 17 - (uiFrame % 2) * 31, uiFrame);
+      EZ_TEST_BOOL(IsSortedBackToFront(positions, depthSort.Sort(positions.GetData(), positions.GetCount(), vCameraPos), vCameraPos));
+    }
+
+    // camera jump, falls back to the radix sort
+    vCameraPos.Set(100, -50, 20);
+    EZ_TEST_BOOL(IsSortedBackToFront(positions, depthSort.Sort(positions.GetData(), positions.GetCount(), vCameraPos), vCameraPos));
+
+    // no particles left
+    EZ_TEST_INT(depthSort.Sort(positions.GetData(), 0, vCameraPos).GetCount(), 0);
+
+    positions.SetCount(1);
+    EZ_TEST_INT(depthSort.Sort(positions.GetData(), 1, vCameraPos)[0], 0);
+  }
+
+  EZ_TEST_BLOCK(EZ_PERFORMANCE_TESTS_STATE, "Depth sort N particles")
+  {
+    ezDynamicArray<ezVec4> positions;
+    const ezVec3 vCameraPos(-5, 3, 2);
+
+    ezTime tComparison, tIncremental;
+
+    {
+      ezDynamicArray<DepthSortEntry> sorted;
+      sorted.SetCountUninitialized(NUM_PARTICLES);
+
+      for (ezUInt32 uiFrame = 0; uiFrame < NUM_FRAMES; ++uiFrame)
+      {
+        CreateSortPositions(positions, NUM_PARTICLES, uiFrame);
+
+        const ezTime tStart = ezTime::Now();
+
+        for (ezUInt32 i = 0; i < NUM_PARTICLES; ++i)
+        {
+          sorted[i].m_fDistSqr = (positions[i].GetAsVec3() - vCameraPos).GetLengthSquared();
+          sorted[i].m_uiIndex = i;
+        }
+
+        sorted.Sort();
+
+        tComparison += ezTime::Now() - tStart;
+      }
+    }
+
+    {
+      ezParticleDepthSort depthSort;
+
+      for (ezUInt32 uiFrame = 0; uiFrame < NUM_FRAMES; ++uiFrame)
+      {
+        CreateSortPositions(positions, NUM_PARTICLES, uiFrame);
+
+        const ezTime tStart = ezTime::Now();
+        depthSort.Sort(positions.GetData(), NUM_PARTICLES, vCameraPos);
+        tIncremental += ezTime::Now() - tStart;
+      }
+    }
+
+    LogParticlesPerMs("Comparison sort", tComparison);
+    LogParticlesPerMs("Incremental radix sort", tIncremental);
+  }
+
+  EZ_TEST_BLOCK(EZ_PERFORMANCE_TESTS_STATE, "Simulate N particles")
+  {
+    ezLog::Info("[test]Simulating {0} particles over {1} frames", NUM_PARTICLES, NUM_FRAMES);
+
+    LogParticlesPerMs("Scalar", SimulateParticles(false, 0));
+    LogParticlesPerMs("SIMD", SimulateParticles(true, 0));
+    LogParticlesPerMs("SIMD, parallel chunks of 2048", SimulateParticles(true, 2048));
+    LogParticlesPerMs("SIMD, parallel chunks of 8192", SimulateParticles(true, 8192));
+  }
+
+  ezStartup::ShutdownCoreSystems();
+}
@@ -0,0 +1,270 @@
+#include <GameEngineTest/GameEngineTestPCH.h>
+
+#include <Foundation/Containers/Deque.h>
+#include <Utilities/PathFinding/GraphSearch.h>
+#include <Utilities/PathFinding/GridNavmesh.h>
+
+#define EZ_PERFORMANCE_TESTS_STATE ezTestBlock::DisabledNoWarning
+
+namespace PathSearchTestDetail
+{
+  enum constants
+  {
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEBUG)
+    NUM_SEARCHES = 5,
+#else
+    NUM_SEARCHES = 50,
+#endif
+  };
+
+  /// Creates a grid with a few walls that have gaps in them, so that paths have to take detours.
+  static void CreateGrid(ezGameGrid<ezUInt8>& out_Grid, ezUInt16 uiSize)
+  {
+    out_Grid.CreateGrid(uiSize, uiSize);
+
+    for (ezUInt32 y = 0; y < uiSize; ++y)
+    {
+      for (ezUInt32 x = 0; x < uiSize; ++x)
+      {
+        const bool bWall = (x % 16 == 8) && ((y + x) % 29 != 0);
+        out_Grid.GetCell(ezVec2I32(x, y)) = bWall ? 1 : 0;
+      }
+    }
+  }
+
+  static bool IsSameCellType(ezUInt32 uiCell1, ezUInt32 uiCell2, void* pPassThrough)
+  {
+    const ezGameGrid<ezUInt8>* pGrid = static_cast<const ezGameGrid<ezUInt8>*>(pPassThrough);
+    return pGrid->GetCell(uiCell1) == pGrid->GetCell(uiCell2);
+  }
+
+  static bool IsCellBlocked(ezUInt32 uiCell, void* pPassThrough)
+  {
+    const ezGameGrid<ezUInt8>* pGrid = static_cast<const ezGameGrid<ezUInt8>*>(pPassThrough);
+    return pGrid->GetCell(uiCell) != 0;
+  }
+
+  /// Four-way movement with unit costs and the manhattan distance as the (optimistic) estimation.
+  class GridStateGenerator : public ezPathStateGenerator<ezPathState>
+  {
+  public:
+    GridStateGenerator(const ezGameGrid<ezUInt8>& grid)
+      : m_Grid(grid)
+    {
+    }
+
+    virtual void StartSearch(ezInt64 iStartNodeIndex, const ezPathState* pStartState, ezInt64 iTargetNodeIndex) override
+    {
+      m_vTarget = m_Grid.ConvertCellIndexToCoordinate(static_cast<ezUInt32>(iTargetNodeIndex));
+    }
+
+    virtual void GenerateAdjacentStates(ezInt64 iNodeIndex, const ezPathState& StartState, ezPathSearch<ezPathState>* pPathSearch) override
+    {
+      const ezVec2I32 vCoord = m_Grid.ConvertCellIndexToCoordinate(static_cast<ezUInt32>(iNodeIndex));
+      const ezVec2I32 directions[4] = {ezVec2I32(1, 0), ezVec2I32(-1, 0), ezVec2I32(0, 1), ezVec2I32(0, -1)};
+
+      for (const ezVec2I32& dir : directions)
+      {
+        const ezVec2I32 vNeighbor(vCoord.x + dir.x, vCoord.y + dir.y);
+
+        if (!m_Grid.IsValidCellCoordinate(vNeighbor) || m_Grid.GetCell(vNeighbor) != 0)
+          continue;
+
+        ezPathState state;
+        state.m_fCostToNode = StartState.m_fCostToNode + 1.0f;
+        state.m_fEstimatedCostToTarget = state.m_fCostToNode + ezMath::Abs(m_vTarget.x - vNeighbor.x) + ezMath::Abs(m_vTarget.y - vNeighbor.y);
+
+        pPathSearch->AddPathNode(m_Grid.ConvertCellCoordinateToIndex(vNeighbor), state);
+      }
+    }
+
+  private:
+    const ezGameGrid<ezUInt8>& m_Grid;
+    ezVec2I32 m_vTarget = ezVec2I32(0, 0);
+  };
+
+  static bool IsInColumn12(ezInt64 iNodeIndex, const ezPathState& state)
+  {
+    // the test grid is 64 cells wide
+    return iNodeIndex % 64 == 12;
+  }
+
+  /// Breadth first search as the reference for the shortest path length.
+  static ezInt32 GetShortestPathLength(const ezGameGrid<ezUInt8>& grid, ezUInt32 uiStart, ezUInt32 uiTarget)
+  {
+    ezDynamicArray<ezInt32> distances;
+    distances.SetCount(grid.GetNumCells(), -1);
+
+    ezDeque<ezUInt32> queue;
+    queue.PushBack(uiStart);
+    distances[uiStart] = 0;
+
+    while (!queue.IsEmpty())
+    {
+      const ezUInt32 uiCell = queue.PeekFront();
+      queue.PopFront();
+
+      if (uiCell == uiTarget)
+        return distances[uiCell];
+
+      const ezVec2I32 vCoord = grid.ConvertCellIndexToCoordinate(uiCell);
+      const ezVec2I32 neighbors[4] = {ezVec2I32(vCoord.x + 1, vCoord.y), ezVec2I32(vCoord.x - 1, vCoord.y), ezVec2I32(vCoord.x, vCoord.y + 1), ezVec2I32(vCoord.x, vCoord.y - 1)};
+
+      for (const ezVec2I32& vNeighbor : neighbors)
+      {
+        if (!grid.IsValidCellCoordinate(vNeighbor) || grid.GetCell(vNeighbor) != 0)
+          continue;
+
+        const ezUInt32 uiNeighbor = grid.ConvertCellCoordinateToIndex(vNeighbor);
+        if (distances[uiNeighbor] >= 0)
+          continue;
+
+        distances[uiNeighbor] = distances[uiCell] + 1;
+        queue.PushBack(uiNeighbor);
+      }
+    }
+
+    return -1;
+  }
+} // namespace PathSearchTestDetail
+
+EZ_CREATE_SIMPLE_TEST(DataStructures, PathSearch)
+{
+  using namespace PathSearchTestDetail;
+
+  ezGameGrid<ezUInt8> grid;
+  CreateGrid(grid, 64);
+
+  GridStateGenerator generator(grid);
+
+  const ezUInt32 uiStart = grid.ConvertCellCoordinateToIndex(ezVec2I32(1, 2));
+  const ezUInt32 uiTarget = grid.ConvertCellCoordinateToIndex(ezVec2I32(60, 61));
+  const ezInt32 iExpectedLength = GetShortestPathLength(grid, uiStart, uiTarget);
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "FindPath")
+  {
+    EZ_TEST_BOOL(iExpectedLength > 0);
+
+    ezPathSearch<ezPathState> sparseSearch;
+    sparseSearch.SetPathStateGenerator(&generator);
+
+    ezPathSearch<ezPathState> denseSearch;
+    denseSearch.SetPathStateGenerator(&generator);
+    denseSearch.SetDenseNodeCount(grid.GetNumCells());
+
+    // run everything twice, the second search reuses the memory of the first one
+    for (ezUInt32 iRun = 0; iRun < 2; ++iRun)
+    {
+      ezDeque<ezPathSearch<ezPathState>::PathResultData> sparsePath;
+      EZ_TEST_BOOL(sparseSearch.FindPath(uiStart, ezPathState(), uiTarget, sparsePath).Succeeded());
+
+      ezDeque<ezPathSearch<ezPathState>::PathResultData> densePath;
+      EZ_TEST_BOOL(denseSearch.FindPath(uiStart, ezPathState(), uiTarget, densePath).Succeeded());
+
+      EZ_TEST_INT(sparsePath.GetCount(), iExpectedLength + 1);
+      EZ_TEST_INT(densePath.GetCount(), iExpectedLength + 1);
+
+      EZ_TEST_INT(sparsePath.PeekFront().m_iNodeIndex, uiStart);
+      EZ_TEST_INT(sparsePath.PeekBack().m_iNodeIndex, uiTarget);
+      EZ_TEST_FLOAT(sparsePath.PeekBack().m_pPathState->m_fCostToNode, (float)iExpectedLength, 0.0f);
+      EZ_TEST_FLOAT(densePath.PeekBack().m_pPathState->m_fCostToNode, (float)iExpectedLength, 0.0f);
+    }
+
+    // the target is walled in
+    {
+      ezGameGrid<ezUInt8> blockedGrid = grid;
+      blockedGrid.GetCell(ezVec2I32(59, 61)) = 1;
+      blockedGrid.GetCell(ezVec2I32(61, 61)) = 1;
+      blockedGrid.GetCell(ezVec2I32(60, 60)) = 1;
+      blockedGrid.GetCell(ezVec2I32(60, 62)) = 1;
+
+      GridStateGenerator blockedGenerator(blockedGrid);
+      denseSearch.SetPathStateGenerator(&blockedGenerator);
+
+      ezDeque<ezPathSearch<ezPathState>::PathResultData> path;
+      EZ_TEST_BOOL(denseSearch.FindPath(uiStart, ezPathState(), uiTarget, path).Failed());
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "FindClosest")
+  {
+    ezPathSearch<ezPathState> search;
+    search.SetPathStateGenerator(&generator);
+    search.SetDenseNodeCount(grid.GetNumCells());
+
+    ezDeque<ezPathSearch<ezPathState>::PathResultData> path;
+    EZ_TEST_BOOL(search.FindClosest(uiStart, ezPathState(), IsInColumn12, path).Succeeded());
+    EZ_TEST_INT(grid.ConvertCellIndexToCoordinate(static_cast<ezUInt32>(path.PeekBack().m_iNodeIndex)).x, 12);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "ezGridNavmesh::FindAreaPath")
+  {
+    ezGridNavmesh navmesh;
+    navmesh.CreateFromGrid(grid, IsSameCellType, &grid, IsCellBlocked, &grid);
+
+    const ezInt32 iStartArea = navmesh.GetAreaAt(ezVec2I32(1, 2));
+    const ezInt32 iTargetArea = navmesh.GetAreaAt(ezVec2I32(60, 61));
+
+    ezDynamicArray<ezInt32> areaPath;
+    EZ_TEST_BOOL(navmesh.FindAreaPath(iStartArea, iTargetArea, areaPath).Succeeded());
+    EZ_TEST_INT(areaPath[0], iStartArea);
+    EZ_TEST_INT(areaPath.PeekBack(), iTargetArea);
+
+    // consecutive areas must be connected through an edge
+    for (ezUInt32 i = 1; i < areaPath.GetCount(); ++i)
+    {
+      const ezGridNavmesh::ConvexArea& area = navmesh.GetConvexArea(areaPath[i - 1]);
+
+      bool bConnected = false;
+      for (ezUInt32 e = 0; e < area.m_uiNumEdges; ++e)
+      {
+        bConnected |= navmesh.GetAreaEdge(area.m_uiFirstEdge + e).m_iNeighborArea == areaPath[i];
+      }
+
+      EZ_TEST_BOOL(bConnected);
+    }
+
+    EZ_TEST_BOOL(navmesh.FindAreaPath(iStartArea, navmesh.GetAreaAt(ezVec2I32(8, 5)), areaPath).Failed());
+  }
+
+  EZ_TEST_BLOCK(EZ_PERFORMANCE_TESTS_STATE, "Grid sizes")
+  {
+    const ezUInt16 sizes[] = {64, 256, 1024};
+
+    for (ezUInt16 uiSize : sizes)
+    {
+      ezGameGrid<ezUInt8> perfGrid;
+      CreateGrid(perfGrid, uiSize);
+
+      GridStateGenerator perfGenerator(perfGrid);
+
+      ezPathSearch<ezPathState> sparseSearch;
+      sparseSearch.SetPathStateGenerator(&perfGenerator);
+
+      ezPathSearch<ezPathState> denseSearch;
+      denseSearch.SetPathStateGenerator(&perfGenerator);
+      denseSearch.SetDenseNodeCount(perfGrid.GetNumCells());
+
+      const ezUInt32 uiPerfStart = perfGrid.ConvertCellCoordinateToIndex(ezVec2I32(1, 1));
+      const ezUInt32 uiPerfTarget = perfGrid.ConvertCellCoordinateToIndex(ezVec2I32(uiSize - 2, uiSize - 3));
+
+      ezDeque<ezPathSearch<ezPathState>::PathResultData> path;
+
+      ezTime tStart = ezTime::Now();
+      for (ezUInt32 i = 0; i < NUM_SEARCHES; ++i)
+      {
+        EZ_TEST_BOOL(sparseSearch.FindPath(uiPerfStart, ezPathState(), uiPerfTarget, path).Succeeded());
+      }
+      const ezTime tSparse = ezTime::Now() - tStart;
+
+      tStart = ezTime::Now();
+      for (ezUInt32 i = 0; i < NUM_SEARCHES; ++i)
+      {
+        EZ_TEST_BOOL(denseSearch.FindPath(uiPerfStart, ezPathState(), uiPerfTarget, path).Succeeded());
+      }
+      const ezTime tDense = ezTime::Now() - tStart;
+
+      ezLog::Info("[test]{0}x{0} grid, {1} searches, hash table states: {2}ms, dense states: {3}ms", uiSize, NUM_SEARCHES, ezArgF(tSparse.GetMilliseconds(), 3), ezArgF(tDense.GetMilliseconds(), 3));
+    }
+  }
+}
@@ -0,0 +1,135 @@
+#include <GameEngineTest/GameEngineTestPCH.h>
+
+#ifdef BUILDSYSTEM_ENABLE_PHYSX_SUPPORT
+
+#  include <PhysXPlugin/Components/PxStaticActorComponent.h>
+#  include <PhysXPlugin/Shapes/PxShapeBoxComponent.h>
+#  include <PhysXPlugin/WorldModule/PhysXWorldModule.h>
+
+EZ_CREATE_SIMPLE_TEST_GROUP(PhysX);
+
+namespace PhysXQueryTestDetail
+{
+  /// A 10x10m static box with its top face at z = 0, so requests starting further than 5m from the origin miss it.
+  static void CreateGround(ezWorld& world)
+  {
+    ezGameObjectDesc desc;
+    desc.m_LocalPosition.Set(0, 0, -0.5f);
+
+    ezGameObject* pObject = nullptr;
+    world.CreateObject(desc, pObject);
+
+    ezPxStaticActorComponent* pActor = nullptr;
+    ezPxStaticActorComponent::CreateComponent(pObject, pActor);
+
+    ezPxShapeBoxComponent* pBox = nullptr;
+    ezPxShapeBoxComponent::CreateComponent(pObject, pBox);
+    pBox->SetExtents(ezVec3(10, 10, 1));
+  }
+
+  static void CreateRequests(ezDynamicArray<ezPhysicsCastRequest>& out_Requests)
+  {
+    for (ezInt32 y = -8; y <= 8; ++y)
+    {
+      for (ezInt32 x = -8; x <= 8; ++x)
+      {
+        ezPhysicsCastRequest& request = out_Requests.ExpandAndGetRef();
+        request.m_vStart.Set(x * 0.75f, y * 0.75f, 5.0f);
+        request.m_vDir.Set(0.1f * (x % 3), 0.0f, -1.0f);
+        request.m_vDir.Normalize();
+        request.m_fDistance = (x + y) % 4 == 0 ? 3.0f : 10.0f;
+      }
+    }
+
+    // degenerate requests are misses, not errors
+    out_Requests[0].m_fDistance = 0.0f;
+    out_Requests[1].m_vDir.SetZero();
+    out_Requests[2].m_vStart.SetZero();
+    out_Requests[2].m_fDistance = 0.0f;
+  }
+} // namespace PhysXQueryTestDetail
+
+EZ_CREATE_SIMPLE_TEST(PhysX, BatchQueries)
+{
+  using namespace PhysXQueryTestDetail;
+
+  ezWorldDesc worldDesc("PhysXQueryTest");
+  ezWorld world(worldDesc);
+  EZ_LOCK(world.GetWriteMarker());
+
+  const ezPhysXWorldModule* pModule = world.GetOrCreateModule<ezPhysXWorldModule>();
+  EZ_TEST_BOOL(pModule != nullptr);
+  if (pModule == nullptr)
+    return;
+
+  CreateGround(world);
+
+  // the actor is added to the PhysX scene once the simulation starts
+  world.SetWorldSimulationEnabled(true);
+  world.Update();
+
+  ezDynamicArray<ezPhysicsCastRequest> requests;
+  CreateRequests(requests);
+
+  const ezPhysicsQueryParameters params(0);
+
+  ezDynamicArray<ezPhysicsCastResult> results;
+  results.SetCount(requests.GetCount());
+  ezDynamicArray<bool> hits;
+  hits.SetCount(requests.GetCount());
+
+  for (bool bMultiThreaded : {false, true})
+  {
+    EZ_TEST_BLOCK(ezTestBlock::Enabled, bMultiThreaded ? "RaycastBatch (multi-threaded)" : "RaycastBatch")
+    {
+      const ezUInt32 uiNumHits = pModule->RaycastBatch(requests, results, hits, params, ezPhysicsHitCollection::Closest, bMultiThreaded);
+
+      ezUInt32 uiExpectedHits = 0;
+      for (ezUInt32 i = 0; i < requests.GetCount(); ++i)
+      {
+        ezPhysicsCastResult expected;
+        const bool bHit = pModule->Raycast(expected, requests[i].m_vStart, requests[i].m_vDir, requests[i].m_fDistance, params);
+
+        EZ_TEST_BOOL(hits[i] == bHit);
+
+        if (bHit && hits[i])
+        {
+          ++uiExpectedHits;
+          EZ_TEST_VEC3(results[i].m_vPosition, expected.m_vPosition, 0.001f);
+          EZ_TEST_FLOAT(results[i].m_fDistance, expected.m_fDistance, 0.001f);
+        }
+      }
+
+      EZ_TEST_INT(uiNumHits, uiExpectedHits);
+      EZ_TEST_BOOL(uiNumHits > 0 && uiNumHits < requests.GetCount());
+      EZ_TEST_BOOL(!hits[0] && !hits[1] && !hits[2]);
+    }
+
+    EZ_TEST_BLOCK(ezTestBlock::Enabled, bMultiThreaded ? "SweepTestSphereBatch (multi-threaded)" : "SweepTestSphereBatch")
+    {
+      const ezUInt32 uiNumHits = pModule->SweepTestSphereBatch(0.5f, requests, results, hits, params, ezPhysicsHitCollection::Closest, bMultiThreaded);
+
+      ezUInt32 uiExpectedHits = 0;
+      for (ezUInt32 i = 0; i < requests.GetCount(); ++i)
+      {
+        ezPhysicsCastResult expected;
+        const bool bHit = pModule->SweepTestSphere(expected, 0.5f, requests[i].m_vStart, requests[i].m_vDir, requests[i].m_fDistance, params);
+
+        EZ_TEST_BOOL(hits[i] == bHit);
+
+        if (bHit && hits[i])
+        {
+          ++uiExpectedHits;
+          EZ_TEST_VEC3(results[i].m_vPosition, expected.m_vPosition, 0.001f);
+          EZ_TEST_FLOAT(results[i].m_fDistance, expected.m_fDistance, 0.001f);
+        }
+      }
+
+      EZ_TEST_INT(uiNumHits, uiExpectedHits);
+      EZ_TEST_BOOL(uiNumHits > 0 && uiNumHits < requests.GetCount());
+      EZ_TEST_BOOL(!hits[0] && !hits[1] && !hits[2]);
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,178 @@
+#include <GameEngineTest/GameEngineTestPCH.h>
+
+#include <Core/ResourceManager/ResourceManager.h>
+#include <Foundation/Configuration/Startup.h>
+#include <GameEngine/VisualScript/Nodes/VisualScriptMathNodes.h>
+#include <GameEngine/VisualScript/Nodes/VisualScriptMessageNodes.h>
+#include <GameEngine/VisualScript/Nodes/VisualScriptVariableNodes.h>
+#include <GameEngine/VisualScript/VisualScriptInstance.h>
+#include <GameEngine/VisualScript/VisualScriptResource.h>
+
+#define EZ_PERFORMANCE_TESTS_STATE ezTestBlock::DisabledNoWarning
+
+namespace
+{
+  enum constants
+  {
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEBUG)
+    NUM_INSTANCES = 64,
+    NUM_EXECUTIONS = 16,
+#else
+    NUM_INSTANCES = 1000,
+    NUM_EXECUTIONS = 100,
+#endif
+  };
+
+  void AddNode(ezVisualScriptResourceDescriptor& desc, const ezRTTI* pType)
+  {
+    auto& node = desc.m_Nodes.ExpandAndGetRef();
+    node.m_pType = pType;
+    node.m_sTypeName = pType->GetTypeName();
+    node.m_uiFirstProperty = static_cast<ezUInt16>(desc.m_Properties.GetCount());
+  }
+
+  void AddProperty(ezVisualScriptResourceDescriptor& desc, const char* szName, const ezVariant& value)
+  {
+    auto& prop = desc.m_Properties.ExpandAndGetRef();
+    prop.m_sName = szName;
+    prop.m_Value = value;
+
+    desc.m_Nodes.PeekBack().m_uiNumProperties++;
+  }
+
+  void AddDataConnection(ezVisualScriptResourceDescriptor& desc, ezUInt16 uiSourceNode, ezUInt8 uiOutputPin, ezUInt16 uiTargetNode, ezUInt8 uiInputPin)
+  {
+    auto& con = desc.m_DataPaths.ExpandAndGetRef();
+    con.m_uiSourceNode = uiSourceNode;
+    con.m_uiOutputPin = uiOutputPin;
+    con.m_uiOutputPinType = ezVisualScriptDataPinType::Number;
+    con.m_uiTargetNode = uiTargetNode;
+    con.m_uiInputPin = uiInputPin;
+    con.m_uiInputPinType = ezVisualScriptDataPinType::Number;
+  }
+
+  /// On every update, reads the variable 'x', adds 1 in each of the uiChainLength math nodes and stores the result in 'x' again.
+  /// The math nodes are added in reverse order, so that the dependencies do not simply follow the node order.
+  ezVisualScriptResourceHandle CreateScript(ezUInt32 uiChainLength)
+  {
+    ezVisualScriptResourceDescriptor desc;
+
+    AddNode(desc, ezGetStaticRTTI<ezVisualScriptNode_ScriptUpdateEvent>());
+
+    AddNode(desc, ezGetStaticRTTI<ezVisualScriptNode_StoreNumber>());
+    AddProperty(desc, "Name", "x");
+
+    AddNode(desc, ezGetStaticRTTI<ezVisualScriptNode_Number>());
+    AddProperty(desc, "Name", "x");
+
+    for (ezUInt32 i = 0; i < uiChainLength; ++i)
+    {
+      AddNode(desc, ezGetStaticRTTI<ezVisualScriptNode_MultiplyAdd>());
+      AddProperty(desc, "b1", 1.0);
+    }
+
+    const ezUInt16 uiFirstMathNode = 3;
+
+    {
+      auto& con = desc.m_ExecutionPaths.ExpandAndGetRef();
+      con.m_uiSourceNode = 0;
+      con.m_uiOutputPin = 0;
+      con.m_uiTargetNode = 1;
+      con.m_uiInputPin = 0;
+    }
+
+    ezUInt16 uiSourceNode = 2;
+    for (ezUInt32 i = uiChainLength; i > 0; --i)
+    {
+      const ezUInt16 uiMathNode = static_cast<ezUInt16>(uiFirstMathNode + i - 1);
+      AddDataConnection(desc, uiSourceNode, 0, uiMathNode, 0);
+      uiSourceNode = uiMathNode;
+    }
+
+    AddDataConnection(desc, uiSourceNode, 0, 1, 0);
+
+    auto& param = desc.m_NumberParameters.ExpandAndGetRef();
+    param.m_sName.Assign("x");
+    param.m_Value = 0.0;
+
+    ezStringBuilder sResourceID;
+    sResourceID.Format("VisualScriptPerformanceChain{0}", uiChainLength);
+
+    return ezResourceManager::GetOrCreateResource<ezVisualScriptResource>(sResourceID, std::move(desc));
+  }
+
+  ezTime ExecuteScripts(ezDynamicArray<ezUniquePtr<ezVisualScriptInstance>>& instances)
+  {
+    const ezTime tStart = ezTime::Now();
+
+    for (ezUInt32 uiExecution = 0; uiExecution < NUM_EXECUTIONS; ++uiExecution)
+    {
+      for (auto& pInstance : instances)
+      {
+        pInstance->ExecuteScript();
+      }
+    }
+
+    return ezTime::Now() - tStart;
+  }
+} // namespace
+
+EZ_CREATE_SIMPLE_TEST_GROUP(VisualScript);
+
+EZ_CREATE_SIMPLE_TEST(VisualScript, ExecutionPerformance)
+{
+  ezStartup::StartupCoreSystems();
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Dependency chain")
+  {
+    const ezUInt32 uiChainLength = 10;
+
+    ezVisualScriptInstance instance;
+    instance.Configure(CreateScript(uiChainLength), nullptr);
+
+    for (ezUInt32 i = 0; i < NUM_EXECUTIONS; ++i)
+    {
+      instance.ExecuteScript();
+    }
+
+    double fValue = 0.0;
+    instance.GetLocalVariables().RetrieveDouble(ezTempHashedString("x"), fValue, -1.0);
+    EZ_TEST_DOUBLE(fValue, static_cast<double>(NUM_EXECUTIONS * uiChainLength), 0.0);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Activity")
+  {
+    ezVisualScriptInstance instance;
+    instance.Configure(CreateScript(2), nullptr);
+
+    ezVisualScriptInstanceActivity activity;
+    instance.ExecuteScript(&activity);
+
+    // update event -> store, number -> math -> math -> store
+    EZ_TEST_INT(activity.m_ActiveExecutionConnections.GetCount(), 1);
+    EZ_TEST_INT(activity.m_ActiveDataConnections.GetCount(), 3);
+    EZ_TEST_INT(activity.m_ActiveExecutionConnections[0], 0);
+  }
+
+  EZ_TEST_BLOCK(EZ_PERFORMANCE_TESTS_STATE, "Execute N scripts")
+  {
+    const ezUInt32 chainLengths[] = {1, 8, 32, 128};
+
+    for (ezUInt32 uiChainLength : chainLengths)
+    {
+      ezVisualScriptResourceHandle hScript = CreateScript(uiChainLength);
+
+      ezDynamicArray<ezUniquePtr<ezVisualScriptInstance>> instances;
+      for (ezUInt32 i = 0; i < NUM_INSTANCES; ++i)
+      {
+        instances.PushBack(EZ_DEFAULT_NEW(ezVisualScriptInstance));
+        instances.PeekBack()->Configure(hScript, nullptr);
+      }
+
+      const ezTime tExecute = ExecuteScripts(instances);
+
+      ezLog::Info("[test]Executing {0} scripts with {1} math nodes: {2}ms per update, {3} node executions per second", NUM_INSTANCES, uiChainLength,
+        ezArgF(tExecute.GetMilliseconds() / NUM_EXECUTIONS, 4), ezArgF(NUM_INSTANCES * NUM_EXECUTIONS * (uiChainLength + 3) / tExecute.GetSeconds(), 0));
+    }
+  }
+}
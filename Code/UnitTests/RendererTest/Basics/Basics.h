@@ -18,6 +18,7 @@ private:
     ST_Textures3D,
     ST_TexturesCube,
     ST_LineRendering,
+    ST_CommandRecording,
   };
 
   virtual void SetupSubTests() override
@@ -29,6 +30,7 @@ private:
     // AddSubTest("3D Textures", SubTests::ST_Textures3D); /// \todo 3D Texture support is currently not implemented
     AddSubTest("Cube Textures", SubTests::ST_TexturesCube);
     AddSubTest("Line Rendering", SubTests::ST_LineRendering);
+    AddSubTest("Command Recording", SubTests::ST_CommandRecording);
   }
 
 
@@ -42,6 +44,7 @@ private:
   ezTestAppRun SubtestTextures3D();
   ezTestAppRun SubtestTexturesCube();
   ezTestAppRun SubtestLineRendering();
+  ezTestAppRun SubtestCommandRecording();
 
   void RenderObjects(ezBitflags<ezShaderBindFlags> ShaderBindFlags);
   void RenderLineObjects(ezBitflags<ezShaderBindFlags> ShaderBindFlags);
@@ -71,6 +74,9 @@ private:
     if (iIdentifier == SubTests::ST_LineRendering)
       return SubtestLineRendering();
 
+    if (iIdentifier == SubTests::ST_CommandRecording)
+      return SubtestCommandRecording();
+
     return ezTestAppRun::Quit;
   }
 
@@ -0,0 +1,73 @@
+#include <RendererTest/RendererTestPCH.h>
+
+#include "Basics.h"
+#include <Foundation/Threading/TaskSystem.h>
+#include <RendererFoundation/CommandEncoder/CommandRecorder.h>
+
+namespace
+{
+  constexpr ezUInt32 s_uiNumChunks = 16;
+  constexpr ezUInt32 s_uiCommandsPerChunk = 64;
+
+  void RecordChunk(ezGALRenderCommandEncoder* pEncoder, ezUInt32 uiChunk)
+  {
+    ezStringBuilder sMarker;
+    sMarker.Format("Chunk {0}", uiChunk);
+    pEncoder->PushMarker(sMarker);
+
+    for (ezUInt32 i = 0; i < s_uiCommandsPerChunk; ++i)
+    {
+      const ezUInt32 uiValue = uiChunk * s_uiCommandsPerChunk + i;
+      pEncoder->SetViewport(ezRectFloat(0.0f, 0.0f, (float)(uiValue + 1), (float)(uiValue + 1)));
+      pEncoder->SetScissorRect(ezRectU32(0, 0, uiValue + 1, uiValue + 1));
+      pEncoder->SetPrimitiveTopology((i & 1) ? ezGALPrimitiveTopology::Lines : ezGALPrimitiveTopology::Triangles);
+    }
+
+    pEncoder->PopMarker();
+  }
+} // namespace
+
+ezTestAppRun ezRendererTestBasics::SubtestCommandRecording()
+{
+  BeginFrame();
+
+  ClearScreen(ezColor::Black);
+
+  // Reference: everything recorded sequentially into a single recorder
+  ezGALCommandRecorder sequential(*m_pDevice);
+  for (ezUInt32 uiChunk = 0; uiChunk < s_uiNumChunks; ++uiChunk)
+  {
+    RecordChunk(sequential.GetRenderCommandEncoder(), uiChunk);
+  }
+
+  // The same commands recorded in parallel, one recorder per chunk
+  ezDynamicArray<ezUniquePtr<ezGALCommandRecorder>> recorders;
+  for (ezUInt32 uiChunk = 0; uiChunk < s_uiNumChunks; ++uiChunk)
+  {
+    recorders.PushBack(EZ_DEFAULT_NEW(ezGALCommandRecorder, *m_pDevice));
+  }
+
+  ezTaskSystem::ParallelForIndexed(0, s_uiNumChunks, [&](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) {
+    for (ezUInt32 uiChunk = uiStartIndex; uiChunk < uiEndIndex; ++uiChunk)
+    {
+      RecordChunk(recorders[uiChunk]->GetRenderCommandEncoder(), uiChunk);
+    }
+  });
+
+  // Replaying the chunks in order must produce exactly the sequentially recorded stream
+  ezGALCommandRecorder combined(*m_pDevice);
+  for (auto& pRecorder : recorders)
+  {
+    pRecorder->Replay(combined, &combined, &combined);
+  }
+
+  EZ_TEST_INT(combined.GetCommandCount(), sequential.GetCommandCount());
+  EZ_TEST_INT(combined.GetCommandStream().GetCount(), sequential.GetCommandStream().GetCount());
+  EZ_TEST_BOOL(combined.GetCommandStream() == sequential.GetCommandStream());
+
+  combined.Replay(ezRenderContext::GetDefaultInstance()->GetRenderCommandEncoder());
+
+  EndFrame();
+
+  return ezTestAppRun::Quit;
+}
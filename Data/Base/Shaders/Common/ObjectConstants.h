@@ -24,6 +24,9 @@ struct EZ_ALIGN_16(ezPerInstanceData)
 
   Buffer<uint> perInstanceVertexColors;
 
+  // Maps the draw-local instance index to a slot in perInstanceData, only used when InstanceIndexOffset is valid
+  StructuredBuffer<uint> perInstanceIndices;
+
 #else // C++
 
   EZ_DEFINE_AS_POD_TYPE(ezPerInstanceData);
@@ -34,18 +37,29 @@ struct EZ_ALIGN_16(ezPerInstanceData)
 CONSTANT_BUFFER(ezObjectConstants, 2)
 {
   UINT1(InstanceDataOffset);
+  UINT1(InstanceIndexOffset); // 0xFFFFFFFF means perInstanceData is accessed directly without indirection
 };
 
 
 
 #if EZ_ENABLED(PLATFORM_SHADER)
 
+  uint GetInstanceDataIndex(uint instanceID)
+  {
+    [branch] if (InstanceIndexOffset == 0xFFFFFFFF)
+    {
+      return instanceID + InstanceDataOffset;
+    }
+
+    return perInstanceIndices[instanceID + InstanceIndexOffset];
+  }
+
   // Access to instance should usually go through this macro!
   // It's a macro so it can work with arbitrary input structs (for VS/GS/PS...)
   #if defined(CAMERA_MODE) && CAMERA_MODE == CAMERA_MODE_STEREO
-    #define GetInstanceData() perInstanceData[G.Input.InstanceID/2 + InstanceDataOffset]
+    #define GetInstanceData() perInstanceData[GetInstanceDataIndex(G.Input.InstanceID/2)]
   #else
-    #define GetInstanceData() perInstanceData[G.Input.InstanceID + InstanceDataOffset]
+    #define GetInstanceData() perInstanceData[GetInstanceDataIndex(G.Input.InstanceID)]
   #endif
   
   #define VERTEX_COLOR_ACCESS_OFFSET_BITS 28
@@ -0,0 +1,147 @@
+# Generated by CMake
+
+if("${CMAKE_MAJOR_VERSION}.${CMAKE_MINOR_VERSION}" LESS 2.8)
+   message(FATAL_ERROR "CMake >= 2.8.0 required")
+endif()
+if(CMAKE_VERSION VERSION_LESS "2.8.3")
+   message(FATAL_ERROR "CMake >= 2.8.3 required")
+endif()
+cmake_policy(PUSH)
+cmake_policy(VERSION 2.8.3...3.23)
+#----------------------------------------------------------------
+# Generated CMake target import file.
+#----------------------------------------------------------------
+
+# Commands may need to know the format version.
+set(CMAKE_IMPORT_FILE_VERSION 1)
+
+# Protect against multiple inclusion, which would fail when already imported targets are added once more.
+set(_cmake_targets_defined "")
+set(_cmake_targets_not_defined "")
+set(_cmake_expected_targets "")
+foreach(_cmake_expected_target IN ITEMS enet stb_image zlib zstd Foundation Texture)
+  list(APPEND _cmake_expected_targets "${_cmake_expected_target}")
+  if(TARGET "${_cmake_expected_target}")
+    list(APPEND _cmake_targets_defined "${_cmake_expected_target}")
+  else()
+    list(APPEND _cmake_targets_not_defined "${_cmake_expected_target}")
+  endif()
+endforeach()
+unset(_cmake_expected_target)
+if(_cmake_targets_defined STREQUAL _cmake_expected_targets)
+  unset(_cmake_targets_defined)
+  unset(_cmake_targets_not_defined)
+  unset(_cmake_expected_targets)
+  unset(CMAKE_IMPORT_FILE_VERSION)
+  cmake_policy(POP)
+  return()
+endif()
+if(NOT _cmake_targets_defined STREQUAL "")
+  string(REPLACE ";" ", " _cmake_targets_defined_text "${_cmake_targets_defined}")
+  string(REPLACE ";" ", " _cmake_targets_not_defined_text "${_cmake_targets_not_defined}")
+  message(FATAL_ERROR "Some (but not all) targets in this export set were already defined.\nTargets Defined: ${_cmake_targets_defined_text}\nTargets not yet defined: ${_cmake_targets_not_defined_text}\n")
+endif()
+unset(_cmake_targets_defined)
+unset(_cmake_targets_not_defined)
+unset(_cmake_expected_targets)
+
+
+# Create imported target enet
+add_library(enet SHARED IMPORTED)
+
+set_target_properties(enet PROPERTIES
+  INTERFACE_COMPILE_DEFINITIONS "UNICODE;_UNICODE;BUILDSYSTEM_ENABLE_ENET_SUPPORT"
+  INTERFACE_INCLUDE_DIRECTORIES "/root/repo/Code/ThirdParty"
+)
+
+# Create imported target stb_image
+add_library(stb_image SHARED IMPORTED)
+
+set_target_properties(stb_image PROPERTIES
+  INTERFACE_COMPILE_DEFINITIONS "UNICODE;_UNICODE"
+  INTERFACE_INCLUDE_DIRECTORIES "/root/repo/Code/ThirdParty"
+)
+
+# Create imported target zlib
+add_library(zlib STATIC IMPORTED)
+
+set_target_properties(zlib PROPERTIES
+  INTERFACE_COMPILE_DEFINITIONS "UNICODE;_UNICODE;BUILDSYSTEM_ENABLE_ZLIB_SUPPORT"
+  INTERFACE_INCLUDE_DIRECTORIES "/root/repo/Code/ThirdParty"
+  INTERFACE_LINK_LIBRARIES "\$<LINK_ONLY:-lgcc_s>;\$<LINK_ONLY:-lgcc>;\$<LINK_ONLY:pthread>;\$<LINK_ONLY:rt>;/usr/lib/x86_64-linux-gnu/libX11.so;\$<LINK_ONLY:sfml-window>;\$<LINK_ONLY:sfml-system>"
+)
+
+# Create imported target zstd
+add_library(zstd SHARED IMPORTED)
+
+set_target_properties(zstd PROPERTIES
+  INTERFACE_COMPILE_DEFINITIONS "UNICODE;_UNICODE;BUILDSYSTEM_ENABLE_ZSTD_SUPPORT"
+  INTERFACE_INCLUDE_DIRECTORIES "/root/repo/Code/ThirdParty"
+)
+
+# Create imported target Foundation
+add_library(Foundation STATIC IMPORTED)
+
+set_target_properties(Foundation PROPERTIES
+  INTERFACE_COMPILE_DEFINITIONS "UNICODE;_UNICODE"
+  INTERFACE_INCLUDE_DIRECTORIES "/root/repo/Code/Engine"
+  INTERFACE_LINK_LIBRARIES "\$<LINK_ONLY:-lgcc_s>;\$<LINK_ONLY:-lgcc>;\$<LINK_ONLY:pthread>;\$<LINK_ONLY:rt>;/usr/lib/x86_64-linux-gnu/libX11.so;\$<LINK_ONLY:sfml-window>;\$<LINK_ONLY:sfml-system>;\$<LINK_ONLY:uuid>;enet;zstd;zlib"
+)
+
+# Create imported target Texture
+add_library(Texture STATIC IMPORTED)
+
+set_target_properties(Texture PROPERTIES
+  INTERFACE_COMPILE_DEFINITIONS "UNICODE;_UNICODE;BUILDSYSTEM_HAS_TEXTURE"
+  INTERFACE_INCLUDE_DIRECTORIES "/root/repo/Code/Engine"
+  INTERFACE_LINK_LIBRARIES "\$<LINK_ONLY:-lgcc_s>;\$<LINK_ONLY:-lgcc>;\$<LINK_ONLY:pthread>;\$<LINK_ONLY:rt>;/usr/lib/x86_64-linux-gnu/libX11.so;\$<LINK_ONLY:sfml-window>;\$<LINK_ONLY:sfml-system>;Foundation;\$<LINK_ONLY:stb_image>"
+)
+
+# Import target "enet" for configuration "Dev"
+set_property(TARGET enet APPEND PROPERTY IMPORTED_CONFIGURATIONS DEV)
+set_target_properties(enet PROPERTIES
+  IMPORTED_LOCATION_DEV "/root/repo/Output/Lib/LinuxMakeGccDev64/libenet.so"
+  IMPORTED_SONAME_DEV "libenet.so"
+  )
+
+# Import target "stb_image" for configuration "Dev"
+set_property(TARGET stb_image APPEND PROPERTY IMPORTED_CONFIGURATIONS DEV)
+set_target_properties(stb_image PROPERTIES
+  IMPORTED_LOCATION_DEV "/root/repo/Output/Lib/LinuxMakeGccDev64/libstb_image.so"
+  IMPORTED_SONAME_DEV "libstb_image.so"
+  )
+
+# Import target "zlib" for configuration "Dev"
+set_property(TARGET zlib APPEND PROPERTY IMPORTED_CONFIGURATIONS DEV)
+set_target_properties(zlib PROPERTIES
+  IMPORTED_LINK_INTERFACE_LANGUAGES_DEV "C"
+  IMPORTED_LOCATION_DEV "/root/repo/Output/Lib/LinuxMakeGccDev64/libzlib.a"
+  )
+
+# Import target "zstd" for configuration "Dev"
+set_property(TARGET zstd APPEND PROPERTY IMPORTED_CONFIGURATIONS DEV)
+set_target_properties(zstd PROPERTIES
+  IMPORTED_LOCATION_DEV "/root/repo/Output/Lib/LinuxMakeGccDev64/libzstd.so"
+  IMPORTED_SONAME_DEV "libzstd.so"
+  )
+
+# Import target "Foundation" for configuration "Dev"
+set_property(TARGET Foundation APPEND PROPERTY IMPORTED_CONFIGURATIONS DEV)
+set_target_properties(Foundation PROPERTIES
+  IMPORTED_LINK_INTERFACE_LANGUAGES_DEV "C;CXX"
+  IMPORTED_LOCATION_DEV "/root/repo/Output/Lib/LinuxMakeGccDev64/ezFoundation.a"
+  )
+
+# Import target "Texture" for configuration "Dev"
+set_property(TARGET Texture APPEND PROPERTY IMPORTED_CONFIGURATIONS DEV)
+set_target_properties(Texture PROPERTIES
+  IMPORTED_LINK_INTERFACE_LANGUAGES_DEV "CXX"
+  IMPORTED_LOCATION_DEV "/root/repo/Output/Lib/LinuxMakeGccDev64/ezTexture.a"
+  )
+
+# This file does not depend on other imported targets which have
+# been exported from the same project but in a separate export set.
+
+# Commands beyond this point should not need to know the version.
+set(CMAKE_IMPORT_FILE_VERSION)
+cmake_policy(POP)